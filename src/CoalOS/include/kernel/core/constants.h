@@ -29,7 +29,7 @@ extern "C" {
 #define KERNEL_SPACE_VIRT_START     KERNEL_VIRT_BASE
 
 // Virtual memory regions
-#define USER_SPACE_START_VIRT       0x00001000U    // 4KB - user space start
+#define USER_SPACE_START_VIRT       0x00400000U    // 4MB - PDE 0 is the kernel's identity map
 #define USER_SPACE_END_VIRT         0xBFFFFFFFU    // Just below kernel space
 #define KERNEL_STACK_VIRT_START     0xE0000000U    // Kernel stack region start
 #define KERNEL_STACK_VIRT_END       0xF0000000U    // Kernel stack region end
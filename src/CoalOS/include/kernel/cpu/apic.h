@@ -0,0 +1,105 @@
+/**
+ * @file apic.h
+ * @brief Local APIC and I/O APIC register access and MADT discovery
+ *
+ * Low-level layer under the x86 IRQ HAL (x86_irq_hal.c). The MADT supplies
+ * the I/O APIC addresses, the ISA interrupt source overrides and the local
+ * APIC ids of all CPUs; without it the architectural defaults are assumed.
+ */
+
+#ifndef APIC_H
+#define APIC_H
+
+#include <kernel/core/types.h>
+#include <kernel/core/error.h>
+
+// --- Local APIC registers (byte offsets into the 4 KiB MMIO page) ---
+#define LAPIC_REG_ID        0x020
+#define LAPIC_REG_VERSION   0x030
+#define LAPIC_REG_TPR       0x080
+#define LAPIC_REG_EOI       0x0B0
+#define LAPIC_REG_SVR       0x0F0
+#define LAPIC_REG_ICR_LOW   0x300
+#define LAPIC_REG_ICR_HIGH  0x310
+
+#define LAPIC_SVR_ENABLE    (1u << 8)
+#define LAPIC_ICR_PENDING   (1u << 12)
+
+#define APIC_SPURIOUS_VECTOR 0xFF
+#define APIC_DEFAULT_LAPIC_PHYS  0xFEE00000u
+#define APIC_DEFAULT_IOAPIC_PHYS 0xFEC00000u
+
+// --- I/O APIC redirection entry (low dword) ---
+#define IOAPIC_REDIR_LEVEL      (1u << 15)
+#define IOAPIC_REDIR_ACTIVE_LOW (1u << 13)
+#define IOAPIC_REDIR_MASKED     (1u << 16)
+
+// --- MSI message format (Intel SDM 10.11) ---
+#define MSI_ADDRESS_BASE    0xFEE00000u
+#define MSI_ADDRESS_DEST(apic_id) ((uint32_t)(apic_id) << 12)
+
+#define APIC_MAX_IOAPICS    4
+
+/*
+ * Kernel VA window for the APIC MMIO pages: the upper half of the temp-map
+ * range, which paging_temp never hands out.
+ */
+#define APIC_MMIO_VIRT_BASE 0xFE800000u
+
+/**
+ * @brief ISA IRQ routing after MADT interrupt source overrides
+ */
+typedef struct apic_isa_route {
+    uint32_t gsi;       // Global system interrupt the ISA line arrives on
+    bool level;         // Level-triggered (default edge)
+    bool active_low;    // Active low (default high)
+} apic_isa_route_t;
+
+/**
+ * @brief Parses the MADT reachable from the RSDP and maps the APICs
+ * @param rsdp Virtual address of the ACPI RSDP (from multiboot), or NULL
+ * @return E_SUCCESS, or E_NOTSUP if the CPU has no local APIC
+ */
+error_t apic_init(const void *rsdp);
+
+/** @brief True once apic_init() has succeeded */
+bool apic_available(void);
+
+/** @brief Enables the local APIC of the calling CPU and clears its TPR */
+void lapic_enable(void);
+
+/** @brief Local APIC id of the calling CPU */
+uint8_t lapic_id(void);
+
+/** @brief Local APIC id of logical CPU cpu (from the MADT), or 0xFF */
+uint8_t apic_cpu_to_lapic_id(uint32_t cpu);
+
+/** @brief Number of enabled CPUs listed in the MADT (at least 1) */
+uint32_t apic_cpu_count(void);
+
+/** @brief Signals end of interrupt: a single MMIO write */
+void lapic_eoi(void);
+
+/** @brief Sends a fixed IPI with the given vector to one local APIC */
+void lapic_send_ipi(uint8_t apic_id, uint8_t vector);
+
+/** @brief Routing of ISA IRQ irq (0-15) */
+const apic_isa_route_t *apic_isa_route(uint8_t irq);
+
+/**
+ * @brief Writes the redirection entry for a global system interrupt
+ * @return E_SUCCESS, or E_NOTFOUND if no I/O APIC serves gsi
+ */
+error_t ioapic_set_entry(uint32_t gsi, uint8_t vector, uint8_t dest_apic_id,
+                         bool level, bool active_low, bool masked);
+
+/** @brief Sets or clears the mask bit of a redirection entry */
+error_t ioapic_set_masked(uint32_t gsi, bool masked);
+
+/** @brief Rewrites only the destination of a redirection entry */
+error_t ioapic_set_destination(uint32_t gsi, uint8_t dest_apic_id);
+
+/** @brief Reads the mask bit of a redirection entry (true if unknown) */
+bool ioapic_is_masked(uint32_t gsi);
+
+#endif // APIC_H
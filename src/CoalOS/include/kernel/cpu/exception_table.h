@@ -15,17 +15,21 @@
  
  /**
   * @brief Defines a single entry in the kernel's exception table.
-  * Each entry maps a specific kernel instruction address, which is known
+  * Each entry maps a range of kernel instruction addresses, which are known
   * to potentially fault when accessing user memory (e.g., a MOV instruction
-  * in copy_from_user), to a "fixup" address within the same function.
-  * If a page fault occurs at `fault_addr`, the page fault handler should
-  * look up this table. If found, it modifies the EIP on the fault stack frame
-  * to point to `fixup_addr` and returns via `iret`, allowing the function
-  * to handle the fault (e.g., by returning an error code) instead of crashing.
+  * in copy_from_user, or a whole REP MOVS copy loop), to a "fixup" address
+  * within the same function.
+  * If a page fault occurs with EIP in [`insn_start`, `insn_end`), the page
+  * fault handler modifies the EIP on the fault stack frame to point to
+  * `fixup_addr` and returns via `iret`, allowing the function to handle the
+  * fault (e.g., by returning an error code) instead of crashing.
+  * Single-instruction entries use `insn_end = insn_start + 1`.
+  * Entries must not overlap.
   */
  typedef struct {
-     uint32_t fault_addr;  /**< Address of the kernel instruction *allowed* to fault (EIP). */
-     uint32_t fixup_addr;  /**< Address to jump to (via modified IRET) if a fault occurs at fault_addr. */
+     uint32_t insn_start;  /**< First kernel instruction address *allowed* to fault (EIP). */
+     uint32_t insn_end;    /**< One past the last address covered by this entry. */
+     uint32_t fixup_addr;  /**< Address to jump to (via modified IRET) if a fault occurs in range. */
  } exception_entry_t;
  
  /**
@@ -41,12 +45,20 @@
  extern exception_entry_t __stop_ex_table[];
  
  
+ /**
+  * @brief Sorts the exception table by instruction address.
+  *
+  * Must be called once during early boot, before the first user memory
+  * access. Until then lookups fall back to a linear scan.
+  */
+ void exception_table_init(void);
+ 
  /**
   * @brief Finds the fixup address corresponding to a faulting kernel instruction address.
   *
-  * This function iterates through the exception table (between `__start_ex_table`
-  * and `__stop_ex_table`) searching for an entry whose `fault_addr` matches the
-  * provided `fault_eip`.
+  * Binary-searches the sorted exception table (between `__start_ex_table`
+  * and `__stop_ex_table`) for the entry whose range contains `fault_eip`,
+  * so lookup cost is logarithmic in the number of uaccess sites.
   *
   * @param fault_eip The EIP (instruction pointer) where the kernel page fault occurred.
   * @return The corresponding `fixup_addr` if an entry is found.
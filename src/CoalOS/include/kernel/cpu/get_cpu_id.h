@@ -7,6 +7,11 @@
 extern "C" {
 #endif
 
+/** Upper bound on CPU ids returned by get_cpu_id(); sizes per-CPU arrays. */
+#ifndef MAX_CPUS
+#define MAX_CPUS 4
+#endif
+
 /**
  * @brief Retrieves the current CPU's identifier using the CPUID instruction.
  *
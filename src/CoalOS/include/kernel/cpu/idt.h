@@ -91,6 +91,19 @@ void idt_init(void);
  */
 void register_int_handler(int num, int_handler_t handler, void* data);
 
+/**
+ * @brief Returns how many times a vector has been dispatched since boot.
+ *
+ * Counted in isr_common_handler(); vectors with their own entry path (the
+ * syscall gate, the APIC spurious vector) are not counted.
+ */
+uint32_t idt_get_interrupt_count(int num);
+
+/**
+ * @brief Returns true if a C handler is registered for the vector.
+ */
+bool idt_has_handler(int num);
+
 
 // Helper for optional delays (used in PIC init)
 static inline void io_wait(void) {
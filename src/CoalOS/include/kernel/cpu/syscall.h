@@ -23,16 +23,24 @@
 #define SYS_CHDIR   12  // __NR_chdir
 #define SYS_LSEEK   19  // __NR_lseek
 #define SYS_GETPID  20  // __NR_getpid
+#define SYS_ALARM   27  // __NR_alarm
 #define SYS_KILL    37  // __NR_kill
 #define SYS_MKDIR   39  // __NR_mkdir
 #define SYS_RMDIR   40  // __NR_rmdir
 #define SYS_PIPE    42  // __NR_pipe
+#define SYS_TIMES   43  // __NR_times
 #define SYS_BRK     45  // __NR_brk
 #define SYS_SIGNAL  48  // __NR_signal
+#define SYS_IOCTL   54  // __NR_ioctl
 #define SYS_DUP2    63  // __NR_dup2
 #define SYS_GETPPID 64  // __NR_getppid
+#define SYS_GETRUSAGE 77 // __NR_getrusage
+#define SYS_READDIR 89  // __NR_readdir (legacy single-entry)
 #define SYS_MMAP    90  // __NR_mmap
+#define SYS_SETITIMER 104 // __NR_setitimer
+#define SYS_GETITIMER 105 // __NR_getitimer
 #define SYS_STAT    106 // __NR_stat
+#define SYS_SIGRETURN 119 // __NR_sigreturn
 #define SYS_GETDENTS 141 // __NR_getdents (CORRECTED from 89)
 #define SYS_GETCWD  183 // __NR_getcwd
 #define SYS_UNLINK  10  // __NR_unlink
@@ -351,9 +351,29 @@
 #define __NR_fanotify_init      338
 #define __NR_fanotify_mark      339
 #define __NR_prlimit64          340
+#define __NR_syncfs             344
+#define __NR_socket             359
+#define __NR_socketpair         360
+#define __NR_bind               361
+#define __NR_connect            362
+#define __NR_listen             363
+#define __NR_accept4            364
+#define __NR_getsockopt         365
+#define __NR_setsockopt         366
+#define __NR_getsockname        367
+#define __NR_getpeername        368
+#define __NR_sendto             369
+#define __NR_sendmsg            370
+#define __NR_recvfrom           371
+#define __NR_recvmsg            372
+#define __NR_shutdown           373
+#define __NR_copy_file_range    377
+#define __NR_io_uring_setup     425
+#define __NR_io_uring_enter     426
+#define __NR_io_uring_register  427
 
 /* System call table size */
-#define __NR_syscalls           341
+#define __NR_syscalls           428
 
 /* Error codes returned in EAX (negative) */
 #define LINUX_EPERM              1  /* Operation not permitted */
@@ -427,6 +447,6 @@ void init_linux_syscall_table(void);
 
 /* Syscall dispatcher for Linux compatibility mode */
 int linux_syscall_dispatcher(uint32_t syscall_num, uint32_t ebx, uint32_t ecx, 
-                            uint32_t edx, uint32_t esi, uint32_t edi);
+                            uint32_t edx, uint32_t esi, uint32_t edi, uint32_t ebp);
 
 #endif /* SYSCALL_LINUX_H */
\ No newline at end of file
@@ -0,0 +1,53 @@
+/**
+ * @file tsc.h
+ * @brief Time Stamp Counter as a fine-grained clock source
+ *
+ * The TSC frequency is calibrated against the 1 kHz scheduler tick during
+ * the first TSC_CALIBRATE_TICKS ticks after boot. Until then (or on CPUs
+ * without a TSC) tsc_ready() is false and callers fall back to tick-based
+ * timing.
+ */
+
+#ifndef TSC_H
+#define TSC_H
+
+#include <kernel/core/types.h>
+#include <libc/stdint.h>
+#include <libc/stdbool.h>
+
+/** Ticks (ms) the calibration window spans. */
+#define TSC_CALIBRATE_TICKS  64
+/** Fixed-point shift of the cycles-to-ns multiplier. */
+#define TSC_SHIFT            16
+
+/** @brief Reads the raw time stamp counter. */
+static inline uint64_t rdtsc(void) {
+    uint32_t lo, hi;
+    asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+/**
+ * @brief Detects the TSC (CPUID.1:EDX.TSC); call once before the PIT starts
+ */
+void tsc_init(void);
+
+/**
+ * @brief Advances calibration; called from the scheduler tick
+ */
+void tsc_calibrate_tick(uint32_t now);
+
+/** @brief True once the TSC frequency is known. */
+bool tsc_ready(void);
+
+/** @brief Calibrated frequency in kHz (cycles per ms), 0 if not ready. */
+uint32_t tsc_khz(void);
+
+/**
+ * @brief Converts a cycle delta to nanoseconds
+ * @note Exact for deltas below 2^44 cycles (hours); meant for intervals
+ * between accounting points, not for absolute TSC values.
+ */
+uint64_t tsc_cycles_to_ns(uint64_t cycles);
+
+#endif // TSC_H
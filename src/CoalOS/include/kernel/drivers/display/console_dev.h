@@ -21,6 +21,11 @@
  */
 file_t *create_console_file(int mode);
 
+/**
+ * @brief True if file is a console descriptor (input comes from the tty)
+ */
+bool console_is_tty(file_t *file);
+
 /**
  * @brief Initialize console device driver
  * Called during system initialization
@@ -103,16 +103,6 @@ void terminal_vprintf(const char* format, va_list args);
 
 /* --- Interactive Input Functions --- */
 
-/**
- * @brief Processes a key event for interactive input editing.
- * This function is called by the keyboard driver's callback.
- * It handles line buffering for the SYS_READ_TERMINAL syscall and
- * can also manage the more complex multi-line input_state if active.
- * @param event The keyboard event.
- */
-void terminal_handle_key_event(const KeyEvent event);
-
-
 /**
  * @brief Starts an interactive multi-line input session (for advanced editing). Thread-safe.
  * @param prompt Optional prompt string to display.
@@ -156,16 +146,5 @@ void terminal_backspace(void);
  */
 void terminal_write_bytes(const char* data, size_t size);
 
-/**
- * @brief Reads a line of input from the terminal, blocking until Enter is pressed.
- * This function is intended to be called by the SYS_READ_TERMINAL syscall handler.
- * It interacts with the internal line buffer populated by terminal_handle_key_event.
- * @param kbuf Kernel buffer to store the input line.
- * @param len Maximum number of bytes to read into kbuf (including null terminator).
- * @return The number of bytes read (excluding null terminator), or a negative error code.
- * Returns 0 for an empty line if Enter is pressed immediately.
- */
-ssize_t terminal_read_line_blocking(char *kbuf, size_t len);
-
 
 #endif // TERMINAL_H
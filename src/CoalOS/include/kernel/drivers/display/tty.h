@@ -0,0 +1,163 @@
+/**
+ * @file tty.h
+ * @brief Console tty: line discipline, termios and terminal input queue
+ *
+ * Keyboard events are turned into bytes in IRQ context and only queued
+ * there; the line discipline (input mapping, ISIG, canonical editing, echo)
+ * runs from a work item in process context, once per batch of keys. Echo is
+ * written to the screen in one terminal_write_bytes() call per batch.
+ *
+ * Processed input collects in a ring. In canonical mode (ICANON) a read
+ * returns at most one line, which becomes readable when a line delimiter
+ * arrives; otherwise reads follow VMIN/VTIME and return everything already
+ * queued, up to the caller's count, in one call.
+ */
+
+#ifndef TTY_H
+#define TTY_H
+
+#include <kernel/core/types.h>
+#include <kernel/drivers/input/keyboard.h>
+#include <libc/stdint.h>
+#include <libc/stdbool.h>
+#include <libc/stddef.h>
+
+//============================================================================
+// User ABI (matches Linux i386)
+//============================================================================
+
+#define NCCS        19
+
+// c_cc indices
+#define VINTR       0
+#define VQUIT       1
+#define VERASE      2
+#define VKILL       3
+#define VEOF        4
+#define VTIME       5
+#define VMIN        6
+#define VSTART      8
+#define VSTOP       9
+#define VSUSP       10
+#define VEOL        11
+#define VREPRINT    12
+#define VWERASE     14
+#define VLNEXT      15
+#define VEOL2       16
+
+// c_iflag
+#define INLCR       0x0040
+#define IGNCR       0x0080
+#define ICRNL       0x0100
+#define IXON        0x0400
+
+// c_oflag
+#define OPOST       0x0001
+#define ONLCR       0x0004
+
+// c_cflag
+#define CS8         0x0030
+#define CREAD       0x0080
+
+// c_lflag
+#define ISIG        0x0001
+#define ICANON      0x0002
+#define ECHO        0x0008
+#define ECHOE       0x0010
+#define ECHOK       0x0020
+#define ECHONL      0x0040
+#define NOFLSH      0x0080
+#define ECHOCTL     0x0200
+#define ECHOKE      0x0800
+#define IEXTEN      0x8000
+
+// ioctl requests
+#define TCGETS      0x5401
+#define TCSETS      0x5402
+#define TCSETSW     0x5403
+#define TCSETSF     0x5404
+#define TCFLSH      0x540B
+#define TIOCGPGRP   0x540F
+#define TIOCSPGRP   0x5410
+#define TIOCGWINSZ  0x5413
+#define TIOCSWINSZ  0x5414
+#define FIONREAD    0x541B
+
+// TCFLSH queue selectors
+#define TCIFLUSH    0
+#define TCOFLUSH    1
+#define TCIOFLUSH   2
+
+// struct termios as the kernel sees it (no c_ispeed/c_ospeed)
+typedef struct {
+    uint32_t c_iflag;
+    uint32_t c_oflag;
+    uint32_t c_cflag;
+    uint32_t c_lflag;
+    uint8_t  c_line;
+    uint8_t  c_cc[NCCS];
+} k_termios_t;
+
+typedef struct {
+    uint16_t ws_row;
+    uint16_t ws_col;
+    uint16_t ws_xpixel;
+    uint16_t ws_ypixel;
+} k_winsize_t;
+
+//============================================================================
+// Configuration
+//============================================================================
+
+#define TTY_RAW_SIZE    256     // Bytes queued by the IRQ side per batch
+#define TTY_BUF_SIZE    1024    // Processed input waiting for read()
+#define TTY_LINE_MAX    255     // Longest canonical line (MAX_INPUT_LENGTH - 1)
+
+//============================================================================
+// Interface
+//============================================================================
+
+/**
+ * @brief Resets the input queues and termios to the canonical defaults
+ */
+void tty_init(void);
+
+/**
+ * @brief Keyboard callback: queues the bytes for a key press (IRQ context)
+ */
+void tty_handle_key_event(KeyEvent event);
+
+/**
+ * @brief Reads processed input
+ * @details Canonical mode returns one line (with its '\n'), or 0 at an EOF
+ * character on an empty line. Non-canonical mode waits as VMIN/VTIME say
+ * and then returns all queued bytes up to count. Must not be called with a
+ * spinlock held unless nonblock is set.
+ * @return Bytes read, -EAGAIN (nonblock, nothing ready) or -EINTR
+ */
+ssize_t tty_read(char *kbuf, size_t count, bool nonblock);
+
+/** @brief Copies the current settings */
+void tty_get_termios(k_termios_t *t);
+
+/**
+ * @brief Installs new settings
+ * @param action TCSETS, TCSETSW or TCSETSF (which also discards queued input)
+ */
+int tty_set_termios(const k_termios_t *t, int action);
+
+/** @brief Discards unread input, including a partially edited line */
+void tty_flush_input(void);
+
+/** @brief Bytes a read could return right now (FIONREAD) */
+size_t tty_bytes_available(void);
+
+/** @brief Foreground process group; 0 until set or adopted by a reader */
+uint32_t tty_get_pgrp(void);
+int tty_set_pgrp(uint32_t pgid);
+
+/** @brief Window size reported by TIOCGWINSZ */
+void tty_get_winsize(k_winsize_t *ws);
+void tty_set_winsize(const k_winsize_t *ws);
+
+#endif // TTY_H
@@ -0,0 +1,20 @@
+/**
+ * @file stats_dev.h
+ * @brief Kernel statistics device (/dev/stats)
+ */
+
+#ifndef STATS_DEV_H
+#define STATS_DEV_H
+
+#define STATS_DEV_MOUNT_POINT "/dev/stats"
+
+/**
+ * @brief Registers the stats driver and mounts it at STATS_DEV_MOUNT_POINT
+ * @return 0 on success, negative FS_ERR_* code on failure
+ *
+ * Reading the device returns one "name value" line per registered
+ * percpu_counter. The snapshot is taken at open time.
+ */
+int stats_dev_init(void);
+
+#endif // STATS_DEV_H
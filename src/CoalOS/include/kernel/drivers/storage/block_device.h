@@ -51,6 +51,10 @@ int block_device_read(block_device_t *dev, uint64_t lba, void *buffer, size_t co
 // LBA is now uint64_t
 int block_device_write(block_device_t *dev, uint64_t lba, const void *buffer, size_t count);
 
+// Flushes the drive's write cache (FLUSH CACHE / FLUSH CACHE EXT). Writes are
+// not durable until this returns BLOCK_ERR_OK.
+int block_device_flush(block_device_t *dev);
+
 void ata_primary_irq_handler(isr_frame_t* frame); // <<< ADDED DECLARATION
 
 #endif /* BLOCK_DEVICE_H */
\ No newline at end of file
@@ -64,13 +64,25 @@
  // Flush a single buffer to disk
  int buffer_flush(buffer_t *buf);
  
- // Sync all dirty buffers to disk
+ // Sync all dirty buffers to disk and flush every registered disk's write cache
  void buffer_cache_sync(void);
  
+ // Sync the dirty buffers of one device, then flush its write cache.
+ // Returns 0 or a negative FS_ERR_* code, as do the two below.
+ int buffer_sync_device(const char *device_name);
+ 
+ // Flush a device's write cache so that completed writes are durable
+ int buffer_flush_device(const char *device_name);
+ 
  // Get buffer cache statistics
  void buffer_cache_get_stats(buffer_cache_stats_t *stats);
  
  // Invalidate all buffers for a specific device
  void buffer_invalidate_device(const char *device_name);
  
+ // Write back dirty buffers in [first_block, first_block + count) and, with
+ // invalidate, drop unused ones so the next buffer_get rereads the disk.
+ // Keeps the cache coherent with transfers that bypass it (O_DIRECT).
+ int buffer_sync_range(const char *device_name, uint32_t first_block, uint32_t count, bool invalidate);
+ 
  #endif /* BUFFER_CACHE_H */
\ No newline at end of file
@@ -65,6 +65,13 @@ int disk_read_raw_sectors(disk_t *disk, uint64_t lba, void *buffer, size_t count
  */
 int disk_write_raw_sectors(disk_t *disk, uint64_t lba, const void *buffer, size_t count);
 
+/**
+ * @brief Flushes the drive's write cache so that completed writes are durable.
+ * @param disk Pointer to the initialized disk_t structure.
+ * @return FS_SUCCESS on success, negative error code on failure.
+ */
+int disk_flush(disk_t *disk);
+
 
 /**
  * @brief Reads sectors from a specific partition.
@@ -0,0 +1,69 @@
+/**
+ * @file ktimer.h
+ * @brief Kernel one-shot timers driven by the scheduler tick
+ *
+ * A ktimer fires its callback once the tick count reaches its expiry. Timers
+ * are kept on a list sorted by expiry, so the per-tick check is O(1) when
+ * nothing is due. Callbacks run in interrupt context with the timer already
+ * dequeued; they must not block but may re-arm the timer (periodic timers).
+ */
+
+#ifndef KTIMER_H
+#define KTIMER_H
+
+#include <kernel/core/types.h>
+#include <libc/stdint.h>
+#include <libc/stdbool.h>
+
+/** Timer resolution; matches the PIT/scheduler tick (1 ms). */
+#define KTIMER_HZ         1000
+/** Largest relative expiry accepted (ticks); keeps wrap-safe comparisons valid. */
+#define KTIMER_MAX_DELTA  0x3FFFFFFFu
+
+typedef struct ktimer ktimer_t;
+typedef void (*ktimer_fn_t)(ktimer_t *timer);
+
+struct ktimer {
+    uint32_t    expires;   // Absolute tick of expiry
+    ktimer_fn_t fn;        // Callback (interrupt context)
+    void       *data;      // Owner context for the callback
+    ktimer_t   *next;      // Sorted pending list links
+    ktimer_t   *prev;
+    bool        pending;   // True while queued
+};
+
+/**
+ * @brief Prepares a timer; it is not armed.
+ */
+void ktimer_init(ktimer_t *timer, ktimer_fn_t fn, void *data);
+
+/**
+ * @brief Arms (or re-arms) a timer to fire at an absolute tick
+ */
+void ktimer_arm_at(ktimer_t *timer, uint32_t expires);
+
+/**
+ * @brief Arms (or re-arms) a timer to fire delta ticks from now (min 1)
+ */
+void ktimer_arm(ktimer_t *timer, uint32_t delta);
+
+/**
+ * @brief Disarms a timer
+ * @return true if the timer was pending
+ */
+bool ktimer_cancel(ktimer_t *timer);
+
+/**
+ * @brief Ticks until a pending timer expires (0 if not pending or due)
+ */
+uint32_t ktimer_remaining(const ktimer_t *timer);
+
+/**
+ * @brief Runs every expired timer; called once per scheduler tick
+ */
+void ktimer_run_expired(uint32_t now);
+
+/** @brief Current tick count (alias of the scheduler clock). */
+uint32_t ktimer_now(void);
+
+#endif // KTIMER_H
@@ -0,0 +1,41 @@
+/**
+ * @file timerfd.h
+ * @brief Timers readable through a file descriptor
+ *
+ * A timerfd counts expirations of an internal ktimer. read() returns the
+ * count as a uint64_t and resets it, blocking (or failing with EAGAIN under
+ * TFD_NONBLOCK) while it is zero.
+ */
+
+#ifndef TIMERFD_H
+#define TIMERFD_H
+
+#include <kernel/fs/vfs/vfs.h>
+#include <kernel/process/itimer.h>
+#include <libc/stdint.h>
+
+#define TFD_TIMER_ABSTIME  1
+#define TFD_NONBLOCK       0x00000800  // == O_NONBLOCK
+#define TFD_CLOEXEC        0x00080000  // Accepted; exec does not close fds yet
+
+/**
+ * @brief Creates a timerfd and installs it in the caller's fd table
+ * @param clockid CLOCK_REALTIME or CLOCK_MONOTONIC
+ * @param flags TFD_NONBLOCK / TFD_CLOEXEC
+ * @return File descriptor or negative errno
+ */
+int timerfd_create(int clockid, int flags);
+
+/**
+ * @brief Arms or disarms a timerfd
+ * @return 0, or -EINVAL if file is not a timerfd or the time is malformed
+ */
+int timerfd_settime(file_t *file, int flags, const k_itimerspec_t *val,
+                    k_itimerspec_t *old);
+
+/**
+ * @brief Reads the time left and the reload interval of a timerfd
+ */
+int timerfd_gettime(file_t *file, k_itimerspec_t *cur);
+
+#endif // TIMERFD_H
@@ -133,6 +133,9 @@
      void      *fat_table;           // Pointer to the cached FAT table in memory
      size_t     fat_table_size_bytes;// Size of the allocated fat_table buffer
      bool       fat_dirty;           // Flag indicating if the in-memory FAT needs flushing
+
+     // Directory Change Tracking
+     uint32_t   dir_generation;      // Bumped on every directory entry write; invalidates cached dir blocks
  
  } fat_fs_t;
  
@@ -147,6 +150,8 @@
      uint32_t file_size;             // Current size of the file in bytes (from directory entry)
      uint32_t dir_entry_cluster;     // Cluster number where the directory entry for this file/dir resides
      uint32_t dir_entry_offset;      // Byte offset within dir_entry_cluster of the 8.3 directory entry
+     uint16_t write_time;            // Last modification time (FAT format), reported by fstat
+     uint16_t write_date;            // Last modification date (FAT format)
      bool     is_directory;          // True if this context represents a directory
  
      // State Flags
@@ -160,6 +165,13 @@
      uint32_t readdir_current_cluster; // Cluster being scanned for readdir
      uint32_t readdir_current_offset;  // Byte offset within the directory data being scanned
      size_t   readdir_last_index;      // The logical index of the last entry returned by readdir
+
+     // Getdents Block Cache (only relevant if is_directory is true)
+     uint8_t *dirblock_data;           // Cached raw directory block (one cluster), NULL until first getdents
+     uint32_t dirblock_base;           // Directory byte offset at which the cached block starts
+     uint32_t dirblock_len;            // Number of valid bytes in dirblock_data
+     uint32_t dirblock_cluster;        // Cluster holding the cached block (0 for FAT12/16 root)
+     uint32_t dirblock_generation;     // fs->dir_generation when the block was loaded
  
  } fat_file_context_t;
  
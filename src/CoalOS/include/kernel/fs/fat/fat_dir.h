@@ -59,6 +59,20 @@
   * @return Other negative FS_ERR_* codes on error (e.g., -FS_ERR_IO).
   */
  int fat_readdir_internal(file_t *dir_file, struct dirent *d_entry_out, size_t entry_index);
+
+ /**
+  * @brief Reads as many directory entries as the caller accepts in one call.
+  *
+  * Starts at dir_file->offset, a byte-offset position cookie into the directory
+  * data, and advances it past every entry accepted by filldir. Cookies are stable
+  * across calls, so seeking to one does not rescan preceding entries.
+  *
+  * @param dir_file Pointer to the VFS file_t representing the opened directory.
+  * @param filldir Emitter called per entry; a non-zero return stops iteration.
+  * @param ctx Opaque pointer passed through to filldir.
+  * @return Number of entries emitted (0 at end of directory), or a negative FS_ERR_* code.
+  */
+ int fat_getdents_internal(file_t *dir_file, vfs_filldir_t filldir, void *ctx);
  
  /**
   * @brief Deletes a file from the FAT filesystem.
@@ -42,4 +42,29 @@
   */
  int fat_unmount_internal(void *fs_context);
  
+ /**
+  * @brief Writes the FAT table and all dirty buffers of the filesystem to disk.
+  *
+  * Copies the in-memory FAT into the buffer cache, writes back every dirty
+  * buffer of the device and flushes the drive's write cache.
+  *
+  * @param fs_context A pointer to the fat_fs_t structure.
+  * @return FS_SUCCESS (0) on success, negative FS_ERR_* code on failure.
+  */
+ int fat_syncfs_internal(void *fs_context);
+ 
+ /**
+  * @brief Writes a range of sectors of the in-memory FAT to every FAT copy on disk.
+  *
+  * Used by fsync to make the chain entries of one file durable without
+  * writing the rest of the table. Assumes the caller holds fs->lock. The
+  * drive's write cache is not flushed.
+  *
+  * @param fs Pointer to the FAT filesystem structure.
+  * @param first_sector First sector index within one FAT.
+  * @param count Number of sectors.
+  * @return FS_SUCCESS (0) on success, negative FS_ERR_* code on failure.
+  */
+ int fat_sync_fat_sectors(fat_fs_t *fs, uint32_t first_sector, uint32_t count);
+ 
  #endif /* FAT_FS_H */
\ No newline at end of file
@@ -68,6 +68,15 @@
   */
  off_t fat_lseek_internal(file_t *file, off_t offset, int whence);
  
+ /**
+  * @brief Reports identity, size and modification time of an opened file. Implements VFS fstat.
+  *
+  * @param file Pointer to the VFS file_t structure.
+  * @param st Output; st_ino is the first cluster (or the directory entry position for empty files).
+  * @return FS_SUCCESS (0) on success, or a negative FS_ERR_* code on failure.
+  */
+ int fat_fstat_internal(file_t *file, struct stat *st);
+ 
  /**
   * @brief Closes an opened file. Implements VFS close.
   *
@@ -79,6 +88,20 @@
   * @return FS_SUCCESS (0) on success, or a negative FS_ERR_* code on failure.
   */
  int fat_close_internal(file_t *file);
+
+ /**
+  * @brief Writes an opened file's data and metadata to disk. Implements VFS fsync.
+  *
+  * Writes back the buffers of the file's clusters and the FAT sectors holding
+  * its chain, flushes the drive's write cache, then writes the directory
+  * entry and flushes again. Other files' dirty buffers are not touched.
+  *
+  * @param file Pointer to the VFS file_t structure.
+  * @param datasync If true (fdatasync), the directory entry is only rewritten
+  * when its size or first cluster is stale, not for timestamps alone.
+  * @return FS_SUCCESS (0) on success, or a negative FS_ERR_* code on failure.
+  */
+ int fat_fsync_internal(file_t *file, bool datasync);
  
  
  /* --- Cluster I/O Helpers (Potentially used by other FAT modules) --- */
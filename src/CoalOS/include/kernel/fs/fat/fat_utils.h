@@ -116,8 +116,10 @@
  
  /**
   * @brief Generates a unique 8.3 short filename based on a long filename, checking for collisions.
-  * Implements the standard "NAME~N.EXT" generation algorithm.
-  * @param fs Filesystem context (used for uniqueness check via fat_raw_short_name_exists).
+  * Implements the Windows-style "NAME~N.EXT" algorithm (~1..~4, then a hashed
+  * "NAHHHH~N.EXT" form, then further numeric tails). Collisions for every
+  * candidate are gathered in a single pass over the parent directory.
+  * @param fs Filesystem context (used to scan the parent directory).
   * @param parent_dir_cluster The cluster number of the parent directory where the name will be created.
   * @param long_name The desired long filename.
   * @param short_name_out Buffer of 11 bytes to store the generated unique 8.3 name.
@@ -0,0 +1,39 @@
+/**
+ * @file procfs.h
+ * @brief /proc: process and kernel statistics generated on read
+ *
+ * Layout (Linux field order where Linux has the file):
+ *
+ *   /proc/meminfo      allocator and page cache totals, in kB
+ *   /proc/vmstat       fault, allocation and page cache event counters
+ *   /proc/loadavg      1/5/15-minute load, runnable/total tasks, last pid
+ *   /proc/interrupts   dispatch count per IDT vector
+ *   /proc/slabinfo     object counts per slab cache
+ *   /proc/buddyinfo    free blocks per buddy order
+ *   /proc/cmdline      the boot command line
+ *   /proc/sys/<g>/<n>  tunable "<g>.<n>"; writable unless boot-only
+ *   /proc/<pid>/stat   one-line summary (the first 24 fields of Linux's)
+ *   /proc/<pid>/status the same, plus address space sizes, as "Key:\tvalue"
+ *   /proc/<pid>/maps   one line per VMA
+ *   /proc/<pid>/fd/<n> offset, open flags and filesystem of descriptor n
+ *   /proc/self         the calling process's directory
+ *
+ * Every file is a seq_file: nothing is generated at open, and each read
+ * formats only the records it returns. Per-process files look the task up
+ * on every fill, so a file opened for an exited process reads as -ESRCH.
+ * Resident set size and fault counts are not tracked per process and read
+ * as 0.
+ */
+
+#ifndef PROCFS_H
+#define PROCFS_H
+
+#define PROCFS_MOUNT_POINT "/proc"
+
+/**
+ * @brief Registers the proc driver and mounts it at PROCFS_MOUNT_POINT
+ * @return 0 on success, negative error code on failure
+ */
+int procfs_init(void);
+
+#endif // PROCFS_H
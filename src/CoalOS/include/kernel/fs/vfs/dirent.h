@@ -47,6 +47,16 @@ struct linux_dirent {
      */
 };
 
+/**
+ * @brief Linux readdir(2) directory entry structure (one entry per call)
+ */
+struct old_linux_dirent {
+    unsigned long  d_ino;       // Inode number
+    unsigned long  d_offset;    // Position cookie of the next entry
+    unsigned short d_namlen;    // Length of d_name (not including null terminator)
+    char           d_name[NAME_MAX + 1];
+};
+
 /**
  * @brief Calculate the size of a linux_dirent structure
  * @param namelen Length of the filename (not including null terminator)
@@ -89,6 +89,22 @@ typedef enum fs_error {
 #define ENOSYS      38  /* Function not implemented (maps to FS_ERR_NOT_SUPPORTED) */
 #define ENOTEMPTY   39  /* Directory not empty */
 #define ELOOP       40  /* Too many symbolic links encountered */
+#define ETIME       62  /* Timer expired */
+#define ENOTSOCK    88  /* Socket operation on non-socket */
+#define EDESTADDRREQ 89 /* Destination address required */
+#define EMSGSIZE    90  /* Message too long */
+#define EPROTOTYPE  91  /* Protocol wrong type for socket */
+#define ENOPROTOOPT 92  /* Protocol not available */
+#define EPROTONOSUPPORT 93 /* Protocol not supported */
+#define EOPNOTSUPP  95  /* Operation not supported on transport endpoint */
+#define EAFNOSUPPORT 97 /* Address family not supported by protocol */
+#define EADDRINUSE  98  /* Address already in use */
+#define ECONNRESET 104  /* Connection reset by peer */
+#define ENOBUFS    105  /* No buffer space available */
+#define EISCONN    106  /* Transport endpoint is already connected */
+#define ENOTCONN   107  /* Transport endpoint is not connected */
+#define ECONNREFUSED 111 /* Connection refused */
+#define ECANCELED  125  /* Operation canceled */
 
 
 // Map specific errors needed by syscall.c if not directly covered above
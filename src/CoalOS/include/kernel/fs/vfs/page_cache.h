@@ -19,7 +19,7 @@
 
 // Page cache configuration
 #define PAGE_CACHE_HASH_SIZE    256     // Number of hash buckets
-#define PAGE_CACHE_MAX_PAGES    1024    // Maximum pages in cache
+#define PAGE_CACHE_MAX_PAGES    1024    // Default vm.page_cache_max_pages
 #define PAGE_CACHE_MIN_FREE     64      // Minimum free pages to maintain
 
 // Page cache flags
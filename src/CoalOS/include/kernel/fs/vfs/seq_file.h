@@ -0,0 +1,97 @@
+/**
+ * @file seq_file.h
+ * @brief Generated-on-read text files, produced one record at a time
+ *
+ * A seq_file turns an iterator (start/next/stop) and a per-record show()
+ * into a readable byte stream. Nothing is generated at open: each read fills
+ * a page-sized buffer with as many whole records as fit, hands out bytes
+ * from it, and only then asks the iterator for more, so a large listing is
+ * never materialised at once and a small read costs one page of work.
+ *
+ * A record that does not fit an empty buffer makes the buffer grow (up to
+ * SEQ_BUF_MAX); one that does not fit behind earlier records is generated
+ * again at the start of the next fill. Reading at an offset other than where
+ * the previous read stopped restarts iteration from record 0 and skips
+ * forward, so records are never split or duplicated across one sequential
+ * pass, but a seek may observe newer data than the bytes before it.
+ *
+ * Files with a single record use single_open(), whose show() writes the
+ * whole file.
+ */
+
+#ifndef SEQ_FILE_H
+#define SEQ_FILE_H
+
+#include <kernel/core/types.h>
+#include <libc/stdarg.h>
+
+#define SEQ_BUF_MAX     (64 * 1024)    // Largest buffer a single record may need
+#define SEQ_SKIP        1              // show() result: drop this record's output
+
+typedef struct seq_file seq_file_t;
+
+typedef struct seq_operations {
+    /* Returns the record at *pos, or NULL past the end. */
+    void *(*start)(seq_file_t *m, off_t *pos);
+    /* Advances *pos and returns the record there, or NULL past the end. */
+    void *(*next)(seq_file_t *m, void *v, off_t *pos);
+    /* Ends a fill; v is the record start/next returned last (may be NULL). */
+    void  (*stop)(seq_file_t *m, void *v);
+    /* Prints v. Returns 0, SEQ_SKIP, or a negative error. */
+    int   (*show)(seq_file_t *m, void *v);
+} seq_operations_t;
+
+struct seq_file {
+    char   *buf;            // Generated text (allocated on first read)
+    size_t  size;           // Capacity of buf
+    size_t  count;          // Bytes of text in buf
+    size_t  from;           // Bytes of buf already returned to readers
+    off_t   index;          // Iterator position of the next record to generate
+    off_t   read_pos;       // File offset of buf[from]
+    bool    overflow;       // Set when output did not fit the current record
+    const seq_operations_t *op;
+    int   (*single_show)(seq_file_t *m, void *v); // single_open() only
+    void   *private;        // Owner's data (e.g. the pid being shown)
+};
+
+/**
+ * @brief Prepares m to iterate with op; no memory is allocated yet
+ */
+void seq_open(seq_file_t *m, const seq_operations_t *op, void *private);
+
+/**
+ * @brief Prepares m for a file generated by one show() call
+ */
+void single_open(seq_file_t *m, int (*show)(seq_file_t *m, void *v), void *private);
+
+/**
+ * @brief Frees the buffer; m may be opened again afterwards
+ */
+void seq_release(seq_file_t *m);
+
+/**
+ * @brief Copies up to count bytes of the file starting at pos
+ * @return Bytes copied (0 at end of file), or negative error code
+ */
+int seq_read(seq_file_t *m, off_t pos, void *out, size_t count);
+
+/**
+ * @brief Appends formatted text to the current record
+ * @details Supports the kernel printf subset (%d %u %x %s %c %p, width and
+ * zero padding, l modifier). Output that does not fit sets m->overflow.
+ */
+void seq_printf(seq_file_t *m, const char *fmt, ...);
+void seq_vprintf(seq_file_t *m, const char *fmt, va_list args);
+
+/** @brief Appends a string, a character, or an unsigned 64-bit decimal */
+void seq_puts(seq_file_t *m, const char *s);
+void seq_putc(seq_file_t *m, char c);
+void seq_put_u64(seq_file_t *m, uint64_t value);
+
+/** @brief True once output for the current record has been truncated */
+static inline bool seq_has_overflowed(const seq_file_t *m)
+{
+    return m->overflow;
+}
+
+#endif // SEQ_FILE_H
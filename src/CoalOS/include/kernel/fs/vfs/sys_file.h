@@ -25,7 +25,11 @@ extern "C" {
 
 // File status flags
 #define O_APPEND    0x0400  // Set append mode (Bit 10)
-// Add O_NONBLOCK, O_SYNC, O_DSYNC, O_DIRECTORY, O_NOFOLLOW etc. as needed
+#ifndef O_NONBLOCK
+#define O_NONBLOCK  0x0800  // Non-blocking I/O (Bit 11)
+#endif
+#define O_DIRECT    0x4000  // Sector-aligned I/O bypasses the buffer cache (Bit 14)
+// Add O_SYNC, O_DSYNC, O_DIRECTORY, O_NOFOLLOW etc. as needed
 
 // === Whence Values for lseek === (Unchanged)
 #ifndef SEEK_SET
@@ -47,6 +51,24 @@ ssize_t sys_read(int fd, void *kbuf, size_t count);
 ssize_t sys_write(int fd, const void *kbuf, size_t count);
 int sys_close(int fd);
 off_t sys_lseek(int fd, off_t offset, int whence);
+ssize_t sys_pread(int fd, void *kbuf, size_t count, off_t pos);
+ssize_t sys_pwrite(int fd, const void *kbuf, size_t count, off_t pos);
+int sys_fsync(int fd, bool datasync);
+int sys_syncfs(int fd);
+int sys_ftruncate(int fd, off_t length);
+
+/**
+ * @brief Installs an open VFS file in the caller's lowest free descriptor
+ * @details Used by objects created without a path (timerfd, ...). On failure
+ * the file is closed.
+ * @return File descriptor, or negative POSIX errno
+ */
+int sys_file_install(file_t *vfs_file, int flags);
+
+/**
+ * @brief Sets up the read-ahead buffers
+ */
+void vfs_performance_init(void);
 
 
 #ifdef __cplusplus
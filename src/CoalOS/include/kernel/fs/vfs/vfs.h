@@ -37,8 +37,18 @@ typedef struct file {
     uint32_t    flags;    // Open flags
     off_t       offset;   // Current file offset (protected by lock)
     spinlock_t  lock;     // <<< ADDED: Lock to protect file offset and concurrent driver access
+    volatile uint32_t refcount; // Descriptors and in-flight references (fork, SCM_RIGHTS)
 } file_t;
 
+/*
+ * Directory entry emitter used by getdents. Called once per entry with the
+ * position cookie of the entry that follows it. Returns 0 if the entry was
+ * accepted, non-zero if the caller's buffer is full (iteration stops and the
+ * entry is returned again on the next call).
+ */
+typedef int (*vfs_filldir_t)(void *ctx, const char *name, size_t namelen,
+                             uint32_t ino, uint8_t d_type, off_t next_pos);
+
 /* VFS driver interface */
 typedef struct vfs_driver {
     const char *fs_name;  // Filesystem name (e.g., "FAT32")
@@ -57,6 +67,9 @@ typedef struct vfs_driver {
     /* Lseek: returns new file offset or negative error code. */
     off_t (*lseek)(file_t *file, off_t offset, int whence);
     int (*readdir)(file_t *dir_file, struct dirent *d_entry_out, size_t entry_index); // Add this
+    /* Getdents: emits entries from dir_file->offset via filldir, advancing the
+     * offset past each accepted entry. Returns entries emitted or negative error. */
+    int (*getdents)(file_t *dir_file, vfs_filldir_t filldir, void *ctx);
     int (*unlink)(void *fs_context, const char *path); // Add this
     int (*mkdir)(void *fs_context, const char *path, mode_t mode); // Add this
     int (*rmdir)(void *fs_context, const char *path); // Add this
@@ -67,6 +80,16 @@ typedef struct vfs_driver {
     ssize_t (*write_inode)(void *fs_context, uint32_t inode_number,
                            uint64_t offset, const void *buffer, size_t size);
     int (*stat_inode)(void *fs_context, uint32_t inode_number, struct stat *st);
+    /* Fstat: identity (st_dev/st_ino), size and mtime of an open file. Optional. */
+    int (*fstat)(file_t *file, struct stat *st);
+    /* Fsync: writes the file's data and the metadata needed to reach it to
+     * stable storage (device cache flushed). datasync skips timestamp-only
+     * metadata. Optional; the VFS falls back to a global sync. */
+    int (*fsync)(file_t *file, bool datasync);
+    /* Syncfs: writes everything on a mounted filesystem to stable storage. Optional. */
+    int (*syncfs)(void *fs_context);
+    /* Ftruncate: sets the file's size; growing reads back zeros. Optional. */
+    int (*ftruncate)(file_t *file, off_t length);
     
     struct vfs_driver *next;
 } vfs_driver_t;
@@ -83,13 +106,26 @@ int vfs_register_driver(vfs_driver_t *driver);
 int vfs_unregister_driver(vfs_driver_t *driver);
 vfs_driver_t *vfs_get_driver(const char *fs_name);
 int vfs_mount_root(const char *mount_point, const char *fs_name, const char *device);
+int vfs_mount(const char *mount_point, const char *fs_name, const char *device);
 int vfs_unmount_root(void);
 int vfs_shutdown(void);
 file_t *vfs_open(const char *path, int flags);
 int vfs_close(file_t *file);
+/* Takes another reference to an open file; vfs_close() drops one. */
+file_t *vfs_file_get(file_t *file);
 int vfs_read(file_t *file, void *buf, size_t len);
 int vfs_write(file_t *file, const void *buf, size_t len);
 off_t vfs_lseek(file_t *file, off_t offset, int whence);
+/* Positional read/write at pos; the file offset is left unchanged. */
+int vfs_pread(file_t *file, void *buf, size_t len, off_t pos);
+int vfs_pwrite(file_t *file, const void *buf, size_t len, off_t pos);
+int vfs_fstat(file_t *file, struct stat *st);
+int vfs_fsync(file_t *file, bool datasync);
+int vfs_syncfs(file_t *file);
+int vfs_ftruncate(file_t *file, off_t length);
+void vfs_sync(void);
+int vfs_readdir(file_t *dir_file, struct dirent *d_entry_out, size_t entry_index);
+int vfs_getdents(file_t *dir_file, vfs_filldir_t filldir, void *ctx);
 int vfs_unlink(const char *path);
 int vfs_mkdir(const char *path, mode_t mode);
 int vfs_rmdir(const char *path);
@@ -15,6 +15,7 @@
 // Includes
 //============================================================================
 #include <kernel/core/types.h>
+#include <kernel/core/error.h>
 #include <libc/stdint.h>
 #include <libc/stdbool.h>
 
@@ -233,13 +234,47 @@ void irq_hal_eoi(uint8_t irq);
 
 #define IRQ_MAX_STANDARD                16      ///< Maximum standard IRQ number
 
+// IRQ n is delivered on vector 32 + n. With the I/O APIC, 16-23 are its
+// remaining pins (PCI INTx) and 24-31 are handed out for MSI.
+#define IRQ_HAL_MAX_IRQS                32      ///< IRQs with an IDT stub
+#define IRQ_MSI_FIRST                   24      ///< First MSI IRQ
+#define IRQ_MSI_COUNT                   8       ///< MSI IRQs available
+
+//============================================================================
+// x86 APIC Extensions
+//============================================================================
+
+/**
+ * @brief Reports which controller irq_hal_init() selected
+ */
+irq_controller_type_t irq_hal_controller(void);
+
+/**
+ * @brief Allocates an MSI IRQ and composes its message
+ *
+ * The caller writes address/data into the device's MSI capability and
+ * enables it; the HAL only owns the vector. Requires the APIC.
+ *
+ * @param cpu Logical CPU the interrupt is steered to
+ * @param irq Receives the allocated IRQ (IRQ_MSI_FIRST..)
+ * @param address Receives the MSI address (upper 32 bits are zero)
+ * @param data Receives the MSI data (fixed delivery, edge)
+ * @return E_SUCCESS, E_NOTSUP without the APIC, or E_NOSPC when all are in use
+ */
+error_t irq_hal_alloc_msi(uint32_t cpu, uint8_t *irq, uint32_t *address, uint32_t *data);
+
+/**
+ * @brief Releases an IRQ from irq_hal_alloc_msi() and its handler
+ */
+void irq_hal_free_msi(uint8_t irq);
+
 //============================================================================
 // Architecture-Specific Initialization
 //============================================================================
 
 #ifdef __i386__
 /**
- * @brief Initialize x86-32 IRQ HAL (8259 PIC-based)
+ * @brief Initialize x86-32 IRQ HAL (local/I/O APIC, 8259 PIC fallback)
  * @return 0 on success, negative error code on failure
  */
 error_t x86_32_irq_hal_init(void);
@@ -0,0 +1,42 @@
+/**
+ * @file math64.h
+ * @brief 64-bit by 32-bit division without libgcc
+ *
+ * The kernel is not linked against libgcc, so plain '/' or '%' on 64-bit
+ * operands fails to link (__udivdi3/__umoddi3). These helpers split the
+ * dividend into two DIVL steps, each of which is guaranteed not to overflow.
+ */
+
+#ifndef MATH64_H
+#define MATH64_H
+
+#include <libc/stdint.h>
+#include <libc/stddef.h>
+
+/**
+ * @brief Divides a 64-bit value by a 32-bit divisor
+ * @param dividend Value to divide
+ * @param divisor Non-zero divisor
+ * @param remainder Receives dividend % divisor if non-NULL
+ * @return dividend / divisor
+ */
+static inline uint64_t div_u64_rem(uint64_t dividend, uint32_t divisor, uint32_t *remainder) {
+    uint32_t hi = (uint32_t)(dividend >> 32);
+    uint32_t lo = (uint32_t)dividend;
+
+    // High word first; its remainder becomes the high half of the second step
+    uint32_t q_hi = hi / divisor;
+    uint32_t rem = hi % divisor;
+    uint32_t q_lo;
+    asm("divl %4" : "=a"(q_lo), "=d"(rem) : "a"(lo), "d"(rem), "rm"(divisor));
+
+    if (remainder) *remainder = rem;
+    return ((uint64_t)q_hi << 32) | q_lo;
+}
+
+/** @brief dividend / divisor for a 32-bit divisor */
+static inline uint64_t div_u64(uint64_t dividend, uint32_t divisor) {
+    return div_u64_rem(dividend, divisor, NULL);
+}
+
+#endif // MATH64_H
@@ -0,0 +1,152 @@
+/**
+ * @file percpu_counter.h
+ * @brief Per-CPU statistics counters with a global name registry
+ * @author Coal OS Kernel Team
+ * @version 1.0
+ *
+ * @details Each counter keeps one cache-line sized slot per CPU. Hot paths
+ * only touch their own CPU's slot; once a slot drifts by more than
+ * PERCPU_COUNTER_BATCH it is folded into the shared total under the
+ * counter's lock. Readers choose between the cheap approximate total
+ * (percpu_counter_read) and the exact sum over all slots (percpu_counter_sum).
+ *
+ * Registered counters are listed by name through the stats device
+ * (/dev/stats).
+ */
+
+#ifndef PERCPU_COUNTER_H
+#define PERCPU_COUNTER_H
+
+#include <kernel/core/types.h>
+#include <kernel/sync/spinlock.h>
+#include <kernel/cpu/get_cpu_id.h>
+#include <libc/stdint.h>
+#include <libc/stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// Configuration
+//============================================================================
+
+#define PERCPU_COUNTER_BATCH    32   // Max per-CPU drift before folding
+#define PERCPU_CACHE_LINE_SIZE  64   // Slot padding to avoid false sharing
+#define PERCPU_COUNTER_NAME_MAX 48   // Longest registered name (incl. NUL)
+
+//============================================================================
+// Types
+//============================================================================
+
+typedef struct {
+    int32_t value;
+    uint8_t pad[PERCPU_CACHE_LINE_SIZE - sizeof(int32_t)];
+} __attribute__((aligned(PERCPU_CACHE_LINE_SIZE))) percpu_counter_slot_t;
+
+typedef struct percpu_counter {
+    percpu_counter_slot_t slots[MAX_CPUS]; // Per-CPU deltas not yet folded
+    int64_t count;                         // Folded total (protected by lock)
+    spinlock_t lock;                       // Serializes folds and exact reads
+    const char *name;                      // Registry name, e.g. "bcache.hits"
+    struct percpu_counter *next;           // Registry link
+    bool registered;
+} percpu_counter_t;
+
+/**
+ * @brief Callback for percpu_counter_for_each()
+ * @return Non-zero to stop iteration
+ */
+typedef int (*percpu_counter_visit_t)(const char *name, int64_t value, void *ctx);
+
+//============================================================================
+// Lifecycle and Registry
+//============================================================================
+
+/**
+ * @brief Initializes a counter and adds it to the registry
+ * @param counter Counter to initialize (usually static storage)
+ * @param name Registry name; must outlive the counter
+ * @param initial Initial value
+ * @note Calling this again on a registered counter just resets its value.
+ */
+void percpu_counter_init(percpu_counter_t *counter, const char *name, int64_t initial);
+
+/**
+ * @brief Removes a counter from the registry
+ */
+void percpu_counter_destroy(percpu_counter_t *counter);
+
+/**
+ * @brief Looks up a registered counter by name
+ * @return Counter, or NULL if no counter has that name
+ */
+percpu_counter_t *percpu_counter_find(const char *name);
+
+/**
+ * @brief Calls visit for every registered counter with its exact value
+ * @return Number of counters visited
+ */
+int percpu_counter_for_each(percpu_counter_visit_t visit, void *ctx);
+
+//============================================================================
+// Update and Read
+//============================================================================
+
+/**
+ * @brief Slow path of percpu_counter_add(): folds the local slot into the total
+ */
+void percpu_counter_fold(percpu_counter_t *counter, int cpu);
+
+/**
+ * @brief Adds delta to the current CPU's slot, folding when it exceeds the batch
+ */
+static inline void percpu_counter_add(percpu_counter_t *counter, int32_t delta)
+{
+    uintptr_t flags = local_irq_save();
+    int cpu = get_cpu_id();
+    if (cpu < 0 || cpu >= MAX_CPUS) {
+        cpu = 0;
+    }
+    int32_t v = counter->slots[cpu].value + delta;
+    counter->slots[cpu].value = v;
+    if (v >= PERCPU_COUNTER_BATCH || v <= -PERCPU_COUNTER_BATCH) {
+        percpu_counter_fold(counter, cpu);
+    }
+    local_irq_restore(flags);
+}
+
+static inline void percpu_counter_inc(percpu_counter_t *counter)
+{
+    percpu_counter_add(counter, 1);
+}
+
+static inline void percpu_counter_dec(percpu_counter_t *counter)
+{
+    percpu_counter_add(counter, -1);
+}
+
+/**
+ * @brief Returns the folded total without visiting other CPUs' slots
+ * @note May lag the true value by up to MAX_CPUS * PERCPU_COUNTER_BATCH
+ */
+static inline int64_t percpu_counter_read(percpu_counter_t *counter)
+{
+    return counter->count;
+}
+
+/**
+ * @brief Returns the exact value (folded total plus all per-CPU slots)
+ */
+int64_t percpu_counter_sum(percpu_counter_t *counter);
+
+/**
+ * @brief Resets the counter (total and all slots) to value
+ */
+void percpu_counter_set(percpu_counter_t *counter, int64_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PERCPU_COUNTER_H
@@ -0,0 +1,134 @@
+/**
+ * @file tunables.h
+ * @brief Named kernel parameters set from the boot command line or at runtime
+ * @author Coal OS Kernel Team
+ * @version 1.0
+ *
+ * @details A tunable binds a name of the form "<group>.<name>" (for example
+ * "vm.page_cache_max_pages") to a uint32_t owned by the subsystem that uses
+ * it. Hot paths keep reading their own variable; the registry only decides
+ * what may be written there.
+ *
+ * Values come from two places:
+ *  - the kernel command line (KERNEL_CMDLINE in limine.cfg), as space
+ *    separated "group.name=value" words, applied when the owner registers;
+ *  - /proc/sys/<group>/<name> after boot, unless the tunable is
+ *    TUNABLE_BOOT_ONLY (sizes fixed once a table has been allocated).
+ *
+ * Every write is range checked, then passed to the optional validate()
+ * hook; changed() runs afterwards, outside the registry lock, so it may
+ * sleep (e.g. to shrink a cache down to a lowered limit).
+ */
+
+#ifndef TUNABLES_H
+#define TUNABLES_H
+
+#include <kernel/core/types.h>
+#include <libc/stdint.h>
+#include <libc/stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// Configuration
+//============================================================================
+
+#define TUNABLE_NAME_MAX        32    // Longest "group.name" (incl. NUL)
+#define TUNABLES_CMDLINE_MAX    512   // Command line bytes kept (incl. NUL)
+
+//============================================================================
+// Types
+//============================================================================
+
+typedef enum {
+    TUNABLE_U32 = 0,        // Decimal or 0x-prefixed hex within [min, max]
+    TUNABLE_BOOL            // 0/1, y/n, on/off, true/false
+} tunable_type_t;
+
+#define TUNABLE_BOOT_ONLY   0x0001   // Only the command line may set it
+
+typedef struct tunable {
+    const char *name;                  // "<group>.<name>"; must outlive the tunable
+    const char *desc;                  // One-line description
+    tunable_type_t type;
+    uint32_t flags;                    // TUNABLE_* flags
+    uint32_t *value;                   // Owner's variable, holds the default
+    uint32_t min;                      // Inclusive bounds (TUNABLE_U32 only)
+    uint32_t max;
+    /* Optional extra check; returns 0 or a negative errno. */
+    int  (*validate)(const struct tunable *t, uint32_t value);
+    /* Optional, called after *value changed at runtime. */
+    void (*changed)(const struct tunable *t, uint32_t old_value);
+    struct tunable *next;              // Registry link
+    bool registered;
+} tunable_t;
+
+/**
+ * @brief Callback for tunables_for_each()
+ * @note Runs with the registry lock held and interrupts disabled.
+ * @return Non-zero to stop iteration
+ */
+typedef int (*tunable_visit_t)(const tunable_t *t, void *ctx);
+
+//============================================================================
+// Command Line
+//============================================================================
+
+/**
+ * @brief Records the boot command line; call before any tunable registers
+ * @param cmdline NUL-terminated string, truncated to TUNABLES_CMDLINE_MAX - 1
+ */
+void tunables_set_cmdline(const char *cmdline);
+
+/**
+ * @brief Returns the recorded command line ("" if none was passed)
+ */
+const char *tunables_get_cmdline(void);
+
+//============================================================================
+// Registry
+//============================================================================
+
+/**
+ * @brief Adds a tunable and applies its command line value, if any
+ * @details An invalid command line value is logged and the default kept.
+ * @return 0 on success, -EINVAL for a malformed name or default
+ */
+int tunable_register(tunable_t *t);
+
+/**
+ * @brief Looks a tunable up by its "group.name"
+ */
+tunable_t *tunable_find(const char *name);
+
+/**
+ * @brief Sets a tunable at runtime
+ * @return 0 on success, -EPERM for TUNABLE_BOOT_ONLY, -EINVAL if the value
+ *         is out of range, or the validate() hook's error
+ */
+int tunable_set(tunable_t *t, uint32_t value);
+
+/**
+ * @brief Parses text (as written to /proc/sys) and sets the tunable
+ * @details Surrounding whitespace, including a trailing newline, is ignored.
+ * @return As tunable_set(), or -EINVAL if the text does not parse
+ */
+int tunable_set_string(tunable_t *t, const char *text, size_t len);
+
+/**
+ * @brief Reads the current value
+ */
+uint32_t tunable_get(const tunable_t *t);
+
+/**
+ * @brief Visits every registered tunable until visit returns non-zero
+ */
+void tunables_for_each(tunable_visit_t visit, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TUNABLES_H
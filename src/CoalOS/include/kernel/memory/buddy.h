@@ -129,6 +129,13 @@ size_t buddy_total_space(void);
  */
 void buddy_get_stats(buddy_stats_t *stats);
 
+/**
+ * @brief Counts the blocks on each free list (walks the lists under the lock).
+ * @param counts Receives the number of free blocks of order i in counts[i];
+ *               orders below MIN_ORDER are always zero.
+ */
+void buddy_get_free_blocks(uint32_t counts[MAX_ORDER + 1]);
+
 
 void* buddy_alloc_raw(int order);
 
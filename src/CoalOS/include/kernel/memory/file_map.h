@@ -0,0 +1,64 @@
+/**
+ * @file file_map.h
+ * @brief File-backed private mappings with shared read-only frames
+ *
+ * Used by the ELF loader for PT_LOAD segments and by mmap2() for file
+ * mappings (ld.so mapping libc.so). Page-aligned file pages come from a
+ * cache of physical frames keyed by file identity (st_dev, st_ino, st_size,
+ * st_mtime), so every process running the same program text or shared
+ * library maps one physical copy. Writable mappings get the same frames
+ * read-only and copy on first write. Pages that mix file data with zero
+ * fill are private copies.
+ */
+
+#ifndef FILE_MAP_H
+#define FILE_MAP_H
+
+#include <kernel/core/types.h>
+#include <kernel/fs/vfs/vfs.h>
+
+#define FILE_MAP_MAX_OBJECTS 16    // Files with cached frames; LRU replacement
+
+/**
+ * @brief Maps file contents into a page directory
+ *
+ * Page i of [vaddr, vaddr + len) receives the file bytes at offset +
+ * i * PAGE_SIZE, except that only the first file_bytes bytes of the range
+ * come from the file; the remainder is zero-filled. Each mapped frame holds
+ * one reference for its PTE, so paging_free_user_space() releases shared and
+ * private frames alike. On failure nothing stays mapped.
+ *
+ * With PAGE_RW in page_flags the range must be covered by a private VM_WRITE
+ * VMA, which is what turns write faults on shared frames into copies.
+ *
+ * @param pd_phys    Target page directory
+ * @param vaddr      Page-aligned start address
+ * @param len        Page-aligned length
+ * @param page_flags PTE flags
+ * @param file       Open file (offset is moved)
+ * @param offset     File offset of vaddr
+ * @param file_bytes Bytes of the range backed by the file
+ * @return 0 on success, negative FS_ERR_* code on failure
+ */
+int file_map_private(uint32_t *pd_phys, uintptr_t vaddr, size_t len, uint32_t page_flags,
+                     file_t *file, uint32_t offset, size_t file_bytes);
+
+/**
+ * @brief Drops the cached frames of a file that is being modified
+ * @details Processes that already map the old frames keep them.
+ */
+void file_map_invalidate(dev_t dev, ino_t ino);
+
+/**
+ * @brief Releases cached files, least recently used first, under memory pressure
+ * @param target_pages Frames the caller would like back
+ * @return Frames actually returned to the allocator (ones no process maps)
+ */
+uint32_t file_map_reclaim(uint32_t target_pages);
+
+/**
+ * @brief Reports cache occupancy
+ */
+void file_map_get_stats(uint32_t *objects, uint32_t *cached_pages);
+
+#endif // FILE_MAP_H
@@ -61,6 +61,18 @@ void get_frame(uintptr_t phys_addr);
  */
 void put_frame(uintptr_t phys_addr);
 
+/**
+ * @brief Drops one reference on each of several frames.
+ *
+ * Same semantics as calling put_frame() on every entry, but the refcount
+ * lock is taken once for the whole batch. Used by address-space teardown.
+ *
+ * @param phys_addrs Page-aligned frame addresses; reused as scratch space,
+ *                   so the contents are undefined on return.
+ * @param count Number of entries.
+ */
+void put_frames(uintptr_t *phys_addrs, size_t count);
+
 /**
  * @brief Gets the current reference count for a physical frame.
  *
@@ -28,6 +28,9 @@
 #define VM_FILEBACKED   0x00000040  // VMA is backed by a file
 #define VM_USER         0x00000080  // VMA is accessible by user mode (redundant with PAGE_USER?)
 
+// Default search start for mmap() placements without an address hint
+#define MMAP_BASE_VIRT  0x40000000u
+
 // --- ADDED VMA Type Flags (Example bits) ---
 #define VM_HEAP         0x00000100  // VMA represents the process heap (managed by brk/sbrk)
 #define VM_STACK        0x00000200  // VMA represents a stack region
@@ -59,6 +62,7 @@ typedef struct mm_struct {
     uint32_t *pgd_phys;         // Physical address of the process's page directory
     spinlock_t lock;            // Lock protecting this mm_struct (especially the VMA tree)
     int map_count;              // Number of VMAs in the tree
+    struct vma_struct *mmap_cache; // Last VMA returned by find_vma (protected by lock)
 
     // Optional fields for tracking specific memory regions
     uintptr_t start_code, end_code; // Virtual address range of executable code
@@ -93,6 +97,24 @@ void destroy_mm(mm_struct_t *mm);
  */
 vma_struct_t *find_vma(mm_struct_t *mm, uintptr_t addr);
 
+/**
+ * @brief Finds a free, page-aligned range of user address space.
+ * Searches upwards from hint (MMAP_BASE_VIRT if 0) to the user stack area.
+ * @param mm Pointer to the process's mm_struct.
+ * @param hint Preferred start address.
+ * @param len Length of the range in bytes.
+ * @return Start of a range no VMA overlaps, or 0 if none is large enough.
+ */
+uintptr_t mm_get_unmapped_area(mm_struct_t *mm, uintptr_t hint, size_t len);
+
+/**
+ * @brief Checks that [addr, addr + len) lies in mappable user address space.
+ * The range must not wrap and must stay within [USER_SPACE_START_VIRT,
+ * USER_STACK_BOTTOM_VIRT); page tables outside it are shared with the kernel.
+ * @return true if a caller-chosen (MAP_FIXED) mapping may be placed there.
+ */
+bool mm_is_user_range(uintptr_t addr, size_t len);
+
 /**
  * @brief Inserts a new VMA into the process's address space.
  * Handles merging with adjacent compatible VMAs if possible.
@@ -135,5 +157,33 @@ int remove_vma_range(mm_struct_t *mm, uintptr_t start, size_t length); // <-- Ad
  */
 int handle_vma_fault(mm_struct_t *mm, vma_struct_t *vma, uintptr_t address, uint32_t error_code);
 
+/**
+ * @brief Copies the page table entries of one VMA into a child for fork.
+ * VM_SHARED pages map the same frame with the same permissions in both;
+ * private writable pages are write-protected in both, so the first write on
+ * either side copies the page (COW). Every copied PTE takes a frame reference.
+ * @param dst Child memory structure, already holding a copy of vma.
+ * @param src Parent memory structure (the current address space).
+ * @return 0 on success, negative error code otherwise.
+ */
+int mm_copy_vma_pages(mm_struct_t *dst, mm_struct_t *src, vma_struct_t *vma);
+
+/**
+ * @brief Pins the user pages backing a buffer for direct transfers.
+ * Each page is faulted in (COW broken for write) and its frame referenced,
+ * so it stays resident and exclusive while the kernel or a device accesses
+ * it with interrupts off.
+ * @param frames Receives the pinned frames, one per page.
+ * @param max_frames Capacity of frames.
+ * @return Number of pages pinned, or negative error code (nothing pinned).
+ */
+int mm_pin_user_pages(mm_struct_t *mm, uintptr_t start, size_t len, bool write,
+                      uintptr_t *frames, size_t max_frames);
+
+/**
+ * @brief Releases frames pinned by mm_pin_user_pages.
+ */
+void mm_unpin_user_pages(uintptr_t *frames, size_t count);
+
 
 #endif // MM_H
@@ -24,6 +24,23 @@
  */
 void page_fault_handler(registers_t* regs);
 
+/**
+ * @brief Try to service a kernel-mode fault raised by a user copy routine
+ *
+ * Called from the page fault ISR for kernel faults whose EIP has an
+ * exception-table entry. Demand-pages or COW-breaks the user page if the
+ * faulting access is allowed by its VMA.
+ * @param regs Register state at time of fault
+ * @return 1 if the fault was resolved and the instruction can be retried,
+ *         0 if the caller should take the exception-table fixup
+ */
+int page_fault_resolve_uaccess(registers_t* regs);
+
+/**
+ * @brief Register page fault counters with the percpu_counter registry
+ */
+void page_fault_stats_init(void);
+
 /**
  * @brief Get page fault statistics
  * @param total_faults Output total number of page faults
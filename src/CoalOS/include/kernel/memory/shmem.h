@@ -0,0 +1,63 @@
+/**
+ * @file shmem.h
+ * @brief Shared memory objects (POSIX shm and shared anonymous mappings)
+ *
+ * A shared memory object is a sparse array of page frames with a size,
+ * allocated zeroed on first touch. Named objects live in a small in-memory
+ * filesystem mounted at SHM_MOUNT_POINT, which is where shm_open() and
+ * shm_unlink() in the C library look ("/dev/shm/<name>"). mmap() with
+ * MAP_SHARED | MAP_ANONYMOUS creates an unnamed object of the mapping's size.
+ *
+ * A MAP_SHARED VMA keeps a reference on the object's file in vm_file and the
+ * fault handler maps the object's own frames, so every process mapping the
+ * object - including a forked child, whose copied VMA shares the file - sees
+ * the same physical pages.
+ */
+
+#ifndef SHMEM_H
+#define SHMEM_H
+
+#include <kernel/core/types.h>
+#include <kernel/fs/vfs/vfs.h>
+#include <kernel/memory/mm.h>
+
+#define SHM_MOUNT_POINT "/dev/shm"
+#define SHM_NAME_MAX    255
+#define SHM_MAX_SIZE    0x10000000  // Same ceiling as a single mmap()
+
+/**
+ * @brief Registers the shm driver and mounts it at SHM_MOUNT_POINT
+ * @return 0 on success, negative FS_ERR_* code on failure
+ */
+int shmem_init(void);
+
+/** @brief True if file refers to a shared memory object */
+bool shmem_is_shm(file_t *file);
+
+/**
+ * @brief Creates an unnamed object of the given size
+ * @details Used for MAP_SHARED | MAP_ANONYMOUS. The file is not installed in
+ * any descriptor table; release it with vfs_close().
+ * @return The file, or NULL when out of memory
+ */
+file_t *shmem_file_create(size_t size);
+
+/**
+ * @brief Maps an object into mm as a MAP_SHARED mapping at addr
+ * @details Pages are faulted in lazily by handle_vma_fault().
+ * @param offset Object offset of addr (page-aligned)
+ * @param prot PROT_* bits
+ * @return 0, or negative error code
+ */
+int shmem_mmap(file_t *file, mm_struct_t *mm, uintptr_t addr, size_t length,
+               uint32_t offset, uint32_t prot);
+
+/**
+ * @brief Returns the frame backing the page at offset, allocating it if needed
+ * @details The returned frame carries a new reference for the caller's PTE.
+ * @return 0, FS_ERR_OUT_OF_BOUNDS past the end of the object, or
+ *         FS_ERR_OUT_OF_MEMORY
+ */
+int shmem_get_page(file_t *file, uint32_t offset, uintptr_t *frame_out);
+
+#endif // SHMEM_H
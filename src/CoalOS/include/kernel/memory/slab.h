@@ -41,6 +41,7 @@ typedef struct slab_cache {
     void (*constructor)(void *obj);
     void (*destructor)(void *obj);
 
+    struct slab_cache *next_cache; // Link in the list walked by slab_for_each_cache().
 } slab_cache_t;
 
 
@@ -106,6 +107,18 @@ void slab_destroy(slab_cache_t *cache);
  */
 void slab_cache_stats(slab_cache_t *cache, unsigned long *out_alloc, unsigned long *out_free);
 
+/**
+ * slab_for_each_cache
+ *
+ * Calls visit for every cache created and not yet destroyed. visit runs with
+ * the cache list lock held and interrupts off; it may take cache->lock (e.g.
+ * through slab_cache_stats) but must not block, create or destroy caches.
+ *
+ * @param visit Callback invoked once per cache.
+ * @param ctx   Opaque pointer passed to visit.
+ */
+void slab_for_each_cache(void (*visit)(slab_cache_t *cache, void *ctx), void *ctx);
+
 
 #ifdef __cplusplus
 }
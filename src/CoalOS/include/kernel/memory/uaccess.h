@@ -21,10 +21,12 @@ typedef const void * /*__attribute__((address_space(0)))*/ const_kernelptr_t; //
 
 /**
  * @brief Checks if a userspace memory range is potentially accessible.
+ * Only the address range is checked (non-NULL, no wrap, below kernel space);
+ * unmapped or read-only pages are caught by the copy routines' fault fixups.
  * @param type Verification type: VERIFY_READ, VERIFY_WRITE.
  * @param uaddr The starting user virtual address.
  * @param size The size of the memory range in bytes.
- * @return `true` if the range seems valid based on VMA checks, `false` otherwise.
+ * @return `true` if the range lies entirely in user space, `false` otherwise.
  */
 bool access_ok(int type, const_userptr_t uaddr, size_t size);
 
@@ -48,6 +50,17 @@ size_t copy_from_user(kernelptr_t k_dst, const_userptr_t u_src, size_t n) __attr
 size_t copy_to_user(userptr_t u_dst, const_kernelptr_t k_src, size_t n) __attribute__((nonnull (1, 2)));
 
 
+/**
+ * @brief Finds the length of a NUL-terminated userspace string.
+ * Reads the string a word at a time in page-bounded chunks.
+ * @param u_str User string virtual address.
+ * @param maxlen Maximum number of bytes to examine.
+ * @return Length excluding the NUL if one is found within maxlen bytes,
+ *         maxlen if no terminator was found, or -EFAULT on an unreadable address.
+ */
+long strnlen_user(const_userptr_t u_str, size_t maxlen);
+
+
 // --- Assembly Helper Prototypes (Internal Use) ---
 extern size_t _raw_copy_from_user(void *k_dst, const void *u_src, size_t n);
 extern size_t _raw_copy_to_user(void *u_dst, const void *k_src, size_t n);
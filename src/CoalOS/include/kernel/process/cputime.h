@@ -0,0 +1,52 @@
+/**
+ * @file cputime.h
+ * @brief Per-task user/system CPU time accounting
+ *
+ * Time is charged at every mode boundary: kernel entry from user mode
+ * (syscall, interrupt), the return to user mode, and context switches.
+ * Each boundary adds the TSC delta since the previous one to the task's
+ * user or system time. Until the TSC is calibrated, or on CPUs without
+ * one, the timer tick charges whole ticks instead.
+ */
+
+#ifndef CPUTIME_H
+#define CPUTIME_H
+
+#include <kernel/process/scheduler.h>
+#include <libc/stdint.h>
+#include <libc/stdbool.h>
+
+#define NSEC_PER_SEC    1000000000u
+#define NSEC_PER_TICK   1000000u     // 1 kHz scheduler tick
+
+/** @brief Kernel entered from user mode (current task). */
+void cputime_user_exit(void);
+
+/** @brief About to return to user mode (current task). */
+void cputime_user_enter(void);
+
+/**
+ * @brief Charges the outgoing task and starts the incoming task's clock
+ * @note Called from schedule() with interrupts disabled
+ */
+void cputime_switch(tcb_t *prev, tcb_t *next);
+
+/**
+ * @brief Tick-based fallback charge while no calibrated TSC is available
+ * @param user_mode True if the tick interrupted user mode
+ */
+void cputime_tick(bool user_mode);
+
+/**
+ * @brief Reads a task's CPU time, including the still-running interval
+ * @param utime Receives user time in ns (may be NULL)
+ * @param stime Receives system time in ns (may be NULL)
+ */
+void cputime_task_read(tcb_t *task, uint64_t *utime, uint64_t *stime);
+
+/**
+ * @brief Folds a finished task's CPU time into its process
+ */
+void cputime_task_exit(tcb_t *task);
+
+#endif // CPUTIME_H
@@ -51,7 +51,12 @@
 /* Program header types */
 #define PT_NULL    0
 #define PT_LOAD    1
-// etc...
+#define PT_DYNAMIC 2
+#define PT_INTERP  3
+#define PT_NOTE    4
+#define PT_SHLIB   5
+#define PT_PHDR    6
+#define PT_GNU_STACK 0x6474e551
 
 /* Program header flags */
 #define PF_X       0x1
@@ -95,4 +100,87 @@ typedef struct {
     Elf32_Word p_align;  /* Segment alignment */
 } Elf32_Phdr;
 
+/* ---- Dynamic linking ---- */
+
+/* d_tag values */
+#define DT_NULL     0
+#define DT_NEEDED   1
+#define DT_PLTRELSZ 2
+#define DT_PLTGOT   3
+#define DT_HASH     4
+#define DT_STRTAB   5
+#define DT_SYMTAB   6
+#define DT_RELA     7
+#define DT_STRSZ    10
+#define DT_SYMENT   11
+#define DT_INIT     12
+#define DT_FINI     13
+#define DT_SONAME   14
+#define DT_REL      17
+#define DT_RELSZ    18
+#define DT_RELENT   19
+#define DT_PLTREL   20
+#define DT_JMPREL   23
+#define DT_BIND_NOW 24
+#define DT_FLAGS    30
+#define DF_BIND_NOW 0x8
+
+typedef struct {
+    Elf32_Sword d_tag;
+    union {
+        Elf32_Word d_val;
+        Elf32_Addr d_ptr;
+    } d_un;
+} Elf32_Dyn;
+
+/* Symbols */
+#define SHN_UNDEF   0
+#define STB_LOCAL   0
+#define STB_GLOBAL  1
+#define STB_WEAK    2
+#define ELF32_ST_BIND(i) ((i) >> 4)
+#define ELF32_ST_TYPE(i) ((i) & 0xf)
+
+typedef struct {
+    Elf32_Word    st_name;
+    Elf32_Addr    st_value;
+    Elf32_Word    st_size;
+    unsigned char st_info;
+    unsigned char st_other;
+    Elf32_Half    st_shndx;
+} Elf32_Sym;
+
+/* i386 relocations (REL, implicit addend) */
+#define R_386_NONE      0
+#define R_386_32        1
+#define R_386_PC32      2
+#define R_386_COPY      5
+#define R_386_GLOB_DAT  6
+#define R_386_JMP_SLOT  7
+#define R_386_RELATIVE  8
+#define ELF32_R_SYM(i)  ((i) >> 8)
+#define ELF32_R_TYPE(i) ((unsigned char)(i))
+
+typedef struct {
+    Elf32_Addr r_offset;
+    Elf32_Word r_info;
+} Elf32_Rel;
+
+/* ---- Auxiliary vector (initial process stack) ---- */
+#define AT_NULL   0
+#define AT_IGNORE 1
+#define AT_EXECFD 2
+#define AT_PHDR   3  /* Program headers of the executable */
+#define AT_PHENT  4
+#define AT_PHNUM  5
+#define AT_PAGESZ 6
+#define AT_BASE   7  /* Load address of the interpreter */
+#define AT_FLAGS  8
+#define AT_ENTRY  9  /* Entry point of the executable */
+
+typedef struct {
+    uint32_t a_type;
+    uint32_t a_val;
+} Elf32_auxv_t;
+
 #endif /* ELF_H */
\ No newline at end of file
@@ -9,6 +9,43 @@
 extern "C" {
 #endif
 
+// Load addresses for position-independent images (ET_DYN)
+#define ELF_ET_DYN_BASE  0x10000000u   // PIE main programs
+#define ELF_INTERP_BASE  0x40000000u   // The PT_INTERP dynamic linker
+
+#define ELF_MAX_PHDRS    32
+#define ELF_INTERP_MAX   64            // Longest accepted PT_INTERP path
+
+/**
+ * @brief What a loaded program needs passed on in the initial auxv
+ */
+typedef struct elf_load_info {
+    uintptr_t entry;        // First user instruction: the interpreter's entry if present
+    uintptr_t prog_entry;   // AT_ENTRY: the program's own entry point
+    uintptr_t phdr;         // AT_PHDR: user address of the program headers
+    uint32_t  phent;        // AT_PHENT
+    uint32_t  phnum;        // AT_PHNUM
+    uintptr_t interp_base;  // AT_BASE: interpreter load bias, 0 without PT_INTERP
+    uintptr_t brk;          // Page-aligned end of the program image
+} elf_load_info_t;
+
+/**
+ * @brief Maps a 32-bit ELF program, and its PT_INTERP interpreter, into mm
+ *
+ * Accepts ET_EXEC and ET_DYN images. Only the ELF and program headers are
+ * read, and those come from the exec cache for recently loaded files.
+ * PT_LOAD segments are mapped through file_map_private(), so they share
+ * physical frames with every other process running the same file; writable
+ * segments copy a page on its first write. One VMA is inserted per segment. On failure some segments
+ * may already be mapped; the caller tears the address space down.
+ *
+ * @param path Path to the ELF file
+ * @param mm   Target address space
+ * @param info [out] Entry point and auxv values
+ * @return 0 on success, negative errno on failure
+ */
+int load_elf_program(const char *path, mm_struct_t *mm, elf_load_info_t *info);
+
 /**
  * @brief Loads a 32-bit ELF file into the given process address space.
  *
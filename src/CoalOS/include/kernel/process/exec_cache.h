@@ -0,0 +1,50 @@
+/**
+ * @file exec_cache.h
+ * @brief Cache of validated ELF headers for frequently launched programs
+ *
+ * Keeps the ELF header, program headers and PT_INTERP path of recently
+ * loaded executables and shared objects, keyed by file identity (st_dev,
+ * st_ino, st_size, st_mtime). A hit lets the loader skip reading and
+ * validating the headers; segment pages come from the file_map frame cache,
+ * so a repeated launch maps already-resident frames without any copying.
+ */
+
+#ifndef EXEC_CACHE_H
+#define EXEC_CACHE_H
+
+#include <kernel/core/types.h>
+#include <kernel/process/elf_loader.h>
+
+#define EXEC_CACHE_MAX_IMAGES 8    // LRU replacement beyond this
+
+/**
+ * @brief Parsed, validated headers of one ELF file
+ */
+typedef struct exec_image {
+    Elf32_Ehdr ehdr;
+    Elf32_Phdr phdrs[ELF_MAX_PHDRS];
+    char       interp[ELF_INTERP_MAX];  // PT_INTERP path, empty if none
+} exec_image_t;
+
+/**
+ * @brief Copies the cached headers of the file with identity st into image
+ * @return true on a hit
+ */
+bool exec_cache_lookup(const struct stat *st, exec_image_t *image);
+
+/**
+ * @brief Records validated headers, replacing the least recently used entry
+ */
+void exec_cache_insert(const struct stat *st, const exec_image_t *image);
+
+/**
+ * @brief Forgets a file that is being modified
+ */
+void exec_cache_invalidate(dev_t dev, ino_t ino);
+
+/**
+ * @brief Reports lookup statistics
+ */
+void exec_cache_get_stats(uint32_t *hits, uint32_t *misses, uint32_t *entries);
+
+#endif // EXEC_CACHE_H
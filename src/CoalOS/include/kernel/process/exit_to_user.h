@@ -0,0 +1,86 @@
+/**
+ * @file exit_to_user.h
+ * @brief Interrupt/syscall exit work: preemption, signals, task work
+ * @version 1.0
+ */
+
+#ifndef EXIT_TO_USER_H
+#define EXIT_TO_USER_H
+
+#include <kernel/process/scheduler.h>
+#include <kernel/cpu/isr_frame.h>
+#include <libc/stdint.h>
+#include <libc/stdbool.h>
+
+//============================================================================
+// Task Work
+//============================================================================
+
+/**
+ * @brief Deferred callback run in the target task's context right before it
+ *        returns to user mode. Embed in the owning object; func may free it.
+ */
+typedef struct task_work {
+    struct task_work *next;
+    void (*func)(struct task_work *work);
+} task_work_t;
+
+/**
+ * @brief Queues work on a task and raises TIF_NOTIFY_RESUME
+ * @return 0 on success, -1 on invalid arguments
+ */
+int task_work_add(tcb_t *task, task_work_t *work);
+
+/**
+ * @brief Removes work queued by task_work_add() that has not started
+ * @return true if it was unlinked, false if it was not queued or the task
+ *         has already taken it to run
+ */
+bool task_work_cancel(tcb_t *task, task_work_t *work);
+
+/**
+ * @brief Registers work to run when task is reaped
+ * @details For objects that keep a pointer to the task, so they can drop it
+ *          before the TCB is freed. Runs in the reaper, not in the task.
+ * @return 0 on success, -1 on invalid arguments
+ */
+int task_exit_work_add(tcb_t *task, task_work_t *work);
+
+/** @brief Unregisters work added by task_exit_work_add() */
+bool task_exit_work_cancel(tcb_t *task, task_work_t *work);
+
+/**
+ * @brief Teardown hook for a reaped task
+ * @details Drops work queued for its return to user mode, which can no longer
+ *          run in its context, then runs its exit works.
+ */
+void task_work_exit(tcb_t *task);
+
+//============================================================================
+// Exit Paths
+//============================================================================
+
+/** Thread flags handled by exit_to_user_mode() */
+#define EXIT_TO_USER_WORK (TIF_NEED_RESCHED | TIF_SIGPENDING | TIF_NOTIFY_RESUME)
+
+/**
+ * @brief Processes pending work before returning to user mode
+ * @param frame Trap frame that will be restored by IRET
+ * @note Called with interrupts disabled from the syscall and IRQ exit paths.
+ *       Loops until the current task has no EXIT_TO_USER_WORK left.
+ */
+void exit_to_user_mode(isr_frame_t *frame);
+
+/** @brief Marks entry into an interrupt handler (raises HARDIRQ count). */
+void irq_enter(void);
+
+/**
+ * @brief Leaves interrupt context and runs the matching exit work
+ * @param frame Interrupted context
+ *
+ * Returning to user mode runs exit_to_user_mode(); returning to kernel code
+ * preempts only if that code was preemptible (count zero, IF set).
+ */
+void irq_exit(isr_frame_t *frame);
+
+#endif // EXIT_TO_USER_H
@@ -0,0 +1,127 @@
+/**
+ * @file itimer.h
+ * @brief Per-process interval timers (alarm/setitimer) and POSIX timers
+ *
+ * ITIMER_REAL and POSIX timers ride on ktimers and count wall ticks;
+ * ITIMER_VIRTUAL and ITIMER_PROF are charged from the timer interrupt with
+ * the CPU time the process consumes. Timer state is allocated on first use
+ * and is not inherited across fork.
+ */
+
+#ifndef ITIMER_H
+#define ITIMER_H
+
+#include <kernel/process/process.h>
+#include <kernel/drivers/timer/ktimer.h>
+#include <libc/stdint.h>
+#include <libc/stdbool.h>
+
+//============================================================================
+// Constants (Linux i386 ABI values)
+//============================================================================
+
+#define ITIMER_REAL      0
+#define ITIMER_VIRTUAL   1
+#define ITIMER_PROF      2
+
+#define CLOCK_REALTIME   0
+#define CLOCK_MONOTONIC  1
+#define CLOCK_PROCESS_CPUTIME_ID 2
+#define CLOCK_THREAD_CPUTIME_ID  3
+
+#define SIGEV_SIGNAL     0
+#define SIGEV_NONE       1
+
+#define TIMER_ABSTIME    1
+
+/** POSIX timers per process. */
+#define PTIMER_MAX       8
+
+//============================================================================
+// User ABI Structures (i386: long == 32 bits)
+//============================================================================
+
+typedef struct {
+    int32_t tv_sec;
+    int32_t tv_usec;
+} k_timeval_t;
+
+typedef struct {
+    int32_t tv_sec;
+    int32_t tv_nsec;
+} k_timespec_t;
+
+typedef struct {
+    k_timeval_t it_interval;
+    k_timeval_t it_value;
+} k_itimerval_t;
+
+typedef struct {
+    k_timespec_t it_interval;
+    k_timespec_t it_value;
+} k_itimerspec_t;
+
+//============================================================================
+// Tick Conversion
+//============================================================================
+
+/**
+ * Time-to-tick conversions round up and clamp to KTIMER_MAX_DELTA.
+ * @return 0, or -EINVAL for negative or out-of-range fields
+ */
+int32_t itimer_timeval_to_ticks(const k_timeval_t *tv, uint32_t *ticks);
+int32_t itimer_timespec_to_ticks(const k_timespec_t *ts, uint32_t *ticks);
+void itimer_ticks_to_timeval(uint32_t ticks, k_timeval_t *tv);
+void itimer_ticks_to_timespec(uint32_t ticks, k_timespec_t *ts);
+
+//============================================================================
+// Interval Timers
+//============================================================================
+
+/**
+ * @brief Sets one of the three interval timers
+ * @param old Receives the previous setting if non-NULL
+ * @return 0 or negative errno
+ */
+int itimer_set(pcb_t *proc, int which, const k_itimerval_t *val, k_itimerval_t *old);
+
+/**
+ * @brief Reads one of the three interval timers
+ */
+int itimer_get(pcb_t *proc, int which, k_itimerval_t *cur);
+
+/**
+ * @brief alarm(): one-shot ITIMER_REAL in seconds (0 cancels)
+ * @return Seconds left on the previous alarm, rounded up
+ */
+uint32_t itimer_alarm(pcb_t *proc, uint32_t seconds);
+
+/**
+ * @brief Charges the process's VIRTUAL/PROF timers with the user/system
+ * time accounted since the previous call
+ */
+void itimer_account_cputime(pcb_t *proc);
+
+//============================================================================
+// POSIX Timers
+//============================================================================
+
+/**
+ * @brief timer_create()
+ * @param notify SIGEV_SIGNAL or SIGEV_NONE
+ * @param signo  Signal for SIGEV_SIGNAL
+ * @param id_out Receives the timer id
+ */
+int ptimer_create(pcb_t *proc, int clockid, int notify, int signo, int *id_out);
+int ptimer_settime(pcb_t *proc, int id, int flags, const k_itimerspec_t *val,
+                   k_itimerspec_t *old);
+int ptimer_gettime(pcb_t *proc, int id, k_itimerspec_t *cur);
+int ptimer_getoverrun(pcb_t *proc, int id);
+int ptimer_delete(pcb_t *proc, int id);
+
+/**
+ * @brief Cancels and frees all timers of an exiting process
+ */
+void proc_timers_release(pcb_t *proc);
+
+#endif // ITIMER_H
@@ -11,11 +11,14 @@
 struct mm_struct;
 // Forward declare sys_file if needed, OR include sys_file.h if it only contains declarations/typedefs
 struct sys_file;
+struct tcb;
+struct proc_timers;
 
 // === Configuration Constants ===
 
 // Define the maximum number of open file descriptors per process
 #define MAX_FD 16 // <<<--- DEFINE MAX_FD HERE (adjust value as needed)
+#define PROC_COMM_LEN 16 // Executable name kept in the PCB, NUL included
 
 // Define the size for the kernel stack allocated per process
 // (Must be page-aligned and > 0)
@@ -47,6 +50,7 @@ typedef enum {
 typedef struct pcb {
     uint32_t pid;                   // Process ID
     bool is_kernel_task;            // True if this is a kernel task (not user process)
+    char comm[PROC_COMM_LEN];       // Executable name (basename, truncated), for /proc
     uint32_t *page_directory_phys;  // Physical address of the process's page directory
     uint32_t entry_point;           // Virtual address of the program's entry point
     void *user_stack_top;           // Virtual address for the initial user ESP setting
@@ -70,7 +74,7 @@ typedef struct pcb {
     process_state_t state;          // e.g., PROC_RUNNING, PROC_READY, PROC_SLEEPING - Uncomment if used
     // int priority;
     struct pcb *next;               // For linking in scheduler queues
-    // struct tcb *tcb;              // Link to associated Task Control Block if separate
+    struct tcb *tcb;                // Task Control Block running this process (set by scheduler)
 
     // === Process Hierarchy for Linux Compatibility ===
     uint32_t ppid;                  // Parent Process ID
@@ -106,6 +110,15 @@ typedef struct pcb {
     uint32_t in_signal_handler;     // Non-zero if currently executing a signal handler
     spinlock_t signal_lock;         // Protects signal-related fields
 
+    // === Timers ===
+    struct proc_timers *timers;     // Interval/POSIX timers (allocated on first use)
+
+    // === CPU Time (ns; own time is folded in from the task on exit) ===
+    uint64_t utime_ns;              // User time of exited tasks
+    uint64_t stime_ns;              // System time of exited tasks
+    uint64_t cutime_ns;             // User time of reaped children
+    uint64_t cstime_ns;             // System time of reaped children
+
     // === CPU Context ===
     // Stores the register state when the process is context-switched OUT.
     // This is typically filled by the context switch assembly code.
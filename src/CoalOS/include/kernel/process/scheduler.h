@@ -28,6 +28,9 @@ typedef enum {
     TASK_EXITING    // Intermediate state during termination (optional)
 } task_state_e; // Changed name to avoid conflict if task_state_t is used elsewhere
 
+struct task_work;
+struct worker;
+
 // === Context for Context Switching ===
 // DEAD SIMPLE: context is just a stack pointer where ALL registers are saved
 typedef uint32_t* context_t;
@@ -62,16 +65,51 @@ typedef struct tcb {
     uint32_t       wakeup_time;    // Absolute tick count when to wake up (if SLEEPING)
     uint32_t       exit_code;      // Exit code when ZOMBIE
 
+    // CPU Time Accounting (see cputime.h)
+    uint64_t       utime_ns;       // Time spent in user mode
+    uint64_t       stime_ns;       // Time spent in kernel mode
+    uint64_t       acct_tsc;       // TSC at the last accounting point (0 = not started)
+
     // Wait Queue Links (used for BLOCKED state on mutexes, semaphores, etc.)
     struct tcb    *wait_prev;    // Previous in wait list (NULL if first or not waiting)
     struct tcb    *wait_next;    // Next in wait list (NULL if last or not waiting)
     void          *wait_reason;  // Pointer to object being waited on (optional context)
 
-    // All Tasks List Link
+    // All Tasks List Links
     struct tcb    *all_tasks_next; // Next TCB in the global list of all tasks
+    struct tcb    *all_tasks_prev; // Previous TCB (NULL at the head), for O(1) unlink
+
+    // Deferred Teardown
+    struct tcb    *reap_next;      // Next ZOMBIE on this CPU's deferred-free list
+
+    // Return-to-user Work
+    volatile uint32_t thread_flags;   // TIF_* work bits, checked on exit to user mode
+    uint32_t       saved_preempt_count; // preempt_count while switched out
+    struct task_work *task_works;     // Callbacks queued for TIF_NOTIFY_RESUME
+    struct task_work *exit_works;     // Callbacks run when the task is reaped
+
+    // Workqueue
+    struct worker *wq_worker;         // Set while this task is a pool worker (see workqueue.h)
 
 } tcb_t;
 
+// --- Thread Flags (tcb_t.thread_flags) ---
+#define TIF_NEED_RESCHED   (1u << 0)  // Preempt at the next safe point
+#define TIF_SIGPENDING     (1u << 1)  // Deliverable signal pending
+#define TIF_NOTIFY_RESUME  (1u << 2)  // Run task_works before returning to user
+
+static inline void set_tsk_thread_flag(tcb_t *task, uint32_t flag) {
+    __atomic_fetch_or(&task->thread_flags, flag, __ATOMIC_RELAXED);
+}
+
+static inline void clear_tsk_thread_flag(tcb_t *task, uint32_t flag) {
+    __atomic_fetch_and(&task->thread_flags, ~flag, __ATOMIC_RELAXED);
+}
+
+static inline bool test_tsk_thread_flag(const tcb_t *task, uint32_t flag) {
+    return (task->thread_flags & flag) != 0;
+}
+
 
 // --- Constants ---
 #define IDLE_TASK_PID 0 // Special PID for the idle task
@@ -156,7 +194,8 @@ uint32_t scheduler_get_ticks(void);
 // --- External Declarations ---
 extern volatile bool g_scheduler_ready;
 
-extern volatile bool g_need_reschedule;
+/** @brief Requests a reschedule of the current task at the next safe point. */
+void set_need_resched(void);
 
 // --- External Assembly Function Prototypes ---
 extern void simple_switch(context_t *old_esp, context_t new_esp);
@@ -18,19 +18,33 @@
 //============================================================================
 
 /**
- * @brief Clean up one zombie task if available
- * @note Called periodically by idle task or scheduler
+ * @brief Queue an exiting task for deferred teardown
+ * @param task Current task, already marked TASK_ZOMBIE
+ * @note Called with interrupts disabled just before the final schedule();
+ *       wakes this CPU's reaper task
+ */
+void scheduler_cleanup_defer_task(tcb_t *task);
+
+/**
+ * @brief Start the reaper kernel task that drains the deferred-free list
+ * @note Called once from scheduler_init()
+ */
+void scheduler_cleanup_start_reaper(void);
+
+/**
+ * @brief Reap every task queued for deferred teardown on this CPU
+ * @note Normally done by the reaper task; safe to call from task context
  */
 void scheduler_cleanup_zombies(void);
 
 /**
- * @brief Clean up all available zombie tasks
+ * @brief Same as scheduler_cleanup_zombies(), reporting how many were reaped
  * @note More aggressive cleanup for system shutdown or maintenance
  */
 void scheduler_cleanup_all_zombies(void);
 
 /**
- * @brief Force cleanup of a specific task by PID
+ * @brief Reap a specific queued task by PID
  * @param pid Process ID to forcibly clean up
  * @return True if task was found and cleaned up
  */
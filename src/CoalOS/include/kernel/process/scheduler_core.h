@@ -18,6 +18,11 @@
 // Core Scheduling Functions
 //============================================================================
 
+/**
+ * @brief Registers the per-priority time slice tunables
+ */
+void scheduler_core_init(void);
+
 /**
  * @brief Selects the next task to run based on priority
  * @return Pointer to next task, or NULL if no tasks available
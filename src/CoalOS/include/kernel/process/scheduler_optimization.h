@@ -23,7 +23,6 @@
 //============================================================================
 
 #define SCHED_BITMAP_SIZE       (SCHED_PRIORITY_LEVELS / 32 + 1)
-#define SCHED_LOAD_HISTORY_SIZE 8
 #define SCHED_BOOST_THRESHOLD   10  // Boost priority after N ticks of waiting
 
 //============================================================================
@@ -78,6 +77,19 @@ static inline int bitmap_find_first_set(priority_bitmap_t *bitmap) {
 // Load Tracking
 //============================================================================
 
+// Load averages are Linux-style exponentially weighted moving averages of
+// the number of runnable tasks, in FSHIFT-bit fixed point (FIXED_1 == 1.0),
+// sampled every LOAD_FREQ ticks. EXP_n = FIXED_1 / exp(5s / n min).
+#define FSHIFT      11
+#define FIXED_1     (1u << FSHIFT)
+#define LOAD_FREQ   (5 * 1000 + 1)  // 5 s of 1 ms ticks; +1 avoids beating with 5 s periodic work
+#define EXP_1       1884
+#define EXP_5       2014
+#define EXP_15      2037
+
+#define LOAD_INT(x)   ((x) >> FSHIFT)
+#define LOAD_FRAC(x)  LOAD_INT(((x) & (FIXED_1 - 1)) * 100)
+
 /**
  * @brief Load tracking structure for scheduler statistics
  */
@@ -85,9 +97,7 @@ typedef struct {
     uint32_t total_tasks;
     uint32_t runnable_tasks;
     uint32_t blocked_tasks;
-    uint32_t load_history[SCHED_LOAD_HISTORY_SIZE];
-    uint32_t history_index;
-    uint32_t average_load;
+    uint32_t avenrun[3];     // 1/5/15-minute load averages (FIXED_1 units)
 } scheduler_load_t;
 
 //============================================================================
@@ -132,7 +142,8 @@ void scheduler_opt_mark_priority_empty(uint8_t priority);
 tcb_t* scheduler_opt_select_next_task(void);
 
 /**
- * @brief Update load statistics
+ * @brief Sample task counts and fold them into the load averages
+ * @note Called from the scheduler tick every LOAD_FREQ ticks
  */
 void scheduler_opt_update_load_stats(void);
 
@@ -156,11 +167,17 @@ void scheduler_opt_boost_priority(tcb_t *task);
 void scheduler_opt_reset_boost(tcb_t *task);
 
 /**
- * @brief Get current scheduler load average
- * @return Load average (0-100)
+ * @brief Get the 1-minute load average
+ * @return Load average scaled by 100 (e.g. 150 == 1.50)
  */
 uint32_t scheduler_opt_get_load_average(void);
 
+/**
+ * @brief Get the 1/5/15-minute load averages
+ * @param loads Receives the averages in FIXED_1 units
+ */
+void scheduler_opt_get_loadavg(uint32_t loads[3]);
+
 /**
  * @brief Check if scheduler is under heavy load
  * @return true if load is high
@@ -58,10 +58,17 @@ void scheduler_queues_move_task_priority(tcb_t *task, uint8_t old_priority, uint
 void scheduler_queues_add_to_all_tasks(tcb_t *task);
 
 /**
- * @brief Find and remove a zombie task for cleanup
- * @return Zombie task to clean up, or NULL if none found
+ * @brief Unlink a task from the global task list
+ * @param task Task to remove (constant time)
  */
-tcb_t* scheduler_queues_remove_zombie_task(void);
+void scheduler_queues_remove_from_all_tasks(tcb_t *task);
+
+/**
+ * @brief Calls fn for every task on the global task list
+ * @details fn runs with the list lock held and interrupts off; it must not
+ * block or add/remove tasks.
+ */
+void scheduler_queues_for_each_task(void (*fn)(tcb_t *task, void *arg), void *arg);
 
 //============================================================================
 // Queue Statistics & Debug
@@ -74,6 +81,14 @@ tcb_t* scheduler_queues_remove_zombie_task(void);
  */
 uint32_t scheduler_queues_get_count(uint8_t priority);
 
+/**
+ * @brief Count live tasks (idle and zombies excluded) by state
+ * @param total All live tasks (may be NULL)
+ * @param runnable READY or RUNNING tasks (may be NULL)
+ * @param blocked BLOCKED or SLEEPING tasks (may be NULL)
+ */
+void scheduler_queues_count_tasks(uint32_t *total, uint32_t *runnable, uint32_t *blocked);
+
 /**
  * @brief Print debug statistics for all queues
  */
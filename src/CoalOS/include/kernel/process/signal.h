@@ -133,6 +133,16 @@ void signal_copy_handlers(pcb_t *parent, pcb_t *child);
  */
 int signal_send(uint32_t target_pid, int signal, uint32_t sender_pid);
 
+/**
+ * @brief Queue a kernel-originated signal on a known process
+ * @details Skips the pid lookup and permission check; safe from interrupt
+ * context (timer expiry).
+ * @param target Target process
+ * @param signal Signal number to send
+ * @return 0 on success, negative error code on failure
+ */
+int signal_send_kernel(pcb_t *target, int signal);
+
 /**
  * @brief Register a signal handler for a process
  * @param proc Process
@@ -151,6 +161,14 @@ void* signal_register_handler(pcb_t *proc, int signal, void *handler, uint32_t f
  */
 bool signal_deliver_pending(pcb_t *proc, isr_frame_t *regs);
 
+/**
+ * @brief Update TIF_SIGPENDING on the process's task
+ * @param proc Process whose pending/mask state changed
+ * @note Call with proc->signal_lock held. Sets the flag if a signal is
+ *       deliverable (or the process was terminated), clears it otherwise.
+ */
+void signal_recalc_pending(pcb_t *proc);
+
 /**
  * @brief Block or unblock signals for a process
  * @param proc Process
@@ -205,7 +223,10 @@ int signal_default_action(int signal);
 void signal_handle_keyboard_interrupt(void);
 
 /**
- * @brief Handle timer-based signals (SIGALRM)
+ * @brief Charge the running process's CPU timers from its accounted CPU time
+ * @details Drives ITIMER_VIRTUAL (user time) and ITIMER_PROF (user + system
+ * time); SIGALRM comes from ktimer expiry instead. Called from the PIT
+ * interrupt.
  */
 void signal_handle_timer_signals(void);
 
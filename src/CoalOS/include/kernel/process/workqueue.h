@@ -0,0 +1,178 @@
+/**
+ * @file workqueue.h
+ * @brief Deferred work executed by a shared pool of kernel worker threads
+ *
+ * Work items are queued on a workqueue and run in process context by worker
+ * threads. Workqueues do not own threads: every bound workqueue feeds the
+ * per-CPU pool of the CPU that queued the item, every WQ_UNBOUND workqueue
+ * feeds one shared unbound pool. Pools are concurrency managed: a worker that
+ * blocks inside a work item lets an idle worker take over the queue, and a
+ * worker that starts on the last idle slot spawns a spare first, so a pool
+ * grows only while its items actually sleep.
+ *
+ * Queueing is safe from interrupt context. A work item is queued at most
+ * once at a time; queueing an already pending item is a no-op.
+ */
+
+#ifndef WORKQUEUE_H
+#define WORKQUEUE_H
+
+#include <kernel/core/types.h>
+#include <kernel/drivers/timer/ktimer.h>
+#include <libc/stdint.h>
+#include <libc/stdbool.h>
+
+#define WQ_UNBOUND          (1u << 0)   // Not tied to the queueing CPU's pool
+#define WQ_MAX_WORKERS      16          // Per pool, including blocked ones
+#define WQ_MAX_IDLE         2           // Idle workers beyond this exit
+#define WORK_CPU_ANY        (-1)        // Queueing CPU (bound queues)
+
+// work_t.flags
+#define WORK_PENDING        (1u << 0)   // Queued or delay timer armed
+
+typedef struct workqueue workqueue_t;
+typedef struct work_struct work_t;
+typedef void (*work_func_t)(work_t *work);
+
+struct work_struct {
+    work_t             *next;       // Pool queue link
+    work_func_t         func;
+    void               *data;       // Owner context for func
+    struct worker_pool *pool;       // Pool it was last queued on
+    workqueue_t        *wq;         // Workqueue it was last queued on
+    volatile uint32_t   flags;      // WORK_*
+};
+
+/**
+ * @brief Work item queued after a delay measured on the ktimer clock
+ */
+typedef struct delayed_work {
+    work_t       work;
+    ktimer_t     timer;
+    workqueue_t *wq;                // Target once the timer fires
+    int          cpu;
+} delayed_work_t;
+
+/** Shared queues for callers that need no workqueue of their own. */
+extern workqueue_t *system_wq;
+extern workqueue_t *system_unbound_wq;
+
+/**
+ * @brief Creates the worker pools and the system workqueues
+ * @note Called once from scheduler_init()
+ */
+void workqueue_init(void);
+
+/**
+ * @brief Creates a workqueue
+ * @param name Static name, for diagnostics
+ * @param flags WQ_*
+ * @return The workqueue, or NULL when out of memory
+ */
+workqueue_t *workqueue_create(const char *name, uint32_t flags);
+
+/**
+ * @brief Waits for a workqueue's queued work and frees it
+ * @note Delayed work whose timer has not fired must be cancelled first
+ */
+void workqueue_destroy(workqueue_t *wq);
+
+/** @brief Prepares a work item; it is not queued. */
+void work_init(work_t *work, work_func_t func, void *data);
+
+/** @brief Prepares a delayed work item; func receives &dwork->work. */
+void delayed_work_init(delayed_work_t *dwork, work_func_t func, void *data);
+
+/** @brief Recovers the delayed_work_t from the work_t handed to func. */
+static inline delayed_work_t *to_delayed_work(work_t *work) {
+    return (delayed_work_t *)((uint8_t *)work - __builtin_offsetof(delayed_work_t, work));
+}
+
+/**
+ * @brief Queues work on the queueing CPU's pool (or the unbound pool)
+ * @return false if the work was already pending
+ */
+bool queue_work(workqueue_t *wq, work_t *work);
+
+/**
+ * @brief Queues work on a specific CPU's pool
+ * @param cpu CPU id, or WORK_CPU_ANY; ignored for WQ_UNBOUND queues
+ * @return false if the work was already pending
+ */
+bool queue_work_on(int cpu, workqueue_t *wq, work_t *work);
+
+/**
+ * @brief Queues work once delay_ms have elapsed (immediately for 0)
+ * @return false if the work was already pending
+ */
+bool queue_delayed_work(workqueue_t *wq, delayed_work_t *dwork, uint32_t delay_ms);
+
+/**
+ * @brief Like queue_delayed_work(), but re-arms a pending timer
+ * @return true if the work was pending before the call
+ */
+bool mod_delayed_work(workqueue_t *wq, delayed_work_t *dwork, uint32_t delay_ms);
+
+/**
+ * @brief Waits until work is neither pending nor running
+ * @return true if it had to wait
+ * @note Must not be called from the work item itself
+ */
+bool flush_work(work_t *work);
+
+/**
+ * @brief Waits until every item queued on wq has finished
+ * @note Items queued while waiting are waited for too
+ */
+void flush_workqueue(workqueue_t *wq);
+
+/**
+ * @brief Dequeues pending work and waits for a running instance to finish
+ * @return true if the work was pending
+ */
+bool cancel_work_sync(work_t *work);
+
+/**
+ * @brief Stops a delayed work's timer or dequeues it; does not wait
+ * @return true if the work was pending
+ */
+bool cancel_delayed_work(delayed_work_t *dwork);
+
+/**
+ * @brief cancel_delayed_work() plus waiting for a running instance
+ * @return true if the work was pending
+ */
+bool cancel_delayed_work_sync(delayed_work_t *dwork);
+
+/** @brief queue_work() on system_wq. */
+static inline bool schedule_work(work_t *work) {
+    return queue_work(system_wq, work);
+}
+
+/** @brief queue_delayed_work() on system_wq. */
+static inline bool schedule_delayed_work(delayed_work_t *dwork, uint32_t delay_ms) {
+    return queue_delayed_work(system_wq, dwork, delay_ms);
+}
+
+//============================================================================
+// Scheduler Hooks
+//============================================================================
+
+struct tcb;
+
+/**
+ * @brief Called by schedule() when a worker blocks or sleeps
+ * @note Interrupts are disabled. Wakes an idle worker if the pool has
+ *       pending work and no other running worker.
+ */
+void wq_worker_sleeping(struct tcb *task);
+
+/** @brief Called by schedule() when a worker runs again. */
+void wq_worker_running(struct tcb *task);
+
+/**
+ * @brief Reports pool activity summed over all pools
+ */
+void workqueue_get_stats(uint32_t *workers, uint32_t *idle, uint32_t *executed);
+
+#endif // WORKQUEUE_H
@@ -0,0 +1,89 @@
+/**
+ * @file preempt.h
+ * @brief Preemption counter for the preemptible kernel
+ *
+ * @details The kernel may be preempted on IRQ exit and when the outermost
+ * preempt_enable() runs, but only while preempt_count() is zero and local
+ * interrupts are enabled. Spinlocks raise the count for the whole critical
+ * section; interrupt handlers run with HARDIRQ_OFFSET added. Regions that
+ * merely disable interrupts are non-preemptible by virtue of IF being clear.
+ *
+ * The count is per CPU; schedule() saves and restores it per task so a task
+ * that blocks inside a non-preemptible region resumes with its own count.
+ */
+
+#ifndef PREEMPT_H
+#define PREEMPT_H
+
+#include <kernel/core/types.h>
+
+#define PREEMPT_MASK    0x000000FFu  // preempt_disable() nesting
+#define HARDIRQ_SHIFT   16
+#define HARDIRQ_OFFSET  (1u << HARDIRQ_SHIFT)
+#define HARDIRQ_MASK    0x00FF0000u  // Interrupt handler nesting
+
+#define EFLAGS_IF       0x200u
+
+extern volatile uint32_t g_preempt_count;
+
+/**
+ * @brief Reschedules if the current task needs it and preemption is allowed
+ * @note Called by preempt_enable() when the count drops to zero.
+ */
+void preempt_check_resched(void);
+
+static inline uint32_t preempt_count(void)
+{
+    return g_preempt_count;
+}
+
+static inline void preempt_count_add(uint32_t val)
+{
+    g_preempt_count += val;
+    asm volatile("" ::: "memory");
+}
+
+static inline void preempt_count_sub(uint32_t val)
+{
+    asm volatile("" ::: "memory");
+    g_preempt_count -= val;
+}
+
+static inline void preempt_disable(void)
+{
+    preempt_count_add(1);
+}
+
+/** @brief Drops one level without checking for a pending reschedule. */
+static inline void preempt_enable_no_resched(void)
+{
+    preempt_count_sub(1);
+}
+
+static inline void preempt_enable(void)
+{
+    preempt_count_sub(1);
+    if (g_preempt_count == 0) {
+        preempt_check_resched();
+    }
+}
+
+static inline bool in_interrupt(void)
+{
+    return (g_preempt_count & HARDIRQ_MASK) != 0;
+}
+
+static inline bool irqs_enabled(void)
+{
+    uint32_t eflags;
+    asm volatile("pushfl; popl %0" : "=r"(eflags));
+    return (eflags & EFLAGS_IF) != 0;
+}
+
+/** @brief True if a context switch may happen right here. */
+static inline bool preemptible(void)
+{
+    return g_preempt_count == 0 && irqs_enabled();
+}
+
+#endif // PREEMPT_H
@@ -27,9 +27,9 @@ void spinlock_init(spinlock_t *lock);
 /**
  * @brief Acquires the spinlock, disabling local interrupts.
  *
- * Spins (busy-waits) until the lock is acquired. Disables interrupts on the
- * current CPU before attempting to acquire the lock and returns an opaque
- * value representing the previous interrupt state.
+ * Spins (busy-waits) until the lock is acquired. Disables interrupts and
+ * preemption on the current CPU before attempting to acquire the lock and
+ * returns an opaque value representing the previous interrupt state.
  *
  * @param lock Pointer to the spinlock_t structure.
  * @return An opaque value representing the previous interrupt state (to be used with restore).
@@ -39,6 +39,9 @@ uintptr_t spinlock_acquire_irqsave(spinlock_t *lock);
 /**
  * @brief Releases the spinlock and restores the previous interrupt state.
  *
+ * Re-enables preemption; if this was the outermost critical section and a
+ * reschedule is pending, the caller may be preempted before this returns.
+ *
  * @param lock Pointer to the spinlock_t structure.
  * @param flags The opaque value returned by spinlock_acquire_irqsave.
  */
@@ -14,13 +14,17 @@
 #include <kernel/core/init.h>
 #include <kernel/cpu/gdt.h>
 #include <kernel/cpu/idt.h>
+#include <kernel/cpu/exception_table.h>
+#include <kernel/cpu/tsc.h>
 #include <kernel/cpu/syscall.h>
 #include <kernel/memory/paging.h>
 #include <kernel/memory/frame.h>
 #include <kernel/memory/buddy.h>
 #include <kernel/memory/kmalloc.h>
+#include <kernel/memory/paging_fault.h>
 #include <kernel/drivers/display/serial.h>
 #include <kernel/drivers/display/terminal.h>
+#include <kernel/drivers/display/tty.h>
 #include <kernel/drivers/timer/pit.h>
 #include <kernel/drivers/input/keyboard.h>
 #include <kernel/drivers/display/console_dev.h>
@@ -32,8 +36,11 @@
 #include <kernel/lib/port_io.h>
 #include <kernel/drivers/input/keyboard_hw.h>
 #include <kernel/lib/assert.h>
+#include <kernel/lib/tunables.h>
 #include <kernel/arch/multiboot2.h>
 #include <kernel/process/process.h>
+#include <kernel/cpu/apic.h>
+#include <kernel/hal/irq_hal.h>
 #include <libc/string.h>
 
 //============================================================================
@@ -163,6 +170,16 @@ init_result_t init_validate_multiboot(uint32_t magic, uint32_t mb_info_phys_addr
     
     terminal_printf("  Multiboot magic OK (Info at phys 0x%lx)\n", 
                    (unsigned long)mb_info_phys_addr);
+
+    // Keep the command line before memory init: kmalloc reads its tunables
+    struct multiboot_tag_string *cmdline_tag = (struct multiboot_tag_string *)
+        find_multiboot_tag_phys(mb_info_phys_addr, MULTIBOOT_TAG_TYPE_CMDLINE);
+    if (cmdline_tag && cmdline_tag->size > sizeof(*cmdline_tag)) {
+        tunables_set_cmdline(cmdline_tag->string);
+        if (tunables_get_cmdline()[0]) {
+            terminal_printf("  Command line: %s\n", tunables_get_cmdline());
+        }
+    }
     
     return init_success("Multiboot Validation");
 }
@@ -179,6 +196,9 @@ init_result_t init_basic_io(void)
     // Initialize terminal for user output
     terminal_init();
     
+    // Reset the console tty (termios defaults, empty input queues)
+    tty_init();
+    
     // Initialize console device driver
     console_dev_init();
     
@@ -194,6 +214,12 @@ init_result_t init_core_systems(uint32_t mb_info_phys_addr)
     // Initialize Global Descriptor Table
     gdt_init();
     
+    // Sort the uaccess exception table for binary-search fault fixups
+    exception_table_init();
+    
+    // Register fault counters before the first demand-paging fault
+    page_fault_stats_init();
+    
     // Initialize memory management
     initialize_memory_management(mb_info_phys_addr);
     
@@ -205,6 +231,20 @@ init_result_t init_core_systems(uint32_t mb_info_phys_addr)
 
 init_result_t init_interrupt_systems(void)
 {
+    // Switch from the 8259 PIC to the local/I/O APIC when the MADT (or the
+    // APIC base MSR) allows it; the IRQ HAL keeps the PIC otherwise.
+    struct multiboot_tag *acpi_tag = find_multiboot_tag_virt(g_multiboot_info_virt_addr_global,
+                                                             MULTIBOOT_TAG_TYPE_ACPI_NEW);
+    if (!acpi_tag) {
+        acpi_tag = find_multiboot_tag_virt(g_multiboot_info_virt_addr_global,
+                                           MULTIBOOT_TAG_TYPE_ACPI_OLD);
+    }
+    apic_init(acpi_tag ? ((struct multiboot_tag_old_acpi *)acpi_tag)->rsdp : NULL);
+    irq_hal_init();
+
+    // Detect the TSC; it is calibrated against the PIT's first ticks
+    tsc_init();
+
     // Initialize Programmable Interval Timer
     init_pit();
     
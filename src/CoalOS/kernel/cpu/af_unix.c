@@ -0,0 +1,1693 @@
+/**
+ * @file af_unix.c
+ * @brief UNIX domain sockets (AF_UNIX) for local IPC
+ *
+ * @details Every socket is an anonymous vnode whose data is a unix_sock_t.
+ * All socket state (queues, peers, the name table) is guarded by one lock;
+ * payload is copied with the lock dropped. A receive queue is a list of
+ * unix_buf_t records whose payload sits in page frames reached through the
+ * direct map:
+ *
+ *  - Small stream writes are packed into the tail record of the peer's queue,
+ *    so a stream of short messages fills pages instead of allocating per
+ *    message.
+ *  - A blocking send of UNIX_ZEROCOPY_MIN bytes or more from a single buffer
+ *    to a receiver that is already waiting for at least that much lends its
+ *    pinned user pages: the record points at the sender's frames, the
+ *    receiver copies straight out of them, and the sender waits until the
+ *    record is consumed. One copy instead of two. Without a waiting reader
+ *    the data is copied as usual, so a send never waits for a future read.
+ *
+ * Readers of one socket are serialized (unix_sock_t.reader) so a record is
+ * never dequeued while another reader copies from it. Blocked tasks wait on
+ * the socket they need to change (their own for data, the peer's for space,
+ * the listener's for a backlog slot) and recheck after every wakeup.
+ */
+
+//============================================================================
+// Includes
+//============================================================================
+#include "af_unix.h"
+#include <kernel/process/process.h>
+#include <kernel/process/scheduler.h>
+#include <kernel/process/signal.h>
+#include <kernel/fs/vfs/sys_file.h>
+#include <kernel/fs/vfs/fs_errno.h>
+#include <kernel/memory/frame.h>
+#include <kernel/memory/paging.h>
+#include <kernel/memory/mm.h>
+#include <kernel/memory/kmalloc.h>
+#include <kernel/memory/uaccess.h>
+#include <kernel/sync/spinlock.h>
+#include <kernel/lib/string.h>
+#include <libc/stddef.h>
+
+//============================================================================
+// Configuration
+//============================================================================
+#define UNIX_DEFAULT_BUF        212992      // SO_SNDBUF / SO_RCVBUF (Linux default)
+#define UNIX_MIN_BUF            4096
+#define UNIX_MAX_BUF            (4 * 1024 * 1024)
+#define UNIX_BUF_PAGES          16          // Frames per copied stream record
+#define UNIX_PACK_MAX           512         // Stream writes packed into the tail record
+#define UNIX_ZEROCOPY_MIN       (16 * 1024) // Sends lending their pages
+#define UNIX_LOAN_MAX_PAGES     64          // Pages lent per record
+#define UNIX_MAX_DGRAM_QLEN     64          // Queued datagrams per socket
+#define UNIX_MAX_BACKLOG        128
+#define UNIX_HASH_SIZE          64
+
+#define RCV_SHUTDOWN            1
+#define SEND_SHUTDOWN           2
+#define SHUTDOWN_MASK           3
+
+#define SUN_PATH_OFFSET         offsetof(k_sockaddr_un_t, sun_path)
+
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+//============================================================================
+// Types
+//============================================================================
+
+typedef struct unix_addr {
+    volatile uint32_t refcount;
+    uint32_t          len;          // sockaddr length reported to user space
+    uint32_t          keylen;       // Significant bytes of sun_path
+    uint32_t          hash;
+    k_sockaddr_un_t   name;
+} unix_addr_t;
+
+typedef struct unix_loan {
+    tcb_t        *task;             // Sender waiting for the record
+    volatile bool done;
+} unix_loan_t;
+
+typedef struct unix_buf {
+    struct unix_buf *next;
+    uint32_t      len;              // Payload bytes
+    uint32_t      off;              // Bytes consumed (stream)
+    uint32_t      page_off;         // Payload start within frames[0]
+    uint32_t      nr_pages;
+    uintptr_t    *frames;
+    uintptr_t     inline_frames[UNIX_BUF_PAGES];
+    bool          borrowed;         // frames are pinned sender pages
+    unix_loan_t  *loan;             // Sender still waiting for the record
+    unix_addr_t  *from;             // Sender's name (datagrams)
+    bool          has_cred;
+    k_ucred_t     cred;
+    file_t      **files;            // SCM_RIGHTS references
+    int          *file_flags;
+    uint32_t      nr_files;
+} unix_buf_t;
+
+typedef enum {
+    UNIX_UNCONNECTED,
+    UNIX_LISTENING,
+    UNIX_CONNECTED,
+} unix_state_e;
+
+typedef struct unix_sock {
+    volatile uint32_t refcount;     // File, peer and accept-queue links
+    int               type;
+    unix_state_e      state;
+    uint32_t          shutdown;     // RCV_SHUTDOWN / SEND_SHUTDOWN
+    int               err;          // Pending SO_ERROR
+    bool              dead;         // File closed
+    bool              passcred;
+    unix_addr_t      *addr;
+    struct unix_sock *peer;
+    struct unix_sock *hash_next;
+    k_ucred_t         peercred;
+    bool              has_peercred;
+    uint32_t          sndbuf;
+    uint32_t          rcvbuf;
+
+    unix_buf_t       *rq_head;
+    unix_buf_t       *rq_tail;
+    uint32_t          rq_bytes;
+    uint32_t          rq_count;
+    tcb_t            *reader;       // Task consuming the receive queue
+    uint32_t          reader_want;  // Bytes the reader waits for on an empty queue
+
+    struct unix_sock *acceptq_head; // Connected, not yet accepted
+    struct unix_sock *acceptq_tail;
+    struct unix_sock *accept_next;
+    struct unix_sock *put_next;     // Deferred unix_sock_put() list
+    uint32_t          acceptq_len;
+    uint32_t          backlog;
+
+    tcb_t            *waiters;      // Linked via tcb->wait_next
+} unix_sock_t;
+
+// Destination of a copy: user iovecs, or one kernel buffer (VFS read/write)
+typedef struct {
+    const k_iovec_t *iov;
+    uint32_t         nr;
+    uint32_t         idx;
+    uint32_t         seg_off;
+    bool             kernel;
+} unix_iter_t;
+
+static spinlock_t g_unix_lock = { 0 };
+static unix_sock_t *g_unix_names[UNIX_HASH_SIZE];
+static uint32_t g_unix_autobind = 0;
+
+static int unix_vfs_read(file_t *file, void *buffer, size_t count);
+static int unix_vfs_write(file_t *file, const void *buffer, size_t count);
+static int unix_vfs_close(file_t *file);
+
+// Never registered or mounted: sockets are only reachable through their fd
+static vfs_driver_t unix_driver = {
+    .fs_name = "unix",
+    .read = unix_vfs_read,
+    .write = unix_vfs_write,
+    .close = unix_vfs_close,
+};
+
+static unix_sock_t *unix_from_file(file_t *file) {
+    if (!file || !file->vnode || file->vnode->fs_driver != &unix_driver) {
+        return NULL;
+    }
+    return (unix_sock_t *)file->vnode->data;
+}
+
+bool unix_is_socket(file_t *file) {
+    return unix_from_file(file) != NULL;
+}
+
+static bool unix_connection_type(int type) {
+    return type == SOCK_STREAM || type == SOCK_SEQPACKET;
+}
+
+static k_ucred_t unix_current_cred(void) {
+    pcb_t *proc = get_current_process();
+    k_ucred_t cred = { proc ? (int32_t)proc->pid : 0, 0, 0 };   // Single user: root
+    return cred;
+}
+
+//============================================================================
+// Copy Helpers
+//============================================================================
+
+static void unix_iter_init(unix_iter_t *it, const k_iovec_t *iov, uint32_t nr, bool kernel) {
+    it->iov = iov;
+    it->nr = nr;
+    it->idx = 0;
+    it->seg_off = 0;
+    it->kernel = kernel;
+}
+
+static size_t unix_iter_count(const unix_iter_t *it) {
+    size_t total = 0;
+    for (uint32_t i = it->idx; i < it->nr; i++) total += it->iov[i].iov_len;
+    return total - it->seg_off;
+}
+
+// Moves n bytes between the iterator and kernel memory; false on a fault
+static bool unix_iter_copy(unix_iter_t *it, void *kaddr, size_t n, bool to_iter) {
+    uint8_t *k = (uint8_t *)kaddr;
+    while (n > 0) {
+        while (it->idx < it->nr && it->seg_off == it->iov[it->idx].iov_len) {
+            it->idx++;
+            it->seg_off = 0;
+        }
+        if (it->idx >= it->nr) return false;
+
+        const k_iovec_t *seg = &it->iov[it->idx];
+        size_t part = MIN(n, seg->iov_len - it->seg_off);
+        uintptr_t addr = seg->iov_base + it->seg_off;
+        if (it->kernel) {
+            if (to_iter) memcpy((void *)addr, k, part);
+            else         memcpy(k, (const void *)addr, part);
+        } else if (to_iter) {
+            if (copy_to_user((userptr_t)addr, (const_kernelptr_t)k, part) != 0) return false;
+        } else {
+            if (copy_from_user((kernelptr_t)k, (const_userptr_t)addr, part) != 0) return false;
+        }
+        it->seg_off += part;
+        k += part;
+        n -= part;
+    }
+    return true;
+}
+
+// Walks [off, off + n) of a record's payload one page piece at a time
+static bool unix_buf_copy(unix_buf_t *buf, uint32_t off, unix_iter_t *it, size_t n, bool to_iter) {
+    uint32_t pos = buf->page_off + off;
+    while (n > 0) {
+        uint32_t page = pos / PAGE_SIZE;
+        uint32_t in_page = pos % PAGE_SIZE;
+        size_t part = MIN(n, PAGE_SIZE - in_page);
+        uint8_t *kaddr = (uint8_t *)(buf->frames[page] + KERNEL_SPACE_VIRT_START) + in_page;
+        if (!unix_iter_copy(it, kaddr, part, to_iter)) return false;
+        pos += part;
+        n -= part;
+    }
+    return true;
+}
+
+// Kernel-to-record copy used when packing into the tail record
+static void unix_buf_store(unix_buf_t *buf, uint32_t off, const uint8_t *src, size_t n) {
+    uint32_t pos = buf->page_off + off;
+    while (n > 0) {
+        uint32_t in_page = pos % PAGE_SIZE;
+        size_t part = MIN(n, PAGE_SIZE - in_page);
+        memcpy((uint8_t *)(buf->frames[pos / PAGE_SIZE] + KERNEL_SPACE_VIRT_START) + in_page, src, part);
+        pos += part;
+        src += part;
+        n -= part;
+    }
+}
+
+//============================================================================
+// Records
+//============================================================================
+
+static void unix_addr_put(unix_addr_t *addr) {
+    if (addr && __atomic_sub_fetch(&addr->refcount, 1, __ATOMIC_ACQ_REL) == 0) {
+        kfree(addr);
+    }
+}
+
+static unix_addr_t *unix_addr_get(unix_addr_t *addr) {
+    if (addr) __atomic_fetch_add(&addr->refcount, 1, __ATOMIC_RELAXED);
+    return addr;
+}
+
+static uint32_t unix_buf_capacity(const unix_buf_t *buf) {
+    return buf->nr_pages * PAGE_SIZE - buf->page_off;
+}
+
+// Record with its own frames for size bytes of payload
+static unix_buf_t *unix_buf_alloc(size_t size) {
+    uint32_t nr_pages = (uint32_t)((size + PAGE_SIZE - 1) / PAGE_SIZE);
+    if (nr_pages == 0) nr_pages = 1;
+
+    unix_buf_t *buf = kmalloc(sizeof(*buf));
+    if (!buf) return NULL;
+    memset(buf, 0, sizeof(*buf));
+    buf->frames = buf->inline_frames;
+    if (nr_pages > UNIX_BUF_PAGES) {
+        buf->frames = kmalloc(nr_pages * sizeof(uintptr_t));
+        if (!buf->frames) {
+            kfree(buf);
+            return NULL;
+        }
+    }
+    for (uint32_t i = 0; i < nr_pages; i++) {
+        buf->frames[i] = frame_alloc();
+        if (!buf->frames[i]) {
+            put_frames(buf->frames, i);
+            if (buf->frames != buf->inline_frames) kfree(buf->frames);
+            kfree(buf);
+            return NULL;
+        }
+        buf->nr_pages++;
+    }
+    return buf;
+}
+
+// Ends a loan: the sender may touch its buffer again. Lock held.
+static void unix_buf_end_loan(unix_buf_t *buf) {
+    unix_loan_t *loan = buf->loan;
+    if (!loan) return;
+    buf->loan = NULL;
+    loan->done = true;
+    if (loan->task && loan->task->state == TASK_BLOCKED) {
+        scheduler_unblock_task(loan->task);
+    }
+}
+
+// Frees a record that is off every queue and whose loan has ended.
+// Passed files still attached are closed.
+static void unix_buf_free(unix_buf_t *buf) {
+    if (buf->nr_pages) {
+        // Lent frames were pinned; our own were allocated. Either way one reference.
+        put_frames(buf->frames, buf->nr_pages);
+    }
+    if (buf->frames != buf->inline_frames) kfree(buf->frames);
+    for (uint32_t i = 0; i < buf->nr_files; i++) {
+        if (buf->files[i]) vfs_close(buf->files[i]);
+    }
+    if (buf->files) kfree(buf->files);
+    unix_addr_put(buf->from);
+    kfree(buf);
+}
+
+static void unix_buf_free_list(unix_buf_t *list) {
+    while (list) {
+        unix_buf_t *next = list->next;
+        unix_buf_free(list);
+        list = next;
+    }
+}
+
+// Moves scm's file references into buf
+static int unix_buf_attach_files(unix_buf_t *buf, unix_scm_t *scm) {
+    if (!scm || scm->nr_files == 0) return 0;
+    buf->files = kmalloc(scm->nr_files * (sizeof(file_t *) + sizeof(int)));
+    if (!buf->files) return -ENOMEM;
+    buf->file_flags = (int *)(buf->files + scm->nr_files);
+    for (uint32_t i = 0; i < scm->nr_files; i++) {
+        buf->files[i] = scm->files[i];
+        buf->file_flags[i] = scm->file_flags[i];
+        scm->files[i] = NULL;
+    }
+    buf->nr_files = scm->nr_files;
+    scm->nr_files = 0;
+    return 0;
+}
+
+// Appends buf to sk's receive queue. Lock held.
+static void unix_queue_tail(unix_sock_t *sk, unix_buf_t *buf) {
+    buf->next = NULL;
+    if (sk->rq_tail) sk->rq_tail->next = buf;
+    else             sk->rq_head = buf;
+    sk->rq_tail = buf;
+    sk->rq_bytes += buf->len - buf->off;
+    sk->rq_count++;
+}
+
+// Unlinks the head record. Lock held.
+static unix_buf_t *unix_dequeue_head(unix_sock_t *sk) {
+    unix_buf_t *buf = sk->rq_head;
+    if (!buf) return NULL;
+    sk->rq_head = buf->next;
+    if (!sk->rq_head) sk->rq_tail = NULL;
+    sk->rq_bytes -= buf->len - buf->off;
+    sk->rq_count--;
+    buf->next = NULL;
+    return buf;
+}
+
+//============================================================================
+// Sockets and Waiting
+//============================================================================
+
+static unix_sock_t *unix_sock_alloc(int type) {
+    unix_sock_t *sk = kmalloc(sizeof(*sk));
+    if (!sk) return NULL;
+    memset(sk, 0, sizeof(*sk));
+    sk->refcount = 1;
+    sk->type = type;
+    sk->state = UNIX_UNCONNECTED;
+    sk->sndbuf = UNIX_DEFAULT_BUF;
+    sk->rcvbuf = UNIX_DEFAULT_BUF;
+    return sk;
+}
+
+static void unix_sock_hold(unix_sock_t *sk) {
+    __atomic_fetch_add(&sk->refcount, 1, __ATOMIC_RELAXED);
+}
+
+static void unix_sock_put(unix_sock_t *sk) {
+    if (sk && __atomic_sub_fetch(&sk->refcount, 1, __ATOMIC_ACQ_REL) == 0) {
+        unix_addr_put(sk->addr);
+        kfree(sk);
+    }
+}
+
+static void unix_wake(unix_sock_t *sk) {
+    tcb_t *task = sk->waiters;
+    sk->waiters = NULL;
+    while (task) {
+        tcb_t *next = task->wait_next;
+        task->wait_next = NULL;
+        task->wait_reason = NULL;
+        if (task->state == TASK_BLOCKED) scheduler_unblock_task(task);
+        task = next;
+    }
+}
+
+/*
+ * Sleeps until the next unix_wake(sk). Called with the lock held (and
+ * returns with it held); the caller keeps sk alive. -EINTR if a signal is
+ * pending.
+ */
+static int unix_wait(unix_sock_t *sk, uintptr_t *irq) {
+    tcb_t *self = get_current_task();
+    if (!self) return -EFAULT;
+    if (test_tsk_thread_flag(self, TIF_SIGPENDING)) return -EINTR;
+
+    self->wait_next = sk->waiters;
+    self->wait_reason = sk;
+    sk->waiters = self;
+    self->state = TASK_BLOCKED;
+    spinlock_release_irqrestore(&g_unix_lock, *irq);
+    schedule();
+    *irq = spinlock_acquire_irqsave(&g_unix_lock);
+
+    // Woken by something other than unix_wake(): leave the list
+    if (self->wait_reason == sk) {
+        tcb_t **link = &sk->waiters;
+        while (*link && *link != self) link = &(*link)->wait_next;
+        if (*link) *link = self->wait_next;
+        self->wait_next = NULL;
+        self->wait_reason = NULL;
+    }
+    return 0;
+}
+
+static bool unix_nonblock(file_t *file, int flags) {
+    return (file->flags & O_NONBLOCK) || (flags & MSG_DONTWAIT);
+}
+
+static void unix_release(unix_sock_t *sk);
+
+// Wraps sk in a file and installs it; sk's reference moves to the file and
+// is released if no descriptor can be assigned
+static int unix_install(unix_sock_t *sk, int flags) {
+    vnode_t *vnode = kmalloc(sizeof(*vnode));
+    file_t *file = kmalloc(sizeof(*file));
+    if (!vnode || !file) {
+        if (vnode) kfree(vnode);
+        if (file) kfree(file);
+        unix_release(sk);
+        return -ENOMEM;
+    }
+    vnode->data = sk;
+    vnode->fs_driver = &unix_driver;
+
+    file->vnode = vnode;
+    file->flags = O_RDWR | (flags & SOCK_NONBLOCK);
+    file->offset = 0;
+    spinlock_init(&file->lock);
+    file->refcount = 1;
+
+    // SOCK_CLOEXEC is accepted; descriptors have no close-on-exec flag yet
+    return sys_file_install(file, (int)file->flags);
+}
+
+//============================================================================
+// Name Table
+//============================================================================
+
+static uint32_t unix_hash_name(const char *key, uint32_t len) {
+    uint32_t h = 2166136261u;   // FNV-1a
+    for (uint32_t i = 0; i < len; i++) {
+        h ^= (uint8_t)key[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/*
+ * Validates a user address and builds its table entry. Path names end at
+ * the first NUL; abstract names (leading NUL) use every byte of addrlen.
+ */
+static int unix_make_addr(const k_sockaddr_un_t *sun, uint32_t addrlen, unix_addr_t **out) {
+    if (!sun || addrlen <= SUN_PATH_OFFSET || addrlen > sizeof(k_sockaddr_un_t)) return -EINVAL;
+    if (sun->sun_family != AF_UNIX) return -EAFNOSUPPORT;
+
+    uint32_t max = addrlen - SUN_PATH_OFFSET;
+    uint32_t keylen;
+    uint32_t len;
+    if (sun->sun_path[0] == '\0') {
+        keylen = max;
+        len = addrlen;
+    } else {
+        keylen = 0;
+        while (keylen < max && sun->sun_path[keylen]) keylen++;
+        if (keylen == UNIX_PATH_MAX) return -EINVAL;
+        len = SUN_PATH_OFFSET + keylen + 1;
+    }
+
+    unix_addr_t *addr = kmalloc(sizeof(*addr));
+    if (!addr) return -ENOMEM;
+    memset(addr, 0, sizeof(*addr));
+    addr->refcount = 1;
+    addr->len = len;
+    addr->keylen = keylen;
+    addr->name.sun_family = AF_UNIX;
+    memcpy(addr->name.sun_path, sun->sun_path, keylen);
+    addr->hash = unix_hash_name(addr->name.sun_path, keylen);
+    *out = addr;
+    return 0;
+}
+
+static bool unix_addr_equal(const unix_addr_t *a, const unix_addr_t *b) {
+    return a->hash == b->hash && a->keylen == b->keylen &&
+           memcmp(a->name.sun_path, b->name.sun_path, a->keylen) == 0;
+}
+
+// Lock held
+static unix_sock_t *unix_find_locked(const unix_addr_t *addr) {
+    for (unix_sock_t *sk = g_unix_names[addr->hash % UNIX_HASH_SIZE]; sk; sk = sk->hash_next) {
+        if (unix_addr_equal(sk->addr, addr)) return sk;
+    }
+    return NULL;
+}
+
+// Lock held
+static void unix_unhash_locked(unix_sock_t *sk) {
+    if (!sk->addr) return;
+    unix_sock_t **link = &g_unix_names[sk->addr->hash % UNIX_HASH_SIZE];
+    while (*link && *link != sk) link = &(*link)->hash_next;
+    if (*link) *link = sk->hash_next;
+    sk->hash_next = NULL;
+}
+
+// Finds the socket bound to a user address, with a reference
+static int unix_lookup(const k_sockaddr_un_t *sun, uint32_t addrlen, int type, unix_sock_t **out) {
+    unix_addr_t *addr;
+    int err = unix_make_addr(sun, addrlen, &addr);
+    if (err) return err;
+
+    uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+    unix_sock_t *other = unix_find_locked(addr);
+    if (other && other->type != type) {
+        err = -EPROTOTYPE;
+    } else if (!other) {
+        // No socket file to find for a path: report it like Linux would
+        err = addr->name.sun_path[0] ? -ENOENT : -ECONNREFUSED;
+    } else {
+        unix_sock_hold(other);
+        *out = other;
+    }
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+    unix_addr_put(addr);
+    return err;
+}
+
+int unix_bind(file_t *file, const k_sockaddr_un_t *sun, uint32_t addrlen) {
+    unix_sock_t *sk = unix_from_file(file);
+    if (!sk) return -ENOTSOCK;
+
+    unix_addr_t *addr;
+    int err;
+    bool autobind = sun && addrlen == SUN_PATH_OFFSET && sun->sun_family == AF_UNIX;
+    if (autobind) {
+        // Kernel-chosen abstract name "\0XXXXX"
+        addr = kmalloc(sizeof(*addr));
+        if (!addr) return -ENOMEM;
+        memset(addr, 0, sizeof(*addr));
+        addr->refcount = 1;
+        addr->name.sun_family = AF_UNIX;
+        addr->keylen = 6;
+        addr->len = SUN_PATH_OFFSET + addr->keylen;
+    } else {
+        err = unix_make_addr(sun, addrlen, &addr);
+        if (err) return err;
+    }
+
+    uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+    if (sk->addr) {
+        err = -EINVAL;
+    } else {
+        for (uint32_t tries = 0; autobind && tries < 0x100000; tries++) {
+            uint32_t n = g_unix_autobind++ & 0xFFFFF;
+            for (int i = 5; i >= 1; i--) {
+                addr->name.sun_path[i] = "0123456789abcdef"[n & 0xF];
+                n >>= 4;
+            }
+            addr->hash = unix_hash_name(addr->name.sun_path, addr->keylen);
+            if (!unix_find_locked(addr)) break;
+        }
+        if (unix_find_locked(addr)) {
+            err = -EADDRINUSE;
+        } else {
+            sk->addr = addr;
+            sk->hash_next = g_unix_names[addr->hash % UNIX_HASH_SIZE];
+            g_unix_names[addr->hash % UNIX_HASH_SIZE] = sk;
+            addr = NULL;
+            err = 0;
+        }
+    }
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+    unix_addr_put(addr);
+    return err;
+}
+
+//============================================================================
+// Release
+//============================================================================
+
+// Moves sk's whole receive queue onto *freelist. Lock held.
+static void unix_purge_locked(unix_sock_t *sk, unix_buf_t **freelist) {
+    unix_buf_t *buf;
+    while ((buf = unix_dequeue_head(sk)) != NULL) {
+        unix_buf_end_loan(buf);
+        buf->next = *freelist;
+        *freelist = buf;
+    }
+}
+
+/*
+ * Tears down a socket whose file (or accept-queue slot) is gone. The peer
+ * sees end of stream, or ECONNRESET if it had data we never read. Queued
+ * records are moved to *freelist and freed by the caller after the lock is
+ * dropped, since they may hold sockets of their own. Lock held.
+ */
+static void unix_release_locked(unix_sock_t *sk, unix_buf_t **freelist, unix_sock_t **putlist) {
+    sk->dead = true;
+    sk->shutdown = SHUTDOWN_MASK;
+    unix_unhash_locked(sk);
+
+    unix_sock_t *peer = sk->peer;
+    if (peer) {
+        sk->peer = NULL;
+        if (unix_connection_type(sk->type) && peer->peer == sk) {
+            peer->shutdown = SHUTDOWN_MASK;
+            if (sk->rq_head) peer->err = ECONNRESET;
+        }
+        unix_wake(peer);
+        peer->put_next = *putlist;
+        *putlist = peer;
+    }
+
+    // Connections nobody accepted die with the listener
+    unix_sock_t *embryo = sk->acceptq_head;
+    sk->acceptq_head = sk->acceptq_tail = NULL;
+    sk->acceptq_len = 0;
+    while (embryo) {
+        unix_sock_t *next = embryo->accept_next;
+        embryo->accept_next = NULL;
+        unix_release_locked(embryo, freelist, putlist);
+        embryo->put_next = *putlist;        // The queue's reference
+        *putlist = embryo;
+        embryo = next;
+    }
+
+    unix_purge_locked(sk, freelist);
+    unix_wake(sk);
+}
+
+static void unix_release(unix_sock_t *sk) {
+    unix_buf_t *freelist = NULL;
+    unix_sock_t *putlist = NULL;
+
+    uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+    unix_release_locked(sk, &freelist, &putlist);
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+
+    unix_buf_free_list(freelist);
+    while (putlist) {
+        unix_sock_t *next = putlist->put_next;
+        unix_sock_put(putlist);
+        putlist = next;
+    }
+    unix_sock_put(sk);
+}
+
+//============================================================================
+// Socket Creation and Connection
+//============================================================================
+
+static int unix_check_type(int type) {
+    int base = type & SOCK_TYPE_MASK;
+    if (type & ~(SOCK_TYPE_MASK | SOCK_NONBLOCK | SOCK_CLOEXEC)) return -EINVAL;
+    if (base != SOCK_STREAM && base != SOCK_DGRAM && base != SOCK_SEQPACKET) return -EPROTONOSUPPORT;
+    return base;
+}
+
+int unix_socket_create(int type) {
+    int base = unix_check_type(type);
+    if (base < 0) return base;
+
+    unix_sock_t *sk = unix_sock_alloc(base);
+    if (!sk) return -ENOMEM;
+    return unix_install(sk, type);
+}
+
+// Links two sockets as peers. Lock held.
+static void unix_pair_locked(unix_sock_t *a, unix_sock_t *b) {
+    unix_sock_hold(b);
+    a->peer = b;
+    unix_sock_hold(a);
+    b->peer = a;
+    a->state = UNIX_CONNECTED;
+    b->state = UNIX_CONNECTED;
+}
+
+int unix_socketpair(int type, int fds[2]) {
+    int base = unix_check_type(type);
+    if (base < 0) return base;
+
+    unix_sock_t *a = unix_sock_alloc(base);
+    unix_sock_t *b = unix_sock_alloc(base);
+    if (!a || !b) {
+        unix_sock_put(a);
+        unix_sock_put(b);
+        return -ENOMEM;
+    }
+
+    k_ucred_t cred = unix_current_cred();
+    uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+    unix_pair_locked(a, b);
+    a->peercred = b->peercred = cred;
+    a->has_peercred = b->has_peercred = true;
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+
+    int fd0 = unix_install(a, type);
+    if (fd0 < 0) {
+        unix_release(b);
+        return fd0;
+    }
+    int fd1 = unix_install(b, type);
+    if (fd1 < 0) {
+        sys_close(fd0);
+        return fd1;
+    }
+    fds[0] = fd0;
+    fds[1] = fd1;
+    return 0;
+}
+
+int unix_listen(file_t *file, int backlog) {
+    unix_sock_t *sk = unix_from_file(file);
+    if (!sk) return -ENOTSOCK;
+    if (!unix_connection_type(sk->type)) return -EOPNOTSUPP;
+
+    if (backlog <= 0) backlog = 1;
+    if (backlog > UNIX_MAX_BACKLOG) backlog = UNIX_MAX_BACKLOG;
+
+    int err = 0;
+    uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+    if (!sk->addr || (sk->state != UNIX_UNCONNECTED && sk->state != UNIX_LISTENING)) {
+        err = -EINVAL;
+    } else {
+        sk->state = UNIX_LISTENING;
+        sk->backlog = (uint32_t)backlog;
+        sk->peercred = unix_current_cred();     // What connecting clients see
+        sk->has_peercred = true;
+        unix_wake(sk);
+    }
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+    return err;
+}
+
+static int unix_stream_connect(file_t *file, unix_sock_t *sk, unix_sock_t *listener) {
+    // The server end exists from connect() on, so data can flow before accept()
+    unix_sock_t *embryo = unix_sock_alloc(sk->type);
+    if (!embryo) return -ENOMEM;
+
+    int err = 0;
+    uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+    for (;;) {
+        if (sk->state == UNIX_CONNECTED) { err = -EISCONN; break; }
+        if (sk->state != UNIX_UNCONNECTED) { err = -EINVAL; break; }
+        if (listener->dead || listener->state != UNIX_LISTENING) { err = -ECONNREFUSED; break; }
+        if (listener->acceptq_len < listener->backlog) break;
+        if (unix_nonblock(file, 0)) { err = -EAGAIN; break; }
+        err = unix_wait(listener, &irq);
+        if (err) break;
+    }
+
+    if (!err) {
+        unix_pair_locked(sk, embryo);
+        embryo->addr = unix_addr_get(listener->addr);
+        embryo->passcred = listener->passcred;
+        embryo->sndbuf = listener->sndbuf;
+        embryo->rcvbuf = listener->rcvbuf;
+        embryo->peercred = unix_current_cred();
+        embryo->has_peercred = true;
+        sk->peercred = listener->peercred;
+        sk->has_peercred = true;
+
+        // The accept queue owns embryo's initial reference
+        if (listener->acceptq_tail) listener->acceptq_tail->accept_next = embryo;
+        else                        listener->acceptq_head = embryo;
+        listener->acceptq_tail = embryo;
+        listener->acceptq_len++;
+        unix_wake(listener);
+        embryo = NULL;
+    }
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+
+    unix_sock_put(embryo);
+    return err;
+}
+
+int unix_connect(file_t *file, const k_sockaddr_un_t *sun, uint32_t addrlen) {
+    unix_sock_t *sk = unix_from_file(file);
+    if (!sk) return -ENOTSOCK;
+
+    // Datagram sockets dissolve their association with AF_UNSPEC
+    if (!unix_connection_type(sk->type) && sun && addrlen >= sizeof(uint16_t) && sun->sun_family == 0) {
+        uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+        unix_sock_t *old = sk->peer;
+        sk->peer = NULL;
+        sk->state = UNIX_UNCONNECTED;
+        spinlock_release_irqrestore(&g_unix_lock, irq);
+        unix_sock_put(old);
+        return 0;
+    }
+
+    unix_sock_t *other;
+    int err = unix_lookup(sun, addrlen, sk->type, &other);
+    if (err) return err;
+
+    if (unix_connection_type(sk->type)) {
+        err = unix_stream_connect(file, sk, other);
+        unix_sock_put(other);
+        return err;
+    }
+
+    // Datagram: remember the default destination
+    uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+    unix_sock_t *old = sk->peer;
+    if (other->dead) {
+        err = -ECONNREFUSED;
+        old = other;
+    } else {
+        sk->peer = other;
+        sk->state = UNIX_CONNECTED;
+    }
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+    unix_sock_put(old);
+    return err;
+}
+
+static void unix_copy_name(const unix_addr_t *addr, k_sockaddr_un_t *out, uint32_t *outlen) {
+    if (!out || !outlen) return;
+    k_sockaddr_un_t name;
+    uint32_t len = SUN_PATH_OFFSET;
+    memset(&name, 0, sizeof(name));
+    name.sun_family = AF_UNIX;
+    if (addr) {
+        memcpy(name.sun_path, addr->name.sun_path, addr->keylen);
+        len = addr->len;
+    }
+    memcpy(out, &name, MIN(*outlen, sizeof(name)));
+    *outlen = len;
+}
+
+int unix_accept(file_t *file, int flags, k_sockaddr_un_t *sun, uint32_t *addrlen) {
+    unix_sock_t *sk = unix_from_file(file);
+    if (!sk) return -ENOTSOCK;
+    if (!unix_connection_type(sk->type)) return -EOPNOTSUPP;
+    if (flags & ~(SOCK_NONBLOCK | SOCK_CLOEXEC)) return -EINVAL;
+
+    int err = 0;
+    unix_sock_t *embryo = NULL;
+    uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+    for (;;) {
+        if (sk->state != UNIX_LISTENING) { err = -EINVAL; break; }
+        embryo = sk->acceptq_head;
+        if (embryo) {
+            sk->acceptq_head = embryo->accept_next;
+            if (!sk->acceptq_head) sk->acceptq_tail = NULL;
+            sk->acceptq_len--;
+            embryo->accept_next = NULL;
+            unix_wake(sk);  // Connectors waiting for a backlog slot
+            break;
+        }
+        if (unix_nonblock(file, 0)) { err = -EAGAIN; break; }
+        err = unix_wait(sk, &irq);
+        if (err) break;
+    }
+    unix_addr_t *peer_addr = (embryo && embryo->peer) ? unix_addr_get(embryo->peer->addr) : NULL;
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+    if (err) return err;
+
+    int fd = unix_install(embryo, flags);
+    if (fd >= 0) unix_copy_name(peer_addr, sun, addrlen);
+    unix_addr_put(peer_addr);
+    return fd;
+}
+
+int unix_getname(file_t *file, bool peer, k_sockaddr_un_t *sun, uint32_t *addrlen) {
+    unix_sock_t *sk = unix_from_file(file);
+    if (!sk) return -ENOTSOCK;
+
+    int err = 0;
+    uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+    unix_addr_t *addr = NULL;
+    if (peer) {
+        if (!sk->peer || sk->state != UNIX_CONNECTED) err = -ENOTCONN;
+        else addr = unix_addr_get(sk->peer->addr);
+    } else {
+        addr = unix_addr_get(sk->addr);
+    }
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+
+    if (!err) unix_copy_name(addr, sun, addrlen);
+    unix_addr_put(addr);
+    return err;
+}
+
+int unix_shutdown(file_t *file, int how) {
+    unix_sock_t *sk = unix_from_file(file);
+    if (!sk) return -ENOTSOCK;
+    if (how < SHUT_RD || how > SHUT_RDWR) return -EINVAL;
+
+    uint32_t mode = (uint32_t)how + 1;      // SHUT_* -> RCV/SEND_SHUTDOWN bits
+    int err = 0;
+    uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+    if (sk->state != UNIX_CONNECTED || !sk->peer) {
+        err = -ENOTCONN;
+    } else {
+        sk->shutdown |= mode;
+        unix_wake(sk);
+        if (unix_connection_type(sk->type)) {
+            // Our send side is the peer's receive side and vice versa
+            unix_sock_t *peer = sk->peer;
+            if (mode & SEND_SHUTDOWN) peer->shutdown |= RCV_SHUTDOWN;
+            if (mode & RCV_SHUTDOWN)  peer->shutdown |= SEND_SHUTDOWN;
+            unix_wake(peer);
+        }
+    }
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+    return err;
+}
+
+//============================================================================
+// Sending
+//============================================================================
+
+static int unix_send_error(int err, int flags) {
+    if (err == -EPIPE && !(flags & MSG_NOSIGNAL)) {
+        pcb_t *proc = get_current_process();
+        if (proc) signal_send_kernel(proc, SIGPIPE);
+    }
+    return err;
+}
+
+// Picks the credentials a record carries, if any
+static void unix_send_cred(unix_sock_t *sk, unix_sock_t *other, const unix_scm_t *scm, unix_buf_t *buf) {
+    if (scm && scm->has_cred) {
+        buf->has_cred = true;
+        buf->cred = scm->cred;
+    } else if (sk->passcred || other->passcred) {
+        buf->has_cred = true;
+        buf->cred = unix_current_cred();
+    }
+}
+
+// Sender may only claim its own identity (everyone is uid 0 here)
+static int unix_check_cred(const unix_scm_t *scm) {
+    if (!scm || !scm->has_cred) return 0;
+    k_ucred_t self = unix_current_cred();
+    if (scm->cred.pid != self.pid || scm->cred.uid != self.uid || scm->cred.gid != self.gid) return -EPERM;
+    return 0;
+}
+
+/*
+ * Builds a record that borrows the sender's pages for len bytes at addr.
+ * The pins are dropped with the record.
+ */
+static unix_buf_t *unix_buf_lend(uintptr_t addr, size_t len) {
+    pcb_t *proc = get_current_process();
+    if (!proc || !proc->mm) return NULL;
+
+    uint32_t nr_pages = (uint32_t)(((addr & (PAGE_SIZE - 1)) + len + PAGE_SIZE - 1) / PAGE_SIZE);
+    unix_buf_t *buf = kmalloc(sizeof(*buf));
+    if (!buf) return NULL;
+    memset(buf, 0, sizeof(*buf));
+    buf->frames = nr_pages > UNIX_BUF_PAGES ? kmalloc(nr_pages * sizeof(uintptr_t)) : buf->inline_frames;
+    if (!buf->frames) {
+        kfree(buf);
+        return NULL;
+    }
+    // On error nothing is left pinned; a short count is released here
+    int pinned = mm_pin_user_pages(proc->mm, addr, len, false, buf->frames, nr_pages);
+    if (pinned < 0 || (uint32_t)pinned != nr_pages) {
+        if (pinned >= 0) mm_unpin_user_pages(buf->frames, (size_t)pinned);
+        if (buf->frames != buf->inline_frames) kfree(buf->frames);
+        kfree(buf);
+        return NULL;
+    }
+    buf->nr_pages = nr_pages;
+    buf->borrowed = true;
+    buf->page_off = addr & (PAGE_SIZE - 1);
+    buf->len = (uint32_t)len;
+    return buf;
+}
+
+/*
+ * Waits until the receiver has consumed or dropped a lent record. A signal
+ * ends the wait early: the record keeps its pins, so the receiver still
+ * reads valid frames, only no longer a frozen snapshot of them.
+ */
+static void unix_wait_loan(unix_sock_t *other, unix_buf_t *buf, unix_loan_t *loan, uintptr_t *irq) {
+    while (!loan->done) {
+        tcb_t *self = get_current_task();
+        if (test_tsk_thread_flag(self, TIF_SIGPENDING)) {
+            buf->loan = NULL;
+            return;
+        }
+        self->state = TASK_BLOCKED;
+        spinlock_release_irqrestore(&g_unix_lock, *irq);
+        schedule();
+        *irq = spinlock_acquire_irqsave(&g_unix_lock);
+    }
+    (void)other;
+}
+
+// Checks that sk may send to its connected peer. Lock held.
+static int unix_stream_check_locked(unix_sock_t *sk) {
+    if (sk->err) {
+        int err = -sk->err;
+        sk->err = 0;
+        return err;
+    }
+    if (sk->shutdown & SEND_SHUTDOWN) return -EPIPE;
+    if (sk->state != UNIX_CONNECTED || !sk->peer) return -ENOTCONN;
+    if (sk->peer->dead || (sk->peer->shutdown & RCV_SHUTDOWN)) return -EPIPE;
+    return 0;
+}
+
+// Packs a short write into the peer's tail record. Lock held.
+static bool unix_try_pack_locked(unix_sock_t *sk, unix_sock_t *other, const uint8_t *data, size_t n) {
+    unix_buf_t *tail = other->rq_tail;
+    if (!tail || tail->borrowed || tail->nr_files || unix_buf_capacity(tail) - tail->len < n) return false;
+    if (other->reader && tail == other->rq_head && tail->off == tail->len) return false;
+
+    bool want_cred = sk->passcred || other->passcred;
+    if (want_cred != tail->has_cred) return false;
+    if (want_cred) {
+        k_ucred_t cred = unix_current_cred();
+        if (memcmp(&cred, &tail->cred, sizeof(cred)) != 0) return false;
+    }
+
+    unix_buf_store(tail, tail->len, data, n);
+    tail->len += (uint32_t)n;
+    other->rq_bytes += (uint32_t)n;
+    return true;
+}
+
+static ssize_t unix_stream_sendmsg(file_t *file, unix_sock_t *sk, unix_iter_t *it,
+                                   unix_scm_t *scm, int flags) {
+    size_t len = unix_iter_count(it);
+    bool nonblock = unix_nonblock(file, flags);
+    bool lend = !nonblock && !it->kernel && it->nr == 1 && len >= UNIX_ZEROCOPY_MIN;
+    size_t sent = 0;
+    int err = 0;
+
+    uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+    unix_sock_t *other = sk->peer;
+    if (other) unix_sock_hold(other);
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+
+    while (sent < len || (len == 0 && sent == 0 && scm && scm->nr_files)) {
+        // Wait for room in the peer's queue
+        size_t space = 0;
+        size_t want = 0;
+        irq = spinlock_acquire_irqsave(&g_unix_lock);
+        for (;;) {
+            err = unix_stream_check_locked(sk);
+            if (err) break;
+            if (sk->peer != other) { err = -EPIPE; break; }
+            if (other->rq_bytes < other->rcvbuf) {
+                space = other->rcvbuf - other->rq_bytes;
+                if (!other->rq_head) want = other->reader_want;
+                break;
+            }
+            if (nonblock) { err = -EAGAIN; break; }
+            err = unix_wait(other, &irq);
+            if (err) break;
+        }
+        spinlock_release_irqrestore(&g_unix_lock, irq);
+        if (err) break;
+
+        size_t chunk = len - sent;
+        bool with_scm = scm && (scm->nr_files || scm->has_cred);
+        unix_buf_t *buf = NULL;
+        unix_loan_t loan = { get_current_task(), false };
+
+        if (lend && chunk >= UNIX_ZEROCOPY_MIN && want >= UNIX_ZEROCOPY_MIN) {
+            // Lend no more than the waiting reader takes in one go
+            uintptr_t addr = it->iov[0].iov_base + it->seg_off;
+            chunk = MIN(chunk, want);
+            chunk = MIN(chunk, UNIX_LOAN_MAX_PAGES * PAGE_SIZE - (addr & (PAGE_SIZE - 1)));
+            buf = unix_buf_lend(addr, chunk);
+            if (buf) {
+                buf->loan = &loan;
+                it->seg_off += (uint32_t)chunk;
+            } else {
+                chunk = len - sent;     // Pinning failed: copy instead
+            }
+        }
+
+        if (!buf && chunk <= UNIX_PACK_MAX && !with_scm && chunk > 0) {
+            uint8_t stage[UNIX_PACK_MAX];
+            unix_iter_t saved = *it;
+            if (!unix_iter_copy(it, stage, chunk, false)) { err = -EFAULT; break; }
+            irq = spinlock_acquire_irqsave(&g_unix_lock);
+            err = unix_stream_check_locked(sk);
+            bool packed = !err && sk->peer == other && unix_try_pack_locked(sk, other, stage, chunk);
+            if (packed) unix_wake(other);
+            spinlock_release_irqrestore(&g_unix_lock, irq);
+            if (err) break;
+            if (packed) {
+                sent += chunk;
+                continue;
+            }
+            *it = saved;        // Copy again into a record of its own
+        }
+
+        if (!buf) {
+            chunk = MIN(chunk, MIN(space, (size_t)UNIX_BUF_PAGES * PAGE_SIZE));
+            buf = unix_buf_alloc(chunk ? chunk : 1);
+            if (!buf) { err = -ENOMEM; break; }
+            if (chunk && !unix_buf_copy(buf, 0, it, chunk, false)) {
+                unix_buf_free(buf);
+                err = -EFAULT;
+                break;
+            }
+            buf->len = (uint32_t)chunk;
+        }
+
+        if (with_scm) {
+            unix_send_cred(sk, other, scm, buf);
+            if (unix_buf_attach_files(buf, scm) != 0) {
+                buf->loan = NULL;
+                unix_buf_free(buf);
+                err = -ENOMEM;
+                break;
+            }
+            scm->has_cred = false;
+        } else {
+            unix_send_cred(sk, other, NULL, buf);
+        }
+
+        irq = spinlock_acquire_irqsave(&g_unix_lock);
+        err = unix_stream_check_locked(sk);
+        if (!err && sk->peer != other) err = -EPIPE;
+        if (err) {
+            spinlock_release_irqrestore(&g_unix_lock, irq);
+            buf->loan = NULL;
+            unix_buf_free(buf);
+            break;
+        }
+        unix_queue_tail(other, buf);
+        unix_wake(other);
+        if (buf->loan) unix_wait_loan(other, buf, &loan, &irq);
+        spinlock_release_irqrestore(&g_unix_lock, irq);
+
+        sent += chunk;
+        if (len == 0) break;
+    }
+
+    unix_sock_put(other);
+    if (sent > 0) return (ssize_t)sent;
+    return unix_send_error(err, flags);
+}
+
+static ssize_t unix_dgram_sendmsg(file_t *file, unix_sock_t *sk, unix_iter_t *it,
+                                  const k_sockaddr_un_t *to, uint32_t tolen,
+                                  unix_scm_t *scm, int flags) {
+    size_t len = unix_iter_count(it);
+    bool nonblock = unix_nonblock(file, flags);
+    if (len > sk->sndbuf) return -EMSGSIZE;
+
+    unix_sock_t *other = NULL;
+    int err;
+    if (to) {
+        err = unix_lookup(to, tolen, sk->type, &other);
+        if (err) return err;
+    } else {
+        uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+        other = sk->peer;
+        if (other) unix_sock_hold(other);
+        spinlock_release_irqrestore(&g_unix_lock, irq);
+        if (!other) return sk->type == SOCK_SEQPACKET ? -ENOTCONN : -EDESTADDRREQ;
+    }
+
+    // Copy (or lend) the whole message first; it is queued atomically
+    uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+    bool reader_waiting = !other->rq_head && other->reader_want != 0;
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+
+    unix_loan_t loan = { get_current_task(), false };
+    unix_buf_t *buf = NULL;
+    if (reader_waiting && !nonblock && !it->kernel && it->nr == 1 && len >= UNIX_ZEROCOPY_MIN &&
+        len <= UNIX_LOAN_MAX_PAGES * PAGE_SIZE - PAGE_SIZE) {
+        buf = unix_buf_lend(it->iov[0].iov_base, len);
+        if (buf) buf->loan = &loan;
+    }
+    if (!buf) {
+        buf = unix_buf_alloc(len);
+        if (!buf) { unix_sock_put(other); return -ENOMEM; }
+        if (len && !unix_buf_copy(buf, 0, it, len, false)) {
+            unix_buf_free(buf);
+            unix_sock_put(other);
+            return -EFAULT;
+        }
+        buf->len = (uint32_t)len;
+    }
+    unix_send_cred(sk, other, scm, buf);
+    if (unix_buf_attach_files(buf, scm) != 0) {
+        buf->loan = NULL;
+        unix_buf_free(buf);
+        unix_sock_put(other);
+        return -ENOMEM;
+    }
+
+    irq = spinlock_acquire_irqsave(&g_unix_lock);
+    buf->from = unix_addr_get(sk->addr);
+    for (;;) {
+        if (sk->shutdown & SEND_SHUTDOWN) { err = -EPIPE; break; }
+        if (other->dead) {
+            // Connected peer is gone: drop the association
+            err = (sk->peer == other) ? -ECONNRESET : -ECONNREFUSED;
+            if (sk->peer == other && sk->type == SOCK_DGRAM) {
+                sk->peer = NULL;
+                sk->state = UNIX_UNCONNECTED;
+                unix_sock_put(other);   // sk's link; still held by us
+            }
+            break;
+        }
+        if (other->shutdown & RCV_SHUTDOWN) { err = -EPIPE; break; }
+        if (other->peer && other->peer != sk && !unix_connection_type(sk->type)) { err = -EPERM; break; }
+        if (other->rq_count < UNIX_MAX_DGRAM_QLEN &&
+            (other->rq_bytes + len <= other->rcvbuf || other->rq_count == 0)) {
+            err = 0;
+            break;
+        }
+        if (nonblock) { err = -EAGAIN; break; }
+        err = unix_wait(other, &irq);
+        if (err) break;
+    }
+    if (!err) {
+        unix_queue_tail(other, buf);
+        unix_wake(other);
+        if (buf->loan) unix_wait_loan(other, buf, &loan, &irq);
+        buf = NULL;
+    }
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+
+    if (buf) {
+        // Not queued: hand the files back to the caller's scm for cleanup
+        if (scm) {
+            for (uint32_t i = 0; i < buf->nr_files; i++) {
+                scm->files[i] = buf->files[i];
+                buf->files[i] = NULL;
+            }
+            scm->nr_files = buf->nr_files;
+        }
+        buf->loan = NULL;
+        unix_buf_free(buf);
+    }
+    unix_sock_put(other);
+    return err ? unix_send_error(err, flags) : (ssize_t)len;
+}
+
+static ssize_t unix_do_sendmsg(file_t *file, unix_iter_t *it, const k_sockaddr_un_t *to,
+                               uint32_t tolen, unix_scm_t *scm, int flags) {
+    unix_sock_t *sk = unix_from_file(file);
+    if (!sk) return -ENOTSOCK;
+    if (flags & MSG_OOB) return -EOPNOTSUPP;
+    int err = unix_check_cred(scm);
+    if (err) return err;
+
+    if (sk->type == SOCK_STREAM) {
+        if (to) return sk->state == UNIX_CONNECTED ? -EISCONN : -EOPNOTSUPP;
+        return unix_stream_sendmsg(file, sk, it, scm, flags);
+    }
+    if (sk->type == SOCK_SEQPACKET) {
+        uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+        err = unix_stream_check_locked(sk);
+        spinlock_release_irqrestore(&g_unix_lock, irq);
+        if (err) return unix_send_error(err, flags);
+        to = NULL;      // Records go to the connected peer
+    }
+    return unix_dgram_sendmsg(file, sk, it, to, tolen, scm, flags);
+}
+
+ssize_t unix_sendmsg(file_t *file, const k_iovec_t *iov, uint32_t iovcnt,
+                     const k_sockaddr_un_t *to, uint32_t tolen,
+                     unix_scm_t *scm, int flags) {
+    unix_iter_t it;
+    unix_iter_init(&it, iov, iovcnt, false);
+    return unix_do_sendmsg(file, &it, to, tolen, scm, flags);
+}
+
+//============================================================================
+// Receiving
+//============================================================================
+
+// Hands a record's control data to the caller. Lock not needed: buf is ours.
+static void unix_recv_scm(unix_sock_t *sk, unix_buf_t *buf, unix_scm_t *scm, int *msg_flags) {
+    if (scm && buf->has_cred && sk->passcred) {
+        scm->has_cred = true;
+        scm->cred = buf->cred;
+    }
+    if (buf->nr_files == 0) return;
+
+    uint32_t room = scm ? scm->max_files - scm->nr_files : 0;
+    for (uint32_t i = 0; i < buf->nr_files; i++) {
+        if (i < room) {
+            scm->files[scm->nr_files] = buf->files[i];
+            scm->file_flags[scm->nr_files] = buf->file_flags[i];
+            scm->nr_files++;
+            buf->files[i] = NULL;
+        }
+    }
+    if (buf->nr_files > room && msg_flags) *msg_flags |= MSG_CTRUNC;
+    // Files beyond room are closed with the record
+}
+
+// Claims sk's receive side for the current task. Lock held.
+static int unix_lock_reader(unix_sock_t *sk, uintptr_t *irq) {
+    tcb_t *self = get_current_task();
+    while (sk->reader && sk->reader != self) {
+        int err = unix_wait(sk, irq);
+        if (err) return err;
+    }
+    sk->reader = self;
+    return 0;
+}
+
+static void unix_unlock_reader(unix_sock_t *sk) {
+    sk->reader = NULL;
+    unix_wake(sk);
+}
+
+// Why a receive on an empty queue cannot wait. Lock held.
+static int unix_recv_empty_locked(unix_sock_t *sk, bool *eof) {
+    *eof = false;
+    if (sk->err) {
+        int err = -sk->err;
+        sk->err = 0;
+        return err;
+    }
+    if (sk->shutdown & RCV_SHUTDOWN) {
+        *eof = true;
+        return 0;
+    }
+    if (unix_connection_type(sk->type) && sk->state != UNIX_CONNECTED) return -ENOTCONN;
+    return 0;
+}
+
+static ssize_t unix_stream_recvmsg(file_t *file, unix_sock_t *sk, unix_iter_t *it,
+                                   unix_scm_t *scm, int *msg_flags, int flags) {
+    size_t len = unix_iter_count(it);
+    bool nonblock = unix_nonblock(file, flags);
+    bool peek = (flags & MSG_PEEK) != 0;
+    size_t target = (flags & MSG_WAITALL) ? len : 1;
+    size_t copied = 0;
+    unix_buf_t *freelist = NULL;
+    int err = 0;
+
+    uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+    err = unix_lock_reader(sk, &irq);
+    if (err) {
+        spinlock_release_irqrestore(&g_unix_lock, irq);
+        return err;
+    }
+
+    file_t **drop_files = NULL;
+    uint32_t drop_nr = 0;
+    unix_buf_t *cur = NULL;         // Position while peeking
+    uint32_t peek_off = 0;
+    bool have_cred = false;
+    k_ucred_t first_cred = { 0, 0, 0 };
+
+    while (copied < len) {
+        unix_buf_t *buf = peek ? (cur ? cur : sk->rq_head) : sk->rq_head;
+        uint32_t start = peek ? (cur ? peek_off : (buf ? buf->off : 0)) : (buf ? buf->off : 0);
+        if (buf && start == buf->len && !buf->nr_files) {
+            if (peek) {
+                cur = buf->next;
+                peek_off = cur ? cur->off : 0;
+                if (cur) continue;
+                buf = NULL;
+            } else if (buf != sk->rq_tail) {
+                // Fully read, and no writer will pack into it any more
+                unix_buf_t *done = unix_dequeue_head(sk);
+                unix_buf_end_loan(done);
+                done->next = freelist;
+                freelist = done;
+                continue;
+            } else {
+                buf = NULL;
+            }
+        }
+
+        if (!buf) {
+            if (copied >= target) break;
+            bool eof;
+            err = unix_recv_empty_locked(sk, &eof);
+            if (err || eof) break;
+            if (nonblock) { err = -EAGAIN; break; }
+            sk->reader_want = (uint32_t)(len - copied);
+            err = unix_wait(sk, &irq);
+            sk->reader_want = 0;
+            if (err) break;
+            continue;
+        }
+
+        // Keep messages from different senders or carrying descriptors apart
+        if (copied > 0 && (buf->nr_files || buf->has_cred != have_cred ||
+                           (have_cred && memcmp(&buf->cred, &first_cred, sizeof(first_cred)) != 0))) {
+            break;
+        }
+        if (copied == 0) {
+            have_cred = buf->has_cred;
+            first_cred = buf->cred;
+        }
+
+        uint32_t avail = buf->len - start;
+        size_t n = MIN((size_t)avail, len - copied);
+        spinlock_release_irqrestore(&g_unix_lock, irq);
+        bool ok = unix_buf_copy(buf, start, it, n, true);
+        irq = spinlock_acquire_irqsave(&g_unix_lock);
+        if (!ok) {
+            if (copied == 0) err = -EFAULT;
+            break;
+        }
+        copied += n;
+
+        bool had_files = buf->nr_files != 0;
+        if (peek) {
+            cur = buf;
+            peek_off = start + (uint32_t)n;
+        } else {
+            buf->off += (uint32_t)n;
+            sk->rq_bytes -= (uint32_t)n;
+            if (start == 0 || had_files) unix_recv_scm(sk, buf, scm, msg_flags);
+            if (buf->off == buf->len && (buf != sk->rq_tail || buf->borrowed || had_files)) {
+                unix_buf_t *done = unix_dequeue_head(sk);
+                unix_buf_end_loan(done);
+                done->next = freelist;
+                freelist = done;
+            } else if (had_files) {
+                // Descriptors go out with the first byte only; close the
+                // ones that did not fit once the lock is dropped
+                drop_files = buf->files;
+                drop_nr = buf->nr_files;
+                buf->files = NULL;
+                buf->file_flags = NULL;
+                buf->nr_files = 0;
+            }
+            unix_wake(sk);  // Room for writers
+        }
+        if (had_files) break;
+    }
+
+    unix_unlock_reader(sk);
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+    unix_buf_free_list(freelist);
+    if (drop_files) {
+        for (uint32_t i = 0; i < drop_nr; i++) {
+            if (drop_files[i]) vfs_close(drop_files[i]);
+        }
+        kfree(drop_files);
+    }
+
+    if (copied > 0) return (ssize_t)copied;
+    return err;
+}
+
+static ssize_t unix_dgram_recvmsg(file_t *file, unix_sock_t *sk, unix_iter_t *it,
+                                  k_sockaddr_un_t *from, uint32_t *fromlen,
+                                  unix_scm_t *scm, int *msg_flags, int flags) {
+    size_t len = unix_iter_count(it);
+    bool nonblock = unix_nonblock(file, flags);
+    bool peek = (flags & MSG_PEEK) != 0;
+    int err;
+
+    uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+    err = unix_lock_reader(sk, &irq);
+    unix_buf_t *buf = NULL;
+    while (!err) {
+        buf = sk->rq_head;
+        if (buf) break;
+        bool eof;
+        err = unix_recv_empty_locked(sk, &eof);
+        if (err) break;
+        if (eof) {
+            unix_unlock_reader(sk);
+            spinlock_release_irqrestore(&g_unix_lock, irq);
+            if (fromlen) *fromlen = 0;
+            return 0;
+        }
+        if (nonblock) { err = -EAGAIN; break; }
+        sk->reader_want = len ? (uint32_t)len : 1;
+        err = unix_wait(sk, &irq);
+        sk->reader_want = 0;
+    }
+    if (err) {
+        if (sk->reader == get_current_task()) unix_unlock_reader(sk);
+        spinlock_release_irqrestore(&g_unix_lock, irq);
+        return err;
+    }
+    if (!peek) {
+        unix_dequeue_head(sk);
+        unix_wake(sk);      // Room for senders
+    }
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+
+    size_t n = MIN(len, (size_t)buf->len);
+    ssize_t ret = (ssize_t)n;
+    if (n && !unix_buf_copy(buf, 0, it, n, true)) ret = -EFAULT;
+    if (ret >= 0) {
+        if (buf->len > len) {
+            if (msg_flags) *msg_flags |= MSG_TRUNC;
+            if (flags & MSG_TRUNC) ret = (ssize_t)buf->len;
+        }
+        if (from && fromlen) {
+            if (buf->from) {
+                unix_copy_name(buf->from, from, fromlen);
+            } else {
+                *fromlen = 0;
+            }
+        }
+        if (!peek) unix_recv_scm(sk, buf, scm, msg_flags);
+    }
+
+    irq = spinlock_acquire_irqsave(&g_unix_lock);
+    if (!peek) unix_buf_end_loan(buf);
+    unix_unlock_reader(sk);
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+
+    if (!peek) unix_buf_free(buf);
+    return ret;
+}
+
+static ssize_t unix_do_recvmsg(file_t *file, unix_iter_t *it, k_sockaddr_un_t *from,
+                               uint32_t *fromlen, unix_scm_t *scm, int *msg_flags, int flags) {
+    unix_sock_t *sk = unix_from_file(file);
+    if (!sk) return -ENOTSOCK;
+    if (flags & MSG_OOB) return -EOPNOTSUPP;
+    if (msg_flags) *msg_flags = 0;
+
+    if (sk->type == SOCK_STREAM) {
+        if (fromlen) *fromlen = 0;
+        return unix_stream_recvmsg(file, sk, it, scm, msg_flags, flags);
+    }
+    return unix_dgram_recvmsg(file, sk, it, from, fromlen, scm, msg_flags, flags);
+}
+
+ssize_t unix_recvmsg(file_t *file, const k_iovec_t *iov, uint32_t iovcnt,
+                     k_sockaddr_un_t *from, uint32_t *fromlen,
+                     unix_scm_t *scm, int *msg_flags, int flags) {
+    unix_iter_t it;
+    unix_iter_init(&it, iov, iovcnt, false);
+    return unix_do_recvmsg(file, &it, from, fromlen, scm, msg_flags, flags);
+}
+
+//============================================================================
+// Socket Options
+//============================================================================
+
+static int unix_opt_int(const void *val, uint32_t len, int *out) {
+    if (!val || len < sizeof(int)) return -EINVAL;
+    memcpy(out, val, sizeof(int));
+    return 0;
+}
+
+static uint32_t unix_clamp_buf(int v) {
+    if (v < UNIX_MIN_BUF) return UNIX_MIN_BUF;
+    if (v > UNIX_MAX_BUF) return UNIX_MAX_BUF;
+    return (uint32_t)v;
+}
+
+int unix_setsockopt(file_t *file, int level, int name, const void *val, uint32_t len) {
+    unix_sock_t *sk = unix_from_file(file);
+    if (!sk) return -ENOTSOCK;
+    if (level != SOL_SOCKET) return -ENOPROTOOPT;
+
+    int v;
+    int err = unix_opt_int(val, len, &v);
+    if (err) return err;
+
+    uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+    switch (name) {
+        case SO_SNDBUF:   sk->sndbuf = unix_clamp_buf(v); break;
+        case SO_RCVBUF:   sk->rcvbuf = unix_clamp_buf(v); unix_wake(sk); break;
+        case SO_PASSCRED: sk->passcred = v != 0; break;
+        default:          err = -ENOPROTOOPT; break;
+    }
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+    return err;
+}
+
+int unix_getsockopt(file_t *file, int level, int name, void *val, uint32_t *len) {
+    unix_sock_t *sk = unix_from_file(file);
+    if (!sk) return -ENOTSOCK;
+    if (level != SOL_SOCKET) return -ENOPROTOOPT;
+    if (!val || !len) return -EINVAL;
+
+    int v = 0;
+    k_ucred_t cred = { 0, (uint32_t)-1, (uint32_t)-1 };
+    bool is_cred = false;
+
+    uintptr_t irq = spinlock_acquire_irqsave(&g_unix_lock);
+    switch (name) {
+        case SO_TYPE:       v = sk->type; break;
+        case SO_ERROR:      v = sk->err; sk->err = 0; break;
+        case SO_SNDBUF:     v = (int)sk->sndbuf; break;
+        case SO_RCVBUF:     v = (int)sk->rcvbuf; break;
+        case SO_PASSCRED:   v = sk->passcred; break;
+        case SO_ACCEPTCONN: v = sk->state == UNIX_LISTENING; break;
+        case SO_DOMAIN:     v = AF_UNIX; break;
+        case SO_PROTOCOL:   v = 0; break;
+        case SO_PEERCRED:
+            is_cred = true;
+            if (sk->has_peercred) cred = sk->peercred;
+            break;
+        default:
+            spinlock_release_irqrestore(&g_unix_lock, irq);
+            return -ENOPROTOOPT;
+    }
+    spinlock_release_irqrestore(&g_unix_lock, irq);
+
+    if (is_cred) {
+        uint32_t n = MIN(*len, (uint32_t)sizeof(cred));
+        memcpy(val, &cred, n);
+        *len = n;
+    } else {
+        uint32_t n = MIN(*len, (uint32_t)sizeof(int));
+        memcpy(val, &v, n);
+        *len = n;
+    }
+    return 0;
+}
+
+//============================================================================
+// VFS Operations
+//============================================================================
+
+ssize_t unix_read_kernel(file_t *file, void *buf, size_t count, int flags) {
+    k_iovec_t iov = { (uint32_t)(uintptr_t)buf, (uint32_t)count };
+    unix_iter_t it;
+    unix_iter_init(&it, &iov, 1, true);
+    return unix_do_recvmsg(file, &it, NULL, NULL, NULL, NULL, flags);
+}
+
+ssize_t unix_write_kernel(file_t *file, const void *buf, size_t count, int flags) {
+    k_iovec_t iov = { (uint32_t)(uintptr_t)buf, (uint32_t)count };
+    unix_iter_t it;
+    unix_iter_init(&it, &iov, 1, true);
+    return unix_do_sendmsg(file, &it, NULL, 0, NULL, flags);
+}
+
+// vfs_read()/vfs_write() call in with file->lock held: never sleep there
+static int unix_vfs_read(file_t *file, void *buffer, size_t count) {
+    return (int)unix_read_kernel(file, buffer, count, MSG_DONTWAIT);
+}
+
+static int unix_vfs_write(file_t *file, const void *buffer, size_t count) {
+    return (int)unix_write_kernel(file, buffer, count, MSG_DONTWAIT | MSG_NOSIGNAL);
+}
+
+static int unix_vfs_close(file_t *file) {
+    unix_sock_t *sk = unix_from_file(file);
+    if (!sk) return -EINVAL;
+    file->vnode->data = NULL;
+    unix_release(sk);
+    return 0;
+}
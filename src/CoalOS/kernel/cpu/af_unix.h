@@ -0,0 +1,188 @@
+/**
+ * @file af_unix.h
+ * @brief UNIX domain sockets (AF_UNIX) for local IPC
+ *
+ * @details Stream, datagram and seqpacket sockets between processes on this
+ * machine. A socket is an anonymous vnode (like timerfd); names live in an
+ * in-kernel table, either a path ("/run/app.sock") or an abstract name
+ * (sun_path[0] == '\0'). Messages can carry the sender's credentials
+ * (SCM_CREDENTIALS) and open descriptors (SCM_RIGHTS).
+ *
+ * Queued data lives in whole page frames rather than per-message buffers:
+ * small stream writes are packed into the tail page of the peer's queue, and
+ * a large send from a blocking socket to a receiver that is already waiting
+ * lends its pinned user pages, which the receiver copies straight out of.
+ */
+
+#ifndef AF_UNIX_H
+#define AF_UNIX_H
+
+//============================================================================
+// Includes
+//============================================================================
+#include "syscall_fileio.h"
+#include <kernel/fs/vfs/vfs.h>
+#include <libc/stdint.h>
+#include <libc/stdbool.h>
+
+//============================================================================
+// User ABI (matches Linux i386)
+//============================================================================
+
+#define AF_UNIX             1
+#define AF_LOCAL            AF_UNIX
+
+#define SOCK_STREAM         1
+#define SOCK_DGRAM          2
+#define SOCK_SEQPACKET      5
+#define SOCK_TYPE_MASK      0xf
+#define SOCK_NONBLOCK       0x00000800  // == O_NONBLOCK
+#define SOCK_CLOEXEC        0x00080000
+
+// send/recv flags
+#define MSG_OOB             0x0001
+#define MSG_PEEK            0x0002
+#define MSG_CTRUNC          0x0008
+#define MSG_TRUNC           0x0020
+#define MSG_DONTWAIT        0x0040
+#define MSG_EOR             0x0080
+#define MSG_WAITALL         0x0100
+#define MSG_NOSIGNAL        0x4000
+#define MSG_CMSG_CLOEXEC    0x40000000
+
+#define SHUT_RD             0
+#define SHUT_WR             1
+#define SHUT_RDWR           2
+
+#define SOL_SOCKET          1
+#define SO_TYPE             3
+#define SO_ERROR            4
+#define SO_SNDBUF           7
+#define SO_RCVBUF           8
+#define SO_PASSCRED         16
+#define SO_PEERCRED         17
+#define SO_ACCEPTCONN       30
+#define SO_PROTOCOL         38
+#define SO_DOMAIN           39
+
+// cmsg_type at SOL_SOCKET
+#define SCM_RIGHTS          1
+#define SCM_CREDENTIALS     2
+
+#define UNIX_PATH_MAX       108
+#define SCM_MAX_FD          253         // Descriptors per SCM_RIGHTS message
+
+typedef struct {
+    uint16_t sun_family;
+    char     sun_path[UNIX_PATH_MAX];
+} k_sockaddr_un_t;
+
+// struct ucred
+typedef struct {
+    int32_t  pid;
+    uint32_t uid;
+    uint32_t gid;
+} k_ucred_t;
+
+//============================================================================
+// Ancillary Data
+//============================================================================
+
+/**
+ * @brief Decoded control data of one message
+ * @details On send the syscall layer fills it from the cmsgs and holds a
+ * reference to every file. On receive max_files is the room in the caller's
+ * control buffer; unix_recvmsg() hands over that many references and drops
+ * the rest (MSG_CTRUNC).
+ */
+typedef struct {
+    file_t   *files[SCM_MAX_FD];
+    int       file_flags[SCM_MAX_FD];   // sys_file_t flags of each descriptor
+    uint32_t  nr_files;
+    uint32_t  max_files;
+    bool      has_cred;
+    k_ucred_t cred;
+} unix_scm_t;
+
+//============================================================================
+// Socket Operations
+//============================================================================
+
+/** @brief True if file is an AF_UNIX socket */
+bool unix_is_socket(file_t *file);
+
+/**
+ * @brief Creates an unbound, unconnected socket and installs its descriptor
+ * @param type SOCK_* plus SOCK_NONBLOCK / SOCK_CLOEXEC
+ * @return Descriptor, or negative error code
+ */
+int unix_socket_create(int type);
+
+/**
+ * @brief Creates a connected pair of sockets
+ * @param fds Receives the two descriptors
+ * @return 0, or negative error code
+ */
+int unix_socketpair(int type, int fds[2]);
+
+/** @brief Names a socket; fails with -EADDRINUSE if the name is taken */
+int unix_bind(file_t *file, const k_sockaddr_un_t *addr, uint32_t addrlen);
+
+/**
+ * @brief Connects to a listening socket (stream, seqpacket) or sets the
+ *        default destination (datagram)
+ */
+int unix_connect(file_t *file, const k_sockaddr_un_t *addr, uint32_t addrlen);
+
+/** @brief Marks a bound stream/seqpacket socket as accepting connections */
+int unix_listen(file_t *file, int backlog);
+
+/**
+ * @brief Takes the oldest pending connection and installs its descriptor
+ * @param flags SOCK_NONBLOCK / SOCK_CLOEXEC for the new descriptor
+ * @param addr Receives the peer's name (may be NULL)
+ * @return Descriptor, or negative error code
+ */
+int unix_accept(file_t *file, int flags, k_sockaddr_un_t *addr, uint32_t *addrlen);
+
+/**
+ * @brief Sends one message gathered from user memory
+ * @param iov User buffers
+ * @param to Destination for unconnected datagram sockets (may be NULL)
+ * @param scm Control data; on success its file references are consumed
+ * @return Bytes sent, or negative error code
+ */
+ssize_t unix_sendmsg(file_t *file, const k_iovec_t *iov, uint32_t iovcnt,
+                     const k_sockaddr_un_t *to, uint32_t tolen,
+                     unix_scm_t *scm, int flags);
+
+/**
+ * @brief Receives data into user memory
+ * @param from Receives the sender's name (may be NULL)
+ * @param scm Receives control data (may be NULL: passed files are dropped)
+ * @param msg_flags Receives MSG_TRUNC / MSG_CTRUNC (may be NULL)
+ * @return Bytes received (0 at end of stream), or negative error code
+ */
+ssize_t unix_recvmsg(file_t *file, const k_iovec_t *iov, uint32_t iovcnt,
+                     k_sockaddr_un_t *from, uint32_t *fromlen,
+                     unix_scm_t *scm, int *msg_flags, int flags);
+
+/**
+ * @brief read()/write() on kernel memory, for in-kernel copies (sendfile())
+ * @param flags MSG_* flags
+ * @return Bytes transferred, or negative error code
+ */
+ssize_t unix_read_kernel(file_t *file, void *buf, size_t count, int flags);
+ssize_t unix_write_kernel(file_t *file, const void *buf, size_t count, int flags);
+
+/** @brief Shuts down reception and/or transmission (SHUT_*) */
+int unix_shutdown(file_t *file, int how);
+
+/** @brief Reports the socket's own name, or its peer's */
+int unix_getname(file_t *file, bool peer, k_sockaddr_un_t *addr, uint32_t *addrlen);
+
+/** @brief SOL_SOCKET options; val is a kernel buffer */
+int unix_setsockopt(file_t *file, int level, int name, const void *val, uint32_t len);
+int unix_getsockopt(file_t *file, int level, int name, void *val, uint32_t *len);
+
+#endif // AF_UNIX_H
@@ -0,0 +1,365 @@
+/**
+ * @file apic.c
+ * @brief Local APIC / I/O APIC access and ACPI MADT parsing
+ *
+ * The MADT is read straight from physical memory through the temp mapper,
+ * so this runs once the memory subsystems are up but needs no ACPI layer.
+ * Register pages are mapped uncached into a fixed kernel window; the local
+ * APIC page sits at the same physical address on every CPU, so a single
+ * mapping serves them all.
+ */
+
+#define LOG_MODULE "apic"
+
+#include <kernel/cpu/apic.h>
+#include <kernel/cpu/cpuid.h>
+#include <kernel/cpu/msr.h>
+#include <kernel/cpu/get_cpu_id.h>
+#include <kernel/memory/paging.h>
+#include <kernel/memory/paging_core.h>
+#include <kernel/memory/paging_temp.h>
+#include <kernel/memory/kmalloc.h>
+#include <kernel/interfaces/logger.h>
+#include <kernel/sync/spinlock.h>
+#include <kernel/lib/string.h>
+
+#define MSR_IA32_APIC_BASE      0x1B
+#define APIC_BASE_ENABLE        (1u << 11)
+#define CPUID_FEAT_EDX_APIC     (1u << 9)
+
+#define MADT_MAX_SIZE           16384u
+
+// MADT entry types
+#define MADT_LOCAL_APIC         0
+#define MADT_IO_APIC            1
+#define MADT_ISO                2
+#define MADT_LAPIC_ADDR         5
+
+typedef struct __attribute__((packed)) {
+    char     signature[8];
+    uint8_t  checksum;
+    char     oem_id[6];
+    uint8_t  revision;
+    uint32_t rsdt_address;
+} acpi_rsdp_t;
+
+typedef struct __attribute__((packed)) {
+    char     signature[4];
+    uint32_t length;
+    uint8_t  revision;
+    uint8_t  checksum;
+    char     oem_id[6];
+    char     oem_table_id[8];
+    uint32_t oem_revision;
+    uint32_t creator_id;
+    uint32_t creator_revision;
+} acpi_sdt_header_t;
+
+typedef struct {
+    volatile uint32_t *regs;    // IOREGSEL at +0x00, IOWIN at +0x10
+    uint32_t gsi_base;
+    uint32_t gsi_count;
+} ioapic_t;
+
+static volatile uint8_t *g_lapic;
+static ioapic_t g_ioapics[APIC_MAX_IOAPICS];
+static uint32_t g_ioapic_count;
+static apic_isa_route_t g_isa_routes[16];
+static uint8_t g_cpu_apic_ids[MAX_CPUS];
+static uint32_t g_cpu_count;
+static bool g_apic_ready = false;
+static spinlock_t g_ioapic_lock = {0};
+
+//============================================================================
+// MMIO helpers
+//============================================================================
+
+static inline uint32_t lapic_read(uint32_t reg) {
+    return *(volatile uint32_t *)(g_lapic + reg);
+}
+
+static inline void lapic_write(uint32_t reg, uint32_t value) {
+    *(volatile uint32_t *)(g_lapic + reg) = value;
+}
+
+static uint32_t ioapic_read(const ioapic_t *io, uint32_t reg) {
+    io->regs[0] = reg;
+    return io->regs[4];
+}
+
+static void ioapic_write(const ioapic_t *io, uint32_t reg, uint32_t value) {
+    io->regs[0] = reg;
+    io->regs[4] = value;
+}
+
+static void *map_mmio_page(uint32_t slot, uintptr_t phys) {
+    uintptr_t vaddr = APIC_MMIO_VIRT_BASE + slot * PAGE_SIZE;
+    if (paging_map_single_4k((uint32_t *)g_kernel_page_directory_phys, vaddr,
+                             phys & ~(uintptr_t)(PAGE_SIZE - 1),
+                             PTE_KERNEL_DATA_FLAGS | PAGE_PCD | PAGE_PWT) != 0) {
+        return NULL;
+    }
+    return (void *)(vaddr + (phys & (PAGE_SIZE - 1)));
+}
+
+//============================================================================
+// MADT discovery
+//============================================================================
+
+static void read_phys(uintptr_t phys, void *dst, size_t len) {
+    uint8_t *out = dst;
+    while (len) {
+        uintptr_t page = phys & ~(uintptr_t)(PAGE_SIZE - 1);
+        size_t off = phys - page;
+        size_t chunk = PAGE_SIZE - off;
+        if (chunk > len) chunk = len;
+
+        uint8_t *virt = paging_temp_map(page);
+        if (!virt) {
+            memset(out, 0, len);
+            return;
+        }
+        memcpy(out, virt + off, chunk);
+        paging_temp_unmap((uintptr_t)virt);
+
+        out += chunk;
+        phys += chunk;
+        len -= chunk;
+    }
+}
+
+static uintptr_t find_madt(const acpi_rsdp_t *rsdp) {
+    if (!rsdp || memcmp(rsdp->signature, "RSD PTR ", 8) != 0) return 0;
+
+    acpi_sdt_header_t rsdt;
+    read_phys(rsdp->rsdt_address, &rsdt, sizeof(rsdt));
+    if (memcmp(rsdt.signature, "RSDT", 4) != 0) return 0;
+
+    uint32_t entries = (rsdt.length - sizeof(rsdt)) / sizeof(uint32_t);
+    for (uint32_t i = 0; i < entries; i++) {
+        uint32_t table;
+        read_phys(rsdp->rsdt_address + sizeof(rsdt) + i * sizeof(uint32_t), &table, sizeof(table));
+
+        char sig[4];
+        read_phys(table, sig, sizeof(sig));
+        if (memcmp(sig, "APIC", 4) == 0) return table;
+    }
+    return 0;
+}
+
+static void parse_madt(uintptr_t madt_phys, uintptr_t *lapic_phys) {
+    acpi_sdt_header_t hdr;
+    read_phys(madt_phys, &hdr, sizeof(hdr));
+    if (hdr.length < sizeof(hdr) + 8 || hdr.length > MADT_MAX_SIZE) return;
+
+    uint8_t *madt = kmalloc(hdr.length);
+    if (!madt) return;
+    read_phys(madt_phys, madt, hdr.length);
+
+    *lapic_phys = *(uint32_t *)(madt + sizeof(hdr));
+
+    for (uint32_t off = sizeof(hdr) + 8; off + 2 <= hdr.length; ) {
+        uint8_t type = madt[off];
+        uint8_t len = madt[off + 1];
+        if (len < 2 || off + len > hdr.length) break;
+        const uint8_t *e = madt + off;
+
+        switch (type) {
+        case MADT_LOCAL_APIC:
+            // Flags bit 0: enabled
+            if ((*(const uint32_t *)(e + 4) & 1) && g_cpu_count < MAX_CPUS) {
+                g_cpu_apic_ids[g_cpu_count++] = e[3];
+            }
+            break;
+        case MADT_IO_APIC:
+            if (g_ioapic_count < APIC_MAX_IOAPICS) {
+                ioapic_t *io = &g_ioapics[g_ioapic_count];
+                io->regs = (volatile uint32_t *)(uintptr_t)*(const uint32_t *)(e + 4);
+                io->gsi_base = *(const uint32_t *)(e + 8);
+                g_ioapic_count++;
+            }
+            break;
+        case MADT_ISO:
+            // Bus 0 (ISA) source -> GSI, MPS INTI flags
+            if (e[2] == 0 && e[3] < 16) {
+                uint16_t flags = *(const uint16_t *)(e + 8);
+                apic_isa_route_t *r = &g_isa_routes[e[3]];
+                r->gsi = *(const uint32_t *)(e + 4);
+                r->active_low = (flags & 0x3) == 0x3;
+                r->level = ((flags >> 2) & 0x3) == 0x3;
+            }
+            break;
+        case MADT_LAPIC_ADDR:
+            *lapic_phys = (uintptr_t)*(const uint64_t *)(e + 4);
+            break;
+        default:
+            break;
+        }
+        off += len;
+    }
+    kfree(madt);
+}
+
+error_t apic_init(const void *rsdp) {
+    if (g_apic_ready) return E_SUCCESS;
+
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(1, &eax, &ebx, &ecx, &edx);
+    if (!(edx & CPUID_FEAT_EDX_APIC)) return E_NOTSUP;
+
+    for (uint8_t irq = 0; irq < 16; irq++) {
+        g_isa_routes[irq].gsi = irq;
+    }
+
+    uintptr_t lapic_phys = 0;
+    uintptr_t madt = find_madt(rsdp);
+    if (madt) {
+        parse_madt(madt, &lapic_phys);
+    } else {
+        LOGGER_WARN(LOG_MODULE, "No MADT; assuming one I/O APIC at %#x",
+                    APIC_DEFAULT_IOAPIC_PHYS);
+    }
+    if (!lapic_phys) {
+        lapic_phys = (uintptr_t)(rdmsr(MSR_IA32_APIC_BASE) & 0xFFFFF000u);
+    }
+    if (!lapic_phys) lapic_phys = APIC_DEFAULT_LAPIC_PHYS;
+    if (g_ioapic_count == 0) {
+        g_ioapics[0].regs = (volatile uint32_t *)(uintptr_t)APIC_DEFAULT_IOAPIC_PHYS;
+        g_ioapics[0].gsi_base = 0;
+        g_ioapic_count = 1;
+    }
+
+    // Slot 0 is the local APIC, slots 1.. the I/O APICs
+    g_lapic = map_mmio_page(0, lapic_phys);
+    if (!g_lapic) return E_NOMEM;
+    for (uint32_t i = 0; i < g_ioapic_count; i++) {
+        ioapic_t *io = &g_ioapics[i];
+        io->regs = map_mmio_page(1 + i, (uintptr_t)io->regs);
+        if (!io->regs) return E_NOMEM;
+        io->gsi_count = ((ioapic_read(io, 0x01) >> 16) & 0xFF) + 1;
+    }
+
+    if (g_cpu_count == 0) {
+        g_cpu_apic_ids[0] = (uint8_t)(lapic_read(LAPIC_REG_ID) >> 24);
+        g_cpu_count = 1;
+    }
+
+    // Make sure the APIC is not globally disabled in the base MSR
+    wrmsr(MSR_IA32_APIC_BASE, rdmsr(MSR_IA32_APIC_BASE) | APIC_BASE_ENABLE);
+
+    g_apic_ready = true;
+    LOGGER_INFO(LOG_MODULE, "LAPIC %#lx, %lu I/O APIC(s), %lu CPU(s)",
+                (unsigned long)lapic_phys, (unsigned long)g_ioapic_count, (unsigned long)g_cpu_count);
+    return E_SUCCESS;
+}
+
+bool apic_available(void) {
+    return g_apic_ready;
+}
+
+//============================================================================
+// Local APIC
+//============================================================================
+
+void lapic_enable(void) {
+    lapic_write(LAPIC_REG_TPR, 0);
+    lapic_write(LAPIC_REG_SVR, LAPIC_SVR_ENABLE | APIC_SPURIOUS_VECTOR);
+}
+
+uint8_t lapic_id(void) {
+    return (uint8_t)(lapic_read(LAPIC_REG_ID) >> 24);
+}
+
+uint8_t apic_cpu_to_lapic_id(uint32_t cpu) {
+    return cpu < g_cpu_count ? g_cpu_apic_ids[cpu] : 0xFF;
+}
+
+uint32_t apic_cpu_count(void) {
+    return g_cpu_count;
+}
+
+void lapic_eoi(void) {
+    lapic_write(LAPIC_REG_EOI, 0);
+}
+
+void lapic_send_ipi(uint8_t apic_id, uint8_t vector) {
+    while (lapic_read(LAPIC_REG_ICR_LOW) & LAPIC_ICR_PENDING) {
+        asm volatile("pause");
+    }
+    lapic_write(LAPIC_REG_ICR_HIGH, (uint32_t)apic_id << 24);
+    lapic_write(LAPIC_REG_ICR_LOW, vector);  // Fixed, physical, edge
+}
+
+const apic_isa_route_t *apic_isa_route(uint8_t irq) {
+    return irq < 16 ? &g_isa_routes[irq] : NULL;
+}
+
+//============================================================================
+// I/O APIC
+//============================================================================
+
+static ioapic_t *ioapic_for_gsi(uint32_t gsi, uint32_t *pin) {
+    for (uint32_t i = 0; i < g_ioapic_count; i++) {
+        ioapic_t *io = &g_ioapics[i];
+        if (gsi >= io->gsi_base && gsi < io->gsi_base + io->gsi_count) {
+            *pin = gsi - io->gsi_base;
+            return io;
+        }
+    }
+    return NULL;
+}
+
+error_t ioapic_set_entry(uint32_t gsi, uint8_t vector, uint8_t dest_apic_id,
+                         bool level, bool active_low, bool masked) {
+    uint32_t pin;
+    ioapic_t *io = ioapic_for_gsi(gsi, &pin);
+    if (!io) return E_NOTFOUND;
+
+    uint32_t low = vector;
+    if (level) low |= IOAPIC_REDIR_LEVEL;
+    if (active_low) low |= IOAPIC_REDIR_ACTIVE_LOW;
+    if (masked) low |= IOAPIC_REDIR_MASKED;
+
+    uintptr_t irq = spinlock_acquire_irqsave(&g_ioapic_lock);
+    // Mask first so the pin never fires with a half-written entry
+    ioapic_write(io, 0x10 + pin * 2, IOAPIC_REDIR_MASKED);
+    ioapic_write(io, 0x11 + pin * 2, (uint32_t)dest_apic_id << 24);
+    ioapic_write(io, 0x10 + pin * 2, low);
+    spinlock_release_irqrestore(&g_ioapic_lock, irq);
+    return E_SUCCESS;
+}
+
+error_t ioapic_set_masked(uint32_t gsi, bool masked) {
+    uint32_t pin;
+    ioapic_t *io = ioapic_for_gsi(gsi, &pin);
+    if (!io) return E_NOTFOUND;
+
+    uintptr_t irq = spinlock_acquire_irqsave(&g_ioapic_lock);
+    uint32_t low = ioapic_read(io, 0x10 + pin * 2);
+    low = masked ? (low | IOAPIC_REDIR_MASKED) : (low & ~IOAPIC_REDIR_MASKED);
+    ioapic_write(io, 0x10 + pin * 2, low);
+    spinlock_release_irqrestore(&g_ioapic_lock, irq);
+    return E_SUCCESS;
+}
+
+error_t ioapic_set_destination(uint32_t gsi, uint8_t dest_apic_id) {
+    uint32_t pin;
+    ioapic_t *io = ioapic_for_gsi(gsi, &pin);
+    if (!io) return E_NOTFOUND;
+
+    uintptr_t irq = spinlock_acquire_irqsave(&g_ioapic_lock);
+    ioapic_write(io, 0x11 + pin * 2, (uint32_t)dest_apic_id << 24);
+    spinlock_release_irqrestore(&g_ioapic_lock, irq);
+    return E_SUCCESS;
+}
+
+bool ioapic_is_masked(uint32_t gsi) {
+    uint32_t pin;
+    ioapic_t *io = ioapic_for_gsi(gsi, &pin);
+    if (!io) return true;
+
+    uintptr_t irq = spinlock_acquire_irqsave(&g_ioapic_lock);
+    bool masked = (ioapic_read(io, 0x10 + pin * 2) & IOAPIC_REDIR_MASKED) != 0;
+    spinlock_release_irqrestore(&g_ioapic_lock, irq);
+    return masked;
+}
@@ -6,11 +6,17 @@
  * by the page fault handler to determine if a fault during kernel execution
  * (specifically when accessing user memory) is expected and has a defined
  * recovery path.
+ *
+ * The table is sorted once at boot so lookups are a binary search, and
+ * entries describe address ranges so a single entry can cover a whole
+ * copy loop.
  */
 
  #include <kernel/cpu/exception_table.h>
  #include <kernel/lib/assert.h> // For KERNEL_ASSERT
  #include <kernel/core/debug.h>  // For DEBUG_PRINTK (optional)
+ #include <libc/stdbool.h>
+ #include <libc/stddef.h>
  
  // --- Debug Configuration ---
  #define DEBUG_EX_TABLE 0 // Set to 1 to enable exception table debug messages
@@ -22,11 +28,44 @@
  #endif
  
  
+ // Set once exception_table_init() has sorted the table.
+ static bool g_ex_table_sorted = false;
+ 
+ /**
+  * @brief Sorts the exception table in place by insn_start.
+  *
+  * Uses insertion sort: entries are emitted in link order, so each object's
+  * entries are already ascending and the table is close to sorted.
+  */
+ void exception_table_init(void) {
+     size_t count = (size_t)(__stop_ex_table - __start_ex_table);
+ 
+     for (size_t i = 1; i < count; ++i) {
+         exception_entry_t key = __start_ex_table[i];
+         size_t j = i;
+         while (j > 0 && __start_ex_table[j - 1].insn_start > key.insn_start) {
+             __start_ex_table[j] = __start_ex_table[j - 1];
+             --j;
+         }
+         __start_ex_table[j] = key;
+     }
+ 
+     for (size_t i = 0; i < count; ++i) {
+         KERNEL_ASSERT(__start_ex_table[i].insn_end > __start_ex_table[i].insn_start,
+                       "Exception table entry has empty range");
+         KERNEL_ASSERT(i == 0 || __start_ex_table[i - 1].insn_end <= __start_ex_table[i].insn_start,
+                       "Exception table entries overlap");
+     }
+ 
+     g_ex_table_sorted = true;
+     EXTABLE_DEBUG_PRINTK("Sorted %u exception table entries\n", (unsigned)count);
+ }
+ 
  /**
   * @brief Finds the fixup address corresponding to a faulting kernel instruction address.
   *
-  * Iterates through the exception table defined by the linker symbols
-  * `__start_ex_table` and `__stop_ex_table`.
+  * Binary-searches for the last entry whose insn_start <= fault_eip and checks
+  * that fault_eip falls inside its range.
   *
   * @param fault_eip The EIP where the kernel fault occurred. Must not be 0.
   * @return The corresponding fixup address if found, 0 otherwise.
@@ -37,17 +76,40 @@
      EXTABLE_DEBUG_PRINTK("Searching fixup for fault_eip=0x%x in table [0x%x - 0x%x)\n",
                           fault_eip, __start_ex_table, __stop_ex_table);
  
-     // Iterate through the table using the linker-defined symbols.
-     // The symbols refer to the start and end addresses of the array of entries.
-     for (exception_entry_t *entry = __start_ex_table; entry < __stop_ex_table; ++entry) {
-         if (entry->fault_addr == fault_eip) {
-             EXTABLE_DEBUG_PRINTK(" -> Found entry: fault=0x%x -> fixup=0x%x\n",
-                                  entry->fault_addr, entry->fixup_addr);
-             KERNEL_ASSERT(entry->fixup_addr != 0, "Exception table entry has NULL fixup address!");
-             return entry->fixup_addr; // Return the handler address
+     const exception_entry_t *found = NULL;
+ 
+     if (g_ex_table_sorted) {
+         size_t lo = 0;
+         size_t hi = (size_t)(__stop_ex_table - __start_ex_table);
+         while (lo < hi) {
+             size_t mid = lo + (hi - lo) / 2;
+             if (__start_ex_table[mid].insn_start <= fault_eip) {
+                 lo = mid + 1;
+             } else {
+                 hi = mid;
+             }
          }
+         // lo is the first entry starting after fault_eip; candidate is lo - 1
+         if (lo > 0 && fault_eip < __start_ex_table[lo - 1].insn_end) {
+             found = &__start_ex_table[lo - 1];
+         }
+     } else {
+         // Early boot, before exception_table_init(): linear scan
+         for (exception_entry_t *entry = __start_ex_table; entry < __stop_ex_table; ++entry) {
+             if (fault_eip >= entry->insn_start && fault_eip < entry->insn_end) {
+                 found = entry;
+                 break;
+             }
+         }
+     }
+ 
+     if (!found) {
+         EXTABLE_DEBUG_PRINTK(" -> Fixup not found.\n");
+         return 0; // Indicate faulting address not found in the table
      }
  
-     EXTABLE_DEBUG_PRINTK(" -> Fixup not found.\n");
-     return 0; // Indicate faulting address not found in the table
- }
\ No newline at end of file
+     EXTABLE_DEBUG_PRINTK(" -> Found entry: [0x%x-0x%x) -> fixup=0x%x\n",
+                          found->insn_start, found->insn_end, found->fixup_addr);
+     KERNEL_ASSERT(found->fixup_addr != 0, "Exception table entry has NULL fixup address!");
+     return found->fixup_addr; // Return the handler address
+ }
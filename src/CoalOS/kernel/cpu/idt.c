@@ -15,6 +15,10 @@
 #include <kernel/lib/assert.h>
 #include <kernel/drivers/display/terminal.h>
 #include <kernel/drivers/storage/block_device.h> // For ata_primary_irq_handler prototype
+#include <kernel/process/exit_to_user.h>
+#include <kernel/process/cputime.h>
+#include <kernel/hal/irq_hal.h>
+#include <kernel/cpu/apic.h>
 
 //============================================================================
 // Definitions and Constants
@@ -35,6 +39,7 @@
 static struct idt_entry idt_entries[IDT_ENTRIES] __attribute__((aligned(16)));
 static struct idt_ptr idtp;
 static interrupt_handler_info_t interrupt_c_handlers[IDT_ENTRIES];
+static volatile uint32_t interrupt_counts[IDT_ENTRIES]; // Dispatches per vector (/proc/interrupts)
 
 //============================================================================
 // External Assembly Routines (from isr_stubs.asm, irq_stubs.asm, syscall.asm)
@@ -47,11 +52,16 @@ extern void isr12(); extern void isr13(); /* ISR 14 in isr_pf.asm */ /* ISR 15 r
 extern void isr16(); extern void isr17(); extern void isr18(); extern void isr19();
 extern void isr14(); // Page Fault Handler (from isr_pf.asm)
 
-// Hardware IRQ Stubs (IRQ 0-15 -> Vectors 32-47)
+// Hardware IRQ Stubs (IRQ 0-31 -> Vectors 32-63; 16-31 only reachable via I/O APIC/MSI)
 extern void irq0();  extern void irq1();  extern void irq2();  extern void irq3();
 extern void irq4();  extern void irq5();  extern void irq6();  extern void irq7();
 extern void irq8();  extern void irq9();  extern void irq10(); extern void irq11();
 extern void irq12(); extern void irq13(); extern void irq14(); extern void irq15();
+extern void irq16(); extern void irq17(); extern void irq18(); extern void irq19();
+extern void irq20(); extern void irq21(); extern void irq22(); extern void irq23();
+extern void irq24(); extern void irq25(); extern void irq26(); extern void irq27();
+extern void irq28(); extern void irq29(); extern void irq30(); extern void irq31();
+extern void irq_spurious(); // Local APIC spurious vector: no EOI, just iret
 
 // Syscall Handler Stub
 extern void syscall_handler_asm();
@@ -79,35 +89,6 @@ static void pic_remap(void) {
     terminal_write("[IDT] PIC remapped.\n");
 }
 
-/**
- * @brief Sends End-Of-Interrupt (EOI) to the PIC(s) based on IRQ *vector*.
- * This should primarily be called by default_isr_handler for unhandled IRQs.
- * Specific IRQ handlers should call an EOI function that takes IRQ line number.
- */
-static void pic_send_eoi_vector(uint32_t vector) {
-    // Convert vector to IRQ line for slave check; this logic is slightly off
-    // if vector is not directly IRQ line + base.
-    // A better way for a generic EOI from vector:
-    // uint8_t irq_line;
-    // if (vector >= PIC2_START_VECTOR && vector < PIC2_START_VECTOR + 8) {
-    //     irq_line = vector - PIC2_START_VECTOR + 8; // IRQ line 8-15
-    // } else if (vector >= PIC1_START_VECTOR && vector < PIC1_START_VECTOR + 8) {
-    //     irq_line = vector - PIC1_START_VECTOR; // IRQ line 0-7
-    // } else {
-    //     return; // Not a PIC IRQ vector
-    // }
-    // Now use the irq_line with the standard EOI logic:
-    // if (irq_line >= 8) outb(PIC2_COMMAND, PIC_EOI);
-    // outb(PIC1_COMMAND, PIC_EOI);
-    // For simplicity here, retaining the original logic which is mostly correct for typical IRQ ranges:
-
-    if (vector >= PIC2_START_VECTOR && vector < (PIC2_START_VECTOR + 8)) { // Is it from Slave PIC (IRQ 8-15, Vectors 40-47)?
-        outb(PIC2_COMMAND, PIC_EOI); // Send EOI to Slave PIC
-    }
-    outb(PIC1_COMMAND, PIC_EOI); // Always send EOI to Master PIC for any IRQ 0-15
-}
-
-
 static void pic_unmask_required_irqs(void) {
     serial_write("[PIC] Unmasking required IRQs (IRQ0-Timer, IRQ1-Keyboard, IRQ2-Cascade, IRQ14-ATA)...\n");
     uint8_t mask1_current = inb(PIC1_DATA);
@@ -168,6 +149,16 @@ void register_int_handler(int vector, int_handler_t handler, void* data) {
     interrupt_c_handlers[vector].data    = data;
 }
 
+uint32_t idt_get_interrupt_count(int vector) {
+    if (vector < 0 || vector >= IDT_ENTRIES) return 0;
+    return interrupt_counts[vector];
+}
+
+bool idt_has_handler(int vector) {
+    if (vector < 0 || vector >= IDT_ENTRIES) return false;
+    return interrupt_c_handlers[vector].handler != NULL;
+}
+
 /**
  * @brief Default C handler for unhandled interrupts/exceptions.
  * Prints diagnostic information and halts the system.
@@ -205,9 +196,9 @@ void default_isr_handler(isr_frame_t* frame) {
                    (unsigned long)frame->esi, (unsigned long)frame->edi, (void*)frame->ebp);
 
     // *** MODIFIED: Send EOI here if it's an unhandled hardware IRQ ***
-    if (frame->int_no >= IRQ0_VECTOR && frame->int_no < (IRQ0_VECTOR + 16)) {
+    if (frame->int_no >= IRQ0_VECTOR && frame->int_no < (IRQ0_VECTOR + IRQ_HAL_MAX_IRQS)) {
         serial_write(" [Default ISR] Unhandled IRQ, sending EOI before panic.\n");
-        pic_send_eoi_vector(frame->int_no); // Use the vector-based EOI sender
+        irq_hal_eoi((uint8_t)(frame->int_no - IRQ0_VECTOR)); // PIC or LAPIC, whichever is active
     }
 
     terminal_write(" System Halted.\n");
@@ -232,7 +223,12 @@ void isr_common_handler(isr_frame_t* frame) {
     }
 
     interrupt_handler_info_t* entry = &interrupt_c_handlers[vector];
+    interrupt_counts[vector]++;
 
+    if ((frame->cs & 3) == 3) {
+        cputime_user_exit();
+    }
+    irq_enter();
     if (entry->handler != NULL) {
         entry->handler(frame); // The specific handler (e.g., pit_irq_handler) is responsible for EOI
     } else {
@@ -243,6 +239,10 @@ void isr_common_handler(isr_frame_t* frame) {
     // EOI is no longer sent here from the common stub if a specific C handler was called.
     // It's the responsibility of the specific handler (e.g., pit_irq_handler, keyboard_irq1_handler)
     // or default_isr_handler (for unhandled IRQs).
+
+    // Handlers only flag work; preemption and signal delivery happen here,
+    // after EOI and outside HARDIRQ context.
+    irq_exit(frame);
 }
 
 
@@ -279,14 +279,17 @@ void idt_init(void) {
     idt_set_gate_internal(18, (uint32_t)isr18, KERNEL_CS_SELECTOR, IDT_FLAG_INTERRUPT_GATE);
     idt_set_gate_internal(19, (uint32_t)isr19, KERNEL_CS_SELECTOR, IDT_FLAG_INTERRUPT_GATE);
 
-    terminal_write("[IDT] Registering Hardware Interrupt handlers (IRQs -> Vectors 32-47)...\n");
-    void (*irq_stub_table[])() = {
+    terminal_write("[IDT] Registering Hardware Interrupt handlers (IRQs -> Vectors 32-63)...\n");
+    void (*irq_stub_table[IRQ_HAL_MAX_IRQS])() = {
         irq0, irq1, irq2, irq3, irq4, irq5, irq6, irq7,
-        irq8, irq9, irq10, irq11, irq12, irq13, irq14, irq15
+        irq8, irq9, irq10, irq11, irq12, irq13, irq14, irq15,
+        irq16, irq17, irq18, irq19, irq20, irq21, irq22, irq23,
+        irq24, irq25, irq26, irq27, irq28, irq29, irq30, irq31
     };
-    for (int i = 0; i < 16; ++i) {
+    for (int i = 0; i < IRQ_HAL_MAX_IRQS; ++i) {
         idt_set_gate_internal(IRQ0_VECTOR + i, (uint32_t)irq_stub_table[i], KERNEL_CS_SELECTOR, IDT_FLAG_INTERRUPT_GATE);
     }
+    idt_set_gate_internal(APIC_SPURIOUS_VECTOR, (uint32_t)irq_spurious, KERNEL_CS_SELECTOR, IDT_FLAG_INTERRUPT_GATE);
 
     terminal_write("[IDT] Registering System Call handler...\n");
     idt_set_gate_internal(SYSCALL_VECTOR, (uint32_t)syscall_handler_asm, KERNEL_CS_SELECTOR, IDT_FLAG_SYSCALL_GATE);
@@ -30,14 +30,19 @@ extern  isr_common_handler      ; void isr_common_handler(isr_frame_t*)
 KERNEL_DS       equ     0x10            ; must match your GDT data‑segment
 IRQ_BASE_VEC    equ     32              ; PIC remap base (0x20)
 
+; IRQ 0-15 are the ISA lines, 16-23 the remaining IOAPIC pins (PCI INTx)
+; and 24-31 MSI vectors. All of them map to vector IRQ_BASE_VEC + irq.
+IRQ_STUB_COUNT  equ     32
+
 ; --------------------------------------------------------------------------
 ; Public IRQ labels (used by idt.c)
 ; --------------------------------------------------------------------------
 %assign i 0
-%rep 16
+%rep IRQ_STUB_COUNT
     global  irq %+ i
 %assign i i+1
 %endrep
+    global  irq_spurious
 
 ; --------------------------------------------------------------------------
 ; Helper macro for general IRQs (excluding IRQ1 which has a special stub)
@@ -64,13 +69,17 @@ irq1:
     push    dword IRQ_BASE_VEC+1    ; vector number for IRQ1 (33)
     jmp     irq_common_stub
 
-; --- IRQ2‑IRQ15 ---
+; --- IRQ2‑IRQ31 ---
 %assign i 2
-%rep 14                             ; IRQs 2 through 15
+%rep IRQ_STUB_COUNT - 2             ; IRQs 2 through 31
     DECL_IRQ_GENERAL i
 %assign i i+1
 %endrep
 
+; --- Local APIC spurious vector: no handler and, per the SDM, no EOI ---
+irq_spurious:
+    iret
+
 ; --------------------------------------------------------------------------
 ; Common stub for IRQs – builds stack frame & jumps to C
 ; --------------------------------------------------------------------------
@@ -15,6 +15,7 @@ global isr14                    ; exposed to IDT setup
 ; External C function references
 extern page_fault_handler       ; void page_fault_handler(isr_frame_t *frame)
 extern find_exception_fixup     ; uint32_t find_exception_fixup(uint32_t fault_eip)
+extern page_fault_resolve_uaccess ; int page_fault_resolve_uaccess(isr_frame_t *frame)
 extern invoke_kernel_panic_from_isr ; void invoke_kernel_panic_from_isr(void)
 extern serial_putc_asm          ; For debug prints
 
@@ -68,6 +69,18 @@ isr14:
     hlt                     ; Halt if it somehow returns
 
 .handle_kernel_fixup:
+    ; The fault came from a user copy routine. access_ok only range-checks,
+    ; so first try to demand-page / COW the user page against its VMA.
+    push eax                ; Preserve fixup_addr
+    lea  ecx, [esp + 4]     ; ECX = pointer to the stack frame
+    push ecx
+    call page_fault_resolve_uaccess
+    add  esp, 4
+    mov  ecx, eax           ; ECX = resolved?
+    pop  eax                ; Restore fixup_addr
+    test ecx, ecx
+    jnz  .restore_and_return_pf ; Resolved: retry the faulting instruction
+
     ; EAX contains the fixup_addr. We need to set the EIP in the saved stack frame.
     ; EIP is at [ESP + 56]
     mov [esp + 56], eax     ; Set saved EIP on stack to the fixup_addr
@@ -1,14 +1,15 @@
 ; -----------------------------------------------------------------------------
-; syscall.asm -- INT 0x80 Entry/Exit Stub for CoalOS (v6.1 - Reschedule Check)
-; Version: 6.1
+; syscall.asm -- INT 0x80 Entry/Exit Stub for CoalOS (v6.2 - Exit Work Loop)
+; Version: 6.2
 ; Author: Tor Martin Kohle
 ; Purpose:
 ;   Provides the low-level assembly interface for system calls initiated via
 ;   the INT 0x80 software interrupt. It constructs the C-callable stack frame
 ;   (isr_frame_t), switches to kernel segments, dispatches to the C handler
-;   (syscall_dispatcher), checks if a reschedule is needed, potentially calls
-;   the scheduler, and correctly restores user-space context, ensuring
-;   the syscall return value (in EAX) is preserved for the user process.
+;   (syscall_dispatcher), runs the exit-to-user work loop (reschedule,
+;   signal delivery, task work) and correctly restores user-space context,
+;   ensuring the syscall return value (in EAX) is preserved for the user
+;   process (unless a signal handler frame replaced it).
 ;
 ; Stack Frame upon entry to C handler (syscall_dispatcher):
 ;   [ESP      ] -> &isr_frame_t (argument for C handler)
@@ -45,8 +46,7 @@
 ; %define USER_DATA_SELECTOR   0x23
 
     extern syscall_dispatcher     ; C-level syscall handler
-    extern schedule             ; <<< ADDED: External C scheduler function
-    extern g_need_reschedule    ; <<< ADDED: External C reschedule flag variable (volatile bool -> byte)
+    extern exit_to_user_mode      ; void exit_to_user_mode(isr_frame_t*)
     ; extern serial_putc_asm        ; Optional: for ultra-low-level debug
     ; extern serial_print_hex_asm   ; Optional: for ultra-low-level debug
 
@@ -87,18 +87,13 @@ syscall_handler_asm:
     ; --- 6. Store Syscall Return Value into the Stack Frame ---
     mov [esp + 28], eax     ; Write return value into the EAX slot of the PUSHA frame
 
-    ; --- *** 7. CHECK RESCHEDULE FLAG (Interrupts are still OFF from int 0x80) *** ---
-check_reschedule:
-    ; Access the global C variable (byte for bool)
-    mov al, byte [g_need_reschedule]
-    test al, al                      ; Check if the flag is non-zero
-    jz .no_reschedule_needed         ; If zero, skip the schedule call
-
-    ; Reschedule is needed:
-    mov byte [g_need_reschedule], 0  ; Clear the flag (no lock needed, IF=0)
-    call schedule                    ; Call the C scheduler function. It handles context switch.
+    ; --- 7. Exit Work (Interrupts are still OFF from int 0x80) ---
+    ; May switch tasks or rewrite the frame to enter a signal handler.
+    mov eax, esp            ; EAX = pointer to the on-stack isr_frame_t
+    push eax
+    call exit_to_user_mode
+    add  esp, 4
 
-.no_reschedule_needed:
     ; --- 8. Restore Registers and Segments ---
     popa                    ; Restores EDI, ESI, EBP, ESP_dummy, EBX, EDX, ECX, EAX (with syscall result)
     pop gs
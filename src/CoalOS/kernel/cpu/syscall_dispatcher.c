@@ -16,9 +16,11 @@
 #include "syscall_fileio.h"
 #include "syscall_utils.h"
 #include "syscall_process.h"
+#include "syscall_timer.h"
 #include <kernel/cpu/syscall.h>
 #include <kernel/cpu/syscall_linux.h>
 #include <kernel/process/process.h>
+#include <kernel/process/cputime.h>
 #include <kernel/lib/assert.h>
 #include <kernel/drivers/display/serial.h>
 #include <kernel/fs/vfs/fs_errno.h>
@@ -43,6 +45,7 @@ extern int32_t sys_getppid_impl(uint32_t arg1, uint32_t arg2, uint32_t arg3, isr
 // Terminal operations  
 extern int32_t sys_puts_impl(uint32_t user_str_ptr, uint32_t arg2, uint32_t arg3, isr_frame_t *regs);
 extern int32_t sys_read_terminal_line_impl(uint32_t user_buf_ptr, uint32_t count, uint32_t arg3, isr_frame_t *regs);
+extern int32_t sys_ioctl_impl(uint32_t fd, uint32_t cmd, uint32_t arg, isr_frame_t *regs);
 
 // Pipe operations
 extern int32_t sys_pipe_impl(uint32_t user_pipefd_ptr, uint32_t arg2, uint32_t arg3, isr_frame_t *regs);
@@ -50,6 +53,7 @@ extern int32_t sys_pipe_impl(uint32_t user_pipefd_ptr, uint32_t arg2, uint32_t a
 // Signal handling
 extern int32_t sys_signal_impl(uint32_t signum, uint32_t user_handler_ptr, uint32_t arg3, isr_frame_t *regs);
 extern int32_t sys_kill_impl(uint32_t pid, uint32_t sig, uint32_t arg3, isr_frame_t *regs);
+extern int32_t sys_sigreturn_impl(uint32_t arg1, uint32_t arg2, uint32_t arg3, isr_frame_t *regs);
 
 // File system operations
 extern int32_t sys_chdir_impl(uint32_t user_path_ptr, uint32_t arg2, uint32_t arg3, isr_frame_t *regs);
@@ -77,7 +81,7 @@ extern int32_t sys_mmap_impl(uint32_t addr, uint32_t length, uint32_t prot, isr_
 // Linux compatibility
 extern void init_linux_syscall_table(void);
 extern int linux_syscall_dispatcher(uint32_t syscall_num, uint32_t arg1, uint32_t arg2, 
-                                    uint32_t arg3, uint32_t arg4, uint32_t arg5);
+                                    uint32_t arg3, uint32_t arg4, uint32_t arg5, uint32_t arg6);
 
 //============================================================================
 // Default Handler Implementation
@@ -112,6 +116,7 @@ void syscall_init(void)
     syscall_table[SYS_CLOSE]  = sys_close_impl;
     syscall_table[SYS_LSEEK]  = sys_lseek_impl;
     syscall_table[SYS_DUP2]   = sys_dup2_impl;
+    syscall_table[SYS_IOCTL]  = sys_ioctl_impl;
     
     // Register process management syscalls (will be in separate modules)
     syscall_table[SYS_EXIT]   = sys_exit_impl;
@@ -131,12 +136,21 @@ void syscall_init(void)
     // Register signal syscalls (will be in separate module)
     syscall_table[SYS_SIGNAL] = sys_signal_impl;
     syscall_table[SYS_KILL]   = sys_kill_impl;
+    syscall_table[SYS_SIGRETURN] = sys_sigreturn_impl;
+    
+    // Register timer syscalls (from syscall_timer module)
+    syscall_table[SYS_ALARM]     = sys_alarm_impl;
+    syscall_table[SYS_SETITIMER] = sys_setitimer_impl;
+    syscall_table[SYS_GETITIMER] = sys_getitimer_impl;
+    syscall_table[SYS_TIMES]     = sys_times_impl;
+    syscall_table[SYS_GETRUSAGE] = sys_getrusage_impl;
     
     // Register file system syscalls (will be in separate module)
     syscall_table[SYS_CHDIR]  = sys_chdir_impl;
     syscall_table[SYS_GETCWD] = sys_getcwd_impl;
     syscall_table[SYS_STAT]   = sys_stat_impl;
     syscall_table[SYS_GETDENTS] = sys_getdents_impl;
+    syscall_table[SYS_READDIR] = sys_readdir_impl;
     syscall_table[SYS_UNLINK] = sys_unlink_impl;
     syscall_table[SYS_MKDIR] = sys_mkdir_impl;
     syscall_table[SYS_RMDIR] = sys_rmdir_impl;
@@ -170,6 +184,11 @@ int32_t syscall_dispatcher(isr_frame_t *regs)
         return -EFAULT;
     }
 
+    // Close the user-time interval before any kernel work
+    if ((regs->cs & 3) == 3) {
+        cputime_user_exit();
+    }
+
     uint32_t syscall_num = regs->eax;
     uint32_t arg1_ebx    = regs->ebx;
     uint32_t arg2_ecx    = regs->ecx;
@@ -200,10 +219,12 @@ int32_t syscall_dispatcher(isr_frame_t *regs)
     }
 
     // Check if we're in Linux compatibility mode
-    if (linux_compat_mode && syscall_num < __NR_syscalls && syscall_num >= 100) {
+    // sigreturn rewrites the frame, which the Linux table does not receive
+    if (linux_compat_mode && syscall_num < __NR_syscalls && syscall_num >= 100 &&
+        syscall_num != SYS_SIGRETURN) {
         // Use Linux syscall dispatcher for syscalls >= 100
         ret_val = linux_syscall_dispatcher(syscall_num, arg1_ebx, arg2_ecx, 
-                                         arg3_edx, arg4_esi, arg5_edi);
+                                         arg3_edx, arg4_esi, arg5_edi, regs->ebp);
     } else if (syscall_num < MAX_SYSCALLS && syscall_table[syscall_num] != NULL) {
         // Use CoalOS native syscalls (including low-numbered ones)
         ret_val = syscall_table[syscall_num](arg1_ebx, arg2_ecx, arg3_edx, regs);
@@ -259,4 +280,4 @@ syscall_fn_t syscall_get_handler(uint32_t syscall_num)
     }
     
     return syscall_table[syscall_num];
-}
\ No newline at end of file
+}
@@ -15,16 +15,22 @@
 #include "syscall_fileio.h"
 #include "syscall_utils.h"
 #include "syscall_security.h"
+#include "syscall_socket.h"
+#include "af_unix.h"
 #include <kernel/process/process.h>
 #include <kernel/fs/vfs/sys_file.h>
 #include <kernel/memory/uaccess.h>
 #include <kernel/memory/kmalloc.h>
+#include <kernel/memory/mm.h>
 #include <kernel/drivers/display/terminal.h>
+#include <kernel/drivers/display/console_dev.h>
+#include <kernel/drivers/display/tty.h>
 #include <kernel/sync/spinlock.h>
 #include <kernel/lib/string.h>
 #include <kernel/lib/assert.h>
 #include <kernel/drivers/display/serial.h>
 #include <kernel/fs/vfs/fs_errno.h>
+#include <libc/limits.h>
 
 //============================================================================
 // Configuration
@@ -44,6 +50,13 @@
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 #endif
 
+#define FILEIO_IOV_MAX 1024   // Linux UIO_MAXIOV
+#define FILEIO_DIRECT_PAGES 32  // User pages pinned per O_DIRECT transfer
+
+#ifndef OFF_T_MAX
+#define OFF_T_MAX LONG_MAX
+#endif
+
 //============================================================================
 // Forward Declarations for External Functions
 //============================================================================
@@ -52,6 +65,335 @@ extern ssize_t pipe_read_operation(vnode_t *vnode, void *buffer, size_t count, o
 extern ssize_t pipe_write_operation(vnode_t *vnode, const void *buffer, size_t count, off_t offset);
 extern int pipe_close_operation(vnode_t *vnode, bool is_write_end);
 
+//============================================================================
+// Transfer Helpers
+//============================================================================
+
+// Returns the pipe vnode behind fd, or NULL if fd is not a pipe
+static vnode_t *fileio_pipe_vnode(int fd)
+{
+    pcb_t *current_process = get_current_process();
+    if (!current_process || fd < 0 || fd >= MAX_FD) return NULL;
+    sys_file_t *sf = current_process->fd_table[fd];
+    if (sf && sf->vfs_file && sf->vfs_file->vnode &&
+        sf->vfs_file->vnode->fs_driver == NULL && sf->vfs_file->vnode->data != NULL) {
+        return sf->vfs_file->vnode;
+    }
+    return NULL;
+}
+
+// True if fd is a socket
+static bool fileio_is_socket(int fd)
+{
+    pcb_t *current_process = get_current_process();
+    if (!current_process || fd < 0 || fd >= MAX_FD) return false;
+    sys_file_t *sf = current_process->fd_table[fd];
+    return sf && unix_is_socket(sf->vfs_file);
+}
+
+/*
+ * True if fd reads from the console tty. A task without a descriptor 0
+ * still reads stdin from the console, as before descriptor tables existed.
+ */
+static bool fileio_is_tty(int fd, bool *nonblock)
+{
+    pcb_t *current_process = get_current_process();
+    if (nonblock) *nonblock = false;
+    if (!current_process || fd < 0 || fd >= MAX_FD) return false;
+    sys_file_t *sf = current_process->fd_table[fd];
+    if (!sf) return fd == STDIN_FILENO;
+    if (!console_is_tty(sf->vfs_file)) return false;
+    if (nonblock) *nonblock = (sf->vfs_file->flags & O_NONBLOCK) != 0;
+    return true;
+}
+
+// Terminal, pipe and socket descriptors have no file position
+static bool fileio_is_stream(int fd)
+{
+    return fd == STDIN_FILENO || fd == STDOUT_FILENO || fd == STDERR_FILENO ||
+           fileio_is_tty(fd, NULL) || fileio_pipe_vnode(fd) != NULL || fileio_is_socket(fd);
+}
+
+/*
+ * Socket transfer: the socket layer copies straight between the user
+ * buffers and its queues, without a bounce buffer or the VFS file lock
+ * (a socket may sleep for data or buffer space). Drops sock's reference.
+ */
+static ssize_t fileio_socket_iov(bool write, file_t *sock, const k_iovec_t *iov, uint32_t iovcnt)
+{
+    ssize_t res = write ? unix_sendmsg(sock, iov, iovcnt, NULL, 0, NULL, 0)
+                        : unix_recvmsg(sock, iov, iovcnt, NULL, NULL, NULL, NULL, 0);
+    vfs_close(sock);
+    return res;
+}
+
+// Regular files opened with O_DIRECT skip the bounce buffer
+static bool fileio_is_direct(int fd)
+{
+    pcb_t *current_process = get_current_process();
+    if (!current_process || fd < 0 || fd >= MAX_FD) return false;
+    sys_file_t *sf = current_process->fd_table[fd];
+    return sf && sf->vfs_file && sf->vfs_file->vnode && sf->vfs_file->vnode->fs_driver &&
+           (sf->vfs_file->flags & O_DIRECT);
+}
+
+/*
+ * O_DIRECT transfer: the user buffer is pinned a window at a time and handed
+ * to the file system as is, which moves aligned sectors between the disk
+ * and those pages without a kernel copy. pos < 0 uses the file offset.
+ */
+static ssize_t fileio_direct_user(bool write, int fd, uintptr_t user_buf, size_t count, off_t pos)
+{
+    pcb_t *current_process = get_current_process();
+    if (!current_process || !current_process->mm) return -EFAULT;
+
+    uintptr_t frames[FILEIO_DIRECT_PAGES];
+    ssize_t total = 0;
+    while ((size_t)total < count) {
+        uintptr_t addr = user_buf + (size_t)total;
+        size_t chunk = MIN(count - (size_t)total, FILEIO_DIRECT_PAGES * PAGE_SIZE - (addr & (PAGE_SIZE - 1)));
+
+        // Destination pages of a read must be writable
+        int pinned = mm_pin_user_pages(current_process->mm, addr, chunk, !write, frames, FILEIO_DIRECT_PAGES);
+        if (pinned < 0) return total > 0 ? total : -EFAULT;
+
+        ssize_t res;
+        if (write) {
+            res = pos < 0 ? sys_write(fd, (const void *)addr, chunk)
+                          : sys_pwrite(fd, (const void *)addr, chunk, pos + total);
+        } else {
+            res = pos < 0 ? sys_read(fd, (void *)addr, chunk)
+                          : sys_pread(fd, (void *)addr, chunk, pos + total);
+        }
+        mm_unpin_user_pages(frames, (size_t)pinned);
+
+        if (res < 0) return total > 0 ? total : res;
+        total += res;
+        if ((size_t)res < chunk) break;
+    }
+    return total;
+}
+
+static ssize_t fileio_read_chunk(int fd, char *kbuf, size_t len)
+{
+    // Console input goes through the tty line discipline, outside the VFS
+    // file lock since it may sleep. It returns what is ready (at most a
+    // line, or less than a chunk), which ends fileio_read_user()'s loop.
+    bool nonblock;
+    if (fileio_is_tty(fd, &nonblock)) return tty_read(kbuf, len, nonblock);
+    vnode_t *pipe = fileio_pipe_vnode(fd);
+    if (pipe) return pipe_read_operation(pipe, kbuf, len, 0);
+    file_t *sock = socket_file_get(fd);
+    if (sock) {
+        ssize_t res = unix_read_kernel(sock, kbuf, len, 0);
+        vfs_close(sock);
+        return res;
+    }
+    // Regular file, or an invalid fd for which the VFS path returns the error
+    return sys_read(fd, kbuf, len);
+}
+
+static ssize_t fileio_write_chunk(int fd, const char *kbuf, size_t len)
+{
+    // Special case for stdout/stderr - delegate to terminal module
+    if (fd == STDOUT_FILENO || fd == STDERR_FILENO) {
+        terminal_write_bytes(kbuf, len);
+        return (ssize_t)len;
+    }
+    vnode_t *pipe = fileio_pipe_vnode(fd);
+    if (pipe) return pipe_write_operation(pipe, kbuf, len, 0);
+    file_t *sock = socket_file_get(fd);
+    if (sock) {
+        ssize_t res = unix_write_kernel(sock, kbuf, len, 0);
+        vfs_close(sock);
+        return res;
+    }
+    return sys_write(fd, kbuf, len);
+}
+
+/*
+ * Reads up to count bytes from fd into user memory, staging through kbuf.
+ * pos < 0 reads at the file offset; otherwise the read is positional and
+ * the offset is left alone.
+ */
+static ssize_t fileio_read_user(int fd, userptr_t user_buf, size_t count,
+                                char *kbuf, size_t kbuf_size, off_t pos)
+{
+    ssize_t total_read = 0;
+    while (total_read < (ssize_t)count) {
+        size_t current_chunk_size = MIN(kbuf_size, count - (size_t)total_read);
+        KERNEL_ASSERT(current_chunk_size > 0, "Read chunk size zero");
+
+        ssize_t bytes_read_this_chunk = pos < 0
+            ? fileio_read_chunk(fd, kbuf, current_chunk_size)
+            : sys_pread(fd, kbuf, current_chunk_size, pos + total_read);
+
+        if (bytes_read_this_chunk < 0) {
+            return total_read > 0 ? total_read : bytes_read_this_chunk;
+        }
+        if (bytes_read_this_chunk == 0) break;
+
+        if (copy_to_user((userptr_t)((char*)user_buf + total_read),
+                        (const_kernelptr_t)kbuf, (size_t)bytes_read_this_chunk) != 0) {
+            return total_read > 0 ? total_read : -EFAULT;
+        }
+        total_read += bytes_read_this_chunk;
+        if ((size_t)bytes_read_this_chunk < current_chunk_size) break;
+    }
+    return total_read;
+}
+
+// Write counterpart of fileio_read_user
+static ssize_t fileio_write_user(int fd, const_userptr_t user_buf, size_t count,
+                                 char *kbuf, size_t kbuf_size, off_t pos)
+{
+    ssize_t total_written = 0;
+    while (total_written < (ssize_t)count) {
+        size_t current_chunk_size = MIN(kbuf_size, count - (size_t)total_written);
+        KERNEL_ASSERT(current_chunk_size > 0, "Write chunk size zero");
+
+        size_t not_copied_from_user = copy_from_user((kernelptr_t)kbuf,
+                                                   (const_userptr_t)((const char*)user_buf + total_written),
+                                                   current_chunk_size);
+        size_t copied_this_chunk_from_user = current_chunk_size - not_copied_from_user;
+
+        if (copied_this_chunk_from_user > 0) {
+            ssize_t bytes_written_this_chunk = pos < 0
+                ? fileio_write_chunk(fd, kbuf, copied_this_chunk_from_user)
+                : sys_pwrite(fd, kbuf, copied_this_chunk_from_user, pos + total_written);
+
+            if (bytes_written_this_chunk < 0) {
+                return total_written > 0 ? total_written : bytes_written_this_chunk;
+            }
+            total_written += bytes_written_this_chunk;
+            if ((size_t)bytes_written_this_chunk < copied_this_chunk_from_user) break;
+        }
+
+        if (not_copied_from_user > 0) {
+            return total_written > 0 ? total_written : -EFAULT;
+        }
+    }
+    return total_written;
+}
+
+/*
+ * Vectored transfer: every iovec goes through the same bounce buffer, sized
+ * for the largest segment, so one allocation serves the whole call.
+ */
+static ssize_t fileio_rw_vec(bool write, int fd, uint32_t user_iov_ptr, uint32_t iovcnt, off_t pos)
+{
+    if (iovcnt == 0) return 0;
+    if (iovcnt > FILEIO_IOV_MAX) return -EINVAL;
+
+    // First pass validates every segment and sizes the buffer
+    size_t total_len = 0;
+    size_t largest = 0;
+    for (uint32_t i = 0; i < iovcnt; i++) {
+        k_iovec_t iov;
+        if (copy_from_user((kernelptr_t)&iov,
+                           (const_userptr_t)(uintptr_t)(user_iov_ptr + i * sizeof(iov)), sizeof(iov)) != 0) {
+            return -EFAULT;
+        }
+        if ((ssize_t)iov.iov_len < 0 || total_len + iov.iov_len > (size_t)INT32_MAX) return -EINVAL;
+        if (iov.iov_len > 0 && !syscall_validate_buffer((userptr_t)(uintptr_t)iov.iov_base, iov.iov_len, !write)) {
+            return -EFAULT;
+        }
+        total_len += iov.iov_len;
+        if (iov.iov_len > largest) largest = iov.iov_len;
+    }
+    if (total_len == 0) return 0;
+
+    file_t *sock = socket_file_get(fd);
+    if (sock) {
+        k_iovec_t *kiov = kmalloc(iovcnt * sizeof(k_iovec_t));
+        if (!kiov) {
+            vfs_close(sock);
+            return -ENOMEM;
+        }
+        if (copy_from_user((kernelptr_t)kiov, (const_userptr_t)(uintptr_t)user_iov_ptr,
+                           iovcnt * sizeof(k_iovec_t)) != 0) {
+            kfree(kiov);
+            vfs_close(sock);
+            return -EFAULT;
+        }
+        ssize_t res = fileio_socket_iov(write, sock, kiov, iovcnt);
+        kfree(kiov);
+        return res;
+    }
+
+    bool direct = fileio_is_direct(fd);
+    size_t kbuf_size = MIN(MAX_RW_CHUNK_SIZE, largest);
+    char *kbuf = direct ? NULL : kmalloc(kbuf_size);
+    if (!direct && !kbuf) return -ENOMEM;
+
+    ssize_t total = 0;
+    for (uint32_t i = 0; i < iovcnt; i++) {
+        k_iovec_t iov;
+        if (copy_from_user((kernelptr_t)&iov,
+                           (const_userptr_t)(uintptr_t)(user_iov_ptr + i * sizeof(iov)), sizeof(iov)) != 0) {
+            if (total == 0) total = -EFAULT;
+            break;
+        }
+        if (iov.iov_len == 0) continue;
+
+        off_t seg_pos = pos < 0 ? -1 : pos + total;
+        ssize_t res;
+        if (direct) {
+            res = fileio_direct_user(write, fd, iov.iov_base, iov.iov_len, seg_pos);
+        } else if (write) {
+            res = fileio_write_user(fd, (const_userptr_t)(uintptr_t)iov.iov_base, iov.iov_len, kbuf, kbuf_size, seg_pos);
+        } else {
+            res = fileio_read_user(fd, (userptr_t)(uintptr_t)iov.iov_base, iov.iov_len, kbuf, kbuf_size, seg_pos);
+        }
+        if (res < 0) {
+            if (total == 0) total = res;
+            break;
+        }
+        total += res;
+        if ((size_t)res < iov.iov_len) break;
+    }
+
+    if (kbuf) kfree(kbuf);
+    return total;
+}
+
+/*
+ * In-kernel copy between descriptors through one bounce buffer; the data
+ * never crosses into user space. in_fd is read at *in_pos, out_fd written
+ * at *out_pos or, when out_pos is NULL, at its own offset. Positions advance
+ * by the bytes actually written.
+ */
+static ssize_t fileio_copy(int in_fd, off_t *in_pos, int out_fd, off_t *out_pos, size_t count)
+{
+    if (count == 0) return 0;
+    size_t kbuf_size = MIN(MAX_RW_CHUNK_SIZE, count);
+    char *kbuf = kmalloc(kbuf_size);
+    if (!kbuf) return -ENOMEM;
+
+    ssize_t total = 0;
+    while ((size_t)total < count) {
+        size_t chunk = MIN(kbuf_size, count - (size_t)total);
+        ssize_t got = sys_pread(in_fd, kbuf, chunk, *in_pos);
+        if (got <= 0) {
+            if (total == 0) total = got;
+            break;
+        }
+        ssize_t put = out_pos ? sys_pwrite(out_fd, kbuf, (size_t)got, *out_pos)
+                              : fileio_write_chunk(out_fd, kbuf, (size_t)got);
+        if (put < 0) {
+            if (total == 0) total = put;
+            break;
+        }
+        *in_pos += put;
+        if (out_pos) *out_pos += put;
+        total += put;
+        if (put < got || (size_t)got < chunk) break;
+    }
+
+    kfree(kbuf);
+    return total;
+}
+
 //============================================================================
 // File I/O System Call Implementation
 //============================================================================
@@ -62,8 +404,6 @@ int32_t sys_read_impl(uint32_t fd_arg, uint32_t user_buf_ptr, uint32_t count_arg
     int fd = (int)fd_arg;
     userptr_t user_buf = (userptr_t)user_buf_ptr;
     size_t count = (size_t)count_arg;
-    ssize_t total_read = 0;
-    char* kbuf = NULL;
 
     if ((ssize_t)count < 0) return -EINVAL;
     if (count == 0) return 0;
@@ -75,57 +415,19 @@ int32_t sys_read_impl(uint32_t fd_arg, uint32_t user_buf_ptr, uint32_t count_arg
         return -EFAULT;
     }
 
+    file_t *sock = socket_file_get(fd);
+    if (sock) {
+        k_iovec_t iov = { user_buf_ptr, (uint32_t)count };
+        return fileio_socket_iov(false, sock, &iov, 1);
+    }
+    if (fileio_is_direct(fd)) return fileio_direct_user(false, fd, user_buf_ptr, count, -1);
+
     size_t chunk_alloc_size = MIN(MAX_RW_CHUNK_SIZE, count);
-    kbuf = kmalloc(chunk_alloc_size);
+    char *kbuf = kmalloc(chunk_alloc_size);
     if (!kbuf) return -ENOMEM;
 
-    while (total_read < (ssize_t)count) {
-        size_t current_chunk_size = MIN(chunk_alloc_size, count - (size_t)total_read);
-        KERNEL_ASSERT(current_chunk_size > 0, "Read chunk size zero");
-
-        ssize_t bytes_read_this_chunk;
-        
-        // Special case for STDIN_FILENO - delegate to terminal module
-        if (fd == STDIN_FILENO) {
-            bytes_read_this_chunk = terminal_read_line_blocking(kbuf, current_chunk_size);
-        }
-        // Check if this is a pipe file descriptor
-        else {
-            pcb_t *current_process = get_current_process();
-            if (current_process && fd >= 0 && fd < MAX_FD && current_process->fd_table[fd]) {
-                sys_file_t *sf = current_process->fd_table[fd];
-                if (sf && sf->vfs_file && sf->vfs_file->vnode && 
-                    sf->vfs_file->vnode->fs_driver == NULL && sf->vfs_file->vnode->data != NULL) {
-                    // This is a pipe - delegate to pipe module
-                    bytes_read_this_chunk = pipe_read_operation(sf->vfs_file->vnode, kbuf, current_chunk_size, 0);
-                } else {
-                    // Regular file - use VFS layer
-                    bytes_read_this_chunk = sys_read(fd, kbuf, current_chunk_size);
-                }
-            } else {
-                // Invalid fd or process - use existing VFS path which will return appropriate error
-                bytes_read_this_chunk = sys_read(fd, kbuf, current_chunk_size);
-            }
-        }
-
-        if (bytes_read_this_chunk < 0) {
-            if (total_read > 0) break;
-            total_read = bytes_read_this_chunk;
-            break;
-        }
-        if (bytes_read_this_chunk == 0) break;
-
-        if (copy_to_user((userptr_t)((char*)user_buf + total_read), 
-                        (const_kernelptr_t)kbuf, (size_t)bytes_read_this_chunk) != 0) {
-            if (total_read > 0) break;
-            total_read = -EFAULT;
-            break;
-        }
-        total_read += bytes_read_this_chunk;
-        if ((size_t)bytes_read_this_chunk < current_chunk_size) break;
-    }
-    
-    if (kbuf) kfree(kbuf);
+    ssize_t total_read = fileio_read_user(fd, user_buf, count, kbuf, chunk_alloc_size, -1);
+    kfree(kbuf);
     return total_read;
 }
 
@@ -135,8 +437,6 @@ int32_t sys_write_impl(uint32_t fd_arg, uint32_t user_buf_ptr, uint32_t count_ar
     int fd = (int)fd_arg;
     const_userptr_t user_buf = (const_userptr_t)user_buf_ptr;
     size_t count = (size_t)count_arg;
-    ssize_t total_written = 0;
-    char* kbuf = NULL;
 
     if ((ssize_t)count < 0) return -EINVAL;
     if (count == 0) return 0;
@@ -148,68 +448,277 @@ int32_t sys_write_impl(uint32_t fd_arg, uint32_t user_buf_ptr, uint32_t count_ar
         return -EFAULT;
     }
 
+    file_t *sock = socket_file_get(fd);
+    if (sock) {
+        k_iovec_t iov = { user_buf_ptr, (uint32_t)count };
+        return fileio_socket_iov(true, sock, &iov, 1);
+    }
+    if (fileio_is_direct(fd)) return fileio_direct_user(true, fd, user_buf_ptr, count, -1);
+
     size_t chunk_alloc_size = MIN(MAX_RW_CHUNK_SIZE, count);
-    kbuf = kmalloc(chunk_alloc_size);
+    char *kbuf = kmalloc(chunk_alloc_size);
     if (!kbuf) return -ENOMEM;
 
-    while (total_written < (ssize_t)count) {
-        size_t current_chunk_size = MIN(chunk_alloc_size, count - (size_t)total_written);
-        KERNEL_ASSERT(current_chunk_size > 0, "Write chunk size zero");
+    ssize_t total_written = fileio_write_user(fd, user_buf, count, kbuf, chunk_alloc_size, -1);
+    kfree(kbuf);
+    return total_written;
+}
 
-        size_t not_copied_from_user = copy_from_user((kernelptr_t)kbuf, 
-                                                   (const_userptr_t)((const char*)user_buf + total_written), 
-                                                   current_chunk_size);
-        size_t copied_this_chunk_from_user = current_chunk_size - not_copied_from_user;
+int32_t sys_readv_impl(uint32_t fd, uint32_t user_iov_ptr, uint32_t iovcnt, isr_frame_t *regs)
+{
+    (void)regs;
+    return fileio_rw_vec(false, (int)fd, user_iov_ptr, iovcnt, -1);
+}
 
-        if (copied_this_chunk_from_user > 0) {
-            ssize_t bytes_written_this_chunk;
-            
-            // Special case for stdout/stderr - delegate to terminal module
-            if (fd == STDOUT_FILENO || fd == STDERR_FILENO) {
-                terminal_write_bytes(kbuf, copied_this_chunk_from_user);
-                bytes_written_this_chunk = copied_this_chunk_from_user;
-            } else {
-                // Check if this is a pipe file descriptor
-                pcb_t *current_process = get_current_process();
-                if (current_process && fd >= 0 && fd < MAX_FD && current_process->fd_table[fd]) {
-                    sys_file_t *sf = current_process->fd_table[fd];
-                    if (sf && sf->vfs_file && sf->vfs_file->vnode && 
-                        sf->vfs_file->vnode->fs_driver == NULL && sf->vfs_file->vnode->data != NULL) {
-                        // This is a pipe - delegate to pipe module
-                        bytes_written_this_chunk = pipe_write_operation(sf->vfs_file->vnode, kbuf, copied_this_chunk_from_user, 0);
-                    } else {
-                        // Regular file - use VFS layer
-                        bytes_written_this_chunk = sys_write(fd, kbuf, copied_this_chunk_from_user);
-                    }
-                } else {
-                    // Invalid fd or process - use existing VFS path which will return appropriate error
-                    bytes_written_this_chunk = sys_write(fd, kbuf, copied_this_chunk_from_user);
-                }
-            }
+int32_t sys_writev_impl(uint32_t fd, uint32_t user_iov_ptr, uint32_t iovcnt, isr_frame_t *regs)
+{
+    (void)regs;
+    return fileio_rw_vec(true, (int)fd, user_iov_ptr, iovcnt, -1);
+}
 
-            if (bytes_written_this_chunk < 0) {
-                if (total_written > 0) break;
-                total_written = bytes_written_this_chunk;
-                break;
+int32_t sys_pread64_impl(uint32_t fd_arg, uint32_t user_buf_ptr, uint32_t count_arg, uint64_t pos)
+{
+    int fd = (int)fd_arg;
+    size_t count = (size_t)count_arg;
+
+    if ((ssize_t)count < 0 || pos > (uint64_t)OFF_T_MAX) return -EINVAL;
+    if (fileio_is_stream(fd)) return -ESPIPE;
+    if (count == 0) return 0;
+    if (!syscall_validate_buffer((userptr_t)user_buf_ptr, count, true)) return -EFAULT;
+
+    if (fileio_is_direct(fd)) return fileio_direct_user(false, fd, user_buf_ptr, count, (off_t)pos);
+
+    size_t chunk_alloc_size = MIN(MAX_RW_CHUNK_SIZE, count);
+    char *kbuf = kmalloc(chunk_alloc_size);
+    if (!kbuf) return -ENOMEM;
+
+    ssize_t total_read = fileio_read_user(fd, (userptr_t)user_buf_ptr, count, kbuf, chunk_alloc_size, (off_t)pos);
+    kfree(kbuf);
+    return total_read;
+}
+
+int32_t sys_pwrite64_impl(uint32_t fd_arg, uint32_t user_buf_ptr, uint32_t count_arg, uint64_t pos)
+{
+    int fd = (int)fd_arg;
+    size_t count = (size_t)count_arg;
+
+    if ((ssize_t)count < 0 || pos > (uint64_t)OFF_T_MAX) return -EINVAL;
+    if (fileio_is_stream(fd)) return -ESPIPE;
+    if (count == 0) return 0;
+    if (!syscall_validate_buffer((userptr_t)user_buf_ptr, count, false)) return -EFAULT;
+
+    if (fileio_is_direct(fd)) return fileio_direct_user(true, fd, user_buf_ptr, count, (off_t)pos);
+
+    size_t chunk_alloc_size = MIN(MAX_RW_CHUNK_SIZE, count);
+    char *kbuf = kmalloc(chunk_alloc_size);
+    if (!kbuf) return -ENOMEM;
+
+    ssize_t total_written = fileio_write_user(fd, (const_userptr_t)user_buf_ptr, count, kbuf, chunk_alloc_size, (off_t)pos);
+    kfree(kbuf);
+    return total_written;
+}
+
+int32_t sys_preadv_impl(uint32_t fd, uint32_t user_iov_ptr, uint32_t iovcnt, uint64_t pos)
+{
+    if (pos > (uint64_t)OFF_T_MAX) return -EINVAL;
+    if (fileio_is_stream((int)fd)) return -ESPIPE;
+    return fileio_rw_vec(false, (int)fd, user_iov_ptr, iovcnt, (off_t)pos);
+}
+
+int32_t sys_pwritev_impl(uint32_t fd, uint32_t user_iov_ptr, uint32_t iovcnt, uint64_t pos)
+{
+    if (pos > (uint64_t)OFF_T_MAX) return -EINVAL;
+    if (fileio_is_stream((int)fd)) return -ESPIPE;
+    return fileio_rw_vec(true, (int)fd, user_iov_ptr, iovcnt, (off_t)pos);
+}
+
+int32_t sys_sendfile_impl(uint32_t out_fd, uint32_t in_fd, uint32_t user_offset_ptr, uint32_t count, bool offset64)
+{
+    if ((ssize_t)count < 0) return -EINVAL;
+    // The source must have a position to read from
+    if (fileio_is_stream((int)in_fd)) return -EINVAL;
+
+    off_t pos;
+    if (user_offset_ptr) {
+        int64_t user_pos = 0;
+        if (offset64) {
+            if (copy_from_user((kernelptr_t)&user_pos, (const_userptr_t)user_offset_ptr, sizeof(int64_t)) != 0) {
+                return -EFAULT;
             }
-            total_written += bytes_written_this_chunk;
-            if ((size_t)bytes_written_this_chunk < copied_this_chunk_from_user) break;
+        } else {
+            int32_t pos32;
+            if (copy_from_user((kernelptr_t)&pos32, (const_userptr_t)user_offset_ptr, sizeof(int32_t)) != 0) {
+                return -EFAULT;
+            }
+            user_pos = pos32;
         }
+        if (user_pos < 0 || user_pos > OFF_T_MAX) return -EINVAL;
+        pos = (off_t)user_pos;
+    } else {
+        pos = sys_lseek((int)in_fd, 0, SEEK_CUR);
+        if (pos < 0) return (int32_t)pos;
+    }
 
-        if (not_copied_from_user > 0) {
-             if (total_written > 0) break;
-             total_written = -EFAULT;
-             break;
+    ssize_t copied = fileio_copy((int)in_fd, &pos, (int)out_fd, NULL, count);
+
+    if (user_offset_ptr) {
+        // With an explicit offset the source position is left unchanged
+        int rc;
+        if (offset64) {
+            int64_t user_pos = pos;
+            rc = copy_to_user((userptr_t)user_offset_ptr, (const_kernelptr_t)&user_pos, sizeof(int64_t));
+        } else {
+            int32_t pos32 = (int32_t)pos;
+            rc = copy_to_user((userptr_t)user_offset_ptr, (const_kernelptr_t)&pos32, sizeof(int32_t));
         }
-        if (copied_this_chunk_from_user == 0 && not_copied_from_user == 0 && current_chunk_size > 0) {
-            if (total_written > 0) break;
-            total_written = -EFAULT;
-            break;
+        if (rc != 0 && copied >= 0) return -EFAULT;
+    } else if (copied > 0) {
+        sys_lseek((int)in_fd, pos, SEEK_SET);
+    }
+    return copied;
+}
+
+// Reads an optional loff_t position argument
+static int fileio_get_loff(uint32_t user_ptr, int fd, off_t *pos)
+{
+    if (!user_ptr) {
+        *pos = sys_lseek(fd, 0, SEEK_CUR);
+        return *pos < 0 ? (int)*pos : 0;
+    }
+    int64_t user_pos;
+    if (copy_from_user((kernelptr_t)&user_pos, (const_userptr_t)user_ptr, sizeof(user_pos)) != 0) return -EFAULT;
+    if (user_pos < 0 || user_pos > OFF_T_MAX) return -EINVAL;
+    *pos = (off_t)user_pos;
+    return 0;
+}
+
+// Stores a position back into an optional loff_t argument, or moves fd there
+static int fileio_put_loff(uint32_t user_ptr, int fd, off_t pos)
+{
+    if (!user_ptr) {
+        off_t res = sys_lseek(fd, pos, SEEK_SET);
+        return res < 0 ? (int)res : 0;
+    }
+    int64_t user_pos = pos;
+    if (copy_to_user((userptr_t)user_ptr, (const_kernelptr_t)&user_pos, sizeof(user_pos)) != 0) return -EFAULT;
+    return 0;
+}
+
+int32_t sys_copy_file_range_impl(uint32_t fd_in, uint32_t user_off_in, uint32_t fd_out, uint32_t user_off_out,
+                                 uint32_t len)
+{
+    if ((ssize_t)len < 0) return -EINVAL;
+    if (fileio_is_stream((int)fd_in) || fileio_is_stream((int)fd_out)) return -EINVAL;
+
+    off_t in_pos, out_pos;
+    int err = fileio_get_loff(user_off_in, (int)fd_in, &in_pos);
+    if (err == 0) err = fileio_get_loff(user_off_out, (int)fd_out, &out_pos);
+    if (err < 0) return err;
+
+    ssize_t copied = fileio_copy((int)fd_in, &in_pos, (int)fd_out, &out_pos, len);
+    if (copied > 0) {
+        err = fileio_put_loff(user_off_in, (int)fd_in, in_pos);
+        if (err == 0) err = fileio_put_loff(user_off_out, (int)fd_out, out_pos);
+        if (err < 0) return err;
+    }
+    return copied;
+}
+
+int32_t sys_fsync_impl(uint32_t fd, bool datasync)
+{
+    // Terminals and pipes have nothing to write back
+    if (fileio_is_stream((int)fd)) return -EINVAL;
+    return sys_fsync((int)fd, datasync);
+}
+
+int32_t sys_syncfs_impl(uint32_t fd)
+{
+    if (fileio_is_stream((int)fd)) return 0;
+    return sys_syncfs((int)fd);
+}
+
+int32_t sys_ftruncate_impl(uint32_t fd, uint64_t length)
+{
+    if (length > 0x7FFFFFFF) return -EFBIG;
+    if (fileio_is_stream((int)fd)) return -EINVAL;
+    return sys_ftruncate((int)fd, (off_t)length);
+}
+
+int32_t sys_sync_impl(void)
+{
+    vfs_sync();
+    return 0;
+}
+
+int32_t sys_ioctl_impl(uint32_t fd_arg, uint32_t cmd, uint32_t arg, isr_frame_t *regs)
+{
+    (void)regs;
+    int fd = (int)fd_arg;
+    pcb_t *current_process = get_current_process();
+    if (!current_process || fd < 0 || fd >= MAX_FD) return -EBADF;
+    if (!current_process->fd_table[fd] && fd != STDIN_FILENO) return -EBADF;
+    if (!fileio_is_tty(fd, NULL)) return -ENOTTY;
+
+    userptr_t user_arg = (userptr_t)(uintptr_t)arg;
+    switch (cmd) {
+        case TCGETS: {
+            k_termios_t t;
+            tty_get_termios(&t);
+            return copy_to_user(user_arg, (const_kernelptr_t)&t, sizeof(t)) ? -EFAULT : 0;
+        }
+        case TCSETS:
+        case TCSETSW:
+        case TCSETSF: {
+            k_termios_t t;
+            if (copy_from_user((kernelptr_t)&t, (const_userptr_t)user_arg, sizeof(t)) != 0) return -EFAULT;
+            return tty_set_termios(&t, (int)cmd);
         }
+        case TCFLSH:
+            if (arg > TCIOFLUSH) return -EINVAL;
+            // Output is never queued, so only the input side has work
+            if (arg != TCOFLUSH) tty_flush_input();
+            return 0;
+        case TIOCGPGRP: {
+            uint32_t pgrp = tty_get_pgrp();
+            return copy_to_user(user_arg, (const_kernelptr_t)&pgrp, sizeof(pgrp)) ? -EFAULT : 0;
+        }
+        case TIOCSPGRP: {
+            uint32_t pgrp;
+            if (copy_from_user((kernelptr_t)&pgrp, (const_userptr_t)user_arg, sizeof(pgrp)) != 0) return -EFAULT;
+            return tty_set_pgrp(pgrp);
+        }
+        case TIOCGWINSZ: {
+            k_winsize_t ws;
+            tty_get_winsize(&ws);
+            return copy_to_user(user_arg, (const_kernelptr_t)&ws, sizeof(ws)) ? -EFAULT : 0;
+        }
+        case TIOCSWINSZ: {
+            k_winsize_t ws;
+            if (copy_from_user((kernelptr_t)&ws, (const_userptr_t)user_arg, sizeof(ws)) != 0) return -EFAULT;
+            tty_set_winsize(&ws);
+            return 0;
+        }
+        case FIONREAD: {
+            int32_t n = (int32_t)tty_bytes_available();
+            return copy_to_user(user_arg, (const_kernelptr_t)&n, sizeof(n)) ? -EFAULT : 0;
+        }
+        default:
+            return -ENOTTY;
     }
-    
-    if (kbuf) kfree(kbuf);
-    return total_written;
+}
+
+int32_t sys_tcgetpgrp_impl(uint32_t fd, uint32_t arg2, uint32_t arg3, isr_frame_t *regs)
+{
+    (void)arg2; (void)arg3; (void)regs;
+    if (!fileio_is_tty((int)fd, NULL)) return -ENOTTY;
+    return (int32_t)tty_get_pgrp();
+}
+
+int32_t sys_tcsetpgrp_impl(uint32_t fd, uint32_t pgid, uint32_t arg3, isr_frame_t *regs)
+{
+    (void)arg3; (void)regs;
+    if (!fileio_is_tty((int)fd, NULL)) return -ENOTTY;
+    return tty_set_pgrp(pgid);
 }
 
 int32_t sys_open_impl(uint32_t user_pathname_ptr, uint32_t flags_arg, uint32_t mode_arg, isr_frame_t *regs)
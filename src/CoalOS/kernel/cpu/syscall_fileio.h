@@ -17,6 +17,17 @@
 //============================================================================
 #include <kernel/cpu/isr_frame.h>
 #include <libc/stdint.h>
+#include <libc/stdbool.h>
+
+//============================================================================
+// Types
+//============================================================================
+
+// Linux i386 struct iovec
+typedef struct {
+    uint32_t iov_base;
+    uint32_t iov_len;
+} k_iovec_t;
 
 //============================================================================
 // File I/O System Call Functions
@@ -82,4 +93,107 @@ int32_t sys_lseek_impl(uint32_t fd, uint32_t offset, uint32_t whence, isr_frame_
  */
 int32_t sys_dup2_impl(uint32_t oldfd, uint32_t newfd, uint32_t arg3, isr_frame_t *regs);
 
+//============================================================================
+// Vectored, Positional and In-Kernel Transfers
+//============================================================================
+
+/**
+ * @brief Read into several user buffers with one call
+ * @param fd File descriptor to read from
+ * @param user_iov_ptr User space array of struct iovec
+ * @param iovcnt Number of iovec entries
+ * @param regs Interrupt register frame
+ * @return Total bytes read on success, negative error code on failure
+ */
+int32_t sys_readv_impl(uint32_t fd, uint32_t user_iov_ptr, uint32_t iovcnt, isr_frame_t *regs);
+
+/**
+ * @brief Write from several user buffers with one call
+ * @return Total bytes written on success, negative error code on failure
+ */
+int32_t sys_writev_impl(uint32_t fd, uint32_t user_iov_ptr, uint32_t iovcnt, isr_frame_t *regs);
+
+/**
+ * @brief Read at pos without moving the file offset
+ * @return Bytes read, -ESPIPE for pipes and the terminal, or negative error code
+ */
+int32_t sys_pread64_impl(uint32_t fd, uint32_t user_buf_ptr, uint32_t count, uint64_t pos);
+
+/**
+ * @brief Write at pos without moving the file offset
+ * @return Bytes written, -ESPIPE for pipes and the terminal, or negative error code
+ */
+int32_t sys_pwrite64_impl(uint32_t fd, uint32_t user_buf_ptr, uint32_t count, uint64_t pos);
+
+/** @brief Vectored form of sys_pread64_impl */
+int32_t sys_preadv_impl(uint32_t fd, uint32_t user_iov_ptr, uint32_t iovcnt, uint64_t pos);
+
+/** @brief Vectored form of sys_pwrite64_impl */
+int32_t sys_pwritev_impl(uint32_t fd, uint32_t user_iov_ptr, uint32_t iovcnt, uint64_t pos);
+
+/**
+ * @brief Copy from a file to any descriptor inside the kernel
+ * @param out_fd Destination descriptor (file, pipe or terminal)
+ * @param in_fd Seekable source descriptor
+ * @param user_offset_ptr Optional source position (off_t, or loff_t with offset64),
+ *        updated on return; in_fd's own offset is then left unchanged
+ * @param count Bytes to copy
+ * @param offset64 True for sendfile64
+ * @return Bytes copied, or negative error code
+ */
+int32_t sys_sendfile_impl(uint32_t out_fd, uint32_t in_fd, uint32_t user_offset_ptr, uint32_t count, bool offset64);
+
+/**
+ * @brief Copy a range between two files inside the kernel
+ * @param user_off_in Optional loff_t source position, NULL to use fd_in's offset
+ * @param user_off_out Optional loff_t destination position, NULL to use fd_out's offset
+ * @return Bytes copied, or negative error code
+ */
+int32_t sys_copy_file_range_impl(uint32_t fd_in, uint32_t user_off_in, uint32_t fd_out, uint32_t user_off_out,
+                                 uint32_t len);
+
+/**
+ * @brief Write a file's data and metadata to stable storage
+ * @param datasync True for fdatasync (timestamp-only metadata is skipped)
+ * @return 0 on success, -EINVAL for terminals and pipes, or negative error code
+ */
+int32_t sys_fsync_impl(uint32_t fd, bool datasync);
+
+/**
+ * @brief Write the filesystem holding fd to stable storage
+ * @return 0 on success, or negative error code
+ */
+int32_t sys_syncfs_impl(uint32_t fd);
+
+/**
+ * @brief Set the size of an open file (ftruncate/ftruncate64)
+ * @param length New size (callers reject negative values); sizes past the
+ *               32-bit file offset range fail with -EFBIG
+ * @return 0 on success, -EINVAL for terminals, pipes and read-only descriptors,
+ *         or negative error code
+ */
+int32_t sys_ftruncate_impl(uint32_t fd, uint64_t length);
+
+/**
+ * @brief Write every mounted filesystem to stable storage
+ * @return Always 0
+ */
+int32_t sys_sync_impl(void);
+
+/**
+ * @brief Device control; only the console tty answers
+ * @details Terminal requests: TCGETS, TCSETS/TCSETSW/TCSETSF, TCFLSH,
+ * TIOCGPGRP/TIOCSPGRP, TIOCGWINSZ/TIOCSWINSZ and FIONREAD, with arg a user
+ * pointer (TCFLSH takes the queue selector itself).
+ * @return 0 (FIONREAD stores the count), -ENOTTY for other descriptors or
+ *         requests, or negative error code
+ */
+int32_t sys_ioctl_impl(uint32_t fd, uint32_t cmd, uint32_t arg, isr_frame_t *regs);
+
+/**
+ * @brief Foreground process group of the terminal on fd
+ */
+int32_t sys_tcgetpgrp_impl(uint32_t fd, uint32_t arg2, uint32_t arg3, isr_frame_t *regs);
+int32_t sys_tcsetpgrp_impl(uint32_t fd, uint32_t pgid, uint32_t arg3, isr_frame_t *regs);
+
 #endif // SYSCALL_FILEIO_H
\ No newline at end of file
@@ -6,6 +6,10 @@
  * 
  * @details Implements system calls for file and directory operations including
  * mkdir, rmdir, unlink, stat, chdir, getcwd, and readdir.
+ *
+ * Directory reads are batched: getdents fills as many records as fit in the
+ * caller's buffer from a single pass over the driver, and d_off carries the
+ * driver's position cookie so lseek() on a directory resumes without rescanning.
  */
 
 //============================================================================
@@ -21,6 +25,8 @@
 #include <kernel/process/process.h>
 #include <kernel/memory/paging.h>
 #include <kernel/memory/uaccess.h>
+#include <kernel/memory/kmalloc.h>
+#include <kernel/fs/vfs/sys_file.h>
 #include <kernel/drivers/display/serial.h>
 #include <kernel/lib/string.h>
 #include <libc/stdint.h>
@@ -28,6 +34,93 @@
 #include <libc/stdbool.h>
 #include <libc/limits.h>
 
+//============================================================================
+// Directory Reading Helpers
+//============================================================================
+
+typedef struct {
+    uint8_t *buf;       // Kernel staging buffer for linux_dirent records
+    size_t   size;      // Capacity of buf
+    size_t   used;      // Bytes filled so far
+    bool     overflow;  // True once an entry did not fit
+} getdents_fill_ctx_t;
+
+typedef struct {
+    struct old_linux_dirent *dirent;
+    bool filled;
+} readdir_fill_ctx_t;
+
+static int getdents_filldir(void *ctx, const char *name, size_t namelen,
+                            uint32_t ino, uint8_t d_type, off_t next_pos)
+{
+    getdents_fill_ctx_t *fc = (getdents_fill_ctx_t *)ctx;
+    size_t reclen = linux_dirent_size(namelen);
+
+    if (fc->used + reclen > fc->size) {
+        fc->overflow = true;
+        return 1;
+    }
+
+    struct linux_dirent *d = (struct linux_dirent *)(fc->buf + fc->used);
+    d->d_ino = ino;
+    d->d_off = (unsigned long)next_pos;
+    d->d_reclen = (unsigned short)reclen;
+    memcpy(d->d_name, name, namelen);
+    d->d_name[namelen] = '\0';
+    linux_dirent_set_type(d, d_type);
+
+    fc->used += reclen;
+    return 0;
+}
+
+static int readdir_filldir(void *ctx, const char *name, size_t namelen,
+                           uint32_t ino, uint8_t d_type, off_t next_pos)
+{
+    (void)d_type;
+    readdir_fill_ctx_t *fc = (readdir_fill_ctx_t *)ctx;
+    if (fc->filled) {
+        return 1;
+    }
+    if (namelen > NAME_MAX) {
+        namelen = NAME_MAX;
+    }
+
+    fc->dirent->d_ino = ino;
+    fc->dirent->d_offset = (unsigned long)next_pos;
+    fc->dirent->d_namlen = (unsigned short)namelen;
+    memcpy(fc->dirent->d_name, name, namelen);
+    fc->dirent->d_name[namelen] = '\0';
+    fc->filled = true;
+    return 0;
+}
+
+static file_t *get_dir_file(pcb_t *proc, uint32_t fd)
+{
+    if (fd >= MAX_FD || !proc->fd_table[fd]) {
+        return NULL;
+    }
+    sys_file_t *sf = proc->fd_table[fd];
+    return sf->vfs_file;
+}
+
+static int32_t dir_error_to_errno(int result)
+{
+    switch (result) {
+        case FS_ERR_NOT_A_DIRECTORY:
+            return -ENOTDIR;
+        case FS_ERR_OUT_OF_MEMORY:
+            return -ENOMEM;
+        case FS_ERR_NOT_SUPPORTED:
+            return -ENOTDIR;
+        case FS_ERR_INVALID_PARAM:
+            return -EINVAL;
+        case FS_ERR_BAD_F:
+            return -EBADF;
+        default:
+            return -EIO;
+    }
+}
+
 //============================================================================
 // System Call Implementations
 //============================================================================
@@ -224,11 +317,23 @@ int32_t sys_stat_impl(uint32_t user_path_ptr, uint32_t user_stat_ptr, uint32_t a
         return copy_result;
     }
     
-    serial_printf("[sys_stat] Getting file status for: '%s'\n", pathname);
+    file_t *file = vfs_open(pathname, O_RDONLY);
+    if (!file) {
+        return -ENOENT;
+    }
     
-    // TODO: Implement stat functionality
-    serial_printf("[sys_stat] stat not yet implemented\n");
-    return -ENOSYS;
+    struct stat kstat;
+    memset(&kstat, 0, sizeof(kstat));
+    int result = vfs_fstat(file, &kstat);
+    vfs_close(file);
+    if (result < 0) {
+        return dir_error_to_errno(result);
+    }
+    
+    if (copy_to_user((userptr_t)user_stat_ptr, (const_kernelptr_t)&kstat, sizeof(kstat)) != 0) {
+        return -EFAULT;
+    }
+    return 0;
 }
 
 /**
@@ -320,7 +425,7 @@ int32_t sys_getcwd_impl(uint32_t user_buf_ptr, uint32_t size, uint32_t arg3, isr
  * @param user_dirp User-space pointer to linux_dirent buffer
  * @param count Size of buffer
  * @param regs Interrupt frame
- * @return Number of bytes read on success, negative error code on failure
+ * @return Number of bytes read on success, 0 at end of directory, negative error code on failure
  */
 int32_t sys_getdents_impl(uint32_t fd, uint32_t user_dirp, uint32_t count, isr_frame_t *regs)
 {
@@ -333,27 +438,87 @@ int32_t sys_getdents_impl(uint32_t fd, uint32_t user_dirp, uint32_t count, isr_f
     }
     
     // Validate file descriptor
-    if (fd >= MAX_FD || !current_proc->fd_table[fd]) {
+    file_t *dir_file = get_dir_file(current_proc, fd);
+    if (!dir_file) {
         serial_printf("[sys_getdents] Invalid file descriptor: %u\n", fd);
         return -EBADF;
     }
     
+    // Additional check for reasonable buffer size
+    if (count > SYSCALL_MAX_BUFFER_LEN) {
+        serial_printf("[sys_getdents] Buffer size too large: %u\n", count);
+        return -EINVAL;
+    }
+    
     // Validate user buffer with enhanced security checks
     if (!syscall_validate_buffer((userptr_t)user_dirp, count, true)) {
         serial_printf("[sys_getdents] Invalid buffer: ptr=0x%x, count=%u\n", user_dirp, count);
         return -EFAULT;
     }
     
-    // Additional check for reasonable buffer size
-    if (count > SYSCALL_MAX_BUFFER_LEN) {
-        serial_printf("[sys_getdents] Buffer size too large: %u\n", count);
-        return -EINVAL;
+    // Records are staged in kernel memory because the driver fills them under
+    // its filesystem lock, then copied out with a single copy_to_user.
+    getdents_fill_ctx_t fc = { .buf = NULL, .size = count, .used = 0, .overflow = false };
+    fc.buf = kmalloc(count ? count : 1);
+    if (!fc.buf) {
+        return -ENOMEM;
     }
     
-    serial_printf("[sys_getdents] Reading directory entries from fd %u\n", fd);
+    int result = vfs_getdents(dir_file, getdents_filldir, &fc);
+    int32_t ret;
+    if (result < 0 && fc.used == 0) {
+        ret = dir_error_to_errno(result);
+    } else if (fc.used == 0 && fc.overflow) {
+        ret = -EINVAL; // Buffer too small for even one entry
+    } else if (copy_to_user((userptr_t)user_dirp, (const_kernelptr_t)fc.buf, fc.used) != 0) {
+        ret = -EFAULT;
+    } else {
+        ret = (int32_t)fc.used;
+    }
     
-    // TODO: Implement getdents functionality
-    // This requires proper integration with VFS readdir
-    serial_printf("[sys_getdents] getdents not yet implemented\n");
-    return -ENOSYS;
-}
\ No newline at end of file
+    kfree(fc.buf);
+    return ret;
+}
+
+/**
+ * @brief Read a single directory entry (legacy readdir(2))
+ * @param fd File descriptor of directory
+ * @param user_buf_ptr User-space pointer to old_linux_dirent structure
+ * @param count Ignored, as in Linux
+ * @param regs Interrupt frame
+ * @return 1 if an entry was read, 0 at end of directory, negative error code on failure
+ */
+int32_t sys_readdir_impl(uint32_t fd, uint32_t user_buf_ptr, uint32_t count, isr_frame_t *regs)
+{
+    (void)count; (void)regs;
+    
+    pcb_t* current_proc = get_current_process();
+    if (!current_proc) {
+        return -ESRCH;
+    }
+    
+    file_t *dir_file = get_dir_file(current_proc, fd);
+    if (!dir_file) {
+        return -EBADF;
+    }
+    
+    if (!syscall_validate_buffer((userptr_t)user_buf_ptr, sizeof(struct old_linux_dirent), true)) {
+        return -EFAULT;
+    }
+    
+    struct old_linux_dirent kdirent;
+    readdir_fill_ctx_t fc = { .dirent = &kdirent, .filled = false };
+    
+    int result = vfs_getdents(dir_file, readdir_filldir, &fc);
+    if (result < 0) {
+        return dir_error_to_errno(result);
+    }
+    if (!fc.filled) {
+        return 0;
+    }
+    
+    if (copy_to_user((userptr_t)user_buf_ptr, (const_kernelptr_t)&kdirent, sizeof(kdirent)) != 0) {
+        return -EFAULT;
+    }
+    return 1;
+}
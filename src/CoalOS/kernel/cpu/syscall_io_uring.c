@@ -0,0 +1,726 @@
+/**
+ * @file syscall_io_uring.c
+ * @brief Shared submission/completion rings for batched asynchronous I/O
+ *
+ * @details A ring is an anonymous vnode (like timerfd) owning two frames:
+ * the ring page (SQ/CQ indices, the SQ index array and the CQEs) and the SQE
+ * page. The kernel reaches both through the direct map; the process maps the
+ * same frames with mmap2(), so neither side copies ring contents.
+ *
+ * SQEs are issued in the submitting task's context through the ordinary
+ * read/write/open/close paths, which block on the device where they must;
+ * a batch of N operations costs one trap instead of N. Timeouts complete
+ * from their ktimer in interrupt context. SQPOLL arms a one-tick ktimer that
+ * queues task work on the ring owner, so SQEs published while the owner runs
+ * in user mode are issued on its next return from an interrupt. If the
+ * owner is reaped while another process still holds the ring, polling stops
+ * and io_uring_enter() submits instead.
+ */
+
+//============================================================================
+// Includes
+//============================================================================
+#include "syscall_io_uring.h"
+#include "syscall_fileio.h"
+#include <kernel/process/process.h>
+#include <kernel/process/scheduler.h>
+#include <kernel/process/exit_to_user.h>
+#include <kernel/process/itimer.h>
+#include <kernel/drivers/timer/ktimer.h>
+#include <kernel/fs/vfs/sys_file.h>
+#include <kernel/fs/vfs/fs_errno.h>
+#include <kernel/memory/frame.h>
+#include <kernel/memory/paging.h>
+#include <kernel/memory/kmalloc.h>
+#include <kernel/memory/uaccess.h>
+#include <kernel/sync/spinlock.h>
+#include <kernel/lib/string.h>
+#include <libc/stddef.h>
+
+//============================================================================
+// Ring Layout
+//============================================================================
+
+// Header at the start of the ring page; the offsets reported to user space
+// in io_uring_params point into it
+typedef struct {
+    uint32_t sq_head;
+    uint32_t sq_tail;
+    uint32_t sq_ring_mask;
+    uint32_t sq_ring_entries;
+    uint32_t sq_flags;
+    uint32_t sq_dropped;
+    uint32_t resv[2];
+    uint32_t cq_head;
+    uint32_t cq_tail;
+    uint32_t cq_ring_mask;
+    uint32_t cq_ring_entries;
+    uint32_t cq_overflow;
+    uint32_t cq_flags;
+} io_rings_hdr_t;
+
+#define IORING_SQ_ARRAY_OFF     64u
+#define IORING_MAX_TIMEOUTS     16
+#define IORING_SQPOLL_IDLE_MS   1000u
+#define IORING_OFFSET_CURRENT   ((uint64_t)-1)
+#define AT_FDCWD                (-100)
+
+#define POLLIN   0x0001
+#define POLLOUT  0x0004
+
+typedef struct io_ring io_ring_t;
+
+typedef struct {
+    io_ring_t *ring;
+    ktimer_t   timer;
+    uint64_t   user_data;
+    uint32_t   count;       // Completions still to wait for (0 = time only)
+    bool       active;
+} io_timeout_t;
+
+struct io_ring {
+    uintptr_t       rings_frame;
+    uintptr_t       sqes_frame;
+    io_rings_hdr_t *hdr;
+    uint32_t       *sq_array;
+    io_uring_cqe_t *cqes;
+    io_uring_sqe_t *sqes;
+    uint32_t        sq_entries;
+    uint32_t        cq_entries;
+    spinlock_t      lock;           // CQ tail, timeouts, waiter
+    tcb_t          *waiter;         // Task blocked in io_uring_enter()
+    bool            submitting;     // SQ consumer active (enter or SQPOLL)
+    io_timeout_t    timeouts[IORING_MAX_TIMEOUTS];
+
+    // SQPOLL
+    bool            sqpoll;
+    tcb_t          *owner;
+    ktimer_t        sq_timer;
+    task_work_t     sq_work;
+    task_work_t     owner_exit;     // Drops owner when its TCB is reaped
+    bool            sq_work_queued;
+    bool            closing;        // Closed while sq_work was running
+    uint32_t        sq_idle_ticks;
+    uint32_t        sq_last_submit;
+};
+
+// struct __kernel_timespec
+typedef struct {
+    int64_t tv_sec;
+    int64_t tv_nsec;
+} k_timespec64_t;
+
+static int io_ring_vfs_read(file_t *file, void *buffer, size_t count);
+static int io_ring_vfs_write(file_t *file, const void *buffer, size_t count);
+static int io_ring_vfs_close(file_t *file);
+
+// Never registered or mounted: rings are only reachable through their fd
+static vfs_driver_t io_ring_driver = {
+    .fs_name = "io_uring",
+    .read = io_ring_vfs_read,
+    .write = io_ring_vfs_write,
+    .close = io_ring_vfs_close,
+};
+
+static io_ring_t *io_ring_from_file(file_t *file) {
+    if (!file || !file->vnode || file->vnode->fs_driver != &io_ring_driver) {
+        return NULL;
+    }
+    return (io_ring_t *)file->vnode->data;
+}
+
+static io_ring_t *io_ring_lookup(uint32_t fd) {
+    pcb_t *proc = get_current_process();
+    if (!proc || fd >= MAX_FD || !proc->fd_table[fd]) return NULL;
+    return io_ring_from_file(proc->fd_table[fd]->vfs_file);
+}
+
+bool io_uring_is_ring(file_t *file) {
+    return io_ring_from_file(file) != NULL;
+}
+
+//============================================================================
+// Completion Queue
+//============================================================================
+
+static uint32_t io_ring_cq_ready(const io_ring_t *ring) {
+    return ring->hdr->cq_tail - __atomic_load_n(&ring->hdr->cq_head, __ATOMIC_ACQUIRE);
+}
+
+// Caller holds ring->lock
+static void io_ring_post_locked(io_ring_t *ring, uint64_t user_data, int32_t res) {
+    io_rings_hdr_t *hdr = ring->hdr;
+    uint32_t tail = hdr->cq_tail;
+
+    if (tail - __atomic_load_n(&hdr->cq_head, __ATOMIC_ACQUIRE) >= ring->cq_entries) {
+        hdr->cq_overflow++;
+    } else {
+        io_uring_cqe_t *cqe = &ring->cqes[tail & (ring->cq_entries - 1)];
+        cqe->user_data = user_data;
+        cqe->res = res;
+        cqe->flags = 0;
+        __atomic_store_n(&hdr->cq_tail, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    tcb_t *waiter = ring->waiter;
+    if (waiter) {
+        ring->waiter = NULL;
+        scheduler_unblock_task(waiter);
+    }
+}
+
+// Posts a CQE for a completed request and fires count-based timeouts
+static void io_ring_complete(io_ring_t *ring, uint64_t user_data, int32_t res) {
+    uintptr_t irq = spinlock_acquire_irqsave(&ring->lock);
+    io_ring_post_locked(ring, user_data, res);
+    for (int i = 0; i < IORING_MAX_TIMEOUTS; i++) {
+        io_timeout_t *t = &ring->timeouts[i];
+        if (t->active && t->count && --t->count == 0) {
+            ktimer_cancel(&t->timer);
+            t->active = false;
+            io_ring_post_locked(ring, t->user_data, 0);
+        }
+    }
+    spinlock_release_irqrestore(&ring->lock, irq);
+}
+
+//============================================================================
+// Timeouts
+//============================================================================
+
+static void io_timeout_expired(ktimer_t *timer) {
+    io_timeout_t *t = (io_timeout_t *)timer->data;
+    io_ring_t *ring = t->ring;
+
+    uintptr_t irq = spinlock_acquire_irqsave(&ring->lock);
+    if (t->active) {
+        t->active = false;
+        io_ring_post_locked(ring, t->user_data, -ETIME);
+    }
+    spinlock_release_irqrestore(&ring->lock, irq);
+}
+
+// Returns 1 when armed (the CQE is posted later), or a negative error
+static int io_op_timeout(io_ring_t *ring, const io_uring_sqe_t *sqe) {
+    if (sqe->len != 1 || (sqe->op_flags & ~IORING_TIMEOUT_ABS)) return -EINVAL;
+
+    k_timespec64_t ts64;
+    if (copy_from_user((kernelptr_t)&ts64, (const_userptr_t)(uintptr_t)sqe->addr, sizeof(ts64)) != 0) {
+        return -EFAULT;
+    }
+    if (ts64.tv_sec < 0 || ts64.tv_sec > INT32_MAX ||
+        ts64.tv_nsec < 0 || ts64.tv_nsec >= 1000000000) {
+        return -EINVAL;
+    }
+    k_timespec_t ts = { (int32_t)ts64.tv_sec, (int32_t)ts64.tv_nsec };
+    uint32_t ticks;
+    if (itimer_timespec_to_ticks(&ts, &ticks) < 0) return -EINVAL;
+
+    uintptr_t irq = spinlock_acquire_irqsave(&ring->lock);
+    io_timeout_t *t = NULL;
+    for (int i = 0; i < IORING_MAX_TIMEOUTS; i++) {
+        if (!ring->timeouts[i].active) {
+            t = &ring->timeouts[i];
+            break;
+        }
+    }
+    if (!t) {
+        spinlock_release_irqrestore(&ring->lock, irq);
+        return -EBUSY;
+    }
+    t->active = true;
+    t->user_data = sqe->user_data;
+    t->count = (uint32_t)sqe->off;
+    if (sqe->op_flags & IORING_TIMEOUT_ABS) {
+        uint32_t now = ktimer_now();
+        ktimer_arm_at(&t->timer, (int32_t)(ticks - now) > 0 ? ticks : now);
+    } else {
+        ktimer_arm(&t->timer, ticks);
+    }
+    spinlock_release_irqrestore(&ring->lock, irq);
+    return 1;
+}
+
+static int io_op_timeout_remove(io_ring_t *ring, const io_uring_sqe_t *sqe) {
+    int res = -ENOENT;
+    uintptr_t irq = spinlock_acquire_irqsave(&ring->lock);
+    for (int i = 0; i < IORING_MAX_TIMEOUTS; i++) {
+        io_timeout_t *t = &ring->timeouts[i];
+        if (t->active && t->user_data == sqe->addr) {
+            ktimer_cancel(&t->timer);
+            t->active = false;
+            io_ring_post_locked(ring, t->user_data, -ECANCELED);
+            res = 0;
+            break;
+        }
+    }
+    spinlock_release_irqrestore(&ring->lock, irq);
+    return res;
+}
+
+//============================================================================
+// Operations
+//============================================================================
+
+static file_t *io_fd_file(int32_t fd) {
+    pcb_t *proc = get_current_process();
+    if (!proc || fd < 0 || fd >= MAX_FD || !proc->fd_table[fd]) return NULL;
+    return proc->fd_table[fd]->vfs_file;
+}
+
+// One read or write at off (IORING_OFFSET_CURRENT uses and advances the
+// descriptor's position, any other offset leaves it untouched)
+static int32_t io_rw(bool write, int32_t fd, uint32_t buf, uint32_t len, uint64_t off) {
+    if (off == IORING_OFFSET_CURRENT) {
+        return write ? sys_write_impl((uint32_t)fd, buf, len, NULL)
+                     : sys_read_impl((uint32_t)fd, buf, len, NULL);
+    }
+    return write ? sys_pwrite64_impl((uint32_t)fd, buf, len, off)
+                 : sys_pread64_impl((uint32_t)fd, buf, len, off);
+}
+
+static int32_t io_rw_vec(bool write, const io_uring_sqe_t *sqe) {
+    uint32_t fd = (uint32_t)sqe->fd;
+    uint32_t iov = (uint32_t)sqe->addr;
+    if (sqe->off == IORING_OFFSET_CURRENT) {
+        return write ? sys_writev_impl(fd, iov, sqe->len, NULL)
+                     : sys_readv_impl(fd, iov, sqe->len, NULL);
+    }
+    return write ? sys_pwritev_impl(fd, iov, sqe->len, sqe->off)
+                 : sys_preadv_impl(fd, iov, sqe->len, sqe->off);
+}
+
+// Runs one SQE and returns its CQE result; *deferred is set instead for
+// requests that post their CQE later
+static int32_t io_issue(io_ring_t *ring, const io_uring_sqe_t *sqe, bool *deferred) {
+    *deferred = false;
+    switch (sqe->opcode) {
+        case IORING_OP_NOP:
+            return 0;
+        case IORING_OP_READ:
+        case IORING_OP_WRITE:
+            return io_rw(sqe->opcode == IORING_OP_WRITE, sqe->fd, (uint32_t)sqe->addr, sqe->len, sqe->off);
+        case IORING_OP_READV:
+        case IORING_OP_WRITEV:
+            return io_rw_vec(sqe->opcode == IORING_OP_WRITEV, sqe);
+        case IORING_OP_FSYNC:
+            if (!io_fd_file(sqe->fd)) return -EBADF;
+            return sys_fsync_impl((uint32_t)sqe->fd, (sqe->op_flags & IORING_FSYNC_DATASYNC) != 0);
+        case IORING_OP_POLL_ADD:
+            // No driver reports readiness yet; every open descriptor is ready
+            if (!io_fd_file(sqe->fd)) return -EBADF;
+            return (int32_t)(sqe->op_flags & (POLLIN | POLLOUT));
+        case IORING_OP_OPENAT:
+            if (sqe->fd != AT_FDCWD) return -EINVAL;
+            return sys_open_impl((uint32_t)sqe->addr, sqe->op_flags, sqe->len, NULL);
+        case IORING_OP_CLOSE:
+            if (io_ring_from_file(io_fd_file(sqe->fd)) == ring) return -EBADF;
+            return sys_close_impl((uint32_t)sqe->fd, 0, 0, NULL);
+        case IORING_OP_TIMEOUT: {
+            int32_t res = io_op_timeout(ring, sqe);
+            if (res == 1) *deferred = true;
+            return res;
+        }
+        case IORING_OP_TIMEOUT_REMOVE:
+            return io_op_timeout_remove(ring, sqe);
+        default:
+            return -EINVAL;
+    }
+}
+
+//============================================================================
+// Submission Queue
+//============================================================================
+
+// Consumes up to max SQEs; returns the number consumed or -EBUSY if another
+// consumer is active
+static int32_t io_ring_submit(io_ring_t *ring, uint32_t max) {
+    uintptr_t irq = spinlock_acquire_irqsave(&ring->lock);
+    if (ring->submitting) {
+        spinlock_release_irqrestore(&ring->lock, irq);
+        return -EBUSY;
+    }
+    ring->submitting = true;
+    spinlock_release_irqrestore(&ring->lock, irq);
+
+    io_rings_hdr_t *hdr = ring->hdr;
+    uint32_t head = hdr->sq_head;
+    uint32_t tail = __atomic_load_n(&hdr->sq_tail, __ATOMIC_ACQUIRE);
+    uint32_t submitted = 0;
+    bool link_failed = false;
+
+    while (head != tail && submitted < max) {
+        uint32_t index = __atomic_load_n(&ring->sq_array[head & (ring->sq_entries - 1)], __ATOMIC_RELAXED);
+        head++;
+        if (index >= ring->sq_entries) {
+            hdr->sq_dropped++;
+            continue;
+        }
+        // Copy the SQE first: user space may reuse the slot once head moves
+        io_uring_sqe_t sqe = ring->sqes[index];
+        __atomic_store_n(&hdr->sq_head, head, __ATOMIC_RELEASE);
+        submitted++;
+
+        bool deferred = false;
+        int32_t res;
+        if (link_failed) {
+            res = -ECANCELED;
+        } else if (sqe.flags & ~(IOSQE_IO_DRAIN | IOSQE_IO_LINK)) {
+            res = -EINVAL;
+        } else {
+            // Requests run in order, so IO_DRAIN needs no extra work
+            res = io_issue(ring, &sqe, &deferred);
+        }
+        if (!deferred) {
+            io_ring_complete(ring, sqe.user_data, res);
+        }
+
+        // Errors and short transfers break a link chain
+        bool failed = !deferred && res < 0;
+        if ((sqe.opcode == IORING_OP_READ || sqe.opcode == IORING_OP_WRITE) &&
+            res >= 0 && (uint32_t)res < sqe.len) {
+            failed = true;
+        }
+        link_failed = (sqe.flags & IOSQE_IO_LINK) ? (link_failed || failed) : false;
+
+        tail = __atomic_load_n(&hdr->sq_tail, __ATOMIC_ACQUIRE);
+    }
+    __atomic_store_n(&hdr->sq_head, head, __ATOMIC_RELEASE);
+
+    irq = spinlock_acquire_irqsave(&ring->lock);
+    ring->submitting = false;
+    spinlock_release_irqrestore(&ring->lock, irq);
+    return (int32_t)submitted;
+}
+
+//============================================================================
+// SQ Polling
+//============================================================================
+
+static void io_ring_free(io_ring_t *ring) {
+    put_frame(ring->rings_frame);
+    put_frame(ring->sqes_frame);
+    kfree(ring);
+}
+
+// Runs in the owner's context on its way back to user mode. sq_work_queued
+// stays set until the pass ends, so a close issued by one of its SQEs
+// leaves the free to us.
+static void io_ring_sq_work(task_work_t *work) {
+    io_ring_t *ring = container_of(work, io_ring_t, sq_work);
+    bool rearm = false;
+
+    if (!ring->closing) {
+        uint32_t now = ktimer_now();
+        int32_t n = io_ring_submit(ring, UINT32_MAX);
+        if (n > 0) {
+            ring->sq_last_submit = now;
+        }
+        if (n <= 0 && now - ring->sq_last_submit >= ring->sq_idle_ticks) {
+            // Idle: stop polling until io_uring_enter(IORING_ENTER_SQ_WAKEUP)
+            __atomic_or_fetch(&ring->hdr->sq_flags, IORING_SQ_NEED_WAKEUP, __ATOMIC_RELEASE);
+        } else {
+            rearm = true;
+        }
+    }
+
+    ring->sq_work_queued = false;
+    if (ring->closing) {
+        io_ring_free(ring);
+        return;
+    }
+    if (rearm) {
+        ktimer_arm(&ring->sq_timer, 1);
+    }
+}
+
+// The owner is being reaped with the ring still open through another fd:
+// stop polling, and let io_uring_enter() submit from then on
+static void io_ring_owner_exit(task_work_t *work) {
+    io_ring_t *ring = container_of(work, io_ring_t, owner_exit);
+
+    uintptr_t irq = spinlock_acquire_irqsave(&ring->lock);
+    ktimer_cancel(&ring->sq_timer);
+    ring->sqpoll = false;
+    ring->owner = NULL;
+    ring->sq_work_queued = false; // task_work_exit() dropped it
+    spinlock_release_irqrestore(&ring->lock, irq);
+}
+
+static void io_ring_sq_tick(ktimer_t *timer) {
+    io_ring_t *ring = (io_ring_t *)timer->data;
+    if (ring->owner && !ring->sq_work_queued) {
+        ring->sq_work_queued = true;
+        task_work_add(ring->owner, &ring->sq_work);
+    }
+}
+
+static void io_ring_sq_wakeup(io_ring_t *ring) {
+    uintptr_t irq = local_irq_save();
+    __atomic_and_fetch(&ring->hdr->sq_flags, ~IORING_SQ_NEED_WAKEUP, __ATOMIC_RELEASE);
+    ring->sq_last_submit = ktimer_now();
+    if (!ring->sq_timer.pending && !ring->sq_work_queued) {
+        ktimer_arm(&ring->sq_timer, 1);
+    }
+    local_irq_restore(irq);
+}
+
+//============================================================================
+// System Calls
+//============================================================================
+
+static uint32_t round_up_pow2(uint32_t n) {
+    uint32_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+int32_t sys_io_uring_setup_impl(uint32_t entries, uint32_t user_params_ptr) {
+    io_uring_params_t params;
+    if (copy_from_user((kernelptr_t)&params, (const_userptr_t)user_params_ptr, sizeof(params)) != 0) {
+        return -EFAULT;
+    }
+    if (params.flags & ~(IORING_SETUP_SQPOLL | IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP)) {
+        return -EINVAL;
+    }
+
+    bool clamp = (params.flags & IORING_SETUP_CLAMP) != 0;
+    if (entries == 0) return -EINVAL;
+    if (entries > IORING_MAX_ENTRIES) {
+        if (!clamp) return -EINVAL;
+        entries = IORING_MAX_ENTRIES;
+    }
+    uint32_t sq_entries = round_up_pow2(entries);
+    uint32_t cq_entries = 2 * sq_entries;
+    if (params.flags & IORING_SETUP_CQSIZE) {
+        if (params.cq_entries == 0) return -EINVAL;
+        if (params.cq_entries > IORING_MAX_CQ_ENTRIES) {
+            if (!clamp) return -EINVAL;
+            params.cq_entries = IORING_MAX_CQ_ENTRIES;
+        }
+        cq_entries = round_up_pow2(params.cq_entries);
+        if (cq_entries < sq_entries) return -EINVAL;
+    }
+
+    uint32_t cqes_off = (IORING_SQ_ARRAY_OFF + sq_entries * sizeof(uint32_t) + 15) & ~15u;
+
+    io_ring_t *ring = kmalloc(sizeof(*ring));
+    vnode_t *vnode = kmalloc(sizeof(*vnode));
+    file_t *file = kmalloc(sizeof(*file));
+    uintptr_t rings_frame = frame_alloc();
+    uintptr_t sqes_frame = frame_alloc();
+    if (!ring || !vnode || !file || !rings_frame || !sqes_frame) {
+        if (ring) kfree(ring);
+        if (vnode) kfree(vnode);
+        if (file) kfree(file);
+        if (rings_frame) put_frame(rings_frame);
+        if (sqes_frame) put_frame(sqes_frame);
+        return -ENOMEM;
+    }
+
+    memset(ring, 0, sizeof(*ring));
+    ring->rings_frame = rings_frame;
+    ring->sqes_frame = sqes_frame;
+    uint8_t *rings_page = (uint8_t *)(rings_frame + KERNEL_SPACE_VIRT_START);
+    memset(rings_page, 0, PAGE_SIZE);
+    memset((void *)(sqes_frame + KERNEL_SPACE_VIRT_START), 0, PAGE_SIZE);
+    ring->hdr = (io_rings_hdr_t *)rings_page;
+    ring->sq_array = (uint32_t *)(rings_page + IORING_SQ_ARRAY_OFF);
+    ring->cqes = (io_uring_cqe_t *)(rings_page + cqes_off);
+    ring->sqes = (io_uring_sqe_t *)(sqes_frame + KERNEL_SPACE_VIRT_START);
+    ring->sq_entries = sq_entries;
+    ring->cq_entries = cq_entries;
+    spinlock_init(&ring->lock);
+    for (int i = 0; i < IORING_MAX_TIMEOUTS; i++) {
+        ring->timeouts[i].ring = ring;
+        ktimer_init(&ring->timeouts[i].timer, io_timeout_expired, &ring->timeouts[i]);
+    }
+
+    ring->hdr->sq_ring_mask = sq_entries - 1;
+    ring->hdr->sq_ring_entries = sq_entries;
+    ring->hdr->cq_ring_mask = cq_entries - 1;
+    ring->hdr->cq_ring_entries = cq_entries;
+
+    if (params.flags & IORING_SETUP_SQPOLL) {
+        uint32_t idle_ms = params.sq_thread_idle ? params.sq_thread_idle : IORING_SQPOLL_IDLE_MS;
+        ring->sqpoll = true;
+        ring->owner = get_current_task();
+        ring->sq_idle_ticks = idle_ms * KTIMER_HZ / 1000;
+        ring->sq_work.func = io_ring_sq_work;
+        ktimer_init(&ring->sq_timer, io_ring_sq_tick, ring);
+    }
+
+    memset(&params.sq_off, 0, sizeof(params.sq_off));
+    memset(&params.cq_off, 0, sizeof(params.cq_off));
+    params.sq_entries = sq_entries;
+    params.cq_entries = cq_entries;
+    params.features = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_SUBMIT_STABLE;
+    params.sq_off.head = offsetof(io_rings_hdr_t, sq_head);
+    params.sq_off.tail = offsetof(io_rings_hdr_t, sq_tail);
+    params.sq_off.ring_mask = offsetof(io_rings_hdr_t, sq_ring_mask);
+    params.sq_off.ring_entries = offsetof(io_rings_hdr_t, sq_ring_entries);
+    params.sq_off.flags = offsetof(io_rings_hdr_t, sq_flags);
+    params.sq_off.dropped = offsetof(io_rings_hdr_t, sq_dropped);
+    params.sq_off.array = IORING_SQ_ARRAY_OFF;
+    params.cq_off.head = offsetof(io_rings_hdr_t, cq_head);
+    params.cq_off.tail = offsetof(io_rings_hdr_t, cq_tail);
+    params.cq_off.ring_mask = offsetof(io_rings_hdr_t, cq_ring_mask);
+    params.cq_off.ring_entries = offsetof(io_rings_hdr_t, cq_ring_entries);
+    params.cq_off.overflow = offsetof(io_rings_hdr_t, cq_overflow);
+    params.cq_off.flags = offsetof(io_rings_hdr_t, cq_flags);
+    params.cq_off.cqes = cqes_off;
+
+    if (copy_to_user((userptr_t)user_params_ptr, (const_kernelptr_t)&params, sizeof(params)) != 0) {
+        io_ring_free(ring);
+        kfree(vnode);
+        kfree(file);
+        return -EFAULT;
+    }
+
+    vnode->data = ring;
+    vnode->fs_driver = &io_ring_driver;
+    file->vnode = vnode;
+    file->flags = O_RDWR;
+    file->offset = 0;
+    spinlock_init(&file->lock);
+    file->refcount = 1;
+
+    // On failure sys_file_install() closes the file, and io_ring_vfs_close()
+    // and vfs_close() free the ring, vnode and file
+    int fd = sys_file_install(file, (int)file->flags);
+    if (fd >= 0 && ring->sqpoll) {
+        ring->owner_exit.func = io_ring_owner_exit;
+        task_exit_work_add(ring->owner, &ring->owner_exit);
+        io_ring_sq_wakeup(ring);
+    }
+    return fd;
+}
+
+int32_t sys_io_uring_enter_impl(uint32_t fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+    io_ring_t *ring = io_ring_lookup(fd);
+    if (!ring) return -EBADF;
+    if (flags & ~(IORING_ENTER_GETEVENTS | IORING_ENTER_SQ_WAKEUP)) return -EINVAL;
+
+    int32_t submitted = 0;
+    if (ring->sqpoll) {
+        // The poller owns the SQ; report the batch as taken
+        if (flags & IORING_ENTER_SQ_WAKEUP) {
+            io_ring_sq_wakeup(ring);
+        }
+        submitted = (int32_t)to_submit;
+    } else if (to_submit) {
+        submitted = io_ring_submit(ring, to_submit);
+        if (submitted < 0) return submitted;
+    }
+
+    if (!(flags & IORING_ENTER_GETEVENTS) || min_complete == 0) {
+        return submitted;
+    }
+    if (min_complete > ring->cq_entries) {
+        min_complete = ring->cq_entries;
+    }
+
+    tcb_t *current = get_current_task();
+    if (!current) return -EFAULT;
+    for (;;) {
+        uintptr_t irq = spinlock_acquire_irqsave(&ring->lock);
+        if (io_ring_cq_ready(ring) >= min_complete) {
+            spinlock_release_irqrestore(&ring->lock, irq);
+            return submitted;
+        }
+        if (test_tsk_thread_flag(current, TIF_SIGPENDING)) {
+            spinlock_release_irqrestore(&ring->lock, irq);
+            return submitted ? submitted : -EINTR;
+        }
+        if (ring->waiter && ring->waiter != current) {
+            spinlock_release_irqrestore(&ring->lock, irq);
+            return -EBUSY;
+        }
+        ring->waiter = current;
+        current->state = TASK_BLOCKED;
+        spinlock_release_irqrestore(&ring->lock, irq);
+
+        schedule();
+    }
+}
+
+//============================================================================
+// Ring Mapping
+//============================================================================
+
+int io_uring_mmap(file_t *file, mm_struct_t *mm, uintptr_t addr, size_t length, uint32_t offset) {
+    io_ring_t *ring = io_ring_from_file(file);
+    if (!ring || !mm) return -EINVAL;
+    if (length != PAGE_SIZE) return -EINVAL;
+    // The ring is mapped eagerly, so the target must not reach kernel tables
+    if ((addr & (PAGE_SIZE - 1)) || !mm_is_user_range(addr, length)) return -EINVAL;
+
+    uintptr_t frame;
+    switch (offset) {
+        case IORING_OFF_SQ_RING:
+        case IORING_OFF_CQ_RING:
+            frame = ring->rings_frame;
+            break;
+        case IORING_OFF_SQES:
+            frame = ring->sqes_frame;
+            break;
+        default:
+            return -EINVAL;
+    }
+
+    uint32_t page_prot = PTE_USER_DATA_FLAGS;
+    if (!insert_vma(mm, addr, addr + PAGE_SIZE, VM_USER | VM_READ | VM_WRITE | VM_SHARED,
+                    page_prot, NULL, offset)) {
+        return -ENOMEM;
+    }
+    // The mapping holds its own reference; munmap/exit drop it
+    get_frame(frame);
+    if (paging_map_single_4k(mm->pgd_phys, addr, frame, page_prot) != 0) {
+        put_frame(frame);
+        remove_vma_range(mm, addr, PAGE_SIZE);
+        return -ENOMEM;
+    }
+    return 0;
+}
+
+//============================================================================
+// VFS Operations
+//============================================================================
+
+static int io_ring_vfs_read(file_t *file, void *buffer, size_t count) {
+    (void)file; (void)buffer; (void)count;
+    return -EINVAL;
+}
+
+static int io_ring_vfs_write(file_t *file, const void *buffer, size_t count) {
+    (void)file; (void)buffer; (void)count;
+    return -EINVAL;
+}
+
+static int io_ring_vfs_close(file_t *file) {
+    io_ring_t *ring = io_ring_from_file(file);
+    if (!ring) return -EINVAL;
+
+    uintptr_t irq = spinlock_acquire_irqsave(&ring->lock);
+    for (int i = 0; i < IORING_MAX_TIMEOUTS; i++) {
+        ktimer_cancel(&ring->timeouts[i].timer);
+        ring->timeouts[i].active = false;
+    }
+    bool running = false;
+    if (ring->sqpoll && ring->owner) {
+        ktimer_cancel(&ring->sq_timer);
+        task_exit_work_cancel(ring->owner, &ring->owner_exit);
+        // A pass the owner has already taken off its list still runs
+        running = ring->sq_work_queued && !task_work_cancel(ring->owner, &ring->sq_work);
+        ring->sq_work_queued = running;
+        ring->closing = running;
+    }
+    spinlock_release_irqrestore(&ring->lock, irq);
+
+    file->vnode->data = NULL;
+    // A running poll pass still references the ring and frees it when done
+    if (!running) {
+        io_ring_free(ring);
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file syscall_io_uring.h
+ * @brief Shared submission/completion rings for batched asynchronous I/O
+ *
+ * @details Linux-compatible io_uring subset. io_uring_setup() returns a ring
+ * descriptor; the process maps the rings (IORING_OFF_SQ_RING, the CQ ring
+ * shares that page) and the SQE array (IORING_OFF_SQES) with mmap2(), queues
+ * SQEs and submits any number of them with one io_uring_enter(). With
+ * IORING_SETUP_SQPOLL the kernel picks up new SQEs by itself on every tick
+ * while the owner runs, so steady-state submission needs no syscall at all.
+ *
+ * Each ring and each SQE array is one page, which bounds a ring at
+ * IORING_MAX_ENTRIES submissions and twice that many completions in flight.
+ */
+
+#ifndef SYSCALL_IO_URING_H
+#define SYSCALL_IO_URING_H
+
+//============================================================================
+// Includes
+//============================================================================
+#include <kernel/fs/vfs/vfs.h>
+#include <kernel/memory/mm.h>
+#include <libc/stdint.h>
+
+//============================================================================
+// User ABI (matches <linux/io_uring.h>)
+//============================================================================
+
+#define IORING_MAX_ENTRIES      64
+#define IORING_MAX_CQ_ENTRIES   (2 * IORING_MAX_ENTRIES)
+
+// io_uring_params.flags
+#define IORING_SETUP_SQPOLL     (1u << 1)
+#define IORING_SETUP_CQSIZE     (1u << 3)
+#define IORING_SETUP_CLAMP      (1u << 4)
+
+// io_uring_params.features
+#define IORING_FEAT_SINGLE_MMAP   (1u << 0)
+#define IORING_FEAT_SUBMIT_STABLE (1u << 2)
+
+// io_uring_enter() flags
+#define IORING_ENTER_GETEVENTS  (1u << 0)
+#define IORING_ENTER_SQ_WAKEUP  (1u << 1)
+
+// SQ ring flags
+#define IORING_SQ_NEED_WAKEUP   (1u << 0)
+
+// mmap2() offsets (bytes; mmap2 passes them in pages)
+#define IORING_OFF_SQ_RING      0x00000000u
+#define IORING_OFF_CQ_RING      0x08000000u
+#define IORING_OFF_SQES         0x10000000u
+
+// sqe->flags
+#define IOSQE_IO_DRAIN          (1u << 1)
+#define IOSQE_IO_LINK           (1u << 2)
+
+// sqe->opcode
+#define IORING_OP_NOP            0
+#define IORING_OP_READV          1
+#define IORING_OP_WRITEV         2
+#define IORING_OP_FSYNC          3
+#define IORING_OP_POLL_ADD       6
+#define IORING_OP_TIMEOUT       11
+#define IORING_OP_TIMEOUT_REMOVE 12
+#define IORING_OP_OPENAT        18
+#define IORING_OP_CLOSE         19
+#define IORING_OP_READ          22
+#define IORING_OP_WRITE         23
+
+#define IORING_TIMEOUT_ABS      (1u << 0)
+#define IORING_FSYNC_DATASYNC   (1u << 0)
+
+typedef struct {
+    uint32_t head;
+    uint32_t tail;
+    uint32_t ring_mask;
+    uint32_t ring_entries;
+    uint32_t flags;
+    uint32_t dropped;
+    uint32_t array;
+    uint32_t resv1;
+    uint64_t resv2;
+} io_sqring_offsets_t;
+
+typedef struct {
+    uint32_t head;
+    uint32_t tail;
+    uint32_t ring_mask;
+    uint32_t ring_entries;
+    uint32_t overflow;
+    uint32_t cqes;
+    uint32_t flags;
+    uint32_t resv1;
+    uint64_t resv2;
+} io_cqring_offsets_t;
+
+typedef struct {
+    uint32_t sq_entries;
+    uint32_t cq_entries;
+    uint32_t flags;
+    uint32_t sq_thread_cpu;
+    uint32_t sq_thread_idle;    // SQPOLL idle time in ms before NEED_WAKEUP
+    uint32_t features;
+    uint32_t wq_fd;
+    uint32_t resv[3];
+    io_sqring_offsets_t sq_off;
+    io_cqring_offsets_t cq_off;
+} io_uring_params_t;
+
+typedef struct {
+    uint8_t  opcode;
+    uint8_t  flags;
+    uint16_t ioprio;
+    int32_t  fd;
+    uint64_t off;               // File offset, (uint64_t)-1 for the current position
+    uint64_t addr;              // Buffer, iovec array, path or timespec
+    uint32_t len;
+    uint32_t op_flags;          // rw_flags / fsync_flags / poll_events / open_flags ...
+    uint64_t user_data;
+    uint64_t pad[3];
+} io_uring_sqe_t;
+
+typedef struct {
+    uint64_t user_data;
+    int32_t  res;
+    uint32_t flags;
+} io_uring_cqe_t;
+
+//============================================================================
+// System Calls
+//============================================================================
+
+/**
+ * @brief Creates a ring and installs its descriptor
+ * @param entries Requested SQ size (rounded up to a power of two)
+ * @param user_params_ptr struct io_uring_params in/out
+ * @return Ring descriptor, or negative error code
+ */
+int32_t sys_io_uring_setup_impl(uint32_t entries, uint32_t user_params_ptr);
+
+/**
+ * @brief Submits queued SQEs and optionally waits for completions
+ * @param fd Ring descriptor
+ * @param to_submit Maximum number of SQEs to consume
+ * @param min_complete With IORING_ENTER_GETEVENTS, CQEs to wait for
+ * @param flags IORING_ENTER_*
+ * @return Number of SQEs consumed, or negative error code
+ */
+int32_t sys_io_uring_enter_impl(uint32_t fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags);
+
+//============================================================================
+// Ring Mapping
+//============================================================================
+
+/** @brief True if file is an io_uring descriptor */
+bool io_uring_is_ring(file_t *file);
+
+/**
+ * @brief Maps a ring region into mm at addr (mmap2 on a ring descriptor)
+ * @param offset IORING_OFF_SQ_RING, IORING_OFF_CQ_RING or IORING_OFF_SQES
+ * @return 0, or negative error code
+ */
+int io_uring_mmap(file_t *file, mm_struct_t *mm, uintptr_t addr, size_t length, uint32_t offset);
+
+#endif // SYSCALL_IO_URING_H
@@ -7,12 +7,18 @@
 #include <kernel/cpu/syscall_linux.h>
 #include <kernel/cpu/syscall.h>
 #include "syscall_security.h"
+#include "syscall_timer.h"
+#include "syscall_io_uring.h"
+#include "syscall_socket.h"
+#include "syscall_fileio.h"
 #include <kernel/process/process.h>
 #include <kernel/process/scheduler.h>
 #include <kernel/memory/mm.h>
 #include <kernel/memory/kmalloc.h>
 #include <kernel/memory/paging.h>
 #include <kernel/memory/uaccess.h>
+#include <kernel/memory/file_map.h>
+#include <kernel/memory/shmem.h>
 #include <kernel/fs/vfs/vfs.h>
 #include <kernel/fs/vfs/sys_file.h>
 #include <kernel/drivers/display/serial.h>
@@ -44,7 +50,10 @@ void paging_map_page(uint32_t *pgdir, uint32_t vaddr, uint32_t paddr, uint32_t f
 uint32_t *get_kernel_page_directory(void);
 extern int32_t sys_waitpid_impl(uint32_t pid, uint32_t user_status_ptr, uint32_t options, isr_frame_t *regs);
 extern int32_t sys_execve_impl(uint32_t user_pathname_ptr, uint32_t user_argv_ptr, uint32_t user_envp_ptr, isr_frame_t *regs);
+extern int32_t sys_getdents_impl(uint32_t fd, uint32_t user_dirp, uint32_t count, isr_frame_t *regs);
+extern int32_t sys_readdir_impl(uint32_t fd, uint32_t user_buf_ptr, uint32_t count, isr_frame_t *regs);
 extern volatile uint32_t g_pit_ticks;
+extern bool g_nx_supported;
 
 // Forward declarations for stub functions
 static pcb_t *process_fork(pcb_t *parent);
@@ -77,14 +86,66 @@ static int sys_linux_brk(uint32_t brk, uint32_t unused1, uint32_t unused2, uint3
 static int sys_linux_getuid(uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4, uint32_t unused5, uint32_t unused6);
 static int sys_linux_getgid(uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4, uint32_t unused5, uint32_t unused6);
 static int sys_linux_mmap(uint32_t addr, uint32_t length, uint32_t prot, uint32_t flags, uint32_t fd, uint32_t offset);
+static int sys_linux_mmap2(uint32_t addr, uint32_t length, uint32_t prot, uint32_t flags, uint32_t fd, uint32_t pgoff);
 static int sys_linux_munmap(uint32_t addr, uint32_t length, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4);
 static int sys_linux_mprotect(uint32_t addr, uint32_t len, uint32_t prot, uint32_t unused1, uint32_t unused2, uint32_t unused3);
 static int sys_linux_mkdir(uint32_t pathname, uint32_t mode, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4);
 static int sys_linux_rmdir(uint32_t pathname, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4, uint32_t unused5);
 static int sys_linux_unlink(uint32_t pathname, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4, uint32_t unused5);
+static int sys_linux_readdir(uint32_t fd, uint32_t dirent, uint32_t count, uint32_t unused1, uint32_t unused2, uint32_t unused3);
+static int sys_linux_getdents(uint32_t fd, uint32_t dirp, uint32_t count, uint32_t unused1, uint32_t unused2, uint32_t unused3);
 static int sys_linux_time(uint32_t tloc, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4, uint32_t unused5);
 static int sys_linux_gettimeofday(uint32_t tv, uint32_t tz, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4);
 static int sys_linux_nanosleep(uint32_t req, uint32_t rem, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4);
+static int sys_linux_alarm(uint32_t seconds, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4, uint32_t unused5);
+static int sys_linux_setitimer(uint32_t which, uint32_t new_value, uint32_t old_value, uint32_t unused1, uint32_t unused2, uint32_t unused3);
+static int sys_linux_getitimer(uint32_t which, uint32_t curr_value, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4);
+static int sys_linux_timer_create(uint32_t clockid, uint32_t sevp, uint32_t timerid, uint32_t unused1, uint32_t unused2, uint32_t unused3);
+static int sys_linux_timer_settime(uint32_t timerid, uint32_t flags, uint32_t new_value, uint32_t old_value, uint32_t unused1, uint32_t unused2);
+static int sys_linux_timer_gettime(uint32_t timerid, uint32_t curr_value, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4);
+static int sys_linux_timer_getoverrun(uint32_t timerid, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4, uint32_t unused5);
+static int sys_linux_timer_delete(uint32_t timerid, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4, uint32_t unused5);
+static int sys_linux_timerfd_create(uint32_t clockid, uint32_t flags, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4);
+static int sys_linux_timerfd_settime(uint32_t fd, uint32_t flags, uint32_t new_value, uint32_t old_value, uint32_t unused1, uint32_t unused2);
+static int sys_linux_timerfd_gettime(uint32_t fd, uint32_t curr_value, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4);
+static int sys_linux_times(uint32_t buf, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4, uint32_t unused5);
+static int sys_linux_getrusage(uint32_t who, uint32_t usage, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4);
+static int sys_linux_clock_gettime(uint32_t clockid, uint32_t tp, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4);
+static int sys_linux_clock_getres(uint32_t clockid, uint32_t res, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4);
+static int sys_linux_readv(uint32_t fd, uint32_t iov, uint32_t iovcnt, uint32_t unused1, uint32_t unused2, uint32_t unused3);
+static int sys_linux_writev(uint32_t fd, uint32_t iov, uint32_t iovcnt, uint32_t unused1, uint32_t unused2, uint32_t unused3);
+static int sys_linux_pread64(uint32_t fd, uint32_t buf, uint32_t count, uint32_t pos_lo, uint32_t pos_hi, uint32_t unused1);
+static int sys_linux_pwrite64(uint32_t fd, uint32_t buf, uint32_t count, uint32_t pos_lo, uint32_t pos_hi, uint32_t unused1);
+static int sys_linux_preadv(uint32_t fd, uint32_t iov, uint32_t iovcnt, uint32_t pos_lo, uint32_t pos_hi, uint32_t unused1);
+static int sys_linux_pwritev(uint32_t fd, uint32_t iov, uint32_t iovcnt, uint32_t pos_lo, uint32_t pos_hi, uint32_t unused1);
+static int sys_linux_sendfile(uint32_t out_fd, uint32_t in_fd, uint32_t offset, uint32_t count, uint32_t unused1, uint32_t unused2);
+static int sys_linux_sendfile64(uint32_t out_fd, uint32_t in_fd, uint32_t offset, uint32_t count, uint32_t unused1, uint32_t unused2);
+static int sys_linux_copy_file_range(uint32_t fd_in, uint32_t off_in, uint32_t fd_out, uint32_t off_out, uint32_t len, uint32_t flags);
+static int sys_linux_fsync(uint32_t fd, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4, uint32_t unused5);
+static int sys_linux_fdatasync(uint32_t fd, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4, uint32_t unused5);
+static int sys_linux_ftruncate(uint32_t fd, uint32_t length, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4);
+static int sys_linux_ftruncate64(uint32_t fd, uint32_t length_lo, uint32_t length_hi, uint32_t unused1, uint32_t unused2, uint32_t unused3);
+static int sys_linux_ioctl(uint32_t fd, uint32_t cmd, uint32_t arg, uint32_t unused1, uint32_t unused2, uint32_t unused3);
+static int sys_linux_sync(uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4, uint32_t unused5, uint32_t unused6);
+static int sys_linux_syncfs(uint32_t fd, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4, uint32_t unused5);
+static int sys_linux_io_uring_setup(uint32_t entries, uint32_t params, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4);
+static int sys_linux_io_uring_enter(uint32_t fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags, uint32_t sig, uint32_t unused1);
+static int sys_linux_socketcall(uint32_t call, uint32_t args, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4);
+static int sys_linux_socket(uint32_t domain, uint32_t type, uint32_t protocol, uint32_t unused1, uint32_t unused2, uint32_t unused3);
+static int sys_linux_socketpair(uint32_t domain, uint32_t type, uint32_t protocol, uint32_t sv, uint32_t unused1, uint32_t unused2);
+static int sys_linux_bind(uint32_t fd, uint32_t addr, uint32_t addrlen, uint32_t unused1, uint32_t unused2, uint32_t unused3);
+static int sys_linux_connect(uint32_t fd, uint32_t addr, uint32_t addrlen, uint32_t unused1, uint32_t unused2, uint32_t unused3);
+static int sys_linux_listen(uint32_t fd, uint32_t backlog, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4);
+static int sys_linux_accept4(uint32_t fd, uint32_t addr, uint32_t addrlen, uint32_t flags, uint32_t unused1, uint32_t unused2);
+static int sys_linux_getsockopt(uint32_t fd, uint32_t level, uint32_t optname, uint32_t optval, uint32_t optlen, uint32_t unused1);
+static int sys_linux_setsockopt(uint32_t fd, uint32_t level, uint32_t optname, uint32_t optval, uint32_t optlen, uint32_t unused1);
+static int sys_linux_getsockname(uint32_t fd, uint32_t addr, uint32_t addrlen, uint32_t unused1, uint32_t unused2, uint32_t unused3);
+static int sys_linux_getpeername(uint32_t fd, uint32_t addr, uint32_t addrlen, uint32_t unused1, uint32_t unused2, uint32_t unused3);
+static int sys_linux_sendto(uint32_t fd, uint32_t buf, uint32_t len, uint32_t flags, uint32_t addr, uint32_t addrlen);
+static int sys_linux_sendmsg(uint32_t fd, uint32_t msg, uint32_t flags, uint32_t unused1, uint32_t unused2, uint32_t unused3);
+static int sys_linux_recvfrom(uint32_t fd, uint32_t buf, uint32_t len, uint32_t flags, uint32_t addr, uint32_t addrlen);
+static int sys_linux_recvmsg(uint32_t fd, uint32_t msg, uint32_t flags, uint32_t unused1, uint32_t unused2, uint32_t unused3);
+static int sys_linux_shutdown(uint32_t fd, uint32_t how, uint32_t unused1, uint32_t unused2, uint32_t unused3, uint32_t unused4);
 
 // Unimplemented syscall handler
 static int sys_unimplemented(uint32_t arg1, uint32_t arg2, uint32_t arg3, uint32_t arg4, uint32_t arg5, uint32_t arg6) {
@@ -115,6 +176,7 @@ void init_linux_syscall_table(void) {
     // Memory Management
     linux_syscall_table[__NR_brk] = sys_linux_brk;
     linux_syscall_table[__NR_mmap] = sys_linux_mmap;
+    linux_syscall_table[__NR_mmap2] = sys_linux_mmap2;
     linux_syscall_table[__NR_munmap] = sys_linux_munmap;
     linux_syscall_table[__NR_mprotect] = sys_linux_mprotect;
     
@@ -122,12 +184,77 @@ void init_linux_syscall_table(void) {
     linux_syscall_table[__NR_mkdir] = sys_linux_mkdir;
     linux_syscall_table[__NR_rmdir] = sys_linux_rmdir;
     linux_syscall_table[__NR_unlink] = sys_linux_unlink;
+    linux_syscall_table[__NR_readdir] = sys_linux_readdir;
+    linux_syscall_table[__NR_getdents] = sys_linux_getdents;
     
     // Time
     linux_syscall_table[__NR_time] = sys_linux_time;
     linux_syscall_table[__NR_gettimeofday] = sys_linux_gettimeofday;
     linux_syscall_table[__NR_nanosleep] = sys_linux_nanosleep;
     
+    // Timers
+    linux_syscall_table[__NR_alarm] = sys_linux_alarm;
+    linux_syscall_table[__NR_setitimer] = sys_linux_setitimer;
+    linux_syscall_table[__NR_getitimer] = sys_linux_getitimer;
+    linux_syscall_table[__NR_timer_create] = sys_linux_timer_create;
+    linux_syscall_table[__NR_timer_settime] = sys_linux_timer_settime;
+    linux_syscall_table[__NR_timer_gettime] = sys_linux_timer_gettime;
+    linux_syscall_table[__NR_timer_getoverrun] = sys_linux_timer_getoverrun;
+    linux_syscall_table[__NR_timer_delete] = sys_linux_timer_delete;
+    linux_syscall_table[__NR_timerfd_create] = sys_linux_timerfd_create;
+    linux_syscall_table[__NR_timerfd_settime] = sys_linux_timerfd_settime;
+    linux_syscall_table[__NR_timerfd_gettime] = sys_linux_timerfd_gettime;
+    
+    // CPU time and clocks
+    linux_syscall_table[__NR_times] = sys_linux_times;
+    linux_syscall_table[__NR_getrusage] = sys_linux_getrusage;
+    linux_syscall_table[__NR_clock_gettime] = sys_linux_clock_gettime;
+    linux_syscall_table[__NR_clock_getres] = sys_linux_clock_getres;
+    
+    // Vectored, positional and in-kernel transfers
+    linux_syscall_table[__NR_readv] = sys_linux_readv;
+    linux_syscall_table[__NR_writev] = sys_linux_writev;
+    linux_syscall_table[__NR_pread64] = sys_linux_pread64;
+    linux_syscall_table[__NR_pwrite64] = sys_linux_pwrite64;
+    linux_syscall_table[__NR_preadv] = sys_linux_preadv;
+    linux_syscall_table[__NR_pwritev] = sys_linux_pwritev;
+    linux_syscall_table[__NR_sendfile] = sys_linux_sendfile;
+    linux_syscall_table[__NR_sendfile64] = sys_linux_sendfile64;
+    linux_syscall_table[__NR_copy_file_range] = sys_linux_copy_file_range;
+    linux_syscall_table[__NR_ftruncate] = sys_linux_ftruncate;
+    linux_syscall_table[__NR_ftruncate64] = sys_linux_ftruncate64;
+    
+    // Terminal control
+    linux_syscall_table[__NR_ioctl] = sys_linux_ioctl;
+    
+    // Durability
+    linux_syscall_table[__NR_fsync] = sys_linux_fsync;
+    linux_syscall_table[__NR_fdatasync] = sys_linux_fdatasync;
+    linux_syscall_table[__NR_sync] = sys_linux_sync;
+    linux_syscall_table[__NR_syncfs] = sys_linux_syncfs;
+    
+    // Asynchronous I/O rings
+    linux_syscall_table[__NR_io_uring_setup] = sys_linux_io_uring_setup;
+    linux_syscall_table[__NR_io_uring_enter] = sys_linux_io_uring_enter;
+    
+    // Sockets
+    linux_syscall_table[__NR_socketcall] = sys_linux_socketcall;
+    linux_syscall_table[__NR_socket] = sys_linux_socket;
+    linux_syscall_table[__NR_socketpair] = sys_linux_socketpair;
+    linux_syscall_table[__NR_bind] = sys_linux_bind;
+    linux_syscall_table[__NR_connect] = sys_linux_connect;
+    linux_syscall_table[__NR_listen] = sys_linux_listen;
+    linux_syscall_table[__NR_accept4] = sys_linux_accept4;
+    linux_syscall_table[__NR_getsockopt] = sys_linux_getsockopt;
+    linux_syscall_table[__NR_setsockopt] = sys_linux_setsockopt;
+    linux_syscall_table[__NR_getsockname] = sys_linux_getsockname;
+    linux_syscall_table[__NR_getpeername] = sys_linux_getpeername;
+    linux_syscall_table[__NR_sendto] = sys_linux_sendto;
+    linux_syscall_table[__NR_sendmsg] = sys_linux_sendmsg;
+    linux_syscall_table[__NR_recvfrom] = sys_linux_recvfrom;
+    linux_syscall_table[__NR_recvmsg] = sys_linux_recvmsg;
+    linux_syscall_table[__NR_shutdown] = sys_linux_shutdown;
+    
     // User/Group IDs
     linux_syscall_table[__NR_getuid] = sys_linux_getuid;
     linux_syscall_table[__NR_getgid] = sys_linux_getgid;
@@ -137,7 +264,7 @@ void init_linux_syscall_table(void) {
 
 // Linux syscall dispatcher
 int linux_syscall_dispatcher(uint32_t syscall_num, uint32_t ebx, uint32_t ecx, 
-                            uint32_t edx, uint32_t esi, uint32_t edi) {
+                            uint32_t edx, uint32_t esi, uint32_t edi, uint32_t ebp) {
     if (syscall_num >= __NR_syscalls) {
         return -LINUX_ENOSYS;
     }
@@ -148,7 +275,7 @@ int linux_syscall_dispatcher(uint32_t syscall_num, uint32_t ebx, uint32_t ecx,
     }
     
     // Call the handler with Linux ABI parameters
-    return handler(ebx, ecx, edx, esi, edi, 0);
+    return handler(ebx, ecx, edx, esi, edi, ebp);
 }
 
 // System call implementations
@@ -261,6 +388,7 @@ static int sys_linux_open(uint32_t filename, uint32_t flags, uint32_t mode,
     if (flags & 0x0400) coalos_flags |= O_NOCTTY;
     if (flags & 0x0800) coalos_flags |= O_TRUNC;
     if (flags & 0x1000) coalos_flags |= O_APPEND;
+    if (flags & 0x4000) coalos_flags |= O_DIRECT;
     
     // Perform open
     int result = sys_open((const char *)filename, coalos_flags, mode);
@@ -434,6 +562,17 @@ static int sys_linux_mmap(uint32_t addr, uint32_t length, uint32_t prot,
         if (addr == 0) {
             return -LINUX_ENOMEM;
         }
+    } else if ((addr & (PAGE_SIZE - 1)) || !mm_is_user_range(addr, length)) {
+        return -LINUX_EINVAL;
+    }
+    
+    // Shared anonymous memory is an unnamed shm object, so fork keeps it shared
+    if (flags & 0x01) { // MAP_SHARED
+        file_t *obj = shmem_file_create(length);
+        if (!obj) return -LINUX_ENOMEM;
+        int res = shmem_mmap(obj, current->process->mm, addr, length, 0, prot);
+        vfs_close(obj); // The VMA holds its own reference
+        return res < 0 ? res : (int)addr;
     }
     
     // Create VMA
@@ -448,9 +587,14 @@ static int sys_linux_mmap(uint32_t addr, uint32_t length, uint32_t prot,
     vma->vm_file = NULL;
     vma->vm_offset = 0;
     
+    // Demand faults map pages with the VMA's protection
+    uint32_t page_prot = PAGE_PRESENT | PAGE_USER;
+    if (vm_flags & VM_WRITE) page_prot |= PAGE_RW;
+    if (!(vm_flags & VM_EXEC) && g_nx_supported) page_prot |= PAGE_NX_BIT;
+    
     // Insert VMA using the proper function signature
     vma_struct_t *inserted = insert_vma(current->process->mm, addr, addr + length, 
-                                       vm_flags, 0, NULL, 0);
+                                       vm_flags | VM_USER | VM_ANONYMOUS, page_prot, NULL, 0);
     if (!inserted) {
         kfree(vma);
         return -LINUX_ENOMEM;
@@ -476,6 +620,92 @@ static int sys_linux_mmap(uint32_t addr, uint32_t length, uint32_t prot,
     return addr;
 }
 
+/**
+ * mmap2: offset in pages. Private file mappings are populated up front by
+ * file_map_private(), so read-only text of shared libraries maps the same
+ * frames in every process. Shared mappings of shm objects fault in the
+ * object's own pages; other writable shared file mappings are not supported.
+ */
+static int sys_linux_mmap2(uint32_t addr, uint32_t length, uint32_t prot,
+                          uint32_t flags, uint32_t fd, uint32_t pgoff) {
+    tcb_t *current = get_current_task();
+    if (!current || !current->process || !current->process->mm) {
+        return -LINUX_ESRCH;
+    }
+    mm_struct_t *mm = current->process->mm;
+
+    length = (length + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    if (length == 0 || length > 0x10000000 || pgoff >= (0xFFFFFFFFu / PAGE_SIZE)) {
+        return -LINUX_EINVAL;
+    }
+
+    if (flags & 0x10) { // MAP_FIXED replaces whatever is there
+        if (addr & (PAGE_SIZE - 1)) return -LINUX_EINVAL;
+        if (!mm_is_user_range(addr, length)) return -LINUX_ENOMEM;
+        if (mm_get_unmapped_area(mm, addr, length) != addr) {
+            remove_vma_range(mm, addr, length);
+        }
+    } else {
+        addr = mm_get_unmapped_area(mm, addr, length);
+        if (addr == 0) return -LINUX_ENOMEM;
+    }
+
+    if (flags & 0x20) { // MAP_ANONYMOUS
+        return sys_linux_mmap(addr, length, prot, flags, fd, 0);
+    }
+    if (fd < MAX_FD && current->process->fd_table[fd] &&
+        io_uring_is_ring(current->process->fd_table[fd]->vfs_file)) {
+        int res = io_uring_mmap(current->process->fd_table[fd]->vfs_file, mm, addr, length, pgoff * PAGE_SIZE);
+        return res < 0 ? res : (int)addr;
+    }
+    if (fd < MAX_FD && current->process->fd_table[fd] && (flags & 0x01) &&
+        shmem_is_shm(current->process->fd_table[fd]->vfs_file)) {
+        sys_file_t *sf = current->process->fd_table[fd];
+        if ((prot & 0x2) && (sf->flags & O_ACCMODE) != O_RDWR) return -LINUX_EACCES;
+        int res = shmem_mmap(sf->vfs_file, mm, addr, length, pgoff * PAGE_SIZE, prot);
+        return res < 0 ? res : (int)addr;
+    }
+    if ((flags & 0x01) && (prot & 0x2)) { // MAP_SHARED with PROT_WRITE
+        return -LINUX_ENODEV;
+    }
+    if (fd >= MAX_FD || !current->process->fd_table[fd] || !current->process->fd_table[fd]->vfs_file) {
+        return -LINUX_EBADF;
+    }
+    file_t *file = current->process->fd_table[fd]->vfs_file;
+
+    struct stat st;
+    if (vfs_fstat(file, &st) != 0) {
+        return -LINUX_EACCES;
+    }
+    if (shmem_is_shm(file)) {
+        // Shared mappings change the object without touching its mtime
+        file_map_invalidate(st.st_dev, st.st_ino);
+    }
+    uint32_t offset = pgoff * PAGE_SIZE;
+    size_t file_bytes = ((off_t)offset < st.st_size) ? MIN((size_t)(st.st_size - offset), (size_t)length) : 0;
+
+    uint32_t vm_flags = VM_USER | VM_FILEBACKED;
+    uint32_t page_prot = PAGE_PRESENT | PAGE_USER;
+    if (prot & 0x1) vm_flags |= VM_READ;
+    if (prot & 0x2) { vm_flags |= VM_WRITE; page_prot |= PAGE_RW; }
+    if (prot & 0x4) vm_flags |= VM_EXEC;
+    else if (g_nx_supported) page_prot |= PAGE_NX_BIT;
+
+    if (!insert_vma(mm, addr, addr + length, vm_flags, page_prot, NULL, offset)) {
+        return -LINUX_ENOMEM;
+    }
+
+    // Mapping reads through the open file; the descriptor's offset is kept
+    off_t saved_pos = vfs_lseek(file, 0, SEEK_CUR);
+    int res = file_map_private(mm->pgd_phys, addr, length, page_prot, file, offset, file_bytes);
+    vfs_lseek(file, saved_pos, SEEK_SET);
+    if (res != 0) {
+        remove_vma_range(mm, addr, length);
+        return (res == FS_ERR_OUT_OF_MEMORY) ? -LINUX_ENOMEM : -LINUX_EIO;
+    }
+    return addr;
+}
+
 static int sys_linux_munmap(uint32_t addr, uint32_t length, uint32_t unused1,
                            uint32_t unused2, uint32_t unused3, uint32_t unused4) {
     (void)unused1; (void)unused2; (void)unused3; (void)unused4;
@@ -583,6 +813,22 @@ static int sys_linux_unlink(uint32_t pathname, uint32_t unused1, uint32_t unused
     return result < 0 ? coalos_to_linux_error(result) : 0;
 }
 
+static int sys_linux_readdir(uint32_t fd, uint32_t dirent, uint32_t count,
+                            uint32_t unused1, uint32_t unused2, uint32_t unused3) {
+    (void)unused1; (void)unused2; (void)unused3;
+    
+    // Native implementation already returns Linux errno values
+    return sys_readdir_impl(fd, dirent, count, NULL);
+}
+
+static int sys_linux_getdents(uint32_t fd, uint32_t dirp, uint32_t count,
+                             uint32_t unused1, uint32_t unused2, uint32_t unused3) {
+    (void)unused1; (void)unused2; (void)unused3;
+    
+    // Native implementation already returns Linux errno values
+    return sys_getdents_impl(fd, dirp, count, NULL);
+}
+
 static int sys_linux_time(uint32_t tloc, uint32_t unused1, uint32_t unused2,
                          uint32_t unused3, uint32_t unused4, uint32_t unused5) {
     (void)unused1; (void)unused2; (void)unused3; (void)unused4; (void)unused5;
@@ -686,6 +932,306 @@ static int sys_linux_nanosleep(uint32_t req, uint32_t rem, uint32_t unused1,
     return 0;
 }
 
+// Timer syscalls: native implementations already return Linux errno values
+
+static int sys_linux_alarm(uint32_t seconds, uint32_t unused1, uint32_t unused2,
+                          uint32_t unused3, uint32_t unused4, uint32_t unused5) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4; (void)unused5;
+    return sys_alarm_impl(seconds, 0, 0, NULL);
+}
+
+static int sys_linux_setitimer(uint32_t which, uint32_t new_value, uint32_t old_value,
+                              uint32_t unused1, uint32_t unused2, uint32_t unused3) {
+    (void)unused1; (void)unused2; (void)unused3;
+    return sys_setitimer_impl(which, new_value, old_value, NULL);
+}
+
+static int sys_linux_getitimer(uint32_t which, uint32_t curr_value, uint32_t unused1,
+                              uint32_t unused2, uint32_t unused3, uint32_t unused4) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4;
+    return sys_getitimer_impl(which, curr_value, 0, NULL);
+}
+
+static int sys_linux_timer_create(uint32_t clockid, uint32_t sevp, uint32_t timerid,
+                                 uint32_t unused1, uint32_t unused2, uint32_t unused3) {
+    (void)unused1; (void)unused2; (void)unused3;
+    return sys_timer_create_impl(clockid, sevp, timerid, NULL);
+}
+
+static int sys_linux_timer_settime(uint32_t timerid, uint32_t flags, uint32_t new_value,
+                                  uint32_t old_value, uint32_t unused1, uint32_t unused2) {
+    (void)unused1; (void)unused2;
+    return sys_timer_settime_impl(timerid, flags, new_value, old_value);
+}
+
+static int sys_linux_timer_gettime(uint32_t timerid, uint32_t curr_value, uint32_t unused1,
+                                  uint32_t unused2, uint32_t unused3, uint32_t unused4) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4;
+    return sys_timer_gettime_impl(timerid, curr_value, 0, NULL);
+}
+
+static int sys_linux_timer_getoverrun(uint32_t timerid, uint32_t unused1, uint32_t unused2,
+                                     uint32_t unused3, uint32_t unused4, uint32_t unused5) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4; (void)unused5;
+    return sys_timer_getoverrun_impl(timerid, 0, 0, NULL);
+}
+
+static int sys_linux_timer_delete(uint32_t timerid, uint32_t unused1, uint32_t unused2,
+                                 uint32_t unused3, uint32_t unused4, uint32_t unused5) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4; (void)unused5;
+    return sys_timer_delete_impl(timerid, 0, 0, NULL);
+}
+
+static int sys_linux_timerfd_create(uint32_t clockid, uint32_t flags, uint32_t unused1,
+                                   uint32_t unused2, uint32_t unused3, uint32_t unused4) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4;
+    return sys_timerfd_create_impl(clockid, flags, 0, NULL);
+}
+
+static int sys_linux_timerfd_settime(uint32_t fd, uint32_t flags, uint32_t new_value,
+                                    uint32_t old_value, uint32_t unused1, uint32_t unused2) {
+    (void)unused1; (void)unused2;
+    return sys_timerfd_settime_impl(fd, flags, new_value, old_value);
+}
+
+static int sys_linux_timerfd_gettime(uint32_t fd, uint32_t curr_value, uint32_t unused1,
+                                    uint32_t unused2, uint32_t unused3, uint32_t unused4) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4;
+    return sys_timerfd_gettime_impl(fd, curr_value, 0, NULL);
+}
+
+static int sys_linux_times(uint32_t buf, uint32_t unused1, uint32_t unused2,
+                          uint32_t unused3, uint32_t unused4, uint32_t unused5) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4; (void)unused5;
+    return sys_times_impl(buf, 0, 0, NULL);
+}
+
+static int sys_linux_getrusage(uint32_t who, uint32_t usage, uint32_t unused1,
+                              uint32_t unused2, uint32_t unused3, uint32_t unused4) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4;
+    return sys_getrusage_impl(who, usage, 0, NULL);
+}
+
+static int sys_linux_clock_gettime(uint32_t clockid, uint32_t tp, uint32_t unused1,
+                                  uint32_t unused2, uint32_t unused3, uint32_t unused4) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4;
+    return sys_clock_gettime_impl(clockid, tp, 0, NULL);
+}
+
+static int sys_linux_clock_getres(uint32_t clockid, uint32_t res, uint32_t unused1,
+                                 uint32_t unused2, uint32_t unused3, uint32_t unused4) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4;
+    return sys_clock_getres_impl(clockid, res, 0, NULL);
+}
+
+static int sys_linux_readv(uint32_t fd, uint32_t iov, uint32_t iovcnt,
+                           uint32_t unused1, uint32_t unused2, uint32_t unused3) {
+    (void)unused1; (void)unused2; (void)unused3;
+    return sys_readv_impl(fd, iov, iovcnt, NULL);
+}
+
+static int sys_linux_writev(uint32_t fd, uint32_t iov, uint32_t iovcnt,
+                            uint32_t unused1, uint32_t unused2, uint32_t unused3) {
+    (void)unused1; (void)unused2; (void)unused3;
+    return sys_writev_impl(fd, iov, iovcnt, NULL);
+}
+
+// The 64-bit position arrives split across two registers, low word first
+static int sys_linux_pread64(uint32_t fd, uint32_t buf, uint32_t count,
+                             uint32_t pos_lo, uint32_t pos_hi, uint32_t unused1) {
+    (void)unused1;
+    return sys_pread64_impl(fd, buf, count, ((uint64_t)pos_hi << 32) | pos_lo);
+}
+
+static int sys_linux_pwrite64(uint32_t fd, uint32_t buf, uint32_t count,
+                              uint32_t pos_lo, uint32_t pos_hi, uint32_t unused1) {
+    (void)unused1;
+    return sys_pwrite64_impl(fd, buf, count, ((uint64_t)pos_hi << 32) | pos_lo);
+}
+
+static int sys_linux_preadv(uint32_t fd, uint32_t iov, uint32_t iovcnt,
+                            uint32_t pos_lo, uint32_t pos_hi, uint32_t unused1) {
+    (void)unused1;
+    return sys_preadv_impl(fd, iov, iovcnt, ((uint64_t)pos_hi << 32) | pos_lo);
+}
+
+static int sys_linux_pwritev(uint32_t fd, uint32_t iov, uint32_t iovcnt,
+                             uint32_t pos_lo, uint32_t pos_hi, uint32_t unused1) {
+    (void)unused1;
+    return sys_pwritev_impl(fd, iov, iovcnt, ((uint64_t)pos_hi << 32) | pos_lo);
+}
+
+static int sys_linux_sendfile(uint32_t out_fd, uint32_t in_fd, uint32_t offset,
+                              uint32_t count, uint32_t unused1, uint32_t unused2) {
+    (void)unused1; (void)unused2;
+    return sys_sendfile_impl(out_fd, in_fd, offset, count, false);
+}
+
+static int sys_linux_sendfile64(uint32_t out_fd, uint32_t in_fd, uint32_t offset,
+                                uint32_t count, uint32_t unused1, uint32_t unused2) {
+    (void)unused1; (void)unused2;
+    return sys_sendfile_impl(out_fd, in_fd, offset, count, true);
+}
+
+// No flags are defined yet
+static int sys_linux_copy_file_range(uint32_t fd_in, uint32_t off_in, uint32_t fd_out,
+                                     uint32_t off_out, uint32_t len, uint32_t flags) {
+    if (flags) return -LINUX_EINVAL;
+    return sys_copy_file_range_impl(fd_in, off_in, fd_out, off_out, len);
+}
+
+static int sys_linux_ftruncate(uint32_t fd, uint32_t length, uint32_t unused1,
+                               uint32_t unused2, uint32_t unused3, uint32_t unused4) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4;
+    if ((int32_t)length < 0) return -LINUX_EINVAL;
+    return sys_ftruncate_impl(fd, length);
+}
+
+// i386 passes the 64-bit length as two registers, low word first
+static int sys_linux_ftruncate64(uint32_t fd, uint32_t length_lo, uint32_t length_hi,
+                                 uint32_t unused1, uint32_t unused2, uint32_t unused3) {
+    (void)unused1; (void)unused2; (void)unused3;
+    if (length_hi & 0x80000000u) return -LINUX_EINVAL;
+    return sys_ftruncate_impl(fd, ((uint64_t)length_hi << 32) | length_lo);
+}
+
+static int sys_linux_ioctl(uint32_t fd, uint32_t cmd, uint32_t arg,
+                           uint32_t unused1, uint32_t unused2, uint32_t unused3) {
+    (void)unused1; (void)unused2; (void)unused3;
+    return sys_ioctl_impl(fd, cmd, arg, NULL);
+}
+
+static int sys_linux_fsync(uint32_t fd, uint32_t unused1, uint32_t unused2,
+                           uint32_t unused3, uint32_t unused4, uint32_t unused5) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4; (void)unused5;
+    return sys_fsync_impl(fd, false);
+}
+
+static int sys_linux_fdatasync(uint32_t fd, uint32_t unused1, uint32_t unused2,
+                               uint32_t unused3, uint32_t unused4, uint32_t unused5) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4; (void)unused5;
+    return sys_fsync_impl(fd, true);
+}
+
+static int sys_linux_sync(uint32_t unused1, uint32_t unused2, uint32_t unused3,
+                          uint32_t unused4, uint32_t unused5, uint32_t unused6) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4; (void)unused5; (void)unused6;
+    return sys_sync_impl();
+}
+
+static int sys_linux_syncfs(uint32_t fd, uint32_t unused1, uint32_t unused2,
+                            uint32_t unused3, uint32_t unused4, uint32_t unused5) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4; (void)unused5;
+    return sys_syncfs_impl(fd);
+}
+
+static int sys_linux_io_uring_setup(uint32_t entries, uint32_t params, uint32_t unused1,
+                                    uint32_t unused2, uint32_t unused3, uint32_t unused4) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4;
+    return sys_io_uring_setup_impl(entries, params);
+}
+
+static int sys_linux_io_uring_enter(uint32_t fd, uint32_t to_submit, uint32_t min_complete,
+                                    uint32_t flags, uint32_t sig, uint32_t unused1) {
+    (void)unused1;
+    if (sig) return -LINUX_EINVAL; // Signal masks during the wait are not supported
+    return sys_io_uring_enter_impl(fd, to_submit, min_complete, flags);
+}
+
+static int sys_linux_socketcall(uint32_t call, uint32_t args, uint32_t unused1,
+                                uint32_t unused2, uint32_t unused3, uint32_t unused4) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4;
+    return sys_socketcall_impl(call, args);
+}
+
+static int sys_linux_socket(uint32_t domain, uint32_t type, uint32_t protocol,
+                            uint32_t unused1, uint32_t unused2, uint32_t unused3) {
+    (void)unused1; (void)unused2; (void)unused3;
+    return sys_socket_impl(domain, type, protocol);
+}
+
+static int sys_linux_socketpair(uint32_t domain, uint32_t type, uint32_t protocol,
+                                uint32_t sv, uint32_t unused1, uint32_t unused2) {
+    (void)unused1; (void)unused2;
+    return sys_socketpair_impl(domain, type, protocol, sv);
+}
+
+static int sys_linux_bind(uint32_t fd, uint32_t addr, uint32_t addrlen,
+                          uint32_t unused1, uint32_t unused2, uint32_t unused3) {
+    (void)unused1; (void)unused2; (void)unused3;
+    return sys_bind_impl(fd, addr, addrlen);
+}
+
+static int sys_linux_connect(uint32_t fd, uint32_t addr, uint32_t addrlen,
+                             uint32_t unused1, uint32_t unused2, uint32_t unused3) {
+    (void)unused1; (void)unused2; (void)unused3;
+    return sys_connect_impl(fd, addr, addrlen);
+}
+
+static int sys_linux_listen(uint32_t fd, uint32_t backlog, uint32_t unused1,
+                            uint32_t unused2, uint32_t unused3, uint32_t unused4) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4;
+    return sys_listen_impl(fd, backlog);
+}
+
+static int sys_linux_accept4(uint32_t fd, uint32_t addr, uint32_t addrlen,
+                             uint32_t flags, uint32_t unused1, uint32_t unused2) {
+    (void)unused1; (void)unused2;
+    return sys_accept4_impl(fd, addr, addrlen, flags);
+}
+
+static int sys_linux_getsockopt(uint32_t fd, uint32_t level, uint32_t optname,
+                                uint32_t optval, uint32_t optlen, uint32_t unused1) {
+    (void)unused1;
+    return sys_getsockopt_impl(fd, level, optname, optval, optlen);
+}
+
+static int sys_linux_setsockopt(uint32_t fd, uint32_t level, uint32_t optname,
+                                uint32_t optval, uint32_t optlen, uint32_t unused1) {
+    (void)unused1;
+    return sys_setsockopt_impl(fd, level, optname, optval, optlen);
+}
+
+static int sys_linux_getsockname(uint32_t fd, uint32_t addr, uint32_t addrlen,
+                                 uint32_t unused1, uint32_t unused2, uint32_t unused3) {
+    (void)unused1; (void)unused2; (void)unused3;
+    return sys_getname_impl(fd, addr, addrlen, false);
+}
+
+static int sys_linux_getpeername(uint32_t fd, uint32_t addr, uint32_t addrlen,
+                                 uint32_t unused1, uint32_t unused2, uint32_t unused3) {
+    (void)unused1; (void)unused2; (void)unused3;
+    return sys_getname_impl(fd, addr, addrlen, true);
+}
+
+static int sys_linux_sendto(uint32_t fd, uint32_t buf, uint32_t len,
+                            uint32_t flags, uint32_t addr, uint32_t addrlen) {
+    return sys_sendto_impl(fd, buf, len, flags, addr, addrlen);
+}
+
+static int sys_linux_sendmsg(uint32_t fd, uint32_t msg, uint32_t flags,
+                             uint32_t unused1, uint32_t unused2, uint32_t unused3) {
+    (void)unused1; (void)unused2; (void)unused3;
+    return sys_sendmsg_impl(fd, msg, flags);
+}
+
+static int sys_linux_recvfrom(uint32_t fd, uint32_t buf, uint32_t len,
+                              uint32_t flags, uint32_t addr, uint32_t addrlen) {
+    return sys_recvfrom_impl(fd, buf, len, flags, addr, addrlen);
+}
+
+static int sys_linux_recvmsg(uint32_t fd, uint32_t msg, uint32_t flags,
+                             uint32_t unused1, uint32_t unused2, uint32_t unused3) {
+    (void)unused1; (void)unused2; (void)unused3;
+    return sys_recvmsg_impl(fd, msg, flags);
+}
+
+static int sys_linux_shutdown(uint32_t fd, uint32_t how, uint32_t unused1,
+                              uint32_t unused2, uint32_t unused3, uint32_t unused4) {
+    (void)unused1; (void)unused2; (void)unused3; (void)unused4;
+    return sys_shutdown_impl(fd, how);
+}
+
 // Additional error code for unimplemented syscalls
 #define LINUX_ENOSYS 38  /* Function not implemented */
 
@@ -699,10 +1245,7 @@ static pcb_t *process_fork(pcb_t *parent) {
 }
 
 static uint32_t find_free_vma_region(mm_struct_t *mm, size_t size) {
-    // TODO: Implement VMA region finding
-    (void)mm;
-    (void)size;
-    return 0x40000000; // Return a placeholder address
+    return mm_get_unmapped_area(mm, 0, size);
 }
 
 // vfs_mkdir, vfs_rmdir, and vfs_unlink are now implemented in vfs.c
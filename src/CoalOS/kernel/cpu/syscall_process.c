@@ -90,6 +90,7 @@ int32_t sys_fork_impl(uint32_t arg1, uint32_t arg2, uint32_t arg3, isr_frame_t *
     
     // Set parent-child relationship
     child->ppid = parent->pid;
+    memcpy(child->comm, parent->comm, sizeof(child->comm));
     
     // TODO: Add child to scheduler
     // scheduler_add_task(child);
@@ -48,24 +48,13 @@ int strncpy_from_user_safe(const_userptr_t u_src, char *k_dst, size_t maxlen);
  */
 static inline bool syscall_validate_string_len(const_userptr_t ptr, size_t max_len)
 {
-    if (!ptr || !access_ok(VERIFY_READ, ptr, 1)) {
+    if (!ptr || max_len == 0) {
         return false;
     }
     
-    // Check string length without copying entire string
-    size_t len = 0;
-    while (len < max_len) {
-        char c;
-        if (copy_from_user(&c, (const_userptr_t)((const char*)ptr + len), 1) != 0) {
-            return false; // Page fault or invalid memory
-        }
-        if (c == '\0') {
-            return true; // Found null terminator within limit
-        }
-        len++;
-    }
-    
-    return false; // String too long
+    // Terminator must appear within max_len bytes; faults report as negative
+    long len = strnlen_user(ptr, max_len);
+    return len >= 0 && (size_t)len < max_len;
 }
 
 /**
@@ -0,0 +1,620 @@
+/**
+ * @file syscall_socket.c
+ * @brief Socket System Call Implementations
+ *
+ * @details Translates the Linux i386 socket ABI to the AF_UNIX core. User
+ * addresses and control messages are copied into kernel buffers here, so
+ * af_unix.c only ever sees kernel memory apart from the payload iovecs.
+ */
+
+//============================================================================
+// Includes
+//============================================================================
+#include "syscall_socket.h"
+#include "af_unix.h"
+#include "syscall_security.h"
+#include <kernel/process/process.h>
+#include <kernel/fs/vfs/sys_file.h>
+#include <kernel/fs/vfs/fs_errno.h>
+#include <kernel/memory/uaccess.h>
+#include <kernel/memory/kmalloc.h>
+#include <kernel/sync/spinlock.h>
+#include <kernel/lib/string.h>
+
+//============================================================================
+// Configuration
+//============================================================================
+#define SOCKET_IOV_MAX      1024    // Linux UIO_MAXIOV
+#define SOCKET_CONTROL_MAX  4096    // Control buffer accepted by sendmsg()
+#define SOCKET_OPT_MAX      16      // Largest option value (struct ucred)
+
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+// socketcall() operations
+#define SYS_SOCKET          1
+#define SYS_BIND            2
+#define SYS_CONNECT         3
+#define SYS_LISTEN          4
+#define SYS_ACCEPT          5
+#define SYS_GETSOCKNAME     6
+#define SYS_GETPEERNAME     7
+#define SYS_SOCKETPAIR      8
+#define SYS_SEND            9
+#define SYS_RECV            10
+#define SYS_SENDTO          11
+#define SYS_RECVFROM        12
+#define SYS_SHUTDOWN        13
+#define SYS_SETSOCKOPT      14
+#define SYS_GETSOCKOPT      15
+#define SYS_SENDMSG         16
+#define SYS_RECVMSG         17
+#define SYS_ACCEPT4         18
+
+//============================================================================
+// Types (Linux i386 layout)
+//============================================================================
+
+typedef struct {
+    uint32_t msg_name;
+    uint32_t msg_namelen;
+    uint32_t msg_iov;
+    uint32_t msg_iovlen;
+    uint32_t msg_control;
+    uint32_t msg_controllen;
+    int32_t  msg_flags;
+} k_msghdr_t;
+
+typedef struct {
+    uint32_t cmsg_len;
+    int32_t  cmsg_level;
+    int32_t  cmsg_type;
+} k_cmsghdr_t;
+
+#define CMSG_ALIGN(len)     (((len) + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1))
+#define CMSG_LEN(len)       (sizeof(k_cmsghdr_t) + (len))
+#define CMSG_SPACE(len)     (sizeof(k_cmsghdr_t) + CMSG_ALIGN(len))
+
+//============================================================================
+// Helpers
+//============================================================================
+
+file_t *socket_file_get(int fd) {
+    pcb_t *proc = get_current_process();
+    if (!proc || fd < 0 || fd >= MAX_FD) return NULL;
+
+    file_t *file = NULL;
+    uintptr_t irq = spinlock_acquire_irqsave(&proc->fd_table_lock);
+    sys_file_t *sf = proc->fd_table[fd];
+    if (sf && unix_is_socket(sf->vfs_file)) file = vfs_file_get(sf->vfs_file);
+    spinlock_release_irqrestore(&proc->fd_table_lock, irq);
+    return file;
+}
+
+// socket_file_get() with the errno a socket syscall reports
+static file_t *socket_lookup(uint32_t fd, int *err) {
+    file_t *file = socket_file_get((int)fd);
+    if (file) return file;
+
+    pcb_t *proc = get_current_process();
+    *err = (proc && fd < MAX_FD && proc->fd_table[fd]) ? -ENOTSOCK : -EBADF;
+    return NULL;
+}
+
+static int socket_copy_addr_in(uint32_t user_addr, uint32_t addrlen, k_sockaddr_un_t *addr) {
+    if (addrlen > sizeof(*addr)) return -EINVAL;
+    if (addrlen < sizeof(uint16_t)) return -EINVAL;
+    memset(addr, 0, sizeof(*addr));
+    if (copy_from_user((kernelptr_t)addr, (const_userptr_t)(uintptr_t)user_addr, addrlen) != 0) return -EFAULT;
+    return 0;
+}
+
+/*
+ * Reports an address through a user sockaddr plus socklen_t pair: the name
+ * is truncated to the caller's buffer, the length written back is the full
+ * one.
+ */
+static int socket_copy_addr_out(const k_sockaddr_un_t *addr, uint32_t len,
+                                uint32_t user_addr, uint32_t user_addrlen) {
+    if (!user_addr) return 0;
+    int32_t room;
+    if (copy_from_user((kernelptr_t)&room, (const_userptr_t)(uintptr_t)user_addrlen, sizeof(room)) != 0) {
+        return -EFAULT;
+    }
+    if (room < 0) return -EINVAL;
+    uint32_t n = MIN((uint32_t)room, len);
+    if (n && copy_to_user((userptr_t)(uintptr_t)user_addr, (const_kernelptr_t)addr, n) != 0) return -EFAULT;
+    if (copy_to_user((userptr_t)(uintptr_t)user_addrlen, (const_kernelptr_t)&len, sizeof(len)) != 0) return -EFAULT;
+    return 0;
+}
+
+// Copies and validates a user iovec array; the caller frees *out
+static int socket_copy_iov(uint32_t user_iov, uint32_t iovcnt, bool writable, k_iovec_t **out) {
+    *out = NULL;
+    if (iovcnt > SOCKET_IOV_MAX) return -EMSGSIZE;
+    if (iovcnt == 0) return 0;
+
+    k_iovec_t *iov = kmalloc(iovcnt * sizeof(*iov));
+    if (!iov) return -ENOMEM;
+    if (copy_from_user((kernelptr_t)iov, (const_userptr_t)(uintptr_t)user_iov, iovcnt * sizeof(*iov)) != 0) {
+        kfree(iov);
+        return -EFAULT;
+    }
+    size_t total = 0;
+    for (uint32_t i = 0; i < iovcnt; i++) {
+        if ((int32_t)iov[i].iov_len < 0 || total + iov[i].iov_len > (size_t)INT32_MAX) {
+            kfree(iov);
+            return -EINVAL;
+        }
+        if (iov[i].iov_len && !syscall_validate_buffer((userptr_t)(uintptr_t)iov[i].iov_base, iov[i].iov_len, writable)) {
+            kfree(iov);
+            return -EFAULT;
+        }
+        total += iov[i].iov_len;
+    }
+    *out = iov;
+    return 0;
+}
+
+static void socket_scm_release(unix_scm_t *scm) {
+    for (uint32_t i = 0; i < scm->nr_files; i++) {
+        if (scm->files[i]) vfs_close(scm->files[i]);
+    }
+    scm->nr_files = 0;
+}
+
+// Takes a reference on the file behind each descriptor of an SCM_RIGHTS message
+static int socket_scm_add_fds(unix_scm_t *scm, const int32_t *fds, uint32_t count) {
+    pcb_t *proc = get_current_process();
+    if (!proc) return -EFAULT;
+    if (scm->nr_files + count > SCM_MAX_FD) return -EINVAL;
+
+    int err = 0;
+    uintptr_t irq = spinlock_acquire_irqsave(&proc->fd_table_lock);
+    for (uint32_t i = 0; i < count; i++) {
+        int fd = fds[i];
+        if (fd < 0 || fd >= MAX_FD || !proc->fd_table[fd]) {
+            err = -EBADF;
+            break;
+        }
+        scm->files[scm->nr_files] = vfs_file_get(proc->fd_table[fd]->vfs_file);
+        scm->file_flags[scm->nr_files] = proc->fd_table[fd]->flags;
+        scm->nr_files++;
+    }
+    spinlock_release_irqrestore(&proc->fd_table_lock, irq);
+    return err;
+}
+
+// Parses a sendmsg() control buffer into scm
+static int socket_parse_control(uint32_t user_control, uint32_t controllen, unix_scm_t *scm) {
+    if (controllen == 0) return 0;
+    if (controllen > SOCKET_CONTROL_MAX) return -ENOBUFS;
+
+    uint8_t *control = kmalloc(controllen);
+    if (!control) return -ENOMEM;
+    if (copy_from_user((kernelptr_t)control, (const_userptr_t)(uintptr_t)user_control, controllen) != 0) {
+        kfree(control);
+        return -EFAULT;
+    }
+
+    int err = 0;
+    uint32_t off = 0;
+    while (!err && off + sizeof(k_cmsghdr_t) <= controllen) {
+        k_cmsghdr_t cmsg;
+        memcpy(&cmsg, control + off, sizeof(cmsg));
+        if (cmsg.cmsg_len < sizeof(cmsg) || cmsg.cmsg_len > controllen - off) {
+            err = -EINVAL;
+            break;
+        }
+        const uint8_t *data = control + off + sizeof(cmsg);
+        uint32_t data_len = cmsg.cmsg_len - sizeof(cmsg);
+
+        if (cmsg.cmsg_level != SOL_SOCKET) {
+            err = -EINVAL;
+        } else if (cmsg.cmsg_type == SCM_RIGHTS) {
+            if (data_len % sizeof(int32_t) != 0 || data_len == 0) err = -EINVAL;
+            else err = socket_scm_add_fds(scm, (const int32_t *)data, data_len / sizeof(int32_t));
+        } else if (cmsg.cmsg_type == SCM_CREDENTIALS) {
+            if (data_len != sizeof(k_ucred_t)) {
+                err = -EINVAL;
+            } else {
+                memcpy(&scm->cred, data, sizeof(k_ucred_t));
+                scm->has_cred = true;
+            }
+        } else {
+            err = -EINVAL;
+        }
+        off += CMSG_ALIGN(cmsg.cmsg_len);
+    }
+
+    kfree(control);
+    return err;
+}
+
+/*
+ * Writes received control data to the user's buffer: passed descriptors are
+ * installed first, then the credentials. What does not fit sets MSG_CTRUNC.
+ * Returns the control bytes used.
+ */
+static uint32_t socket_put_control(unix_scm_t *scm, uint32_t user_control, uint32_t controllen,
+                                   int msg_flags_in, int *msg_flags) {
+    uint32_t used = 0;
+
+    if (scm->nr_files) {
+        int32_t fds[SCM_MAX_FD];
+        uint32_t installed = 0;
+        for (uint32_t i = 0; i < scm->nr_files; i++) {
+            file_t *file = scm->files[i];
+            scm->files[i] = NULL;
+            if (installed < i) {
+                // An earlier install failed: drop the rest
+                vfs_close(file);
+                continue;
+            }
+            int fd = sys_file_install(file, scm->file_flags[i]);   // Closes file on failure
+            if (fd < 0) {
+                *msg_flags |= MSG_CTRUNC;
+                continue;
+            }
+            fds[installed++] = fd;
+        }
+        scm->nr_files = 0;
+        (void)msg_flags_in;     // MSG_CMSG_CLOEXEC: descriptors carry no close-on-exec flag yet
+
+        if (installed) {
+            k_cmsghdr_t cmsg = { CMSG_LEN(installed * sizeof(int32_t)), SOL_SOCKET, SCM_RIGHTS };
+            if (copy_to_user((userptr_t)(uintptr_t)user_control, (const_kernelptr_t)&cmsg, sizeof(cmsg)) != 0 ||
+                copy_to_user((userptr_t)(uintptr_t)(user_control + sizeof(cmsg)), (const_kernelptr_t)fds,
+                             installed * sizeof(int32_t)) != 0) {
+                *msg_flags |= MSG_CTRUNC;
+            } else {
+                used += MIN(CMSG_SPACE(installed * sizeof(int32_t)), controllen);
+            }
+        }
+    }
+
+    if (scm->has_cred) {
+        if (used + CMSG_LEN(sizeof(k_ucred_t)) > controllen) {
+            *msg_flags |= MSG_CTRUNC;
+        } else {
+            k_cmsghdr_t cmsg = { CMSG_LEN(sizeof(k_ucred_t)), SOL_SOCKET, SCM_CREDENTIALS };
+            uint32_t at = user_control + used;
+            if (copy_to_user((userptr_t)(uintptr_t)at, (const_kernelptr_t)&cmsg, sizeof(cmsg)) == 0 &&
+                copy_to_user((userptr_t)(uintptr_t)(at + sizeof(cmsg)), (const_kernelptr_t)&scm->cred,
+                             sizeof(k_ucred_t)) == 0) {
+                used += MIN(CMSG_SPACE(sizeof(k_ucred_t)), controllen - used);
+            } else {
+                *msg_flags |= MSG_CTRUNC;
+            }
+        }
+    }
+    return used;
+}
+
+//============================================================================
+// Socket System Call Implementation
+//============================================================================
+
+int32_t sys_socket_impl(uint32_t domain, uint32_t type, uint32_t protocol)
+{
+    if (domain != AF_UNIX) return -EAFNOSUPPORT;
+    if (protocol != 0) return -EPROTONOSUPPORT;
+    return unix_socket_create((int)type);
+}
+
+int32_t sys_socketpair_impl(uint32_t domain, uint32_t type, uint32_t protocol, uint32_t user_sv)
+{
+    if (domain != AF_UNIX) return -EAFNOSUPPORT;
+    if (protocol != 0) return -EPROTONOSUPPORT;
+    if (!syscall_validate_buffer((userptr_t)(uintptr_t)user_sv, 2 * sizeof(int32_t), true)) return -EFAULT;
+
+    int fds[2];
+    int err = unix_socketpair((int)type, fds);
+    if (err) return err;
+    int32_t sv[2] = { fds[0], fds[1] };
+    if (copy_to_user((userptr_t)(uintptr_t)user_sv, (const_kernelptr_t)sv, sizeof(sv)) != 0) {
+        sys_close(fds[0]);
+        sys_close(fds[1]);
+        return -EFAULT;
+    }
+    return 0;
+}
+
+int32_t sys_bind_impl(uint32_t fd, uint32_t user_addr, uint32_t addrlen)
+{
+    k_sockaddr_un_t addr;
+    int err = socket_copy_addr_in(user_addr, addrlen, &addr);
+    if (err) return err;
+    file_t *file = socket_lookup(fd, &err);
+    if (!file) return err;
+    err = unix_bind(file, &addr, addrlen);
+    vfs_close(file);
+    return err;
+}
+
+int32_t sys_connect_impl(uint32_t fd, uint32_t user_addr, uint32_t addrlen)
+{
+    k_sockaddr_un_t addr;
+    int err = socket_copy_addr_in(user_addr, addrlen, &addr);
+    if (err) return err;
+    file_t *file = socket_lookup(fd, &err);
+    if (!file) return err;
+    err = unix_connect(file, &addr, addrlen);
+    vfs_close(file);
+    return err;
+}
+
+int32_t sys_listen_impl(uint32_t fd, uint32_t backlog)
+{
+    int err;
+    file_t *file = socket_lookup(fd, &err);
+    if (!file) return err;
+    err = unix_listen(file, (int)backlog);
+    vfs_close(file);
+    return err;
+}
+
+int32_t sys_accept4_impl(uint32_t fd, uint32_t user_addr, uint32_t user_addrlen, uint32_t flags)
+{
+    if (user_addr && !user_addrlen) return -EFAULT;
+    int err;
+    file_t *file = socket_lookup(fd, &err);
+    if (!file) return err;
+
+    k_sockaddr_un_t addr;
+    uint32_t len = sizeof(addr);
+    int newfd = unix_accept(file, (int)flags, &addr, &len);
+    vfs_close(file);
+    if (newfd < 0) return newfd;
+
+    err = socket_copy_addr_out(&addr, len, user_addr, user_addrlen);
+    if (err) {
+        sys_close(newfd);
+        return err;
+    }
+    return newfd;
+}
+
+int32_t sys_getname_impl(uint32_t fd, uint32_t user_addr, uint32_t user_addrlen, bool peer)
+{
+    if (!user_addr || !user_addrlen) return -EFAULT;
+    int err;
+    file_t *file = socket_lookup(fd, &err);
+    if (!file) return err;
+
+    k_sockaddr_un_t addr;
+    uint32_t len = sizeof(addr);
+    err = unix_getname(file, peer, &addr, &len);
+    vfs_close(file);
+    if (err) return err;
+    return socket_copy_addr_out(&addr, len, user_addr, user_addrlen);
+}
+
+int32_t sys_sendto_impl(uint32_t fd, uint32_t user_buf, uint32_t len, uint32_t flags,
+                        uint32_t user_addr, uint32_t addrlen)
+{
+    if ((int32_t)len < 0) return -EINVAL;
+    if (len && !syscall_validate_buffer((userptr_t)(uintptr_t)user_buf, len, false)) return -EFAULT;
+
+    k_sockaddr_un_t addr;
+    int err;
+    if (user_addr) {
+        err = socket_copy_addr_in(user_addr, addrlen, &addr);
+        if (err) return err;
+    }
+    file_t *file = socket_lookup(fd, &err);
+    if (!file) return err;
+
+    k_iovec_t iov = { user_buf, len };
+    ssize_t res = unix_sendmsg(file, &iov, 1, user_addr ? &addr : NULL, addrlen, NULL, (int)flags);
+    vfs_close(file);
+    return (int32_t)res;
+}
+
+int32_t sys_recvfrom_impl(uint32_t fd, uint32_t user_buf, uint32_t len, uint32_t flags,
+                          uint32_t user_addr, uint32_t user_addrlen)
+{
+    if ((int32_t)len < 0) return -EINVAL;
+    if (len && !syscall_validate_buffer((userptr_t)(uintptr_t)user_buf, len, true)) return -EFAULT;
+    if (user_addr && !user_addrlen) return -EFAULT;
+
+    int err;
+    file_t *file = socket_lookup(fd, &err);
+    if (!file) return err;
+
+    k_iovec_t iov = { user_buf, len };
+    k_sockaddr_un_t addr;
+    uint32_t addr_len = sizeof(addr);
+    ssize_t res = unix_recvmsg(file, &iov, 1, &addr, &addr_len, NULL, NULL, (int)flags);
+    vfs_close(file);
+
+    // Connected stream sockets report no sender
+    if (res >= 0 && user_addr && addr_len) {
+        err = socket_copy_addr_out(&addr, addr_len, user_addr, user_addrlen);
+        if (err) return err;
+    } else if (res >= 0 && user_addr) {
+        uint32_t zero = 0;
+        if (copy_to_user((userptr_t)(uintptr_t)user_addrlen, (const_kernelptr_t)&zero, sizeof(zero)) != 0) return -EFAULT;
+    }
+    return (int32_t)res;
+}
+
+int32_t sys_sendmsg_impl(uint32_t fd, uint32_t user_msg, uint32_t flags)
+{
+    k_msghdr_t msg;
+    if (copy_from_user((kernelptr_t)&msg, (const_userptr_t)(uintptr_t)user_msg, sizeof(msg)) != 0) return -EFAULT;
+
+    k_sockaddr_un_t addr;
+    int err;
+    if (msg.msg_name) {
+        err = socket_copy_addr_in(msg.msg_name, msg.msg_namelen, &addr);
+        if (err) return err;
+    }
+
+    k_iovec_t *iov;
+    err = socket_copy_iov(msg.msg_iov, msg.msg_iovlen, false, &iov);
+    if (err) return err;
+
+    // Too large for the stack: SCM_MAX_FD references
+    unix_scm_t *scm = kmalloc(sizeof(*scm));
+    if (!scm) {
+        if (iov) kfree(iov);
+        return -ENOMEM;
+    }
+    memset(scm, 0, sizeof(*scm));
+
+    ssize_t res = socket_parse_control(msg.msg_control, msg.msg_controllen, scm);
+    file_t *file = res ? NULL : socket_lookup(fd, &err);
+    if (!res && !file) res = err;
+    if (file) {
+        res = unix_sendmsg(file, iov, msg.msg_iovlen, msg.msg_name ? &addr : NULL, msg.msg_namelen,
+                           scm, (int)flags);
+        vfs_close(file);
+    }
+
+    socket_scm_release(scm);    // References the socket layer did not take over
+    kfree(scm);
+    if (iov) kfree(iov);
+    return (int32_t)res;
+}
+
+int32_t sys_recvmsg_impl(uint32_t fd, uint32_t user_msg, uint32_t flags)
+{
+    k_msghdr_t msg;
+    if (copy_from_user((kernelptr_t)&msg, (const_userptr_t)(uintptr_t)user_msg, sizeof(msg)) != 0) return -EFAULT;
+    if ((int32_t)msg.msg_namelen < 0 || (int32_t)msg.msg_controllen < 0) return -EINVAL;
+
+    k_iovec_t *iov;
+    int err = socket_copy_iov(msg.msg_iov, msg.msg_iovlen, true, &iov);
+    if (err) return err;
+
+    unix_scm_t *scm = kmalloc(sizeof(*scm));
+    if (!scm) {
+        if (iov) kfree(iov);
+        return -ENOMEM;
+    }
+    memset(scm, 0, sizeof(*scm));
+    if (msg.msg_control && msg.msg_controllen >= CMSG_LEN(sizeof(int32_t))) {
+        scm->max_files = MIN((msg.msg_controllen - CMSG_LEN(0)) / sizeof(int32_t), (uint32_t)SCM_MAX_FD);
+    }
+
+    k_sockaddr_un_t addr;
+    uint32_t addr_len = sizeof(addr);
+    int msg_flags = 0;
+    ssize_t res;
+    file_t *file = socket_lookup(fd, &err);
+    if (!file) {
+        res = err;
+    } else {
+        res = unix_recvmsg(file, iov, msg.msg_iovlen, &addr, &addr_len, scm, &msg_flags, (int)flags);
+        vfs_close(file);
+    }
+
+    if (res >= 0) {
+        uint32_t namelen = 0;
+        if (msg.msg_name && addr_len) {
+            namelen = addr_len;
+            if (copy_to_user((userptr_t)(uintptr_t)msg.msg_name, (const_kernelptr_t)&addr,
+                             MIN(msg.msg_namelen, addr_len)) != 0) {
+                res = -EFAULT;
+            }
+        }
+        uint32_t controllen = msg.msg_control ?
+            socket_put_control(scm, msg.msg_control, msg.msg_controllen, (int)flags, &msg_flags) : 0;
+        if (!msg.msg_control && (scm->nr_files || scm->has_cred)) msg_flags |= MSG_CTRUNC;
+
+        // Write back the lengths and flags in place
+        msg.msg_namelen = namelen;
+        msg.msg_controllen = controllen;
+        msg.msg_flags = msg_flags;
+        if (res >= 0 && copy_to_user((userptr_t)(uintptr_t)user_msg, (const_kernelptr_t)&msg, sizeof(msg)) != 0) {
+            res = -EFAULT;
+        }
+    }
+
+    socket_scm_release(scm);
+    kfree(scm);
+    if (iov) kfree(iov);
+    return (int32_t)res;
+}
+
+int32_t sys_shutdown_impl(uint32_t fd, uint32_t how)
+{
+    int err;
+    file_t *file = socket_lookup(fd, &err);
+    if (!file) return err;
+    err = unix_shutdown(file, (int)how);
+    vfs_close(file);
+    return err;
+}
+
+int32_t sys_setsockopt_impl(uint32_t fd, uint32_t level, uint32_t optname, uint32_t user_val, uint32_t optlen)
+{
+    uint8_t val[SOCKET_OPT_MAX];
+    if ((int32_t)optlen < 0) return -EINVAL;
+    uint32_t len = MIN(optlen, (uint32_t)sizeof(val));
+    if (len && copy_from_user((kernelptr_t)val, (const_userptr_t)(uintptr_t)user_val, len) != 0) return -EFAULT;
+
+    int err;
+    file_t *file = socket_lookup(fd, &err);
+    if (!file) return err;
+    err = unix_setsockopt(file, (int)level, (int)optname, val, len);
+    vfs_close(file);
+    return err;
+}
+
+int32_t sys_getsockopt_impl(uint32_t fd, uint32_t level, uint32_t optname, uint32_t user_val, uint32_t user_optlen)
+{
+    int32_t room;
+    if (copy_from_user((kernelptr_t)&room, (const_userptr_t)(uintptr_t)user_optlen, sizeof(room)) != 0) return -EFAULT;
+    if (room < 0) return -EINVAL;
+
+    int err;
+    file_t *file = socket_lookup(fd, &err);
+    if (!file) return err;
+
+    uint8_t val[SOCKET_OPT_MAX];
+    uint32_t len = MIN((uint32_t)room, (uint32_t)sizeof(val));
+    err = unix_getsockopt(file, (int)level, (int)optname, val, &len);
+    vfs_close(file);
+    if (err) return err;
+
+    if (len && copy_to_user((userptr_t)(uintptr_t)user_val, (const_kernelptr_t)val, len) != 0) return -EFAULT;
+    if (copy_to_user((userptr_t)(uintptr_t)user_optlen, (const_kernelptr_t)&len, sizeof(len)) != 0) return -EFAULT;
+    return 0;
+}
+
+int32_t sys_socketcall_impl(uint32_t call, uint32_t user_args)
+{
+    // Argument words per operation, indexed by SYS_*
+    static const uint8_t nargs[] = { 0, 3, 3, 3, 2, 3, 3, 3, 4, 4, 4, 6, 6, 2, 5, 5, 3, 3, 4 };
+    if (call < SYS_SOCKET || call > SYS_ACCEPT4) return -EINVAL;
+
+    uint32_t a[6] = { 0 };
+    if (copy_from_user((kernelptr_t)a, (const_userptr_t)(uintptr_t)user_args, nargs[call] * sizeof(uint32_t)) != 0) {
+        return -EFAULT;
+    }
+
+    switch (call) {
+        case SYS_SOCKET:      return sys_socket_impl(a[0], a[1], a[2]);
+        case SYS_BIND:        return sys_bind_impl(a[0], a[1], a[2]);
+        case SYS_CONNECT:     return sys_connect_impl(a[0], a[1], a[2]);
+        case SYS_LISTEN:      return sys_listen_impl(a[0], a[1]);
+        case SYS_ACCEPT:      return sys_accept4_impl(a[0], a[1], a[2], 0);
+        case SYS_GETSOCKNAME: return sys_getname_impl(a[0], a[1], a[2], false);
+        case SYS_GETPEERNAME: return sys_getname_impl(a[0], a[1], a[2], true);
+        case SYS_SOCKETPAIR:  return sys_socketpair_impl(a[0], a[1], a[2], a[3]);
+        case SYS_SEND:        return sys_sendto_impl(a[0], a[1], a[2], a[3], 0, 0);
+        case SYS_RECV:        return sys_recvfrom_impl(a[0], a[1], a[2], a[3], 0, 0);
+        case SYS_SENDTO:      return sys_sendto_impl(a[0], a[1], a[2], a[3], a[4], a[5]);
+        case SYS_RECVFROM:    return sys_recvfrom_impl(a[0], a[1], a[2], a[3], a[4], a[5]);
+        case SYS_SHUTDOWN:    return sys_shutdown_impl(a[0], a[1]);
+        case SYS_SETSOCKOPT:  return sys_setsockopt_impl(a[0], a[1], a[2], a[3], a[4]);
+        case SYS_GETSOCKOPT:  return sys_getsockopt_impl(a[0], a[1], a[2], a[3], a[4]);
+        case SYS_SENDMSG:     return sys_sendmsg_impl(a[0], a[1], a[2]);
+        case SYS_RECVMSG:     return sys_recvmsg_impl(a[0], a[1], a[2]);
+        case SYS_ACCEPT4:     return sys_accept4_impl(a[0], a[1], a[2], a[3]);
+        default:              return -EINVAL;
+    }
+}
@@ -0,0 +1,103 @@
+/**
+ * @file syscall_socket.h
+ * @brief Socket System Call Implementations
+ *
+ * @details Linux i386 socket ABI: the individual socket syscalls and the
+ * socketcall() multiplexer older C libraries use. Only AF_UNIX is
+ * implemented (see af_unix.h); this layer copies addresses, iovecs and
+ * control messages between user space and the socket core.
+ */
+
+#ifndef SYSCALL_SOCKET_H
+#define SYSCALL_SOCKET_H
+
+//============================================================================
+// Includes
+//============================================================================
+#include <kernel/fs/vfs/vfs.h>
+#include <libc/stdint.h>
+#include <libc/stdbool.h>
+
+//============================================================================
+// Descriptor Lookup
+//============================================================================
+
+/**
+ * @brief Returns the socket behind fd with a reference held
+ * @return The file (release with vfs_close()), or NULL if fd is not a socket
+ */
+file_t *socket_file_get(int fd);
+
+//============================================================================
+// Socket System Call Functions
+//============================================================================
+
+/**
+ * @brief Create a socket
+ * @param domain Address family; only AF_UNIX
+ * @param type SOCK_STREAM, SOCK_DGRAM or SOCK_SEQPACKET, plus SOCK_NONBLOCK / SOCK_CLOEXEC
+ * @param protocol Must be 0
+ * @return File descriptor on success, negative error code on failure
+ */
+int32_t sys_socket_impl(uint32_t domain, uint32_t type, uint32_t protocol);
+
+/**
+ * @brief Create a pair of connected sockets
+ * @param user_sv User space int[2] receiving the descriptors
+ * @return 0 on success, negative error code on failure
+ */
+int32_t sys_socketpair_impl(uint32_t domain, uint32_t type, uint32_t protocol, uint32_t user_sv);
+
+int32_t sys_bind_impl(uint32_t fd, uint32_t user_addr, uint32_t addrlen);
+int32_t sys_connect_impl(uint32_t fd, uint32_t user_addr, uint32_t addrlen);
+int32_t sys_listen_impl(uint32_t fd, uint32_t backlog);
+
+/**
+ * @brief Accept a pending connection
+ * @param user_addr Optional buffer for the peer's address
+ * @param user_addrlen socklen_t in/out, required if user_addr is set
+ * @param flags SOCK_NONBLOCK / SOCK_CLOEXEC
+ * @return New file descriptor on success, negative error code on failure
+ */
+int32_t sys_accept4_impl(uint32_t fd, uint32_t user_addr, uint32_t user_addrlen, uint32_t flags);
+
+/** @brief getsockname() (peer false) or getpeername() (peer true) */
+int32_t sys_getname_impl(uint32_t fd, uint32_t user_addr, uint32_t user_addrlen, bool peer);
+
+/**
+ * @brief Send from one buffer, optionally to an address (send() when user_addr is 0)
+ * @return Bytes sent, or negative error code
+ */
+int32_t sys_sendto_impl(uint32_t fd, uint32_t user_buf, uint32_t len, uint32_t flags,
+                        uint32_t user_addr, uint32_t addrlen);
+
+/**
+ * @brief Receive into one buffer, optionally reporting the sender (recv() when user_addr is 0)
+ * @return Bytes received, or negative error code
+ */
+int32_t sys_recvfrom_impl(uint32_t fd, uint32_t user_buf, uint32_t len, uint32_t flags,
+                          uint32_t user_addr, uint32_t user_addrlen);
+
+/**
+ * @brief Send a message with iovecs and SCM_RIGHTS / SCM_CREDENTIALS control data
+ * @return Bytes sent, or negative error code
+ */
+int32_t sys_sendmsg_impl(uint32_t fd, uint32_t user_msg, uint32_t flags);
+
+/**
+ * @brief Receive a message; passed descriptors are installed in the caller
+ * @return Bytes received, or negative error code
+ */
+int32_t sys_recvmsg_impl(uint32_t fd, uint32_t user_msg, uint32_t flags);
+
+int32_t sys_shutdown_impl(uint32_t fd, uint32_t how);
+int32_t sys_setsockopt_impl(uint32_t fd, uint32_t level, uint32_t optname, uint32_t user_val, uint32_t optlen);
+int32_t sys_getsockopt_impl(uint32_t fd, uint32_t level, uint32_t optname, uint32_t user_val, uint32_t user_optlen);
+
+/**
+ * @brief socketcall(): runs socket operation call with arguments read from user_args
+ * @return The operation's result, or negative error code
+ */
+int32_t sys_socketcall_impl(uint32_t call, uint32_t user_args);
+
+#endif // SYSCALL_SOCKET_H
@@ -93,15 +93,8 @@ int32_t sys_kill_impl(uint32_t pid, uint32_t sig, uint32_t arg3, isr_frame_t *re
 //============================================================================
 // File System Operations Stubs
 //============================================================================
-// NOTE: sys_chdir, sys_getcwd, sys_stat, sys_mkdir, sys_rmdir, sys_unlink
-// are now implemented in syscall_filesystem.c
-
-int32_t sys_readdir_impl(uint32_t fd, uint32_t user_buf_ptr, uint32_t count, isr_frame_t *regs)
-{
-    (void)fd; (void)user_buf_ptr; (void)count; (void)regs;
-    serial_write("[Syscall] sys_readdir not implemented\n");
-    return -ENOSYS;
-}
+// NOTE: sys_chdir, sys_getcwd, sys_stat, sys_mkdir, sys_rmdir, sys_unlink,
+// sys_readdir and sys_getdents are now implemented in syscall_filesystem.c
 
 //============================================================================
 // Process Groups and Sessions Stubs
@@ -142,20 +135,6 @@ int32_t sys_getpgrp_impl(uint32_t arg1, uint32_t arg2, uint32_t arg3, isr_frame_
     return -ENOSYS;
 }
 
-int32_t sys_tcsetpgrp_impl(uint32_t fd, uint32_t pgid, uint32_t arg3, isr_frame_t *regs)
-{
-    (void)fd; (void)pgid; (void)arg3; (void)regs;
-    serial_write("[Syscall] sys_tcsetpgrp not implemented\n");
-    return -ENOSYS;
-}
-
-int32_t sys_tcgetpgrp_impl(uint32_t fd, uint32_t arg2, uint32_t arg3, isr_frame_t *regs)
-{
-    (void)fd; (void)arg2; (void)arg3; (void)regs;
-    serial_write("[Syscall] sys_tcgetpgrp not implemented\n");
-    return -ENOSYS;
-}
-
 //============================================================================
 // Memory Management Stubs
 //============================================================================
@@ -0,0 +1,366 @@
+/**
+ * @file syscall_timer.c
+ * @brief Timer System Call Implementations
+ *
+ * @details Copies the i386 user structures in and out and hands the work to
+ * the per-process timer module (itimer.c), the timerfd driver and the CPU
+ * time accounting (cputime.c).
+ */
+
+//============================================================================
+// Includes
+//============================================================================
+#include "syscall_timer.h"
+#include <kernel/process/process.h>
+#include <kernel/process/itimer.h>
+#include <kernel/process/signal.h>
+#include <kernel/process/cputime.h>
+#include <kernel/drivers/timer/ktimer.h>
+#include <kernel/drivers/timer/timerfd.h>
+#include <kernel/fs/vfs/sys_file.h>
+#include <kernel/fs/vfs/fs_errno.h>
+#include <kernel/memory/uaccess.h>
+#include <kernel/lib/string.h>
+#include <kernel/lib/math64.h>
+
+// Leading fields of the i386 struct sigevent
+typedef struct {
+    int32_t sigev_value;
+    int32_t sigev_signo;
+    int32_t sigev_notify;
+} k_sigevent_head_t;
+
+// Linux i386 struct tms: clock_t fields in USER_HZ
+typedef struct {
+    int32_t tms_utime;
+    int32_t tms_stime;
+    int32_t tms_cutime;
+    int32_t tms_cstime;
+} k_tms_t;
+
+// Linux i386 struct rusage: two timevals followed by 14 longs
+typedef struct {
+    k_timeval_t ru_utime;
+    k_timeval_t ru_stime;
+    int32_t     ru_other[14];
+} k_rusage_t;
+
+#define USER_HZ          100
+#define NSEC_PER_USER_HZ (NSEC_PER_SEC / USER_HZ)
+
+#define RUSAGE_SELF      0
+#define RUSAGE_CHILDREN  (-1)
+#define RUSAGE_THREAD    1
+
+static int32_t copy_in(void *dst, uint32_t user_ptr, size_t len) {
+    if (!user_ptr) return -EFAULT;
+    return copy_from_user((kernelptr_t)dst, (const_userptr_t)user_ptr, len) ? -EFAULT : 0;
+}
+
+static int32_t copy_out(uint32_t user_ptr, const void *src, size_t len) {
+    if (!user_ptr) return 0; // Optional output
+    return copy_to_user((userptr_t)user_ptr, (const_kernelptr_t)src, len) ? -EFAULT : 0;
+}
+
+//============================================================================
+// Interval Timers
+//============================================================================
+
+int32_t sys_alarm_impl(uint32_t seconds, uint32_t arg2, uint32_t arg3, isr_frame_t *regs)
+{
+    (void)arg2; (void)arg3; (void)regs;
+
+    pcb_t *proc = get_current_process();
+    if (!proc) return -ESRCH;
+    return (int32_t)itimer_alarm(proc, seconds);
+}
+
+int32_t sys_setitimer_impl(uint32_t which, uint32_t user_new_ptr, uint32_t user_old_ptr, isr_frame_t *regs)
+{
+    (void)regs;
+
+    pcb_t *proc = get_current_process();
+    if (!proc) return -ESRCH;
+
+    k_itimerval_t val, old;
+    int32_t ret = copy_in(&val, user_new_ptr, sizeof(val));
+    if (ret < 0) return ret;
+
+    ret = itimer_set(proc, (int)which, &val, &old);
+    if (ret < 0) return ret;
+    return copy_out(user_old_ptr, &old, sizeof(old));
+}
+
+int32_t sys_getitimer_impl(uint32_t which, uint32_t user_cur_ptr, uint32_t arg3, isr_frame_t *regs)
+{
+    (void)arg3; (void)regs;
+
+    pcb_t *proc = get_current_process();
+    if (!proc) return -ESRCH;
+    if (!user_cur_ptr) return -EFAULT;
+
+    k_itimerval_t cur;
+    int32_t ret = itimer_get(proc, (int)which, &cur);
+    if (ret < 0) return ret;
+    return copy_out(user_cur_ptr, &cur, sizeof(cur));
+}
+
+//============================================================================
+// POSIX Timers
+//============================================================================
+
+int32_t sys_timer_create_impl(uint32_t clockid, uint32_t user_sevp_ptr, uint32_t user_id_ptr, isr_frame_t *regs)
+{
+    (void)regs;
+
+    pcb_t *proc = get_current_process();
+    if (!proc) return -ESRCH;
+    if (!user_id_ptr) return -EFAULT;
+
+    k_sigevent_head_t sev = { 0, SIGALRM, SIGEV_SIGNAL };
+    if (user_sevp_ptr) {
+        int32_t ret = copy_in(&sev, user_sevp_ptr, sizeof(sev));
+        if (ret < 0) return ret;
+    }
+
+    int id;
+    int32_t ret = ptimer_create(proc, (int)clockid, sev.sigev_notify, sev.sigev_signo, &id);
+    if (ret < 0) return ret;
+
+    int32_t id_out = id;
+    ret = copy_out(user_id_ptr, &id_out, sizeof(id_out));
+    if (ret < 0) {
+        ptimer_delete(proc, id);
+    }
+    return ret;
+}
+
+int32_t sys_timer_settime_impl(uint32_t timer_id, uint32_t flags, uint32_t user_new_ptr, uint32_t user_old_ptr)
+{
+    pcb_t *proc = get_current_process();
+    if (!proc) return -ESRCH;
+
+    k_itimerspec_t val, old;
+    int32_t ret = copy_in(&val, user_new_ptr, sizeof(val));
+    if (ret < 0) return ret;
+
+    ret = ptimer_settime(proc, (int)timer_id, (int)flags, &val, &old);
+    if (ret < 0) return ret;
+    return copy_out(user_old_ptr, &old, sizeof(old));
+}
+
+int32_t sys_timer_gettime_impl(uint32_t timer_id, uint32_t user_cur_ptr, uint32_t arg3, isr_frame_t *regs)
+{
+    (void)arg3; (void)regs;
+
+    pcb_t *proc = get_current_process();
+    if (!proc) return -ESRCH;
+    if (!user_cur_ptr) return -EFAULT;
+
+    k_itimerspec_t cur;
+    int32_t ret = ptimer_gettime(proc, (int)timer_id, &cur);
+    if (ret < 0) return ret;
+    return copy_out(user_cur_ptr, &cur, sizeof(cur));
+}
+
+int32_t sys_timer_getoverrun_impl(uint32_t timer_id, uint32_t arg2, uint32_t arg3, isr_frame_t *regs)
+{
+    (void)arg2; (void)arg3; (void)regs;
+
+    pcb_t *proc = get_current_process();
+    if (!proc) return -ESRCH;
+    return ptimer_getoverrun(proc, (int)timer_id);
+}
+
+int32_t sys_timer_delete_impl(uint32_t timer_id, uint32_t arg2, uint32_t arg3, isr_frame_t *regs)
+{
+    (void)arg2; (void)arg3; (void)regs;
+
+    pcb_t *proc = get_current_process();
+    if (!proc) return -ESRCH;
+    return ptimer_delete(proc, (int)timer_id);
+}
+
+//============================================================================
+// timerfd
+//============================================================================
+
+static file_t *timerfd_lookup(uint32_t fd)
+{
+    pcb_t *proc = get_current_process();
+    if (!proc || fd >= MAX_FD || !proc->fd_table[fd]) return NULL;
+    return proc->fd_table[fd]->vfs_file;
+}
+
+int32_t sys_timerfd_create_impl(uint32_t clockid, uint32_t flags, uint32_t arg3, isr_frame_t *regs)
+{
+    (void)arg3; (void)regs;
+    return timerfd_create((int)clockid, (int)flags);
+}
+
+int32_t sys_timerfd_settime_impl(uint32_t fd, uint32_t flags, uint32_t user_new_ptr, uint32_t user_old_ptr)
+{
+    file_t *file = timerfd_lookup(fd);
+    if (!file) return -EBADF;
+
+    k_itimerspec_t val, old;
+    int32_t ret = copy_in(&val, user_new_ptr, sizeof(val));
+    if (ret < 0) return ret;
+
+    ret = timerfd_settime(file, (int)flags, &val, &old);
+    if (ret < 0) return ret;
+    return copy_out(user_old_ptr, &old, sizeof(old));
+}
+
+int32_t sys_timerfd_gettime_impl(uint32_t fd, uint32_t user_cur_ptr, uint32_t arg3, isr_frame_t *regs)
+{
+    (void)arg3; (void)regs;
+
+    file_t *file = timerfd_lookup(fd);
+    if (!file) return -EBADF;
+    if (!user_cur_ptr) return -EFAULT;
+
+    k_itimerspec_t cur;
+    int32_t ret = timerfd_gettime(file, &cur);
+    if (ret < 0) return ret;
+    return copy_out(user_cur_ptr, &cur, sizeof(cur));
+}
+
+//============================================================================
+// CPU Time and Clocks
+//============================================================================
+
+// Live tasks have not been folded into their pcb yet, so add both halves
+static void process_cputime(pcb_t *proc, uint64_t *utime, uint64_t *stime)
+{
+    uint64_t u = 0, s = 0;
+    if (proc->tcb) {
+        cputime_task_read(proc->tcb, &u, &s);
+    }
+    *utime = proc->utime_ns + u;
+    *stime = proc->stime_ns + s;
+}
+
+static void ns_to_timeval(uint64_t ns, k_timeval_t *tv)
+{
+    uint32_t rem;
+    tv->tv_sec = (int32_t)div_u64_rem(ns, NSEC_PER_SEC, &rem);
+    tv->tv_usec = (int32_t)(rem / 1000u);
+}
+
+static void ns_to_timespec(uint64_t ns, k_timespec_t *ts)
+{
+    uint32_t rem;
+    ts->tv_sec = (int32_t)div_u64_rem(ns, NSEC_PER_SEC, &rem);
+    ts->tv_nsec = (int32_t)rem;
+}
+
+int32_t sys_times_impl(uint32_t user_tms_ptr, uint32_t arg2, uint32_t arg3, isr_frame_t *regs)
+{
+    (void)arg2; (void)arg3; (void)regs;
+
+    pcb_t *proc = get_current_process();
+    if (!proc) return -ESRCH;
+
+    if (user_tms_ptr) {
+        uint64_t utime, stime;
+        process_cputime(proc, &utime, &stime);
+
+        k_tms_t tms;
+        tms.tms_utime = (int32_t)div_u64(utime, NSEC_PER_USER_HZ);
+        tms.tms_stime = (int32_t)div_u64(stime, NSEC_PER_USER_HZ);
+        tms.tms_cutime = (int32_t)div_u64(proc->cutime_ns, NSEC_PER_USER_HZ);
+        tms.tms_cstime = (int32_t)div_u64(proc->cstime_ns, NSEC_PER_USER_HZ);
+
+        int32_t ret = copy_out(user_tms_ptr, &tms, sizeof(tms));
+        if (ret < 0) return ret;
+    }
+
+    // Returned as clock_t; userspace only uses differences, so wrap is fine
+    return (int32_t)(ktimer_now() / (1000u / USER_HZ));
+}
+
+int32_t sys_getrusage_impl(uint32_t who, uint32_t user_rusage_ptr, uint32_t arg3, isr_frame_t *regs)
+{
+    (void)arg3; (void)regs;
+
+    pcb_t *proc = get_current_process();
+    if (!proc) return -ESRCH;
+    if (!user_rusage_ptr) return -EFAULT;
+
+    uint64_t utime, stime;
+    switch ((int32_t)who) {
+        case RUSAGE_SELF:
+            process_cputime(proc, &utime, &stime);
+            break;
+        case RUSAGE_THREAD:
+            // One thread per process
+            if (proc->tcb) {
+                cputime_task_read(proc->tcb, &utime, &stime);
+            } else {
+                utime = stime = 0;
+            }
+            break;
+        case RUSAGE_CHILDREN:
+            utime = proc->cutime_ns;
+            stime = proc->cstime_ns;
+            break;
+        default:
+            return -EINVAL;
+    }
+
+    k_rusage_t ru;
+    memset(&ru, 0, sizeof(ru));
+    ns_to_timeval(utime, &ru.ru_utime);
+    ns_to_timeval(stime, &ru.ru_stime);
+    return copy_out(user_rusage_ptr, &ru, sizeof(ru));
+}
+
+int32_t sys_clock_gettime_impl(uint32_t clockid, uint32_t user_ts_ptr, uint32_t arg3, isr_frame_t *regs)
+{
+    (void)arg3; (void)regs;
+
+    pcb_t *proc = get_current_process();
+    if (!proc) return -ESRCH;
+    if (!user_ts_ptr) return -EFAULT;
+
+    uint64_t utime, stime;
+    k_timespec_t ts;
+    switch (clockid) {
+        case CLOCK_REALTIME:
+        case CLOCK_MONOTONIC:
+            itimer_ticks_to_timespec(ktimer_now(), &ts);
+            break;
+        case CLOCK_PROCESS_CPUTIME_ID:
+            process_cputime(proc, &utime, &stime);
+            ns_to_timespec(utime + stime, &ts);
+            break;
+        case CLOCK_THREAD_CPUTIME_ID:
+            if (!proc->tcb) return -EINVAL;
+            cputime_task_read(proc->tcb, &utime, &stime);
+            ns_to_timespec(utime + stime, &ts);
+            break;
+        default:
+            return -EINVAL;
+    }
+    return copy_out(user_ts_ptr, &ts, sizeof(ts));
+}
+
+int32_t sys_clock_getres_impl(uint32_t clockid, uint32_t user_ts_ptr, uint32_t arg3, isr_frame_t *regs)
+{
+    (void)arg3; (void)regs;
+
+    k_timespec_t res = { 0, 0 };
+    switch (clockid) {
+        case CLOCK_REALTIME:
+        case CLOCK_MONOTONIC:
+        case CLOCK_PROCESS_CPUTIME_ID:
+        case CLOCK_THREAD_CPUTIME_ID:
+            // CPU clocks are finer once the TSC is calibrated; the tick is the bound
+            res.tv_nsec = (int32_t)NSEC_PER_TICK;
+            break;
+        default:
+            return -EINVAL;
+    }
+    return copy_out(user_ts_ptr, &res, sizeof(res));
+}
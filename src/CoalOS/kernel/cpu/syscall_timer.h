@@ -0,0 +1,86 @@
+/**
+ * @file syscall_timer.h
+ * @brief Timer System Call Implementations
+ *
+ * @details alarm/setitimer/getitimer, POSIX timer_* and timerfd_* calls.
+ * Three-argument calls use the native table signature; timer_settime and
+ * timerfd_settime take four arguments and are reached through the Linux
+ * table only.
+ */
+
+#ifndef SYSCALL_TIMER_H
+#define SYSCALL_TIMER_H
+
+//============================================================================
+// Includes
+//============================================================================
+#include <kernel/cpu/isr_frame.h>
+#include <libc/stdint.h>
+
+//============================================================================
+// Interval Timers
+//============================================================================
+
+/**
+ * @brief Schedule SIGALRM after a number of seconds (0 cancels)
+ * @return Seconds left on the previous alarm
+ */
+int32_t sys_alarm_impl(uint32_t seconds, uint32_t arg2, uint32_t arg3, isr_frame_t *regs);
+
+/**
+ * @brief Set ITIMER_REAL/VIRTUAL/PROF
+ * @param user_new_ptr struct itimerval to install
+ * @param user_old_ptr Receives the previous setting (may be 0)
+ * @return 0 on success, negative error code on failure
+ */
+int32_t sys_setitimer_impl(uint32_t which, uint32_t user_new_ptr, uint32_t user_old_ptr, isr_frame_t *regs);
+
+/**
+ * @brief Read ITIMER_REAL/VIRTUAL/PROF
+ * @return 0 on success, negative error code on failure
+ */
+int32_t sys_getitimer_impl(uint32_t which, uint32_t user_cur_ptr, uint32_t arg3, isr_frame_t *regs);
+
+//============================================================================
+// POSIX Timers
+//============================================================================
+
+/**
+ * @brief Create a POSIX timer
+ * @param user_sevp_ptr struct sigevent (0 = SIGEV_SIGNAL with SIGALRM)
+ * @param user_id_ptr Receives the timer id
+ */
+int32_t sys_timer_create_impl(uint32_t clockid, uint32_t user_sevp_ptr, uint32_t user_id_ptr, isr_frame_t *regs);
+int32_t sys_timer_settime_impl(uint32_t timer_id, uint32_t flags, uint32_t user_new_ptr, uint32_t user_old_ptr);
+int32_t sys_timer_gettime_impl(uint32_t timer_id, uint32_t user_cur_ptr, uint32_t arg3, isr_frame_t *regs);
+int32_t sys_timer_getoverrun_impl(uint32_t timer_id, uint32_t arg2, uint32_t arg3, isr_frame_t *regs);
+int32_t sys_timer_delete_impl(uint32_t timer_id, uint32_t arg2, uint32_t arg3, isr_frame_t *regs);
+
+//============================================================================
+// timerfd
+//============================================================================
+
+int32_t sys_timerfd_create_impl(uint32_t clockid, uint32_t flags, uint32_t arg3, isr_frame_t *regs);
+int32_t sys_timerfd_settime_impl(uint32_t fd, uint32_t flags, uint32_t user_new_ptr, uint32_t user_old_ptr);
+int32_t sys_timerfd_gettime_impl(uint32_t fd, uint32_t user_cur_ptr, uint32_t arg3, isr_frame_t *regs);
+
+//============================================================================
+// CPU Time and Clocks
+//============================================================================
+
+/**
+ * @brief Fill struct tms with the caller's and its reaped children's times
+ * @return Clock ticks (USER_HZ) since boot
+ */
+int32_t sys_times_impl(uint32_t user_tms_ptr, uint32_t arg2, uint32_t arg3, isr_frame_t *regs);
+
+/**
+ * @brief Fill struct rusage for RUSAGE_SELF/CHILDREN/THREAD
+ * @note Only ru_utime and ru_stime are maintained; the rest reads as zero
+ */
+int32_t sys_getrusage_impl(uint32_t who, uint32_t user_rusage_ptr, uint32_t arg3, isr_frame_t *regs);
+
+int32_t sys_clock_gettime_impl(uint32_t clockid, uint32_t user_ts_ptr, uint32_t arg3, isr_frame_t *regs);
+int32_t sys_clock_getres_impl(uint32_t clockid, uint32_t user_ts_ptr, uint32_t arg3, isr_frame_t *regs);
+
+#endif // SYSCALL_TIMER_H
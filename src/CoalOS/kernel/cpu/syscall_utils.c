@@ -40,42 +40,32 @@ int strncpy_from_user_safe(const_userptr_t u_src, char *k_dst, size_t maxlen)
     if (maxlen == 0) return -EINVAL;
     k_dst[0] = '\0';
 
-    // Basic check, uaccess.c's access_ok will do more thorough VMA checks.
+    // Range check only; unmapped pages are reported by the copy fault fixups.
     if (!u_src || (uintptr_t)u_src >= KERNEL_SPACE_VIRT_START) {
         return -EFAULT;
     }
     
-    // Check at least one byte can be touched by access_ok
-    if (!access_ok(VERIFY_READ, u_src, 1)) {
+    // Locate the terminator a word at a time, then copy the string in one go
+    long len = strnlen_user(u_src, maxlen);
+    if (len < 0) {
         return -EFAULT;
     }
-
-    size_t len = 0;
-    while (len < maxlen - 1) { // Leave space for null terminator
-        char current_char;
-        if (copy_from_user((kernelptr_t)&current_char, 
-                          (const_userptr_t)((const char*)u_src + len), 1) != 0) {
-            k_dst[len] = '\0'; // Null-terminate on partial copy due to fault
+    if ((size_t)len >= maxlen) {
+        // No NUL within maxlen bytes: copy what fits and report truncation
+        if (copy_from_user((kernelptr_t)k_dst, u_src, maxlen - 1) != 0) {
+            k_dst[0] = '\0';
             return -EFAULT;
         }
-        k_dst[len] = current_char;
-        if (current_char == '\0') {
-            return 0; // Success, null terminator copied
-        }
-        len++;
+        k_dst[maxlen - 1] = '\0';
+        return -ENAMETOOLONG;
     }
 
-    k_dst[len] = '\0'; // Maxlen-1 chars copied, ensure null termination
-    
-    // Check if the original string was actually longer (meaning truncation occurred)
-    char next_char_check;
-    if (copy_from_user((kernelptr_t)&next_char_check, 
-                      (const_userptr_t)((const char*)u_src + len), 1) == 0 && 
-        next_char_check != '\0') {
-        return -ENAMETOOLONG; // Original string was longer
+    if (copy_from_user((kernelptr_t)k_dst, u_src, (size_t)len + 1) != 0) {
+        k_dst[0] = '\0';
+        return -EFAULT;
     }
-    
-    return 0; // String fit or was shorter and NUL terminated within maxlen
+    k_dst[len] = '\0'; // Guard against the string changing under us
+    return 0;
 }
 
 //============================================================================
@@ -118,6 +108,13 @@ static bool copy_vma_tree_simple(mm_struct_t *child_mm, mm_struct_t *parent_mm)
             return false;
         }
         
+        // Shared mappings (shm objects) keep the same frames; private ones go COW
+        if (mm_copy_vma_pages(child_mm, parent_mm, parent_vma) != 0) {
+            serial_printf("[Fork] Failed to copy pages of VMA [0x%x-0x%x]\n",
+                          parent_vma->vm_start, parent_vma->vm_end);
+            return false;
+        }
+        
         vmas_copied++;
         serial_printf("[Fork] Copied VMA [0x%x-0x%x] flags=0x%x\n",
                       parent_vma->vm_start, parent_vma->vm_end, parent_vma->vm_flags);
@@ -216,21 +213,9 @@ int copy_fd_table(pcb_t *parent, pcb_t *child)
             // Copy sys_file structure
             *child_sf = *parent_sf;
             
-            // Child gets its own copy of the file structure
-            file_t *child_file = (file_t*)kmalloc(sizeof(file_t));
-            if (!child_file) {
-                kfree(child_sf);
-                spinlock_release_irqrestore(&parent->fd_table_lock, irq_flags);
-                return -ENOMEM;
-            }
-            
-            // Copy file structure
-            *child_file = *parent_sf->vfs_file;
-            spinlock_init(&child_file->lock);
-            child_sf->vfs_file = child_file;
-            
-            // Reference same vnode (files are shared between parent and child)
-            // Note: In a full implementation, we'd need proper vnode reference counting
+            // Parent and child share the open file (offset, socket, ...);
+            // it is torn down when the last descriptor closes
+            child_sf->vfs_file = vfs_file_get(parent_sf->vfs_file);
             
             child->fd_table[fd] = child_sf;
         }
@@ -0,0 +1,69 @@
+/**
+ * @file tsc.c
+ * @brief TSC detection and tick-based frequency calibration
+ */
+
+#include <kernel/cpu/tsc.h>
+#include <kernel/cpu/cpuid.h>
+#include <kernel/lib/math64.h>
+#include <kernel/drivers/display/serial.h>
+
+#define CPUID_EDX_TSC      (1u << 4)
+#define NSEC_PER_MSEC      1000000u
+
+static bool     g_tsc_present = false;
+static bool     g_tsc_ready = false;
+static bool     g_calibrating = false;
+static uint32_t g_cal_start_tick;
+static uint64_t g_cal_start_tsc;
+static uint32_t g_tsc_khz;
+static uint32_t g_tsc_mult;   // ns per cycle << TSC_SHIFT
+
+void tsc_init(void) {
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(0, &eax, &ebx, &ecx, &edx);
+    if (eax < 1) return;
+
+    cpuid(1, &eax, &ebx, &ecx, &edx);
+    g_tsc_present = (edx & CPUID_EDX_TSC) != 0;
+    serial_printf("[TSC] %s\n", g_tsc_present ? "Present, calibrating against PIT" : "Not available");
+}
+
+void tsc_calibrate_tick(uint32_t now) {
+    if (!g_tsc_present || g_tsc_ready) return;
+
+    if (!g_calibrating) {
+        g_cal_start_tick = now;
+        g_cal_start_tsc = rdtsc();
+        g_calibrating = true;
+        return;
+    }
+
+    uint32_t elapsed = now - g_cal_start_tick;
+    if (elapsed < TSC_CALIBRATE_TICKS) return;
+
+    // One tick is 1 ms; 64 ms of cycles fits 32 bits below ~67 GHz
+    uint32_t cycles = (uint32_t)(rdtsc() - g_cal_start_tsc);
+    uint32_t khz = cycles / elapsed;
+    if (khz == 0) {
+        g_tsc_present = false;
+        return;
+    }
+
+    g_tsc_khz = khz;
+    g_tsc_mult = (uint32_t)div_u64((uint64_t)NSEC_PER_MSEC << TSC_SHIFT, khz);
+    g_tsc_ready = true;
+    serial_printf("[TSC] Calibrated: %lu kHz\n", (unsigned long)khz);
+}
+
+bool tsc_ready(void) {
+    return g_tsc_ready;
+}
+
+uint32_t tsc_khz(void) {
+    return g_tsc_ready ? g_tsc_khz : 0;
+}
+
+uint64_t tsc_cycles_to_ns(uint64_t cycles) {
+    return (cycles * g_tsc_mult) >> TSC_SHIFT;
+}
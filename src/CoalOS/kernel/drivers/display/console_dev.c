@@ -6,7 +6,9 @@
  * with the VFS layer for stdin, stdout, and stderr file descriptors.
  */
 
+#include <kernel/drivers/display/console_dev.h>
 #include <kernel/drivers/display/terminal.h>
+#include <kernel/drivers/display/tty.h>
 #include <kernel/fs/vfs/vfs.h>
 #include <kernel/drivers/display/serial.h>
 #include <kernel/memory/kmalloc.h>
@@ -113,18 +115,9 @@ static int console_vfs_read(file_t *file, void *buffer, size_t count) {
         return -EACCES;
     }
     
-    // Limit read size to reasonable maximum
-    if (count > 1024) {
-        count = 1024;
-    }
-    
-    char *char_buffer = (char *)buffer;
-    
-    // Use terminal's line-based input for now
-    // This will block until a complete line is available
-    size_t bytes_read = terminal_read_line_blocking(char_buffer, count);
-    
-    return (int)bytes_read;
+    // Called under the VFS file lock, so only take what is already queued;
+    // read() on a console descriptor goes to tty_read() directly and blocks
+    return (int)tty_read((char *)buffer, count, true);
 }
 
 /**
@@ -215,10 +208,15 @@ file_t *create_console_file(int mode) {
     console_file->flags = mode;
     console_file->offset = 0;
     spinlock_init(&console_file->lock);
+    console_file->refcount = 1;
     
     return console_file;
 }
 
+bool console_is_tty(file_t *file) {
+    return file && file->vnode && file->vnode->fs_driver == &console_driver;
+}
+
 /**
  * @brief Initialize console device
  * Called during system initialization
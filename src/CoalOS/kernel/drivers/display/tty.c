@@ -0,0 +1,626 @@
+/**
+ * @file tty.c
+ * @brief Console tty line discipline
+ *
+ * Two queues: raw holds bytes straight from the keyboard IRQ, buf holds
+ * input that has been through the line discipline and is waiting for
+ * read(). The IRQ side only appends to raw and queues the work item; the
+ * work item drains raw in chunks, edits the canonical line, fills buf and
+ * echoes, all from process context. A read in canonical mode stops at the
+ * first byte marked in delim; eof marks a VEOF delimiter, which is consumed
+ * but not returned.
+ */
+
+#include <kernel/drivers/display/tty.h>
+#include <kernel/drivers/display/terminal.h>
+#include <kernel/drivers/display/serial.h>
+#include <kernel/drivers/timer/ktimer.h>
+#include <kernel/process/workqueue.h>
+#include <kernel/process/scheduler.h>
+#include <kernel/process/scheduler_queues.h>
+#include <kernel/process/process.h>
+#include <kernel/process/signal.h>
+#include <kernel/sync/spinlock.h>
+#include <kernel/fs/vfs/fs_errno.h>
+#include <kernel/lib/string.h>
+
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+#define TTY_CHUNK       64      // Raw bytes processed per lock hold
+#define TTY_ECHO_SIZE   128
+
+#define CTRL(c)         ((c) & 0x1f)
+#define TTY_DEL         0x7f
+
+typedef struct {
+    spinlock_t   lock;
+    k_termios_t  termios;
+    k_winsize_t  winsize;
+    uint32_t     pgrp;          // Foreground process group (0 = none yet)
+
+    // Keyboard bytes not yet seen by the line discipline
+    uint8_t      raw[TTY_RAW_SIZE];
+    uint32_t     raw_head;
+    uint32_t     raw_count;
+    work_t       work;
+
+    // Processed input
+    uint8_t      buf[TTY_BUF_SIZE];
+    uint8_t      delim[TTY_BUF_SIZE / 8];
+    uint8_t      eof[TTY_BUF_SIZE / 8];
+    uint32_t     head;
+    uint32_t     count;
+    uint32_t     lines;         // Delimiters in buf
+
+    // Canonical line being edited
+    uint8_t      line[TTY_LINE_MAX];
+    uint32_t     line_len;
+
+    tcb_t       *readers;
+} tty_t;
+
+static tty_t s_tty;
+
+// Echo collected while the lock is held and written once per chunk
+typedef struct {
+    char     data[TTY_ECHO_SIZE];
+    uint32_t len;
+} tty_echo_t;
+
+// Timed wait of a VTIME read
+typedef struct {
+    ktimer_t          timer;
+    tcb_t            *task;
+    volatile bool     expired;
+} tty_sleep_t;
+
+/* ------------------------------------------------------------------------- */
+/* Defaults                                                                  */
+/* ------------------------------------------------------------------------- */
+
+static void tty_default_termios(k_termios_t *t) {
+    memset(t, 0, sizeof(*t));
+    t->c_iflag = ICRNL | IXON;
+    t->c_oflag = OPOST | ONLCR;
+    t->c_cflag = CS8 | CREAD;
+    t->c_lflag = ISIG | ICANON | ECHO | ECHOE | ECHOK | ECHOCTL | ECHOKE | IEXTEN;
+    t->c_cc[VINTR]   = CTRL('C');
+    t->c_cc[VQUIT]   = CTRL('\\');
+    t->c_cc[VERASE]  = TTY_DEL;
+    t->c_cc[VKILL]   = CTRL('U');
+    t->c_cc[VEOF]    = CTRL('D');
+    t->c_cc[VTIME]   = 0;
+    t->c_cc[VMIN]    = 1;
+    t->c_cc[VSTART]  = CTRL('Q');
+    t->c_cc[VSTOP]   = CTRL('S');
+    t->c_cc[VSUSP]   = CTRL('Z');
+    t->c_cc[VREPRINT] = CTRL('R');
+    t->c_cc[VWERASE] = CTRL('W');
+    t->c_cc[VLNEXT]  = CTRL('V');
+}
+
+/* ------------------------------------------------------------------------- */
+/* Queues (lock held)                                                        */
+/* ------------------------------------------------------------------------- */
+
+static inline bool tty_bit(const uint8_t *map, uint32_t i) {
+    return (map[i / 8] >> (i % 8)) & 1;
+}
+
+static inline void tty_set_bit(uint8_t *map, uint32_t i, bool on) {
+    if (on) map[i / 8] |= (uint8_t)(1u << (i % 8));
+    else    map[i / 8] &= (uint8_t)~(1u << (i % 8));
+}
+
+static bool tty_canon(void) {
+    return (s_tty.termios.c_lflag & ICANON) != 0;
+}
+
+// True if cc slot i is enabled and equals c
+static bool tty_is_cc(uint8_t c, int i) {
+    uint8_t v = s_tty.termios.c_cc[i];
+    return v != 0 && v == c;
+}
+
+static void tty_buf_put(uint8_t c, bool delim, bool eof) {
+    uint32_t i = (s_tty.head + s_tty.count) % TTY_BUF_SIZE;
+    s_tty.buf[i] = c;
+    tty_set_bit(s_tty.delim, i, delim);
+    tty_set_bit(s_tty.eof, i, eof);
+    s_tty.count++;
+    if (delim) s_tty.lines++;
+}
+
+/*
+ * Moves up to count bytes out of buf. In canonical mode the copy stops
+ * after the first delimiter; a VEOF delimiter is consumed but not copied.
+ */
+static size_t tty_take(char *kbuf, size_t count, bool canon) {
+    size_t n = 0;
+    while (s_tty.count > 0 && n < count) {
+        uint32_t i = s_tty.head;
+        bool delim = tty_bit(s_tty.delim, i);
+        bool eof = tty_bit(s_tty.eof, i);
+        s_tty.head = (s_tty.head + 1) % TTY_BUF_SIZE;
+        s_tty.count--;
+        if (delim) s_tty.lines--;
+        if (!eof || !canon) kbuf[n++] = (char)s_tty.buf[i];
+        if (delim && canon) break;
+    }
+    return n;
+}
+
+static void tty_flush_locked(void) {
+    s_tty.head = 0;
+    s_tty.count = 0;
+    s_tty.lines = 0;
+    s_tty.line_len = 0;
+    s_tty.raw_count = 0;
+    memset(s_tty.delim, 0, sizeof(s_tty.delim));
+    memset(s_tty.eof, 0, sizeof(s_tty.eof));
+}
+
+static void tty_wake(void) {
+    tcb_t *task = s_tty.readers;
+    s_tty.readers = NULL;
+    while (task) {
+        tcb_t *next = task->wait_next;
+        task->wait_next = NULL;
+        task->wait_reason = NULL;
+        if (task->state == TASK_BLOCKED) scheduler_unblock_task(task);
+        task = next;
+    }
+}
+
+/*
+ * Sleeps until the next tty_wake() or timer expiry. Called with the lock
+ * held and returns with it held. -EINTR if a signal is pending.
+ */
+static int tty_wait(uintptr_t *irq) {
+    tcb_t *self = get_current_task();
+    if (!self) return -EFAULT;
+    if (test_tsk_thread_flag(self, TIF_SIGPENDING)) return -EINTR;
+
+    self->wait_next = s_tty.readers;
+    self->wait_reason = &s_tty;
+    s_tty.readers = self;
+    self->state = TASK_BLOCKED;
+    spinlock_release_irqrestore(&s_tty.lock, *irq);
+    schedule();
+    *irq = spinlock_acquire_irqsave(&s_tty.lock);
+
+    // Woken by the VTIME timer or a signal: leave the list
+    if (self->wait_reason == &s_tty) {
+        tcb_t **link = &s_tty.readers;
+        while (*link && *link != self) link = &(*link)->wait_next;
+        if (*link) *link = self->wait_next;
+        self->wait_next = NULL;
+        self->wait_reason = NULL;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Echo                                                                      */
+/* ------------------------------------------------------------------------- */
+
+static void tty_echo_flush(tty_echo_t *e) {
+    if (e->len) {
+        terminal_write_bytes(e->data, e->len);
+        e->len = 0;
+    }
+}
+
+static void tty_echo_put(tty_echo_t *e, char c) {
+    if (e->len == sizeof(e->data)) tty_echo_flush(e);
+    e->data[e->len++] = c;
+}
+
+// Control characters other than tab and newline echo as ^X under ECHOCTL
+static bool tty_echoes_as_ctl(uint8_t c) {
+    return (s_tty.termios.c_lflag & ECHOCTL) &&
+           (c < 0x20 || c == TTY_DEL) && c != '\t' && c != '\n';
+}
+
+static void tty_echo_char(tty_echo_t *e, uint8_t c) {
+    if (!(s_tty.termios.c_lflag & ECHO)) return;
+    if (tty_echoes_as_ctl(c)) {
+        tty_echo_put(e, '^');
+        tty_echo_put(e, c == TTY_DEL ? '?' : (char)(c + 0x40));
+    } else {
+        tty_echo_put(e, (char)c);
+    }
+}
+
+// Erases the last character of the edited line, on screen too under ECHOE
+static void tty_erase_one(tty_echo_t *e) {
+    if (s_tty.line_len == 0) return;
+    uint8_t c = s_tty.line[--s_tty.line_len];
+    if (!(s_tty.termios.c_lflag & ECHO) || !(s_tty.termios.c_lflag & ECHOE)) return;
+    int width = tty_echoes_as_ctl(c) ? 2 : 1;
+    for (int i = 0; i < width; i++) {
+        tty_echo_put(e, '\b');
+        tty_echo_put(e, ' ');
+        tty_echo_put(e, '\b');
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/* Line discipline (process context, lock held)                              */
+/* ------------------------------------------------------------------------- */
+
+// Commits the edited line plus its delimiter to buf; dropped if it won't fit
+static void tty_commit_line(uint8_t term, bool eof) {
+    if (s_tty.count + s_tty.line_len + 1 > TTY_BUF_SIZE) {
+        s_tty.line_len = 0;
+        return;
+    }
+    for (uint32_t i = 0; i < s_tty.line_len; i++) {
+        tty_buf_put(s_tty.line[i], false, false);
+    }
+    tty_buf_put(term, true, eof);
+    s_tty.line_len = 0;
+}
+
+static void tty_input_byte(uint8_t c, tty_echo_t *e, uint32_t *sigs) {
+    const k_termios_t *t = &s_tty.termios;
+
+    if (c == '\r') {
+        if (t->c_iflag & IGNCR) return;
+        if (t->c_iflag & ICRNL) c = '\n';
+    } else if (c == '\n' && (t->c_iflag & INLCR)) {
+        c = '\r';
+    }
+
+    if (t->c_lflag & ISIG) {
+        int sig = 0;
+        if (tty_is_cc(c, VINTR)) sig = SIGINT;
+        else if (tty_is_cc(c, VQUIT)) sig = SIGQUIT;
+        else if (tty_is_cc(c, VSUSP)) sig = SIGTSTP;
+        if (sig) {
+            if (!(t->c_lflag & NOFLSH)) tty_flush_locked();
+            tty_echo_char(e, c);
+            *sigs |= 1u << sig;
+            return;
+        }
+    }
+
+    if (!(t->c_lflag & ICANON)) {
+        if (s_tty.count < TTY_BUF_SIZE) {
+            tty_buf_put(c, false, false);
+            tty_echo_char(e, c);
+        }
+        return;
+    }
+
+    if (tty_is_cc(c, VERASE)) {
+        tty_erase_one(e);
+        return;
+    }
+    if ((t->c_lflag & IEXTEN) && tty_is_cc(c, VWERASE)) {
+        while (s_tty.line_len && s_tty.line[s_tty.line_len - 1] == ' ') tty_erase_one(e);
+        while (s_tty.line_len && s_tty.line[s_tty.line_len - 1] != ' ') tty_erase_one(e);
+        return;
+    }
+    if (tty_is_cc(c, VKILL)) {
+        if ((t->c_lflag & ECHOKE) && (t->c_lflag & ECHOE)) {
+            while (s_tty.line_len) tty_erase_one(e);
+        } else {
+            s_tty.line_len = 0;
+            tty_echo_char(e, c);
+            if ((t->c_lflag & ECHO) && (t->c_lflag & ECHOK)) tty_echo_put(e, '\n');
+        }
+        return;
+    }
+    if (tty_is_cc(c, VEOF)) {
+        tty_commit_line(c, true);
+        return;
+    }
+    if (c == '\n' || tty_is_cc(c, VEOL) || tty_is_cc(c, VEOL2)) {
+        if ((t->c_lflag & ECHO) || (c == '\n' && (t->c_lflag & ECHONL))) {
+            tty_echo_put(e, (char)c);
+        }
+        tty_commit_line(c, false);
+        return;
+    }
+
+    // Full line: drop the byte, as a real terminal would beep
+    if (s_tty.line_len < TTY_LINE_MAX) {
+        s_tty.line[s_tty.line_len++] = c;
+        tty_echo_char(e, c);
+    }
+}
+
+static bool tty_readable(void) {
+    return tty_canon() ? s_tty.lines > 0 : s_tty.count > 0;
+}
+
+static void tty_signal_task(tcb_t *task, void *arg) {
+    uint32_t *args = (uint32_t *)arg;   // { pgrp, sig }
+    if (task->process && task->process->pgid == args[0] &&
+        task->state != TASK_ZOMBIE && task->state != TASK_EXITING) {
+        signal_send_kernel(task->process, (int)args[1]);
+    }
+}
+
+static void tty_signal_pgrp(uint32_t pgrp, uint32_t sigs) {
+    if (!pgrp) return;
+    for (uint32_t sig = 1; sig < 32; sig++) {
+        if (sigs & (1u << sig)) {
+            uint32_t args[2] = { pgrp, sig };
+            scheduler_queues_for_each_task(tty_signal_task, args);
+        }
+    }
+}
+
+// Drains raw through the line discipline, a chunk per lock hold
+static void tty_process(void) {
+    tty_echo_t echo;
+    echo.len = 0;
+
+    for (;;) {
+        uint32_t sigs = 0;
+        uintptr_t irq = spinlock_acquire_irqsave(&s_tty.lock);
+        if (s_tty.raw_count == 0) {
+            spinlock_release_irqrestore(&s_tty.lock, irq);
+            break;
+        }
+
+        uint32_t n = MIN(s_tty.raw_count, TTY_CHUNK);
+        for (uint32_t i = 0; i < n && s_tty.raw_count; i++) {
+            uint8_t c = s_tty.raw[s_tty.raw_head];
+            s_tty.raw_head = (s_tty.raw_head + 1) % TTY_RAW_SIZE;
+            s_tty.raw_count--;
+            tty_input_byte(c, &echo, &sigs);
+        }
+
+        // Interrupted readers must see their signal, so wake them too
+        if (tty_readable() || sigs) tty_wake();
+        uint32_t pgrp = s_tty.pgrp;
+        spinlock_release_irqrestore(&s_tty.lock, irq);
+
+        tty_echo_flush(&echo);
+        if (sigs) tty_signal_pgrp(pgrp, sigs);
+    }
+}
+
+static void tty_work_fn(work_t *work) {
+    (void)work;
+    tty_process();
+}
+
+/* ------------------------------------------------------------------------- */
+/* Keyboard side (IRQ context)                                               */
+/* ------------------------------------------------------------------------- */
+
+// Translates a key press into the bytes a VT100-style terminal would send
+static size_t tty_key_bytes(const KeyEvent *ev, char out[8]) {
+    static const char *const fkeys[] = {
+        "\033OP", "\033OQ", "\033OR", "\033OS", "\033[15~",
+        "\033[17~", "\033[18~", "\033[19~", "\033[20~", "\033[21~",
+    };
+    const char *seq = NULL;
+    char c;
+
+    switch (ev->code) {
+        case KEY_ENTER:     c = '\r'; break;
+        case KEY_BACKSPACE: c = TTY_DEL; break;
+        case KEY_TAB:       c = '\t'; break;
+        case KEY_ESC:       c = '\033'; break;
+        case KEY_UP:        seq = "\033[A"; break;
+        case KEY_DOWN:      seq = "\033[B"; break;
+        case KEY_RIGHT:     seq = "\033[C"; break;
+        case KEY_LEFT:      seq = "\033[D"; break;
+        case KEY_HOME:      seq = "\033[H"; break;
+        case KEY_END:       seq = "\033[F"; break;
+        case KEY_INSERT:    seq = "\033[2~"; break;
+        case KEY_DELETE:    seq = "\033[3~"; break;
+        case KEY_PAGE_UP:   seq = "\033[5~"; break;
+        case KEY_PAGE_DOWN: seq = "\033[6~"; break;
+        default:
+            if (ev->code >= KEY_F1 && ev->code <= KEY_F10) {
+                seq = fkeys[ev->code - KEY_F1];
+                break;
+            }
+            if (ev->code == 0 || ev->code >= 0x80) return 0;
+            c = apply_modifiers_extended((char)ev->code, ev->modifiers);
+            if (c == '\n') c = '\r';
+            else if (c == '\b') c = TTY_DEL;
+            if (ev->modifiers & MOD_CTRL) {
+                if (c >= 'a' && c <= 'z') c = CTRL(c);
+                else if (c >= '@' && c <= '_') c = CTRL(c);
+                else if (c == '?') c = TTY_DEL;
+                else if (c == ' ') c = 0;
+            }
+            break;
+    }
+
+    if (seq) {
+        size_t len = strlen(seq);
+        memcpy(out, seq, len);
+        return len;
+    }
+    size_t len = 0;
+    if (ev->modifiers & MOD_ALT) out[len++] = '\033';
+    out[len++] = c;
+    return len;
+}
+
+void tty_handle_key_event(KeyEvent event) {
+    if (event.action == KEY_RELEASE) return;
+
+    char bytes[8];
+    size_t len = tty_key_bytes(&event, bytes);
+    if (len == 0) return;
+
+    uintptr_t irq = spinlock_acquire_irqsave(&s_tty.lock);
+    if (s_tty.raw_count + len <= TTY_RAW_SIZE) {
+        for (size_t i = 0; i < len; i++) {
+            s_tty.raw[(s_tty.raw_head + s_tty.raw_count) % TTY_RAW_SIZE] = (uint8_t)bytes[i];
+            s_tty.raw_count++;
+        }
+    }
+    spinlock_release_irqrestore(&s_tty.lock, irq);
+
+    // Before the worker pool exists the discipline runs right here
+    if (system_wq) queue_work(system_wq, &s_tty.work);
+    else tty_process();
+}
+
+/* ------------------------------------------------------------------------- */
+/* Reading                                                                   */
+/* ------------------------------------------------------------------------- */
+
+static void tty_read_timeout(ktimer_t *timer) {
+    tty_sleep_t *sl = (tty_sleep_t *)timer->data;
+    sl->expired = true;
+    if (sl->task && sl->task->state == TASK_BLOCKED) scheduler_unblock_task(sl->task);
+}
+
+ssize_t tty_read(char *kbuf, size_t count, bool nonblock) {
+    if (!kbuf) return -EINVAL;
+    if (count == 0) return 0;
+
+    tty_sleep_t sl;
+    ktimer_init(&sl.timer, tty_read_timeout, &sl);
+    sl.task = get_current_task();
+    sl.expired = false;
+    bool armed = false;
+    uint32_t armed_at = 0;  // Bytes queued when the inter-byte timer was armed
+
+    ssize_t res;
+    uintptr_t irq = spinlock_acquire_irqsave(&s_tty.lock);
+
+    // The first reader's group becomes the foreground group
+    if (!s_tty.pgrp && sl.task && sl.task->process) s_tty.pgrp = sl.task->process->pgid;
+
+    for (;;) {
+        if (tty_canon()) {
+            if (s_tty.lines > 0) {
+                res = (ssize_t)tty_take(kbuf, count, true);
+                break;
+            }
+        } else {
+            uint8_t vmin = s_tty.termios.c_cc[VMIN];
+            uint8_t vtime = s_tty.termios.c_cc[VTIME];
+            uint32_t avail = s_tty.count;
+            size_t want = vmin ? MIN((size_t)vmin, count) : 1;
+
+            if (avail >= want || (vmin == 0 && vtime == 0) || (sl.expired && (avail || !vmin))) {
+                res = (ssize_t)tty_take(kbuf, count, false);
+                break;
+            }
+            if (nonblock && avail) {
+                res = (ssize_t)tty_take(kbuf, count, false);
+                break;
+            }
+
+            // VTIME is tenths of a second: the whole read with VMIN = 0,
+            // otherwise the gap allowed after each byte
+            if (vtime && !nonblock && (vmin == 0 ? !armed : (avail && avail != armed_at))) {
+                sl.expired = false;
+                ktimer_arm(&sl.timer, (uint32_t)vtime * (KTIMER_HZ / 10));
+                armed = true;
+                armed_at = avail;
+            }
+        }
+
+        if (nonblock) {
+            res = -EAGAIN;
+            break;
+        }
+        int err = tty_wait(&irq);
+        if (err < 0) {
+            res = err;
+            break;
+        }
+    }
+    spinlock_release_irqrestore(&s_tty.lock, irq);
+
+    if (armed) ktimer_cancel(&sl.timer);
+    return res;
+}
+
+size_t tty_bytes_available(void) {
+    uintptr_t irq = spinlock_acquire_irqsave(&s_tty.lock);
+    size_t n = s_tty.count;
+    spinlock_release_irqrestore(&s_tty.lock, irq);
+    return n;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Settings                                                                  */
+/* ------------------------------------------------------------------------- */
+
+void tty_get_termios(k_termios_t *t) {
+    uintptr_t irq = spinlock_acquire_irqsave(&s_tty.lock);
+    *t = s_tty.termios;
+    spinlock_release_irqrestore(&s_tty.lock, irq);
+}
+
+int tty_set_termios(const k_termios_t *t, int action) {
+    if (action != TCSETS && action != TCSETSW && action != TCSETSF) return -EINVAL;
+
+    uintptr_t irq = spinlock_acquire_irqsave(&s_tty.lock);
+    bool was_canon = tty_canon();
+    s_tty.termios = *t;
+
+    // Output is written synchronously, so TCSETSW has nothing to drain
+    if (action == TCSETSF) {
+        tty_flush_locked();
+    } else if (was_canon && !tty_canon()) {
+        // The half-edited line becomes ordinary input
+        for (uint32_t i = 0; i < s_tty.line_len && s_tty.count < TTY_BUF_SIZE; i++) {
+            tty_buf_put(s_tty.line[i], false, false);
+        }
+        s_tty.line_len = 0;
+    }
+    // New VMIN/VTIME or mode may satisfy a blocked read
+    tty_wake();
+    spinlock_release_irqrestore(&s_tty.lock, irq);
+    return 0;
+}
+
+void tty_flush_input(void) {
+    uintptr_t irq = spinlock_acquire_irqsave(&s_tty.lock);
+    tty_flush_locked();
+    spinlock_release_irqrestore(&s_tty.lock, irq);
+}
+
+uint32_t tty_get_pgrp(void) {
+    return s_tty.pgrp;
+}
+
+int tty_set_pgrp(uint32_t pgid) {
+    if (pgid == 0) return -EINVAL;
+    s_tty.pgrp = pgid;
+    return 0;
+}
+
+void tty_get_winsize(k_winsize_t *ws) {
+    uintptr_t irq = spinlock_acquire_irqsave(&s_tty.lock);
+    *ws = s_tty.winsize;
+    spinlock_release_irqrestore(&s_tty.lock, irq);
+}
+
+void tty_set_winsize(const k_winsize_t *ws) {
+    uintptr_t irq = spinlock_acquire_irqsave(&s_tty.lock);
+    bool changed = memcmp(&s_tty.winsize, ws, sizeof(*ws)) != 0;
+    s_tty.winsize = *ws;
+    uint32_t pgrp = s_tty.pgrp;
+    spinlock_release_irqrestore(&s_tty.lock, irq);
+
+    if (changed) tty_signal_pgrp(pgrp, 1u << SIGWINCH);
+}
+
+void tty_init(void) {
+    memset(&s_tty, 0, sizeof(s_tty));
+    spinlock_init(&s_tty.lock);
+    tty_default_termios(&s_tty.termios);
+    s_tty.winsize.ws_row = VGA_ROWS;
+    s_tty.winsize.ws_col = VGA_COLS;
+    work_init(&s_tty.work, tty_work_fn, NULL);
+    serial_write("[TTY] Console line discipline initialized\n");
+}
@@ -14,6 +14,7 @@
 #include <kernel/cpu/idt.h>          // For PIC_EOI, outb, PIC1_COMMAND, PIC2_COMMAND constants
 #include <kernel/lib/port_io.h>      // For outb, inb
 #include <kernel/cpu/isr_frame.h>
+#include <kernel/hal/irq_hal.h>      // irq_hal_eoi (PIC or local APIC)
 #include <kernel/drivers/display/terminal.h>
 #include <kernel/drivers/timer/pit.h>          // For get_pit_ticks()
 #include <kernel/lib/string.h>
@@ -70,18 +71,7 @@ static void kbc_send_command_port(uint8_t cmd);
 static bool kbc_expect_ack(const char* command_name);
 static void kbc_flush_output_buffer(const char* context);
 static void very_short_delay(void);
-extern void terminal_handle_key_event(KeyEvent event);
-static inline void pic_send_eoi(uint8_t irq);
-
-//============================================================================
-// PIC EOI Helper
-//============================================================================
-static inline void pic_send_eoi(uint8_t irq) {
-    if (irq >= 8 && irq <= 15) { 
-        outb(PIC2_COMMAND, PIC_EOI); 
-    }
-    outb(PIC1_COMMAND, PIC_EOI); 
-}
+extern void tty_handle_key_event(KeyEvent event);
 
 //============================================================================
 // KBC Helper Functions
@@ -148,7 +138,7 @@ static void keyboard_irq1_handler(isr_frame_t *frame) {
 
     if (!(status_from_kbc & KBC_SR_OBF)) {
         // No data in buffer - send EOI and return
-        pic_send_eoi(1); 
+        irq_hal_eoi(IRQ_KEYBOARD); 
         return; 
     }
     uint8_t scancode = inb(KBC_DATA_PORT);
@@ -160,12 +150,12 @@ static void keyboard_irq1_handler(isr_frame_t *frame) {
 
     if (scancode == SCANCODE_PAUSE_PREFIX) {
         keyboard_state.extended_code_active = false; 
-        pic_send_eoi(1); 
+        irq_hal_eoi(IRQ_KEYBOARD); 
         return; 
     }
     if (scancode == SCANCODE_EXTENDED_PREFIX) { 
         keyboard_state.extended_code_active = true;
-        pic_send_eoi(1); 
+        irq_hal_eoi(IRQ_KEYBOARD); 
         return; 
     }
 
@@ -196,7 +186,7 @@ static void keyboard_irq1_handler(isr_frame_t *frame) {
     }
 
     if ((kc == KEY_UNKNOWN || kc == 0) && base_scancode != 0) {
-        pic_send_eoi(1); 
+        irq_hal_eoi(IRQ_KEYBOARD); 
         return;
     }
     
@@ -237,7 +227,7 @@ static void keyboard_irq1_handler(isr_frame_t *frame) {
     spinlock_release_irqrestore(&keyboard_state.buffer_lock, buffer_irq_flags);
 
     // Send EOI before calling callback to ensure interrupts continue even if callback blocks
-    pic_send_eoi(1);
+    irq_hal_eoi(IRQ_KEYBOARD);
     
     if (keyboard_state.event_callback) {
         keyboard_state.event_callback(event);
@@ -410,8 +400,8 @@ void keyboard_init(void) {
     register_int_handler(IRQ1_VECTOR, keyboard_irq1_handler, NULL);
     serial_write("  [KB Init] IRQ1 handler registered.\n");
 
-    keyboard_register_callback(terminal_handle_key_event);
-    serial_write("  [KB Init] Registered terminal handler as callback.\n");
+    keyboard_register_callback(tty_handle_key_event);
+    serial_write("  [KB Init] Registered tty input handler as callback.\n");
 
     terminal_printf("[Keyboard] Initialized (v%s).\n", "6.5.2");
 }
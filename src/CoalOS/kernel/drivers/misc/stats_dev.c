@@ -0,0 +1,259 @@
+/**
+ * @file stats_dev.c
+ * @brief Read-only device exposing every registered percpu_counter
+ *
+ * Each open takes a text snapshot of the counter registry ("name value\n"
+ * per counter); reads and seeks then operate on that snapshot so a reader
+ * sees a consistent listing even while counters keep moving.
+ */
+
+#include <kernel/drivers/misc/stats_dev.h>
+#include <kernel/lib/percpu_counter.h>
+#include <kernel/fs/vfs/vfs.h>
+#include <kernel/fs/vfs/fs_errno.h>
+#include <kernel/drivers/display/serial.h>
+#include <kernel/memory/kmalloc.h>
+#include <kernel/lib/string.h>
+#include <libc/stddef.h>
+
+// Longest line: name + ' ' + sign + 20 digits + '\n'
+#define STATS_LINE_MAX (PERCPU_COUNTER_NAME_MAX + 24)
+
+// Snapshot attached to each open vnode
+typedef struct stats_snapshot {
+    char *text;
+    size_t len;
+} stats_snapshot_t;
+
+typedef struct stats_format_ctx {
+    char *buf;
+    size_t cap;
+    size_t len;
+} stats_format_ctx_t;
+
+static void *stats_vfs_mount(const char *device);
+static int stats_vfs_unmount(void *fs_context);
+static vnode_t *stats_vfs_open(void *fs_context, const char *path, int flags);
+static int stats_vfs_read(file_t *file, void *buffer, size_t count);
+static int stats_vfs_write(file_t *file, const void *buffer, size_t count);
+static int stats_vfs_close(file_t *file);
+static off_t stats_vfs_lseek(file_t *file, off_t offset, int whence);
+
+static vfs_driver_t stats_driver = {
+    .fs_name = "stats",
+    .mount = stats_vfs_mount,
+    .unmount = stats_vfs_unmount,
+    .open = stats_vfs_open,
+    .read = stats_vfs_read,
+    .write = stats_vfs_write,
+    .close = stats_vfs_close,
+    .lseek = stats_vfs_lseek,
+    .readdir = NULL,
+    .unlink = NULL,
+    .mkdir = NULL,
+    .rmdir = NULL,
+    .read_inode = NULL,
+    .write_inode = NULL,
+    .stat_inode = NULL,
+    .next = NULL
+};
+
+/**
+ * @brief Formats a signed 64-bit value in decimal
+ * @return Number of characters written (no terminator)
+ *
+ * Divides 16 bits at a time so no 64-bit division helper is needed.
+ */
+static size_t format_int64(char *out, int64_t value)
+{
+    uint64_t v = (value < 0) ? (uint64_t)(-(value + 1)) + 1 : (uint64_t)value;
+    uint16_t limbs[4] = {
+        (uint16_t)(v >> 48), (uint16_t)(v >> 32), (uint16_t)(v >> 16), (uint16_t)v
+    };
+    char digits[20];
+    size_t n = 0;
+
+    do {
+        uint32_t rem = 0;
+        bool nonzero = false;
+        for (int i = 0; i < 4; i++) {
+            uint32_t cur = (rem << 16) | limbs[i];
+            limbs[i] = (uint16_t)(cur / 10);
+            rem = cur % 10;
+            nonzero |= (limbs[i] != 0);
+        }
+        digits[n++] = (char)('0' + rem);
+        if (!nonzero) break;
+    } while (n < sizeof(digits));
+
+    size_t pos = 0;
+    if (value < 0) out[pos++] = '-';
+    while (n > 0) out[pos++] = digits[--n];
+    return pos;
+}
+
+static int stats_count_visit(const char *name, int64_t value, void *ctx)
+{
+    (void)name;
+    (void)value;
+    (void)ctx;
+    return 0;
+}
+
+static int stats_format_visit(const char *name, int64_t value, void *ctx)
+{
+    stats_format_ctx_t *fmt = (stats_format_ctx_t *)ctx;
+    size_t name_len = strlen(name);
+
+    // Counters registered after sizing the buffer are left for the next open
+    if (fmt->len + name_len + 24 > fmt->cap) {
+        return 1;
+    }
+
+    memcpy(fmt->buf + fmt->len, name, name_len);
+    fmt->len += name_len;
+    fmt->buf[fmt->len++] = ' ';
+    fmt->len += format_int64(fmt->buf + fmt->len, value);
+    fmt->buf[fmt->len++] = '\n';
+    return 0;
+}
+
+static void *stats_vfs_mount(const char *device)
+{
+    (void)device;
+    // Nothing to mount; VFS only needs a non-NULL context
+    return (void *)0x1;
+}
+
+static int stats_vfs_unmount(void *fs_context)
+{
+    (void)fs_context;
+    return 0;
+}
+
+static vnode_t *stats_vfs_open(void *fs_context, const char *path, int flags)
+{
+    (void)fs_context;
+    (void)path;
+
+    if ((flags & 0x003) != 0) { // Read-only device
+        return NULL;
+    }
+
+    vnode_t *vnode = (vnode_t *)kmalloc(sizeof(vnode_t));
+    stats_snapshot_t *snap = (stats_snapshot_t *)kmalloc(sizeof(stats_snapshot_t));
+    if (!vnode || !snap) {
+        if (vnode) kfree(vnode);
+        if (snap) kfree(snap);
+        return NULL;
+    }
+
+    int counters = percpu_counter_for_each(stats_count_visit, NULL);
+    stats_format_ctx_t fmt = {
+        .buf = NULL,
+        .cap = (size_t)counters * STATS_LINE_MAX,
+        .len = 0
+    };
+    if (fmt.cap > 0) {
+        fmt.buf = (char *)kmalloc(fmt.cap);
+        if (!fmt.buf) {
+            kfree(snap);
+            kfree(vnode);
+            return NULL;
+        }
+        percpu_counter_for_each(stats_format_visit, &fmt);
+    }
+
+    snap->text = fmt.buf;
+    snap->len = fmt.len;
+
+    memset(vnode, 0, sizeof(vnode_t));
+    vnode->data = snap;
+    vnode->fs_driver = &stats_driver;
+    return vnode;
+}
+
+static int stats_vfs_read(file_t *file, void *buffer, size_t count)
+{
+    if (!file || !file->vnode || !buffer) {
+        return -EINVAL;
+    }
+
+    stats_snapshot_t *snap = (stats_snapshot_t *)file->vnode->data;
+    if (file->offset < 0 || (size_t)file->offset >= snap->len) {
+        return 0;
+    }
+
+    size_t avail = snap->len - (size_t)file->offset;
+    if (count > avail) {
+        count = avail;
+    }
+    memcpy(buffer, snap->text + file->offset, count);
+    return (int)count;
+}
+
+static int stats_vfs_write(file_t *file, const void *buffer, size_t count)
+{
+    (void)file;
+    (void)buffer;
+    (void)count;
+    return -EACCES;
+}
+
+static int stats_vfs_close(file_t *file)
+{
+    if (!file || !file->vnode) {
+        return 0;
+    }
+
+    stats_snapshot_t *snap = (stats_snapshot_t *)file->vnode->data;
+    if (snap) {
+        if (snap->text) kfree(snap->text);
+        kfree(snap);
+        file->vnode->data = NULL;
+    }
+
+    kfree(file->vnode);
+    file->vnode = NULL;
+    return 0;
+}
+
+static off_t stats_vfs_lseek(file_t *file, off_t offset, int whence)
+{
+    if (!file || !file->vnode) {
+        return -EINVAL;
+    }
+
+    stats_snapshot_t *snap = (stats_snapshot_t *)file->vnode->data;
+    off_t base;
+    switch (whence) {
+        case SEEK_SET: base = 0; break;
+        case SEEK_CUR: base = file->offset; break;
+        case SEEK_END: base = (off_t)snap->len; break;
+        default: return -EINVAL;
+    }
+    if (base + offset < 0) {
+        return -EINVAL;
+    }
+    file->offset = base + offset;
+    return file->offset;
+}
+
+int stats_dev_init(void)
+{
+    int result = vfs_register_driver(&stats_driver);
+    if (result < 0) {
+        serial_printf("[Stats Device] Failed to register stats driver: %d\n", result);
+        return result;
+    }
+
+    result = vfs_mount(STATS_DEV_MOUNT_POINT, "stats", "stats");
+    if (result < 0) {
+        serial_printf("[Stats Device] Failed to mount at %s: %d\n", STATS_DEV_MOUNT_POINT, result);
+        vfs_unregister_driver(&stats_driver);
+        return result;
+    }
+
+    serial_printf("[Stats Device] Counters available at %s\n", STATS_DEV_MOUNT_POINT);
+    return 0;
+}
@@ -16,6 +16,7 @@
  #include <kernel/fs/vfs/fs_errno.h>     // For error codes (FS_ERR_*, BLOCK_ERR_*)
  #include <libc/limits.h>  // For UINTPTR_MAX
  #include <kernel/cpu/isr_frame.h>    // Include the frame definition
+ #include <kernel/hal/irq_hal.h>      // irq_hal_eoi
  #include <kernel/lib/assert.h>       // KERNEL_ASSERT (Optional, but recommended)
  #include <kernel/drivers/input/keyboard_hw.h> // <<< ADDED for KBC_STATUS_PORT constant for debug prints
  // --- ATA Register Definitions ---
@@ -464,8 +465,59 @@ terminal_printf("    -> Mult:%u SectorSize:%lu\n", // Use %u for uint16_t, %lu f
  }
 
 
+ /**
+  * @brief Issues FLUSH CACHE (EXT) and waits for it. Caller holds dev->channel_lock.
+  *
+  * Writes complete into the drive's volatile write cache; this is the only
+  * point at which they are made durable.
+  */
+ static int ata_flush_cache_locked(block_device_t *dev) {
+     if (dev->io_base != ATA_PRIMARY_IO) {
+         return BLOCK_ERR_UNSUPPORTED;
+     }
+     volatile bool *irq_fired_flag = &g_ata_primary_irq_fired;
+     volatile uint8_t *last_status_flag = &g_ata_primary_last_status;
+     volatile uint8_t *last_error_flag = &g_ata_primary_last_error;
+
+     *irq_fired_flag = false; *last_status_flag = 0; *last_error_flag = 0;
+     int sel_ret = ata_select_drive(dev);
+     if (sel_ret != BLOCK_ERR_OK) {
+         terminal_printf("[ATA %s Flush] Select drive failed before FlushCache (Err %d).\n", dev->device_name, sel_ret);
+         return sel_ret;
+     }
+     uint8_t flush_cmd = dev->lba48_supported ? ATA_CMD_FLUSH_CACHE_EXT : ATA_CMD_FLUSH_CACHE;
+     outb(dev->io_base + ATA_REG_COMMAND, flush_cmd);
+     ata_delay_400ns(dev->control_base);
+
+     uint32_t wait_loops = ATA_TIMEOUT_PIO * ATA_IRQ_WAIT_MULTIPLIER;
+     bool timed_out = true;
+     uint8_t poll_stat = 0;
+     while (wait_loops--) {
+         if (*irq_fired_flag) { timed_out = false; break; }
+         poll_stat = inb(dev->io_base + ATA_REG_STATUS);
+         if (!(poll_stat & ATA_SR_BSY)) { timed_out = false; break; }
+         asm volatile("pause");
+     }
+     if (timed_out && *irq_fired_flag) { timed_out = false; } // Final IRQ check
+
+     if (timed_out) {
+         terminal_printf("[ATA %s Flush] FlushCache timeout.\n", dev->device_name);
+         return BLOCK_ERR_TIMEOUT;
+     }
+     uint8_t final_stat = *irq_fired_flag ? *last_status_flag : poll_stat;
+     uint8_t final_err = *irq_fired_flag ? *last_error_flag : ((final_stat & ATA_SR_ERR) ? inb(dev->io_base + ATA_REG_ERROR) : 0);
+     if ((final_stat & ATA_SR_BSY) || (final_stat & (ATA_SR_ERR | ATA_SR_DF))) {
+         terminal_printf("[ATA %s Flush] FlushCache error/fault/busy (Status=%#x, Error=%#x).\n", dev->device_name, final_stat, final_err);
+         return (final_stat & ATA_SR_ERR) ? BLOCK_ERR_DEV_ERR : BLOCK_ERR_DEV_FAULT;
+     }
+     return BLOCK_ERR_OK;
+ }
+
  /**
   * @brief Reads or writes sectors to/from a block device using PIO with hybrid IRQ/Polling wait.
+  *
+  * Writes are left in the drive's write cache; block_device_flush() makes
+  * them durable.
   */
   static int block_device_transfer(block_device_t *dev, uint64_t lba, void *buffer, size_t count, bool write) {
      KERNEL_ASSERT(dev && dev->initialized && buffer && count > 0, "Invalid parameters to block_device_transfer");
@@ -586,45 +638,6 @@ terminal_printf("    -> Mult:%u SectorSize:%lu\n", // Use %u for uint16_t, %lu f
          current_buffer += sectors_this_cmd * dev->sector_size;
      } // End while(sectors_remaining > 0)
 
-     // --- Final Cache Flush --- (Logic remains similar, uses hybrid wait)
-     if (write && final_ret == BLOCK_ERR_OK) {
-         *irq_fired_flag = false; *last_status_flag = 0; *last_error_flag = 0;
-         int sel_ret = ata_select_drive(dev);
-         if (sel_ret == BLOCK_ERR_OK) {
-             uint8_t flush_cmd = dev->lba48_supported ? ATA_CMD_FLUSH_CACHE_EXT : ATA_CMD_FLUSH_CACHE;
-             outb(dev->io_base + ATA_REG_COMMAND, flush_cmd);
-             ata_delay_400ns(dev->control_base);
-
-             uint32_t wait_loops = ATA_TIMEOUT_PIO * ATA_IRQ_WAIT_MULTIPLIER;
-             bool timed_out = true;
-             // <<< FIX: Remove unused variable >>>
-             // bool cmd_done_poll = false;
-             uint8_t poll_stat = 0;
-             while(wait_loops--) {
-                 if (*irq_fired_flag) { timed_out = false; break; }
-                 poll_stat = inb(dev->io_base + ATA_REG_STATUS);
-                 if (!(poll_stat & ATA_SR_BSY)) { /*cmd_done_poll = true;*/ timed_out = false; break; } // Removed assignment
-                 asm volatile("pause");
-             }
-             if (!timed_out || *irq_fired_flag) { timed_out = false; } // Final IRQ check
-
-             if (timed_out) {
-                 terminal_printf("[ATA %s RW Write] FlushCache timeout.\n", dev->device_name);
-                 final_ret = BLOCK_ERR_TIMEOUT;
-             } else {
-                 uint8_t final_stat = *irq_fired_flag ? *last_status_flag : poll_stat;
-                 uint8_t final_err = *irq_fired_flag ? *last_error_flag : ((final_stat & ATA_SR_ERR) ? inb(dev->io_base + ATA_REG_ERROR) : 0);
-                 if ((final_stat & ATA_SR_BSY) || (final_stat & (ATA_SR_ERR | ATA_SR_DF))) {
-                     terminal_printf("[ATA %s RW Write] FlushCache error/fault/busy (Status=%#x, Error=%#x).\n", dev->device_name, final_stat, final_err);
-                     final_ret = (final_stat & ATA_SR_ERR) ? BLOCK_ERR_DEV_ERR : BLOCK_ERR_DEV_FAULT;
-                 }
-             }
-         } else {
-             terminal_printf("[ATA %s RW Write] Select drive failed before FlushCache (Err %d).\n", dev->device_name, sel_ret);
-             if (final_ret == BLOCK_ERR_OK) final_ret = sel_ret;
-         }
-     }
-
      // Release Lock and Return
      spinlock_release_irqrestore(dev->channel_lock, irq_flags);
      return final_ret;
@@ -644,6 +657,17 @@ terminal_printf("    -> Mult:%u SectorSize:%lu\n", // Use %u for uint16_t, %lu f
      return block_device_transfer(dev, lba, (void *)buffer, count, true);
  }
 
+ /**
+  * @brief Flushes the drive's volatile write cache. Public wrapper.
+  */
+ int block_device_flush(block_device_t *dev) {
+     KERNEL_ASSERT(dev && dev->initialized, "Invalid parameters to block_device_flush");
+     uintptr_t irq_flags = spinlock_acquire_irqsave(dev->channel_lock);
+     int ret = ata_flush_cache_locked(dev);
+     spinlock_release_irqrestore(dev->channel_lock, irq_flags);
+     return ret;
+ }
+
  /**
   * @brief Primary ATA IRQ Handler (IRQ 14 -> Vector 46).
   */
@@ -655,4 +679,5 @@ terminal_printf("    -> Mult:%u SectorSize:%lu\n", // Use %u for uint16_t, %lu f
       g_ata_primary_last_error = error;
       g_ata_primary_irq_fired = true;
       // serial_write('!'); // Minimal debug signal
+      irq_hal_eoi(IRQ_ATA_PRIMARY); // Handlers registered via register_int_handler must EOI
   }
\ No newline at end of file
@@ -14,31 +14,56 @@
  #include <kernel/sync/spinlock.h>
  #include <kernel/lib/string.h>
  #include <kernel/core/types.h>
+ #include <kernel/lib/percpu_counter.h>
+ #include <kernel/lib/tunables.h>
  
  // Configuration
- #define BUFFER_CACHE_HASH_SIZE     256     // Power of 2 recommended for hash distribution
+ #define BUFFER_CACHE_HASH_SIZE     256     // Default bucket count (fs.buffer_cache_hash_size)
+ #define BUFFER_CACHE_HASH_MIN      16
+ #define BUFFER_CACHE_HASH_MAX      16384
  #define DEFAULT_BUFFER_BLOCK_SIZE  512     // Standard sector size
  #define MAX_BUFFER_BLOCK_SIZE      8192    // Maximum allowed buffer size
  #define MIN_BUFFER_BLOCK_SIZE      128     // Minimum allowed buffer size
  #define BUFFER_PADDING             16      // Safety padding for buffers
  #define MAX_SECTORS_PER_IO         128     // Maximum sectors in a single I/O operation
  
- // Cache statistics (optional)
+ // Cache statistics. Per-CPU counters keep the hit path off a shared
+ // cache line; they are listed in /dev/stats under "bcache.*".
  static struct {
-     uint32_t hits;          // Cache hits
-     uint32_t misses;        // Cache misses
-     uint32_t reads;         // Disk reads performed
-     uint32_t writes;        // Disk writes performed
-     uint32_t evictions;     // Number of buffers evicted
-     uint32_t alloc_failures;// Memory allocation failures
-     uint32_t io_errors;     // I/O errors encountered
+     percpu_counter_t hits;          // Cache hits
+     percpu_counter_t misses;        // Cache misses
+     percpu_counter_t reads;         // Disk reads performed
+     percpu_counter_t writes;        // Disk writes performed
+     percpu_counter_t evictions;     // Number of buffers evicted
+     percpu_counter_t alloc_failures;// Memory allocation failures
+     percpu_counter_t io_errors;     // I/O errors encountered
  } cache_stats;
  
  // Lock for the entire buffer cache
  static spinlock_t cache_lock;
  
- // Hash table of buffer pointers
- static buffer_t *buffer_hash_table[BUFFER_CACHE_HASH_SIZE];
+ // Hash table of buffer pointers. The default-sized table is static so the
+ // cache works before buffer_cache_init(); a different fs.buffer_cache_hash_size
+ // replaces it at init, before any buffer is hashed.
+ static buffer_t *default_hash_table[BUFFER_CACHE_HASH_SIZE];
+ static buffer_t **buffer_hash_table = default_hash_table;
+ static uint32_t buffer_hash_size = BUFFER_CACHE_HASH_SIZE;  // Power of 2
+
+ static int hash_size_validate(const tunable_t *t, uint32_t value) {
+     (void)t;
+     return (value & (value - 1)) == 0 ? 0 : -EINVAL;
+ }
+
+ static tunable_t hash_size_tunable = {
+     .name = "fs.buffer_cache_hash_size",
+     .desc = "Buffer cache hash buckets (power of 2)",
+     .type = TUNABLE_U32,
+     .flags = TUNABLE_BOOT_ONLY,
+     .value = &buffer_hash_size,
+     .min = BUFFER_CACHE_HASH_MIN,
+     .max = BUFFER_CACHE_HASH_MAX,
+     .validate = hash_size_validate,
+ };
  
  // LRU list for buffer replacement
  static buffer_t *lru_head = NULL;  // Most recently used
@@ -56,7 +81,7 @@
   * Compute a high-quality hash for buffer lookup
   */
  static uint32_t buffer_hash(const char *device_name, uint32_t block_number) {
-     if (!device_name) return block_number % BUFFER_CACHE_HASH_SIZE;
+     if (!device_name) return block_number & (buffer_hash_size - 1);
  
      // FNV-1a hash algorithm
      uint32_t hash = 2166136261u; // FNV offset basis
@@ -76,7 +101,7 @@
      hash *= 16777619u;
      hash ^= ((block_number >> 24) & 0xFF);
  
-     return hash % BUFFER_CACHE_HASH_SIZE;
+     return hash & (buffer_hash_size - 1);
  }
  
  /**
@@ -149,14 +174,31 @@
      spinlock_init(&cache_lock);
      spinlock_init(&disk_registry.lock);
  
-     // Initialize hash table
-     memset(buffer_hash_table, 0, sizeof(buffer_hash_table));
+     // Initialize hash table, sized from the command line
+     tunable_register(&hash_size_tunable);
+     if (buffer_hash_size != BUFFER_CACHE_HASH_SIZE && buffer_hash_table == default_hash_table) {
+         buffer_t **table = kmalloc(sizeof(buffer_t*) * buffer_hash_size);
+         if (table) {
+             buffer_hash_table = table;
+         } else {
+             terminal_printf("[BufferCache] Cannot allocate %lu hash buckets, using %u.\n",
+                             (unsigned long)buffer_hash_size, (unsigned)BUFFER_CACHE_HASH_SIZE);
+             buffer_hash_size = BUFFER_CACHE_HASH_SIZE;
+         }
+     }
+     memset(buffer_hash_table, 0, sizeof(buffer_t*) * buffer_hash_size);
  
      // Initialize disk registry
      disk_registry.count = 0;
  
-     // Clear statistics
-     memset(&cache_stats, 0, sizeof(cache_stats));
+     // Register statistics
+     percpu_counter_init(&cache_stats.hits, "bcache.hits", 0);
+     percpu_counter_init(&cache_stats.misses, "bcache.misses", 0);
+     percpu_counter_init(&cache_stats.reads, "bcache.reads", 0);
+     percpu_counter_init(&cache_stats.writes, "bcache.writes", 0);
+     percpu_counter_init(&cache_stats.evictions, "bcache.evictions", 0);
+     percpu_counter_init(&cache_stats.alloc_failures, "bcache.alloc_failures", 0);
+     percpu_counter_init(&cache_stats.io_errors, "bcache.io_errors", 0);
  
      terminal_write("[BufferCache] Initialized buffer cache system.\n");
  }
@@ -310,7 +352,7 @@
              // Remove from LRU and hash while holding lock
              lru_remove(victim);
              buffer_remove_internal(victim);
-             cache_stats.evictions++;
+             percpu_counter_inc(&cache_stats.evictions);
  
              // Keep pointer to free outside lock
              buffer_t *victim_to_free = victim;
@@ -326,9 +368,9 @@
                  if (write_result != 0) {
                      terminal_printf("[Evict] Flush FAILED (Error %d) for block %u.\n",
                                      write_result, block_to_write);
-                     cache_stats.io_errors++;
+                     percpu_counter_inc(&cache_stats.io_errors);
                  } else {
-                     cache_stats.writes++;
+                     percpu_counter_inc(&cache_stats.writes);
                  }
              }
  
@@ -378,9 +420,9 @@
      if (result != 0) {
          terminal_printf("[BufferCache] Error: Failed to read sector %u from '%s' after %d retries.\n",
                          start_sector, disk->blk_dev.device_name, max_retries);
-         cache_stats.io_errors++;
+         percpu_counter_inc(&cache_stats.io_errors);
      } else {
-         cache_stats.reads++;
+         percpu_counter_inc(&cache_stats.reads);
      }
  
      return result;
@@ -419,12 +461,12 @@
          buf->ref_count++;
          lru_make_most_recent(buf);
          spinlock_release_irqrestore(&cache_lock, irq_state);
-         cache_stats.hits++;
+         percpu_counter_inc(&cache_stats.hits);
          return buf;
      }
  
      // Not found in cache
-     cache_stats.misses++;
+     percpu_counter_inc(&cache_stats.misses);
  
      // Try to allocate the buffer_t
      buf = (buffer_t *)kmalloc(sizeof(buffer_t));
@@ -445,6 +487,7 @@
  
          if (!buf) {
              terminal_write("[BufferCache] kmalloc failed for buffer_t even after eviction.\n");
+             percpu_counter_inc(&cache_stats.alloc_failures);
              spinlock_release_irqrestore(&cache_lock, irq_state);
              return NULL;
          }
@@ -484,6 +527,7 @@
  
          if (!buf || !buf->data) {
              terminal_write("[BufferCache] kmalloc failed for buffer data even after eviction.\n");
+             percpu_counter_inc(&cache_stats.alloc_failures);
              if (buf) {
                  // if buf->data is NULL, free buf
                  kfree(buf);
@@ -603,23 +647,27 @@
      kfree(temp_data);
  
      if (write_result != 0) {
-         cache_stats.io_errors++;
+         percpu_counter_inc(&cache_stats.io_errors);
          terminal_printf("[BufferCache] Error: Failed to write block %u to disk '%s'.\n",
                          block, disk->blk_dev.device_name);
+         // Keep the data dirty so a later sync retries it
+         irq_state = spinlock_acquire_irqsave(&cache_lock);
+         if (buf->flags & BUFFER_FLAG_VALID) buf->flags |= BUFFER_FLAG_DIRTY;
+         spinlock_release_irqrestore(&cache_lock, irq_state);
          return -FS_ERR_IO;
      }
  
-     cache_stats.writes++;
+     percpu_counter_inc(&cache_stats.writes);
  
      return 0;
  }
  
  /**
-  * Sync all dirty buffers
+  * Write back the dirty buffers of one device, or of all devices if device_name
+  * is NULL. Returns the number of buffers that failed to flush, or -1 if the
+  * dirty set could not be collected.
   */
- void buffer_cache_sync(void) {
-     terminal_write("[BufferCache] Starting full cache sync...\n");
- 
+ static int buffer_sync_matching(const char *device_name, int *flushed_out) {
      int total_flushed = 0;
      int errors = 0;
  
@@ -627,27 +675,28 @@
      uintptr_t irq_state = spinlock_acquire_irqsave(&cache_lock);
  
      // Create a copy of all dirty buffers to avoid long lock hold
-     buffer_t **dirty_buffers = kmalloc(sizeof(buffer_t*) * BUFFER_CACHE_HASH_SIZE);
+     buffer_t **dirty_buffers = kmalloc(sizeof(buffer_t*) * buffer_hash_size);
      if (!dirty_buffers) {
          spinlock_release_irqrestore(&cache_lock, irq_state);
          terminal_write("[BufferCache] Error: Failed to allocate memory for sync.\n");
-         return;
+         return -1;
      }
  
      int dirty_count = 0;
  
      // Scan all hash buckets
-     for (uint32_t i = 0; i < BUFFER_CACHE_HASH_SIZE; i++) {
+     for (uint32_t i = 0; i < buffer_hash_size; i++) {
          buffer_t *buf = buffer_hash_table[i];
          while (buf) {
-             if ((buf->flags & BUFFER_FLAG_DIRTY) && (buf->flags & BUFFER_FLAG_VALID)) {
+             if ((buf->flags & BUFFER_FLAG_DIRTY) && (buf->flags & BUFFER_FLAG_VALID) &&
+                 (!device_name || (buf->disk && strcmp(buf->disk->blk_dev.device_name, device_name) == 0))) {
                  // Increment ref count to prevent eviction during sync
                  buf->ref_count++;
                  dirty_buffers[dirty_count++] = buf;
  
                  // Resize array if needed (unlikely, but just in case)
-                 if (dirty_count >= (int)BUFFER_CACHE_HASH_SIZE && i < BUFFER_CACHE_HASH_SIZE - 1) {
-                     buffer_t **new_array = kmalloc(sizeof(buffer_t*) * BUFFER_CACHE_HASH_SIZE * 2);
+                 if (dirty_count >= (int)buffer_hash_size && i < buffer_hash_size - 1) {
+                     buffer_t **new_array = kmalloc(sizeof(buffer_t*) * buffer_hash_size * 2);
                      if (!new_array) {
                          // Decrement ref counts for buffers we've already found
                          for (int j = 0; j < dirty_count; j++) {
@@ -656,7 +705,7 @@
                          spinlock_release_irqrestore(&cache_lock, irq_state);
                          kfree(dirty_buffers);
                          terminal_write("[BufferCache] Error: Failed to resize dirty buffer array.\n");
-                         return;
+                         return -1;
                      }
                      // Copy to new array
                      memcpy(new_array, dirty_buffers, sizeof(buffer_t*) * dirty_count);
@@ -691,9 +740,55 @@
  
      kfree(dirty_buffers);
  
+     if (flushed_out) *flushed_out = total_flushed;
+     return errors;
+ }
+ 
+ /**
+  * Sync all dirty buffers and flush every registered disk's write cache
+  */
+ void buffer_cache_sync(void) {
+     terminal_write("[BufferCache] Starting full cache sync...\n");
+ 
+     int total_flushed = 0;
+     int errors = buffer_sync_matching(NULL, &total_flushed);
+     if (errors < 0) return;
+ 
+     uintptr_t irq_state = spinlock_acquire_irqsave(&disk_registry.lock);
+     disk_t *disks[MAX_REGISTERED_DISKS];
+     int disk_count = disk_registry.count;
+     memcpy(disks, disk_registry.disks, sizeof(disk_t *) * disk_count);
+     spinlock_release_irqrestore(&disk_registry.lock, irq_state);
+ 
+     for (int i = 0; i < disk_count; i++) {
+         if (disk_flush(disks[i]) != FS_SUCCESS) errors++;
+     }
+ 
      terminal_printf("[BufferCache] Sync complete: %d flushed, %d errors.\n", total_flushed, errors);
  }
  
+ /**
+  * Sync the dirty buffers of one device and flush its write cache
+  */
+ int buffer_sync_device(const char *device_name) {
+     if (!device_name) return FS_ERR_INVALID_PARAM;
+ 
+     int errors = buffer_sync_matching(device_name, NULL);
+     if (errors < 0) return FS_ERR_OUT_OF_MEMORY;
+ 
+     int result = buffer_flush_device(device_name);
+     return errors ? FS_ERR_IO : result;
+ }
+ 
+ /**
+  * Flush a device's write cache
+  */
+ int buffer_flush_device(const char *device_name) {
+     disk_t *disk = get_disk_by_name(device_name);
+     if (!disk) return FS_ERR_NOT_FOUND;
+     return disk_flush(disk) == FS_SUCCESS ? 0 : FS_ERR_IO;
+ }
+ 
  /**
   * Get buffer cache statistics
   */
@@ -702,13 +797,13 @@
  
      uintptr_t irq_state = spinlock_acquire_irqsave(&cache_lock);
  
-     stats->hits = cache_stats.hits;
-     stats->misses = cache_stats.misses;
-     stats->reads = cache_stats.reads;
-     stats->writes = cache_stats.writes;
-     stats->evictions = cache_stats.evictions;
-     stats->alloc_failures = cache_stats.alloc_failures;
-     stats->io_errors = cache_stats.io_errors;
+     stats->hits = (uint32_t)percpu_counter_sum(&cache_stats.hits);
+     stats->misses = (uint32_t)percpu_counter_sum(&cache_stats.misses);
+     stats->reads = (uint32_t)percpu_counter_sum(&cache_stats.reads);
+     stats->writes = (uint32_t)percpu_counter_sum(&cache_stats.writes);
+     stats->evictions = (uint32_t)percpu_counter_sum(&cache_stats.evictions);
+     stats->alloc_failures = (uint32_t)percpu_counter_sum(&cache_stats.alloc_failures);
+     stats->io_errors = (uint32_t)percpu_counter_sum(&cache_stats.io_errors);
  
      // Count current buffers
      stats->cached_buffers = 0;
@@ -737,7 +832,7 @@
      int invalidated = 0;
  
      // Check all hash buckets
-     for (uint32_t i = 0; i < BUFFER_CACHE_HASH_SIZE; i++) {
+     for (uint32_t i = 0; i < buffer_hash_size; i++) {
          buffer_t **pp = &buffer_hash_table[i];
          while (*pp) {
              buffer_t *buf = *pp;
@@ -771,4 +866,39 @@
      terminal_printf("[BufferCache] Invalidated %d buffers for device '%s'.\n",
                      invalidated, device_name);
  }
- 
\ No newline at end of file
+  
+ /**
+  * Write back and optionally drop the buffers of a block range
+  */
+ int buffer_sync_range(const char *device_name, uint32_t first_block, uint32_t count, bool invalidate) {
+     if (!device_name) return FS_ERR_INVALID_PARAM;
+ 
+     int result = 0;
+     for (uint32_t block = first_block; block < first_block + count; block++) {
+         uintptr_t irq_state = spinlock_acquire_irqsave(&cache_lock);
+         buffer_t *buf = buffer_lookup_internal(device_name, block);
+         if (!buf) {
+             spinlock_release_irqrestore(&cache_lock, irq_state);
+             continue;
+         }
+ 
+         if ((buf->flags & BUFFER_FLAG_DIRTY) && (buf->flags & BUFFER_FLAG_VALID)) {
+             // Pin across the flush, as buffer_cache_sync does
+             buf->ref_count++;
+             spinlock_release_irqrestore(&cache_lock, irq_state);
+             if (buffer_flush(buf) != 0) result = FS_ERR_IO;
+             irq_state = spinlock_acquire_irqsave(&cache_lock);
+             buf->ref_count--;
+         }
+ 
+         // Buffers still referenced by another operation are left in place
+         if (invalidate && buf->ref_count == 0 && !(buf->flags & BUFFER_FLAG_DIRTY)) {
+             buffer_remove_internal(buf);
+             lru_remove(buf);
+             kfree(buf->data);
+             kfree(buf);
+         }
+         spinlock_release_irqrestore(&cache_lock, irq_state);
+     }
+     return result;
+ }
@@ -171,6 +171,24 @@
      }
      return ret;
  }
+
+ /**
+  * @brief Makes all completed writes to the disk durable.
+  * Writes land in the drive's volatile cache; this issues a cache flush.
+  * @param disk Pointer to the initialized disk_t structure.
+  * @return FS_SUCCESS on success, negative error code on failure.
+  */
+ int disk_flush(disk_t *disk) {
+     if (!disk || !disk->initialized) {
+         return FS_ERR_INVALID_PARAM;
+     }
+     int ret = block_device_flush(&disk->blk_dev);
+     if (ret != FS_SUCCESS) {
+         terminal_printf("[Disk] flush: Cache flush failed on '%s' (err %d).\n", disk->blk_dev.device_name, ret);
+         return FS_ERR_IO;
+     }
+     return FS_SUCCESS;
+ }
  
  
  /**
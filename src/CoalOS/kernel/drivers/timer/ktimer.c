@@ -0,0 +1,109 @@
+/**
+ * @file ktimer.c
+ * @brief Tick-driven kernel timer list
+ *
+ * Pending timers sit on one list sorted by expiry (wrap-safe comparison), the
+ * same structure the scheduler uses for its sleep queue. Expired timers are
+ * unlinked under the lock and their callbacks run with the lock dropped.
+ */
+
+#include <kernel/drivers/timer/ktimer.h>
+#include <kernel/process/scheduler.h>
+#include <kernel/sync/spinlock.h>
+#include <libc/stddef.h>
+
+static ktimer_t *g_timer_head = NULL;
+static spinlock_t g_timer_lock = { 0 };
+
+// a is at or after b, tolerating tick counter wrap
+static inline bool tick_after_eq(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) >= 0;
+}
+
+static void ktimer_unlink_locked(ktimer_t *timer) {
+    if (timer->prev) {
+        timer->prev->next = timer->next;
+    } else {
+        g_timer_head = timer->next;
+    }
+    if (timer->next) {
+        timer->next->prev = timer->prev;
+    }
+    timer->next = timer->prev = NULL;
+    timer->pending = false;
+}
+
+void ktimer_init(ktimer_t *timer, ktimer_fn_t fn, void *data) {
+    if (!timer) return;
+    timer->expires = 0;
+    timer->fn = fn;
+    timer->data = data;
+    timer->next = timer->prev = NULL;
+    timer->pending = false;
+}
+
+void ktimer_arm_at(ktimer_t *timer, uint32_t expires) {
+    if (!timer || !timer->fn) return;
+
+    uintptr_t flags = spinlock_acquire_irqsave(&g_timer_lock);
+    if (timer->pending) {
+        ktimer_unlink_locked(timer);
+    }
+    timer->expires = expires;
+
+    // Insert after every timer expiring at or before us (FIFO for ties)
+    ktimer_t *prev = NULL;
+    ktimer_t *cur = g_timer_head;
+    while (cur && tick_after_eq(expires, cur->expires)) {
+        prev = cur;
+        cur = cur->next;
+    }
+    timer->prev = prev;
+    timer->next = cur;
+    if (prev) prev->next = timer; else g_timer_head = timer;
+    if (cur) cur->prev = timer;
+    timer->pending = true;
+    spinlock_release_irqrestore(&g_timer_lock, flags);
+}
+
+void ktimer_arm(ktimer_t *timer, uint32_t delta) {
+    if (delta == 0) delta = 1;
+    if (delta > KTIMER_MAX_DELTA) delta = KTIMER_MAX_DELTA;
+    ktimer_arm_at(timer, ktimer_now() + delta);
+}
+
+bool ktimer_cancel(ktimer_t *timer) {
+    if (!timer) return false;
+
+    uintptr_t flags = spinlock_acquire_irqsave(&g_timer_lock);
+    bool was_pending = timer->pending;
+    if (was_pending) {
+        ktimer_unlink_locked(timer);
+    }
+    spinlock_release_irqrestore(&g_timer_lock, flags);
+    return was_pending;
+}
+
+uint32_t ktimer_remaining(const ktimer_t *timer) {
+    if (!timer || !timer->pending) return 0;
+    uint32_t now = ktimer_now();
+    return tick_after_eq(now, timer->expires) ? 0 : timer->expires - now;
+}
+
+void ktimer_run_expired(uint32_t now) {
+    uintptr_t flags = spinlock_acquire_irqsave(&g_timer_lock);
+    while (g_timer_head && tick_after_eq(now, g_timer_head->expires)) {
+        ktimer_t *timer = g_timer_head;
+        ktimer_unlink_locked(timer);
+
+        // Callback may re-arm this timer or touch others
+        spinlock_release_irqrestore(&g_timer_lock, flags);
+        timer->fn(timer);
+        flags = spinlock_acquire_irqsave(&g_timer_lock);
+    }
+    spinlock_release_irqrestore(&g_timer_lock, flags);
+}
+
+uint32_t ktimer_now(void) {
+    return scheduler_get_ticks();
+}
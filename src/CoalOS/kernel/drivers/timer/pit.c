@@ -10,9 +10,12 @@
  #include <kernel/drivers/timer/pit.h>
  #include <kernel/cpu/idt.h>       // Needed for register_int_handler and PIC/EOI defines
  #include <kernel/cpu/isr_frame.h>  // Include the frame definition
+ #include <kernel/hal/irq_hal.h>    // irq_hal_eoi
  #include <kernel/drivers/display/terminal.h>
  #include <kernel/lib/port_io.h>   // For outb, io_wait
  #include <kernel/process/scheduler.h> // Need scheduler_tick() declaration
+ #include <kernel/process/signal.h>    // CPU-time interval timers
+ #include <kernel/process/cputime.h>   // Tick-based CPU time fallback
  #include <kernel/core/types.h>     // Ensure bool is defined via types.h -> stdbool.h
  #include <kernel/lib/assert.h>    // For KERNEL_ASSERT
  #include <libc/stdint.h> // For UINT32_MAX
@@ -23,16 +26,6 @@
  #define TARGET_FREQUENCY 1000 // Default to 1000 Hz if not defined
  #endif
 
- // PIC EOI definitions (can also be from idt.h or a dedicated pic.h)
- #ifndef PIC_EOI
- #define PIC_EOI      0x20      /* End-of-interrupt command code */
- #endif
- #ifndef PIC1_COMMAND
- #define PIC1_COMMAND 0x20
- #endif
- #ifndef PIC2_COMMAND
- #define PIC2_COMMAND 0xA0
- #endif
  #define IRQ_PIT 0         // Timer is IRQ line 0 on the master PIC
 
  // --- Revised Workaround Helper ---
@@ -83,44 +76,22 @@
      return total_ticks;
  }
 
-/**
- * @brief Sends End-Of-Interrupt (EOI) to the PIC(s).
- * @param irq_line The IRQ line number (0-15) that was serviced.
- */
-static inline void pic_send_eoi_line(uint8_t irq_line)
-{
-    if (irq_line >= 8) { // IRQ 8-15 are on the slave PIC
-        outb(PIC2_COMMAND, PIC_EOI);
-    }
-    outb(PIC1_COMMAND, PIC_EOI); // Always send EOI to master PIC
-}
-
  /**
   * PIT IRQ handler:
-  * Performs essential timekeeping (implicitly via scheduler_tick's start),
-  * ACKs the interrupt with the PIC *before* potentially rescheduling,
-  * then calls the scheduler logic which might switch tasks.
+  * ACKs the interrupt with the interrupt controller, then runs the scheduler tick. The tick
+  * only accounts time and flags TIF_NEED_RESCHED; the actual switch happens
+  * in irq_exit() once the handler has returned.
   */
  static void pit_irq_handler(isr_frame_t *frame) {
-     (void)frame;    // Mark frame as unused if not directly accessed
+     irq_hal_eoi(IRQ_PIT); // EOI for IRQ 0 (timer) via the PIC or local APIC
 
-     // Debug counter removed - interrupts verified working
-
-     // As per the latest advice:
-     // 1. Timekeeping / scheduler-tick bookkeeping (scheduler_tick() handles g_tick_count++)
-     // 2. ACK the interrupt **before** doing anything that may reschedule.
-     // 3. Hand control to the scheduler (scheduler_tick() may call schedule()).
-
-     // Increment tick count (this happens as the first step in scheduler_tick)
-     // If scheduler_tick() were not called, and this handler directly called schedule(),
-     // then g_tick_count++ would happen here.
-
-     pic_send_eoi_line(IRQ_PIT); // Send EOI for IRQ 0 (timer) *BEFORE* scheduler_tick
-
-     // Now, call the scheduler's tick processing.
-     // This function handles g_tick_count increment, waking sleeping tasks,
-     // managing time slices, and potentially calling schedule().
+     // Handles g_tick_count increment, waking sleeping tasks and time slices.
      scheduler_tick();
+
+     // Tick-granular CPU time until the TSC is calibrated, then the
+     // interval timers that consume it
+     cputime_tick(frame && (frame->cs & 3) == 3);
+     signal_handle_timer_signals();
  }
 
  uint32_t get_pit_ticks(void) {
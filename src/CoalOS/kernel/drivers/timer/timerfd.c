@@ -0,0 +1,199 @@
+/**
+ * @file timerfd.c
+ * @brief timerfd: expiration counters exposed as read-only files
+ *
+ * Each timerfd is an anonymous vnode (no mount point) whose data is the
+ * timer state below. The expiry callback bumps the counter and wakes the
+ * reader blocked in read(), the same hand-off the terminal uses for line
+ * input.
+ */
+
+#include <kernel/drivers/timer/timerfd.h>
+#include <kernel/drivers/timer/ktimer.h>
+#include <kernel/fs/vfs/sys_file.h>
+#include <kernel/fs/vfs/fs_errno.h>
+#include <kernel/process/scheduler.h>
+#include <kernel/memory/kmalloc.h>
+#include <kernel/sync/spinlock.h>
+#include <kernel/lib/string.h>
+#include <libc/stddef.h>
+
+typedef struct timerfd {
+    ktimer_t  timer;
+    int       clockid;
+    uint32_t  interval;      // Reload in ticks (0 = one-shot)
+    uint32_t  expirations;   // Expiries since the last read
+    tcb_t    *waiter;        // Reader blocked in read()
+} timerfd_t;
+
+static int timerfd_vfs_read(file_t *file, void *buffer, size_t count);
+static int timerfd_vfs_write(file_t *file, const void *buffer, size_t count);
+static int timerfd_vfs_close(file_t *file);
+
+// Never registered or mounted: timerfds are only reachable through their fd
+static vfs_driver_t timerfd_driver = {
+    .fs_name = "timerfd",
+    .read = timerfd_vfs_read,
+    .write = timerfd_vfs_write,
+    .close = timerfd_vfs_close,
+};
+
+static timerfd_t *timerfd_from_file(file_t *file) {
+    if (!file || !file->vnode || file->vnode->fs_driver != &timerfd_driver) {
+        return NULL;
+    }
+    return (timerfd_t *)file->vnode->data;
+}
+
+static void timerfd_expired(ktimer_t *timer) {
+    timerfd_t *tfd = (timerfd_t *)timer->data;
+
+    if (tfd->interval) {
+        ktimer_arm(&tfd->timer, tfd->interval);
+    }
+    if (tfd->expirations != UINT32_MAX) {
+        tfd->expirations++;
+    }
+
+    tcb_t *waiter = tfd->waiter;
+    if (waiter) {
+        tfd->waiter = NULL;
+        scheduler_unblock_task(waiter);
+    }
+}
+
+int timerfd_create(int clockid, int flags) {
+    if (clockid != CLOCK_REALTIME && clockid != CLOCK_MONOTONIC) return -EINVAL;
+    if (flags & ~(TFD_NONBLOCK | TFD_CLOEXEC)) return -EINVAL;
+
+    timerfd_t *tfd = kmalloc(sizeof(*tfd));
+    vnode_t *vnode = kmalloc(sizeof(*vnode));
+    file_t *file = kmalloc(sizeof(*file));
+    if (!tfd || !vnode || !file) {
+        if (tfd) kfree(tfd);
+        if (vnode) kfree(vnode);
+        if (file) kfree(file);
+        return -ENOMEM;
+    }
+
+    memset(tfd, 0, sizeof(*tfd));
+    ktimer_init(&tfd->timer, timerfd_expired, tfd);
+    tfd->clockid = clockid;
+
+    vnode->data = tfd;
+    vnode->fs_driver = &timerfd_driver;
+
+    file->vnode = vnode;
+    file->flags = O_RDONLY | (flags & TFD_NONBLOCK);
+    file->offset = 0;
+    spinlock_init(&file->lock);
+    file->refcount = 1;
+
+    return sys_file_install(file, (int)file->flags);
+}
+
+static void timerfd_read_setting(const timerfd_t *tfd, k_itimerspec_t *cur) {
+    uint32_t value = ktimer_remaining(&tfd->timer);
+    if (tfd->timer.pending && value == 0) value = 1;
+    itimer_ticks_to_timespec(value, &cur->it_value);
+    itimer_ticks_to_timespec(tfd->interval, &cur->it_interval);
+}
+
+int timerfd_settime(file_t *file, int flags, const k_itimerspec_t *val,
+                    k_itimerspec_t *old) {
+    timerfd_t *tfd = timerfd_from_file(file);
+    if (!tfd || !val) return -EINVAL;
+    if (flags & ~TFD_TIMER_ABSTIME) return -EINVAL;
+
+    uint32_t value, interval;
+    if (itimer_timespec_to_ticks(&val->it_value, &value) < 0 ||
+        itimer_timespec_to_ticks(&val->it_interval, &interval) < 0) {
+        return -EINVAL;
+    }
+
+    uintptr_t irq = local_irq_save();
+    if (old) {
+        timerfd_read_setting(tfd, old);
+    }
+    ktimer_cancel(&tfd->timer);
+    tfd->interval = value ? interval : 0;
+    tfd->expirations = 0;
+    if (value) {
+        if (flags & TFD_TIMER_ABSTIME) {
+            uint32_t now = ktimer_now();
+            ktimer_arm_at(&tfd->timer, (int32_t)(value - now) > 0 ? value : now);
+        } else {
+            ktimer_arm(&tfd->timer, value);
+        }
+    }
+    local_irq_restore(irq);
+    return 0;
+}
+
+int timerfd_gettime(file_t *file, k_itimerspec_t *cur) {
+    timerfd_t *tfd = timerfd_from_file(file);
+    if (!tfd || !cur) return -EINVAL;
+
+    uintptr_t irq = local_irq_save();
+    timerfd_read_setting(tfd, cur);
+    local_irq_restore(irq);
+    return 0;
+}
+
+//============================================================================
+// VFS Operations
+//============================================================================
+
+static int timerfd_vfs_read(file_t *file, void *buffer, size_t count) {
+    timerfd_t *tfd = timerfd_from_file(file);
+    if (!tfd || !buffer) return -EINVAL;
+    if (count < sizeof(uint64_t)) return -EINVAL;
+
+    for (;;) {
+        uintptr_t irq = local_irq_save();
+        uint32_t expirations = tfd->expirations;
+        if (expirations) {
+            tfd->expirations = 0;
+            local_irq_restore(irq);
+
+            uint64_t value = expirations;
+            memcpy(buffer, &value, sizeof(value));
+            return (int)sizeof(value);
+        }
+
+        if (file->flags & TFD_NONBLOCK) {
+            local_irq_restore(irq);
+            return -EAGAIN;
+        }
+
+        tcb_t *current = get_current_task();
+        if (!current) {
+            local_irq_restore(irq);
+            return -EFAULT;
+        }
+        if (tfd->waiter && tfd->waiter != current) {
+            local_irq_restore(irq);
+            return -EBUSY;
+        }
+        tfd->waiter = current;
+        current->state = TASK_BLOCKED;
+        local_irq_restore(irq);
+
+        schedule();
+    }
+}
+
+static int timerfd_vfs_write(file_t *file, const void *buffer, size_t count) {
+    (void)file; (void)buffer; (void)count;
+    return -EINVAL;
+}
+
+static int timerfd_vfs_close(file_t *file) {
+    timerfd_t *tfd = timerfd_from_file(file);
+    if (!tfd) return -EINVAL;
+
+    ktimer_cancel(&tfd->timer);
+    file->vnode->data = NULL;
+    kfree(tfd);
+    return 0;
+}
@@ -22,10 +22,12 @@
  // Implemented in fat_fs.c
  extern void *fat_mount_internal(const char *device);
  extern int   fat_unmount_internal(void *fs_context);
+ extern int   fat_syncfs_internal(void *fs_context);
  
  // Implemented in fat_dir.c
  extern vnode_t *fat_open_internal(void *fs_context, const char *path, int flags);
  extern int      fat_readdir_internal(file_t *dir_file, struct dirent *d_entry_out, size_t entry_index);
+ extern int      fat_getdents_internal(file_t *dir_file, vfs_filldir_t filldir, void *ctx);
  extern int      fat_unlink_internal(void *fs_context, const char *path);
  
  // Implemented in fat_dir_ops.c
@@ -37,6 +39,8 @@
  extern int   fat_write_internal(file_t *file, const void *buf, size_t len);
  extern int   fat_close_internal(file_t *file);
  extern off_t fat_lseek_internal(file_t *file, off_t offset, int whence);
+ extern int   fat_fstat_internal(file_t *file, struct stat *st);
+ extern int   fat_fsync_internal(file_t *file, bool datasync);
  
  /* --- Static VFS Driver Structure --- */
  // Defines the FAT filesystem driver interface for the VFS.
@@ -50,10 +54,13 @@
      .close   = fat_close_internal,    // Close function pointer
      .lseek   = fat_lseek_internal,    // Lseek function pointer
      .readdir = fat_readdir_internal,  // Readdir function pointer
+     .getdents = fat_getdents_internal, // Batched readdir with position cookies
      .unlink  = fat_unlink_internal,   // Unlink function pointer
     .mkdir   = fat_mkdir_internal,    // Mkdir function pointer
     .rmdir   = fat_rmdir_internal,    // Rmdir function pointer
-     // Add .stat, etc. here if/when implemented
+     .fstat   = fat_fstat_internal,    // Identity/size/mtime of an open file
+     .fsync   = fat_fsync_internal,    // Ordered writeback of one file
+     .syncfs  = fat_syncfs_internal,   // FAT table and all buffers of the mount
      .next    = NULL                 // Linked list pointer for VFS internal use
  };
  
@@ -68,6 +68,7 @@ int fat_dir_io_update_entry(fat_fs_t *fs,
     memcpy(b->data + offset_in_sector, new_entry, sizeof(fat_dir_entry_t));
     buffer_mark_dirty(b);
     buffer_release(b);
+    fs->dir_generation++;
     
     FAT_DEBUG_LOG("Updated directory entry at cluster=%lu, offset=%lu (LBA %lu)",
                   (unsigned long)dir_cluster, (unsigned long)dir_offset, (unsigned long)lba);
@@ -126,7 +127,10 @@ int fat_dir_io_mark_entries_deleted(fat_fs_t *fs,
                          (unsigned long)entries_marked, (unsigned long)current_offset - sizeof(fat_dir_entry_t));
         }
         
-        if (buffer_dirtied) buffer_mark_dirty(b);
+        if (buffer_dirtied) {
+            buffer_mark_dirty(b);
+            fs->dir_generation++;
+        }
         buffer_release(b);
         
         if (result != FS_SUCCESS) break;
@@ -195,6 +199,7 @@ int fat_dir_io_write_entries(fat_fs_t *fs, uint32_t dir_cluster,
         memcpy(b->data + offset_in_sector, src_buf + bytes_written, bytes_to_write_this_sector);
         buffer_mark_dirty(b);
         buffer_release(b);
+        fs->dir_generation++;
         bytes_written += bytes_to_write_this_sector;
         
         FAT_DEBUG_LOG("Wrote %lu bytes to LBA %lu (total written: %lu/%lu)",
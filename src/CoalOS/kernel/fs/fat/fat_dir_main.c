@@ -44,6 +44,11 @@ int fat_readdir_internal(file_t *dir_file, struct dirent *d_entry_out, size_t en
     return fat_dir_reader_readdir_internal(dir_file, d_entry_out, entry_index);
 }
 
+int fat_getdents_internal(file_t *dir_file, vfs_filldir_t filldir, void *ctx)
+{
+    return fat_dir_reader_getdents(dir_file, filldir, ctx);
+}
+
 int fat_unlink_internal(void *fs_context, const char *path)
 {
     FAT_DEBUG_LOG("Delegating to fat_dir_operations_unlink_internal");
@@ -42,6 +42,15 @@ vnode_t *fat_open_internal(void *fs_context, const char *path, int flags);
  */
 int fat_readdir_internal(file_t *dir_file, struct dirent *d_entry_out, size_t entry_index);
 
+/**
+ * @brief Read a batch of directory entries starting at the file's position cookie
+ * @param dir_file File handle for directory being read
+ * @param filldir Emitter called per entry; non-zero return stops iteration
+ * @param ctx Opaque pointer passed to filldir
+ * @return Number of entries emitted (0 at end of directory), or error code
+ */
+int fat_getdents_internal(file_t *dir_file, vfs_filldir_t filldir, void *ctx);
+
 /**
  * @brief Unlink (delete) a file from the FAT filesystem
  * @param fs_context FAT filesystem context
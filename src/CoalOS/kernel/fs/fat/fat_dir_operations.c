@@ -369,6 +369,8 @@ vnode_t *fat_dir_operations_create_vnode(fat_fs_t *fs, const fat_dir_entry_t *en
     file_ctx->file_size           = entry->file_size;
     file_ctx->dir_entry_cluster   = entry_dir_cluster;
     file_ctx->dir_entry_offset    = entry_offset;
+    file_ctx->write_time          = entry->write_time;
+    file_ctx->write_date          = entry->write_date;
     file_ctx->is_directory        = (entry->attr & FAT_ATTR_DIRECTORY);
     file_ctx->dirty               = (was_created || was_truncated);
     file_ctx->readdir_current_cluster = file_ctx->is_directory ? first_cluster_final : 0;
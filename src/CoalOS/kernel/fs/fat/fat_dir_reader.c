@@ -7,6 +7,13 @@
  * @details Handles directory reading operations including readdir functionality,
  * LFN reconstruction, and directory entry iteration. Manages directory traversal
  * state and provides dirent structures to VFS layer.
+ *
+ * Batched reads (getdents) use byte-offset position cookies into the directory
+ * data stream. A cookie always points at the first slot of the next entry to
+ * return, so resuming seeks straight to it by walking the in-memory FAT chain
+ * from the nearest cached cluster instead of rescanning entries. One cluster of
+ * raw directory data is cached per open directory and invalidated through
+ * fs->dir_generation whenever any directory entry is written.
  */
 
 //============================================================================
@@ -18,6 +25,7 @@
 #include <kernel/fs/fat/fat_dir.h>
 #include <kernel/fs/fat/fat_utils.h>
 #include <kernel/fs/fat/fat_lfn.h>
+#include <kernel/fs/fat/fat_io.h>
 #include <kernel/fs/vfs/fs_errno.h>
 #include <kernel/sync/spinlock.h>
 #include <kernel/memory/kmalloc.h>
@@ -263,6 +271,175 @@ readdir_done:
     return ret;
 }
 
+//============================================================================
+// Batched Directory Reading Implementation
+//============================================================================
+
+/**
+ * @brief Ensure the cluster-sized directory block containing pos is cached
+ * @return FS_SUCCESS, FS_ERR_NOT_FOUND past the end of the directory, or error
+ * @note Caller must hold fs->lock
+ */
+static int fat_dir_reader_load_block(fat_fs_t *fs, fat_file_context_t *fctx, uint32_t pos)
+{
+    uint32_t block_size = fs->cluster_size_bytes;
+    uint32_t base = pos - (pos % block_size);
+    bool is_fat12_16_root = (fs->type != FAT_TYPE_FAT32 && fctx->first_cluster == 0);
+
+    if (fctx->dirblock_data && fctx->dirblock_len > 0 && fctx->dirblock_base == base &&
+        fctx->dirblock_generation == fs->dir_generation) {
+        return FS_SUCCESS;
+    }
+
+    uint32_t cluster = 0;
+    uint32_t len = block_size;
+
+    if (is_fat12_16_root) {
+        uint32_t root_size = fs->root_dir_sectors * fs->bytes_per_sector;
+        if (base >= root_size) return FS_ERR_NOT_FOUND;
+        if (len > root_size - base) len = root_size - base;
+    } else {
+        // Walk the chain from the cached cluster when seeking forward, else from the start.
+        // The cluster chain of a live directory only ever grows, so the hint stays valid
+        // even when the cached block contents are stale.
+        uint32_t walk_base = 0;
+        cluster = fctx->first_cluster;
+        if (fctx->dirblock_cluster >= 2 && fctx->dirblock_base <= base) {
+            cluster = fctx->dirblock_cluster;
+            walk_base = fctx->dirblock_base;
+        }
+        if (cluster < 2) return FS_ERR_NOT_FOUND;
+
+        for (uint32_t hops = (base - walk_base) / block_size; hops > 0; hops--) {
+            uint32_t next_cluster;
+            int res = fat_get_next_cluster(fs, cluster, &next_cluster);
+            if (res != FS_SUCCESS) return res;
+            if (next_cluster < 2 || next_cluster >= fs->eoc_marker) return FS_ERR_NOT_FOUND;
+            cluster = next_cluster;
+        }
+    }
+
+    if (!fctx->dirblock_data) {
+        fctx->dirblock_data = kmalloc(block_size);
+        if (!fctx->dirblock_data) {
+            FAT_ERROR_LOG("Failed to allocate directory block cache (%lu bytes)", (unsigned long)block_size);
+            return FS_ERR_OUT_OF_MEMORY;
+        }
+    }
+
+    int read_res = read_cluster_cached(fs, cluster, is_fat12_16_root ? base : 0,
+                                       fctx->dirblock_data, len);
+    if (read_res < 0) {
+        FAT_ERROR_LOG("Failed to read directory block at offset %lu (err %d)", (unsigned long)base, read_res);
+        fctx->dirblock_len = 0;
+        fctx->dirblock_cluster = 0;
+        return read_res;
+    }
+
+    fctx->dirblock_base = base;
+    fctx->dirblock_len = len;
+    fctx->dirblock_cluster = cluster;
+    fctx->dirblock_generation = fs->dir_generation;
+    return FS_SUCCESS;
+}
+
+int fat_dir_reader_getdents(file_t *dir_file, vfs_filldir_t filldir, void *ctx)
+{
+    if (!dir_file || !dir_file->vnode || !dir_file->vnode->data || !filldir) {
+        return FS_ERR_INVALID_PARAM;
+    }
+
+    fat_file_context_t *fctx = (fat_file_context_t*)dir_file->vnode->data;
+    if (!fctx->fs || !fctx->is_directory) {
+        return FS_ERR_NOT_A_DIRECTORY;
+    }
+    if (dir_file->offset < 0) {
+        return FS_ERR_INVALID_PARAM;
+    }
+
+    fat_fs_t *fs = fctx->fs;
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&fs->lock);
+
+    // Cookies handed out always sit on a slot boundary; round anything else up to one
+    uint32_t pos = ((uint32_t)dir_file->offset + sizeof(fat_dir_entry_t) - 1) &
+                   ~(uint32_t)(sizeof(fat_dir_entry_t) - 1);
+
+    fat_lfn_entry_t lfn_collector[FAT_MAX_LFN_ENTRIES];
+    char final_name[FAT_MAX_LFN_CHARS];
+    int lfn_count = 0;
+    int emitted = 0;
+    int ret = FS_SUCCESS;
+
+    while (true) {
+        int load_res = fat_dir_reader_load_block(fs, fctx, pos);
+        if (load_res == FS_ERR_NOT_FOUND) break;
+        if (load_res != FS_SUCCESS) {
+            ret = load_res;
+            break;
+        }
+
+        const uint8_t *block = fctx->dirblock_data;
+        uint32_t block_end = fctx->dirblock_base + fctx->dirblock_len;
+
+        for (; pos < block_end; pos += sizeof(fat_dir_entry_t)) {
+            const fat_dir_entry_t *dent = (const fat_dir_entry_t*)(block + (pos - fctx->dirblock_base));
+            uint32_t next_pos = pos + sizeof(fat_dir_entry_t);
+
+            if (dent->name[0] == FAT_DIR_ENTRY_UNUSED) {
+                // Leave the cookie here so entries created later are still returned
+                goto getdents_done;
+            }
+
+            if (dent->name[0] == FAT_DIR_ENTRY_DELETED) {
+                lfn_count = 0;
+                dir_file->offset = next_pos;
+                continue;
+            }
+
+            if ((dent->attr & FAT_ATTR_LONG_NAME_MASK) == FAT_ATTR_LONG_NAME) {
+                if (lfn_count < FAT_MAX_LFN_ENTRIES) {
+                    lfn_collector[lfn_count++] = *(const fat_lfn_entry_t*)dent;
+                } else {
+                    lfn_count = 0;
+                }
+                continue;
+            }
+
+            if (dent->attr & FAT_ATTR_VOLUME_ID) {
+                lfn_count = 0;
+                dir_file->offset = next_pos;
+                continue;
+            }
+
+            final_name[0] = '\0';
+            if (lfn_count > 0 && lfn_collector[0].checksum == fat_calculate_lfn_checksum(dent->name)) {
+                fat_reconstruct_lfn(lfn_collector, lfn_count, final_name, sizeof(final_name));
+            }
+            if (final_name[0] == '\0') {
+                uint8_t short_name[11];
+                memcpy(short_name, dent->name, sizeof(short_name));
+                if (short_name[0] == FAT_DIR_ENTRY_KANJI) short_name[0] = FAT_DIR_ENTRY_DELETED;
+                fat_dir_reader_format_short_name(short_name, final_name);
+            }
+            lfn_count = 0;
+
+            uint8_t d_type = (dent->attr & FAT_ATTR_DIRECTORY) ? DT_DIR : DT_REG;
+            if (filldir(ctx, final_name, strlen(final_name), fat_get_entry_cluster(dent),
+                        d_type, (off_t)next_pos) != 0) {
+                // Caller is full; the cookie still points at this entry (or its LFN run)
+                goto getdents_done;
+            }
+
+            dir_file->offset = next_pos;
+            emitted++;
+        }
+    }
+
+getdents_done:
+    spinlock_release_irqrestore(&fs->lock, irq_flags);
+    return (ret != FS_SUCCESS && emitted == 0) ? ret : emitted;
+}
+
 //============================================================================
 // Helper Function Implementations
 //============================================================================
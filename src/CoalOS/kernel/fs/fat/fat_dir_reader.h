@@ -34,6 +34,15 @@
 int fat_dir_reader_readdir_internal(file_t *dir_file, struct dirent *d_entry_out, 
                                     size_t entry_index);
 
+/**
+ * @brief Emit as many directory entries as the caller accepts in one pass
+ * @param dir_file File handle for directory being read; offset is the position cookie
+ * @param filldir Emitter called per entry with the cookie of the following entry
+ * @param ctx Opaque pointer passed to filldir
+ * @return Number of entries emitted (0 at end of directory), or error code
+ */
+int fat_dir_reader_getdents(file_t *dir_file, vfs_filldir_t filldir, void *ctx);
+
 //============================================================================
 // Internal Helper Functions
 //============================================================================
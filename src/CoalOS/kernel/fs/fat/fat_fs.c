@@ -35,6 +35,16 @@
   */
  static int flush_fat_table(fat_fs_t *fs);
  
+ /**
+  * @brief Copies in-memory FAT sectors into the buffer cache for every FAT copy.
+  * @param fs Pointer to the fat_fs_t structure containing the FAT table.
+  * @param first_sector First sector index within one FAT.
+  * @param count Number of sectors.
+  * @param written_out Incremented for each cached sector that changed (may be NULL).
+  * @return Number of sectors that could not be updated.
+  */
+ static int copy_fat_sectors(fat_fs_t *fs, uint32_t first_sector, uint32_t count, int *written_out);
+ 
  
  /* --- VFS Mount/Unmount Implementations --- */
  
@@ -256,9 +266,8 @@
      // 2. Optionally sync the entire buffer cache for the device. Good practice.
      //    This ensures directory entries, data blocks etc. are written out.
      if (fs->disk_ptr && fs->disk_ptr->blk_dev.device_name) {
-         // Corrected: Replace missing buffer_cache_sync_device with buffer_cache_sync
-         buffer_cache_sync(); // Sync all dirty buffers across all devices
-         terminal_printf("[FAT Unmount] Called buffer_cache_sync().\n");
+         buffer_sync_device(fs->disk_ptr->blk_dev.device_name); // Sync this device's buffers and its write cache
+         terminal_printf("[FAT Unmount] Synced buffers of %s.\n", dev_name);
      }
  
      // 3. Release the lock before freeing the context structure itself
@@ -364,35 +373,7 @@
  
      terminal_printf("[FAT Flush FAT] Flushing %u modified FAT sectors via buffer cache...\n", fs->fat_size_sectors);
      int sectors_written = 0;
-     int errors_encountered = 0;
-     const uint8_t *current_fat_ptr = (const uint8_t *)fs->fat_table;
- 
-     // Iterate through each sector of the FAT table
-     for (uint32_t i = 0; i < fs->fat_size_sectors; i++) {
-         uint32_t target_lba = fs->fat_start_lba + i;
-         const uint8_t *fat_sector_in_memory = current_fat_ptr + (i * fs->bytes_per_sector);
- 
-         // Get the corresponding buffer from the cache
-         // This might read from disk if not present, but that's okay.
-         buffer_t *cached_buf = buffer_get(fs->disk_ptr->blk_dev.device_name, target_lba);
-         if (!cached_buf) {
-             terminal_printf("[FAT Flush FAT] Error: Failed to get buffer for LBA %u (FAT sector %u).\n", target_lba, i);
-             errors_encountered++;
-             continue; // Try to flush subsequent sectors
-         }
- 
-         // --- Optimization: Compare in-memory FAT sector with cached buffer ---
-         // Only write if they differ. memcmp returns 0 if identical.
-         if (memcmp(cached_buf->data, fat_sector_in_memory, fs->bytes_per_sector) != 0) {
-             // Contents differ - update the cache buffer and mark it dirty
-             memcpy(cached_buf->data, fat_sector_in_memory, fs->bytes_per_sector);
-             buffer_mark_dirty(cached_buf);
-             sectors_written++;
-         }
- 
-         // Release the buffer (decrements ref count)
-         buffer_release(cached_buf);
-     }
+     int errors_encountered = copy_fat_sectors(fs, 0, fs->fat_size_sectors, &sectors_written);
  
      // Only clear the dirty flag if no errors occurred during the flush attempt
      if (errors_encountered == 0) {
@@ -405,4 +386,79 @@
          // Do NOT clear fs->fat_dirty - indicates flush may be incomplete
          return FS_ERR_IO;
      }
- }
\ No newline at end of file
+ }
+ 
+ static int copy_fat_sectors(fat_fs_t *fs, uint32_t first_sector, uint32_t count, int *written_out)
+ {
+     int errors_encountered = 0;
+     const uint8_t *current_fat_ptr = (const uint8_t *)fs->fat_table;
+     const char *device_name = fs->disk_ptr->blk_dev.device_name;
+ 
+     // Every FAT copy mirrors the in-memory table; readers may use any of them
+     for (uint32_t copy = 0; copy < fs->num_fats; copy++) {
+         uint32_t copy_lba = fs->fat_start_lba + copy * fs->fat_size_sectors;
+         for (uint32_t i = first_sector; i < first_sector + count && i < fs->fat_size_sectors; i++) {
+             uint32_t target_lba = copy_lba + i;
+             const uint8_t *fat_sector_in_memory = current_fat_ptr + (i * fs->bytes_per_sector);
+ 
+             // Get the corresponding buffer from the cache
+             // This might read from disk if not present, but that's okay.
+             buffer_t *cached_buf = buffer_get(device_name, target_lba);
+             if (!cached_buf) {
+                 terminal_printf("[FAT Flush FAT] Error: Failed to get buffer for LBA %u (FAT sector %u).\n", target_lba, i);
+                 errors_encountered++;
+                 continue; // Try to flush subsequent sectors
+             }
+ 
+             // Only write if they differ. memcmp returns 0 if identical.
+             if (memcmp(cached_buf->data, fat_sector_in_memory, fs->bytes_per_sector) != 0) {
+                 memcpy(cached_buf->data, fat_sector_in_memory, fs->bytes_per_sector);
+                 buffer_mark_dirty(cached_buf);
+                 if (written_out) (*written_out)++;
+             }
+ 
+             buffer_release(cached_buf);
+         }
+     }
+     return errors_encountered;
+ }
+ 
+ /**
+  * @brief Writes FAT sectors [first_sector, first_sector + count) of every FAT copy to disk.
+  */
+ int fat_sync_fat_sectors(fat_fs_t *fs, uint32_t first_sector, uint32_t count)
+ {
+     KERNEL_ASSERT(fs != NULL, "FS context cannot be NULL in fat_sync_fat_sectors");
+     if (!fs->fat_table || !fs->disk_ptr) return FS_ERR_INTERNAL;
+     if (first_sector >= fs->fat_size_sectors) return FS_SUCCESS;
+     if (count > fs->fat_size_sectors - first_sector) count = fs->fat_size_sectors - first_sector;
+ 
+     int result = FS_SUCCESS;
+     if (copy_fat_sectors(fs, first_sector, count, NULL) != 0) result = FS_ERR_IO;
+ 
+     const char *device_name = fs->disk_ptr->blk_dev.device_name;
+     for (uint32_t copy = 0; copy < fs->num_fats; copy++) {
+         uint32_t lba = fs->fat_start_lba + copy * fs->fat_size_sectors + first_sector;
+         if (buffer_sync_range(device_name, lba, count, false) != 0) result = FS_ERR_IO;
+     }
+     return result;
+ }
+ 
+ /**
+  * @brief Writes the FAT table and every dirty buffer of the filesystem to disk
+  * and flushes the device's write cache. Implements VFS syncfs.
+  */
+ int fat_syncfs_internal(void *fs_context)
+ {
+     fat_fs_t *fs = (fat_fs_t*)fs_context;
+     if (!fs || !fs->disk_ptr) return FS_ERR_INVALID_PARAM;
+ 
+     uintptr_t irq_flags = spinlock_acquire_irqsave(&fs->lock);
+     int result = flush_fat_table(fs);
+     spinlock_release_irqrestore(&fs->lock, irq_flags);
+ 
+     if (buffer_sync_device(fs->disk_ptr->blk_dev.device_name) != 0 && result == FS_SUCCESS) {
+         result = FS_ERR_IO;
+     }
+     return result;
+ }
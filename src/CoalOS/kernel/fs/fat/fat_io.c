@@ -23,6 +23,8 @@
 #include <kernel/fs/fat/fat_utils.h>      // fat_cluster_to_lba, fat_get_current_timestamp (placeholder)
 #include <kernel/fs/fat/fat_alloc.h>      // fat_get_next_cluster, fat_allocate_cluster
 #include <kernel/fs/fat/fat_dir.h>        // update_directory_entry (needed for close/flush), read_directory_sector (used in close)
+#include <kernel/fs/fat/fat_fs.h>         // fat_sync_fat_sectors
+#include "fat_dir_io.h"                   // fat_dir_io_calculate_lba
 #include <kernel/drivers/storage/buffer_cache.h>   // buffer_get, buffer_release, buffer_mark_dirty
 #include <kernel/sync/spinlock.h>       // spinlock_t, spinlock_acquire_irqsave, spinlock_release_irqrestore
 #include <kernel/drivers/display/serial.h>         // serial_write, serial_print_hex
@@ -172,6 +174,74 @@ write_cluster_cleanup:
 }
 
 
+/* --- Direct (O_DIRECT) I/O --- */
+
+#define FAT_DIRECT_MAX_SECTORS 256   // Upper bound on one raw transfer
+
+/*
+ * A run of consecutive sectors backed by a contiguous stretch of the caller's
+ * buffer. O_DIRECT transfers append whole sectors cluster by cluster; runs
+ * of physically adjacent clusters merge into one multi-sector command.
+ */
+typedef struct {
+    uint32_t lba;
+    uint32_t sectors;
+    uint8_t *buf;
+} fat_direct_run_t;
+
+static int fat_direct_flush(fat_fs_t *fs, fat_direct_run_t *run, bool write)
+{
+    if (run->sectors == 0) return FS_SUCCESS;
+    const char *dev = fs->disk_ptr->blk_dev.device_name;
+
+    // Dirty cached copies would later overwrite written data, and a read
+    // must see them on disk; either way they go out before the transfer
+    int result = buffer_sync_range(dev, run->lba, run->sectors, write);
+    if (result == FS_SUCCESS) {
+        if (write) {
+            result = disk_write_raw_sectors(fs->disk_ptr, run->lba, run->buf, run->sectors);
+            // Drop whatever was cached again during the transfer
+            int sync_result = buffer_sync_range(dev, run->lba, run->sectors, true);
+            if (result == FS_SUCCESS) result = sync_result;
+        } else {
+            result = disk_read_raw_sectors(fs->disk_ptr, run->lba, run->buf, run->sectors);
+        }
+    }
+    if (result != FS_SUCCESS) {
+        // The run is kept so the caller can tell how far the data got
+        serial_printf("[FAT_IO_ERR] fat_direct: %s of %lu sectors at LBA 0x%lx failed (%d)\n",
+                      write ? "write" : "read", (unsigned long)run->sectors, (unsigned long)run->lba, result);
+        return FS_ERR_IO;
+    }
+    run->sectors = 0;
+    return FS_SUCCESS;
+}
+
+/* Appends len bytes (whole sectors) at offset_in_cluster of cluster to the run */
+static int fat_direct_add(fat_fs_t *fs, fat_direct_run_t *run, uint32_t cluster,
+                          uint32_t offset_in_cluster, uint8_t *buf, size_t len, bool write)
+{
+    uint32_t sector_size = fs->bytes_per_sector;
+    uint32_t cluster_lba = fat_cluster_to_lba(fs, cluster);
+    if (cluster_lba == 0) return FS_ERR_IO;
+    uint32_t lba = cluster_lba + offset_in_cluster / sector_size;
+    uint32_t sectors = (uint32_t)(len / sector_size);
+
+    if (run->sectors > 0 &&
+        run->lba + run->sectors == lba &&
+        run->buf + (size_t)run->sectors * sector_size == buf &&
+        run->sectors + sectors <= FAT_DIRECT_MAX_SECTORS) {
+        run->sectors += sectors;
+        return FS_SUCCESS;
+    }
+    int result = fat_direct_flush(fs, run, write);
+    if (result != FS_SUCCESS) return result;
+    run->lba = lba;
+    run->sectors = sectors;
+    run->buf = buf;
+    return FS_SUCCESS;
+}
+
 /* --- VFS Operation Implementations --- */
 
 /**
@@ -254,6 +324,11 @@ int fat_read_internal(file_t *file, void *buf, size_t len)
     }
     // serial_write("[FAT_IO] fat_read: Seeked to StartClu=0x"); serial_print_hex(current_cluster_num); serial_write(", OffsetInClu=0x"); serial_print_hex(offset_in_first_read_cluster); serial_write("\n");
 
+    // O_DIRECT reads of whole sectors at sector-aligned offsets go straight
+    // from disk to buf; a trailing partial sector still uses the cache
+    bool direct = (file->flags & O_DIRECT) && (current_offset % fs->bytes_per_sector) == 0;
+    fat_direct_run_t run = { 0, 0, NULL };
+
     // Read data cluster by cluster
     uint32_t current_offset_in_cluster = offset_in_first_read_cluster;
     while (total_bytes_read < len) {
@@ -265,15 +340,27 @@ int fat_read_internal(file_t *file, void *buf, size_t len)
         size_t bytes_to_read_this_cluster = MIN(cluster_size - current_offset_in_cluster, len - total_bytes_read);
         // serial_printf("[FAT_IO] fat_read: Reading 0x%zx bytes from Clu=0x%lx, Offset=0x%lx\n", bytes_to_read_this_cluster, (unsigned long)current_cluster_num, (unsigned long)current_offset_in_cluster);
 
-        result = read_cluster_cached(fs, current_cluster_num, current_offset_in_cluster, (uint8_t*)buf + total_bytes_read, bytes_to_read_this_cluster);
-
-        if (result < 0) {
-            serial_printf("[FAT_IO_ERR] fat_read: read_cluster_cached failed with %d\n", result);
-            goto cleanup_read;
+        size_t direct_bytes = direct ? bytes_to_read_this_cluster - (bytes_to_read_this_cluster % fs->bytes_per_sector) : 0;
+        if (direct_bytes > 0) {
+            result = fat_direct_add(fs, &run, current_cluster_num, current_offset_in_cluster,
+                                    (uint8_t*)buf + total_bytes_read, direct_bytes, false);
+            if (result < 0) goto cleanup_read;
         }
-        if ((size_t)result != bytes_to_read_this_cluster) {
-            serial_write("[FAT_IO_ERR] fat_read: Short read from read_cluster_cached\n");
-            result = FS_ERR_IO; goto cleanup_read;
+        if (direct_bytes < bytes_to_read_this_cluster) {
+            result = fat_direct_flush(fs, &run, false);
+            if (result < 0) goto cleanup_read;
+            size_t cached_bytes = bytes_to_read_this_cluster - direct_bytes;
+            result = read_cluster_cached(fs, current_cluster_num, current_offset_in_cluster + (uint32_t)direct_bytes,
+                                         (uint8_t*)buf + total_bytes_read + direct_bytes, cached_bytes);
+
+            if (result < 0) {
+                serial_printf("[FAT_IO_ERR] fat_read: read_cluster_cached failed with %d\n", result);
+                goto cleanup_read;
+            }
+            if ((size_t)result != cached_bytes) {
+                serial_write("[FAT_IO_ERR] fat_read: Short read from read_cluster_cached\n");
+                result = FS_ERR_IO; goto cleanup_read;
+            }
         }
 
         total_bytes_read += bytes_to_read_this_cluster;
@@ -301,7 +388,7 @@ int fat_read_internal(file_t *file, void *buf, size_t len)
             }
         }
     }
-    result = FS_SUCCESS; // If loop completed or broke due to EOC (which is not an error for read itself)
+    result = fat_direct_flush(fs, &run, false); // If loop completed or broke due to EOC (which is not an error for read itself)
 
 cleanup_read:
     // serial_printf("[FAT_IO] fat_read: Exit. TotalRead=0x%zx, Result=%d\n", total_bytes_read, result);
@@ -309,6 +396,66 @@ cleanup_read:
 }
 
 
+/**
+ * @brief Writes size, first cluster and timestamps from the context into the
+ * file's directory entry (via buffer cache) and clears fctx->dirty.
+ * With size_only, an entry whose size and first cluster are already current
+ * is left alone (fdatasync does not need the timestamps).
+ * Assumes the caller holds fs->lock.
+ */
+static int fat_write_back_dir_entry(fat_fs_t *fs, fat_file_context_t *fctx, bool size_only)
+{
+    // This part updates the directory entry on disk with new size, first cluster, and timestamps.
+    // It's crucial for data integrity.
+    fat_dir_entry_t existing_entry; // Temporary stack storage
+    uint8_t *sector_buf = kmalloc(fs->bytes_per_sector); // Buffer for sector read/write
+    if (!sector_buf) {
+        serial_write("[FAT_IO_ERR] fat_dir_entry: Failed to alloc sector_buf for dir update\n");
+        return FS_ERR_OUT_OF_MEMORY;
+    }
+
+    int update_result;
+    // Read the sector containing the directory entry
+    int read_sec_res = read_directory_sector(fs, fctx->dir_entry_cluster, fctx->dir_entry_offset / fs->bytes_per_sector, sector_buf);
+    if (read_sec_res == FS_SUCCESS) {
+        memcpy(&existing_entry, sector_buf + (fctx->dir_entry_offset % fs->bytes_per_sector), sizeof(fat_dir_entry_t));
+
+        if (size_only && existing_entry.file_size == fctx->file_size &&
+            existing_entry.first_cluster_low == (uint16_t)(fctx->first_cluster & 0xFFFF) &&
+            existing_entry.first_cluster_high == (uint16_t)((fctx->first_cluster >> 16) & 0xFFFF)) {
+            kfree(sector_buf);
+            return FS_SUCCESS; // Still dirty: close updates the timestamps
+        }
+
+        // Update fields from context
+        existing_entry.file_size = fctx->file_size;
+        existing_entry.first_cluster_low = (uint16_t)(fctx->first_cluster & 0xFFFF);
+        existing_entry.first_cluster_high = (uint16_t)((fctx->first_cluster >> 16) & 0xFFFF);
+
+        // The entry is packed; fill locals rather than taking member addresses
+        uint16_t write_time, write_date;
+        fat_get_current_timestamp(&write_time, &write_date);
+        existing_entry.write_time = write_time;
+        existing_entry.write_date = write_date;
+        existing_entry.last_access_date = write_date;
+        fctx->write_time = write_time;
+        fctx->write_date = write_date;
+
+        // Write the modified entry back
+        update_result = update_directory_entry(fs, fctx->dir_entry_cluster, fctx->dir_entry_offset, &existing_entry);
+        if (update_result == FS_SUCCESS) {
+            fctx->dirty = false; // Clear dirty flag ONLY on successful write-back
+        } else {
+            serial_printf("[FAT_IO_ERR] fat_dir_entry: Failed to update directory entry (err %d)\n", update_result);
+        }
+    } else {
+        serial_printf("[FAT_IO_ERR] fat_dir_entry: Failed to read dir sector for update (err %d)\n", read_sec_res);
+        update_result = read_sec_res;
+    }
+    kfree(sector_buf);
+    return update_result;
+}
+
 /**
  * @brief Closes an opened file. Updates directory entry if modified.
  */
@@ -325,47 +472,11 @@ int fat_close_internal(file_t *file)
     uintptr_t irq_flags = spinlock_acquire_irqsave(&fs->lock);
 
     if (fctx->dirty) {
-        // serial_printf("[FAT_IO] fat_close: Context dirty. Updating dir entry (DirClu=0x%lx, DirOff=0x%lx)\n", (unsigned long)fctx->dir_entry_cluster, (unsigned long)fctx->dir_entry_offset);
-        
-        // This part updates the directory entry on disk with new size, first cluster, and timestamps.
-        // It's crucial for data integrity.
-        fat_dir_entry_t existing_entry; // Temporary stack storage
-        uint8_t *sector_buf = kmalloc(fs->bytes_per_sector); // Buffer for sector read/write
-        if (!sector_buf) {
-            serial_write("[FAT_IO_ERR] fat_close: Failed to alloc sector_buf for dir update\n");
-            update_result = FS_ERR_OUT_OF_MEMORY;
-        } else {
-            // Read the sector containing the directory entry
-            int read_sec_res = read_directory_sector(fs, fctx->dir_entry_cluster, fctx->dir_entry_offset / fs->bytes_per_sector, sector_buf);
-            if (read_sec_res == FS_SUCCESS) {
-                memcpy(&existing_entry, sector_buf + (fctx->dir_entry_offset % fs->bytes_per_sector), sizeof(fat_dir_entry_t));
-
-                // Update fields from context
-                existing_entry.file_size = fctx->file_size;
-                existing_entry.first_cluster_low = (uint16_t)(fctx->first_cluster & 0xFFFF);
-                existing_entry.first_cluster_high = (uint16_t)((fctx->first_cluster >> 16) & 0xFFFF);
-                
-                // TODO: Update timestamps (write_time, write_date, last_access_date)
-                // fat_get_current_timestamp(&existing_entry.write_time, &existing_entry.write_date);
-                // existing_entry.last_access_date = existing_entry.write_date; // Or specific access date logic
-
-                // Write the modified entry back
-                update_result = update_directory_entry(fs, fctx->dir_entry_cluster, fctx->dir_entry_offset, &existing_entry);
-                if (update_result == FS_SUCCESS) {
-                    fctx->dirty = false; // Clear dirty flag ONLY on successful write-back
-                    // serial_write("[FAT_IO] fat_close: Directory entry update successful.\n");
-                } else {
-                    serial_printf("[FAT_IO_ERR] fat_close: Failed to update directory entry (err %d)\n", update_result);
-                }
-            } else {
-                serial_printf("[FAT_IO_ERR] fat_close: Failed to read dir sector for update (err %d)\n", read_sec_res);
-                update_result = read_sec_res;
-            }
-            kfree(sector_buf);
-        }
+        update_result = fat_write_back_dir_entry(fs, fctx, false);
     }
     spinlock_release_irqrestore(&fs->lock, irq_flags);
 
+    if (fctx->dirblock_data) kfree(fctx->dirblock_data);
     kfree(fctx);
     file->vnode->data = NULL;
 
@@ -373,6 +484,83 @@ int fat_close_internal(file_t *file)
     return update_result;
 }
 
+/**
+ * @brief Makes an opened file durable. Implements VFS fsync.
+ *
+ * Writes are ordered so that a crash never leaves the directory entry
+ * describing data that is not on disk: the file's data sectors and the FAT
+ * sectors holding its chain go first, then a device cache flush, then the
+ * directory entry, then a second flush. Only buffers of this file are
+ * written; the rest of the FAT and cache stays dirty.
+ */
+int fat_fsync_internal(file_t *file, bool datasync)
+{
+    if (!file || !file->vnode || !file->vnode->data) { return FS_ERR_BAD_F; }
+    fat_file_context_t *fctx = (fat_file_context_t*)file->vnode->data;
+    KERNEL_ASSERT(fctx->fs != NULL, "FAT context missing FS pointer");
+    fat_fs_t *fs = fctx->fs;
+    const char *dev = fs->disk_ptr->blk_dev.device_name;
+    size_t entry_size = (fs->type == FAT_TYPE_FAT32) ? 4 : 2;
+    int result = FS_SUCCESS;
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&fs->lock);
+
+    // 1. Data and chain: walk the clusters, merging physically adjacent ones
+    //    into one range and consecutive FAT sectors into another
+    uint32_t data_lba = 0, data_sectors = 0;
+    uint32_t fat_first = 0, fat_count = 0;
+    uint32_t cluster = fctx->first_cluster;
+    for (uint32_t hops = 0; cluster >= 2 && cluster < fs->eoc_marker; hops++) {
+        if (hops > fs->total_data_clusters) { result = FS_ERR_CORRUPT; break; }
+
+        uint32_t lba = fat_cluster_to_lba(fs, cluster);
+        if (lba == 0) { result = FS_ERR_IO; break; }
+        if (data_sectors > 0 && data_lba + data_sectors == lba) {
+            data_sectors += fs->sectors_per_cluster;
+        } else {
+            if (data_sectors > 0 && buffer_sync_range(dev, data_lba, data_sectors, false) != 0) result = FS_ERR_IO;
+            data_lba = lba;
+            data_sectors = fs->sectors_per_cluster;
+        }
+
+        uint32_t fat_sector = (uint32_t)(((size_t)cluster * entry_size) / fs->bytes_per_sector);
+        if (fat_count > 0 && (fat_sector == fat_first + fat_count - 1 || fat_sector == fat_first + fat_count)) {
+            fat_count = fat_sector - fat_first + 1;
+        } else {
+            if (fat_count > 0 && fat_sync_fat_sectors(fs, fat_first, fat_count) != FS_SUCCESS) result = FS_ERR_IO;
+            fat_first = fat_sector;
+            fat_count = 1;
+        }
+
+        uint32_t next;
+        if (fat_get_next_cluster(fs, cluster, &next) != FS_SUCCESS) { result = FS_ERR_IO; break; }
+        cluster = next;
+    }
+    if (data_sectors > 0 && buffer_sync_range(dev, data_lba, data_sectors, false) != 0) result = FS_ERR_IO;
+    if (fat_count > 0 && fat_sync_fat_sectors(fs, fat_first, fat_count) != FS_SUCCESS) result = FS_ERR_IO;
+
+    // 2. Barrier: the entry must not reach the platter before what it describes
+    if (result == FS_SUCCESS && buffer_flush_device(dev) != 0) result = FS_ERR_IO;
+
+    // 3. Directory entry. Write paths already put size and first cluster into
+    //    the cached sector; fsync also refreshes the timestamps.
+    if (result == FS_SUCCESS && fctx->dirty) {
+        result = fat_write_back_dir_entry(fs, fctx, datasync);
+    }
+    if (result == FS_SUCCESS) {
+        uint32_t entry_lba;
+        result = fat_dir_io_calculate_lba(fs, fctx->dir_entry_cluster,
+                                          fctx->dir_entry_offset / fs->bytes_per_sector, &entry_lba);
+        if (result == FS_SUCCESS && buffer_sync_range(dev, entry_lba, 1, false) != 0) result = FS_ERR_IO;
+    }
+
+    spinlock_release_irqrestore(&fs->lock, irq_flags);
+
+    // 4. Make the entry itself durable
+    if (result == FS_SUCCESS && buffer_flush_device(dev) != 0) result = FS_ERR_IO;
+    return result;
+}
+
 
 /**
  * @brief Writes data to an opened file. Implements VFS write.
@@ -403,6 +591,7 @@ int fat_write_internal(file_t *file, const void *buf, size_t len)
     int result = FS_SUCCESS;
     size_t total_bytes_written = 0;
     bool file_metadata_changed = false; // Tracks if first_cluster or file_size changes
+    fat_direct_run_t run = { 0, 0, NULL }; // Pending O_DIRECT sectors
 
     // Determine write position
     irq_flags = spinlock_acquire_irqsave(&fs->lock);
@@ -499,6 +688,10 @@ int fat_write_internal(file_t *file, const void *buf, size_t len)
     }
     // serial_write("[FAT_IO] fat_write: Seek/Extend successful. StartClu=0x"); serial_print_hex(current_cluster_num); serial_write(", OffsetInClu=0x"); serial_print_hex(offset_in_first_write_cluster); serial_write("\n");
 
+    // O_DIRECT writes of whole sectors at sector-aligned offsets go straight
+    // from buf to disk; a trailing partial sector still uses the cache
+    bool direct = (file->flags & O_DIRECT) && (current_offset % fs->bytes_per_sector) == 0;
+
     // Write data cluster by cluster, allocating as needed
     uint32_t current_offset_in_cluster = offset_in_first_write_cluster;
     while (total_bytes_written < len) {
@@ -511,14 +704,26 @@ int fat_write_internal(file_t *file, const void *buf, size_t len)
         size_t bytes_to_write_this_cluster = MIN(cluster_size - current_offset_in_cluster, len - total_bytes_written);
         // serial_printf("[FAT_IO] fat_write: Writing 0x%zx bytes to Clu=0x%lx, Offset=0x%lx\n", bytes_to_write_this_cluster, (unsigned long)current_cluster_num, (unsigned long)current_offset_in_cluster);
 
-        int write_res = write_cluster_cached(fs, current_cluster_num, current_offset_in_cluster, (const uint8_t*)buf + total_bytes_written, bytes_to_write_this_cluster);
-        if (write_res < 0) {
-            serial_printf("[FAT_IO_ERR] fat_write: write_cluster_cached failed with %d\n", write_res);
-            result = write_res; goto cleanup_write;
+        size_t direct_bytes = direct ? bytes_to_write_this_cluster - (bytes_to_write_this_cluster % fs->bytes_per_sector) : 0;
+        if (direct_bytes > 0) {
+            int add_res = fat_direct_add(fs, &run, current_cluster_num, current_offset_in_cluster,
+                                         (uint8_t*)buf + total_bytes_written, direct_bytes, true);
+            if (add_res < 0) { result = add_res; goto cleanup_write; }
         }
-        if ((size_t)write_res != bytes_to_write_this_cluster) {
-            serial_write("[FAT_IO_ERR] fat_write: Short write from write_cluster_cached\n");
-            result = FS_ERR_IO; goto cleanup_write;
+        if (direct_bytes < bytes_to_write_this_cluster) {
+            int flush_res = fat_direct_flush(fs, &run, true);
+            if (flush_res < 0) { result = flush_res; goto cleanup_write; }
+            size_t cached_bytes = bytes_to_write_this_cluster - direct_bytes;
+            int write_res = write_cluster_cached(fs, current_cluster_num, current_offset_in_cluster + (uint32_t)direct_bytes,
+                                                 (const uint8_t*)buf + total_bytes_written + direct_bytes, cached_bytes);
+            if (write_res < 0) {
+                serial_printf("[FAT_IO_ERR] fat_write: write_cluster_cached failed with %d\n", write_res);
+                result = write_res; goto cleanup_write;
+            }
+            if ((size_t)write_res != cached_bytes) {
+                serial_write("[FAT_IO_ERR] fat_write: Short write from write_cluster_cached\n");
+                result = FS_ERR_IO; goto cleanup_write;
+            }
         }
 
         total_bytes_written += bytes_to_write_this_cluster;
@@ -561,6 +766,16 @@ int fat_write_internal(file_t *file, const void *buf, size_t len)
     result = FS_SUCCESS;
 
 cleanup_write:
+    // Sectors still queued for O_DIRECT are written now; if that fails the
+    // file only grows to cover what reached the disk
+    if (run.sectors > 0) {
+        int flush_res = fat_direct_flush(fs, &run, true);
+        if (flush_res < 0) {
+            total_bytes_written = (size_t)(run.buf - (const uint8_t*)buf);
+            if (result == FS_SUCCESS) result = flush_res;
+        }
+    }
+
     // Update file offset and size in context
     irq_flags = spinlock_acquire_irqsave(&fs->lock);
     off_t final_offset = current_offset + total_bytes_written;
@@ -593,6 +808,57 @@ cleanup_write:
 }
 
 
+/**
+ * @brief Converts a FAT date/time pair to seconds since the Unix epoch.
+ */
+static time_t fat_timestamp_to_unix(uint16_t fat_date, uint16_t fat_time) {
+    uint32_t year  = 1980 + ((fat_date >> 9) & 0x7F);
+    uint32_t month = (fat_date >> 5) & 0x0F;
+    uint32_t day   = fat_date & 0x1F;
+    if (month < 1 || month > 12 || day < 1) return 0;
+
+    // Days from civil (proleptic Gregorian), March-based year
+    uint32_t y = (month <= 2) ? year - 1 : year;
+    uint32_t era = y / 400;
+    uint32_t yoe = y - era * 400;
+    uint32_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    uint32_t days = era * 146097 + doe - 719468;
+
+    return (time_t)(days * 86400u +
+                    ((fat_time >> 11) & 0x1F) * 3600u +
+                    ((fat_time >> 5) & 0x3F) * 60u +
+                    (fat_time & 0x1F) * 2u);
+}
+
+/**
+ * @brief Reports identity, size and mtime of an opened file. Implements VFS fstat.
+ *
+ * FAT has no inode numbers; the first data cluster identifies a file for as
+ * long as it exists. Empty files own no cluster, so they are identified by
+ * the position of their directory entry instead (tagged with the top bit).
+ */
+int fat_fstat_internal(file_t *file, struct stat *st) {
+    if (!file || !file->vnode || !file->vnode->data || !st) { return FS_ERR_BAD_F; }
+    fat_file_context_t *fctx = (fat_file_context_t*)file->vnode->data;
+
+    st->st_dev = (dev_t)(uintptr_t)fctx->fs;
+    if (fctx->first_cluster >= 2) {
+        st->st_ino = fctx->first_cluster;
+    } else {
+        st->st_ino = 0x80000000u | (fctx->dir_entry_cluster << 12) | (fctx->dir_entry_offset / sizeof(fat_dir_entry_t));
+    }
+    st->st_mode = (fctx->is_directory ? S_IFDIR : S_IFREG) | 0755;
+    st->st_nlink = 1;
+    st->st_size = (off_t)fctx->file_size;
+    st->st_mtime = fat_timestamp_to_unix(fctx->write_date, fctx->write_time);
+    st->st_atime = st->st_mtime;
+    st->st_ctime = st->st_mtime;
+    st->st_blksize = fctx->fs->cluster_size_bytes;
+    st->st_blocks = (fctx->file_size + 511) / 512;
+    return FS_SUCCESS;
+}
+
 /**
  * @brief Sets the file offset for the next read or write operation.
  */
@@ -733,6 +999,7 @@ int update_directory_entry_first_cluster_now(fat_fs_t *fs, fat_file_context_t *f
 
     buffer_mark_dirty(b);
     buffer_release(b); // This will eventually write it to disk.
+    fs->dir_generation++;
 
     // serial_printf("[FAT_IO_Update] DirEntry FirstCluster successfully updated on disk (via cache) for LBA %lu.\n", (unsigned long)target_lba);
     return FS_SUCCESS;
@@ -806,6 +1073,7 @@ int update_directory_entry_size_now(fat_fs_t *fs, fat_file_context_t *fctx) {
 
     buffer_mark_dirty(b);
     buffer_release(b);
+    fs->dir_generation++;
 
     // serial_printf("[FAT_IO_Update] DirEntry FileSize successfully updated on disk (via cache) for LBA %lu.\n", (unsigned long)target_lba);
     return FS_SUCCESS;
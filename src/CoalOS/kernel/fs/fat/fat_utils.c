@@ -261,23 +261,49 @@ int fat_compare_8_3(const char* component, const uint8_t name_8_3[11]) {
 
 /* --- Short Name Generation & Collision Check --- */
 
+// Numeric tails tracked by the single-pass collision scan (~1 .. ~N).
+#define FAT_SN_NUMERIC_TAIL_MAX   1023
+// Plain numeric tails tried before switching to the hashed form (Windows uses 4).
+#define FAT_SN_NUMERIC_TAIL_FIRST 4
+// Tails tried on the hashed "XXHHHH~N" form.
+#define FAT_SN_HASHED_TAIL_MAX    9
+
 /**
- * @brief Checks if a directory entry with the exact raw 11-byte short name exists.
+ * Callback for _fat_walk_short_names(). Return true to stop the walk early.
  */
-bool fat_raw_short_name_exists(fat_fs_t *fs, uint32_t dir_cluster, const uint8_t short_name_raw[11]) {
-    KERNEL_ASSERT(fs != NULL && short_name_raw != NULL, "NULL fs or name pointer");
-    // Assumes caller holds fs->lock if concurrent modification is possible
+typedef bool (*fat_sn_visit_t)(const fat_dir_entry_t *de, void *ctx);
 
+/**
+ * State collected by one pass over a directory while generating a short name.
+ */
+typedef struct {
+    uint8_t  base[8];        // Sanitized, space-padded basis name
+    uint8_t  ext[3];         // Sanitized, space-padded extension
+    size_t   base_len;       // Significant (non-padding) chars in base
+    uint8_t  hash_stem[6];   // 2 basis chars + 4 hex digits of the long name hash
+    size_t   hash_stem_len;  // 5 when the basis has a single char
+    bool     basis_taken;    // Plain BASE.EXT already exists
+    uint8_t  numeric_used[(FAT_SN_NUMERIC_TAIL_MAX + 8) / 8]; // Bit n set => BASE~n taken
+    uint16_t hashed_used;    // Bit n set => STEM~n taken
+} fat_sn_scan_t;
+
+/**
+ * @brief Walks every live short-name entry of a directory once.
+ * Skips free, deleted, LFN and volume label entries. Stops at the end marker.
+ * @return FS_SUCCESS or the I/O error that aborted the walk.
+ */
+static int _fat_walk_short_names(fat_fs_t *fs, uint32_t dir_cluster,
+                                 fat_sn_visit_t visit, void *ctx)
+{
     uint32_t current_cluster = dir_cluster;
     bool scanning_fixed_root = (fs->type != FAT_TYPE_FAT32 && dir_cluster == 0);
     uint32_t current_byte_offset = 0;
-    bool found = false;
     int io_error = FS_SUCCESS;
 
     uint8_t *sector_data = kmalloc(fs->bytes_per_sector);
     if (!sector_data) {
         FAT_ERROR_LOG("Failed to allocate sector buffer.");
-        return true; // Fail safe: Assume it exists if we can't check.
+        return FS_ERR_OUT_OF_MEMORY;
     }
 
     while (true) {
@@ -292,15 +318,12 @@ bool fat_raw_short_name_exists(fat_fs_t *fs, uint32_t dir_cluster, const uint8_t
 
         for (size_t e_idx = 0; e_idx < entries_per_sector; e_idx++) {
             fat_dir_entry_t *de = (fat_dir_entry_t*)(sector_data + e_idx * sizeof(fat_dir_entry_t));
-            if (de->name[0] == FAT_DIR_ENTRY_UNUSED) { goto check_done; }
+            if (de->name[0] == FAT_DIR_ENTRY_UNUSED) { goto walk_done; }
             if (de->name[0] == FAT_DIR_ENTRY_DELETED) continue;
             if ((de->attr & FAT_ATTR_VOLUME_ID) && !(de->attr & FAT_ATTR_LONG_NAME)) continue;
             if ((de->attr & FAT_ATTR_LONG_NAME_MASK) == FAT_ATTR_LONG_NAME) continue;
 
-            if (memcmp(de->name, short_name_raw, 11) == 0) {
-                found = true;
-                goto check_done;
-            }
+            if (visit(de, ctx)) { goto walk_done; }
         }
 
         current_byte_offset += fs->bytes_per_sector;
@@ -314,18 +337,139 @@ bool fat_raw_short_name_exists(fat_fs_t *fs, uint32_t dir_cluster, const uint8_t
         }
     }
 
-check_done:
+walk_done:
     kfree(sector_data);
+    return io_error;
+}
+
+typedef struct {
+    const uint8_t *name;
+    bool found;
+} fat_sn_exact_ctx_t;
+
+static bool _fat_sn_visit_exact(const fat_dir_entry_t *de, void *ctx)
+{
+    fat_sn_exact_ctx_t *ec = (fat_sn_exact_ctx_t *)ctx;
+    if (memcmp(de->name, ec->name, 11) == 0) {
+        ec->found = true;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Checks if a directory entry with the exact raw 11-byte short name exists.
+ */
+bool fat_raw_short_name_exists(fat_fs_t *fs, uint32_t dir_cluster, const uint8_t short_name_raw[11]) {
+    KERNEL_ASSERT(fs != NULL && short_name_raw != NULL, "NULL fs or name pointer");
+    // Assumes caller holds fs->lock if concurrent modification is possible
+
+    fat_sn_exact_ctx_t ctx = { .name = short_name_raw, .found = false };
+    int io_error = _fat_walk_short_names(fs, dir_cluster, _fat_sn_visit_exact, &ctx);
     if (io_error != FS_SUCCESS) {
         FAT_ERROR_LOG("I/O error %d during short name check.", io_error);
-        return true; // Fail safe
+        return true; // Fail safe: Assume it exists if we can't check.
+    }
+    return ctx.found;
+}
+
+/**
+ * @brief Builds "STEM~N" + ext into candidate, truncating the stem so the tail fits in 8 chars.
+ * @return false if N cannot be formatted.
+ */
+static bool _fat_sn_build_tailed(const uint8_t *stem, size_t stem_len, const uint8_t ext[3],
+                                 int n, uint8_t candidate[11])
+{
+    char num_suffix[8]; // ~ + 6 digits + null
+    num_suffix[0] = '~';
+    int num_len = _itoa_simple(n, num_suffix + 1, sizeof(num_suffix) - 1);
+    if (num_len < 0) return false;
+    int suffix_len = 1 + num_len; // Length including '~'
+
+    // Determine how many stem characters to keep (at least 1)
+    int keep = 8 - suffix_len;
+    if (keep < 1) keep = 1;
+    if ((size_t)keep > stem_len) keep = (int)stem_len;
+
+    memcpy(candidate, stem, keep);
+    memcpy(candidate + keep, num_suffix, suffix_len);
+    for (int k = keep + suffix_len; k < 8; ++k) {
+        candidate[k] = ' ';
     }
-    return found;
+    memcpy(candidate + 8, ext, 3);
+    return true;
+}
+
+/**
+ * @brief Parses the decimal "~N" tail of a raw 8.3 base name.
+ * @return N (>0) if the name ends in a tail, 0 otherwise.
+ */
+static int _fat_sn_parse_tail(const uint8_t name[11])
+{
+    int end = 8;
+    while (end > 0 && name[end - 1] == ' ') end--;
+
+    int p = end;
+    while (p > 0 && name[p - 1] >= '0' && name[p - 1] <= '9') p--;
+    if (p == end || p == 0 || name[p - 1] != '~') return 0;
+
+    int n = 0;
+    for (int k = p; k < end; k++) {
+        n = n * 10 + (name[k] - '0');
+    }
+    return n;
+}
+
+/**
+ * @brief Records which tailed candidates an existing entry occupies.
+ * Only names whose tail parses to N are rebuilt and compared, so each entry costs O(1).
+ */
+static bool _fat_sn_visit_collect(const fat_dir_entry_t *de, void *ctx)
+{
+    fat_sn_scan_t *scan = (fat_sn_scan_t *)ctx;
+    uint8_t candidate[11];
+
+    if (memcmp(de->name + 8, scan->ext, 3) != 0) return false;
+
+    if (memcmp(de->name, scan->base, 8) == 0) {
+        scan->basis_taken = true;
+        return false;
+    }
+
+    int n = _fat_sn_parse_tail(de->name);
+    if (n <= 0) return false;
+
+    if (n <= FAT_SN_NUMERIC_TAIL_MAX &&
+        _fat_sn_build_tailed(scan->base, scan->base_len, scan->ext, n, candidate) &&
+        memcmp(candidate, de->name, 11) == 0) {
+        scan->numeric_used[n / 8] |= (uint8_t)(1u << (n % 8));
+    }
+
+    if (n <= FAT_SN_HASHED_TAIL_MAX &&
+        _fat_sn_build_tailed(scan->hash_stem, scan->hash_stem_len, scan->ext, n, candidate) &&
+        memcmp(candidate, de->name, 11) == 0) {
+        scan->hashed_used |= (uint16_t)(1u << n);
+    }
+    return false;
+}
+
+/**
+ * @brief 16-bit rotate-and-add checksum of the long name, used for hashed tails.
+ */
+static uint16_t _fat_sn_long_name_hash(const char *long_name)
+{
+    uint16_t sum = 0;
+    for (const unsigned char *p = (const unsigned char *)long_name; *p; p++) {
+        sum = (uint16_t)(((sum & 1) ? 0x8000 : 0) + (sum >> 1) + *p);
+    }
+    return sum;
 }
 
 /**
  * @brief Generates a unique 8.3 short filename based on a long filename.
- * Implements the standard "NAME~N.EXT" generation algorithm.
+ * Implements the Windows-style "NAME~N.EXT" algorithm: ~1..~4 first, then a
+ * hashed "NAHHHH~N.EXT" form, then the remaining numeric tails. All candidates
+ * are checked against a single pass over the parent directory.
  * @note Assumes caller holds fs->lock.
  */
 int fat_generate_short_name(fat_fs_t   *fs,
@@ -336,9 +480,12 @@ int fat_generate_short_name(fat_fs_t   *fs,
     KERNEL_ASSERT(fs && long_name && short_name_out, "Invalid args to fat_generate_short_name");
     if (!*long_name) return FS_ERR_INVALID_PARAM; // Empty long name
 
+    fat_sn_scan_t scan;
+    memset(&scan, 0, sizeof(scan));
+    memset(scan.base, ' ', sizeof(scan.base));
+    memset(scan.ext, ' ', sizeof(scan.ext));
+
     // 0. Normalise and split at the last '.'
-    char base[9] = { ' ' }; // Initialize with spaces
-    char ext[4] = { ' ' };  // Initialize with spaces
     const char *dot = strrchr(long_name, '.');
     size_t len_base = dot ? (size_t)(dot - long_name) : strlen(long_name);
     size_t len_ext  = dot ? strlen(dot + 1) : 0;
@@ -352,9 +499,10 @@ int fat_generate_short_name(fat_fs_t   *fs,
         if (strchr("\"*+,/:;<=>?[\\]|", c) || c < 0x20) c = '_';
         // Handle KANJI E5 replacement at the start
         if (j == 0 && c == (char)0xE5) c = 0x05;
-        base[j++] = c;
+        scan.base[j++] = c;
     }
-    // Pad remaining base with spaces if needed (already done by init)
+    size_t base_chars = j;
+    scan.base_len = base_chars;
 
     // 2. Copy and sanitize extension (up to 3 chars)
     if (dot) { // Only process if extension exists
@@ -362,54 +510,71 @@ int fat_generate_short_name(fat_fs_t   *fs,
             char c = toupper((unsigned char)dot[1 + i]);
             if (c == '.' || c == ' ') continue; // Skip dots/spaces within ext
             if (strchr("\"*+,/:;<=>?[\\]|", c) || c < 0x20) c = '_';
-            ext[j++] = c;
+            scan.ext[j++] = c;
         }
     }
-    // Pad remaining ext with spaces if needed (already done by init)
 
-    // 3. Try BASE    .EXT first
+    // 3. Hashed stem: up to 2 basis chars followed by 4 hex digits
+    static const char hex_digits[] = "0123456789ABCDEF";
+    uint16_t hash = _fat_sn_long_name_hash(long_name);
+    size_t stem_prefix = base_chars < 2 ? base_chars : 2;
+    if (stem_prefix == 0) {
+        scan.hash_stem[0] = '_';
+        stem_prefix = 1;
+    } else {
+        memcpy(scan.hash_stem, scan.base, stem_prefix);
+    }
+    for (int k = 0; k < 4; k++) {
+        scan.hash_stem[stem_prefix + k] = hex_digits[(hash >> (12 - 4 * k)) & 0xF];
+    }
+    scan.hash_stem_len = stem_prefix + 4;
+
+    // 4. One pass over the directory records every candidate already in use
+    int io_error = _fat_walk_short_names(fs, parent_dir_cluster, _fat_sn_visit_collect, &scan);
+    if (io_error != FS_SUCCESS) {
+        FAT_ERROR_LOG("I/O error %d while scanning for short name collisions.", io_error);
+        return io_error;
+    }
+
     uint8_t candidate[11];
-    memcpy(candidate, base, 8);
-    memcpy(candidate + 8, ext, 3);
-    if (!fat_raw_short_name_exists(fs, parent_dir_cluster, candidate)) {
-        memcpy(short_name_out, candidate, 11);
-        FAT_DEBUG_LOG("Generated unique 8.3: '%.11s' (no suffix needed)", candidate);
+    if (!scan.basis_taken) {
+        memcpy(short_name_out, scan.base, 8);
+        memcpy(short_name_out + 8, scan.ext, 3);
+        FAT_DEBUG_LOG("Generated unique 8.3: '%.11s' (no suffix needed)", short_name_out);
         return FS_SUCCESS;
     }
 
-    // 4. Try BASE~N.EXT variations (1 <= N <= 999999)
-    char num_suffix[8]; // ~ + 6 digits + null
-    for (int n = 1; n <= 999999; ++n) {
-        num_suffix[0] = '~';
-        int num_len = _itoa_simple(n, num_suffix + 1, sizeof(num_suffix) - 1);
-        if (num_len < 0) {
-            FAT_ERROR_LOG("Failed to convert suffix number %d to string.", n);
-            return FS_ERR_INTERNAL; // Should not happen
+    // 5. BASE~1 .. BASE~4
+    for (int n = 1; n <= FAT_SN_NUMERIC_TAIL_FIRST; ++n) {
+        if (!(scan.numeric_used[n / 8] & (1u << (n % 8))) &&
+            _fat_sn_build_tailed(scan.base, scan.base_len, scan.ext, n, candidate)) {
+            memcpy(short_name_out, candidate, 11);
+            FAT_DEBUG_LOG("Generated unique 8.3: '%.11s' (using suffix ~%d)", candidate, n);
+            return FS_SUCCESS;
         }
-        int suffix_len = 1 + num_len; // Length including '~'
-
-        // Determine how many base characters to keep
-        int base_chars_to_keep = 8 - suffix_len;
-        if (base_chars_to_keep < 1) base_chars_to_keep = 1; // Keep at least 1 char
-
-        // Construct the trial name
-        memcpy(candidate, base, base_chars_to_keep); // Copy truncated base
-        memcpy(candidate + base_chars_to_keep, num_suffix, suffix_len); // Copy suffix
-        // Pad remaining base name part with spaces if needed
-        for (int k = base_chars_to_keep + suffix_len; k < 8; ++k) {
-            candidate[k] = ' ';
+    }
+
+    // 6. Hashed tails keep heavily shared prefixes from marching through ~N
+    for (int n = 1; n <= FAT_SN_HASHED_TAIL_MAX; ++n) {
+        if (!(scan.hashed_used & (1u << n)) &&
+            _fat_sn_build_tailed(scan.hash_stem, scan.hash_stem_len, scan.ext, n, candidate)) {
+            memcpy(short_name_out, candidate, 11);
+            FAT_DEBUG_LOG("Generated unique 8.3: '%.11s' (hashed suffix ~%d)", candidate, n);
+            return FS_SUCCESS;
         }
-        memcpy(candidate + 8, ext, 3); // Copy original extension
+    }
 
-        // Check uniqueness
-        if (!fat_raw_short_name_exists(fs, parent_dir_cluster, candidate)) {
+    // 7. Remaining numeric tails
+    for (int n = FAT_SN_NUMERIC_TAIL_FIRST + 1; n <= FAT_SN_NUMERIC_TAIL_MAX; ++n) {
+        if (!(scan.numeric_used[n / 8] & (1u << (n % 8))) &&
+            _fat_sn_build_tailed(scan.base, scan.base_len, scan.ext, n, candidate)) {
             memcpy(short_name_out, candidate, 11);
             FAT_DEBUG_LOG("Generated unique 8.3: '%.11s' (using suffix ~%d)", candidate, n);
             return FS_SUCCESS;
         }
     }
 
-    FAT_ERROR_LOG("Could not generate unique short name for '%s' after %d attempts.", long_name, 999999);
+    FAT_ERROR_LOG("Could not generate unique short name for '%s'.", long_name);
     return FS_ERR_NO_SPACE; // Or FS_ERR_FILE_EXISTS? NO_SPACE seems more appropriate
 }
 
@@ -0,0 +1,1309 @@
+/**
+ * @file procfs.c
+ * @brief /proc pseudo-filesystem (see procfs.h for the layout)
+ *
+ * Every open node is a proc_node_t. Regular files carry a seq_file whose
+ * show callbacks read the kernel's statistics accessors on each fill.
+ * Directories take their listing at open (the pids on the task list, the
+ * open descriptors of one process) so getdents, which runs under the
+ * directory's spinlock, never allocates or walks the task list itself.
+ *
+ * /proc/sys mirrors the tunables registry: "vm.page_cache_max_pages" is
+ * /proc/sys/vm/page_cache_max_pages. Those files are the only writable ones;
+ * a write parses the value and goes through tunable_set(), so range checks
+ * and change callbacks are the registry's.
+ *
+ * Per-process data is read from inside scheduler_queues_for_each_task(),
+ * which keeps the task and its PCB alive while it is formatted. Formatting
+ * only appends to the seq_file's preallocated buffer, so nothing in those
+ * callbacks blocks.
+ */
+
+#include <kernel/fs/procfs/procfs.h>
+#include <kernel/fs/vfs/seq_file.h>
+#include <kernel/fs/vfs/vfs.h>
+#include <kernel/fs/vfs/fs_errno.h>
+#include <kernel/fs/vfs/sys_file.h>
+#include <kernel/fs/vfs/dirent.h>
+#include <kernel/fs/vfs/page_cache.h>
+#include <kernel/process/process.h>
+#include <kernel/process/scheduler.h>
+#include <kernel/process/scheduler_queues.h>
+#include <kernel/process/scheduler_optimization.h>
+#include <kernel/process/cputime.h>
+#include <kernel/memory/mm.h>
+#include <kernel/memory/buddy.h>
+#include <kernel/memory/slab.h>
+#include <kernel/memory/paging_fault.h>
+#include <kernel/memory/kmalloc.h>
+#include <kernel/lib/rbtree.h>
+#include <kernel/lib/math64.h>
+#include <kernel/lib/string.h>
+#include <kernel/lib/tunables.h>
+#include <kernel/cpu/idt.h>
+#include <kernel/drivers/display/tty.h>
+#include <kernel/drivers/display/serial.h>
+#include <kernel/core/constants.h>
+#include <libc/stddef.h>
+
+#define PROC_DEV            0x5052     // st_dev of every entry ("PR")
+#define PROC_NAME_MAX       TUNABLE_NAME_MAX // Longest path component we accept
+#define PROC_USER_HZ        100        // Unit of the time fields in stat
+#define NSEC_PER_USER_HZ    (1000000000u / PROC_USER_HZ)
+#define PROC_PF_KTHREAD     0x00200000 // stat flags bit for kernel tasks
+
+// Inode numbers: (pid << 8) | slot, with pid 0 for the top level
+#define PROC_INO(pid, slot) (((uint32_t)(pid) << 8) | (uint32_t)(slot))
+#define PROC_SLOT_DIR       1
+#define PROC_SLOT_FD_DIR    2
+#define PROC_SLOT_SYS_DIR   4          // /proc/sys (pid 0)
+#define PROC_SLOT_FILE      8          // + index in the entry table
+#define PROC_SLOT_SYS_GROUP 32         // + registry index of the group's first tunable
+#define PROC_SLOT_FD        64         // + descriptor number
+#define PROC_SLOT_SYS_FILE  128        // + registry index of the tunable (pid 0)
+
+_Static_assert(MAX_FD <= 32, "fd_mask holds one bit per descriptor");
+
+typedef enum proc_kind {
+    PROC_ROOT_DIR,
+    PROC_PID_DIR,
+    PROC_FD_DIR,
+    PROC_SYSTEM_FILE,
+    PROC_PID_FILE,
+    PROC_FD_FILE,
+    PROC_SYS_DIR,
+    PROC_SYS_GROUP_DIR,
+    PROC_SYS_FILE
+} proc_kind_t;
+
+// A tunable listed in a /proc/sys directory
+typedef struct proc_sys_item {
+    const tunable_t *tunable;
+    uint32_t index;             // Position in the registry
+} proc_sys_item_t;
+
+typedef struct proc_entry {
+    const char *name;
+    int (*show)(seq_file_t *m, void *v);    // Single-record files
+    const seq_operations_t *ops;            // Iterated files
+} proc_entry_t;
+
+// State attached to each open vnode
+typedef struct proc_node {
+    proc_kind_t kind;
+    uint32_t pid;               // PROC_PID_* and PROC_FD_*
+    int fd;                     // PROC_FD_FILE
+    uint32_t entry;             // Index in the entry table (files), registry index (sys)
+    seq_file_t seq;             // Files
+    uint32_t *pids;             // PROC_ROOT_DIR: processes listed at open
+    uint32_t npids;
+    uint32_t fd_mask;           // PROC_FD_DIR: descriptors open at open
+    tunable_t *tunable;         // PROC_SYS_FILE
+    char group[PROC_NAME_MAX];  // PROC_SYS_GROUP_DIR
+    proc_sys_item_t *items;     // PROC_SYS_*_DIR: groups or tunables listed at open
+    uint32_t nitems;
+} proc_node_t;
+
+static void *proc_vfs_mount(const char *device);
+static int proc_vfs_unmount(void *fs_context);
+static vnode_t *proc_vfs_open(void *fs_context, const char *path, int flags);
+static int proc_vfs_read(file_t *file, void *buffer, size_t count);
+static int proc_vfs_write(file_t *file, const void *buffer, size_t count);
+static int proc_vfs_close(file_t *file);
+static off_t proc_vfs_lseek(file_t *file, off_t offset, int whence);
+static int proc_vfs_getdents(file_t *dir_file, vfs_filldir_t filldir, void *ctx);
+static int proc_vfs_fstat(file_t *file, struct stat *st);
+
+static vfs_driver_t proc_driver = {
+    .fs_name = "proc",
+    .mount = proc_vfs_mount,
+    .unmount = proc_vfs_unmount,
+    .open = proc_vfs_open,
+    .read = proc_vfs_read,
+    .write = proc_vfs_write,
+    .close = proc_vfs_close,
+    .lseek = proc_vfs_lseek,
+    .readdir = NULL,
+    .getdents = proc_vfs_getdents,
+    .unlink = NULL,
+    .mkdir = NULL,
+    .rmdir = NULL,
+    .read_inode = NULL,
+    .write_inode = NULL,
+    .stat_inode = NULL,
+    .fstat = proc_vfs_fstat,
+    .next = NULL
+};
+
+//============================================================================
+// Task access
+//============================================================================
+
+typedef struct proc_task_query {
+    uint32_t pid;
+    void (*fn)(tcb_t *task, void *arg);
+    void *arg;
+    bool found;
+} proc_task_query_t;
+
+static void proc_task_visit(tcb_t *task, void *arg)
+{
+    proc_task_query_t *q = (proc_task_query_t *)arg;
+    if (q->found || task->pid != q->pid) {
+        return;
+    }
+    q->found = true;
+    if (q->fn) {
+        q->fn(task, q->arg);
+    }
+}
+
+/**
+ * @brief Runs fn on the task with the given pid, under the task list lock
+ * @return true if the task exists
+ */
+static bool proc_with_task(uint32_t pid, void (*fn)(tcb_t *task, void *arg), void *arg)
+{
+    if (pid == 0) {
+        return false;
+    }
+    proc_task_query_t q = { .pid = pid, .fn = fn, .arg = arg, .found = false };
+    scheduler_queues_for_each_task(proc_task_visit, &q);
+    return q.found;
+}
+
+// Show helper for per-process files: fn formats the task into the seq_file
+static int proc_show_task(seq_file_t *m, void (*fn)(tcb_t *task, void *arg))
+{
+    proc_node_t *node = (proc_node_t *)m->private;
+    return proc_with_task(node->pid, fn, m) ? 0 : -ESRCH;
+}
+
+typedef struct proc_pid_list {
+    uint32_t *pids;
+    uint32_t count;
+    uint32_t cap;
+} proc_pid_list_t;
+
+static void proc_count_visit(tcb_t *task, void *arg)
+{
+    (void)task;
+    (*(uint32_t *)arg)++;
+}
+
+// Inserts the task's pid in ascending order, once per pid
+static void proc_pid_collect(tcb_t *task, void *arg)
+{
+    proc_pid_list_t *list = (proc_pid_list_t *)arg;
+    uint32_t pid = task->pid;
+    if (pid == 0 || list->count == list->cap) {
+        return;
+    }
+
+    uint32_t i = list->count;
+    while (i > 0 && list->pids[i - 1] > pid) {
+        i--;
+    }
+    if (i > 0 && list->pids[i - 1] == pid) {
+        return;
+    }
+    memmove(&list->pids[i + 1], &list->pids[i], (list->count - i) * sizeof(uint32_t));
+    list->pids[i] = pid;
+    list->count++;
+}
+
+static void proc_fd_mask_task(tcb_t *task, void *arg)
+{
+    uint32_t *mask = (uint32_t *)arg;
+    pcb_t *proc = task->process;
+    *mask = 0;
+    if (!proc) {
+        return;
+    }
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&proc->fd_table_lock);
+    for (int fd = 0; fd < (int)MAX_FD; fd++) {
+        if (proc->fd_table[fd]) {
+            *mask |= 1u << fd;
+        }
+    }
+    spinlock_release_irqrestore(&proc->fd_table_lock, irq_flags);
+}
+
+static char proc_state_char(task_state_e state)
+{
+    switch (state) {
+        case TASK_READY:
+        case TASK_RUNNING:  return 'R';
+        case TASK_BLOCKED:
+        case TASK_SLEEPING: return 'S';
+        case TASK_ZOMBIE:   return 'Z';
+        case TASK_EXITING:  return 'X';
+        default:            return '?';
+    }
+}
+
+static const char *proc_state_name(char state)
+{
+    switch (state) {
+        case 'R': return "running";
+        case 'S': return "sleeping";
+        case 'Z': return "zombie";
+        case 'X': return "dead";
+        default:  return "unknown";
+    }
+}
+
+static const char *proc_comm(const tcb_t *task)
+{
+    const pcb_t *proc = task->process;
+    if (proc && proc->comm[0]) {
+        return proc->comm;
+    }
+    return (proc && !proc->is_kernel_task) ? "user" : "kthread";
+}
+
+typedef struct proc_vm_usage {
+    uint32_t size;              // Bytes covered by VMAs
+    uint32_t exe;               // Executable mappings
+    uint32_t data;              // Private writable mappings other than stacks
+    uint32_t stk;               // Stacks
+    uint32_t maps;              // Number of VMAs
+} proc_vm_usage_t;
+
+static void proc_vm_usage(mm_struct_t *mm, proc_vm_usage_t *usage)
+{
+    memset(usage, 0, sizeof(*usage));
+    if (!mm) {
+        return;
+    }
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&mm->lock);
+    for (struct rb_node *n = rb_tree_first(&mm->vma_tree); n; n = rb_node_next(n)) {
+        vma_struct_t *vma = rb_entry(n, vma_struct_t, rb_node);
+        uint32_t len = (uint32_t)(vma->vm_end - vma->vm_start);
+        usage->size += len;
+        usage->maps++;
+        if (vma->vm_flags & (VM_STACK | VM_GROWS_DOWN)) {
+            usage->stk += len;
+        } else if (vma->vm_flags & VM_EXEC) {
+            usage->exe += len;
+        } else if ((vma->vm_flags & VM_WRITE) && !(vma->vm_flags & VM_SHARED)) {
+            usage->data += len;
+        }
+    }
+    spinlock_release_irqrestore(&mm->lock, irq_flags);
+}
+
+//============================================================================
+// /proc/<pid>/ files
+//============================================================================
+
+static void proc_pid_stat_task(tcb_t *task, void *arg)
+{
+    seq_file_t *m = (seq_file_t *)arg;
+    pcb_t *proc = task->process;
+    uint64_t utime = 0, stime = 0, cutime = 0, cstime = 0;
+    proc_vm_usage_t vm;
+
+    cputime_task_read(task, &utime, &stime);
+    if (proc) {
+        utime += proc->utime_ns;
+        stime += proc->stime_ns;
+        cutime = proc->cutime_ns;
+        cstime = proc->cstime_ns;
+    }
+    proc_vm_usage(proc ? proc->mm : NULL, &vm);
+
+    uint32_t tpgid = tty_get_pgrp();
+    seq_printf(m, "%u (%s) %c %u %u %u 0 %d %u 0 0 0 0 ",
+               task->pid, proc_comm(task), proc_state_char(task->state),
+               proc ? proc->ppid : 0, proc ? proc->pgid : 0, proc ? proc->sid : 0,
+               tpgid ? (int)tpgid : -1,
+               (!proc || proc->is_kernel_task) ? PROC_PF_KTHREAD : 0);
+    seq_put_u64(m, div_u64(utime, NSEC_PER_USER_HZ));
+    seq_putc(m, ' ');
+    seq_put_u64(m, div_u64(stime, NSEC_PER_USER_HZ));
+    seq_putc(m, ' ');
+    seq_put_u64(m, div_u64(cutime, NSEC_PER_USER_HZ));
+    seq_putc(m, ' ');
+    seq_put_u64(m, div_u64(cstime, NSEC_PER_USER_HZ));
+    // priority nice num_threads itrealvalue starttime vsize rss
+    seq_printf(m, " %u 0 1 0 0 %u 0\n", task->effective_priority, vm.size);
+}
+
+static int proc_pid_stat_show(seq_file_t *m, void *v)
+{
+    (void)v;
+    return proc_show_task(m, proc_pid_stat_task);
+}
+
+static void proc_pid_status_task(tcb_t *task, void *arg)
+{
+    seq_file_t *m = (seq_file_t *)arg;
+    pcb_t *proc = task->process;
+    char state = proc_state_char(task->state);
+    proc_vm_usage_t vm;
+
+    proc_vm_usage(proc ? proc->mm : NULL, &vm);
+
+    seq_printf(m, "Name:\t%s\n", proc_comm(task));
+    seq_printf(m, "State:\t%c (%s)\n", state, proc_state_name(state));
+    seq_printf(m, "Tgid:\t%u\nPid:\t%u\nPPid:\t%u\n",
+               task->pid, task->pid, proc ? proc->ppid : 0);
+    seq_printf(m, "Pgid:\t%u\nSid:\t%u\n", proc ? proc->pgid : 0, proc ? proc->sid : 0);
+    seq_printf(m, "Kthread:\t%u\nThreads:\t1\n", (!proc || proc->is_kernel_task) ? 1u : 0u);
+    seq_printf(m, "SigPnd:\t%08x\nSigBlk:\t%08x\n",
+               proc ? proc->pending_signals : 0, proc ? proc->signal_mask : 0);
+    seq_printf(m, "VmSize:\t%8u kB\nVmData:\t%8u kB\nVmStk:\t%8u kB\nVmExe:\t%8u kB\n",
+               vm.size / 1024, vm.data / 1024, vm.stk / 1024, vm.exe / 1024);
+    seq_printf(m, "Maps:\t%u\nPriority:\t%u\n", vm.maps, task->effective_priority);
+}
+
+static int proc_pid_status_show(seq_file_t *m, void *v)
+{
+    (void)v;
+    return proc_show_task(m, proc_pid_status_task);
+}
+
+static void proc_pid_maps_task(tcb_t *task, void *arg)
+{
+    seq_file_t *m = (seq_file_t *)arg;
+    mm_struct_t *mm = task->process ? task->process->mm : NULL;
+    if (!mm) {
+        return;
+    }
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&mm->lock);
+    for (struct rb_node *n = rb_tree_first(&mm->vma_tree); n; n = rb_node_next(n)) {
+        vma_struct_t *vma = rb_entry(n, vma_struct_t, rb_node);
+        uint32_t flags = vma->vm_flags;
+        const char *label = NULL;
+
+        if (flags & VM_HEAP) {
+            label = "[heap]";
+        } else if (flags & VM_STACK) {
+            label = "[stack]";
+        } else if (vma->vm_file && vma->vm_file->vnode && vma->vm_file->vnode->fs_driver) {
+            label = vma->vm_file->vnode->fs_driver->fs_name;
+        }
+
+        seq_printf(m, "%08lx-%08lx %c%c%c%c %08lx 00:00 0",
+                   (unsigned long)vma->vm_start, (unsigned long)vma->vm_end,
+                   (flags & VM_READ) ? 'r' : '-', (flags & VM_WRITE) ? 'w' : '-',
+                   (flags & VM_EXEC) ? 'x' : '-', (flags & VM_SHARED) ? 's' : 'p',
+                   (unsigned long)vma->vm_offset);
+        if (label) {
+            seq_printf(m, "    %s", label);
+        }
+        seq_putc(m, '\n');
+    }
+    spinlock_release_irqrestore(&mm->lock, irq_flags);
+}
+
+static int proc_pid_maps_show(seq_file_t *m, void *v)
+{
+    (void)v;
+    return proc_show_task(m, proc_pid_maps_task);
+}
+
+static void proc_pid_fd_task(tcb_t *task, void *arg)
+{
+    seq_file_t *m = (seq_file_t *)arg;
+    proc_node_t *node = (proc_node_t *)m->private;
+    pcb_t *proc = task->process;
+    if (!proc) {
+        return;
+    }
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&proc->fd_table_lock);
+    sys_file_t *sf = proc->fd_table[node->fd];
+    if (sf && sf->vfs_file) {
+        file_t *file = sf->vfs_file;
+        const char *fs = (file->vnode && file->vnode->fs_driver) ?
+                         file->vnode->fs_driver->fs_name : "none";
+        seq_printf(m, "pos:\t%ld\nflags:\t0%o\nfs:\t%s\n",
+                   (long)file->offset, (unsigned)sf->flags, fs);
+    }
+    spinlock_release_irqrestore(&proc->fd_table_lock, irq_flags);
+}
+
+static int proc_pid_fd_show(seq_file_t *m, void *v)
+{
+    (void)v;
+    return proc_show_task(m, proc_pid_fd_task);
+}
+
+static const proc_entry_t proc_pid_files[] = {
+    { "stat",   proc_pid_stat_show,   NULL },
+    { "status", proc_pid_status_show, NULL },
+    { "maps",   proc_pid_maps_show,   NULL },
+};
+#define PROC_PID_FILE_COUNT (sizeof(proc_pid_files) / sizeof(proc_pid_files[0]))
+
+//============================================================================
+// System-wide files
+//============================================================================
+
+static int proc_meminfo_show(seq_file_t *m, void *v)
+{
+    (void)v;
+    buddy_stats_t buddy;
+    page_cache_stats_t cache;
+    buddy_get_stats(&buddy);
+    page_cache_get_stats(&cache);
+
+    uint32_t page_kb = PAGE_SIZE / 1024;
+    uint32_t clean_pages = (cache.total_pages > cache.dirty_pages) ?
+                           cache.total_pages - cache.dirty_pages : 0;
+
+    seq_printf(m, "MemTotal:     %8u kB\n", (unsigned)(buddy.total_bytes / 1024));
+    seq_printf(m, "MemFree:      %8u kB\n", (unsigned)(buddy.free_bytes / 1024));
+    seq_printf(m, "MemAvailable: %8u kB\n",
+               (unsigned)(buddy.free_bytes / 1024 + clean_pages * page_kb));
+    seq_printf(m, "Cached:       %8u kB\n", cache.total_pages * page_kb);
+    seq_printf(m, "Dirty:        %8u kB\n", cache.dirty_pages * page_kb);
+    seq_printf(m, "Locked:       %8u kB\n", cache.locked_pages * page_kb);
+    return 0;
+}
+
+static void proc_put_counter(seq_file_t *m, const char *name, uint64_t value)
+{
+    seq_puts(m, name);
+    seq_putc(m, ' ');
+    seq_put_u64(m, value);
+    seq_putc(m, '\n');
+}
+
+static int proc_vmstat_show(seq_file_t *m, void *v)
+{
+    (void)v;
+    buddy_stats_t buddy;
+    page_cache_stats_t cache;
+    uint64_t faults = 0, handled = 0, fatal = 0;
+    buddy_get_stats(&buddy);
+    page_cache_get_stats(&cache);
+    page_fault_get_stats(&faults, &handled, &fatal);
+
+    proc_put_counter(m, "nr_free_pages", buddy.free_bytes / PAGE_SIZE);
+    proc_put_counter(m, "nr_file_pages", cache.total_pages);
+    proc_put_counter(m, "nr_dirty", cache.dirty_pages);
+    proc_put_counter(m, "nr_locked", cache.locked_pages);
+    proc_put_counter(m, "pgfault", faults);
+    proc_put_counter(m, "pgfault_handled", handled);
+    proc_put_counter(m, "pgfault_fatal", fatal);
+    proc_put_counter(m, "buddy_alloc", buddy.alloc_count);
+    proc_put_counter(m, "buddy_free", buddy.free_count);
+    proc_put_counter(m, "buddy_alloc_fail", buddy.failed_alloc_count);
+    proc_put_counter(m, "pgcache_hit", cache.cache_hits);
+    proc_put_counter(m, "pgcache_miss", cache.cache_misses);
+    proc_put_counter(m, "pgcache_fault", cache.page_faults);
+    proc_put_counter(m, "pgcache_writeback", cache.write_backs);
+    proc_put_counter(m, "pgcache_evict", cache.evictions);
+    return 0;
+}
+
+typedef struct proc_task_counts {
+    uint32_t total;
+    uint32_t runnable;
+    uint32_t last_pid;
+} proc_task_counts_t;
+
+static void proc_task_count_visit(tcb_t *task, void *arg)
+{
+    proc_task_counts_t *counts = (proc_task_counts_t *)arg;
+    counts->total++;
+    if (task->state == TASK_READY || task->state == TASK_RUNNING) {
+        counts->runnable++;
+    }
+    if (task->pid > counts->last_pid) {
+        counts->last_pid = task->pid;
+    }
+}
+
+static int proc_loadavg_show(seq_file_t *m, void *v)
+{
+    (void)v;
+    uint32_t loads[3];
+    proc_task_counts_t counts = { 0 };
+    scheduler_opt_get_loadavg(loads);
+    scheduler_queues_for_each_task(proc_task_count_visit, &counts);
+
+    seq_printf(m, "%u.%02u %u.%02u %u.%02u %u/%u %u\n",
+               LOAD_INT(loads[0]), LOAD_FRAC(loads[0]),
+               LOAD_INT(loads[1]), LOAD_FRAC(loads[1]),
+               LOAD_INT(loads[2]), LOAD_FRAC(loads[2]),
+               counts.runnable, counts.total, counts.last_pid);
+    return 0;
+}
+
+// Legacy PIC lines, by IRQ number
+static const char *const proc_irq_names[16] = {
+    "timer", "keyboard", "cascade", "serial", "serial", "lpt", "floppy", "lpt",
+    "rtc", "acpi", "", "", "mouse", "fpu", "ata", "ata"
+};
+
+// Record tokens: pos 0 is the header, pos n is vector n - 1 (skipping unused ones)
+static void *proc_irq_seek(off_t *pos)
+{
+    if (*pos == 0) {
+        return (void *)1;
+    }
+    while (*pos - 1 < (off_t)IDT_ENTRIES) {
+        int vector = (int)(*pos - 1);
+        if (idt_has_handler(vector) || idt_get_interrupt_count(vector)) {
+            return (void *)(uintptr_t)(vector + 2);
+        }
+        (*pos)++;
+    }
+    return NULL;
+}
+
+static void *proc_irq_start(seq_file_t *m, off_t *pos)
+{
+    (void)m;
+    return proc_irq_seek(pos);
+}
+
+static void *proc_irq_next(seq_file_t *m, void *v, off_t *pos)
+{
+    (void)m;
+    (void)v;
+    (*pos)++;
+    return proc_irq_seek(pos);
+}
+
+static void proc_irq_stop(seq_file_t *m, void *v)
+{
+    (void)m;
+    (void)v;
+}
+
+static int proc_irq_show(seq_file_t *m, void *v)
+{
+    if (v == (void *)1) {
+        seq_puts(m, "           CPU0\n");
+        return 0;
+    }
+
+    int vector = (int)(uintptr_t)v - 2;
+    seq_printf(m, "%3u: %10u  ", (unsigned)vector, idt_get_interrupt_count(vector));
+    if (vector < PIC1_START_VECTOR) {
+        seq_puts(m, "exception\n");
+    } else if (vector < PIC1_START_VECTOR + 16) {
+        int irq = vector - PIC1_START_VECTOR;
+        seq_printf(m, "IRQ%u %s\n", (unsigned)irq, proc_irq_names[irq]);
+    } else {
+        seq_puts(m, "vector\n");
+    }
+    return 0;
+}
+
+static const seq_operations_t proc_interrupts_ops = {
+    .start = proc_irq_start,
+    .next = proc_irq_next,
+    .stop = proc_irq_stop,
+    .show = proc_irq_show
+};
+
+static void proc_slab_visit(slab_cache_t *cache, void *ctx)
+{
+    seq_file_t *m = (seq_file_t *)ctx;
+    unsigned long allocs = 0, frees = 0;
+    slab_cache_stats(cache, &allocs, &frees);
+    seq_printf(m, "%s %lu %u %u %u %lu %lu\n", cache->name, allocs - frees,
+               (unsigned)cache->user_obj_size, (unsigned)cache->internal_slot_size,
+               cache->objs_per_slab_max, allocs, frees);
+}
+
+static int proc_slabinfo_show(seq_file_t *m, void *v)
+{
+    (void)v;
+    seq_puts(m, "# name <active_objs> <objsize> <slotsize> <objperslab> <allocs> <frees>\n");
+    slab_for_each_cache(proc_slab_visit, m);
+    return 0;
+}
+
+// Page orders as in Linux; sub-page blocks (byte orders MIN_ORDER and up) follow
+static int proc_buddyinfo_show(seq_file_t *m, void *v)
+{
+    (void)v;
+    uint32_t counts[MAX_ORDER + 1];
+    buddy_get_free_blocks(counts);
+
+    seq_puts(m, "Node 0, zone   Normal");
+    for (int order = PAGE_SHIFT; order <= MAX_ORDER; order++) {
+        seq_printf(m, " %6u", counts[order]);
+    }
+    seq_puts(m, "\nNode 0, zone  Subpage");
+    for (int order = MIN_ORDER; order < (int)PAGE_SHIFT; order++) {
+        seq_printf(m, " %6u", counts[order]);
+    }
+    seq_putc(m, '\n');
+    return 0;
+}
+
+static int proc_cmdline_show(seq_file_t *m, void *v)
+{
+    (void)v;
+    seq_printf(m, "%s\n", tunables_get_cmdline());
+    return 0;
+}
+
+static const proc_entry_t proc_system_files[] = {
+    { "meminfo",    proc_meminfo_show,   NULL },
+    { "vmstat",     proc_vmstat_show,    NULL },
+    { "loadavg",    proc_loadavg_show,   NULL },
+    { "interrupts", NULL,                &proc_interrupts_ops },
+    { "slabinfo",   proc_slabinfo_show,  NULL },
+    { "buddyinfo",  proc_buddyinfo_show, NULL },
+    { "cmdline",    proc_cmdline_show,   NULL },
+};
+#define PROC_SYSTEM_FILE_COUNT (sizeof(proc_system_files) / sizeof(proc_system_files[0]))
+
+//============================================================================
+// /proc/sys
+//============================================================================
+
+// Length of the "<group>" part of a tunable name
+static size_t proc_sys_group_len(const char *name)
+{
+    const char *dot = strchr(name, '.');
+    return dot ? (size_t)(dot - name) : strlen(name);
+}
+
+static bool proc_sys_in_group(const tunable_t *t, const char *group, size_t len)
+{
+    return proc_sys_group_len(t->name) == len && strncmp(t->name, group, len) == 0;
+}
+
+typedef struct proc_sys_query {
+    const char *group;          // Group to match
+    const char *leaf;           // Name within it, or NULL for any
+    uint32_t index;             // Registry position of the tunable visited
+    bool found;
+} proc_sys_query_t;
+
+static int proc_sys_find_visit(const tunable_t *t, void *arg)
+{
+    proc_sys_query_t *q = (proc_sys_query_t *)arg;
+    size_t len = proc_sys_group_len(t->name);
+    if (proc_sys_in_group(t, q->group, strlen(q->group)) &&
+        (!q->leaf || strcmp(t->name + len + 1, q->leaf) == 0)) {
+        q->found = true;
+        return 1;
+    }
+    q->index++;
+    return 0;
+}
+
+/**
+ * @brief Finds group.leaf (or the group's first tunable if leaf is NULL)
+ * @return true and its registry index if it exists
+ */
+static bool proc_sys_find(const char *group, const char *leaf, uint32_t *index)
+{
+    proc_sys_query_t q = { .group = group, .leaf = leaf, .index = 0, .found = false };
+    tunables_for_each(proc_sys_find_visit, &q);
+    *index = q.index;
+    return q.found;
+}
+
+typedef struct proc_sys_list {
+    proc_sys_item_t *items;
+    uint32_t count;
+    uint32_t cap;
+    uint32_t index;             // Registry position of the tunable visited
+    const char *group;          // List this group's tunables, or NULL for the groups
+} proc_sys_list_t;
+
+static int proc_sys_count_visit(const tunable_t *t, void *arg)
+{
+    (void)t;
+    (*(uint32_t *)arg)++;
+    return 0;
+}
+
+static int proc_sys_collect(const tunable_t *t, void *arg)
+{
+    proc_sys_list_t *list = (proc_sys_list_t *)arg;
+    uint32_t index = list->index++;
+    if (list->count == list->cap) {
+        return 1;
+    }
+
+    if (list->group) {
+        if (!proc_sys_in_group(t, list->group, strlen(list->group))) {
+            return 0;
+        }
+    } else {
+        // One entry per group, at its first tunable
+        size_t len = proc_sys_group_len(t->name);
+        for (uint32_t i = 0; i < list->count; i++) {
+            if (proc_sys_in_group(list->items[i].tunable, t->name, len)) {
+                return 0;
+            }
+        }
+    }
+    list->items[list->count].tunable = t;
+    list->items[list->count].index = index;
+    list->count++;
+    return 0;
+}
+
+/**
+ * @brief Takes the listing of a /proc/sys directory into node->items
+ * @return false if out of memory
+ */
+static bool proc_sys_list(proc_node_t *node, const char *group)
+{
+    // Tunables are never unregistered, so the pointers stay valid
+    uint32_t total = 0;
+    tunables_for_each(proc_sys_count_visit, &total);
+    if (total == 0) {
+        return true;
+    }
+
+    proc_sys_list_t list = { .items = NULL, .count = 0, .cap = total, .index = 0, .group = group };
+    list.items = (proc_sys_item_t *)kmalloc(total * sizeof(proc_sys_item_t));
+    if (!list.items) {
+        return false;
+    }
+    tunables_for_each(proc_sys_collect, &list);
+    node->items = list.items;
+    node->nitems = list.count;
+    return true;
+}
+
+static int proc_sys_show(seq_file_t *m, void *v)
+{
+    (void)v;
+    proc_node_t *node = (proc_node_t *)m->private;
+    seq_printf(m, "%lu\n", (unsigned long)tunable_get(node->tunable));
+    return 0;
+}
+
+//============================================================================
+// Path lookup and directory listing
+//============================================================================
+
+static size_t proc_format_uint(char *out, uint32_t value)
+{
+    char digits[10];
+    size_t n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    size_t len = 0;
+    while (n > 0) {
+        out[len++] = digits[--n];
+    }
+    out[len] = '\0';
+    return len;
+}
+
+static bool proc_parse_uint(const char *s, uint32_t *out)
+{
+    uint32_t value = 0;
+    if (!*s || (s[0] == '0' && s[1])) {
+        return false;
+    }
+    for (; *s; s++) {
+        if (*s < '0' || *s > '9' || value > 429496728u) {
+            return false;
+        }
+        value = value * 10 + (uint32_t)(*s - '0');
+    }
+    *out = value;
+    return true;
+}
+
+static int proc_find_entry(const proc_entry_t *table, size_t count, const char *name)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(table[i].name, name) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+// Splits path into at most 3 components; returns the count, or -1
+static int proc_split_path(const char *path, char comps[3][PROC_NAME_MAX])
+{
+    int n = 0;
+    while (*path) {
+        while (*path == '/') path++;
+        if (!*path) break;
+        if (n == 3) return -1;
+
+        size_t len = 0;
+        while (path[len] && path[len] != '/') len++;
+        if (len >= PROC_NAME_MAX) return -1;
+        memcpy(comps[n], path, len);
+        comps[n][len] = '\0';
+        path += len;
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Resolves a path relative to the mount into node (kind, pid, fd, entry)
+ * @return true if the path names an existing entry
+ */
+static bool proc_lookup(const char *path, proc_node_t *node)
+{
+    char comps[3][PROC_NAME_MAX];
+    int n = proc_split_path(path, comps);
+    if (n < 0) {
+        return false;
+    }
+    if (n == 0) {
+        node->kind = PROC_ROOT_DIR;
+        return true;
+    }
+
+    if (strcmp(comps[0], "sys") == 0) {
+        if (n == 1) {
+            node->kind = PROC_SYS_DIR;
+            return true;
+        }
+        if (!proc_sys_find(comps[1], n == 3 ? comps[2] : NULL, &node->entry)) {
+            return false;
+        }
+        if (n == 2) {
+            node->kind = PROC_SYS_GROUP_DIR;
+            strcpy(node->group, comps[1]);
+            return true;
+        }
+
+        char name[TUNABLE_NAME_MAX];
+        size_t group_len = strlen(comps[1]);
+        if (group_len + 1 + strlen(comps[2]) >= sizeof(name)) {
+            return false;
+        }
+        memcpy(name, comps[1], group_len);
+        name[group_len] = '.';
+        strcpy(name + group_len + 1, comps[2]);
+        node->tunable = tunable_find(name);
+        node->kind = PROC_SYS_FILE;
+        return node->tunable != NULL;
+    }
+
+    int idx = proc_find_entry(proc_system_files, PROC_SYSTEM_FILE_COUNT, comps[0]);
+    if (idx >= 0) {
+        node->kind = PROC_SYSTEM_FILE;
+        node->entry = (uint32_t)idx;
+        return n == 1;
+    }
+
+    uint32_t pid;
+    if (strcmp(comps[0], "self") == 0) {
+        pcb_t *current = get_current_process();
+        if (!current) return false;
+        pid = current->pid;
+    } else if (!proc_parse_uint(comps[0], &pid)) {
+        return false;
+    }
+    if (!proc_with_task(pid, NULL, NULL)) {
+        return false;
+    }
+    node->pid = pid;
+
+    if (n == 1) {
+        node->kind = PROC_PID_DIR;
+        return true;
+    }
+    if (strcmp(comps[1], "fd") == 0) {
+        if (n == 2) {
+            node->kind = PROC_FD_DIR;
+            return true;
+        }
+        uint32_t fd, mask = 0;
+        if (!proc_parse_uint(comps[2], &fd) || fd >= MAX_FD) return false;
+        proc_with_task(pid, proc_fd_mask_task, &mask);
+        if (!(mask & (1u << fd))) return false;
+        node->kind = PROC_FD_FILE;
+        node->fd = (int)fd;
+        return true;
+    }
+
+    idx = proc_find_entry(proc_pid_files, PROC_PID_FILE_COUNT, comps[1]);
+    if (idx < 0 || n != 2) {
+        return false;
+    }
+    node->kind = PROC_PID_FILE;
+    node->entry = (uint32_t)idx;
+    return true;
+}
+
+static bool proc_is_dir(const proc_node_t *node)
+{
+    return node->kind == PROC_ROOT_DIR || node->kind == PROC_PID_DIR ||
+           node->kind == PROC_FD_DIR || node->kind == PROC_SYS_DIR ||
+           node->kind == PROC_SYS_GROUP_DIR;
+}
+
+static uint32_t proc_node_ino(const proc_node_t *node)
+{
+    switch (node->kind) {
+        case PROC_ROOT_DIR:    return PROC_INO(0, PROC_SLOT_DIR);
+        case PROC_SYSTEM_FILE: return PROC_INO(0, PROC_SLOT_FILE + node->entry);
+        case PROC_PID_DIR:     return PROC_INO(node->pid, PROC_SLOT_DIR);
+        case PROC_FD_DIR:      return PROC_INO(node->pid, PROC_SLOT_FD_DIR);
+        case PROC_PID_FILE:    return PROC_INO(node->pid, PROC_SLOT_FILE + node->entry);
+        case PROC_FD_FILE:     return PROC_INO(node->pid, PROC_SLOT_FD + node->fd);
+        case PROC_SYS_DIR:     return PROC_INO(0, PROC_SLOT_SYS_DIR);
+        case PROC_SYS_GROUP_DIR: return PROC_INO(0, PROC_SLOT_SYS_GROUP + node->entry);
+        case PROC_SYS_FILE:    return PROC_INO(0, PROC_SLOT_SYS_FILE + node->entry);
+        default:               return 0;
+    }
+}
+
+/**
+ * @brief Describes the directory entry at *pos, or the next one after a gap
+ * @return false past the last entry
+ */
+static bool proc_dir_entry(const proc_node_t *node, off_t *pos, char *name,
+                           uint32_t *ino, uint8_t *type)
+{
+    off_t p = *pos;
+    if (p < 2) {
+        strcpy(name, p == 0 ? "." : "..");
+        *ino = proc_node_ino(node);
+        *type = DT_DIR;
+        return true;
+    }
+    p -= 2;
+
+    switch (node->kind) {
+        case PROC_ROOT_DIR:
+            if (p < (off_t)PROC_SYSTEM_FILE_COUNT) {
+                strcpy(name, proc_system_files[p].name);
+                *ino = PROC_INO(0, PROC_SLOT_FILE + p);
+                *type = DT_REG;
+                return true;
+            }
+            p -= PROC_SYSTEM_FILE_COUNT;
+            if (p == 0) {
+                strcpy(name, "self");
+                *ino = PROC_INO(0, PROC_SLOT_DIR + 1);
+                *type = DT_DIR;
+                return true;
+            }
+            if (p == 1) {
+                strcpy(name, "sys");
+                *ino = PROC_INO(0, PROC_SLOT_SYS_DIR);
+                *type = DT_DIR;
+                return true;
+            }
+            p -= 2;
+            if (p < (off_t)node->npids) {
+                proc_format_uint(name, node->pids[p]);
+                *ino = PROC_INO(node->pids[p], PROC_SLOT_DIR);
+                *type = DT_DIR;
+                return true;
+            }
+            return false;
+
+        case PROC_PID_DIR:
+            if (p < (off_t)PROC_PID_FILE_COUNT) {
+                strcpy(name, proc_pid_files[p].name);
+                *ino = PROC_INO(node->pid, PROC_SLOT_FILE + p);
+                *type = DT_REG;
+                return true;
+            }
+            if (p == (off_t)PROC_PID_FILE_COUNT) {
+                strcpy(name, "fd");
+                *ino = PROC_INO(node->pid, PROC_SLOT_FD_DIR);
+                *type = DT_DIR;
+                return true;
+            }
+            return false;
+
+        case PROC_FD_DIR:
+            for (; p < (off_t)MAX_FD; p++, (*pos)++) {
+                if (node->fd_mask & (1u << p)) {
+                    proc_format_uint(name, (uint32_t)p);
+                    *ino = PROC_INO(node->pid, PROC_SLOT_FD + p);
+                    *type = DT_REG;
+                    return true;
+                }
+            }
+            return false;
+
+        case PROC_SYS_DIR:
+            if (p < (off_t)node->nitems) {
+                const proc_sys_item_t *item = &node->items[p];
+                size_t len = proc_sys_group_len(item->tunable->name);
+                memcpy(name, item->tunable->name, len);
+                name[len] = '\0';
+                *ino = PROC_INO(0, PROC_SLOT_SYS_GROUP + item->index);
+                *type = DT_DIR;
+                return true;
+            }
+            return false;
+
+        case PROC_SYS_GROUP_DIR:
+            if (p < (off_t)node->nitems) {
+                const proc_sys_item_t *item = &node->items[p];
+                strcpy(name, item->tunable->name + proc_sys_group_len(item->tunable->name) + 1);
+                *ino = PROC_INO(0, PROC_SLOT_SYS_FILE + item->index);
+                *type = DT_REG;
+                return true;
+            }
+            return false;
+
+        default:
+            return false;
+    }
+}
+
+//============================================================================
+// VFS operations
+//============================================================================
+
+static void *proc_vfs_mount(const char *device)
+{
+    (void)device;
+    // Nothing to mount; VFS only needs a non-NULL context
+    return (void *)0x1;
+}
+
+static int proc_vfs_unmount(void *fs_context)
+{
+    (void)fs_context;
+    return 0;
+}
+
+static vnode_t *proc_vfs_open(void *fs_context, const char *path, int flags)
+{
+    (void)fs_context;
+
+    proc_node_t *node = (proc_node_t *)kmalloc(sizeof(proc_node_t));
+    if (!node) {
+        return NULL;
+    }
+    memset(node, 0, sizeof(proc_node_t));
+    if (!proc_lookup(path ? path : "/", node)) {
+        kfree(node);
+        return NULL;
+    }
+
+    // Only runtime tunables are writable
+    if ((flags & O_ACCMODE) != O_RDONLY &&
+        (node->kind != PROC_SYS_FILE || (node->tunable->flags & TUNABLE_BOOT_ONLY))) {
+        kfree(node);
+        return NULL;
+    }
+
+    switch (node->kind) {
+        case PROC_ROOT_DIR: {
+            // Sized with slack for tasks created between the two walks
+            uint32_t tasks = 0;
+            scheduler_queues_for_each_task(proc_count_visit, &tasks);
+            proc_pid_list_t list = { .pids = NULL, .count = 0, .cap = tasks + 8 };
+            list.pids = (uint32_t *)kmalloc(list.cap * sizeof(uint32_t));
+            if (!list.pids) {
+                kfree(node);
+                return NULL;
+            }
+            scheduler_queues_for_each_task(proc_pid_collect, &list);
+            node->pids = list.pids;
+            node->npids = list.count;
+            break;
+        }
+        case PROC_FD_DIR:
+            proc_with_task(node->pid, proc_fd_mask_task, &node->fd_mask);
+            break;
+        case PROC_SYSTEM_FILE: {
+            const proc_entry_t *entry = &proc_system_files[node->entry];
+            if (entry->ops) {
+                seq_open(&node->seq, entry->ops, node);
+            } else {
+                single_open(&node->seq, entry->show, node);
+            }
+            break;
+        }
+        case PROC_PID_FILE:
+            single_open(&node->seq, proc_pid_files[node->entry].show, node);
+            break;
+        case PROC_FD_FILE:
+            single_open(&node->seq, proc_pid_fd_show, node);
+            break;
+        case PROC_SYS_DIR:
+        case PROC_SYS_GROUP_DIR:
+            if (!proc_sys_list(node, node->kind == PROC_SYS_DIR ? NULL : node->group)) {
+                kfree(node);
+                return NULL;
+            }
+            break;
+        case PROC_SYS_FILE:
+            single_open(&node->seq, proc_sys_show, node);
+            break;
+        default:
+            break;
+    }
+
+    vnode_t *vnode = (vnode_t *)kmalloc(sizeof(vnode_t));
+    if (!vnode) {
+        if (node->pids) kfree(node->pids);
+        if (node->items) kfree(node->items);
+        kfree(node);
+        return NULL;
+    }
+    memset(vnode, 0, sizeof(vnode_t));
+    vnode->data = node;
+    vnode->fs_driver = &proc_driver;
+    return vnode;
+}
+
+static int proc_vfs_read(file_t *file, void *buffer, size_t count)
+{
+    if (!file || !file->vnode || !file->vnode->data || !buffer) {
+        return -EINVAL;
+    }
+
+    proc_node_t *node = (proc_node_t *)file->vnode->data;
+    if (proc_is_dir(node)) {
+        return -EISDIR;
+    }
+    return seq_read(&node->seq, file->offset, buffer, count);
+}
+
+// Writes set a tunable; the whole value must arrive in one write
+static int proc_vfs_write(file_t *file, const void *buffer, size_t count)
+{
+    if (!file || !file->vnode || !file->vnode->data || !buffer) {
+        return -EINVAL;
+    }
+
+    proc_node_t *node = (proc_node_t *)file->vnode->data;
+    if (node->kind != PROC_SYS_FILE) {
+        return -EACCES;
+    }
+
+    char text[24];
+    if (count >= sizeof(text)) {
+        return -EINVAL;
+    }
+    memcpy(text, buffer, count);
+    text[count] = '\0';
+
+    int err = tunable_set_string(node->tunable, text, count);
+    return err < 0 ? err : (int)count;
+}
+
+static int proc_vfs_close(file_t *file)
+{
+    if (!file || !file->vnode) {
+        return 0;
+    }
+
+    proc_node_t *node = (proc_node_t *)file->vnode->data;
+    if (node) {
+        seq_release(&node->seq);
+        if (node->pids) kfree(node->pids);
+        if (node->items) kfree(node->items);
+        kfree(node);
+        file->vnode->data = NULL;
+    }
+
+    kfree(file->vnode);
+    file->vnode = NULL;
+    return 0;
+}
+
+static off_t proc_vfs_lseek(file_t *file, off_t offset, int whence)
+{
+    if (!file || !file->vnode) {
+        return -EINVAL;
+    }
+
+    // Generated files have no size, so SEEK_END is not supported
+    off_t base;
+    switch (whence) {
+        case SEEK_SET: base = 0; break;
+        case SEEK_CUR: base = file->offset; break;
+        default: return -EINVAL;
+    }
+    if (base + offset < 0) {
+        return -EINVAL;
+    }
+    file->offset = base + offset;
+    return file->offset;
+}
+
+static int proc_vfs_getdents(file_t *dir_file, vfs_filldir_t filldir, void *ctx)
+{
+    if (!dir_file || !dir_file->vnode || !dir_file->vnode->data) {
+        return -EINVAL;
+    }
+
+    proc_node_t *node = (proc_node_t *)dir_file->vnode->data;
+    if (!proc_is_dir(node)) {
+        return -ENOTDIR;
+    }
+
+    char name[PROC_NAME_MAX];
+    uint32_t ino;
+    uint8_t type;
+    int emitted = 0;
+    off_t pos = dir_file->offset;
+    while (proc_dir_entry(node, &pos, name, &ino, &type)) {
+        if (filldir(ctx, name, strlen(name), ino, type, pos + 1) != 0) {
+            break;
+        }
+        pos++;
+        dir_file->offset = pos;
+        emitted++;
+    }
+    return emitted;
+}
+
+static int proc_vfs_fstat(file_t *file, struct stat *st)
+{
+    if (!file || !file->vnode || !file->vnode->data) {
+        return FS_ERR_BAD_F;
+    }
+
+    proc_node_t *node = (proc_node_t *)file->vnode->data;
+    bool dir = proc_is_dir(node);
+    st->st_dev = PROC_DEV;
+    st->st_ino = proc_node_ino(node);
+    if (dir) {
+        st->st_mode = S_IFDIR | 0555;
+    } else if (node->kind == PROC_SYS_FILE && !(node->tunable->flags & TUNABLE_BOOT_ONLY)) {
+        st->st_mode = S_IFREG | 0644;
+    } else {
+        st->st_mode = S_IFREG | 0444;
+    }
+    st->st_nlink = dir ? 2 : 1;
+    st->st_size = 0;
+    st->st_mtime = 0;
+    st->st_blksize = PAGE_SIZE;
+    st->st_blocks = 0;
+    return FS_SUCCESS;
+}
+
+int procfs_init(void)
+{
+    int result = vfs_register_driver(&proc_driver);
+    if (result < 0) {
+        serial_printf("[Procfs] Failed to register proc driver: %d\n", result);
+        return result;
+    }
+
+    result = vfs_mount(PROCFS_MOUNT_POINT, "proc", "proc");
+    if (result < 0) {
+        serial_printf("[Procfs] Failed to mount at %s: %d\n", PROCFS_MOUNT_POINT, result);
+        vfs_unregister_driver(&proc_driver);
+        return result;
+    }
+
+    serial_printf("[Procfs] Mounted at %s\n", PROCFS_MOUNT_POINT);
+    return 0;
+}
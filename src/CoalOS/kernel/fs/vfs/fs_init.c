@@ -17,11 +17,15 @@
  #include <kernel/fs/vfs/fs_config.h>   // Not including as ROOT_* defines are missing
  #include <kernel/core/types.h>          // Standard types (bool, etc.)
  #include <kernel/fs/vfs/sys_file.h>       // For O_RDONLY used in test function
+ #include <kernel/fs/vfs/page_cache.h>     // page_cache_init
  #include <kernel/memory/kmalloc.h>        // For memory allocation (used in test function)
  #include <kernel/fs/vfs/mount_table.h>    // For list_mounts()
  #include <kernel/drivers/input/keyboard_hw.h> 
  #include <kernel/drivers/display/serial.h>  
  #include <kernel/lib/port_io.h>       // For inb() used in debugging
+ #include <kernel/drivers/misc/stats_dev.h> // /dev/stats pseudo-device
+ #include <kernel/memory/shmem.h>          // /dev/shm shared memory objects
+ #include <kernel/fs/procfs/procfs.h>      // /proc statistics
  
  #include <kernel/lib/string.h>         // For strcmp, etc.
  
@@ -53,11 +57,13 @@
       int ret = FS_SUCCESS;
   
       // 1. Initialize Buffer Cache (Should happen before disk registration)
-      //    Assuming buffer_cache_init() is called elsewhere during kernel boot.
+      buffer_cache_init();
   
       // 2. Initialize VFS Layer
       terminal_write("[FS_INIT] Initializing VFS layer...\n");
       vfs_init(); // Initialize mount table, file descriptor table etc.
+      page_cache_init();
+      vfs_performance_init(); // Read-ahead buffers
   
       // 3. Register Filesystem Drivers
       terminal_write("[FS_INIT] Registering FAT filesystem driver...\n");
@@ -125,6 +131,17 @@
           return ret; // Propagate mount error
       }
   
+      // 6. Pseudo-devices mounted beside the root (non-fatal on failure)
+      if (stats_dev_init() != FS_SUCCESS) {
+          terminal_write("[FS_INIT] Warning: /dev/stats unavailable.\n");
+      }
+      if (shmem_init() != FS_SUCCESS) {
+          terminal_write("[FS_INIT] Warning: /dev/shm unavailable.\n");
+      }
+      if (procfs_init() != FS_SUCCESS) {
+          terminal_write("[FS_INIT] Warning: /proc unavailable.\n");
+      }
+  
       s_fs_initialized = true;
       terminal_write("[FS_INIT] File system initialization complete.\n");
       terminal_write("[FS_INIT] Current mount points:\n");
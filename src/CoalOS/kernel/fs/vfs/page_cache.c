@@ -17,6 +17,8 @@
 #include <kernel/drivers/display/serial.h>
 #include <kernel/lib/string.h>
 #include <kernel/lib/assert.h>
+#include <kernel/lib/percpu_counter.h>
+#include <kernel/lib/tunables.h>
 #include <kernel/process/scheduler.h>  // For yield()
 #include <libc/stdint.h>
 #include <libc/stdbool.h>
@@ -35,12 +37,45 @@ static page_cache_entry_t *lru_tail = NULL;  // Least recently used
 // Global cache lock
 static spinlock_t cache_lock;
 
-// Statistics
+// Statistics: gauges live in cache_stats under cache_lock, event counts in
+// per-CPU counters so lookups do not bounce a shared line ("pcache.*").
 static page_cache_stats_t cache_stats;
+static struct {
+    percpu_counter_t cache_hits;
+    percpu_counter_t cache_misses;
+    percpu_counter_t write_backs;
+    percpu_counter_t evictions;
+} cache_events;
 
 // Current number of pages in cache
 static uint32_t current_pages = 0;
 
+// Cache size limit (vm.page_cache_max_pages)
+static uint32_t max_pages = PAGE_CACHE_MAX_PAGES;
+
+// Evicts down to a lowered limit now instead of one page per later miss
+static void max_pages_changed(const tunable_t *t, uint32_t old_value) {
+    (void)t;
+    (void)old_value;
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&cache_lock);
+    uint32_t excess = (current_pages > max_pages) ? current_pages - max_pages : 0;
+    spinlock_release_irqrestore(&cache_lock, irq_flags);
+
+    if (excess > 0) {
+        page_cache_shrink((int)excess);
+    }
+}
+
+static tunable_t max_pages_tunable = {
+    .name = "vm.page_cache_max_pages",
+    .desc = "Pages the file page cache may hold",
+    .type = TUNABLE_U32,
+    .value = &max_pages,
+    .min = 16,
+    .max = 65536,
+    .changed = max_pages_changed,
+};
+
 // Logging macros
 #define PAGE_CACHE_ERROR(fmt, ...) serial_printf("[PageCache ERROR] %s:%d: " fmt "\n", __func__, __LINE__, ##__VA_ARGS__)
 #define PAGE_CACHE_WARN(fmt, ...)  serial_printf("[PageCache WARN ] " fmt "\n", ##__VA_ARGS__)
@@ -243,7 +278,7 @@ static int page_write_to_disk(page_cache_entry_t *page) {
     }
     
     page->flags &= ~PAGE_FLAG_DIRTY;
-    cache_stats.write_backs++;
+    percpu_counter_inc(&cache_events.write_backs);
     
     return 0;
 }
@@ -327,7 +362,7 @@ static int try_evict_page(uintptr_t *irq_flags) {
                 hash_remove(victim);
                 lru_remove(victim);
                 current_pages--;
-                cache_stats.evictions++;
+                percpu_counter_inc(&cache_events.evictions);
                 
                 // Free the page
                 page_free(victim);
@@ -357,10 +392,16 @@ void page_cache_init(void) {
     
     // Clear statistics
     memset(&cache_stats, 0, sizeof(cache_stats));
+    percpu_counter_init(&cache_events.cache_hits, "pcache.hits", 0);
+    percpu_counter_init(&cache_events.cache_misses, "pcache.misses", 0);
+    percpu_counter_init(&cache_events.write_backs, "pcache.write_backs", 0);
+    percpu_counter_init(&cache_events.evictions, "pcache.evictions", 0);
     
     // Initialize LRU list
     lru_head = lru_tail = NULL;
     current_pages = 0;
+
+    tunable_register(&max_pages_tunable);
     
     PAGE_CACHE_INFO("Page cache initialized with %u hash buckets", PAGE_CACHE_HASH_SIZE);
 }
@@ -376,16 +417,16 @@ page_cache_entry_t* page_cache_get(uint32_t device_id, uint32_t inode_number,
         // Cache hit
         page->ref_count++;
         lru_touch(page);
-        cache_stats.cache_hits++;
+        percpu_counter_inc(&cache_events.cache_hits);
         spinlock_release_irqrestore(&cache_lock, irq_flags);
         return page;
     }
     
     // Cache miss
-    cache_stats.cache_misses++;
+    percpu_counter_inc(&cache_events.cache_misses);
     
     // Check if we need to evict
-    if (current_pages >= PAGE_CACHE_MAX_PAGES) {
+    if (current_pages >= max_pages) {
         if (try_evict_page(&irq_flags) < 0) {
             spinlock_release_irqrestore(&cache_lock, irq_flags);
             PAGE_CACHE_ERROR("Failed to evict page, cache full");
@@ -442,9 +483,9 @@ page_cache_entry_t* page_cache_find(uint32_t device_id, uint32_t inode_number,
     if (page) {
         page->ref_count++;
         lru_touch(page);
-        cache_stats.cache_hits++;
+        percpu_counter_inc(&cache_events.cache_hits);
     } else {
-        cache_stats.cache_misses++;
+        percpu_counter_inc(&cache_events.cache_misses);
     }
     
     spinlock_release_irqrestore(&cache_lock, irq_flags);
@@ -852,6 +893,10 @@ void page_cache_get_stats(page_cache_stats_t *stats) {
     
     memcpy(stats, &cache_stats, sizeof(page_cache_stats_t));
     stats->total_pages = current_pages;
+    stats->cache_hits = (uint64_t)percpu_counter_sum(&cache_events.cache_hits);
+    stats->cache_misses = (uint64_t)percpu_counter_sum(&cache_events.cache_misses);
+    stats->write_backs = (uint64_t)percpu_counter_sum(&cache_events.write_backs);
+    stats->evictions = (uint64_t)percpu_counter_sum(&cache_events.evictions);
     
     spinlock_release_irqrestore(&cache_lock, irq_flags);
 }
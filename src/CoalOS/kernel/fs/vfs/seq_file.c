@@ -0,0 +1,271 @@
+/**
+ * @file seq_file.c
+ * @brief Generated-on-read text files (see seq_file.h)
+ */
+
+#include <kernel/fs/vfs/seq_file.h>
+#include <kernel/fs/vfs/fs_errno.h>
+#include <kernel/memory/kmalloc.h>
+#include <kernel/lib/string.h>
+#include <kernel/lib/math64.h>
+#include <kernel/core/constants.h>
+#include <libc/stddef.h>
+
+// Kernel printf core (terminal.c); always NUL-terminates, returns chars written
+extern int _vsnprintf(char *str, size_t size, const char *fmt, va_list args);
+
+//============================================================================
+// single_open() iterator: one record at position 0
+//============================================================================
+
+static void *single_start(seq_file_t *m, off_t *pos)
+{
+    (void)m;
+    return (*pos == 0) ? (void *)1 : NULL;
+}
+
+static void *single_next(seq_file_t *m, void *v, off_t *pos)
+{
+    (void)m;
+    (void)v;
+    (*pos)++;
+    return NULL;
+}
+
+static void single_stop(seq_file_t *m, void *v)
+{
+    (void)m;
+    (void)v;
+}
+
+static int single_show_record(seq_file_t *m, void *v)
+{
+    return m->single_show(m, v);
+}
+
+static const seq_operations_t single_ops = {
+    .start = single_start,
+    .next = single_next,
+    .stop = single_stop,
+    .show = single_show_record
+};
+
+//============================================================================
+// Setup and teardown
+//============================================================================
+
+void seq_open(seq_file_t *m, const seq_operations_t *op, void *private)
+{
+    memset(m, 0, sizeof(*m));
+    m->op = op;
+    m->private = private;
+}
+
+void single_open(seq_file_t *m, int (*show)(seq_file_t *m, void *v), void *private)
+{
+    seq_open(m, &single_ops, private);
+    m->single_show = show;
+}
+
+void seq_release(seq_file_t *m)
+{
+    if (m->buf) {
+        kfree(m->buf);
+    }
+    m->buf = NULL;
+    m->size = 0;
+    m->count = 0;
+    m->from = 0;
+}
+
+//============================================================================
+// Generation
+//============================================================================
+
+/**
+ * @brief Refills the buffer with whole records starting at m->index
+ * @return Bytes generated (0 at end of file), or negative error code
+ */
+static int seq_fill(seq_file_t *m)
+{
+    m->count = 0;
+    m->from = 0;
+
+    off_t pos = m->index;
+    void *v = m->op->start(m, &pos);
+    while (v) {
+        size_t before = m->count;
+        m->overflow = false;
+
+        int err = m->op->show(m, v);
+        if (err < 0) {
+            m->op->stop(m, v);
+            m->count = before;
+            return before ? (int)before : err;
+        }
+        if (err == SEQ_SKIP) {
+            m->count = before;
+        }
+
+        if (m->overflow) {
+            m->count = before;
+            if (before > 0) {
+                break; // Generated again at the start of the next fill
+            }
+
+            // The record alone does not fit: grow and start it over
+            m->op->stop(m, v);
+            if (m->size * 2 > SEQ_BUF_MAX) {
+                return -ENOMEM;
+            }
+            char *bigger = (char *)kmalloc(m->size * 2);
+            if (!bigger) {
+                return -ENOMEM;
+            }
+            kfree(m->buf);
+            m->buf = bigger;
+            m->size *= 2;
+
+            pos = m->index;
+            v = m->op->start(m, &pos);
+            continue;
+        }
+
+        v = m->op->next(m, v, &pos);
+        m->index = pos;
+    }
+    m->op->stop(m, v);
+    return (int)m->count;
+}
+
+int seq_read(seq_file_t *m, off_t pos, void *out, size_t count)
+{
+    if (!m || !m->op || !out || pos < 0) {
+        return -EINVAL;
+    }
+
+    if (!m->buf) {
+        m->buf = (char *)kmalloc(PAGE_SIZE);
+        if (!m->buf) {
+            return -ENOMEM;
+        }
+        m->size = PAGE_SIZE;
+    }
+
+    // Backward seek (or a fresh pread): regenerate from the first record
+    if (pos < m->read_pos) {
+        m->index = 0;
+        m->read_pos = 0;
+        m->count = 0;
+        m->from = 0;
+    }
+
+    // Forward seek: discard generated text up to pos
+    while (m->read_pos < pos) {
+        if (m->from == m->count) {
+            int filled = seq_fill(m);
+            if (filled <= 0) {
+                return filled;
+            }
+        }
+        size_t skip = m->count - m->from;
+        if ((off_t)skip > pos - m->read_pos) {
+            skip = (size_t)(pos - m->read_pos);
+        }
+        m->from += skip;
+        m->read_pos += (off_t)skip;
+    }
+
+    size_t copied = 0;
+    while (copied < count) {
+        if (m->from == m->count) {
+            int filled = seq_fill(m);
+            if (filled < 0) {
+                return copied ? (int)copied : filled;
+            }
+            if (filled == 0) {
+                break;
+            }
+        }
+        size_t n = m->count - m->from;
+        if (n > count - copied) {
+            n = count - copied;
+        }
+        memcpy((char *)out + copied, m->buf + m->from, n);
+        m->from += n;
+        m->read_pos += (off_t)n;
+        copied += n;
+    }
+    return (int)copied;
+}
+
+//============================================================================
+// Output helpers
+//============================================================================
+
+void seq_vprintf(seq_file_t *m, const char *fmt, va_list args)
+{
+    if (m->overflow) {
+        return;
+    }
+    size_t room = m->size - m->count;
+    if (room < 2) {
+        m->overflow = true;
+        return;
+    }
+
+    // Filling the buffer to the last byte may mean the text was cut short
+    int len = _vsnprintf(m->buf + m->count, room, fmt, args);
+    if (len < 0 || (size_t)len >= room - 1) {
+        m->overflow = true;
+        return;
+    }
+    m->count += (size_t)len;
+}
+
+void seq_printf(seq_file_t *m, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    seq_vprintf(m, fmt, args);
+    va_end(args);
+}
+
+void seq_puts(seq_file_t *m, const char *s)
+{
+    size_t len = strlen(s);
+    if (m->overflow || len > m->size - m->count) {
+        m->overflow = true;
+        return;
+    }
+    memcpy(m->buf + m->count, s, len);
+    m->count += len;
+}
+
+void seq_putc(seq_file_t *m, char c)
+{
+    if (m->overflow || m->count >= m->size) {
+        m->overflow = true;
+        return;
+    }
+    m->buf[m->count++] = c;
+}
+
+void seq_put_u64(seq_file_t *m, uint64_t value)
+{
+    char digits[20];
+    size_t n = 0;
+    do {
+        uint32_t rem;
+        value = div_u64_rem(value, 10, &rem);
+        digits[n++] = (char)('0' + rem);
+    } while (value && n < sizeof(digits));
+
+    if (m->overflow || n > m->size - m->count) {
+        m->overflow = true;
+        return;
+    }
+    while (n > 0) {
+        m->buf[m->count++] = digits[--n];
+    }
+}
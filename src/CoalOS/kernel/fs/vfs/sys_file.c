@@ -97,10 +97,32 @@
          return -ENOENT; // Common error if file not found and O_CREAT not set or failed.
      }
  
+     int fd_or_err = sys_file_install(vfs_file, flags);
+     if (fd_or_err < 0) {
+         SF_LOG("sys_open: Could not install fd (%d) for path '%s'", fd_or_err, pathname);
+         return fd_or_err;
+     }
+ 
+     SF_LOG("sys_open: Success. Path '%s' -> fd %d", pathname, fd_or_err);
+     return fd_or_err; // This is the non-negative file descriptor
+ }
+ 
+ /**
+  * @brief Installs an open VFS file in the lowest free descriptor.
+  * Takes ownership of vfs_file: it is closed if no descriptor can be assigned.
+  * @return File descriptor on success, negative POSIX errno on failure.
+  */
+ int sys_file_install(file_t *vfs_file, int flags) {
+     pcb_t *current_proc = get_current_process();
+     if (!current_proc || !vfs_file) {
+         if (vfs_file) vfs_close(vfs_file);
+         return -EFAULT;
+     }
+ 
      sys_file_t *sf = (sys_file_t *)kmalloc(sizeof(sys_file_t));
      if (!sf) {
          vfs_close(vfs_file); // Clean up allocated VFS file
-         SF_LOG("sys_open: kmalloc for sys_file_t failed for path '%s'", pathname);
+         SF_LOG("sys_file_install: kmalloc for sys_file_t failed");
          return -ENOMEM;
      }
      sf->vfs_file = vfs_file;
@@ -113,12 +135,10 @@
      if (fd_or_err == EMFILE) { // assign_fd_locked returns positive EMFILE
          vfs_close(vfs_file);
          kfree(sf);
-         SF_LOG("sys_open: No free FDs (EMFILE) for path '%s'", pathname);
+         SF_LOG("sys_file_install: No free FDs (EMFILE)");
          return -EMFILE; // Convert to negative errno
      }
- 
-     SF_LOG("sys_open: Success. Path '%s' -> fd %d", pathname, fd_or_err);
-     return fd_or_err; // This is the non-negative file descriptor
+     return fd_or_err;
  }
  
  /**
@@ -181,6 +201,108 @@
      return bytes_written; // vfs_write returns bytes written (>=0) or negative FS_ERR_*
  }
  
+ /**
+  * @brief Reads from a descriptor at pos without moving its offset.
+  * @return Number of bytes read, or negative error code on failure.
+  */
+ ssize_t sys_pread(int fd, void *kbuf, size_t count, off_t pos) {
+     if (kbuf == NULL && count != 0) return -EFAULT;
+     if (count == 0) return 0;
+
+     pcb_t *current_proc = get_current_process();
+     if (!current_proc) return -EFAULT;
+
+     uintptr_t irq_flags = spinlock_acquire_irqsave(&current_proc->fd_table_lock);
+     sys_file_t *sf = get_sys_file_locked(current_proc, fd);
+     spinlock_release_irqrestore(&current_proc->fd_table_lock, irq_flags);
+
+     if (!sf) return -EBADF;
+     if (!((sf->flags & O_ACCMODE) == O_RDONLY || (sf->flags & O_ACCMODE) == O_RDWR)) {
+         return -EACCES;
+     }
+     return vfs_pread(sf->vfs_file, kbuf, count, pos);
+ }
+
+ /**
+  * @brief Writes to a descriptor at pos without moving its offset.
+  * @return Number of bytes written, or negative error code on failure.
+  */
+ ssize_t sys_pwrite(int fd, const void *kbuf, size_t count, off_t pos) {
+     if (kbuf == NULL && count != 0) return -EFAULT;
+     if (count == 0) return 0;
+
+     pcb_t *current_proc = get_current_process();
+     if (!current_proc) return -EFAULT;
+
+     uintptr_t irq_flags = spinlock_acquire_irqsave(&current_proc->fd_table_lock);
+     sys_file_t *sf = get_sys_file_locked(current_proc, fd);
+     spinlock_release_irqrestore(&current_proc->fd_table_lock, irq_flags);
+
+     if (!sf) return -EBADF;
+     if (!((sf->flags & O_ACCMODE) == O_WRONLY || (sf->flags & O_ACCMODE) == O_RDWR)) {
+         return -EACCES;
+     }
+     return vfs_pwrite(sf->vfs_file, kbuf, count, pos);
+ }
+
+ /**
+  * @brief Writes a descriptor's file to stable storage (fsync/fdatasync).
+  * @return 0 on success, negative POSIX errno on failure.
+  */
+ int sys_fsync(int fd, bool datasync) {
+     pcb_t *current_proc = get_current_process();
+     if (!current_proc) return -EFAULT;
+
+     uintptr_t irq_flags = spinlock_acquire_irqsave(&current_proc->fd_table_lock);
+     sys_file_t *sf = get_sys_file_locked(current_proc, fd);
+     spinlock_release_irqrestore(&current_proc->fd_table_lock, irq_flags);
+
+     if (!sf) return -EBADF;
+     return vfs_fsync(sf->vfs_file, datasync) == FS_SUCCESS ? 0 : -EIO;
+ }
+
+ /**
+  * @brief Writes the filesystem holding a descriptor's file to stable storage.
+  * @return 0 on success, negative POSIX errno on failure.
+  */
+ int sys_syncfs(int fd) {
+     pcb_t *current_proc = get_current_process();
+     if (!current_proc) return -EFAULT;
+
+     uintptr_t irq_flags = spinlock_acquire_irqsave(&current_proc->fd_table_lock);
+     sys_file_t *sf = get_sys_file_locked(current_proc, fd);
+     spinlock_release_irqrestore(&current_proc->fd_table_lock, irq_flags);
+
+     if (!sf) return -EBADF;
+     return vfs_syncfs(sf->vfs_file) == FS_SUCCESS ? 0 : -EIO;
+ }
+
+ /**
+  * @brief Sets the size of a descriptor's file (ftruncate).
+  * @return 0 on success, negative POSIX errno on failure.
+  */
+ int sys_ftruncate(int fd, off_t length) {
+     pcb_t *current_proc = get_current_process();
+     if (!current_proc) return -EFAULT;
+     if (length < 0) return -EINVAL;
+
+     uintptr_t irq_flags = spinlock_acquire_irqsave(&current_proc->fd_table_lock);
+     sys_file_t *sf = get_sys_file_locked(current_proc, fd);
+     spinlock_release_irqrestore(&current_proc->fd_table_lock, irq_flags);
+
+     if (!sf) return -EBADF;
+     if ((sf->flags & O_ACCMODE) == O_RDONLY) return -EINVAL;
+
+     switch (vfs_ftruncate(sf->vfs_file, length)) {
+         case FS_SUCCESS:           return 0;
+         case FS_ERR_NOT_SUPPORTED: return -EINVAL;
+         case FS_ERR_OUT_OF_MEMORY: return -ENOMEM;
+         case FS_ERR_OVERFLOW:      return -EFBIG;
+         case FS_ERR_NO_SPACE:      return -ENOSPC;
+         default:                   return -EIO;
+     }
+ }
+
  /**
   * @brief Implements the sys_close_impl logic.
   * Closes a file descriptor, releasing associated VFS resources.
@@ -37,6 +37,9 @@
  #include <libc/stdarg.h>   // varargs for printf (Assumed available)
  #include <kernel/lib/assert.h>        // KERNEL_ASSERT
  #include <kernel/drivers/display/serial.h>        // Serial logging for critical paths
+ #include <kernel/memory/file_map.h>      // file_map_invalidate on write
+ #include <kernel/process/exec_cache.h>    // exec_cache_invalidate on write
+ #include <kernel/drivers/storage/buffer_cache.h> // buffer_cache_sync fallback for fsync
 
  /* Define SEEK macros if not already defined (should be in sys_file.h ideally) */
  #ifndef SEEK_SET
@@ -503,6 +506,18 @@
      return vfs_mount_internal(mp, fs_type, dev);
  }
 
+ /**
+  * @brief Mounts a filesystem on an arbitrary absolute mount point.
+  *
+  * Used for pseudo-filesystems (e.g. the stats device) mounted beside the root.
+  */
+ int vfs_mount(const char *mp, const char *fs_type, const char *dev) {
+     if (!mp || !fs_type || !dev || mp[0] != '/') {
+         return -FS_ERR_INVALID_PARAM;
+     }
+     return vfs_mount_internal(mp, fs_type, dev);
+ }
+
  /**
   * @brief Unmounts the root filesystem.
   */
@@ -642,13 +657,23 @@
      file->flags = flags;
      file->offset = 0;
      spinlock_init(&file->lock); // <<< INITIALIZE LOCK >>>
+     file->refcount = 1;
 
      serial_write("[vfs_open] Success. file="); serial_print_hex((uintptr_t)file); /* ... */ serial_write("\n");
      return file;
  }
 
+ file_t *vfs_file_get(file_t *file) {
+     if (file) __atomic_fetch_add(&file->refcount, 1, __ATOMIC_RELAXED);
+     return file;
+ }
+
  int vfs_close(file_t *file) {
      if (!file) { VFS_ERROR("NULL file handle passed to vfs_close"); return -FS_ERR_INVALID_PARAM; }
+     // Other descriptors (or messages in flight) still use it
+     if (file->refcount > 1 && __atomic_sub_fetch(&file->refcount, 1, __ATOMIC_ACQ_REL) > 0) {
+         return FS_SUCCESS;
+     }
      if (!file->vnode) { VFS_ERROR("vfs_close: File handle %p has NULL vnode!", file); kfree(file); return -FS_ERR_BAD_F; }
      if (!file->vnode->fs_driver) { VFS_ERROR("vfs_close: Vnode %p has NULL fs_driver!", file->vnode); kfree(file->vnode); kfree(file); return -FS_ERR_BAD_F; }
 
@@ -744,6 +769,69 @@
 
     // === Release Lock ===
     spinlock_release_irqrestore(&file->lock, irq_flags);
+
+    // Frames and headers cached from the old contents must not be reused
+    if (bytes_written > 0) {
+        struct stat st;
+        if (vfs_fstat(file, &st) == FS_SUCCESS) {
+            file_map_invalidate(st.st_dev, st.st_ino);
+            exec_cache_invalidate(st.st_dev, st.st_ino);
+        }
+    }
+    return bytes_written;
+ }
+
+ /*
+  * Positional transfer: the driver works on file->offset, so it is moved to
+  * pos and put back under the file lock; other users of the file never see
+  * the temporary position.
+  */
+ static int vfs_transfer_at(file_t *file, void *buf, size_t len, off_t pos, bool write) {
+    vfs_driver_t *driver = file->vnode->fs_driver;
+    if (!driver->lseek) return FS_ERR_NOT_SUPPORTED;
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&file->lock);
+    off_t saved = file->offset;
+    int result;
+    off_t at = driver->lseek(file, pos, SEEK_SET);
+    if (at < 0) {
+        result = (int)at;
+    } else {
+        file->offset = at;
+        result = write ? driver->write(file, buf, len) : driver->read(file, buf, len);
+        driver->lseek(file, saved, SEEK_SET);
+        file->offset = saved;
+    }
+    spinlock_release_irqrestore(&file->lock, irq_flags);
+    return result;
+ }
+
+ int vfs_pread(file_t *file, void *buf, size_t len, off_t pos) {
+    if (!file || !file->vnode || !file->vnode->fs_driver) return FS_ERR_BAD_F;
+    if (!buf && len > 0) return FS_ERR_INVALID_PARAM;
+    if (pos < 0) return FS_ERR_INVALID_PARAM;
+    if (len == 0) return 0;
+    if (!file->vnode->fs_driver->read) return FS_ERR_NOT_SUPPORTED;
+    return vfs_transfer_at(file, buf, len, pos, false);
+ }
+
+ int vfs_pwrite(file_t *file, const void *buf, size_t len, off_t pos) {
+    if (!file || !file->vnode || !file->vnode->fs_driver) return FS_ERR_BAD_F;
+    if (!buf && len > 0) return FS_ERR_INVALID_PARAM;
+    if (pos < 0) return FS_ERR_INVALID_PARAM;
+    if (len == 0) return 0;
+    int access_mode = file->flags & O_ACCMODE;
+    if (access_mode != O_WRONLY && access_mode != O_RDWR) return FS_ERR_PERMISSION_DENIED;
+    if (!file->vnode->fs_driver->write) return FS_ERR_NOT_SUPPORTED;
+
+    int bytes_written = vfs_transfer_at(file, (void *)buf, len, pos, true);
+    if (bytes_written > 0) {
+        struct stat st;
+        if (vfs_fstat(file, &st) == FS_SUCCESS) {
+            file_map_invalidate(st.st_dev, st.st_ino);
+            exec_cache_invalidate(st.st_dev, st.st_ino);
+        }
+    }
     return bytes_written;
  }
 
@@ -774,6 +862,92 @@
     return new_offset; // Return result from driver
  }
 
+ /**
+  * @brief Returns identity, size and modification time of an open file.
+  * @return FS_SUCCESS, or FS_ERR_NOT_SUPPORTED if the driver has no fstat.
+  */
+ int vfs_fstat(file_t *file, struct stat *st) {
+    if (!file || !file->vnode || !file->vnode->fs_driver) return FS_ERR_BAD_F;
+    if (!st) return FS_ERR_INVALID_PARAM;
+    if (!file->vnode->fs_driver->fstat) return FS_ERR_NOT_SUPPORTED;
+
+    memset(st, 0, sizeof(*st));
+    return file->vnode->fs_driver->fstat(file, st);
+ }
+
+ /**
+  * @brief Makes an open file's data and metadata durable.
+  * @return FS_SUCCESS, or a negative error code.
+  */
+ int vfs_fsync(file_t *file, bool datasync) {
+    if (!file || !file->vnode || !file->vnode->fs_driver) return FS_ERR_BAD_F;
+    if (!file->vnode->fs_driver->fsync) {
+        buffer_cache_sync(); // No per-file writeback: everything, then every disk cache
+        return FS_SUCCESS;
+    }
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&file->lock);
+    int result = file->vnode->fs_driver->fsync(file, datasync);
+    spinlock_release_irqrestore(&file->lock, irq_flags);
+    return result;
+ }
+
+ /**
+  * @brief Syncs the filesystem holding an open file.
+  *
+  * A file does not record its mount, so every mount served by the file's
+  * driver is synced.
+  * @return FS_SUCCESS, or a negative error code from the first failing mount.
+  */
+ int vfs_syncfs(file_t *file) {
+    if (!file || !file->vnode || !file->vnode->fs_driver) return FS_ERR_BAD_F;
+    vfs_driver_t *driver = file->vnode->fs_driver;
+    if (!driver->syncfs) {
+        buffer_cache_sync();
+        return FS_SUCCESS;
+    }
+
+    int result = FS_SUCCESS;
+    for (mount_t *mnt = mount_table_get_head(); mnt; mnt = mnt->next) {
+        if (vfs_get_driver(mnt->fs_name) != driver) continue;
+        int ret = driver->syncfs(mnt->fs_context);
+        if (ret != FS_SUCCESS && result == FS_SUCCESS) result = ret;
+    }
+    return result;
+ }
+
+ /**
+  * @brief Sets the size of an open file.
+  * @return FS_SUCCESS, FS_ERR_NOT_SUPPORTED if the driver cannot resize files,
+  *         or a negative error code.
+  */
+ int vfs_ftruncate(file_t *file, off_t length) {
+    if (!file || !file->vnode || !file->vnode->fs_driver) return FS_ERR_BAD_F;
+    if (length < 0) return FS_ERR_INVALID_PARAM;
+    if (!file->vnode->fs_driver->ftruncate) return FS_ERR_NOT_SUPPORTED;
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&file->lock);
+    int result = file->vnode->fs_driver->ftruncate(file, length);
+    spinlock_release_irqrestore(&file->lock, irq_flags);
+    return result;
+ }
+
+ /**
+  * @brief Syncs every mounted filesystem.
+  */
+ void vfs_sync(void) {
+    bool need_global = false;
+    for (mount_t *mnt = mount_table_get_head(); mnt; mnt = mnt->next) {
+        vfs_driver_t *driver = vfs_get_driver(mnt->fs_name);
+        if (driver && driver->syncfs) {
+            driver->syncfs(mnt->fs_context);
+        } else {
+            need_global = true;
+        }
+    }
+    if (need_global) buffer_cache_sync();
+ }
+
  /**
   * @brief Reads a directory entry via the appropriate driver.
   * @param dir_file Open file handle representing the directory.
@@ -802,6 +976,50 @@
      // release_lock(&dir_file->lock);
      return result;
  }
+
+ /**
+  * @brief Emits as many directory entries as the caller accepts, starting at
+  * the directory's current position cookie (dir_file->offset).
+  *
+  * Drivers with a native getdents seek straight to the cookie. Otherwise the
+  * cookie is treated as a logical entry index and readdir is called per entry.
+  *
+  * @param dir_file Open file handle representing the directory.
+  * @param filldir Emitter invoked per entry; non-zero return stops iteration.
+  * @param ctx Opaque pointer passed through to filldir.
+  * @return Number of entries emitted (0 at end of directory), negative error otherwise.
+  */
+ int vfs_getdents(file_t *dir_file, vfs_filldir_t filldir, void *ctx) {
+     if (!dir_file || !filldir) return FS_ERR_INVALID_PARAM;
+     if (!dir_file->vnode || !dir_file->vnode->fs_driver) return FS_ERR_BAD_F;
+
+     vfs_driver_t *driver = dir_file->vnode->fs_driver;
+     if (!driver->getdents && !driver->readdir) return FS_ERR_NOT_SUPPORTED;
+
+     uintptr_t irq_flags = spinlock_acquire_irqsave(&dir_file->lock);
+
+     int result;
+     if (driver->getdents) {
+         result = driver->getdents(dir_file, filldir, ctx);
+     } else {
+         struct dirent entry;
+         result = 0;
+         while (true) {
+             int rd = driver->readdir(dir_file, &entry, (size_t)dir_file->offset);
+             if (rd == FS_ERR_NOT_FOUND || rd == FS_ERR_EOF) break;
+             if (rd != FS_SUCCESS) { if (result == 0) result = rd; break; }
+             if (filldir(ctx, entry.d_name, strlen(entry.d_name), entry.d_ino,
+                         entry.d_type, dir_file->offset + 1) != 0) break;
+             dir_file->offset++;
+             result++;
+         }
+     }
+
+     spinlock_release_irqrestore(&dir_file->lock, irq_flags);
+
+     if (result < 0) { VFS_ERROR("vfs_getdents: Driver '%s' failed (err %d)", driver->fs_name, result); }
+     return result;
+ }
  
  /**
   * @brief Deletes a name (file or potentially empty directory) from the filesystem.
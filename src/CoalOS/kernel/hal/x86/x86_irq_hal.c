@@ -0,0 +1,496 @@
+/**
+ * @file x86_irq_hal.c
+ * @brief x86 IRQ HAL Implementation (local/I/O APIC with 8259 PIC fallback)
+ * @version 1.0
+ *
+ * @details With an APIC, the 8259s are masked off and every ISA line is
+ * routed through the I/O APIC redirection table (honouring MADT source
+ * overrides) to vector 32 + irq, so existing IDT handlers keep working.
+ * EOI becomes a single LAPIC MMIO write instead of one or two port writes,
+ * redirection entries can target any CPU, and spare vectors back MSI.
+ * Without an APIC the same interface drives the PICs.
+ */
+
+//============================================================================
+// Includes
+//============================================================================
+#include <kernel/hal/irq_hal.h>
+#include <kernel/cpu/apic.h>
+#include <kernel/cpu/idt.h>
+#include <kernel/cpu/isr_frame.h>
+#include <kernel/lib/port_io.h>
+#include <kernel/sync/spinlock.h>
+#include <kernel/drivers/display/serial.h>
+
+//============================================================================
+// State
+//============================================================================
+
+typedef struct {
+    irq_handler_t handler;
+    void *context;
+} irq_slot_t;
+
+static irq_controller_type_t g_controller = IRQ_CONTROLLER_PIC_8259;
+static irq_slot_t g_irq_slots[IRQ_HAL_MAX_IRQS];
+static uint32_t g_irq_affinity[IRQ_HAL_MAX_IRQS];
+static uint32_t g_irq_enabled;       // Bit per IRQ, mirrors the hardware masks
+static uint8_t g_msi_used;           // Bit per MSI IRQ
+static spinlock_t g_irq_hal_lock = {0};
+
+static const irq_controller_info_t g_pic_info = {
+    .type = IRQ_CONTROLLER_PIC_8259,
+    .name = "Intel 8259A PIC (cascaded)",
+    .max_irqs = IRQ_MAX_STANDARD,
+    .priority_levels = 0,
+    .supports_nmi = false,
+    .supports_priority = false,
+    .supports_affinity = false,
+};
+
+static const irq_controller_info_t g_apic_info = {
+    .type = IRQ_CONTROLLER_APIC,
+    .name = "Local APIC + I/O APIC",
+    .max_irqs = IRQ_HAL_MAX_IRQS,
+    .priority_levels = 16,          // Vector >> 4
+    .supports_nmi = true,
+    .supports_priority = false,     // Fixed by vector number
+    .supports_affinity = true,
+};
+
+static inline bool apic_mode(void) {
+    return g_controller == IRQ_CONTROLLER_APIC;
+}
+
+// GSI for an IRQ that arrives through the I/O APIC; false for MSI IRQs
+static bool irq_to_gsi(uint8_t irq, uint32_t *gsi) {
+    if (irq < IRQ_MAX_STANDARD) {
+        *gsi = apic_isa_route(irq)->gsi;
+        return true;
+    }
+    if (irq < IRQ_MSI_FIRST) {
+        *gsi = irq;
+        return true;
+    }
+    return false;
+}
+
+static uint8_t first_cpu_apic_id(uint32_t cpu_mask) {
+    for (uint32_t cpu = 0; cpu < 32; cpu++) {
+        if (cpu_mask & (1u << cpu)) return apic_cpu_to_lapic_id(cpu);
+    }
+    return 0xFF;
+}
+
+//============================================================================
+// 8259 PIC helpers
+//============================================================================
+
+static void pic_set_masks(uint16_t mask) {
+    outb(PIC1_DATA, (uint8_t)mask);
+    outb(PIC2_DATA, (uint8_t)(mask >> 8));
+}
+
+static uint16_t pic_get_masks(void) {
+    return (uint16_t)(inb(PIC1_DATA) | (inb(PIC2_DATA) << 8));
+}
+
+//============================================================================
+// Operations
+//============================================================================
+
+static error_t x86_irq_init(void)
+{
+    // Whatever idt_init() unmasked on the PIC stays enabled after the switch
+    g_irq_enabled = (uint16_t)~pic_get_masks() & ~(1u << IRQ_CASCADE);
+
+    if (!apic_available()) {
+        serial_write("[IRQ HAL] No APIC; using the 8259 PIC\n");
+        return E_SUCCESS;
+    }
+
+    pic_set_masks(0xFFFF);
+    lapic_enable();
+    uint8_t bsp = lapic_id();
+
+    for (uint8_t irq = 0; irq < IRQ_MAX_STANDARD; irq++) {
+        if (irq == IRQ_CASCADE) continue;
+        const apic_isa_route_t *route = apic_isa_route(irq);
+        ioapic_set_entry(route->gsi, (uint8_t)(IRQ0_VECTOR + irq), bsp,
+                         route->level, route->active_low,
+                         !(g_irq_enabled & (1u << irq)));
+        g_irq_affinity[irq] = 1;
+    }
+    // PCI INTx pins: level-triggered, active low, masked until claimed
+    for (uint8_t irq = IRQ_MAX_STANDARD; irq < IRQ_MSI_FIRST; irq++) {
+        ioapic_set_entry(irq, (uint8_t)(IRQ0_VECTOR + irq), bsp, true, true, true);
+        g_irq_affinity[irq] = 1;
+    }
+
+    g_controller = IRQ_CONTROLLER_APIC;
+    serial_printf("[IRQ HAL] I/O APIC routing active (BSP LAPIC id %u)\n", bsp);
+    return E_SUCCESS;
+}
+
+static void x86_irq_shutdown(void)
+{
+    if (apic_mode()) {
+        for (uint8_t irq = 0; irq < IRQ_MSI_FIRST; irq++) {
+            uint32_t gsi;
+            if (irq_to_gsi(irq, &gsi)) ioapic_set_masked(gsi, true);
+        }
+    } else {
+        pic_set_masks(0xFFFF);
+    }
+}
+
+static error_t x86_irq_enable(uint8_t irq)
+{
+    if (irq >= IRQ_HAL_MAX_IRQS) return E_INVAL;
+
+    uintptr_t flags = spinlock_acquire_irqsave(&g_irq_hal_lock);
+    error_t err = E_SUCCESS;
+    if (apic_mode()) {
+        uint32_t gsi;
+        if (irq_to_gsi(irq, &gsi)) err = ioapic_set_masked(gsi, false);
+    } else if (irq < IRQ_MAX_STANDARD) {
+        pic_set_masks(pic_get_masks() & ~(1u << irq));
+    } else {
+        err = E_NOTSUP;
+    }
+    if (err == E_SUCCESS) g_irq_enabled |= 1u << irq;
+    spinlock_release_irqrestore(&g_irq_hal_lock, flags);
+    return err;
+}
+
+static error_t x86_irq_disable(uint8_t irq)
+{
+    if (irq >= IRQ_HAL_MAX_IRQS) return E_INVAL;
+
+    uintptr_t flags = spinlock_acquire_irqsave(&g_irq_hal_lock);
+    error_t err = E_SUCCESS;
+    if (apic_mode()) {
+        uint32_t gsi;
+        if (irq_to_gsi(irq, &gsi)) err = ioapic_set_masked(gsi, true);
+    } else if (irq < IRQ_MAX_STANDARD) {
+        pic_set_masks(pic_get_masks() | (1u << irq));
+    }
+    g_irq_enabled &= ~(1u << irq);
+    spinlock_release_irqrestore(&g_irq_hal_lock, flags);
+    return err;
+}
+
+static bool x86_irq_is_enabled(uint8_t irq)
+{
+    return irq < IRQ_HAL_MAX_IRQS && (g_irq_enabled & (1u << irq));
+}
+
+static error_t x86_irq_configure(uint8_t irq, const irq_config_t *config)
+{
+    if (irq >= IRQ_HAL_MAX_IRQS || !config) return E_INVAL;
+
+    if (apic_mode()) {
+        uint32_t gsi;
+        if (irq_to_gsi(irq, &gsi)) {
+            error_t err = ioapic_set_entry(gsi, (uint8_t)(IRQ0_VECTOR + irq),
+                                           first_cpu_apic_id(g_irq_affinity[irq]),
+                                           config->trigger_mode == IRQ_TRIGGER_LEVEL,
+                                           config->polarity == IRQ_POLARITY_ACTIVE_LOW,
+                                           !config->enabled);
+            if (err != E_SUCCESS) return err;
+            if (config->enabled) g_irq_enabled |= 1u << irq;
+            else g_irq_enabled &= ~(1u << irq);
+            return E_SUCCESS;
+        }
+    }
+    // The PIC's trigger mode is fixed (edge, ELCR aside)
+    return config->enabled ? x86_irq_enable(irq) : x86_irq_disable(irq);
+}
+
+static void x86_irq_send_eoi(uint8_t irq)
+{
+    irq_hal_eoi(irq);
+}
+
+/**
+ * IDT-level handler for IRQs registered through the HAL: looks up the
+ * handler by vector, then acknowledges. Handlers registered directly with
+ * register_int_handler() still send their own EOI.
+ */
+static void irq_hal_dispatch(isr_frame_t *frame)
+{
+    uint8_t irq = (uint8_t)(frame->int_no - IRQ0_VECTOR);
+    irq_slot_t *slot = &g_irq_slots[irq];
+    if (slot->handler) {
+        slot->handler(irq, frame, slot->context);
+    }
+    irq_hal_eoi(irq);
+}
+
+static error_t x86_irq_register_handler(uint8_t irq, irq_handler_t handler, void *context)
+{
+    if (irq >= IRQ_HAL_MAX_IRQS || !handler) return E_INVAL;
+
+    uintptr_t flags = spinlock_acquire_irqsave(&g_irq_hal_lock);
+    g_irq_slots[irq].handler = handler;
+    g_irq_slots[irq].context = context;
+    spinlock_release_irqrestore(&g_irq_hal_lock, flags);
+
+    register_int_handler(IRQ0_VECTOR + irq, irq_hal_dispatch, NULL);
+    return E_SUCCESS;
+}
+
+static error_t x86_irq_unregister_handler(uint8_t irq)
+{
+    if (irq >= IRQ_HAL_MAX_IRQS) return E_INVAL;
+
+    x86_irq_disable(irq);
+    uintptr_t flags = spinlock_acquire_irqsave(&g_irq_hal_lock);
+    g_irq_slots[irq].handler = NULL;
+    g_irq_slots[irq].context = NULL;
+    spinlock_release_irqrestore(&g_irq_hal_lock, flags);
+    return E_SUCCESS;
+}
+
+static void x86_irq_mask_all(void)
+{
+    for (uint8_t irq = 0; irq < IRQ_HAL_MAX_IRQS; irq++) {
+        if (g_irq_enabled & (1u << irq)) x86_irq_disable(irq);
+    }
+}
+
+static uint32_t x86_irq_get_mask(void)
+{
+    return ~g_irq_enabled;  // Set bit = masked, as on the PIC
+}
+
+static void x86_irq_set_mask(uint32_t mask)
+{
+    for (uint8_t irq = 0; irq < IRQ_HAL_MAX_IRQS; irq++) {
+        if (irq == IRQ_CASCADE) continue;
+        if (mask & (1u << irq)) x86_irq_disable(irq);
+        else x86_irq_enable(irq);
+    }
+}
+
+static void x86_irq_unmask_all(void)
+{
+    x86_irq_set_mask(0);
+}
+
+static error_t x86_irq_set_priority(uint8_t irq, uint8_t priority)
+{
+    // Priority is the vector's upper nibble on the APIC and fixed on the PIC
+    (void)irq; (void)priority;
+    return E_NOTSUP;
+}
+
+static uint8_t x86_irq_get_priority(uint8_t irq)
+{
+    return (uint8_t)((IRQ0_VECTOR + irq) >> 4);
+}
+
+static bool x86_irq_is_pending(uint8_t irq)
+{
+    if (apic_mode() || irq >= IRQ_MAX_STANDARD) return false;
+    // OCW3: read IRR
+    if (irq < 8) {
+        outb(PIC1_COMMAND, 0x0A);
+        return (inb(PIC1_COMMAND) >> irq) & 1;
+    }
+    outb(PIC2_COMMAND, 0x0A);
+    return (inb(PIC2_COMMAND) >> (irq - 8)) & 1;
+}
+
+static uint8_t x86_irq_get_current(void)
+{
+    return 0xFF;    // Not tracked; handlers receive their IRQ number
+}
+
+static const irq_controller_info_t *x86_irq_get_info(void)
+{
+    return apic_mode() ? &g_apic_info : &g_pic_info;
+}
+
+static error_t x86_irq_set_affinity(uint8_t irq, uint32_t cpu_mask)
+{
+    if (irq >= IRQ_HAL_MAX_IRQS || cpu_mask == 0) return E_INVAL;
+    if (!apic_mode()) return E_NOTSUP;
+
+    uint8_t dest = first_cpu_apic_id(cpu_mask);
+    if (dest == 0xFF) return E_INVAL;
+
+    uint32_t gsi;
+    if (irq_to_gsi(irq, &gsi)) {
+        error_t err = ioapic_set_destination(gsi, dest);
+        if (err != E_SUCCESS) return err;
+    }
+    // MSI: the new mask applies when the device's message is recomposed
+    g_irq_affinity[irq] = cpu_mask;
+    return E_SUCCESS;
+}
+
+static uint32_t x86_irq_get_affinity(uint8_t irq)
+{
+    return irq < IRQ_HAL_MAX_IRQS ? g_irq_affinity[irq] : 0;
+}
+
+static error_t x86_irq_trigger_software(uint8_t irq, uint32_t cpu_mask)
+{
+    if (irq >= IRQ_HAL_MAX_IRQS) return E_INVAL;
+    if (!apic_mode()) return E_NOTSUP;
+
+    for (uint32_t cpu = 0; cpu < apic_cpu_count() && cpu < 32; cpu++) {
+        if (cpu_mask & (1u << cpu)) {
+            lapic_send_ipi(apic_cpu_to_lapic_id(cpu), (uint8_t)(IRQ0_VECTOR + irq));
+        }
+    }
+    return E_SUCCESS;
+}
+
+static void x86_irq_suspend(void)
+{
+    x86_irq_shutdown();
+}
+
+static void x86_irq_resume(void)
+{
+    x86_irq_set_mask(~g_irq_enabled);
+}
+
+//============================================================================
+// Operations Table
+//============================================================================
+
+static const irq_hal_ops_t x86_irq_ops = {
+    .init = x86_irq_init,
+    .shutdown = x86_irq_shutdown,
+
+    .configure_irq = x86_irq_configure,
+    .enable_irq = x86_irq_enable,
+    .disable_irq = x86_irq_disable,
+    .is_irq_enabled = x86_irq_is_enabled,
+
+    .register_handler = x86_irq_register_handler,
+    .unregister_handler = x86_irq_unregister_handler,
+
+    .send_eoi = x86_irq_send_eoi,
+    .mask_all_irqs = x86_irq_mask_all,
+    .unmask_all_irqs = x86_irq_unmask_all,
+    .get_irq_mask = x86_irq_get_mask,
+    .set_irq_mask = x86_irq_set_mask,
+
+    .set_irq_priority = x86_irq_set_priority,
+    .get_irq_priority = x86_irq_get_priority,
+
+    .is_irq_pending = x86_irq_is_pending,
+    .get_current_irq = x86_irq_get_current,
+    .get_info = x86_irq_get_info,
+
+    .set_irq_affinity = x86_irq_set_affinity,
+    .get_irq_affinity = x86_irq_get_affinity,
+    .trigger_software_irq = x86_irq_trigger_software,
+
+    .suspend = x86_irq_suspend,
+    .resume = x86_irq_resume
+};
+
+//============================================================================
+// Global Interface
+//============================================================================
+
+const irq_hal_ops_t *irq_hal_get_ops(void)
+{
+    return &x86_irq_ops;
+}
+
+error_t irq_hal_init(void)
+{
+    return x86_irq_init();
+}
+
+void irq_hal_shutdown(void)
+{
+    x86_irq_shutdown();
+}
+
+irq_controller_type_t irq_hal_controller(void)
+{
+    return g_controller;
+}
+
+error_t irq_hal_enable(uint8_t irq)
+{
+    return x86_irq_enable(irq);
+}
+
+error_t irq_hal_disable(uint8_t irq)
+{
+    return x86_irq_disable(irq);
+}
+
+error_t irq_hal_register(uint8_t irq, irq_handler_t handler, void *context)
+{
+    error_t err = x86_irq_register_handler(irq, handler, context);
+    return err == E_SUCCESS ? x86_irq_enable(irq) : err;
+}
+
+error_t irq_hal_unregister(uint8_t irq)
+{
+    return x86_irq_unregister_handler(irq);
+}
+
+void irq_hal_eoi(uint8_t irq)
+{
+    if (apic_mode()) {
+        lapic_eoi();
+        return;
+    }
+    if (irq >= 8) {
+        outb(PIC2_COMMAND, PIC_EOI);
+    }
+    outb(PIC1_COMMAND, PIC_EOI);
+}
+
+error_t irq_hal_alloc_msi(uint32_t cpu, uint8_t *irq, uint32_t *address, uint32_t *data)
+{
+    if (!irq || !address || !data) return E_INVAL;
+    if (!apic_mode()) return E_NOTSUP;
+
+    uint8_t dest = apic_cpu_to_lapic_id(cpu);
+    if (dest == 0xFF) return E_INVAL;
+
+    uintptr_t flags = spinlock_acquire_irqsave(&g_irq_hal_lock);
+    uint32_t slot = 0;
+    while (slot < IRQ_MSI_COUNT && (g_msi_used & (1u << slot))) slot++;
+    if (slot == IRQ_MSI_COUNT) {
+        spinlock_release_irqrestore(&g_irq_hal_lock, flags);
+        return E_NOSPC;
+    }
+    g_msi_used |= (uint8_t)(1u << slot);
+    spinlock_release_irqrestore(&g_irq_hal_lock, flags);
+
+    *irq = (uint8_t)(IRQ_MSI_FIRST + slot);
+    *address = MSI_ADDRESS_BASE | MSI_ADDRESS_DEST(dest);
+    *data = IRQ0_VECTOR + *irq;     // Fixed delivery, edge-triggered
+    g_irq_affinity[*irq] = 1u << cpu;
+    g_irq_enabled |= 1u << *irq;
+    return E_SUCCESS;
+}
+
+void irq_hal_free_msi(uint8_t irq)
+{
+    if (irq < IRQ_MSI_FIRST || irq >= IRQ_MSI_FIRST + IRQ_MSI_COUNT) return;
+
+    x86_irq_unregister_handler(irq);
+    uintptr_t flags = spinlock_acquire_irqsave(&g_irq_hal_lock);
+    g_msi_used &= (uint8_t)~(1u << (irq - IRQ_MSI_FIRST));
+    spinlock_release_irqrestore(&g_irq_hal_lock, flags);
+}
+
+#ifdef __i386__
+error_t x86_32_irq_hal_init(void)
+{
+    return irq_hal_init();
+}
+#endif
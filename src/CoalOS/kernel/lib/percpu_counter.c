@@ -0,0 +1,143 @@
+/**
+ * @file percpu_counter.c
+ * @brief Per-CPU statistics counters and the counter registry
+ * @author Coal OS Kernel Team
+ * @version 1.0
+ *
+ * @details Counters are updated on the local CPU's slot with interrupts
+ * disabled; only folds and exact reads take the per-counter lock. The
+ * registry is a singly linked list protected by its own lock and walked
+ * by the stats device.
+ */
+
+//============================================================================
+// Includes
+//============================================================================
+#include <kernel/lib/percpu_counter.h>
+#include <kernel/lib/string.h>
+#include <kernel/lib/assert.h>
+#include <libc/stddef.h>
+
+//============================================================================
+// Module Static Data
+//============================================================================
+
+static percpu_counter_t *g_counter_list = NULL;
+static spinlock_t g_registry_lock = { 0 };
+
+//============================================================================
+// Lifecycle and Registry
+//============================================================================
+
+void percpu_counter_init(percpu_counter_t *counter, const char *name, int64_t initial)
+{
+    KERNEL_ASSERT(counter != NULL && name != NULL, "percpu_counter_init: NULL argument");
+    KERNEL_ASSERT(strlen(name) < PERCPU_COUNTER_NAME_MAX, "percpu_counter_init: name too long");
+
+    // Re-initializing a live counter (e.g. subsystem re-init) only resets it
+    if (counter->registered) {
+        percpu_counter_set(counter, initial);
+        return;
+    }
+
+    memset(counter, 0, sizeof(*counter));
+    spinlock_init(&counter->lock);
+    counter->count = initial;
+    counter->name = name;
+
+    uintptr_t flags = spinlock_acquire_irqsave(&g_registry_lock);
+    counter->next = g_counter_list;
+    g_counter_list = counter;
+    counter->registered = true;
+    spinlock_release_irqrestore(&g_registry_lock, flags);
+}
+
+void percpu_counter_destroy(percpu_counter_t *counter)
+{
+    if (!counter || !counter->registered) {
+        return;
+    }
+
+    uintptr_t flags = spinlock_acquire_irqsave(&g_registry_lock);
+    percpu_counter_t **link = &g_counter_list;
+    while (*link) {
+        if (*link == counter) {
+            *link = counter->next;
+            break;
+        }
+        link = &(*link)->next;
+    }
+    counter->next = NULL;
+    counter->registered = false;
+    spinlock_release_irqrestore(&g_registry_lock, flags);
+}
+
+percpu_counter_t *percpu_counter_find(const char *name)
+{
+    if (!name) {
+        return NULL;
+    }
+
+    uintptr_t flags = spinlock_acquire_irqsave(&g_registry_lock);
+    percpu_counter_t *c = g_counter_list;
+    while (c && strcmp(c->name, name) != 0) {
+        c = c->next;
+    }
+    spinlock_release_irqrestore(&g_registry_lock, flags);
+    return c;
+}
+
+int percpu_counter_for_each(percpu_counter_visit_t visit, void *ctx)
+{
+    if (!visit) {
+        return 0;
+    }
+
+    int visited = 0;
+    uintptr_t flags = spinlock_acquire_irqsave(&g_registry_lock);
+    for (percpu_counter_t *c = g_counter_list; c; c = c->next) {
+        visited++;
+        if (visit(c->name, percpu_counter_sum(c), ctx) != 0) {
+            break;
+        }
+    }
+    spinlock_release_irqrestore(&g_registry_lock, flags);
+    return visited;
+}
+
+//============================================================================
+// Update and Read
+//============================================================================
+
+/**
+ * Called with local interrupts disabled by percpu_counter_add(), so the slot
+ * cannot change underneath us on this CPU.
+ */
+void percpu_counter_fold(percpu_counter_t *counter, int cpu)
+{
+    uintptr_t flags = spinlock_acquire_irqsave(&counter->lock);
+    counter->count += counter->slots[cpu].value;
+    counter->slots[cpu].value = 0;
+    spinlock_release_irqrestore(&counter->lock, flags);
+}
+
+int64_t percpu_counter_sum(percpu_counter_t *counter)
+{
+    uintptr_t flags = spinlock_acquire_irqsave(&counter->lock);
+    int64_t sum = counter->count;
+    for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+        sum += counter->slots[cpu].value;
+    }
+    spinlock_release_irqrestore(&counter->lock, flags);
+    return sum;
+}
+
+void percpu_counter_set(percpu_counter_t *counter, int64_t value)
+{
+    uintptr_t flags = spinlock_acquire_irqsave(&counter->lock);
+    for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+        counter->slots[cpu].value = 0;
+    }
+    counter->count = value;
+    spinlock_release_irqrestore(&counter->lock, flags);
+}
@@ -0,0 +1,321 @@
+/**
+ * @file tunables.c
+ * @brief Kernel parameter registry and boot command line parsing
+ * @author Coal OS Kernel Team
+ * @version 1.0
+ *
+ * @details The command line is copied into static storage while the
+ * multiboot information is still mapped, before any allocator exists, so
+ * subsystems that register during early boot (kmalloc, the scheduler) see
+ * their parameters. The registry is a singly linked list in registration
+ * order, protected by one lock and walked by /proc/sys.
+ */
+
+//============================================================================
+// Includes
+//============================================================================
+#include <kernel/lib/tunables.h>
+#include <kernel/lib/string.h>
+#include <kernel/sync/spinlock.h>
+#include <kernel/fs/vfs/fs_errno.h>
+#include <kernel/drivers/display/serial.h>
+#include <libc/stddef.h>
+
+//============================================================================
+// Module Static Data
+//============================================================================
+
+static char g_cmdline[TUNABLES_CMDLINE_MAX];
+static tunable_t *g_tunable_list = NULL;
+static spinlock_t g_tunables_lock = { 0 };
+
+//============================================================================
+// Parsing Helpers
+//============================================================================
+
+static bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool text_equals(const char *text, size_t len, const char *word)
+{
+    size_t wlen = strlen(word);
+    return len == wlen && strncmp(text, word, len) == 0;
+}
+
+/**
+ * @brief Parses len bytes of text as t's type
+ * @return 0 and *out on success, -EINVAL otherwise
+ */
+static int parse_value(const tunable_t *t, const char *text, size_t len, uint32_t *out)
+{
+    while (len > 0 && is_space(*text)) {
+        text++;
+        len--;
+    }
+    while (len > 0 && is_space(text[len - 1])) {
+        len--;
+    }
+    if (len == 0) {
+        return -EINVAL;
+    }
+
+    if (t->type == TUNABLE_BOOL) {
+        if (text_equals(text, len, "1") || text_equals(text, len, "y") ||
+            text_equals(text, len, "on") || text_equals(text, len, "true")) {
+            *out = 1;
+            return 0;
+        }
+        if (text_equals(text, len, "0") || text_equals(text, len, "n") ||
+            text_equals(text, len, "off") || text_equals(text, len, "false")) {
+            *out = 0;
+            return 0;
+        }
+        return -EINVAL;
+    }
+
+    uint32_t base = 10;
+    if (len > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        base = 16;
+        text += 2;
+        len -= 2;
+    }
+
+    uint32_t value = 0;
+    for (size_t i = 0; i < len; i++) {
+        char c = text[i];
+        uint32_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = (uint32_t)(c - '0');
+        } else if (base == 16 && c >= 'a' && c <= 'f') {
+            digit = (uint32_t)(c - 'a' + 10);
+        } else if (base == 16 && c >= 'A' && c <= 'F') {
+            digit = (uint32_t)(c - 'A' + 10);
+        } else {
+            return -EINVAL;
+        }
+        if (value > (UINT32_MAX - digit) / base) {
+            return -EINVAL; // Overflow
+        }
+        value = value * base + digit;
+    }
+    *out = value;
+    return 0;
+}
+
+/**
+ * @brief Range and validate() checks shared by boot and runtime writes
+ */
+static int check_value(const tunable_t *t, uint32_t value)
+{
+    if (t->type == TUNABLE_BOOL) {
+        if (value > 1) {
+            return -EINVAL;
+        }
+    } else if (value < t->min || value > t->max) {
+        return -EINVAL;
+    }
+    return t->validate ? t->validate(t, value) : 0;
+}
+
+/**
+ * @brief Accepts "<group>.<name>" with both parts non-empty, [a-z0-9_] only
+ */
+static bool name_is_valid(const char *name)
+{
+    size_t len = strlen(name);
+    if (len == 0 || len >= TUNABLE_NAME_MAX) {
+        return false;
+    }
+
+    int dots = 0;
+    for (size_t i = 0; i < len; i++) {
+        char c = name[i];
+        if (c == '.') {
+            if (i == 0 || i == len - 1) {
+                return false;
+            }
+            dots++;
+        } else if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_')) {
+            return false;
+        }
+    }
+    return dots == 1;
+}
+
+/**
+ * @brief Finds the last "name=value" word on the command line
+ * @return true and the value text if the name was given
+ */
+static bool cmdline_lookup(const char *name, const char **value, size_t *value_len)
+{
+    size_t name_len = strlen(name);
+    bool found = false;
+
+    const char *p = g_cmdline;
+    while (*p) {
+        while (*p && is_space(*p)) {
+            p++;
+        }
+        const char *word = p;
+        while (*p && !is_space(*p)) {
+            p++;
+        }
+        size_t word_len = (size_t)(p - word);
+
+        // Later words override earlier ones
+        if (word_len > name_len && word[name_len] == '=' &&
+            strncmp(word, name, name_len) == 0) {
+            *value = word + name_len + 1;
+            *value_len = word_len - name_len - 1;
+            found = true;
+        }
+    }
+    return found;
+}
+
+//============================================================================
+// Command Line
+//============================================================================
+
+void tunables_set_cmdline(const char *cmdline)
+{
+    if (!cmdline) {
+        g_cmdline[0] = '\0';
+        return;
+    }
+    strncpy(g_cmdline, cmdline, sizeof(g_cmdline) - 1);
+    g_cmdline[sizeof(g_cmdline) - 1] = '\0';
+}
+
+const char *tunables_get_cmdline(void)
+{
+    return g_cmdline;
+}
+
+//============================================================================
+// Registry
+//============================================================================
+
+int tunable_register(tunable_t *t)
+{
+    if (!t || !t->name || !t->value || !name_is_valid(t->name)) {
+        serial_printf("[Tunables] Rejected tunable '%s': bad name\n",
+                      (t && t->name) ? t->name : "(null)");
+        return -EINVAL;
+    }
+    if (t->registered) {
+        return 0;
+    }
+    if (check_value(t, *t->value) != 0) {
+        serial_printf("[Tunables] Rejected tunable '%s': default out of range\n", t->name);
+        return -EINVAL;
+    }
+
+    // Owners have not started using the value yet, so no changed() call
+    const char *text;
+    size_t text_len;
+    if (cmdline_lookup(t->name, &text, &text_len)) {
+        uint32_t value;
+        int err = parse_value(t, text, text_len, &value);
+        if (err == 0) {
+            err = check_value(t, value);
+        }
+        if (err == 0) {
+            *t->value = value;
+            serial_printf("[Tunables] %s=%lu (command line)\n", t->name, (unsigned long)value);
+        } else {
+            serial_printf("[Tunables] Ignoring invalid %s on command line, keeping %lu\n",
+                          t->name, (unsigned long)*t->value);
+        }
+    }
+
+    t->next = NULL;
+    uintptr_t flags = spinlock_acquire_irqsave(&g_tunables_lock);
+    tunable_t **link = &g_tunable_list;
+    while (*link) {
+        link = &(*link)->next;
+    }
+    *link = t;
+    t->registered = true;
+    spinlock_release_irqrestore(&g_tunables_lock, flags);
+    return 0;
+}
+
+tunable_t *tunable_find(const char *name)
+{
+    if (!name) {
+        return NULL;
+    }
+
+    tunable_t *found = NULL;
+    uintptr_t flags = spinlock_acquire_irqsave(&g_tunables_lock);
+    for (tunable_t *t = g_tunable_list; t; t = t->next) {
+        if (strcmp(t->name, name) == 0) {
+            found = t;
+            break;
+        }
+    }
+    spinlock_release_irqrestore(&g_tunables_lock, flags);
+    return found;
+}
+
+int tunable_set(tunable_t *t, uint32_t value)
+{
+    if (!t || !t->registered) {
+        return -EINVAL;
+    }
+    if (t->flags & TUNABLE_BOOT_ONLY) {
+        return -EPERM;
+    }
+
+    int err = check_value(t, value);
+    if (err != 0) {
+        return err;
+    }
+
+    uintptr_t flags = spinlock_acquire_irqsave(&g_tunables_lock);
+    uint32_t old_value = *t->value;
+    *t->value = value;
+    spinlock_release_irqrestore(&g_tunables_lock, flags);
+
+    if (old_value != value && t->changed) {
+        t->changed(t, old_value);
+    }
+    return 0;
+}
+
+int tunable_set_string(tunable_t *t, const char *text, size_t len)
+{
+    if (!t || !text) {
+        return -EINVAL;
+    }
+
+    uint32_t value;
+    int err = parse_value(t, text, len, &value);
+    if (err != 0) {
+        return err;
+    }
+    return tunable_set(t, value);
+}
+
+uint32_t tunable_get(const tunable_t *t)
+{
+    return *(volatile const uint32_t *)t->value;
+}
+
+void tunables_for_each(tunable_visit_t visit, void *ctx)
+{
+    if (!visit) {
+        return;
+    }
+
+    uintptr_t flags = spinlock_acquire_irqsave(&g_tunables_lock);
+    for (tunable_t *t = g_tunable_list; t; t = t->next) {
+        if (visit(t, ctx)) {
+            break;
+        }
+    }
+    spinlock_release_irqrestore(&g_tunables_lock, flags);
+}
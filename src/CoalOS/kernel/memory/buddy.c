@@ -1237,6 +1237,19 @@ void buddy_get_stats(buddy_stats_t *stats) {
     spinlock_release_irqrestore(&g_buddy_lock, irq_flags);
 }
 
+void buddy_get_free_blocks(uint32_t counts[MAX_ORDER + 1]) {
+    if (!counts) return;
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&g_buddy_lock);
+    for (int order = 0; order <= MAX_ORDER; order++) {
+        uint32_t n = 0;
+        for (buddy_block_t *block = free_lists[order]; block; block = block->next) {
+            n++;
+        }
+        counts[order] = n;
+    }
+    spinlock_release_irqrestore(&g_buddy_lock, irq_flags);
+}
+
 //============================================================================
 // New Standardized Error Handling API Implementation
 //============================================================================
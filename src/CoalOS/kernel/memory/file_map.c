@@ -0,0 +1,268 @@
+/**
+ * @file file_map.c
+ * @brief File-backed private mappings with shared read-only frames
+ *
+ * The cache owns one reference on every frame it holds; each PTE that maps
+ * a shared frame owns another. Dropping a cache object therefore never pulls
+ * pages out from under running processes: the frames live on until the last
+ * mapping goes away through the normal put_frame() path.
+ *
+ * Writable private mappings take the cached frames too, mapped read-only:
+ * the first write to such a page faults and handle_vma_fault() copies it,
+ * since the cache reference keeps the frame's refcount above one.
+ */
+
+#include <kernel/memory/file_map.h>
+#include <kernel/memory/frame.h>
+#include <kernel/memory/kmalloc.h>
+#include <kernel/memory/paging.h>
+#include <kernel/fs/vfs/fs_errno.h>
+#include <kernel/fs/vfs/sys_file.h>
+#include <kernel/sync/spinlock.h>
+#include <kernel/lib/string.h>
+
+typedef struct {
+    bool      in_use;
+    dev_t     dev;
+    ino_t     ino;
+    off_t     size;
+    time_t    mtime;
+    uint32_t  npages;
+    uintptr_t *frames;      // 0 until the page is first read
+    uint32_t  last_use;     // g_use_clock at last lookup, for LRU replacement
+} file_map_object_t;
+
+static file_map_object_t g_objects[FILE_MAP_MAX_OBJECTS];
+static uint32_t g_use_clock = 0;
+static spinlock_t g_file_map_lock = {0};
+
+//============================================================================
+// Cache objects
+//============================================================================
+
+static void object_release_locked(file_map_object_t *obj) {
+    for (uint32_t i = 0; i < obj->npages; i++) {
+        if (obj->frames[i]) put_frame(obj->frames[i]);
+    }
+    kfree(obj->frames);
+    memset(obj, 0, sizeof(*obj));
+}
+
+/**
+ * Finds the object for a file identity, creating it (and evicting the least
+ * recently used one if the table is full) when absent. Stale objects for the
+ * same inode are dropped. Caller holds g_file_map_lock.
+ */
+static file_map_object_t *object_lookup_locked(const struct stat *st) {
+    file_map_object_t *victim = NULL;
+
+    for (int i = 0; i < FILE_MAP_MAX_OBJECTS; i++) {
+        file_map_object_t *obj = &g_objects[i];
+        if (!obj->in_use) {
+            if (!victim || victim->in_use) victim = obj;
+            continue;
+        }
+        if (obj->dev == st->st_dev && obj->ino == st->st_ino) {
+            if (obj->size == st->st_size && obj->mtime == st->st_mtime) {
+                obj->last_use = ++g_use_clock;
+                return obj;
+            }
+            object_release_locked(obj);
+            victim = obj;
+            continue;
+        }
+        if (!victim || (victim->in_use && obj->last_use < victim->last_use)) victim = obj;
+    }
+
+    uint32_t npages = ((uint32_t)st->st_size + PAGE_SIZE - 1) / PAGE_SIZE;
+    uintptr_t *frames = kmalloc(npages * sizeof(uintptr_t));
+    if (!frames) return NULL;
+    memset(frames, 0, npages * sizeof(uintptr_t));
+
+    if (victim->in_use) object_release_locked(victim);
+    victim->in_use = true;
+    victim->dev = st->st_dev;
+    victim->ino = st->st_ino;
+    victim->size = st->st_size;
+    victim->mtime = st->st_mtime;
+    victim->npages = npages;
+    victim->frames = frames;
+    victim->last_use = ++g_use_clock;
+    return victim;
+}
+
+//============================================================================
+// Page population
+//============================================================================
+
+/**
+ * Allocates a frame holding count file bytes from offset followed by zeros.
+ * Returns the frame (refcount 1) or 0.
+ */
+static uintptr_t read_file_frame(file_t *file, uint32_t offset, size_t count) {
+    uintptr_t frame = frame_alloc();
+    if (!frame) return 0;
+
+    uint8_t *page = paging_temp_map(frame);
+    if (!page) {
+        put_frame(frame);
+        return 0;
+    }
+
+    size_t done = 0;
+    if (count > 0 && vfs_lseek(file, (off_t)offset, SEEK_SET) == (off_t)offset) {
+        while (done < count) {
+            int n = vfs_read(file, page + done, count - done);
+            if (n <= 0) break;
+            done += (size_t)n;
+        }
+    }
+    memset(page + done, 0, PAGE_SIZE - done);
+    paging_temp_unmap((uintptr_t)page);
+
+    if (done < count) {
+        put_frame(frame);
+        return 0;
+    }
+    return frame;
+}
+
+/**
+ * Returns the cached frame for page index of the file with identity st,
+ * reading it on first use, with an extra reference for the caller's PTE.
+ */
+static uintptr_t shared_frame(file_t *file, const struct stat *st, uint32_t index) {
+    uintptr_t irq = spinlock_acquire_irqsave(&g_file_map_lock);
+    file_map_object_t *obj = object_lookup_locked(st);
+    if (obj && index < obj->npages && obj->frames[index]) {
+        uintptr_t frame = obj->frames[index];
+        get_frame(frame);
+        spinlock_release_irqrestore(&g_file_map_lock, irq);
+        return frame;
+    }
+    spinlock_release_irqrestore(&g_file_map_lock, irq);
+    if (!obj || index >= obj->npages) return 0;
+
+    // Read outside the lock; a concurrent reader of the same page loses the race
+    uint32_t offset = index * PAGE_SIZE;
+    size_t count = MIN((size_t)(st->st_size - offset), (size_t)PAGE_SIZE);
+    uintptr_t frame = read_file_frame(file, offset, count);
+    if (!frame) return 0;
+
+    irq = spinlock_acquire_irqsave(&g_file_map_lock);
+    obj = object_lookup_locked(st);
+    if (obj && index < obj->npages) {
+        if (obj->frames[index]) {
+            put_frame(frame);
+            frame = obj->frames[index];
+        } else {
+            obj->frames[index] = frame;     // Cache keeps the allocation reference
+        }
+        get_frame(frame);
+    }
+    // else: table thrashing; hand out the private frame as is
+    spinlock_release_irqrestore(&g_file_map_lock, irq);
+    return frame;
+}
+
+//============================================================================
+// Mapping
+//============================================================================
+
+static void unmap_and_release(uint32_t *pd_phys, uintptr_t vaddr, size_t len) {
+    for (uintptr_t va = vaddr; va < vaddr + len; va += PAGE_SIZE) {
+        uintptr_t phys = 0;
+        if (paging_get_physical_address(pd_phys, va, &phys) == 0 && phys) {
+            put_frame(phys & PAGING_ADDR_MASK);
+        }
+    }
+    paging_unmap_range(pd_phys, vaddr, len);
+}
+
+int file_map_private(uint32_t *pd_phys, uintptr_t vaddr, size_t len, uint32_t page_flags,
+                     file_t *file, uint32_t offset, size_t file_bytes) {
+    if (!pd_phys || !file || ((vaddr | len) & (PAGE_SIZE - 1))) return FS_ERR_INVALID_PARAM;
+    if (file_bytes > len) file_bytes = len;
+
+    // Page-aligned file data can share frames; writable views share them COW
+    struct stat st;
+    bool shareable = !(offset & (PAGE_SIZE - 1)) &&
+                     vfs_fstat(file, &st) == FS_SUCCESS && st.st_size > 0;
+    bool reaches_eof = shareable && (off_t)(offset + file_bytes) >= st.st_size;
+
+    for (size_t done = 0; done < len; done += PAGE_SIZE) {
+        size_t page_bytes = (done < file_bytes) ? MIN(file_bytes - done, (size_t)PAGE_SIZE) : 0;
+        uintptr_t frame;
+        uint32_t flags = page_flags;
+
+        // A partial page is shareable only if the rest of it lies past EOF,
+        // where the cached frame is zero-filled as well
+        if (shareable && page_bytes > 0 && (page_bytes == PAGE_SIZE || reaches_eof)) {
+            frame = shared_frame(file, &st, (offset + done) / PAGE_SIZE);
+            flags &= ~PAGE_RW;
+        } else {
+            frame = read_file_frame(file, offset + done, page_bytes);
+        }
+        if (!frame) {
+            unmap_and_release(pd_phys, vaddr, done);
+            return FS_ERR_OUT_OF_MEMORY;
+        }
+        if (paging_map_single_4k(pd_phys, vaddr + done, frame, flags) != 0) {
+            put_frame(frame);
+            unmap_and_release(pd_phys, vaddr, done);
+            return FS_ERR_IO;
+        }
+    }
+    return FS_SUCCESS;
+}
+
+void file_map_invalidate(dev_t dev, ino_t ino) {
+    uintptr_t irq = spinlock_acquire_irqsave(&g_file_map_lock);
+    for (int i = 0; i < FILE_MAP_MAX_OBJECTS; i++) {
+        file_map_object_t *obj = &g_objects[i];
+        if (obj->in_use && obj->dev == dev && obj->ino == ino) {
+            object_release_locked(obj);
+        }
+    }
+    spinlock_release_irqrestore(&g_file_map_lock, irq);
+}
+
+uint32_t file_map_reclaim(uint32_t target_pages) {
+    // Called from the allocator, possibly under our own lock (kmalloc in
+    // object_lookup_locked); give up rather than deadlock
+    uintptr_t irq = spinlock_try_acquire_irqsave(&g_file_map_lock);
+    if (!irq) return 0;
+
+    uint32_t freed = 0;
+    while (freed < target_pages) {
+        file_map_object_t *lru = NULL;
+        for (int i = 0; i < FILE_MAP_MAX_OBJECTS; i++) {
+            if (g_objects[i].in_use && (!lru || g_objects[i].last_use < lru->last_use)) {
+                lru = &g_objects[i];
+            }
+        }
+        if (!lru) break;
+        // Only frames no process maps come back to the allocator
+        for (uint32_t p = 0; p < lru->npages; p++) {
+            if (lru->frames[p] && get_frame_refcount(lru->frames[p]) == 1) freed++;
+        }
+        object_release_locked(lru);
+    }
+    spinlock_release_irqrestore(&g_file_map_lock, irq);
+    return freed;
+}
+
+void file_map_get_stats(uint32_t *objects, uint32_t *cached_pages) {
+    uint32_t nobj = 0, npages = 0;
+    uintptr_t irq = spinlock_acquire_irqsave(&g_file_map_lock);
+    for (int i = 0; i < FILE_MAP_MAX_OBJECTS; i++) {
+        if (!g_objects[i].in_use) continue;
+        nobj++;
+        for (uint32_t p = 0; p < g_objects[i].npages; p++) {
+            if (g_objects[i].frames[p]) npages++;
+        }
+    }
+    spinlock_release_irqrestore(&g_file_map_lock, irq);
+    if (objects) *objects = nobj;
+    if (cached_pages) *cached_pages = npages;
+}
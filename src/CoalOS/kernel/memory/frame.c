@@ -19,6 +19,7 @@
 #include <kernel/core/types.h>            // For uintptr_t, size_t, bool
 #include <kernel/arch/multiboot2.h>
 #include <kernel/lib/assert.h>           // For KERNEL_ASSERT and KERNEL_PANIC_HALT
+#include <kernel/memory/file_map.h>        // file_map_reclaim under memory pressure
 
 // Forward declaration for idle task stack checking
 extern void check_idle_task_stack_integrity(const char *checkpoint);
@@ -51,6 +52,10 @@ extern void check_idle_task_stack_integrity(const char *checkpoint);
 #error "MAX_ORDER is not defined (include buddy.h)"
 #endif
 
+// Frames frame_alloc() asks the file mapping cache to give back when the buddy
+// allocator runs dry
+#define FRAME_RECLAIM_BATCH 64
+
 //----------------------------------------------------------------------------
 // Internal Macros for Logging
 //----------------------------------------------------------------------------
@@ -419,6 +424,11 @@ uintptr_t frame_alloc(void) {
     void* block_virt = buddy_alloc_raw(frame_req_order);
     FRAME_PRINT(2, "[Frame Alloc] buddy_alloc_raw returned VIRT=%p\n", block_virt);
 
+    // Out of memory: drop cached executable and library pages, then retry once
+    if (!block_virt && file_map_reclaim(FRAME_RECLAIM_BATCH) > 0) {
+        block_virt = buddy_alloc_raw(frame_req_order);
+    }
+
     if (!block_virt) {
         FRAME_PRINT(0, "[Frame Alloc ERR] Buddy allocation failed (out of memory?)!\n");
         return 0; // Indicate failure
@@ -569,6 +579,46 @@ void put_frame(uintptr_t phys_addr) {
     }
 }
 
+/**
+ * @brief Drops one reference on each frame in a batch.
+ * Refcounts are adjusted under a single hold of g_frame_lock; frames that
+ * reach zero are compacted to the front of the array and returned to the
+ * buddy allocator once the lock is dropped.
+ * @param phys_addrs Page-aligned physical addresses (overwritten).
+ * @param count Number of entries in phys_addrs.
+ */
+void put_frames(uintptr_t *phys_addrs, size_t count) {
+    if (!phys_addrs || count == 0) return;
+
+    size_t to_free = 0;
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&g_frame_lock);
+    for (size_t i = 0; i < count; i++) {
+        uintptr_t phys_addr = PAGE_ALIGN_DOWN(phys_addrs[i]);
+        size_t pfn = addr_to_pfn(phys_addr);
+
+        if (pfn >= g_total_frames) {
+            spinlock_release_irqrestore(&g_frame_lock, irq_flags);
+            KERNEL_PANIC_HALT("FRAME PANIC: PFN out of bounds in put_frames");
+        }
+        if (g_frame_refcounts[pfn] == 0) {
+            spinlock_release_irqrestore(&g_frame_lock, irq_flags);
+            FRAME_PANIC("Double free detected in put_frames!");
+            return;
+        }
+        if (--g_frame_refcounts[pfn] == 0) {
+            phys_addrs[to_free++] = phys_addr;
+        }
+    }
+    spinlock_release_irqrestore(&g_frame_lock, irq_flags);
+
+    FRAME_PRINT(1, "[Put Frames] Dropped %lu references, freeing %lu frames.\n",
+                  (unsigned long)count, (unsigned long)to_free);
+
+    for (size_t i = 0; i < to_free; i++) {
+        buddy_free_raw((void*)(phys_addrs[i] + KERNEL_SPACE_VIRT_START), FRAME_BUDDY_ORDER);
+    }
+}
+
 //----------------------------------------------------------------------------
 // Reference Count Management Functions
 //----------------------------------------------------------------------------
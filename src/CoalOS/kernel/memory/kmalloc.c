@@ -25,6 +25,8 @@
  #endif
  
  #include <kernel/lib/string.h> // For memset
+ #include <kernel/lib/percpu_counter.h>
+ #include <kernel/lib/tunables.h>
  
  //----------------------------------------------------------------------------
  // Constants and Configuration
@@ -35,10 +37,29 @@
  // Let's keep it at 2048 for now.
  #define SLAB_ALLOC_MAX_USER_SIZE 2048
  _Static_assert(SLAB_ALLOC_MAX_USER_SIZE < (PAGE_SIZE - 128), "SLAB_ALLOC_MAX_USER_SIZE too large"); // Basic check
+
+ // Effective slab threshold (vm.kmalloc_slab_max). Slab caches exist up to
+ // SLAB_ALLOC_MAX_USER_SIZE, so it can only be lowered; larger requests go to
+ // the buddy allocator. kfree() follows each block's header, so changing it
+ // at runtime is safe.
+ static uint32_t g_slab_max_user_size = SLAB_ALLOC_MAX_USER_SIZE;
+
+ static tunable_t g_slab_max_tunable = {
+     .name = "vm.kmalloc_slab_max",
+     .desc = "Largest kmalloc() size served from slab caches, in bytes",
+     .type = TUNABLE_U32,
+     .value = &g_slab_max_user_size,
+     .min = 64,
+     .max = SLAB_ALLOC_MAX_USER_SIZE,
+ };
  
  // Define KMALLOC_HEADER_MAGIC for extra validation in kfree (optional)
  #define KMALLOC_HEADER_MAGIC 0xDEADBEEF
  
+ // Small-object cache hit/miss accounting ("kmalloc.tls_*" in /dev/stats)
+ static percpu_counter_t g_tls_cache_hits;
+ static percpu_counter_t g_tls_cache_misses;
+ 
  //----------------------------------------------------------------------------
  // Global Slab Mode Specifics (Only if USE_PERCPU_ALLOC is NOT defined)
  //----------------------------------------------------------------------------
@@ -116,7 +137,11 @@
      terminal_write("[kmalloc] Initializing Kmalloc...\n");
      serial_printf("  - Header Size    : %d bytes\n", (int)KALLOC_HEADER_SIZE);
      serial_printf("  - Min Alignment  : %d bytes\n", (int)KMALLOC_MIN_ALIGNMENT);
-     serial_printf("  - Slab Max User Size: %d bytes\n", (int)SLAB_ALLOC_MAX_USER_SIZE);
+     tunable_register(&g_slab_max_tunable);
+     serial_printf("  - Slab Max User Size: %d bytes\n", (int)g_slab_max_user_size);
+ 
+     percpu_counter_init(&g_tls_cache_hits, "kmalloc.tls_hits", 0);
+     percpu_counter_init(&g_tls_cache_misses, "kmalloc.tls_misses", 0);
  
  #ifdef USE_PERCPU_ALLOC
      terminal_write("[kmalloc] Initializing Per-CPU strategy...\n");
@@ -215,7 +240,7 @@ void *kmalloc(size_t user_size) {
     alloc_type_e alloc_type = ALLOC_TYPE_BUDDY;
     slab_cache_t *slab_cache = NULL;
 
-    if (user_size <= SLAB_ALLOC_MAX_USER_SIZE) {
+    if (user_size <= g_slab_max_user_size) {
 #ifdef USE_PERCPU_ALLOC
         int cpu_id = get_cpu_id();
         if (cpu_id >= 0) {
@@ -366,30 +391,28 @@ void kfree(void *ptr) {
 typedef struct tls_cache_entry {
     void *objects[TLS_CACHE_SIZE];
     uint32_t count;
-    uint32_t hits;
-    uint32_t misses;
 } tls_cache_entry_t;
 
 // Per-CPU caches to reduce contention
-static tls_cache_entry_t g_tls_caches[4] = {0}; // Support up to 4 CPUs
+static tls_cache_entry_t g_tls_caches[MAX_CPUS] = {0};
 
 static void *tls_cache_alloc(size_t size) {
     if (size > TLS_CACHE_OBJECT_SIZE) return NULL;
     
     int cpu_id = get_cpu_id();
-    if (cpu_id < 0 || cpu_id >= 4) return NULL;
+    if (cpu_id < 0 || cpu_id >= MAX_CPUS) return NULL;
     
     tls_cache_entry_t *cache = &g_tls_caches[cpu_id];
     
     if (cache->count > 0) {
         cache->count--;
-        cache->hits++;
+        percpu_counter_inc(&g_tls_cache_hits);
         void *result = cache->objects[cache->count];
         cache->objects[cache->count] = NULL;
         return result;
     }
     
-    cache->misses++;
+    percpu_counter_inc(&g_tls_cache_misses);
     return NULL; // Cache miss - use regular allocation
 }
 
@@ -397,7 +420,7 @@ static bool tls_cache_free(void *ptr, size_t size) {
     if (size > TLS_CACHE_OBJECT_SIZE || !ptr) return false;
     
     int cpu_id = get_cpu_id();
-    if (cpu_id < 0 || cpu_id >= 4) return false;
+    if (cpu_id < 0 || cpu_id >= MAX_CPUS) return false;
     
     tls_cache_entry_t *cache = &g_tls_caches[cpu_id];
     
@@ -419,7 +442,7 @@ void *kmalloc_bulk(size_t size, size_t count, void **ptrs) {
     if (!ptrs || count == 0 || size == 0) return NULL;
     
     // For small objects, try to allocate from same slab for better locality
-    if (size <= SLAB_ALLOC_MAX_USER_SIZE && count <= 16) {
+    if (size <= g_slab_max_user_size && count <= 16) {
 #ifdef USE_PERCPU_ALLOC
         int cpu_id = get_cpu_id();
         if (cpu_id >= 0) {
@@ -12,10 +12,12 @@
  #include <kernel/memory/buddy.h>      // Underlying physical allocator (called by frame allocator) - Needed indirectly
  #include <kernel/memory/frame.h>      // Frame allocator header (frame_alloc, put_frame, get_frame_refcount)
  #include <kernel/memory/paging.h>     // For mapping pages, flags, KERNEL_SPACE_VIRT_START, paging_temp_map/unmap, paging_invalidate_page, paging_unmap_range
- #include <kernel/fs/vfs/vfs.h>        // For file_t definition (though not used directly here, included for completeness)
+ #include <kernel/fs/vfs/vfs.h>        // For file_t, vfs_file_get/vfs_close on vm_file
+ #include <kernel/memory/shmem.h>      // Pages of shared memory objects (VM_SHARED with vm_file)
  #include <kernel/fs/vfs/fs_errno.h>   // For error codes (EFAULT, ENOMEM, EPERM, etc.)
  #include <kernel/lib/rbtree.h>     // RB Tree header
  #include <kernel/process/process.h>    // For pcb_t, get_current_process
+ #include <kernel/core/constants.h>     // USER_SPACE_START_VIRT
  #include <kernel/lib/string.h>     // For memset, memcpy
  #include <kernel/drivers/display/serial.h>     // For serial_write debug logging
  #include <kernel/sync/spinlock.h>   // For spinlock_t and functions
@@ -65,8 +67,7 @@
  // Frees the VMA structure and associated resources (like file handle ref count)
  static void free_vma_resources(vma_struct_t* vma) {
      if (!vma) return;
-     // TODO: If file-backed, decrement file reference count (vfs_file_put?)
-     // if (vma->vm_file) { vfs_file_put(vma->vm_file); } // Assuming vfs_file_put exists
+     if (vma->vm_file) { vfs_close(vma->vm_file); } // Drop the VMA's file reference
      kfree(vma); // Free the vma_struct itself
  }
  
@@ -111,6 +112,7 @@
      // ---> END Log <---
      mm->vma_tree.root = NULL; // Clear root immediately
      mm->map_count = 0;
+     mm->mmap_cache = NULL;
      spinlock_release_irqrestore(&mm->lock, irq_flags); // Release lock before traversal
  
      if (root) {
@@ -200,10 +202,20 @@
  
  /**
   * Finds the VMA containing addr using RB Tree. Assumes lock held.
+  * Consecutive lookups usually hit the same VMA (stack, heap), so the last
+  * hit is checked before walking the tree.
   */
  static vma_struct_t* find_vma_locked(mm_struct_t *mm, uintptr_t addr) {
+     vma_struct_t *cached = mm->mmap_cache;
+     if (cached && addr >= cached->vm_start && addr < cached->vm_end) {
+         return cached;
+     }
      // Call RB Tree find function
-     return rbtree_find_vma(mm->vma_tree.root, addr);
+     vma_struct_t *vma = rbtree_find_vma(mm->vma_tree.root, addr);
+     if (vma) {
+         mm->mmap_cache = vma;
+     }
+     return vma;
  }
  
  /**
@@ -217,6 +229,30 @@
      return vma;
  }
  
+ bool mm_is_user_range(uintptr_t addr, size_t len) {
+     return len > 0 && addr >= USER_SPACE_START_VIRT &&
+            addr + len > addr && addr + len <= USER_STACK_BOTTOM_VIRT;
+ }
+
+ uintptr_t mm_get_unmapped_area(mm_struct_t *mm, uintptr_t hint, size_t len) {
+     if (!mm || len == 0) return 0;
+     len = PAGE_ALIGN_UP(len);
+     uintptr_t addr = PAGE_ALIGN_DOWN(hint ? hint : MMAP_BASE_VIRT);
+     if (addr < USER_SPACE_START_VIRT) addr = USER_SPACE_START_VIRT;
+
+     uintptr_t irq_flags = spinlock_acquire_irqsave(&mm->lock);
+     while (addr + len > addr && addr + len <= USER_STACK_BOTTOM_VIRT) {
+         vma_struct_t *clash = rbtree_find_overlap(mm->vma_tree.root, addr, addr + len);
+         if (!clash) {
+             spinlock_release_irqrestore(&mm->lock, irq_flags);
+             return addr;
+         }
+         addr = clash->vm_end;   // Skip past the conflicting area and retry
+     }
+     spinlock_release_irqrestore(&mm->lock, irq_flags);
+     return 0;
+ }
+
  /**
   * Inserts a VMA into RB Tree, checking overlaps. Assumes lock held.
   */
@@ -279,7 +315,7 @@
      vma->vm_end = end;
      vma->vm_flags = vm_flags;
      vma->page_prot = page_prot;
-     vma->vm_file = file; // Note: This doesn't take ownership or increment refcount here
+     vma->vm_file = vfs_file_get(file); // The VMA holds its own reference (dropped in free_vma_resources)
      vma->vm_offset = offset;
      vma->vm_mm = mm;
      // RB node fields initialized by rb_tree_insert_at
@@ -292,8 +328,6 @@
          free_vma_resources(vma); // Free struct if insertion failed
          return NULL;
      }
-     // TODO: If file-backed, increment file reference count NOW (e.g., vfs_file_dup(file))
-     // if (vma->vm_file) { vfs_file_dup(vma->vm_file); } // Requires vfs_file_dup
      return result;
  }
  
@@ -499,30 +533,37 @@
  
      // --- Handle Non-Present Page Fault (Allocate and Map) ---
      // terminal_printf("[PF Handle] NP Fault: V=%p\n", (void*)fault_address);
-     phys_page = frame_alloc(); // 1. Allocate frame
-     if (!phys_page) { return -FS_ERR_OUT_OF_MEMORY; }
-     // terminal_printf("   Allocated phys frame: %#lx\n", phys_page);
- 
-     // 2. Map frame temporarily into kernel to populate
-     temp_addr_for_copy = paging_temp_map(phys_page);
-     if (!temp_addr_for_copy) {
-         put_frame(phys_page); return -FS_ERR_IO;
-     }
+     if (vma->vm_file && shmem_is_shm(vma->vm_file)) {
+         // Shared memory object: map its page (with a reference for this PTE) so
+         // every mapping of the object sees the same frame
+         ret = shmem_get_page(vma->vm_file, (uint32_t)(vma->vm_offset + (page_addr - vma->vm_start)), &phys_page);
+         if (ret != FS_SUCCESS) { return ret; }
+     } else {
+         phys_page = frame_alloc(); // 1. Allocate frame
+         if (!phys_page) { return -FS_ERR_OUT_OF_MEMORY; }
+         // terminal_printf("   Allocated phys frame: %#lx\n", phys_page);
+ 
+         // 2. Map frame temporarily into kernel to populate
+         temp_addr_for_copy = paging_temp_map(phys_page);
+         if (!temp_addr_for_copy) {
+             put_frame(phys_page); return -FS_ERR_IO;
+         }
  
-     // 3. Populate frame
-     if (vma->vm_flags & VM_FILEBACKED) {
-         terminal_printf("   Populating from file (TODO) V=%p P=%#lx\n", (void*)page_addr, (unsigned long)phys_page);
-         // TODO: Implement file read logic here
-         // Need vma->vm_file, vma->vm_offset, page_addr - vma->vm_start
-         memset(temp_addr_for_copy, 0, PAGE_SIZE); // Placeholder
-     } else { // Anonymous VMA
-         // terminal_printf("   Zeroing anonymous page V=%p P=%#lx\n", (void*)page_addr, phys_page);
-         memset(temp_addr_for_copy, 0, PAGE_SIZE);
-     }
+         // 3. Populate frame
+         if (vma->vm_flags & VM_FILEBACKED) {
+             terminal_printf("   Populating from file (TODO) V=%p P=%#lx\n", (void*)page_addr, (unsigned long)phys_page);
+             // TODO: Implement file read logic here
+             // Need vma->vm_file, vma->vm_offset, page_addr - vma->vm_start
+             memset(temp_addr_for_copy, 0, PAGE_SIZE); // Placeholder
+         } else { // Anonymous VMA
+             // terminal_printf("   Zeroing anonymous page V=%p P=%#lx\n", (void*)page_addr, phys_page);
+             memset(temp_addr_for_copy, 0, PAGE_SIZE);
+         }
  
-     // 4. Unmap temporary kernel mapping
-     paging_temp_unmap(temp_addr_for_copy);
-     temp_addr_for_copy = NULL; // Mark as unmapped
+         // 4. Unmap temporary kernel mapping
+         paging_temp_unmap(temp_addr_for_copy);
+         temp_addr_for_copy = NULL; // Mark as unmapped
+     }
  
      // 5. Map frame into process space via PTE
      pte_ptr = get_pte_ptr(mm, page_addr, true); // Allocate PT if needed
@@ -552,6 +593,39 @@
      return 0; // Success
  }
  // --- END UPDATED handle_vma_fault ---
+
+ /**
+  * Copies the PTEs of one VMA from src to dst (fork). Page tables the parent
+  * never populated are skipped whole.
+  */
+ int mm_copy_vma_pages(mm_struct_t *dst, mm_struct_t *src, vma_struct_t *vma) {
+     if (!dst || !src || !vma) return FS_ERR_INVALID_PARAM;
+     bool cow = (vma->vm_flags & VM_WRITE) && !(vma->vm_flags & VM_SHARED);
+     const uintptr_t pt_span = PAGE_SIZE * 1024;
+
+     for (uintptr_t va = vma->vm_start; va < vma->vm_end; va += PAGE_SIZE) {
+         uint32_t *src_pte = get_pte_ptr(src, va, false);
+         if (!src_pte) {
+             va = (va & ~(pt_span - 1)) + pt_span - PAGE_SIZE; // No PT: next table
+             continue;
+         }
+         uint32_t pte = *src_pte;
+         if ((pte & PAGE_PRESENT) && cow && (pte & PAGE_RW)) {
+             pte &= ~PAGE_RW; // Parent loses write access too
+             *src_pte = pte;
+             paging_invalidate_page((void*)va);
+         }
+         paging_temp_unmap(PAGE_ALIGN_DOWN((uintptr_t)src_pte));
+         if (!(pte & PAGE_PRESENT)) continue;
+
+         uint32_t *dst_pte = get_pte_ptr(dst, va, true);
+         if (!dst_pte) return FS_ERR_OUT_OF_MEMORY;
+         get_frame(pte & PAGING_ADDR_MASK);
+         *dst_pte = pte;
+         paging_temp_unmap(PAGE_ALIGN_DOWN((uintptr_t)dst_pte));
+     }
+     return 0;
+ }
  
  
  // --- VMA Range Removal ---
@@ -563,6 +637,9 @@
      uintptr_t end = start + length;
      if (start >= end) return -FS_ERR_INVALID_PARAM;
  
+     // VMAs may be freed or split below; drop the lookup cache
+     mm->mmap_cache = NULL;
+ 
      // terminal_printf("[MM] remove_vma_range_locked: Request [0x%x - 0x%x)\n", start, end);
      int result = 0;
      struct rb_node *node = NULL;
@@ -589,6 +666,13 @@
          if (overlap_start < overlap_end) {
              // terminal_printf("   Overlap found: VMA [0x%x-0x%x) overlaps request [0x%x-0x%x) => unmap [0x%x-0x%x)\n", vma->vm_start, vma->vm_end, start, end, overlap_start, overlap_end);
  
+             // Each present PTE holds a frame reference (shared file frames included)
+             for (uintptr_t va = overlap_start; va < overlap_end; va += PAGE_SIZE) {
+                 uintptr_t phys = 0;
+                 if (paging_get_physical_address(mm->pgd_phys, va, &phys) == 0 && phys) {
+                     put_frame(phys & PAGING_ADDR_MASK);
+                 }
+             }
              result = paging_unmap_range(mm->pgd_phys, overlap_start, overlap_end - overlap_start);
              if (result != 0) { return result; } // Stop on error
  
@@ -603,6 +687,7 @@
                  created_second_part = alloc_vma_struct();
                  if (!created_second_part) return -FS_ERR_OUT_OF_MEMORY;
                  memcpy(created_second_part, vma, sizeof(vma_struct_t)); // Copy original VMA data
+                 vfs_file_get(created_second_part->vm_file); // Each part holds a file reference
                  created_second_part->vm_start = end; // Set new start for second part
                  // Adjust file offset if file-backed
                  if (created_second_part->vm_flags & VM_FILEBACKED) {
@@ -685,4 +770,47 @@
      int result = remove_vma_range_locked(mm, start, length);
      spinlock_release_irqrestore(&mm->lock, irq_flags);
      return result;
- }
\ No newline at end of file
+ } 
+ 
+ // --- User Page Pinning ---
+ 
+ /**
+  * Faults in each page of [start, start + len) as a user access would and
+  * takes a frame reference on it. For writes the fault breaks COW first.
+  */
+ int mm_pin_user_pages(mm_struct_t *mm, uintptr_t start, size_t len, bool write,
+                       uintptr_t *frames, size_t max_frames) {
+     if (!mm || !frames || len == 0) return FS_ERR_INVALID_PARAM;
+     uintptr_t first = PAGE_ALIGN_DOWN(start);
+     uintptr_t end = start + len;
+     if (start < USER_SPACE_START_VIRT || end < start || end > KERNEL_SPACE_VIRT_START) return FS_ERR_INVALID_PARAM;
+     size_t pages = (PAGE_ALIGN_UP(end) - first) / PAGE_SIZE;
+     if (pages > max_frames) return FS_ERR_INVALID_PARAM;
+ 
+     for (size_t i = 0; i < pages; i++) {
+         uintptr_t va = first + i * PAGE_SIZE;
+         uintptr_t phys = 0;
+         uint32_t flags = 0;
+         bool mapped = paging_get_physical_address_and_flags(mm->pgd_phys, va, &phys, &flags) == 0;
+ 
+         if (!mapped || !(flags & PAGE_USER) || (write && !(flags & PAGE_RW))) {
+             vma_struct_t *vma = find_vma(mm, va);
+             uint32_t error_code = PAGE_FAULT_USER | (write ? PAGE_FAULT_WRITE : 0) | (mapped ? PAGE_FAULT_PRESENT : 0);
+             if (!vma || va < vma->vm_start || handle_vma_fault(mm, vma, va, error_code) != 0 ||
+                 paging_get_physical_address_and_flags(mm->pgd_phys, va, &phys, &flags) != 0) {
+                 mm_unpin_user_pages(frames, i);
+                 return FS_ERR_PERMISSION_DENIED;
+             }
+         }
+ 
+         frames[i] = phys & PAGING_ADDR_MASK;
+         get_frame(frames[i]);
+     }
+     return (int)pages;
+ }
+ 
+ void mm_unpin_user_pages(uintptr_t *frames, size_t count) {
+     for (size_t i = 0; i < count; i++) {
+         put_frame(frames[i]);
+     }
+ }
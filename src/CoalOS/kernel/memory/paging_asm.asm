@@ -28,9 +28,11 @@ paging_activate:
     mov eax, [esp + 4]  ; Get physical address of the Page Directory from the stack
     mov cr3, eax        ; Load the physical address into CR3
 
-    ; Enable paging bit (PG - bit 31) in CR0
+    ; Enable paging bit (PG - bit 31) and write protect (WP - bit 16) in CR0.
+    ; WP makes kernel writes to read-only user pages fault, so copy_to_user
+    ; honours COW and read-only mappings without a VMA walk up front.
     mov eax, cr0        ; Read current CR0 value
-    or eax, 0x80000000  ; Set the PG bit (bit 31)
+    or eax, 0x80010000  ; Set the PG bit (bit 31) and WP bit (bit 16)
     mov cr0, eax        ; Write the modified value back to CR0
 
     ret                 ; Return to caller
\ No newline at end of file
@@ -16,13 +16,23 @@
 #include <kernel/drivers/display/terminal.h>
 #include <kernel/drivers/display/serial.h>
 #include <kernel/lib/assert.h>
+#include <kernel/lib/percpu_counter.h>
 
-// Page fault statistics
+// Page fault statistics ("pf.*" in /dev/stats)
 static struct {
-    uint64_t total_faults;
-    uint64_t handled_faults;
-    uint64_t fatal_faults;
-} g_pf_stats = {0};
+    percpu_counter_t total_faults;
+    percpu_counter_t handled_faults;
+    percpu_counter_t fatal_faults;
+} g_pf_stats;
+
+/**
+ * @brief Registers the page fault counters
+ */
+void page_fault_stats_init(void) {
+    percpu_counter_init(&g_pf_stats.total_faults, "pf.total", 0);
+    percpu_counter_init(&g_pf_stats.handled_faults, "pf.handled", 0);
+    percpu_counter_init(&g_pf_stats.fatal_faults, "pf.fatal", 0);
+}
 
 /**
  * @brief Page fault handler
@@ -40,7 +50,7 @@ void page_fault_handler(registers_t* regs) {
     bool is_reserved = (error_code & PAGE_FAULT_RESERVED) != 0;
     bool is_fetch = (error_code & PAGE_FAULT_FETCH) != 0;
     
-    g_pf_stats.total_faults++;
+    percpu_counter_inc(&g_pf_stats.total_faults);
     
     // Log the fault details
     LOGGER_DEBUG(LOG_MODULE, "Page fault at %p (EIP=%p, error=%#x)",
@@ -104,7 +114,7 @@ void page_fault_handler(registers_t* regs) {
     
     if (result == 0) {
         // Successfully handled
-        g_pf_stats.handled_faults++;
+        percpu_counter_inc(&g_pf_stats.handled_faults);
         LOGGER_DEBUG(LOG_MODULE, "Page fault handled successfully");
         return;
     }
@@ -124,7 +134,7 @@ void page_fault_handler(registers_t* regs) {
     }
     
 fatal:
-    g_pf_stats.fatal_faults++;
+    percpu_counter_inc(&g_pf_stats.fatal_faults);
     
     // Print detailed fault information
     terminal_printf("\n=== FATAL PAGE FAULT ===\n");
@@ -160,13 +170,48 @@ fatal:
     KERNEL_PANIC_HALT("Fatal page fault");
 }
 
+/**
+ * @brief Resolves a kernel-mode fault on a user address at a uaccess site
+ */
+int page_fault_resolve_uaccess(registers_t* regs) {
+    uintptr_t fault_addr;
+    asm volatile("mov %%cr2, %0" : "=r"(fault_addr));
+
+    percpu_counter_inc(&g_pf_stats.total_faults);
+
+    if (fault_addr >= KERNEL_SPACE_VIRT_START) {
+        return 0;
+    }
+
+    tcb_t* current_task = get_current_task();
+    if (!current_task || !current_task->process || !current_task->process->mm) {
+        return 0;
+    }
+
+    mm_struct_t *mm = current_task->process->mm;
+    vma_struct_t *vma = find_vma(mm, fault_addr);
+    if (!vma || fault_addr < vma->vm_start) {
+        LOGGER_DEBUG(LOG_MODULE, "uaccess fault at %p outside any VMA (EIP=%p)",
+                     (void*)fault_addr, (void*)regs->eip);
+        return 0;
+    }
+
+    // VMA permission checks happen here, on the first real touch of the page
+    if (handle_vma_fault(mm, vma, fault_addr, regs->err_code) != 0) {
+        return 0;
+    }
+
+    percpu_counter_inc(&g_pf_stats.handled_faults);
+    return 1;
+}
+
 /**
  * @brief Get page fault statistics
  */
 void page_fault_get_stats(uint64_t* total_faults, 
                          uint64_t* handled_faults,
                          uint64_t* fatal_faults) {
-    if (total_faults) *total_faults = g_pf_stats.total_faults;
-    if (handled_faults) *handled_faults = g_pf_stats.handled_faults;
-    if (fatal_faults) *fatal_faults = g_pf_stats.fatal_faults;
+    if (total_faults) *total_faults = (uint64_t)percpu_counter_sum(&g_pf_stats.total_faults);
+    if (handled_faults) *handled_faults = (uint64_t)percpu_counter_sum(&g_pf_stats.handled_faults);
+    if (fatal_faults) *fatal_faults = (uint64_t)percpu_counter_sum(&g_pf_stats.fatal_faults);
 }
\ No newline at end of file
@@ -105,20 +105,32 @@ uintptr_t paging_clone_directory(uint32_t* src_pd_phys) {
     return new_pd_phys;
 }
 
+// Frames released per put_frames() call during teardown
+#define FREE_BATCH_SIZE 64
+
 /**
  * @brief Free all user space mappings in a page directory
+ *
+ * Frames are handed back in batches so the frame lock is taken once per
+ * FREE_BATCH_SIZE pages rather than once per page. PDEs shared with the
+ * kernel directory (the low identity mapping) are left alone.
  */
 void paging_free_user_space(uint32_t* page_directory_phys) {
-    // Map the page directory
-    uint32_t* pd_virt = (page_directory_phys == (uint32_t*)g_kernel_page_directory_phys)
-                        ? g_kernel_page_directory_virt
-                        : (uint32_t*)paging_temp_map((uintptr_t)page_directory_phys);
+    if (page_directory_phys == (uint32_t*)g_kernel_page_directory_phys) {
+        LOGGER_ERROR(LOG_MODULE, "Refusing to free user space of the kernel page directory");
+        return;
+    }
     
+    // Map the page directory
+    uint32_t* pd_virt = (uint32_t*)paging_temp_map((uintptr_t)page_directory_phys);
     if (!pd_virt) {
         LOGGER_ERROR(LOG_MODULE, "Failed to map page directory for cleanup");
         return;
     }
     
+    uintptr_t batch[FREE_BATCH_SIZE];
+    size_t batch_count = 0;
+    
     // Free all user space page tables (below kernel space)
     uint32_t kernel_pde_start = PDE_INDEX(KERNEL_SPACE_VIRT_START);
     
@@ -129,9 +141,13 @@ void paging_free_user_space(uint32_t* page_directory_phys) {
             continue;
         }
         
+        // Copied from the kernel directory, not owned by this process
+        if (pde == g_kernel_page_directory_virt[i]) {
+            pd_virt[i] = 0;
+            continue;
+        }
+        
         if (pde & PAGE_PS) {
-            // 4MB page - free it
-            uintptr_t large_page_phys = pde & PAGING_PDE_ADDR_MASK_4MB;
             // TODO: Handle 4MB page freeing
             LOGGER_WARN(LOG_MODULE, "4MB page freeing not implemented");
         } else {
@@ -140,30 +156,38 @@ void paging_free_user_space(uint32_t* page_directory_phys) {
             uint32_t* pt_virt = (uint32_t*)paging_temp_map(pt_phys);
             
             if (pt_virt) {
-                // Free all pages in this page table
                 for (uint32_t j = 0; j < 1024; j++) {
                     uint32_t pte = pt_virt[j];
-                    if (pte & PAGE_PRESENT) {
-                        uintptr_t page_phys = pte & PAGING_ADDR_MASK;
-                        put_frame(page_phys);
+                    if (!(pte & PAGE_PRESENT)) {
+                        continue;
+                    }
+                    batch[batch_count++] = pte & PAGING_ADDR_MASK;
+                    if (batch_count == FREE_BATCH_SIZE) {
+                        put_frames(batch, batch_count);
+                        batch_count = 0;
                     }
                 }
                 
                 paging_temp_unmap((uintptr_t)pt_virt);
             }
             
-            // Free the page table itself
-            put_frame(pt_phys);
+            // The page table itself goes in the same batch
+            batch[batch_count++] = pt_phys;
+            if (batch_count == FREE_BATCH_SIZE) {
+                put_frames(batch, batch_count);
+                batch_count = 0;
+            }
         }
         
         // Clear the PDE
         pd_virt[i] = 0;
     }
     
-    // Unmap if we used temp mapping
-    if (pd_virt != g_kernel_page_directory_virt) {
-        paging_temp_unmap((uintptr_t)pd_virt);
+    if (batch_count) {
+        put_frames(batch, batch_count);
     }
     
+    paging_temp_unmap((uintptr_t)pd_virt);
+    
     LOGGER_DEBUG(LOG_MODULE, "Freed user space for PD %p", page_directory_phys);
-}
\ No newline at end of file
+}
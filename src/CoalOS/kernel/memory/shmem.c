@@ -0,0 +1,494 @@
+/**
+ * @file shmem.c
+ * @brief Shared memory objects (POSIX shm and shared anonymous mappings)
+ *
+ * The object owns one reference on every frame in its page array; each PTE
+ * that maps a page owns another, taken by shmem_get_page(). Shrinking or
+ * freeing an object therefore only drops the object's references, and pages
+ * still mapped somewhere live on until those mappings go away.
+ *
+ * Every open file of an object holds one object reference (refs), and so
+ * does every VMA through the file it keeps in vm_file. An object is freed
+ * once it is no longer reachable by name and the last reference is gone.
+ */
+
+#include <kernel/memory/shmem.h>
+#include <kernel/memory/frame.h>
+#include <kernel/memory/kmalloc.h>
+#include <kernel/memory/paging.h>
+#include <kernel/fs/vfs/fs_errno.h>
+#include <kernel/fs/vfs/sys_file.h>
+#include <kernel/drivers/display/serial.h>
+#include <kernel/sync/spinlock.h>
+#include <kernel/lib/string.h>
+#include <libc/stddef.h>
+
+#define SHM_DEV 0x5348     // st_dev of every object ("SH")
+
+typedef struct shm_object {
+    struct shm_object *next;        // g_shm_objects, while linked
+    char       name[SHM_NAME_MAX + 1];
+    bool       linked;              // Reachable through SHM_MOUNT_POINT
+    uint32_t   refs;                // Open files of the object
+    ino_t      ino;
+    size_t     size;
+    uint32_t   mtime;               // Bumped on every write/truncate
+    uintptr_t *pages;               // 0 until the page is first touched
+    uint32_t   nr_slots;            // Entries in pages[]
+} shm_object_t;
+
+static shm_object_t *g_shm_objects = NULL;
+static spinlock_t g_shm_lock = {0};
+static ino_t g_next_ino = 1;
+
+static void *shm_vfs_mount(const char *device);
+static int shm_vfs_unmount(void *fs_context);
+static vnode_t *shm_vfs_open(void *fs_context, const char *path, int flags);
+static int shm_vfs_read(file_t *file, void *buffer, size_t count);
+static int shm_vfs_write(file_t *file, const void *buffer, size_t count);
+static int shm_vfs_close(file_t *file);
+static off_t shm_vfs_lseek(file_t *file, off_t offset, int whence);
+static int shm_vfs_unlink(void *fs_context, const char *path);
+static int shm_vfs_fstat(file_t *file, struct stat *st);
+static int shm_vfs_ftruncate(file_t *file, off_t length);
+
+static vfs_driver_t shm_driver = {
+    .fs_name = "shm",
+    .mount = shm_vfs_mount,
+    .unmount = shm_vfs_unmount,
+    .open = shm_vfs_open,
+    .read = shm_vfs_read,
+    .write = shm_vfs_write,
+    .close = shm_vfs_close,
+    .lseek = shm_vfs_lseek,
+    .readdir = NULL,
+    .unlink = shm_vfs_unlink,
+    .mkdir = NULL,
+    .rmdir = NULL,
+    .read_inode = NULL,
+    .write_inode = NULL,
+    .stat_inode = NULL,
+    .fstat = shm_vfs_fstat,
+    .ftruncate = shm_vfs_ftruncate,
+    .next = NULL
+};
+
+//============================================================================
+// Objects
+//============================================================================
+
+static inline shm_object_t *shm_from_file(file_t *file)
+{
+    if (!file || !file->vnode || file->vnode->fs_driver != &shm_driver) return NULL;
+    return (shm_object_t *)file->vnode->data;
+}
+
+static inline uint8_t *shm_page_addr(uintptr_t frame)
+{
+    return (uint8_t *)(frame + KERNEL_SPACE_VIRT_START);
+}
+
+static shm_object_t *shm_object_alloc(const char *name)
+{
+    shm_object_t *obj = kmalloc(sizeof(*obj));
+    if (!obj) return NULL;
+    memset(obj, 0, sizeof(*obj));
+    if (name) {
+        strncpy(obj->name, name, SHM_NAME_MAX);
+        obj->name[SHM_NAME_MAX] = '\0';
+    }
+    obj->ino = g_next_ino++;
+    return obj;
+}
+
+// Caller holds g_shm_lock and the object is unreachable
+static void shm_object_free(shm_object_t *obj)
+{
+    if (obj->pages) {
+        for (uint32_t i = 0; i < obj->nr_slots; i++) {
+            if (obj->pages[i]) put_frame(obj->pages[i]);
+        }
+        kfree(obj->pages);
+    }
+    kfree(obj);
+}
+
+static shm_object_t *shm_lookup_locked(const char *name)
+{
+    for (shm_object_t *obj = g_shm_objects; obj; obj = obj->next) {
+        if (strcmp(obj->name, name) == 0) return obj;
+    }
+    return NULL;
+}
+
+static void shm_unlink_locked(shm_object_t *obj)
+{
+    for (shm_object_t **link = &g_shm_objects; *link; link = &(*link)->next) {
+        if (*link == obj) {
+            *link = obj->next;
+            break;
+        }
+    }
+    obj->next = NULL;
+    obj->linked = false;
+}
+
+/**
+ * Sets the object size. The page array grows to cover it; shrinking drops
+ * the object's frames past the end and zeroes the tail of the last page, so
+ * growing again reads zeros as a fresh object would. Caller holds g_shm_lock.
+ */
+static int shm_resize_locked(shm_object_t *obj, size_t size)
+{
+    if (size > SHM_MAX_SIZE) return FS_ERR_OVERFLOW;
+    uint32_t need = (uint32_t)(PAGE_ALIGN_UP(size) / PAGE_SIZE);
+
+    if (need > obj->nr_slots) {
+        uint32_t slots = obj->nr_slots ? obj->nr_slots : 1;
+        while (slots < need) slots *= 2;
+        uintptr_t *pages = kmalloc(slots * sizeof(uintptr_t));
+        if (!pages) return FS_ERR_OUT_OF_MEMORY;
+        memset(pages, 0, slots * sizeof(uintptr_t));
+        if (obj->pages) {
+            memcpy(pages, obj->pages, obj->nr_slots * sizeof(uintptr_t));
+            kfree(obj->pages);
+        }
+        obj->pages = pages;
+        obj->nr_slots = slots;
+    } else if (size < obj->size) {
+        for (uint32_t i = need; i < obj->nr_slots; i++) {
+            if (obj->pages[i]) {
+                put_frame(obj->pages[i]);
+                obj->pages[i] = 0;
+            }
+        }
+        size_t tail = size & (PAGE_SIZE - 1);
+        if (tail && obj->pages[need - 1]) {
+            memset(shm_page_addr(obj->pages[need - 1]) + tail, 0, PAGE_SIZE - tail);
+        }
+    }
+
+    obj->size = size;
+    obj->mtime++;
+    return FS_SUCCESS;
+}
+
+// Returns the frame of page index, allocating a zeroed one on first touch
+static uintptr_t shm_page_locked(shm_object_t *obj, uint32_t index)
+{
+    uintptr_t frame = obj->pages[index];
+    if (!frame) {
+        frame = frame_alloc();
+        if (!frame) return 0;
+        memset(shm_page_addr(frame), 0, PAGE_SIZE);
+        obj->pages[index] = frame;
+    }
+    return frame;
+}
+
+static vnode_t *shm_vnode_create(shm_object_t *obj)
+{
+    vnode_t *vnode = kmalloc(sizeof(*vnode));
+    if (!vnode) return NULL;
+    vnode->data = obj;
+    vnode->fs_driver = &shm_driver;
+    return vnode;
+}
+
+bool shmem_is_shm(file_t *file)
+{
+    return shm_from_file(file) != NULL;
+}
+
+file_t *shmem_file_create(size_t size)
+{
+    shm_object_t *obj = shm_object_alloc(NULL);
+    vnode_t *vnode = obj ? shm_vnode_create(obj) : NULL;
+    file_t *file = vnode ? kmalloc(sizeof(*file)) : NULL;
+    if (!file) {
+        if (vnode) kfree(vnode);
+        if (obj) kfree(obj);
+        return NULL;
+    }
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&g_shm_lock);
+    int ret = shm_resize_locked(obj, size);
+    obj->refs = 1;
+    spinlock_release_irqrestore(&g_shm_lock, irq_flags);
+
+    file->vnode = vnode;
+    file->flags = O_RDWR;
+    file->offset = 0;
+    spinlock_init(&file->lock);
+    file->refcount = 1;
+
+    if (ret != FS_SUCCESS) {
+        vfs_close(file);
+        return NULL;
+    }
+    return file;
+}
+
+int shmem_get_page(file_t *file, uint32_t offset, uintptr_t *frame_out)
+{
+    shm_object_t *obj = shm_from_file(file);
+    if (!obj || !frame_out) return FS_ERR_INVALID_PARAM;
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&g_shm_lock);
+    if (offset >= obj->size) {
+        // Past the end, where Linux would raise SIGBUS
+        spinlock_release_irqrestore(&g_shm_lock, irq_flags);
+        return FS_ERR_OUT_OF_BOUNDS;
+    }
+    uintptr_t frame = shm_page_locked(obj, offset / PAGE_SIZE);
+    if (frame) get_frame(frame);
+    spinlock_release_irqrestore(&g_shm_lock, irq_flags);
+
+    if (!frame) return FS_ERR_OUT_OF_MEMORY;
+    *frame_out = frame;
+    return FS_SUCCESS;
+}
+
+int shmem_mmap(file_t *file, mm_struct_t *mm, uintptr_t addr, size_t length,
+               uint32_t offset, uint32_t prot)
+{
+    if (!shm_from_file(file) || !mm || (offset & (PAGE_SIZE - 1))) return -EINVAL;
+
+    uint32_t vm_flags = VM_USER | VM_SHARED | VM_FILEBACKED;
+    uint32_t page_prot = PAGE_PRESENT | PAGE_USER;
+    if (prot & 0x1) vm_flags |= VM_READ;
+    if (prot & 0x2) { vm_flags |= VM_WRITE; page_prot |= PAGE_RW; }
+    if (prot & 0x4) vm_flags |= VM_EXEC;
+    else if (g_nx_supported) page_prot |= PAGE_NX_BIT;
+
+    // The VMA takes its own reference on the file; faults map the pages
+    if (!insert_vma(mm, addr, addr + length, vm_flags, page_prot, file, offset)) {
+        return -ENOMEM;
+    }
+    return 0;
+}
+
+//============================================================================
+// VFS Operations
+//============================================================================
+
+static void *shm_vfs_mount(const char *device)
+{
+    (void)device;
+    // Objects are global; VFS only needs a non-NULL context
+    return (void *)0x1;
+}
+
+static int shm_vfs_unmount(void *fs_context)
+{
+    (void)fs_context;
+    return 0;
+}
+
+// "/name" relative to the mount; there are no subdirectories
+static const char *shm_name_from_path(const char *path)
+{
+    if (!path || path[0] != '/') return NULL;
+    const char *name = path + 1;
+    size_t len = strlen(name);
+    if (len == 0 || len > SHM_NAME_MAX || strchr(name, '/')) return NULL;
+    return name;
+}
+
+static vnode_t *shm_vfs_open(void *fs_context, const char *path, int flags)
+{
+    (void)fs_context;
+    const char *name = shm_name_from_path(path);
+    if (!name) return NULL;
+
+    // Allocated up front so nothing is allocated while holding the lock
+    shm_object_t *fresh = (flags & O_CREAT) ? shm_object_alloc(name) : NULL;
+    if ((flags & O_CREAT) && !fresh) return NULL;
+    vnode_t *vnode = kmalloc(sizeof(*vnode));
+    if (!vnode) {
+        if (fresh) kfree(fresh);
+        return NULL;
+    }
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&g_shm_lock);
+    shm_object_t *obj = shm_lookup_locked(name);
+    if (obj && (flags & O_CREAT) && (flags & O_EXCL)) {
+        obj = NULL;     // Exists: the open fails
+    } else if (!obj && fresh) {
+        obj = fresh;
+        fresh = NULL;
+        obj->linked = true;
+        obj->next = g_shm_objects;
+        g_shm_objects = obj;
+    }
+    if (obj) {
+        obj->refs++;
+        if ((flags & O_TRUNC) && (flags & O_ACCMODE) != O_RDONLY) {
+            shm_resize_locked(obj, 0);
+        }
+    }
+    spinlock_release_irqrestore(&g_shm_lock, irq_flags);
+
+    if (fresh) kfree(fresh);
+    if (!obj) {
+        kfree(vnode);
+        return NULL;
+    }
+    vnode->data = obj;
+    vnode->fs_driver = &shm_driver;
+    return vnode;
+}
+
+static int shm_vfs_read(file_t *file, void *buffer, size_t count)
+{
+    shm_object_t *obj = shm_from_file(file);
+    if (!obj || !buffer) return -EINVAL;
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&g_shm_lock);
+    if (file->offset < 0 || (size_t)file->offset >= obj->size) {
+        spinlock_release_irqrestore(&g_shm_lock, irq_flags);
+        return 0;
+    }
+    size_t pos = (size_t)file->offset;
+    if (count > obj->size - pos) count = obj->size - pos;
+
+    uint8_t *dst = buffer;
+    size_t done = 0;
+    while (done < count) {
+        size_t in_page = (pos + done) & (PAGE_SIZE - 1);
+        size_t part = MIN(PAGE_SIZE - in_page, count - done);
+        uintptr_t frame = obj->pages[(pos + done) / PAGE_SIZE];
+        if (frame) memcpy(dst + done, shm_page_addr(frame) + in_page, part);
+        else memset(dst + done, 0, part);   // Never touched: reads as zeros
+        done += part;
+    }
+    spinlock_release_irqrestore(&g_shm_lock, irq_flags);
+    return (int)count;
+}
+
+static int shm_vfs_write(file_t *file, const void *buffer, size_t count)
+{
+    shm_object_t *obj = shm_from_file(file);
+    if (!obj || !buffer || file->offset < 0) return -EINVAL;
+    size_t pos = (size_t)file->offset;
+    if (pos > SHM_MAX_SIZE || count > SHM_MAX_SIZE - pos) return -EFBIG;
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&g_shm_lock);
+    if (pos + count > obj->size && shm_resize_locked(obj, pos + count) != FS_SUCCESS) {
+        spinlock_release_irqrestore(&g_shm_lock, irq_flags);
+        return -ENOMEM;
+    }
+
+    const uint8_t *src = buffer;
+    size_t done = 0;
+    while (done < count) {
+        size_t in_page = (pos + done) & (PAGE_SIZE - 1);
+        size_t part = MIN(PAGE_SIZE - in_page, count - done);
+        uintptr_t frame = shm_page_locked(obj, (uint32_t)((pos + done) / PAGE_SIZE));
+        if (!frame) break;
+        memcpy(shm_page_addr(frame) + in_page, src + done, part);
+        done += part;
+    }
+    obj->mtime++;
+    spinlock_release_irqrestore(&g_shm_lock, irq_flags);
+    return done ? (int)done : -ENOMEM;
+}
+
+static int shm_vfs_close(file_t *file)
+{
+    shm_object_t *obj = shm_from_file(file);
+    if (!obj) return 0;
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&g_shm_lock);
+    bool last = (--obj->refs == 0) && !obj->linked;
+    if (last) shm_object_free(obj);
+    spinlock_release_irqrestore(&g_shm_lock, irq_flags);
+
+    file->vnode->data = NULL;
+    return 0;
+}
+
+static off_t shm_vfs_lseek(file_t *file, off_t offset, int whence)
+{
+    shm_object_t *obj = shm_from_file(file);
+    if (!obj) return -EINVAL;
+
+    off_t base;
+    switch (whence) {
+        case SEEK_SET: base = 0; break;
+        case SEEK_CUR: base = file->offset; break;
+        case SEEK_END: base = (off_t)obj->size; break;
+        default: return -EINVAL;
+    }
+    if (base + offset < 0) return -EINVAL;
+    file->offset = base + offset;
+    return file->offset;
+}
+
+static int shm_vfs_unlink(void *fs_context, const char *path)
+{
+    (void)fs_context;
+    const char *name = shm_name_from_path(path);
+    if (!name) return FS_ERR_NOT_FOUND;
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&g_shm_lock);
+    shm_object_t *obj = shm_lookup_locked(name);
+    if (obj) {
+        shm_unlink_locked(obj);
+        // Open descriptors and mappings keep it alive until they go away
+        if (obj->refs == 0) shm_object_free(obj);
+    }
+    spinlock_release_irqrestore(&g_shm_lock, irq_flags);
+    return obj ? FS_SUCCESS : FS_ERR_NOT_FOUND;
+}
+
+static int shm_vfs_fstat(file_t *file, struct stat *st)
+{
+    shm_object_t *obj = shm_from_file(file);
+    if (!obj) return FS_ERR_BAD_F;
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&g_shm_lock);
+    st->st_dev = SHM_DEV;
+    st->st_ino = obj->ino;
+    st->st_mode = S_IFREG | 0600;
+    st->st_nlink = obj->linked ? 1 : 0;
+    st->st_size = (off_t)obj->size;
+    st->st_mtime = (time_t)obj->mtime;
+    st->st_blksize = PAGE_SIZE;
+    st->st_blocks = (blkcnt_t)(PAGE_ALIGN_UP(obj->size) / 512);
+    spinlock_release_irqrestore(&g_shm_lock, irq_flags);
+    return FS_SUCCESS;
+}
+
+static int shm_vfs_ftruncate(file_t *file, off_t length)
+{
+    shm_object_t *obj = shm_from_file(file);
+    if (!obj) return FS_ERR_BAD_F;
+    if (length < 0) return FS_ERR_INVALID_PARAM;
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&g_shm_lock);
+    int ret = shm_resize_locked(obj, (size_t)length);
+    spinlock_release_irqrestore(&g_shm_lock, irq_flags);
+    return ret;
+}
+
+int shmem_init(void)
+{
+    spinlock_init(&g_shm_lock);
+
+    int result = vfs_register_driver(&shm_driver);
+    if (result < 0) {
+        serial_printf("[SHM] Failed to register shm driver: %d\n", result);
+        return result;
+    }
+
+    result = vfs_mount(SHM_MOUNT_POINT, "shm", "shm");
+    if (result < 0) {
+        serial_printf("[SHM] Failed to mount at %s: %d\n", SHM_MOUNT_POINT, result);
+        vfs_unregister_driver(&shm_driver);
+        return result;
+    }
+
+    serial_printf("[SHM] Shared memory objects available at %s\n", SHM_MOUNT_POINT);
+    return 0;
+}
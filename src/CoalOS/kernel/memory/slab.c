@@ -60,6 +60,10 @@
  static void slab_list_add(slab_t **list_head, slab_t *slab);
  static bool slab_list_remove(slab_t **list_head, slab_t *slab_to_remove);
 
+ /* Registry of live caches, for slab_for_each_cache() */
+ static slab_cache_t *g_slab_caches = NULL;
+ static spinlock_t g_slab_caches_lock = { 0 };
+
  /* Helper: Check slab magic and alignment */
  static inline bool is_valid_slab(const slab_t *slab) {
      if (!slab) { return false; }
@@ -148,6 +152,11 @@
          return NULL;
      }
 
+     uintptr_t list_flags = spinlock_acquire_irqsave(&g_slab_caches_lock);
+     cache->next_cache = g_slab_caches;
+     g_slab_caches = cache;
+     spinlock_release_irqrestore(&g_slab_caches_lock, list_flags);
+
      serial_printf("[Slab] Created cache '%s' (user=%d, slot=%d, align=%d, color=%d)\n",
                      name, (int)cache->user_obj_size, (int)cache->internal_slot_size,
                      (int)cache->alignment, cache->color_range);
@@ -376,6 +385,12 @@
      if (!cache) return;
      const char * cache_name_copy = cache->name;
 
+     uintptr_t list_flags = spinlock_acquire_irqsave(&g_slab_caches_lock);
+     for (slab_cache_t **link = &g_slab_caches; *link; link = &(*link)->next_cache) {
+         if (*link == cache) { *link = cache->next_cache; break; }
+     }
+     spinlock_release_irqrestore(&g_slab_caches_lock, list_flags);
+
      uintptr_t irq_flags = spinlock_acquire_irqsave(&cache->lock);
      serial_printf("[Slab] Destroying cache '%s'...\n", cache_name_copy);
      slab_t *curr, *next;
@@ -412,4 +427,14 @@
      if (out_alloc) *out_alloc = cache->alloc_count;
      if (out_free) *out_free = cache->free_count;
      spinlock_release_irqrestore(&cache->lock, irq_flags);
- }
\ No newline at end of file
+ }
+
+ /* slab_for_each_cache */
+ void slab_for_each_cache(void (*visit)(slab_cache_t *cache, void *ctx), void *ctx) {
+     if (!visit) return;
+     uintptr_t irq_flags = spinlock_acquire_irqsave(&g_slab_caches_lock);
+     for (slab_cache_t *cache = g_slab_caches; cache; cache = cache->next_cache) {
+         visit(cache, ctx);
+     }
+     spinlock_release_irqrestore(&g_slab_caches_lock, irq_flags);
+ }
@@ -1,7 +1,7 @@
 ; uaccess.asm
 ; Provides low-level routines for copying data between kernel and user space.
 ; Includes exception table for page fault handling.
-; Version 2.3 - Applied stack imbalance fix for movsb fault paths as per review.
+; Version 2.4 - REP MOVS copies covered by exception table range entries.
 
 BITS 32
 
@@ -9,69 +9,65 @@ SECTION .text
 GLOBAL _raw_copy_from_user
 GLOBAL _raw_copy_to_user
 
+; Exception table entry covering the single instruction at %1.
 %macro EX_TABLE 2
     SECTION .ex_table align=4
-    dd %1 ; from_eip
-    dd %2 ; to_eip
+    dd %1     ; insn_start
+    dd %1 + 1 ; insn_end
+    dd %2     ; fixup
     SECTION .text
 %endmacro
 
+; Exception table entry covering every instruction in [%1, %2).
+%macro EX_TABLE_RANGE 3
+    SECTION .ex_table align=4
+    dd %1 ; insn_start
+    dd %2 ; insn_end
+    dd %3 ; fixup
+    SECTION .text
+%endmacro
+
+; Both routines copy n/4 dwords with REP MOVSD, then n%4 bytes with REP MOVSB.
+; On a fault REP leaves ECX holding the iterations still to do, so the fixups
+; can compute the number of bytes not copied without any per-byte bookkeeping.
+; EDX holds the byte tail count throughout.
+
 _raw_copy_from_user:
     push ebp
     mov ebp, esp
     push esi
     push edi
     push ebx
-    ; ECX (count) is passed directly, not saved here as it's return value / modified
 
     mov edi, [ebp + 8]  ; k_dst
     mov esi, [ebp + 12] ; u_src
     mov ecx, [ebp + 16] ; n (count)
 
-    test ecx, ecx
-    jz .copy_from_done_success  ; If count is 0, nothing to do
-
-.dword_loop_from:
-    cmp ecx, 4
-    jl .byte_loop_from_check    ; Less than 4 bytes left
-
-    EX_TABLE .movsd_fault_target_from, .fault_handler_movsd_from
-.movsd_fault_target_from:
-    movsd                       ; Copy 4 bytes: [ESI] -> [EDI], ESI+=4, EDI+=4
-    sub ecx, 4
-    jmp .dword_loop_from
-
-.byte_loop_from_check:
-    test ecx, ecx
-    jz .copy_from_done_success  ; If count is 0 after dwords, done
-
-.byte_loop_from:
-    ; Byte copy loop:
-    push ecx                    ; Save remaining byte count (1, 2, or 3)
-    mov ecx, 1                  ; Set count for movsb
+    cld
+    mov edx, ecx
+    and edx, 3                  ; EDX = tail bytes
+    shr ecx, 2                  ; ECX = dwords
 
-    EX_TABLE .movsb_fault_target_from, .fault_handler_movsb_from
-.movsb_fault_target_from:
-    movsb                       ; Copy 1 byte: [ESI] -> [EDI], ESI++, EDI++
+    EX_TABLE_RANGE .dwords_from_start, .dwords_from_end, .fault_handler_dwords_from
+.dwords_from_start:
+    rep movsd
+.dwords_from_end:
 
-    pop ecx                     ; Restore original remaining byte count
-    dec ecx                     ; Decrement count for the byte just copied
-    jnz .byte_loop_from         ; Loop if more bytes remaining
-    ; If ecx becomes 0, fall through to done_success
+    mov ecx, edx
+    EX_TABLE .bytes_from_start, .fault_handler_bytes_from
+.bytes_from_start:
+    rep movsb
 
-.copy_from_done_success:
     xor eax, eax                ; Success: 0 bytes not copied
     jmp .cleanup_from
 
-.fault_handler_movsd_from:
-    ; Fault during MOVSD. ECX has bytes remaining at point of fault.
-    mov eax, ecx
+.fault_handler_dwords_from:
+    ; Remaining = dwords left * 4 + untouched tail bytes
+    lea eax, [edx + ecx * 4]
     jmp .cleanup_from
 
-.fault_handler_movsb_from:
-    ; Fault during MOVSB.
-    add esp, 4                  ; *** PATCH: Undo the 'push ecx' from .byte_loop_from ***
-    mov eax, ecx                ; ECX was 1 (the byte being copied), so 1 byte not copied.
+.fault_handler_bytes_from:
+    mov eax, ecx                ; Bytes left in the tail
     jmp .cleanup_from
 
 .cleanup_from:
@@ -89,52 +85,35 @@ _raw_copy_to_user:
     push esi
     push edi
     push ebx
-    ; ECX (count) is passed directly
 
     mov edi, [ebp + 8]  ; u_dst
     mov esi, [ebp + 12] ; k_src
     mov ecx, [ebp + 16] ; n (count)
 
-    test ecx, ecx
-    jz .copy_to_done_success
-
-.dword_loop_to:
-    cmp ecx, 4
-    jl .byte_loop_to_check
-
-    EX_TABLE .movsd_fault_target_to, .fault_handler_movsd_to
-.movsd_fault_target_to:
-    movsd
-    sub ecx, 4
-    jmp .dword_loop_to
-
-.byte_loop_to_check:
-    test ecx, ecx
-    jz .copy_to_done_success
+    cld
+    mov edx, ecx
+    and edx, 3
+    shr ecx, 2
 
-.byte_loop_to:
-    push ecx
-    mov ecx, 1
+    EX_TABLE_RANGE .dwords_to_start, .dwords_to_end, .fault_handler_dwords_to
+.dwords_to_start:
+    rep movsd
+.dwords_to_end:
 
-    EX_TABLE .movsb_fault_target_to, .fault_handler_movsb_to
-.movsb_fault_target_to:
-    movsb
+    mov ecx, edx
+    EX_TABLE .bytes_to_start, .fault_handler_bytes_to
+.bytes_to_start:
+    rep movsb
 
-    pop ecx
-    dec ecx
-    jnz .byte_loop_to
-
-.copy_to_done_success:
     xor eax, eax
     jmp .cleanup_to
 
-.fault_handler_movsd_to:
-    mov eax, ecx
+.fault_handler_dwords_to:
+    lea eax, [edx + ecx * 4]
     jmp .cleanup_to
 
-.fault_handler_movsb_to:
-    add esp, 4                  ; *** PATCH: Undo the 'push ecx' from .byte_loop_to ***
-    mov eax, ecx                ; ECX was 1.
+.fault_handler_bytes_to:
+    mov eax, ecx
     jmp .cleanup_to
 
 .cleanup_to:
@@ -143,4 +122,4 @@ _raw_copy_to_user:
     pop esi
     mov esp, ebp
     pop ebp
-    ret
\ No newline at end of file
+    ret
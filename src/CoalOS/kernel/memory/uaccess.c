@@ -7,6 +7,7 @@
 // --- Includes ---
 #include <kernel/memory/uaccess.h>
 #include <kernel/memory/paging.h>
+#include <kernel/core/constants.h>  // USER_SPACE_START_VIRT
 #include <kernel/process/process.h>
 #include <kernel/memory/mm.h>
 #include <kernel/lib/assert.h>
@@ -46,80 +47,42 @@ static inline void serial_print_hex_uaccess(uintptr_t n) { /* ... */ }
 #endif
 
 
+/**
+ * Range-only check: the span must lie within [USER_SPACE_START_VIRT,
+ * KERNEL_SPACE_VIRT_START). Below USER_SPACE_START_VIRT every page directory
+ * shares the kernel's supervisor identity map (PDE 0), which the kernel's own
+ * accesses would reach without faulting. VMA coverage and permissions are not
+ * consulted here; a bad user address is caught when the copy actually faults.
+ * The page fault path first tries to resolve the fault against the VMA
+ * (demand paging, COW) and otherwise redirects to the copy routine's
+ * exception-table fixup, which reports the bytes left uncopied. This keeps
+ * the common syscall path free of VMA tree walks and of unlocked reads of
+ * current_proc->mm.
+ */
 bool access_ok(int type, const_userptr_t uaddr_user, size_t size) {
     uintptr_t uaddr = (uintptr_t)uaddr_user;
     uintptr_t end_addr;
-
-    UACCESS_SERIAL_LOG("Enter access_ok");
-    UACCESS_SERIAL_LOG_ADDR("  Type:", type);
-    UACCESS_SERIAL_LOG_ADDR("  Addr:", uaddr);
-    UACCESS_SERIAL_LOG_ADDR("  Size:", size);
-
+    (void)type;
 
     if (size == 0) {
-        UACCESS_SERIAL_LOG("  -> OK (size is 0)");
         return true;
     }
     if (!uaddr_user) { // Check the opaque pointer
         UACCESS_SERIAL_LOG("  -> Denied: NULL pointer");
         return false;
     }
-    if (uaddr >= KERNEL_SPACE_VIRT_START) {
-        UACCESS_SERIAL_LOG_ADDR("  -> Denied: Address in kernel space", uaddr);
+    if (uaddr < USER_SPACE_START_VIRT) {
+        UACCESS_SERIAL_LOG_ADDR("  -> Denied: Address below user space", uaddr);
         return false;
     }
     if (__builtin_add_overflow(uaddr, size, &end_addr)) {
         UACCESS_SERIAL_LOG_ADDR("  -> Denied: Address range overflow", uaddr);
         return false;
     }
-    if (end_addr > KERNEL_SPACE_VIRT_START || end_addr <= uaddr) {
-        UACCESS_SERIAL_LOG_RANGE("  -> Denied: Address range crosses kernel boundary or wraps", uaddr, end_addr);
-        return false;
-    }
-    UACCESS_SERIAL_LOG_RANGE("  Basic checks passed. Range:", uaddr, end_addr);
-
-    pcb_t *current_proc = get_current_process();
-    if (!current_proc || !current_proc->mm) {
-        UACCESS_SERIAL_LOG("  -> Denied: No current process or mm_struct for VMA check.");
+    if (end_addr > KERNEL_SPACE_VIRT_START) {
+        UACCESS_SERIAL_LOG_RANGE("  -> Denied: Address range crosses kernel boundary", uaddr, end_addr);
         return false;
     }
-    mm_struct_t *mm = current_proc->mm;
-    // KERNEL_ASSERT(mm != NULL, "Process has NULL mm_struct"); // Already covered by !current_proc->mm
-
-    UACCESS_SERIAL_LOG_ADDR("  Checking VMAs for PID:", current_proc->pid);
-
-    uintptr_t current_check_addr = uaddr;
-    while (current_check_addr < end_addr) {
-        UACCESS_SERIAL_LOG_ADDR("  Checking VMA coverage starting at:", current_check_addr);
-        vma_struct_t *vma = find_vma(mm, current_check_addr);
-
-        if (!vma || current_check_addr < vma->vm_start) {
-            UACCESS_SERIAL_LOG_ADDR("  -> Denied: Address not covered by any VMA", current_check_addr);
-            return false;
-        }
-        UACCESS_SERIAL_LOG_VMA(vma);
-
-        // BUG_ON(vma->vm_end <= vma->vm_start); // As per review suggestion
-        KERNEL_ASSERT(vma->vm_end > vma->vm_start, "VMA has vm_end <= vm_start in access_ok");
-
-
-        bool access_granted = true;
-        if ((type & VERIFY_READ) && !(vma->vm_flags & VM_READ)) {
-            access_granted = false;
-            UACCESS_SERIAL_LOG("  -> Denied: VMA lacks READ permission.");
-        }
-        if ((type & VERIFY_WRITE) && !(vma->vm_flags & VM_WRITE)) {
-            access_granted = false;
-            UACCESS_SERIAL_LOG("  -> Denied: VMA lacks WRITE permission.");
-        }
-        if (!access_granted) return false;
-
-        UACCESS_SERIAL_LOG("  Permissions OK for this VMA segment.");
-        current_check_addr = vma->vm_end;
-        UACCESS_SERIAL_LOG_ADDR("  Advanced check address to:", current_check_addr);
-    }
-
-    UACCESS_SERIAL_LOG("  -> OK (VMA checks passed for entire range)");
     return true;
 }
 
@@ -147,4 +110,47 @@ size_t copy_to_user(userptr_t u_dst, const_kernelptr_t k_src, size_t n) {
     }
     // The assembly function _raw_copy_to_user still takes void* internally
     return _raw_copy_to_user((void*)u_dst, (const void*)k_src, n);
-}
\ No newline at end of file
+}
+
+// Word-at-a-time zero byte detection (true if any byte of v is 0x00).
+#define UACCESS_HAS_ZERO_BYTE(v) ((((v) - 0x01010101u) & ~(v) & 0x80808080u) != 0)
+// Bytes fetched per _raw_copy_from_user call in strnlen_user.
+#define STRNLEN_USER_CHUNK 64
+
+long strnlen_user(const_userptr_t u_str, size_t maxlen) {
+    uintptr_t uaddr = (uintptr_t)u_str;
+    if (maxlen == 0) return 0;
+    if (!access_ok(VERIFY_READ, u_str, 1)) return -EFAULT;
+
+    // Never read past the user/kernel boundary even if maxlen would allow it
+    size_t limit = KERNEL_SPACE_VIRT_START - uaddr;
+    if (maxlen > limit) maxlen = limit;
+
+    uint32_t chunk_buf[STRNLEN_USER_CHUNK / sizeof(uint32_t)];
+    size_t len = 0;
+    while (len < maxlen) {
+        // Stay within the current page so a NUL near the end of the last
+        // mapped page is found before we touch the next (possibly unmapped) one.
+        uintptr_t cur = uaddr + len;
+        size_t chunk = PAGE_SIZE - (cur & (PAGE_SIZE - 1));
+        if (chunk > STRNLEN_USER_CHUNK) chunk = STRNLEN_USER_CHUNK;
+        if (chunk > maxlen - len) chunk = maxlen - len;
+
+        size_t not_copied = _raw_copy_from_user(chunk_buf, (const void *)cur, chunk);
+        size_t got = chunk - not_copied;
+
+        const uint8_t *bytes = (const uint8_t *)chunk_buf;
+        size_t i = 0;
+        for (; i + sizeof(uint32_t) <= got; i += sizeof(uint32_t)) {
+            uint32_t v = chunk_buf[i / sizeof(uint32_t)];
+            if (UACCESS_HAS_ZERO_BYTE(v)) break;
+        }
+        for (; i < got; i++) {
+            if (bytes[i] == '\0') return (long)(len + i);
+        }
+
+        if (not_copied) return -EFAULT;
+        len += got;
+    }
+    return (long)maxlen;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file cputime.c
+ * @brief TSC-based user/system time accounting
+ *
+ * Each task keeps the TSC value of its last accounting point (acct_tsc).
+ * A boundary charges the cycles since then to user or system time and moves
+ * the point forward; the direction of the boundary says which bucket the
+ * elapsed interval belongs to, so no per-task mode flag is needed. An
+ * acct_tsc of 0 means "not started" (e.g. the task predates calibration)
+ * and only starts the clock.
+ */
+
+#include <kernel/process/cputime.h>
+#include <kernel/cpu/tsc.h>
+#include <kernel/sync/spinlock.h>
+#include <libc/stddef.h>
+
+// Closes the interval [acct_tsc, now) and returns its length in ns
+static inline uint64_t cputime_interval(tcb_t *task, uint64_t now) {
+    uint64_t start = task->acct_tsc;
+    task->acct_tsc = now;
+    return start ? tsc_cycles_to_ns(now - start) : 0;
+}
+
+void cputime_user_exit(void) {
+    if (!tsc_ready()) return;
+    tcb_t *task = get_current_task();
+    if (!task) return;
+
+    uintptr_t flags = local_irq_save();
+    task->utime_ns += cputime_interval(task, rdtsc());
+    local_irq_restore(flags);
+}
+
+void cputime_user_enter(void) {
+    if (!tsc_ready()) return;
+    tcb_t *task = get_current_task();
+    if (!task) return;
+
+    uintptr_t flags = local_irq_save();
+    task->stime_ns += cputime_interval(task, rdtsc());
+    local_irq_restore(flags);
+}
+
+void cputime_switch(tcb_t *prev, tcb_t *next) {
+    if (!tsc_ready()) return;
+
+    // Switches happen in kernel mode: the outgoing interval is system time
+    uint64_t now = rdtsc();
+    if (prev) {
+        prev->stime_ns += cputime_interval(prev, now);
+    }
+    if (next) {
+        next->acct_tsc = now;
+    }
+}
+
+void cputime_tick(bool user_mode) {
+    if (tsc_ready()) return;
+    tcb_t *task = get_current_task();
+    if (!task) return;
+
+    if (user_mode) {
+        task->utime_ns += NSEC_PER_TICK;
+    } else {
+        task->stime_ns += NSEC_PER_TICK;
+    }
+}
+
+void cputime_task_read(tcb_t *task, uint64_t *utime, uint64_t *stime) {
+    if (!task) return;
+
+    uintptr_t flags = local_irq_save();
+    uint64_t u = task->utime_ns;
+    uint64_t s = task->stime_ns;
+    // Callers run in the kernel, so the open interval of the current task
+    // is system time
+    if (task == get_current_task() && tsc_ready() && task->acct_tsc) {
+        s += tsc_cycles_to_ns(rdtsc() - task->acct_tsc);
+    }
+    local_irq_restore(flags);
+
+    if (utime) *utime = u;
+    if (stime) *stime = s;
+}
+
+void cputime_task_exit(tcb_t *task) {
+    if (!task) return;
+
+    uintptr_t flags = local_irq_save();
+    if (task == get_current_task() && tsc_ready()) {
+        task->stime_ns += cputime_interval(task, rdtsc());
+    }
+    if (task->process) {
+        task->process->utime_ns += task->utime_ns;
+        task->process->stime_ns += task->stime_ns;
+    }
+    local_irq_restore(flags);
+}
@@ -15,6 +15,11 @@
  #include <kernel/core/types.h>        // size_t, uintptr_t, etc. (Needs MIN macro added)
  
  #include <kernel/lib/string.h>       // memcpy, memset
+ #include <kernel/memory/file_map.h>     // file_map_private
+ #include <kernel/process/exec_cache.h>
+ #include <kernel/fs/vfs/vfs.h>
+ #include <kernel/fs/vfs/sys_file.h>     // O_RDONLY, SEEK_SET
+ #include <kernel/core/constants.h>     // USER_SPACE_START_VIRT, USER_STACK_BOTTOM_VIRT
  #include <libc/stdbool.h> // bool type
  
  // TODO: Define MIN macro in a suitable header (e.g., include/types.h or include/utils.h)
@@ -336,9 +341,209 @@
      return ret;
  }
  
+ //============================================================================
+ // Program loading through file mappings
+ //============================================================================
+
+ extern bool g_nx_supported;
+
+ /** One mapped image: the main program or its interpreter */
+ typedef struct {
+     uintptr_t bias;        // Load bias added to every p_vaddr (0 for ET_EXEC)
+     uintptr_t entry;       // Biased e_entry
+     uintptr_t phdr;        // Biased user address of the program headers, or 0
+     uint32_t  phnum;
+     uintptr_t end;         // Highest biased segment end
+ } elf_image_t;
+
+ static int elf_read_at(file_t *file, uint32_t offset, void *buf, size_t len) {
+     if (vfs_lseek(file, (off_t)offset, SEEK_SET) != (off_t)offset) return -EIO;
+     size_t done = 0;
+     while (done < len) {
+         int n = vfs_read(file, (uint8_t *)buf + done, len - done);
+         if (n <= 0) return -EIO;
+         done += (size_t)n;
+     }
+     return 0;
+ }
+
+ static bool elf_header_valid(const Elf32_Ehdr *ehdr) {
+     return ehdr->e_ident[EI_MAG0] == ELFMAG0 && ehdr->e_ident[EI_MAG1] == ELFMAG1 &&
+            ehdr->e_ident[EI_MAG2] == ELFMAG2 && ehdr->e_ident[EI_MAG3] == ELFMAG3 &&
+            ehdr->e_ident[EI_CLASS] == ELFCLASS32 && ehdr->e_ident[EI_DATA] == ELFDATA2LSB &&
+            (ehdr->e_type == ET_EXEC || ehdr->e_type == ET_DYN) &&
+            ehdr->e_machine == EM_386 && ehdr->e_phentsize == sizeof(Elf32_Phdr) &&
+            ehdr->e_phnum > 0 && ehdr->e_phnum <= ELF_MAX_PHDRS;
+ }
+
+ /** Reads and validates the ELF header, program headers and PT_INTERP path */
+ static int elf_read_headers(file_t *file, const char *path, exec_image_t *image) {
+     int ret;
+
+     memset(image, 0, sizeof(*image));
+     if ((ret = elf_read_at(file, 0, &image->ehdr, sizeof(image->ehdr))) != 0) return ret;
+     if (!elf_header_valid(&image->ehdr)) {
+         terminal_printf("[elf_loader] '%s': not a loadable i386 ELF image.\n", path);
+         return -ENOEXEC;
+     }
+     ret = elf_read_at(file, image->ehdr.e_phoff, image->phdrs,
+                       image->ehdr.e_phnum * sizeof(Elf32_Phdr));
+     if (ret != 0) return ret;
+
+     for (int i = 0; i < image->ehdr.e_phnum; i++) {
+         const Elf32_Phdr *ph = &image->phdrs[i];
+         if (ph->p_type != PT_INTERP) continue;
+         if (ph->p_filesz == 0 || ph->p_filesz > ELF_INTERP_MAX) return -ENOEXEC;
+         if ((ret = elf_read_at(file, ph->p_offset, image->interp, ph->p_filesz)) != 0) return ret;
+         image->interp[ph->p_filesz - 1] = '\0';
+     }
+     return 0;
+ }
+
+ /**
+  * Maps every PT_LOAD segment of path into mm. ET_DYN images are placed at
+  * dyn_base. If interp is non-NULL it receives the PT_INTERP path, or an
+  * empty string when there is none. Headers of recently loaded files come
+  * from the exec cache.
+  */
+ static int elf_map_image(const char *path, mm_struct_t *mm, uintptr_t dyn_base,
+                          elf_image_t *img, char *interp) {
+     exec_image_t image;
+     struct stat st;
+     int ret;
+
+     memset(img, 0, sizeof(*img));
+     if (interp) interp[0] = '\0';
+
+     file_t *file = vfs_open(path, O_RDONLY);
+     if (!file) return -ENOENT;
+
+     bool cacheable = (vfs_fstat(file, &st) == FS_SUCCESS);
+     if (!cacheable || !exec_cache_lookup(&st, &image)) {
+         if ((ret = elf_read_headers(file, path, &image)) != 0) goto out;
+         if (cacheable) exec_cache_insert(&st, &image);
+     }
+     const Elf32_Ehdr *ehdr = &image.ehdr;
+     const Elf32_Phdr *phdrs = image.phdrs;
+     if (interp) memcpy(interp, image.interp, ELF_INTERP_MAX);
+
+     // Position-independent images are rebased so their lowest page lands on dyn_base
+     if (ehdr->e_type == ET_DYN) {
+         uintptr_t lowest = UINTPTR_MAX;
+         for (int i = 0; i < ehdr->e_phnum; i++) {
+             if (phdrs[i].p_type == PT_LOAD && PAGE_ALIGN_DOWN(phdrs[i].p_vaddr) < lowest) {
+                 lowest = PAGE_ALIGN_DOWN(phdrs[i].p_vaddr);
+             }
+         }
+         img->bias = dyn_base - (lowest == UINTPTR_MAX ? 0 : lowest);
+     }
+     img->entry = ehdr->e_entry + img->bias;
+     img->phnum = ehdr->e_phnum;
+
+     uintptr_t prev_end = 0;
+     for (int i = 0; i < ehdr->e_phnum; i++) {
+         const Elf32_Phdr *ph = &phdrs[i];
+
+         if (ph->p_type == PT_PHDR) {
+             img->phdr = ph->p_vaddr + img->bias;
+             continue;
+         }
+         if (ph->p_type != PT_LOAD || ph->p_memsz == 0) continue;
+
+         uintptr_t vaddr = ph->p_vaddr + img->bias;
+         uintptr_t page_start = PAGE_ALIGN_DOWN(vaddr);
+         uintptr_t page_end = PAGE_ALIGN_UP(vaddr + ph->p_memsz);
+         uint32_t lead = vaddr - page_start;
+
+         // Segments must be ordered, page-disjoint and inside user space
+         if (ph->p_filesz > ph->p_memsz || ph->p_offset < lead ||
+             page_start < prev_end || page_start < USER_SPACE_START_VIRT ||
+             page_end > USER_STACK_BOTTOM_VIRT || page_end <= page_start) {
+             terminal_printf("[elf_loader] '%s': bad PT_LOAD %d at %#lx.\n", path, i, (unsigned long)vaddr);
+             ret = -ENOEXEC;
+             goto out;
+         }
+         prev_end = page_end;
+
+         uint32_t vm_flags = VM_USER | VM_FILEBACKED | VM_PRIVATE;
+         uint32_t prot = PAGE_PRESENT | PAGE_USER;
+         if (ph->p_flags & PF_R) vm_flags |= VM_READ;
+         if (ph->p_flags & PF_W) { vm_flags |= VM_WRITE; prot |= PAGE_RW; }
+         if (ph->p_flags & PF_X) vm_flags |= VM_EXEC;
+         else if (g_nx_supported) prot |= PAGE_NX_BIT;
+
+         ret = file_map_private(mm->pgd_phys, page_start, page_end - page_start, prot,
+                                file, ph->p_offset - lead, lead + ph->p_filesz);
+         if (ret != 0) {
+             ret = (ret == FS_ERR_OUT_OF_MEMORY) ? -ENOMEM : -EIO;
+             goto out;
+         }
+         // Pages are populated up front; the VMA only records the layout
+         if (!insert_vma(mm, page_start, page_end, vm_flags, prot, NULL, ph->p_offset - lead)) {
+             ret = -ENOMEM;
+             goto out;
+         }
+
+         // Without PT_PHDR, the headers are found in the segment that maps e_phoff
+         if (!img->phdr && ehdr->e_phoff >= ph->p_offset &&
+             ehdr->e_phoff + ehdr->e_phnum * sizeof(Elf32_Phdr) <= ph->p_offset + ph->p_filesz) {
+             img->phdr = vaddr + (ehdr->e_phoff - ph->p_offset);
+         }
+         if (ph->p_flags & PF_X) {
+             if (!mm->start_code || vaddr < mm->start_code) mm->start_code = vaddr;
+             if (vaddr + ph->p_memsz > mm->end_code) mm->end_code = vaddr + ph->p_memsz;
+         } else if (ph->p_flags & PF_W) {
+             if (!mm->start_data || vaddr < mm->start_data) mm->start_data = vaddr;
+             if (vaddr + ph->p_memsz > mm->end_data) mm->end_data = vaddr + ph->p_memsz;
+         }
+         if (page_end > img->end) img->end = page_end;
+     }
+
+     ret = img->end ? 0 : -ENOEXEC;
+
+ out:
+     vfs_close(file);
+     return ret;
+ }
+
+ int load_elf_program(const char *path, mm_struct_t *mm, elf_load_info_t *info) {
+     if (!path || !mm || !mm->pgd_phys || !info) return -EINVAL;
+     memset(info, 0, sizeof(*info));
+
+     elf_image_t prog;
+     char interp[ELF_INTERP_MAX];
+     int ret = elf_map_image(path, mm, ELF_ET_DYN_BASE, &prog, interp);
+     if (ret != 0) {
+         terminal_printf("[elf_loader] Failed to load '%s' (error %d).\n", path, ret);
+         return ret;
+     }
+
+     info->entry = info->prog_entry = prog.entry;
+     info->phdr = prog.phdr;
+     info->phent = sizeof(Elf32_Phdr);
+     info->phnum = prog.phnum;
+     info->brk = prog.end;
+
+     if (interp[0]) {
+         elf_image_t ld;
+         ret = elf_map_image(interp, mm, ELF_INTERP_BASE, &ld, NULL);
+         if (ret != 0) {
+             terminal_printf("[elf_loader] Failed to load interpreter '%s' for '%s' (error %d).\n",
+                             interp, path, ret);
+             return ret;
+         }
+         info->entry = ld.entry;
+         info->interp_base = ld.bias;
+     }
+     return 0;
+ }
+
  /**
   * @brief Loads a 32-bit ELF file into the given process address space.
   *
+  * Compatibility wrapper around load_elf_program() for callers that need
+  * only the entry point and initial brk.
+  *
   * @param path          Path to the ELF file in your filesystem
   * @param mm            Pointer to the process memory manager (page directory, etc.)
   * @param entry_point   [out] Receives the ELF's entry point
@@ -349,61 +554,13 @@
                               mm_struct_t *mm,
                               uint32_t *entry_point,
                               uintptr_t *initial_brk) {
-     // Validate parameters
-     if (!path || !mm || !entry_point || !initial_brk) {
-         terminal_printf("[elf_loader] load_elf_and_init_memory: Invalid parameters.\n");
-         return -EINVAL;
-     }
-     
-     // Get the page directory from mm_struct
-     if (!mm->pgd_phys) {
-         terminal_printf("[elf_loader] load_elf_and_init_memory: No page directory in mm.\n");
-         return -EINVAL;
-     }
-     
-     terminal_printf("[elf_loader] Loading ELF '%s' into process memory...\n", path);
-     
-     // 1. Call load_elf_binary to load segments
-     int ret = load_elf_binary(path, mm->pgd_phys, entry_point);
-     if (ret != 0) {
-         terminal_printf("[elf_loader] load_elf_binary failed with error %d\n", ret);
-         return ret;
-     }
-     
-     // 2. Calculate initial_brk based on highest loaded address
-     // We need to scan the ELF file again to find the highest address used
-     size_t file_size = 0;
-     void *file_data = read_file(path, &file_size);
-     if (!file_data) {
-         terminal_printf("[elf_loader] Failed to re-read file for brk calculation.\n");
-         return -EIO;
-     }
-     
-     Elf32_Ehdr *ehdr = (Elf32_Ehdr *)file_data;
-     Elf32_Phdr *phdrs = (Elf32_Phdr *)((uint8_t *)file_data + ehdr->e_phoff);
-     
-     uintptr_t highest_addr = 0;
-     
-     // Find the highest virtual address used by any PT_LOAD segment
-     for (Elf32_Half i = 0; i < ehdr->e_phnum; i++) {
-         Elf32_Phdr *phdr = &phdrs[i];
-         if (phdr->p_type == PT_LOAD && phdr->p_memsz > 0) {
-             uintptr_t seg_end = phdr->p_vaddr + phdr->p_memsz;
-             if (seg_end > highest_addr) {
-                 highest_addr = seg_end;
-             }
-         }
-     }
-     
-     kfree(file_data);
-     
-     // Align the brk to page boundary
-     *initial_brk = (highest_addr + PAGE_SIZE - 1) & PAGING_PAGE_MASK;
-     
-     terminal_printf("[elf_loader] ELF loaded successfully. Entry: 0x%x, Initial brk: 0x%lx\n", 
-                     *entry_point, (unsigned long)*initial_brk);
-     
-     // 3. VMAs are initialized by the process creation code after this function returns
-     
+     if (!entry_point || !initial_brk) return -EINVAL;
+
+     elf_load_info_t info;
+     int ret = load_elf_program(path, mm, &info);
+     if (ret != 0) return ret;
+
+     *entry_point = info.entry;
+     *initial_brk = info.brk;
      return 0;
- }
\ No newline at end of file
+ }
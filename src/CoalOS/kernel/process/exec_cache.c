@@ -0,0 +1,89 @@
+/**
+ * @file exec_cache.c
+ * @brief Cache of validated ELF headers for frequently launched programs
+ */
+
+#include <kernel/process/exec_cache.h>
+#include <kernel/sync/spinlock.h>
+#include <kernel/lib/string.h>
+
+typedef struct {
+    bool         in_use;
+    dev_t        dev;
+    ino_t        ino;
+    off_t        size;
+    time_t       mtime;
+    uint32_t     last_use;
+    exec_image_t image;
+} exec_cache_entry_t;
+
+static exec_cache_entry_t g_exec_cache[EXEC_CACHE_MAX_IMAGES];
+static uint32_t g_exec_use_clock = 0;
+static uint32_t g_exec_hits = 0;
+static uint32_t g_exec_misses = 0;
+static spinlock_t g_exec_cache_lock = {0};
+
+bool exec_cache_lookup(const struct stat *st, exec_image_t *image) {
+    bool hit = false;
+    uintptr_t irq = spinlock_acquire_irqsave(&g_exec_cache_lock);
+    for (int i = 0; i < EXEC_CACHE_MAX_IMAGES; i++) {
+        exec_cache_entry_t *e = &g_exec_cache[i];
+        if (e->in_use && e->dev == st->st_dev && e->ino == st->st_ino &&
+            e->size == st->st_size && e->mtime == st->st_mtime) {
+            memcpy(image, &e->image, sizeof(*image));
+            e->last_use = ++g_exec_use_clock;
+            hit = true;
+            break;
+        }
+    }
+    if (hit) g_exec_hits++;
+    else     g_exec_misses++;
+    spinlock_release_irqrestore(&g_exec_cache_lock, irq);
+    return hit;
+}
+
+void exec_cache_insert(const struct stat *st, const exec_image_t *image) {
+    uintptr_t irq = spinlock_acquire_irqsave(&g_exec_cache_lock);
+    exec_cache_entry_t *victim = NULL;
+    for (int i = 0; i < EXEC_CACHE_MAX_IMAGES; i++) {
+        exec_cache_entry_t *e = &g_exec_cache[i];
+        // A stale version of the same file is replaced in place
+        if (e->in_use && e->dev == st->st_dev && e->ino == st->st_ino) {
+            victim = e;
+            break;
+        }
+        if (!victim || (victim->in_use && (!e->in_use || e->last_use < victim->last_use))) {
+            victim = e;
+        }
+    }
+    victim->in_use = true;
+    victim->dev = st->st_dev;
+    victim->ino = st->st_ino;
+    victim->size = st->st_size;
+    victim->mtime = st->st_mtime;
+    victim->last_use = ++g_exec_use_clock;
+    memcpy(&victim->image, image, sizeof(*image));
+    spinlock_release_irqrestore(&g_exec_cache_lock, irq);
+}
+
+void exec_cache_invalidate(dev_t dev, ino_t ino) {
+    uintptr_t irq = spinlock_acquire_irqsave(&g_exec_cache_lock);
+    for (int i = 0; i < EXEC_CACHE_MAX_IMAGES; i++) {
+        if (g_exec_cache[i].in_use && g_exec_cache[i].dev == dev && g_exec_cache[i].ino == ino) {
+            g_exec_cache[i].in_use = false;
+        }
+    }
+    spinlock_release_irqrestore(&g_exec_cache_lock, irq);
+}
+
+void exec_cache_get_stats(uint32_t *hits, uint32_t *misses, uint32_t *entries) {
+    uint32_t n = 0;
+    uintptr_t irq = spinlock_acquire_irqsave(&g_exec_cache_lock);
+    for (int i = 0; i < EXEC_CACHE_MAX_IMAGES; i++) {
+        if (g_exec_cache[i].in_use) n++;
+    }
+    if (hits) *hits = g_exec_hits;
+    if (misses) *misses = g_exec_misses;
+    spinlock_release_irqrestore(&g_exec_cache_lock, irq);
+    if (entries) *entries = n;
+}
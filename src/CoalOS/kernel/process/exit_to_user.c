@@ -0,0 +1,188 @@
+/**
+ * @file exit_to_user.c
+ * @brief Unified exit-to-user work loop and IRQ exit preemption
+ * @version 1.0
+ *
+ * @details Every return to user mode (syscall or interrupt) funnels through
+ * exit_to_user_mode(), which services the current task's TIF_* flags until
+ * none remain: reschedule, deliver signals, run queued task work. Kernel
+ * code is only preempted from irq_exit() when it was interrupted with a
+ * zero preempt count and interrupts enabled, or from preempt_enable().
+ */
+
+//============================================================================
+// Includes
+//============================================================================
+#include <kernel/process/exit_to_user.h>
+#include <kernel/process/signal.h>
+#include <kernel/process/cputime.h>
+#include <kernel/sync/preempt.h>
+#include <kernel/sync/spinlock.h>
+#include <kernel/drivers/display/serial.h>
+#include <libc/stddef.h>
+
+#define USER_RPL_MASK 0x3
+
+//============================================================================
+// Task Work
+//============================================================================
+
+int task_work_add(tcb_t *task, task_work_t *work) {
+    if (!task || !work || !work->func) return -1;
+
+    uintptr_t flags = local_irq_save();
+    work->next = task->task_works;
+    task->task_works = work;
+    set_tsk_thread_flag(task, TIF_NOTIFY_RESUME);
+    local_irq_restore(flags);
+    return 0;
+}
+
+// Unlinks work from a singly linked list; interrupts must be disabled
+static bool task_work_unlink(task_work_t **head, task_work_t *work) {
+    for (task_work_t **link = head; *link; link = &(*link)->next) {
+        if (*link == work) {
+            *link = work->next;
+            work->next = NULL;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool task_work_cancel(tcb_t *task, task_work_t *work) {
+    if (!task || !work) return false;
+
+    uintptr_t flags = local_irq_save();
+    bool removed = task_work_unlink(&task->task_works, work);
+    local_irq_restore(flags);
+    return removed;
+}
+
+int task_exit_work_add(tcb_t *task, task_work_t *work) {
+    if (!task || !work || !work->func) return -1;
+
+    uintptr_t flags = local_irq_save();
+    work->next = task->exit_works;
+    task->exit_works = work;
+    local_irq_restore(flags);
+    return 0;
+}
+
+bool task_exit_work_cancel(tcb_t *task, task_work_t *work) {
+    if (!task || !work) return false;
+
+    uintptr_t flags = local_irq_save();
+    bool removed = task_work_unlink(&task->exit_works, work);
+    local_irq_restore(flags);
+    return removed;
+}
+
+void task_work_exit(tcb_t *task) {
+    if (!task) return;
+
+    uintptr_t flags = local_irq_save();
+    task->task_works = NULL;
+    clear_tsk_thread_flag(task, TIF_NOTIFY_RESUME);
+    task_work_t *work = task->exit_works;
+    task->exit_works = NULL;
+    local_irq_restore(flags);
+
+    while (work) {
+        task_work_t *next = work->next;
+        work->func(work);
+        work = next;
+    }
+}
+
+static void task_work_run(tcb_t *task) {
+    // Detach the whole list; callbacks may queue more work, which re-raises
+    // TIF_NOTIFY_RESUME and is picked up by the next loop iteration.
+    uintptr_t flags = local_irq_save();
+    task_work_t *work = task->task_works;
+    task->task_works = NULL;
+    local_irq_restore(flags);
+
+    while (work) {
+        task_work_t *next = work->next;
+        work->func(work);
+        work = next;
+    }
+}
+
+//============================================================================
+// Exit Paths
+//============================================================================
+
+static void exit_deliver_signals(tcb_t *task, isr_frame_t *frame) {
+    pcb_t *proc = task->process;
+    if (!proc) return;
+
+    signal_deliver_pending(proc, frame);
+
+    // Fatal default action or SIGKILL: never go back to user mode
+    if (proc->has_exited) {
+        remove_current_task_with_code(proc->exit_status);
+    }
+
+    uintptr_t flags = spinlock_acquire_irqsave(&proc->signal_lock);
+    signal_recalc_pending(proc);
+    spinlock_release_irqrestore(&proc->signal_lock, flags);
+}
+
+void exit_to_user_mode(isr_frame_t *frame) {
+    tcb_t *task = get_current_task();
+    if (!task || !frame) return;
+
+    // Kernel-mode callers of INT 0x80 only get the reschedule check
+    bool to_user = (frame->cs & USER_RPL_MASK) == USER_RPL_MASK;
+    uint32_t mask = to_user ? EXIT_TO_USER_WORK : TIF_NEED_RESCHED;
+
+    uint32_t work;
+    while ((work = task->thread_flags & mask) != 0) {
+        if (work & TIF_NEED_RESCHED) {
+            schedule(); // Clears the flag; resumes here as the same task
+            continue;
+        }
+        if (work & TIF_NOTIFY_RESUME) {
+            clear_tsk_thread_flag(task, TIF_NOTIFY_RESUME);
+            task_work_run(task);
+        }
+        if (work & TIF_SIGPENDING) {
+            clear_tsk_thread_flag(task, TIF_SIGPENDING);
+            exit_deliver_signals(task, frame);
+        }
+        // Work above may have re-enabled interrupts; re-check with IF clear
+        asm volatile("cli" ::: "memory");
+    }
+
+    if (to_user) {
+        cputime_user_enter();
+    }
+}
+
+void irq_enter(void) {
+    preempt_count_add(HARDIRQ_OFFSET);
+}
+
+void irq_exit(isr_frame_t *frame) {
+    preempt_count_sub(HARDIRQ_OFFSET);
+
+    // Nested interrupt: the outermost handler does the exit work
+    if (in_interrupt() || !frame) return;
+
+    if ((frame->cs & USER_RPL_MASK) == USER_RPL_MASK) {
+        exit_to_user_mode(frame);
+        return;
+    }
+
+    // Kernel preemption at a safe point only
+    if (preempt_count() != 0 || !(frame->eflags & EFLAGS_IF) || !scheduler_is_ready()) {
+        return;
+    }
+    tcb_t *task = get_current_task();
+    while (task && test_tsk_thread_flag(task, TIF_NEED_RESCHED)) {
+        schedule();
+        asm volatile("cli" ::: "memory");
+    }
+}
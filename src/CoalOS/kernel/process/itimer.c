@@ -0,0 +1,410 @@
+/**
+ * @file itimer.c
+ * @brief Per-process interval timers and POSIX timers
+ *
+ * Wall-clock timers (ITIMER_REAL, timer_create) are ktimers whose callbacks
+ * queue the signal and re-arm themselves for periodic operation. CPU-time
+ * timers (ITIMER_VIRTUAL, ITIMER_PROF) are nanosecond countdowns; each PIT
+ * tick charges them with the user/system time accounted since the previous
+ * tick (see cputime.h). The kernel has no wall clock yet, so CLOCK_REALTIME
+ * and CLOCK_MONOTONIC both count ticks since boot.
+ */
+
+#include <kernel/process/itimer.h>
+#include <kernel/process/signal.h>
+#include <kernel/process/cputime.h>
+#include <kernel/memory/kmalloc.h>
+#include <kernel/sync/spinlock.h>
+#include <kernel/lib/string.h>
+#include <kernel/lib/math64.h>
+#include <kernel/fs/vfs/fs_errno.h>
+#include <libc/stddef.h>
+
+#define TICKS_PER_SEC   KTIMER_HZ
+#define USEC_PER_TICK   (1000000u / KTIMER_HZ)
+#define NSEC_PER_USEC   1000u
+
+typedef struct ptimer {
+    ktimer_t  kt;
+    pcb_t    *owner;
+    int       clockid;
+    int       notify;
+    int       signo;
+    uint32_t  interval;       // Reload in ticks (0 = one-shot)
+    uint32_t  overrun;        // Expiries while the signal was still pending
+    uint32_t  overrun_last;   // Reported by timer_getoverrun()
+} ptimer_t;
+
+struct proc_timers {
+    spinlock_t lock;
+    pcb_t     *owner;
+    ktimer_t   real;
+    uint32_t   real_interval;
+    uint64_t   virt_value;      // CPU timers count down in ns
+    uint64_t   virt_interval;
+    uint64_t   prof_value;
+    uint64_t   prof_interval;
+    uint64_t   last_utime;      // Task times at the previous charge
+    uint64_t   last_stime;
+    ptimer_t  *posix[PTIMER_MAX];
+};
+
+//============================================================================
+// Tick Conversion
+//============================================================================
+
+static int32_t secs_frac_to_ticks(int32_t sec, uint32_t frac_ticks, uint32_t *ticks) {
+    if (sec >= (int32_t)(KTIMER_MAX_DELTA / TICKS_PER_SEC)) {
+        *ticks = KTIMER_MAX_DELTA;
+    } else {
+        *ticks = (uint32_t)sec * TICKS_PER_SEC + frac_ticks;
+    }
+    return 0;
+}
+
+int32_t itimer_timeval_to_ticks(const k_timeval_t *tv, uint32_t *ticks) {
+    if (!tv || !ticks) return -EINVAL;
+    if (tv->tv_sec < 0 || tv->tv_usec < 0 || tv->tv_usec >= 1000000) return -EINVAL;
+    uint32_t frac = ((uint32_t)tv->tv_usec + USEC_PER_TICK - 1) / USEC_PER_TICK;
+    return secs_frac_to_ticks(tv->tv_sec, frac, ticks);
+}
+
+int32_t itimer_timespec_to_ticks(const k_timespec_t *ts, uint32_t *ticks) {
+    if (!ts || !ticks) return -EINVAL;
+    if (ts->tv_sec < 0 || ts->tv_nsec < 0 || ts->tv_nsec >= 1000000000) return -EINVAL;
+    uint32_t frac = ((uint32_t)ts->tv_nsec + NSEC_PER_TICK - 1) / NSEC_PER_TICK;
+    return secs_frac_to_ticks(ts->tv_sec, frac, ticks);
+}
+
+void itimer_ticks_to_timeval(uint32_t ticks, k_timeval_t *tv) {
+    tv->tv_sec = (int32_t)(ticks / TICKS_PER_SEC);
+    tv->tv_usec = (int32_t)((ticks % TICKS_PER_SEC) * USEC_PER_TICK);
+}
+
+void itimer_ticks_to_timespec(uint32_t ticks, k_timespec_t *ts) {
+    ts->tv_sec = (int32_t)(ticks / TICKS_PER_SEC);
+    ts->tv_nsec = (int32_t)((ticks % TICKS_PER_SEC) * NSEC_PER_TICK);
+}
+
+// tv must already be validated
+static uint64_t timeval_to_ns(const k_timeval_t *tv) {
+    return (uint64_t)(uint32_t)tv->tv_sec * NSEC_PER_SEC +
+           (uint32_t)tv->tv_usec * NSEC_PER_USEC;
+}
+
+static void ns_to_timeval(uint64_t ns, k_timeval_t *tv) {
+    uint32_t rem;
+    uint64_t sec = div_u64_rem(ns, NSEC_PER_SEC, &rem);
+    tv->tv_sec = sec > (uint64_t)INT32_MAX ? INT32_MAX : (int32_t)sec;
+    // Round up so a running timer never reads as disarmed
+    tv->tv_usec = (int32_t)((rem + NSEC_PER_USEC - 1) / NSEC_PER_USEC);
+    if (tv->tv_usec == 1000000) {
+        tv->tv_sec++;
+        tv->tv_usec = 0;
+    }
+}
+
+//============================================================================
+// Timer State
+//============================================================================
+
+static void itimer_real_expired(ktimer_t *timer) {
+    struct proc_timers *pt = (struct proc_timers *)timer->data;
+
+    uintptr_t flags = spinlock_acquire_irqsave(&pt->lock);
+    if (pt->real_interval) {
+        ktimer_arm(&pt->real, pt->real_interval);
+    }
+    spinlock_release_irqrestore(&pt->lock, flags);
+
+    signal_send_kernel(pt->owner, SIGALRM);
+}
+
+static struct proc_timers *proc_timers_get(pcb_t *proc, bool create) {
+    if (proc->timers || !create) return proc->timers;
+
+    struct proc_timers *pt = kmalloc(sizeof(*pt));
+    if (!pt) return NULL;
+    memset(pt, 0, sizeof(*pt));
+    spinlock_init(&pt->lock);
+    pt->owner = proc;
+    ktimer_init(&pt->real, itimer_real_expired, pt);
+    proc->timers = pt;
+    return pt;
+}
+
+void proc_timers_release(pcb_t *proc) {
+    if (!proc || !proc->timers) return;
+
+    struct proc_timers *pt = proc->timers;
+    ktimer_cancel(&pt->real);
+    for (int i = 0; i < PTIMER_MAX; i++) {
+        if (pt->posix[i]) {
+            ktimer_cancel(&pt->posix[i]->kt);
+            kfree(pt->posix[i]);
+        }
+    }
+    proc->timers = NULL;
+    kfree(pt);
+}
+
+//============================================================================
+// Interval Timers
+//============================================================================
+
+static void itimer_read_locked(struct proc_timers *pt, int which, k_itimerval_t *cur) {
+    switch (which) {
+        case ITIMER_REAL: {
+            uint32_t value = ktimer_remaining(&pt->real);
+            // Due but not yet run still counts as armed
+            if (pt->real.pending && value == 0) value = 1;
+            itimer_ticks_to_timeval(value, &cur->it_value);
+            itimer_ticks_to_timeval(pt->real_interval, &cur->it_interval);
+            break;
+        }
+        case ITIMER_VIRTUAL:
+            ns_to_timeval(pt->virt_value, &cur->it_value);
+            ns_to_timeval(pt->virt_interval, &cur->it_interval);
+            break;
+        case ITIMER_PROF:
+            ns_to_timeval(pt->prof_value, &cur->it_value);
+            ns_to_timeval(pt->prof_interval, &cur->it_interval);
+            break;
+    }
+}
+
+int itimer_get(pcb_t *proc, int which, k_itimerval_t *cur) {
+    if (!proc || !cur) return -EINVAL;
+    if (which < ITIMER_REAL || which > ITIMER_PROF) return -EINVAL;
+
+    struct proc_timers *pt = proc_timers_get(proc, false);
+    if (!pt) {
+        memset(cur, 0, sizeof(*cur));
+        return 0;
+    }
+
+    uintptr_t flags = spinlock_acquire_irqsave(&pt->lock);
+    itimer_read_locked(pt, which, cur);
+    spinlock_release_irqrestore(&pt->lock, flags);
+    return 0;
+}
+
+int itimer_set(pcb_t *proc, int which, const k_itimerval_t *val, k_itimerval_t *old) {
+    if (!proc || !val) return -EINVAL;
+    if (which < ITIMER_REAL || which > ITIMER_PROF) return -EINVAL;
+
+    uint32_t value, interval;
+    if (itimer_timeval_to_ticks(&val->it_value, &value) < 0 ||
+        itimer_timeval_to_ticks(&val->it_interval, &interval) < 0) {
+        return -EINVAL;
+    }
+
+    // Disarming a timer that was never set needs no state
+    struct proc_timers *pt = proc_timers_get(proc, value != 0);
+    if (!pt) {
+        if (value != 0) return -ENOMEM;
+        if (old) memset(old, 0, sizeof(*old));
+        return 0;
+    }
+
+    uintptr_t flags = spinlock_acquire_irqsave(&pt->lock);
+    if (old) {
+        itimer_read_locked(pt, which, old);
+    }
+    switch (which) {
+        case ITIMER_REAL:
+            pt->real_interval = value ? interval : 0;
+            if (value) {
+                ktimer_arm(&pt->real, value);
+            } else {
+                ktimer_cancel(&pt->real);
+            }
+            break;
+        case ITIMER_VIRTUAL:
+            pt->virt_value = timeval_to_ns(&val->it_value);
+            pt->virt_interval = value ? timeval_to_ns(&val->it_interval) : 0;
+            break;
+        case ITIMER_PROF:
+            pt->prof_value = timeval_to_ns(&val->it_value);
+            pt->prof_interval = value ? timeval_to_ns(&val->it_interval) : 0;
+            break;
+    }
+    if (which != ITIMER_REAL) {
+        // CPU time used before arming does not count
+        cputime_task_read(proc->tcb, &pt->last_utime, &pt->last_stime);
+    }
+    spinlock_release_irqrestore(&pt->lock, flags);
+    return 0;
+}
+
+uint32_t itimer_alarm(pcb_t *proc, uint32_t seconds) {
+    k_itimerval_t val, old;
+    memset(&val, 0, sizeof(val));
+    if (seconds > (uint32_t)INT32_MAX) seconds = INT32_MAX;
+    val.it_value.tv_sec = (int32_t)seconds;
+
+    if (itimer_set(proc, ITIMER_REAL, &val, &old) < 0) return 0;
+
+    // Report a pending sub-second alarm as 1 rather than 0 (0 = none)
+    uint32_t left = (uint32_t)old.it_value.tv_sec;
+    if (old.it_value.tv_usec > 0) left++;
+    return left;
+}
+
+// Charges delta ns to a CPU timer; returns true when it expires. The
+// overshoot is carried into the next period so the average rate holds.
+static bool itimer_cpu_charge(uint64_t *value, uint64_t interval, uint64_t delta) {
+    if (*value == 0) return false;
+    if (delta < *value) {
+        *value -= delta;
+        return false;
+    }
+    uint64_t over = delta - *value;
+    *value = (interval > over) ? interval - over : interval;
+    return true;
+}
+
+void itimer_account_cputime(pcb_t *proc) {
+    struct proc_timers *pt = proc ? proc->timers : NULL;
+    if (!pt || !proc->tcb) return;
+
+    uint64_t utime, stime;
+    cputime_task_read(proc->tcb, &utime, &stime);
+
+    bool virt_fired, prof_fired;
+    uintptr_t flags = spinlock_acquire_irqsave(&pt->lock);
+    uint64_t du = utime - pt->last_utime;
+    uint64_t ds = stime - pt->last_stime;
+    pt->last_utime = utime;
+    pt->last_stime = stime;
+    virt_fired = itimer_cpu_charge(&pt->virt_value, pt->virt_interval, du);
+    prof_fired = itimer_cpu_charge(&pt->prof_value, pt->prof_interval, du + ds);
+    spinlock_release_irqrestore(&pt->lock, flags);
+
+    if (virt_fired) signal_send_kernel(proc, SIGVTALRM);
+    if (prof_fired) signal_send_kernel(proc, SIGPROF);
+}
+
+//============================================================================
+// POSIX Timers
+//============================================================================
+
+static void ptimer_expired(ktimer_t *timer) {
+    ptimer_t *t = (ptimer_t *)timer->data;
+
+    if (t->interval) {
+        ktimer_arm(&t->kt, t->interval);
+    }
+    if (t->notify != SIGEV_SIGNAL) return;
+
+    // One queued signal per timer: later expiries are counted as overruns
+    if (signal_is_pending(t->owner, t->signo)) {
+        t->overrun++;
+        return;
+    }
+    t->overrun_last = t->overrun;
+    t->overrun = 0;
+    signal_send_kernel(t->owner, t->signo);
+}
+
+static ptimer_t *ptimer_lookup(pcb_t *proc, int id) {
+    if (!proc || !proc->timers || id < 0 || id >= PTIMER_MAX) return NULL;
+    return proc->timers->posix[id];
+}
+
+int ptimer_create(pcb_t *proc, int clockid, int notify, int signo, int *id_out) {
+    if (!proc || !id_out) return -EINVAL;
+    if (clockid != CLOCK_REALTIME && clockid != CLOCK_MONOTONIC) return -EINVAL;
+    if (notify != SIGEV_SIGNAL && notify != SIGEV_NONE) return -EINVAL;
+    if (notify == SIGEV_SIGNAL && (signo <= 0 || signo >= SIGNAL_MAX)) return -EINVAL;
+
+    struct proc_timers *pt = proc_timers_get(proc, true);
+    if (!pt) return -ENOMEM;
+
+    int id = -1;
+    for (int i = 0; i < PTIMER_MAX; i++) {
+        if (!pt->posix[i]) { id = i; break; }
+    }
+    if (id < 0) return -EAGAIN;
+
+    ptimer_t *t = kmalloc(sizeof(*t));
+    if (!t) return -ENOMEM;
+    memset(t, 0, sizeof(*t));
+    ktimer_init(&t->kt, ptimer_expired, t);
+    t->owner = proc;
+    t->clockid = clockid;
+    t->notify = notify;
+    t->signo = signo;
+
+    pt->posix[id] = t;
+    *id_out = id;
+    return 0;
+}
+
+static void ptimer_read(const ptimer_t *t, k_itimerspec_t *cur) {
+    uint32_t value = ktimer_remaining(&t->kt);
+    if (t->kt.pending && value == 0) value = 1;
+    itimer_ticks_to_timespec(value, &cur->it_value);
+    itimer_ticks_to_timespec(t->interval, &cur->it_interval);
+}
+
+int ptimer_settime(pcb_t *proc, int id, int flags, const k_itimerspec_t *val,
+                   k_itimerspec_t *old) {
+    ptimer_t *t = ptimer_lookup(proc, id);
+    if (!t || !val) return -EINVAL;
+
+    uint32_t value, interval;
+    if (itimer_timespec_to_ticks(&val->it_value, &value) < 0 ||
+        itimer_timespec_to_ticks(&val->it_interval, &interval) < 0) {
+        return -EINVAL;
+    }
+
+    uintptr_t irq = local_irq_save();
+    if (old) {
+        ptimer_read(t, old);
+    }
+    ktimer_cancel(&t->kt);
+    t->interval = value ? interval : 0;
+    t->overrun = 0;
+    if (value) {
+        if (flags & TIMER_ABSTIME) {
+            // Both clocks are ticks since boot; a past time fires next tick
+            uint32_t now = ktimer_now();
+            ktimer_arm_at(&t->kt, (int32_t)(value - now) > 0 ? value : now);
+        } else {
+            ktimer_arm(&t->kt, value);
+        }
+    }
+    local_irq_restore(irq);
+    return 0;
+}
+
+int ptimer_gettime(pcb_t *proc, int id, k_itimerspec_t *cur) {
+    ptimer_t *t = ptimer_lookup(proc, id);
+    if (!t || !cur) return -EINVAL;
+
+    uintptr_t irq = local_irq_save();
+    ptimer_read(t, cur);
+    local_irq_restore(irq);
+    return 0;
+}
+
+int ptimer_getoverrun(pcb_t *proc, int id) {
+    ptimer_t *t = ptimer_lookup(proc, id);
+    if (!t) return -EINVAL;
+    return (int)(t->overrun_last > (uint32_t)INT32_MAX ? INT32_MAX : t->overrun_last);
+}
+
+int ptimer_delete(pcb_t *proc, int id) {
+    ptimer_t *t = ptimer_lookup(proc, id);
+    if (!t) return -EINVAL;
+
+    // Expiry callbacks run with interrupts off, so none is mid-flight here
+    uintptr_t irq = local_irq_save();
+    ktimer_cancel(&t->kt);
+    proc->timers->posix[id] = NULL;
+    local_irq_restore(irq);
+
+    kfree(t);
+    return 0;
+}
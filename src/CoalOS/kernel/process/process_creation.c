@@ -12,13 +12,16 @@
 #include <kernel/memory/kmalloc.h>
 #include <kernel/memory/paging.h>
 #include <kernel/memory/frame.h>
+#include <kernel/memory/paging_process.h>
 #include <kernel/drivers/display/terminal.h>
 #include <kernel/core/types.h>
 #include <kernel/lib/string.h>
 #include <kernel/process/scheduler.h>
+#include <kernel/process/itimer.h>
 #include <kernel/fs/vfs/read_file.h>
 #include <kernel/memory/kmalloc_internal.h>
 #include <kernel/process/elf.h>
+#include <kernel/process/elf_loader.h>
 #include <libc/stddef.h>
 #include <kernel/lib/assert.h>
 #include <kernel/cpu/gdt.h>
@@ -31,7 +34,7 @@
 
 // Define USER_SPACE_START_VIRT if not defined elsewhere (e.g., paging.h)
 #ifndef USER_SPACE_START_VIRT
-#define USER_SPACE_START_VIRT 0x00001000
+#define USER_SPACE_START_VIRT 0x00400000
 #endif
 
 #ifndef KERNEL_VIRT_BASE
@@ -63,7 +66,6 @@ extern bool g_nx_supported;
 extern uint32_t *g_kernel_page_directory_virt; // Add this missing declaration
 
 // Forward declarations
-extern int load_elf_and_init_memory(const char *path, mm_struct_t *mm, uint32_t *entry_point, uintptr_t *initial_brk);
 extern void copy_kernel_pde_entries(uint32_t *new_pd_virt);
 extern void check_idle_task_stack_integrity(const char *checkpoint);
 
@@ -73,6 +75,37 @@ extern void free_kernel_stack(pcb_t *proc);
 extern void process_init_fds(pcb_t *proc);
 extern void process_close_fds(pcb_t *proc);
 
+/**
+ * @brief Writes the SysV i386 initial process stack into the top stack page
+ *
+ * Layout from the returned ESP upwards: argc (0), the NULL-terminated argv
+ * and envp arrays, then the auxiliary vector ld.so and crt0 read to find the
+ * program headers and entry point.
+ *
+ * @param page_virt Kernel mapping of the page at USER_STACK_TOP - PAGE_SIZE
+ * @param info      Values from the ELF loader
+ * @return User virtual address of the initial stack pointer
+ */
+static uintptr_t setup_initial_user_stack(void *page_virt, const elf_load_info_t *info)
+{
+    const uint32_t words[] = {
+        0,                      // argc
+        0,                      // argv[0] = NULL
+        0,                      // envp[0] = NULL
+        AT_PHDR,   info->phdr,
+        AT_PHENT,  info->phent,
+        AT_PHNUM,  info->phnum,
+        AT_PAGESZ, PAGE_SIZE,
+        AT_BASE,   info->interp_base,
+        AT_ENTRY,  info->prog_entry,
+        AT_NULL,   0,
+    };
+    // Keep ESP 16-byte aligned at entry, as the i386 psABI expects
+    size_t size = (sizeof(words) + 15u) & ~15u;
+    memcpy((uint8_t *)page_virt + PAGE_SIZE - size, words, sizeof(words));
+    return USER_STACK_TOP_VIRT_ADDR - size;
+}
+
 /**
  * @brief Prepares the kernel stack of a newly created process for the initial
  * transition to user mode via the IRET instruction.
@@ -158,8 +191,7 @@ pcb_t *create_user_process(const char *path)
     int ret_status = 0;
 
     // Declare local variables needed for ELF loading and verification
-    uint32_t entry_point = 0;
-    uintptr_t initial_brk = 0;
+    elf_load_info_t load_info;
     bool mapping_error = false;
 
     // --- Step 1: Allocate PCB ---
@@ -176,6 +208,9 @@ pcb_t *create_user_process(const char *path)
     proc->pid = temp_next_pid++;
     PROC_DEBUG_PRINTF("PCB allocated at %p, PID=%lu\n", proc, (unsigned long)proc->pid);
 
+    const char *base = strrchr(path, '/');
+    strncpy(proc->comm, base ? base + 1 : path, sizeof(proc->comm) - 1);
+
     // === Step 1.5: Initialize File Descriptors and Lock ===
     process_init_fds(proc);
 
@@ -239,14 +274,14 @@ pcb_t *create_user_process(const char *path)
 
     // --- Step 6: Load ELF executable ---
     PROC_DEBUG_PRINTF("Step 6: Load ELF '%s'\n", path);
-    int load_res = load_elf_and_init_memory(path, proc->mm, &entry_point, &initial_brk);
+    int load_res = load_elf_program(path, proc->mm, &load_info);
      if (load_res != 0) {
          serial_printf("[Process] ERROR: Failed to load ELF '%s' (Error code %d).\n", path, load_res);
          ret_status = load_res;
          goto fail_create;
      }
-     proc->entry_point = entry_point;
-     if (proc->mm) { proc->mm->start_brk = proc->mm->end_brk = initial_brk; }
+     proc->entry_point = load_info.entry;
+     if (proc->mm) { proc->mm->start_brk = proc->mm->end_brk = load_info.brk; }
      else { ret_status = -EINVAL; goto fail_create; }
 
     // --- Step 7: Setup standard VMAs ---
@@ -277,7 +312,11 @@ pcb_t *create_user_process(const char *path)
                     (unsigned long)initial_stack_phys_frame, (void*)initial_user_stack_page_vaddr, proc->user_stack_top);
     
     void* temp_stack_map = paging_temp_map(initial_stack_phys_frame);
-     if (temp_stack_map) { memset(temp_stack_map, 0, PAGE_SIZE); paging_temp_unmap(temp_stack_map); }
+     if (!temp_stack_map) { ret_status = -EIO; goto fail_create; }
+     memset(temp_stack_map, 0, PAGE_SIZE);
+     proc->user_stack_top = (void*)setup_initial_user_stack(temp_stack_map, &load_info);
+     paging_temp_unmap(temp_stack_map);
+     proc->mm->start_stack = (uintptr_t)proc->user_stack_top;
 
     // --- Step 8.5: Verify EIP/ESP Mappings ---
     PROC_DEBUG_PRINTF("  Verifying EIP and ESP mappings/flags in Proc PD P=%#lx...\n", (unsigned long)proc->page_directory_phys);
@@ -363,6 +402,9 @@ fail_create:
       PROC_DEBUG_PRINTF("Enter PID=%lu\n", (unsigned long)pid);
       serial_printf("[Process] Destroying process PID %lu.\n", (unsigned long)pid);
 
+      // 0. Stop timers before anything they signal goes away
+      proc_timers_release(pcb);
+
       // 1. Close All Open File Descriptors
       serial_write("[destroy_process] Step 1: Closing FDs...\n");
       check_idle_task_stack_integrity("destroy_process: Before close_fds");
@@ -370,9 +412,14 @@ fail_create:
       check_idle_task_stack_integrity("destroy_process: After close_fds");
       serial_write("[destroy_process] Step 1: FDs closed.\n");
 
-      // 2. Destroy Memory Management structure
+      // 2. Release user frames and page tables in bulk, then the VMAs. With
+      //    the page tables already gone, destroy_mm only frees VMA nodes.
       serial_write("[destroy_process] Step 2: Destroying MM (user space memory)...\n");
       check_idle_task_stack_integrity("destroy_process: Before destroy_mm");
+      if (pcb->page_directory_phys &&
+          pcb->page_directory_phys != (uint32_t*)g_kernel_page_directory_phys) {
+          paging_free_user_space(pcb->page_directory_phys);
+      }
       if (pcb->mm) {
           PROC_DEBUG_PRINTF("  Destroying mm_struct %p...\n", pcb->mm);
           destroy_mm(pcb->mm);
@@ -161,6 +161,10 @@ int process_reap_child(pcb_t *parent, int child_pid, int *status) {
     }
     
     uint32_t reaped_pid = child_to_reap->pid;
+
+    // The child's own and inherited CPU time now count as the parent's
+    parent->cutime_ns += child_to_reap->utime_ns + child_to_reap->cutime_ns;
+    parent->cstime_ns += child_to_reap->stime_ns + child_to_reap->cstime_ns;
     
     // Remove from children list
     if (parent->children == child_to_reap) {
@@ -25,7 +25,7 @@
 
 // Memory layout constants
 #ifndef USER_SPACE_START_VIRT
-#define USER_SPACE_START_VIRT 0x00001000
+#define USER_SPACE_START_VIRT 0x00400000
 #endif
 
 #ifndef KERNEL_VIRT_BASE
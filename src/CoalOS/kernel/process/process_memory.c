@@ -14,6 +14,7 @@
 #include <kernel/lib/string.h>
 #include <kernel/lib/assert.h>
 #include <kernel/cpu/tss.h>
+#include <kernel/sync/spinlock.h>
 
 // Constants for kernel stack management
 #ifndef KERNEL_STACK_VIRT_START
@@ -28,6 +29,52 @@
 static uintptr_t g_next_kernel_stack_virt_base = KERNEL_STACK_VIRT_START;
 // TODO: Replace with a proper kernel virtual address space allocator (e.g., using VMAs)
 
+// Kernel stacks of exited processes are kept mapped and reused whole, which
+// skips the frame allocation, mapping and VA bump on the next process
+// creation, and stops exited processes from leaking stack VA.
+#define KSTACK_CACHE_SIZE 8
+
+typedef struct {
+    uint32_t *vaddr_top;   // Usable stack top (TSS esp0 value)
+    uint32_t  phys_base;   // First frame, as recorded in the PCB
+} kstack_cache_entry_t;
+
+static kstack_cache_entry_t g_kstack_cache[KSTACK_CACHE_SIZE];
+static size_t g_kstack_cache_count = 0;
+static spinlock_t g_kstack_cache_lock = {0};
+
+static bool kstack_cache_get(pcb_t *proc)
+{
+    bool hit = false;
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&g_kstack_cache_lock);
+    if (g_kstack_cache_count > 0) {
+        kstack_cache_entry_t *entry = &g_kstack_cache[--g_kstack_cache_count];
+        proc->kernel_stack_vaddr_top = entry->vaddr_top;
+        proc->kernel_stack_phys_base = entry->phys_base;
+        hit = true;
+    }
+    spinlock_release_irqrestore(&g_kstack_cache_lock, irq_flags);
+
+    if (hit) {
+        tss_set_kernel_stack((uint32_t)proc->kernel_stack_vaddr_top);
+    }
+    return hit;
+}
+
+static bool kstack_cache_put(pcb_t *proc)
+{
+    bool stored = false;
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&g_kstack_cache_lock);
+    if (g_kstack_cache_count < KSTACK_CACHE_SIZE) {
+        kstack_cache_entry_t *entry = &g_kstack_cache[g_kstack_cache_count++];
+        entry->vaddr_top = proc->kernel_stack_vaddr_top;
+        entry->phys_base = proc->kernel_stack_phys_base;
+        stored = true;
+    }
+    spinlock_release_irqrestore(&g_kstack_cache_lock, irq_flags);
+    return stored;
+}
+
 // External globals
 extern uint32_t g_kernel_page_directory_phys;
 extern bool g_nx_supported;
@@ -42,6 +89,10 @@ bool allocate_kernel_stack(pcb_t *proc)
 {
     KERNEL_ASSERT(proc != NULL, "allocate_kernel_stack: NULL proc");
 
+    if (kstack_cache_get(proc)) {
+        return true;
+    }
+
     size_t usable_stack_size = PROCESS_KSTACK_SIZE; // Defined in process.h (e.g., 16384)
     if (usable_stack_size == 0 || (usable_stack_size % PAGE_SIZE) != 0) {
        serial_printf("[Process] ERROR: Invalid PROCESS_KSTACK_SIZE (%lu).\n", (unsigned long)usable_stack_size);
@@ -186,6 +237,13 @@ void free_kernel_stack(pcb_t *proc)
         return;
     }
 
+    // Keep the stack mapped for the next process if the cache has room
+    if (kstack_cache_put(proc)) {
+        proc->kernel_stack_vaddr_top = NULL;
+        proc->kernel_stack_phys_base = 0;
+        return;
+    }
+
     // kernel_stack_vaddr_top points to the end of the *usable* stack (e.g., 0xe0004000)
     uintptr_t stack_top_usable = (uintptr_t)proc->kernel_stack_vaddr_top;
     size_t usable_stack_size = PROCESS_KSTACK_SIZE;
@@ -250,6 +308,10 @@ error_t allocate_kernel_stack_safe(pcb_t *proc) {
         return E_INVAL;
     }
 
+    if (kstack_cache_get(proc)) {
+        return E_SUCCESS;
+    }
+
     // Calculate page requirements
     size_t num_usable_pages = usable_stack_size / PAGE_SIZE;
     size_t num_pages_with_guard = num_usable_pages + 1; // Include guard page
@@ -45,6 +45,7 @@ pcb_t* process_create(const char* name) {
     memset(proc, 0, sizeof(pcb_t));
     proc->pid = next_pid++;
     proc->state = PROC_INITIALIZING;
+    strncpy(proc->comm, name, sizeof(proc->comm) - 1);
     
     // Initialize spinlock
     spinlock_init(&proc->fd_table_lock);
@@ -122,6 +123,7 @@ error_t process_create_safe(const char* name, pcb_t** proc_out) {
     memset(proc, 0, sizeof(pcb_t));
     proc->pid = next_pid++;
     proc->state = PROC_INITIALIZING;
+    strncpy(proc->comm, name, sizeof(proc->comm) - 1);
     
     // Initialize synchronization primitives
     spinlock_init(&proc->fd_table_lock);
@@ -5,8 +5,8 @@
  * @version 6.0
  * 
  * @details Handles cleanup of terminated processes, resource deallocation,
- * and zombie process reaping. Focuses purely on cleanup operations
- * without affecting core scheduling logic.
+ * and zombie process reaping. Exiting tasks only queue themselves; the
+ * teardown runs later in a low-priority reaper task, off the exit path.
  */
 
 //============================================================================
@@ -16,7 +16,10 @@
 #include <kernel/process/scheduler_queues.h>
 #include <kernel/process/scheduler_context.h>
 #include <kernel/process/process_manager.h>
+#include <kernel/process/exit_to_user.h>
 #include <kernel/memory/kmalloc.h>
+#include <kernel/sync/spinlock.h>
+#include <kernel/cpu/get_cpu_id.h>
 #include <kernel/drivers/display/serial.h>
 #include <kernel/lib/assert.h>
 #include <libc/stdint.h>
@@ -34,76 +37,133 @@
 #define SCHED_WARN(fmt, ...)  serial_printf("[Cleanup WARN ] %s:%d: " fmt "\n", __func__, __LINE__, ##__VA_ARGS__)
 #define SCHED_TRACE(fmt, ...) ((void)0)
 
+//============================================================================
+// Deferred Teardown State
+//============================================================================
+
+// Exiting tasks are pushed here by scheduler_core_remove_current_task() and
+// torn down later by the reaper task. Lists are per CPU so a task is only
+// ever reaped on the CPU it died on, after that CPU has switched off its
+// kernel stack. All access is with interrupts disabled.
+static tcb_t *g_deferred_free[MAX_CPUS];
+static tcb_t *g_reaper_task[MAX_CPUS];
+
+static int cleanup_cpu(void) {
+    int cpu = get_cpu_id();
+    return (cpu >= 0 && cpu < MAX_CPUS) ? cpu : 0;
+}
+
 //============================================================================
 // Zombie Cleanup Implementation
 //============================================================================
 
-void scheduler_cleanup_zombies(void) {
-    SCHED_TRACE("Checking for ZOMBIE tasks...");
-    
-    tcb_t *zombie_to_reap = scheduler_queues_remove_zombie_task();
-    
-    if (zombie_to_reap) {
-        SCHED_INFO("Cleanup: Reaping ZOMBIE task PID %lu (Exit Code: %lu).", 
-                   zombie_to_reap->pid, zombie_to_reap->exit_code);
-        
-        // Check idle task stack before destroying process
-        scheduler_context_check_idle_integrity("Before destroy_process");
-        
-        if (zombie_to_reap->process) {
-            serial_printf("[destroy_process] Enter for PID %lu\n", zombie_to_reap->pid);
-            destroy_process(zombie_to_reap->process);
-            serial_printf("[destroy_process] Exit for PID %lu\n", zombie_to_reap->pid);
-        } else {
-            SCHED_WARN("Zombie task PID %lu has NULL process pointer!", zombie_to_reap->pid);
+static void reap_task(tcb_t *zombie) {
+    SCHED_DEBUG("Reaping ZOMBIE task PID %lu (Exit Code: %lu).",
+                zombie->pid, zombie->exit_code);
+
+    scheduler_queues_remove_from_all_tasks(zombie);
+
+    pcb_t *proc = zombie->process;
+    if (!proc) {
+        SCHED_WARN("Zombie task PID %lu has NULL process pointer!", zombie->pid);
+        scheduler_cleanup_increment_stats(false);
+    } else if (proc->is_kernel_task) {
+        // Kernel tasks share the kernel page directory; only the stack and
+        // PCB kmalloc'd by scheduler_create_kernel_task() are theirs
+        if (proc->kernel_stack_vaddr_top) {
+            kfree((void *)((uintptr_t)proc->kernel_stack_vaddr_top - PROCESS_KSTACK_SIZE));
         }
-        
-        // Check idle task stack after destroying process
-        scheduler_context_check_idle_integrity("After destroy_process");
-        
-        // Free the TCB
-        kfree(zombie_to_reap);
-        
-        // Check idle task stack after freeing TCB
-        scheduler_context_check_idle_integrity("After kfree(tcb)");
-        
-        SCHED_DEBUG("Successfully reaped zombie task PID %lu", zombie_to_reap->pid);
+        kfree(proc);
+        scheduler_cleanup_increment_stats(true);
+    } else {
+        destroy_process(proc);
+        scheduler_cleanup_increment_stats(true);
     }
+
+    // After destroy_process(): closing the last fds may cancel exit works
+    task_work_exit(zombie);
+    kfree(zombie);
 }
 
-void scheduler_cleanup_all_zombies(void) {
-    int cleanup_count = 0;
-    const int max_cleanup_per_call = 10; // Prevent infinite loops
-    
-    SCHED_DEBUG("Starting comprehensive zombie cleanup");
-    
-    while (cleanup_count < max_cleanup_per_call) {
-        tcb_t *zombie_to_reap = scheduler_queues_remove_zombie_task();
-        
-        if (!zombie_to_reap) {
-            break; // No more zombies
+// Detaches this CPU's whole deferred list
+static tcb_t *take_deferred_list(void) {
+    uintptr_t irq_flags = local_irq_save();
+    int cpu = cleanup_cpu();
+    tcb_t *list = g_deferred_free[cpu];
+    g_deferred_free[cpu] = NULL;
+    local_irq_restore(irq_flags);
+    return list;
+}
+
+static int reap_list(tcb_t *list) {
+    int reaped = 0;
+    while (list) {
+        tcb_t *next = list->reap_next;
+        reap_task(list);
+        list = next;
+        reaped++;
+    }
+    return reaped;
+}
+
+void scheduler_cleanup_defer_task(tcb_t *task) {
+    KERNEL_ASSERT(task && task->state == TASK_ZOMBIE, "Only ZOMBIE tasks can be deferred");
+
+    uintptr_t irq_flags = local_irq_save();
+    int cpu = cleanup_cpu();
+    task->reap_next = g_deferred_free[cpu];
+    g_deferred_free[cpu] = task;
+
+    tcb_t *reaper = g_reaper_task[cpu];
+    if (reaper && reaper->state == TASK_BLOCKED) {
+        scheduler_unblock_task(reaper);
+    }
+    local_irq_restore(irq_flags);
+}
+
+static __attribute__((noreturn)) void reaper_task_loop(void) {
+    int cpu = cleanup_cpu();
+    tcb_t *self = get_current_task();
+    g_reaper_task[cpu] = self;
+
+    SCHED_INFO("Reaper task started on CPU %d (PID %lu).", cpu, self ? self->pid : 0);
+
+    for (;;) {
+        tcb_t *batch = take_deferred_list();
+        if (batch) {
+            reap_list(batch);
+            continue;
         }
-        
-        SCHED_INFO("Bulk cleanup: Reaping ZOMBIE task PID %lu (Exit Code: %lu).", 
-                   zombie_to_reap->pid, zombie_to_reap->exit_code);
-        
-        if (zombie_to_reap->process) {
-            destroy_process(zombie_to_reap->process);
+
+        // Sleep until scheduler_cleanup_defer_task() queues more work
+        uintptr_t irq_flags = local_irq_save();
+        if (!g_deferred_free[cpu]) {
+            self->state = TASK_BLOCKED;
+            schedule();
         }
-        
-        kfree(zombie_to_reap);
-        cleanup_count++;
+        local_irq_restore(irq_flags);
     }
+}
+
+void scheduler_cleanup_start_reaper(void) {
+    if (scheduler_create_kernel_task(reaper_task_loop, SCHED_IDLE_PRIORITY, "reaper") != 0) {
+        SCHED_ERROR("Failed to start reaper task; zombies will only be reaped on demand");
+    }
+}
+
+void scheduler_cleanup_zombies(void) {
+    SCHED_TRACE("Checking for ZOMBIE tasks...");
+    reap_list(take_deferred_list());
+}
+
+void scheduler_cleanup_all_zombies(void) {
+    int cleanup_count = reap_list(take_deferred_list());
     
     if (cleanup_count > 0) {
         SCHED_INFO("Bulk cleanup completed: reaped %d zombie tasks", cleanup_count);
     } else {
         SCHED_DEBUG("No zombie tasks found during bulk cleanup");
     }
-    
-    if (cleanup_count == max_cleanup_per_call) {
-        SCHED_WARN("Hit cleanup limit - more zombies may remain");
-    }
 }
 
 bool scheduler_cleanup_force_cleanup_task(uint32_t pid) {
@@ -112,34 +172,27 @@ bool scheduler_cleanup_force_cleanup_task(uint32_t pid) {
         return false;
     }
     
-    SCHED_DEBUG("Attempting forced cleanup of task PID %lu", pid);
-    
-    // This is a simplified implementation
-    // In a full implementation, we would search through all task lists
-    // and forcibly clean up the specified task
-    
-    tcb_t *zombie = scheduler_queues_remove_zombie_task();
-    while (zombie) {
-        if (zombie->pid == pid) {
-            SCHED_INFO("Force cleanup: Found and reaping task PID %lu", pid);
-            
-            if (zombie->process) {
-                destroy_process(zombie->process);
-            }
-            kfree(zombie);
-            
-            SCHED_DEBUG("Successfully force-cleaned task PID %lu", pid);
-            return true;
+    tcb_t *found = NULL;
+    uintptr_t irq_flags = local_irq_save();
+    tcb_t **link = &g_deferred_free[cleanup_cpu()];
+    while (*link) {
+        if ((*link)->pid == pid) {
+            found = *link;
+            *link = found->reap_next;
+            break;
         }
-        
-        // Put it back and continue searching
-        // Note: This is simplified - in reality we'd need a proper search
-        kfree(zombie);
-        zombie = scheduler_queues_remove_zombie_task();
+        link = &(*link)->reap_next;
     }
-    
-    SCHED_WARN("Force cleanup: Task PID %lu not found in zombie list", pid);
-    return false;
+    local_irq_restore(irq_flags);
+
+    if (!found) {
+        SCHED_WARN("Force cleanup: Task PID %lu not found in zombie list", pid);
+        return false;
+    }
+
+    SCHED_INFO("Force cleanup: Found and reaping task PID %lu", pid);
+    reap_task(found);
+    return true;
 }
 
 //============================================================================
@@ -163,7 +216,7 @@ void scheduler_cleanup_get_stats(uint32_t *total_reaped, uint32_t *last_reap_tic
 void scheduler_cleanup_increment_stats(bool success) {
     if (success) {
         g_cleanup_stats.total_reaped++;
-        // Would set last_reap_tick to current tick if we had access to scheduler_core_get_ticks()
+        g_cleanup_stats.last_reap_tick = scheduler_get_ticks();
     } else {
         g_cleanup_stats.reap_failures++;
     }
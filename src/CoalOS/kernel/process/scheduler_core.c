@@ -16,11 +16,18 @@
 #include <kernel/process/scheduler_queues.h>
 #include <kernel/process/scheduler_context.h>
 #include <kernel/process/scheduler_sleep.h>
+#include <kernel/process/scheduler_cleanup.h>
 #include <kernel/process/scheduler_optimization.h>
+#include <kernel/drivers/timer/ktimer.h>
+#include <kernel/process/cputime.h>
+#include <kernel/process/workqueue.h>
+#include <kernel/cpu/tsc.h>
+#include <kernel/sync/preempt.h>
 #include <kernel/memory/kmalloc.h>
 #include <kernel/drivers/display/serial.h>
 #include <kernel/lib/assert.h>
 #include <kernel/lib/string.h>
+#include <kernel/lib/tunables.h>
 #include <libc/stdint.h>
 #include <libc/stddef.h>
 #include <libc/stdbool.h>
@@ -37,10 +44,32 @@
 
 #define MS_TO_TICKS(ms) (((ms) * SCHED_TICKS_PER_SECOND) / 1000)
 
-static const uint32_t g_priority_time_slices_ms[SCHED_PRIORITY_LEVELS] = {
+// Quantum per priority level; sched.timeslice_p<N>_ms. A change applies from
+// each task's next slice. The tick rate itself stays fixed: timers, cputime
+// and the load average are derived from it.
+static uint32_t g_priority_time_slices_ms[SCHED_PRIORITY_LEVELS] = {
     200, /* P0 */ 100, /* P1 */ 50, /* P2 */ 25  /* P3 (Idle) */
 };
 
+#define SCHED_TIMESLICE_MAX_MS  1000
+
+#define SCHED_TIMESLICE_TUNABLE(prio) {                         \
+    .name = "sched.timeslice_p" #prio "_ms",                    \
+    .desc = "Time slice of priority " #prio " tasks, in ms",    \
+    .type = TUNABLE_U32,                                        \
+    .value = &g_priority_time_slices_ms[prio],                  \
+    .min = 1,                                                   \
+    .max = SCHED_TIMESLICE_MAX_MS,                              \
+}
+
+static tunable_t g_time_slice_tunables[SCHED_PRIORITY_LEVELS] = {
+    SCHED_TIMESLICE_TUNABLE(0),
+    SCHED_TIMESLICE_TUNABLE(1),
+    SCHED_TIMESLICE_TUNABLE(2),
+    SCHED_TIMESLICE_TUNABLE(3),
+};
+_Static_assert(SCHED_PRIORITY_LEVELS == 4, "one time slice tunable per priority level");
+
 // Logging Macros
 #define SCHED_INFO(fmt, ...)  serial_printf("[Sched INFO ] " fmt "\n", ##__VA_ARGS__)
 #define SCHED_DEBUG(fmt, ...) serial_printf("[Sched DEBUG] " fmt "\n", ##__VA_ARGS__)
@@ -52,13 +81,22 @@ static const uint32_t g_priority_time_slices_ms[SCHED_PRIORITY_LEVELS] = {
 //============================================================================
 static volatile tcb_t *g_current_task = NULL;
 static volatile uint32_t g_tick_count = 0;
+static uint32_t g_load_sample_tick = 0;
 volatile bool g_scheduler_ready = false;
-volatile bool g_need_reschedule = false;
+
+// Per-CPU preemption count (single CPU); handed over per task in schedule()
+volatile uint32_t g_preempt_count = 0;
 
 //============================================================================
 // Core Scheduling Functions
 //============================================================================
 
+void scheduler_core_init(void) {
+    for (int prio = 0; prio < SCHED_PRIORITY_LEVELS; ++prio) {
+        tunable_register(&g_time_slice_tunables[prio]);
+    }
+}
+
 tcb_t* scheduler_select_next_task(void) {
 #ifdef USE_SCHEDULER_OPTIMIZATION
     // Use O(1) optimized task selection
@@ -115,6 +153,14 @@ void schedule(void) {
     asm volatile("pushf; pop %0; cli" : "=r"(eflags));
 
     tcb_t *old_task = (tcb_t *)g_current_task;
+    if (old_task) {
+        clear_tsk_thread_flag(old_task, TIF_NEED_RESCHED);
+        // A worker blocking inside a work item hands its pool to an idle worker
+        if (old_task->wq_worker &&
+            (old_task->state == TASK_BLOCKED || old_task->state == TASK_SLEEPING)) {
+            wq_worker_sleeping(old_task);
+        }
+    }
     tcb_t *new_task = scheduler_select_next_task();
     
     // If no tasks available, handle idle mode
@@ -122,6 +168,7 @@ void schedule(void) {
         SCHED_INFO("No runnable tasks. Entering idle mode.");
         scheduler_context_enter_idle_mode();
         // This should not return unless resuming from idle
+        if (old_task && old_task->wq_worker) wq_worker_running(old_task);
         if (eflags & 0x200) asm volatile("sti");
         return;
     }
@@ -131,6 +178,7 @@ void schedule(void) {
         if (old_task && old_task->state == TASK_READY) {
             old_task->state = TASK_RUNNING;
         }
+        if (old_task && old_task->wq_worker) wq_worker_running(old_task);
         if (eflags & 0x200) asm volatile("sti");
         return;
     }
@@ -147,34 +195,51 @@ void schedule(void) {
         }
     }
 
-    // Update current task and perform context switch
+    // Update current task and perform context switch. The preempt count
+    // belongs to the task: park ours and install the incoming task's.
     g_current_task = new_task;
     new_task->state = TASK_RUNNING;
+    if (old_task) {
+        old_task->saved_preempt_count = g_preempt_count;
+    }
+    g_preempt_count = new_task->saved_preempt_count;
+    cputime_switch(old_task, new_task);
     
     scheduler_context_switch(old_task, new_task);
+
+    // Back on old_task's stack
+    if (old_task && old_task->wq_worker) wq_worker_running(old_task);
     
     if (eflags & 0x200) asm volatile("sti");
 }
 
 void scheduler_core_tick(void) {
     g_tick_count++;
+
+    // Runs until the TSC frequency is known
+    tsc_calibrate_tick(g_tick_count);
     
     if (!g_scheduler_ready) return;
 
+    // Sample the run queues for the load averages every LOAD_FREQ ticks
+    if (g_tick_count - g_load_sample_tick >= LOAD_FREQ) {
+        g_load_sample_tick = g_tick_count;
+        scheduler_opt_update_load_stats();
+    }
+
     // Check sleeping tasks
     scheduler_sleep_check_wakeups();
 
+    // Fire due kernel timers (alarms, POSIX timers, timerfds)
+    ktimer_run_expired(g_tick_count);
+
     volatile tcb_t *curr_task_v = g_current_task;
     if (!curr_task_v) return;
     
     tcb_t *curr_task = (tcb_t *)curr_task_v;
 
-    // Handle idle task specially
+    // The idle task is preempted on IRQ exit as soon as work is flagged
     if (curr_task->pid == IDLE_TASK_PID) {
-        if (g_need_reschedule) { 
-            g_need_reschedule = false; 
-            schedule(); 
-        }
         return;
     }
 
@@ -184,15 +249,10 @@ void scheduler_core_tick(void) {
         curr_task->ticks_remaining--;
     }
 
-    // Trigger reschedule if time slice expired
+    // Time slice expired: flag it, the IRQ exit path does the switch
     if (curr_task->ticks_remaining == 0) {
         SCHED_DEBUG("Timeslice expired for PID %lu", curr_task->pid);
-        g_need_reschedule = true;
-    }
-
-    if (g_need_reschedule) {
-        g_need_reschedule = false;
-        schedule();
+        set_tsk_thread_flag(curr_task, TIF_NEED_RESCHED);
     }
 }
 
@@ -209,6 +269,7 @@ int scheduler_core_add_task(pcb_t *pcb) {
     
     memset(new_task, 0, sizeof(tcb_t));
     new_task->process = pcb;
+    pcb->tcb = new_task;
     new_task->pid = pcb->pid;
     new_task->state = TASK_READY;
     new_task->in_run_queue = false;
@@ -261,9 +322,12 @@ void scheduler_core_remove_current_task(uint32_t code) {
 
     SCHED_INFO("Task PID %lu exiting with code %lu. Marking as ZOMBIE.", 
                task_to_terminate->pid, code);
+    cputime_task_exit(task_to_terminate);
     task_to_terminate->state = TASK_ZOMBIE;
     task_to_terminate->exit_code = code;
     task_to_terminate->in_run_queue = false;
+    // Teardown runs in the reaper once we are off this kernel stack
+    scheduler_cleanup_defer_task(task_to_terminate);
     schedule();
     KERNEL_PANIC_HALT("Returned from schedule() after terminating task!");
 }
@@ -283,7 +347,7 @@ void scheduler_core_unblock_task(tcb_t *task) {
         if (!scheduler_queues_enqueue_ready_task(task)) {
              SCHED_ERROR("Failed to enqueue unblocked task PID %lu", task->pid);
         } else {
-             g_need_reschedule = true;
+             set_need_resched();
              SCHED_DEBUG("Task PID %lu enqueued into run queue.", task->pid);
         }
     } else {
@@ -307,7 +371,25 @@ uint32_t scheduler_core_get_ticks(void) {
 }
 
 void scheduler_core_set_need_reschedule(void) {
-    g_need_reschedule = true;
+    set_need_resched();
+}
+
+void set_need_resched(void) {
+    tcb_t *curr = (tcb_t *)g_current_task;
+    if (curr) {
+        set_tsk_thread_flag(curr, TIF_NEED_RESCHED);
+    }
+}
+
+void preempt_check_resched(void) {
+    tcb_t *curr = (tcb_t *)g_current_task;
+    if (!g_scheduler_ready || !curr || !test_tsk_thread_flag(curr, TIF_NEED_RESCHED)) {
+        return;
+    }
+    if (!preemptible()) {
+        return;
+    }
+    schedule();
 }
 
 bool scheduler_core_is_ready(void) {
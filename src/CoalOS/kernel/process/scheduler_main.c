@@ -19,6 +19,7 @@
 #include <kernel/process/scheduler_sleep.h>
 #include <kernel/process/scheduler_cleanup.h>
 #include <kernel/process/scheduler_optimization.h>
+#include <kernel/process/workqueue.h>
 #include <kernel/drivers/display/terminal.h>
 #include <kernel/drivers/display/serial.h>
 #include <kernel/memory/kmalloc.h>
@@ -45,7 +46,14 @@ void scheduler_init(void) {
 #endif
     
     // Core scheduler initialization
+    scheduler_core_init();
     scheduler_core_set_ready(false);
+
+    // Shared worker pools for deferred work
+    workqueue_init();
+
+    // Deferred task teardown
+    scheduler_cleanup_start_reaper();
     
     terminal_printf("Modular scheduler initialized\n");
 }
@@ -220,9 +228,9 @@ int scheduler_create_kernel_task(void (*entry_point)(void), uint8_t priority, co
     pcb->entry_point = (uint32_t)entry_point;
     pcb->kernel_stack_vaddr_top = (void*)((uintptr_t)kernel_stack + PROCESS_KSTACK_SIZE);
     
-    // Set up initial context
-    uint32_t *stack_ptr = (uint32_t*)pcb->kernel_stack_vaddr_top;
-    --stack_ptr; *stack_ptr = (uint32_t)entry_point;
+    // Set up initial context in the layout simple_switch restores, so the
+    // first switch starts the task on its own stack
+    uint32_t *stack_ptr = setup_idle_context((uint32_t*)pcb->kernel_stack_vaddr_top, entry_point);
     
     pcb->user_stack_top = pcb->kernel_stack_vaddr_top;
     pcb->kernel_esp_for_switch = (uint32_t)stack_ptr;
@@ -233,7 +241,7 @@ int scheduler_create_kernel_task(void (*entry_point)(void), uint8_t priority, co
     tcb->pid = task_pid;
     tcb->state = TASK_READY;
     tcb->in_run_queue = false;
-    tcb->has_run = false;
+    tcb->has_run = true; // Context is already switchable
     tcb->priority = priority;
     tcb->base_priority = priority;
     tcb->effective_priority = priority;
@@ -118,31 +118,28 @@ tcb_t* scheduler_opt_select_next_task(void) {
 // Load Statistics
 //============================================================================
 
-void scheduler_opt_update_load_stats(void) {
-    // Count tasks in each state
-    uint32_t runnable = 0;
-    uint32_t blocked = 0;
-    uint32_t total = 0;
-    
-    // This would iterate through all tasks - simplified for now
-    for (int i = 0; i < SCHED_PRIORITY_LEVELS; i++) {
-        runnable += g_queue_counts[i];
+// load = load * exp + active * (1 - exp), rounded, in fixed point.
+// 32 bits are enough below ~1000 runnable tasks.
+static uint32_t calc_load(uint32_t load, uint32_t exp, uint32_t active) {
+    uint32_t newload = load * exp + active * (FIXED_1 - exp);
+    if (active >= load) {
+        newload += FIXED_1 - 1;
     }
+    return newload / FIXED_1;
+}
+
+void scheduler_opt_update_load_stats(void) {
+    uint32_t total, runnable, blocked;
+    scheduler_queues_count_tasks(&total, &runnable, &blocked);
     
     g_load_stats.runnable_tasks = runnable;
     g_load_stats.total_tasks = total;
     g_load_stats.blocked_tasks = blocked;
     
-    // Update load history
-    g_load_stats.load_history[g_load_stats.history_index] = runnable;
-    g_load_stats.history_index = (g_load_stats.history_index + 1) % SCHED_LOAD_HISTORY_SIZE;
-    
-    // Calculate average
-    uint32_t sum = 0;
-    for (int i = 0; i < SCHED_LOAD_HISTORY_SIZE; i++) {
-        sum += g_load_stats.load_history[i];
-    }
-    g_load_stats.average_load = sum / SCHED_LOAD_HISTORY_SIZE;
+    uint32_t active = runnable * FIXED_1;
+    g_load_stats.avenrun[0] = calc_load(g_load_stats.avenrun[0], EXP_1, active);
+    g_load_stats.avenrun[1] = calc_load(g_load_stats.avenrun[1], EXP_5, active);
+    g_load_stats.avenrun[2] = calc_load(g_load_stats.avenrun[2], EXP_15, active);
 }
 
 //============================================================================
@@ -218,7 +215,15 @@ void scheduler_opt_reset_boost(tcb_t *task) {
 //============================================================================
 
 uint32_t scheduler_opt_get_load_average(void) {
-    return g_load_stats.average_load;
+    uint32_t load = g_load_stats.avenrun[0];
+    return LOAD_INT(load) * 100 + LOAD_FRAC(load);
+}
+
+void scheduler_opt_get_loadavg(uint32_t loads[3]) {
+    if (!loads) return;
+    for (int i = 0; i < 3; i++) {
+        loads[i] = g_load_stats.avenrun[i];
+    }
 }
 
 bool scheduler_opt_is_high_load(void) {
@@ -258,42 +258,46 @@ void scheduler_queues_add_to_all_tasks(tcb_t *task) {
     }
 
     uintptr_t all_tasks_irq_flags = spinlock_acquire_irqsave(&g_all_tasks_lock);
+    task->all_tasks_prev = NULL;
     task->all_tasks_next = g_all_tasks_head;
+    if (g_all_tasks_head) {
+        g_all_tasks_head->all_tasks_prev = task;
+    }
     g_all_tasks_head = task;
     spinlock_release_irqrestore(&g_all_tasks_lock, all_tasks_irq_flags);
     
     SCHED_DEBUG("Added task PID %lu to all tasks list", task->pid);
 }
 
-tcb_t* scheduler_queues_remove_zombie_task(void) {
-    tcb_t *zombie_to_reap = NULL;
-    tcb_t *prev_all = NULL;
+void scheduler_queues_remove_from_all_tasks(tcb_t *task) {
+    if (!task) {
+        return;
+    }
 
     uintptr_t all_tasks_irq_flags = spinlock_acquire_irqsave(&g_all_tasks_lock);
-    tcb_t *current_all = g_all_tasks_head;
-    
-    while (current_all) {
-        if (current_all->pid != IDLE_TASK_PID && current_all->state == TASK_ZOMBIE) {
-            zombie_to_reap = current_all;
-            if (prev_all) {
-                prev_all->all_tasks_next = current_all->all_tasks_next;
-            } else {
-                g_all_tasks_head = current_all->all_tasks_next;
-            }
-            zombie_to_reap->all_tasks_next = NULL;
-            break;
-        }
-        prev_all = current_all;
-        current_all = current_all->all_tasks_next;
+    if (task->all_tasks_prev) {
+        task->all_tasks_prev->all_tasks_next = task->all_tasks_next;
+    } else if (g_all_tasks_head == task) {
+        g_all_tasks_head = task->all_tasks_next;
     }
-    
+    if (task->all_tasks_next) {
+        task->all_tasks_next->all_tasks_prev = task->all_tasks_prev;
+    }
+    task->all_tasks_next = NULL;
+    task->all_tasks_prev = NULL;
     spinlock_release_irqrestore(&g_all_tasks_lock, all_tasks_irq_flags);
-    
-    if (zombie_to_reap) {
-        SCHED_DEBUG("Found zombie task PID %lu for cleanup", zombie_to_reap->pid);
+}
+
+void scheduler_queues_for_each_task(void (*fn)(tcb_t *task, void *arg), void *arg) {
+    if (!fn) {
+        return;
     }
-    
-    return zombie_to_reap;
+
+    uintptr_t all_tasks_irq_flags = spinlock_acquire_irqsave(&g_all_tasks_lock);
+    for (tcb_t *task = g_all_tasks_head; task; task = task->all_tasks_next) {
+        fn(task, arg);
+    }
+    spinlock_release_irqrestore(&g_all_tasks_lock, all_tasks_irq_flags);
 }
 
 //============================================================================
@@ -313,6 +317,28 @@ uint32_t scheduler_queues_get_count(uint8_t priority) {
     return count;
 }
 
+void scheduler_queues_count_tasks(uint32_t *total, uint32_t *runnable, uint32_t *blocked) {
+    uint32_t n_total = 0, n_runnable = 0, n_blocked = 0;
+
+    uintptr_t all_tasks_irq_flags = spinlock_acquire_irqsave(&g_all_tasks_lock);
+    for (tcb_t *task = g_all_tasks_head; task; task = task->all_tasks_next) {
+        if (task->pid == IDLE_TASK_PID || task->state == TASK_ZOMBIE) {
+            continue;
+        }
+        n_total++;
+        if (task->state == TASK_READY || task->state == TASK_RUNNING) {
+            n_runnable++;
+        } else if (task->state == TASK_BLOCKED || task->state == TASK_SLEEPING) {
+            n_blocked++;
+        }
+    }
+    spinlock_release_irqrestore(&g_all_tasks_lock, all_tasks_irq_flags);
+
+    if (total) *total = n_total;
+    if (runnable) *runnable = n_runnable;
+    if (blocked) *blocked = n_blocked;
+}
+
 void scheduler_queues_debug_print_stats(void) {
     serial_printf("[Queue Stats] Priority queue counts:\n");
     for (int i = 0; i < SCHED_PRIORITY_LEVELS; i++) {
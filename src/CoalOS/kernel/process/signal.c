@@ -14,6 +14,7 @@
 #include <kernel/process/signal.h>
 #include <kernel/process/process.h>
 #include <kernel/process/scheduler.h>
+#include <kernel/process/itimer.h>
 #include <kernel/memory/kmalloc.h>
 #include <kernel/memory/uaccess.h>
 #include <kernel/lib/string.h>
@@ -21,6 +22,7 @@
 #include <kernel/sync/spinlock.h>
 #include <kernel/lib/assert.h>
 #include <kernel/core/error.h>
+#include <kernel/cpu/syscall.h>
 #include <libc/stddef.h>
 
 // Forward declaration for process lookup
@@ -34,6 +36,22 @@ extern pcb_t *process_get_by_pid(uint32_t pid);
 #define EFAULT E_FAULT
 #define ENOMEM E_NOMEM
 
+//============================================================================
+// Signal Return Trampoline
+//============================================================================
+
+// Copied to the user stack on every delivery, as i386 Linux does:
+//   popl %eax; movl $SYS_SIGRETURN, %eax; int $0x80
+// User stack pages are executable without PAE, so no vsyscall page is needed.
+static const uint8_t signal_retcode[8] = {
+    0x58,
+    0xB8, SYS_SIGRETURN & 0xFF, (SYS_SIGRETURN >> 8) & 0xFF, 0x00, 0x00,
+    0xCD, 0x80
+};
+
+// CF PF AF ZF SF TF DF OF RF AC: the EFLAGS bits sigreturn may restore
+#define SIGRETURN_EFLAGS_MASK 0x00050DD5U
+
 //============================================================================
 // Signal Default Actions Table
 //============================================================================
@@ -156,6 +174,23 @@ void* signal_register_handler(pcb_t *proc, int signal, void *handler, uint32_t f
     return old_handler;
 }
 
+//============================================================================
+// Pending-Work Flag
+//============================================================================
+
+void signal_recalc_pending(pcb_t *proc) {
+    if (!proc || !proc->tcb) return;
+
+    // A terminated process must reach the exit path; otherwise only flag
+    // signals that can actually be delivered right now.
+    if (proc->has_exited ||
+        (!proc->in_signal_handler && (proc->pending_signals & ~proc->signal_mask))) {
+        set_tsk_thread_flag(proc->tcb, TIF_SIGPENDING);
+    } else {
+        clear_tsk_thread_flag(proc->tcb, TIF_SIGPENDING);
+    }
+}
+
 //============================================================================
 // Signal Sending
 //============================================================================
@@ -180,6 +215,19 @@ int signal_send(uint32_t target_pid, int signal, uint32_t sender_pid) {
         }
     }
     
+    int result = signal_send_kernel(target, signal);
+    if (result == 0) {
+        serial_printf("[Signal] Sent signal %d to PID %u from PID %u\n",
+                      signal, target_pid, sender_pid);
+    }
+    return result;
+}
+
+int signal_send_kernel(pcb_t *target, int signal) {
+    if (!target || signal <= 0 || signal >= SIGNAL_MAX) {
+        return -EINVAL;
+    }
+
     uintptr_t irq_flags = spinlock_acquire_irqsave(&target->signal_lock);
     
     // Special handling for SIGKILL and SIGSTOP - cannot be blocked or ignored
@@ -191,8 +239,7 @@ int signal_send(uint32_t target_pid, int signal, uint32_t sender_pid) {
         if (signal == SIGKILL) {
             signal_terminate_process(target, signal);
         }
-        
-        serial_printf("[Signal] Sent uncatchable signal %d to PID %u\n", signal, target_pid);
+        signal_recalc_pending(target);
         return 0;
     }
     
@@ -205,18 +252,16 @@ int signal_send(uint32_t target_pid, int signal, uint32_t sender_pid) {
     
     // Set pending bit
     target->pending_signals |= SIGMASK(signal);
+    signal_recalc_pending(target);
     
     spinlock_release_irqrestore(&target->signal_lock, irq_flags);
     
     // Wake up the target process if it's sleeping
     if (target->state == PROC_SLEEPING) {
         // TODO: Implement process wakeup - convert to scheduler's task representation
-        serial_printf("[Signal] Target process PID %u is sleeping, should wake up\n", target_pid);
+        serial_printf("[Signal] Target process PID %u is sleeping, should wake up\n", target->pid);
     }
     
-    serial_printf("[Signal] Sent signal %d to PID %u from PID %u\n", 
-                  signal, target_pid, sender_pid);
-    
     return 0;
 }
 
@@ -297,34 +342,46 @@ bool signal_deliver_pending(pcb_t *proc, isr_frame_t *regs) {
     proc->in_signal_handler = signal;
     spinlock_release_irqrestore(&proc->signal_lock, irq_flags);
     
-    // Set up user space signal handler execution
-    // Save current context on user stack
-    uint32_t user_esp = regs->useresp;
-    
-    // Allocate space for signal context on user stack
+    // Build the handler frame on the user stack, lowest address first:
+    //   [ret addr -> retcode][signal number][signal_context_t][retcode]
+    // The handler's ret lands on retcode, which pops the signal number so
+    // ESP points at the saved context and then calls sigreturn.
+    signal_context_t sig_ctx;
+    memset(&sig_ctx, 0, sizeof(sig_ctx));
+    sig_ctx.eax = regs->eax;
+    sig_ctx.ebx = regs->ebx;
+    sig_ctx.ecx = regs->ecx;
+    sig_ctx.edx = regs->edx;
+    sig_ctx.esi = regs->esi;
+    sig_ctx.edi = regs->edi;
+    sig_ctx.ebp = regs->ebp;
+    sig_ctx.esp = regs->useresp;
+    sig_ctx.eip = regs->eip;
+    sig_ctx.eflags = regs->eflags;
+    sig_ctx.original_esp = regs->useresp;
+    sig_ctx.signal_number = signal;
+
+    uint32_t user_esp = regs->useresp - sizeof(signal_retcode);
+    uint32_t retcode_addr = user_esp;
     user_esp -= sizeof(signal_context_t);
-    signal_context_t *sig_ctx = (signal_context_t*)user_esp;
-    
-    // Fill signal context (simplified - would need proper user space writing)
-    sig_ctx->eax = regs->eax;
-    sig_ctx->ebx = regs->ebx;
-    sig_ctx->ecx = regs->ecx;
-    sig_ctx->edx = regs->edx;
-    sig_ctx->esi = regs->esi;
-    sig_ctx->edi = regs->edi;
-    sig_ctx->ebp = regs->ebp;
-    sig_ctx->esp = regs->useresp;
-    sig_ctx->eip = regs->eip;
-    sig_ctx->eflags = regs->eflags;
-    sig_ctx->original_esp = regs->useresp;
-    sig_ctx->signal_number = signal;
-    
-    // Set up signal handler call
-    user_esp -= sizeof(uint32_t);  // Space for signal number argument
-    *((uint32_t*)user_esp) = signal;
-    
-    user_esp -= sizeof(uint32_t);  // Space for return address (stub for now)
-    *((uint32_t*)user_esp) = 0;  // Simplified - no return trampoline for now
+    uint32_t ctx_addr = user_esp;
+
+    uint32_t frame_words[2] = {
+        retcode_addr,      // Return address
+        (uint32_t)signal   // Handler argument
+    };
+    user_esp -= sizeof(frame_words);
+
+    // The user stack may be unmapped or bogus; fall back to SIGSEGV
+    if (copy_to_user((userptr_t)retcode_addr, signal_retcode, sizeof(signal_retcode)) != 0 ||
+        copy_to_user((userptr_t)ctx_addr, &sig_ctx, sizeof(sig_ctx)) != 0 ||
+        copy_to_user((userptr_t)user_esp, frame_words, sizeof(frame_words)) != 0) {
+        serial_printf("[Signal] Bad user stack delivering signal %d to PID %u\n",
+                      signal, proc->pid);
+        proc->in_signal_handler = 0;
+        signal_terminate_process(proc, SIGSEGV);
+        return true;
+    }
     
     // Modify registers to call signal handler
     regs->useresp = user_esp;
@@ -366,6 +423,7 @@ int signal_mask_change(pcb_t *proc, int how, uint32_t newmask, uint32_t *oldmask
             spinlock_release_irqrestore(&proc->signal_lock, irq_flags);
             return -EINVAL;
     }
+    signal_recalc_pending(proc);
     
     spinlock_release_irqrestore(&proc->signal_lock, irq_flags);
     
@@ -420,8 +478,10 @@ void signal_handle_keyboard_interrupt(void) {
 }
 
 void signal_handle_timer_signals(void) {
-    // TODO: Implement timer-based signal delivery (SIGALRM)
-    // This would be called from the timer interrupt handler
+    pcb_t *current = get_current_process();
+    if (current && current->pid != IDLE_TASK_PID) {
+        itimer_account_cputime(current);
+    }
 }
 
 void signal_handle_page_fault(pcb_t *proc, uintptr_t fault_addr, uint32_t error_code) {
@@ -445,23 +505,40 @@ void signal_handle_fpe(pcb_t *proc) {
 // Signal Return Mechanism (for returning from signal handlers)
 //============================================================================
 
-// This would be implemented as a small assembly trampoline
-// that user space signal handlers return to
-extern void signal_return_trampoline(void);
+int32_t sys_sigreturn_impl(uint32_t arg1, uint32_t arg2, uint32_t arg3, isr_frame_t *regs) {
+    (void)arg1; (void)arg2; (void)arg3;
 
-// System call to return from signal handler
-int sys_sigreturn(signal_context_t *context) {
     pcb_t *proc = get_current_process();
-    if (!proc || !context) {
+    if (!proc || !regs) {
         return -EINVAL;
     }
-    
-    // Restore original context
-    // This would restore the register state from before the signal
+
+    // retcode popped the signal number, so ESP points at the saved context
+    signal_context_t ctx;
+    if (copy_from_user(&ctx, (const_userptr_t)regs->useresp, sizeof(ctx)) != 0) {
+        serial_printf("[Signal] Bad sigreturn frame in PID %u\n", proc->pid);
+        signal_terminate_process(proc, SIGSEGV);
+        return -EFAULT;
+    }
+
+    // Segments stay as the syscall entered; only flags user code may
+    // change are taken from the frame, so IOPL/IF/VM cannot be forged
+    regs->ebx = ctx.ebx;
+    regs->ecx = ctx.ecx;
+    regs->edx = ctx.edx;
+    regs->esi = ctx.esi;
+    regs->edi = ctx.edi;
+    regs->ebp = ctx.ebp;
+    regs->useresp = ctx.esp;
+    regs->eip = ctx.eip;
+    regs->eflags = (regs->eflags & ~SIGRETURN_EFLAGS_MASK) |
+                   (ctx.eflags & SIGRETURN_EFLAGS_MASK);
+
+    uintptr_t irq_flags = spinlock_acquire_irqsave(&proc->signal_lock);
     proc->in_signal_handler = 0;
-    
-    // Restore registers (would be done by assembly code)
-    // restore_user_context(context);
-    
-    return 0;
-}
\ No newline at end of file
+    signal_recalc_pending(proc);
+    spinlock_release_irqrestore(&proc->signal_lock, irq_flags);
+
+    // The dispatcher stores the return value in EAX
+    return (int32_t)ctx.eax;
+}
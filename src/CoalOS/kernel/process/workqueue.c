@@ -0,0 +1,528 @@
+/**
+ * @file workqueue.c
+ * @brief Concurrency-managed worker pools behind the workqueue API
+ *
+ * Each pool keeps a FIFO of pending work, a list of idle workers and a count
+ * of workers that are executing work without being blocked (nr_running).
+ * Queueing wakes an idle worker only when nr_running is zero; a worker that
+ * blocks inside a work item drops out of nr_running (schedule() calls
+ * wq_worker_sleeping()) and hands the queue to an idle worker. Before taking
+ * an item, a worker that would leave the pool without an idle spare starts a
+ * new one, so there is always someone to hand over to, up to WQ_MAX_WORKERS.
+ *
+ * Kernel tasks have no CPU affinity here, so a per-CPU pool is a queue and a
+ * set of workers reserved for work queued on that CPU rather than threads
+ * pinned to it.
+ */
+
+#include <kernel/process/workqueue.h>
+#include <kernel/process/scheduler.h>
+#include <kernel/memory/kmalloc.h>
+#include <kernel/sync/spinlock.h>
+#include <kernel/cpu/get_cpu_id.h>
+#include <kernel/drivers/display/serial.h>
+#include <kernel/lib/assert.h>
+#include <kernel/lib/string.h>
+#include <libc/stddef.h>
+
+#define WQ_ERROR(fmt, ...) serial_printf("[WQ ERROR] %s:%d: " fmt "\n", __func__, __LINE__, ##__VA_ARGS__)
+
+typedef struct worker worker_t;
+
+struct worker {
+    worker_t           *next;        // Idle list / start list link
+    worker_t           *all_next;    // Every worker of the pool
+    struct worker_pool *pool;
+    tcb_t              *task;
+    work_t             *current;     // Item being executed, NULL when idle
+    bool                sleeping;    // Blocked inside current (not in nr_running)
+};
+
+typedef struct worker_pool {
+    spinlock_t  lock;
+    int         cpu;                 // WORK_CPU_ANY for the unbound pool
+    work_t     *head;                // Pending FIFO
+    work_t     *tail;
+    worker_t   *idle;                // Blocked, waiting for work
+    worker_t   *all;
+    uint32_t    nr_workers;
+    uint32_t    nr_idle;
+    uint32_t    nr_running;          // Executing and not blocked
+    bool        starting;            // A new worker has not run yet
+    uint32_t    executed;
+} worker_pool_t;
+
+struct workqueue {
+    const char       *name;
+    uint32_t          flags;
+    volatile uint32_t nr_inflight;   // Queued on a pool or executing
+};
+
+static worker_pool_t g_cpu_pools[MAX_CPUS];
+static worker_pool_t g_unbound_pool;
+
+// Workers created but not yet running; the new task claims one on entry
+static worker_t *g_start_list = NULL;
+
+// Tasks waiting in flush_work()/flush_workqueue(), linked via tcb->wait_next.
+// Every completed item wakes them all to recheck their condition.
+static tcb_t *g_flushers = NULL;
+static spinlock_t g_wq_lock = { 0 };
+
+static workqueue_t g_system_wq = { "events", 0, 0 };
+static workqueue_t g_system_unbound_wq = { "events_unbound", WQ_UNBOUND, 0 };
+workqueue_t *system_wq = &g_system_wq;
+workqueue_t *system_unbound_wq = &g_system_unbound_wq;
+
+//============================================================================
+// Pools and Workers
+//============================================================================
+
+static worker_pool_t *pool_for(workqueue_t *wq, int cpu) {
+    if (wq->flags & WQ_UNBOUND) return &g_unbound_pool;
+    if (cpu == WORK_CPU_ANY) cpu = get_cpu_id();
+    return &g_cpu_pools[(cpu >= 0 && cpu < MAX_CPUS) ? cpu : 0];
+}
+
+// Pops an idle worker and makes it runnable. Caller holds pool->lock.
+static bool wake_idle_worker_locked(worker_pool_t *pool) {
+    worker_t *worker = pool->idle;
+    if (!worker) return false;
+    pool->idle = worker->next;
+    worker->next = NULL;
+    pool->nr_idle--;
+    pool->nr_running++;
+    if (worker->task && worker->task->state == TASK_BLOCKED) {
+        scheduler_unblock_task(worker->task);
+    }
+    return true;
+}
+
+static void worker_thread(void);
+
+// Starts one more worker for pool. Process context only.
+static bool create_worker(worker_pool_t *pool) {
+    worker_t *worker = kmalloc(sizeof(worker_t));
+    if (!worker) return false;
+    memset(worker, 0, sizeof(*worker));
+    worker->pool = pool;
+
+    uintptr_t irq = spinlock_acquire_irqsave(&g_wq_lock);
+    worker->next = g_start_list;
+    g_start_list = worker;
+    spinlock_release_irqrestore(&g_wq_lock, irq);
+
+    const char *name = (pool->cpu == WORK_CPU_ANY) ? "kworker/u" : "kworker";
+    if (scheduler_create_kernel_task(worker_thread, SCHED_DEFAULT_PRIORITY, name) != 0) {
+        irq = spinlock_acquire_irqsave(&g_wq_lock);
+        worker_t **link = &g_start_list;
+        while (*link && *link != worker) link = &(*link)->next;
+        if (*link) *link = worker->next;
+        spinlock_release_irqrestore(&g_wq_lock, irq);
+        kfree(worker);
+        return false;
+    }
+    return true;
+}
+
+static void wake_flushers(void) {
+    uintptr_t irq = spinlock_acquire_irqsave(&g_wq_lock);
+    tcb_t *task = g_flushers;
+    g_flushers = NULL;
+    while (task) {
+        tcb_t *next = task->wait_next;
+        task->wait_next = NULL;
+        task->wait_reason = NULL;
+        if (task->state == TASK_BLOCKED) scheduler_unblock_task(task);
+        task = next;
+    }
+    spinlock_release_irqrestore(&g_wq_lock, irq);
+}
+
+// Sleeps until a work item completes, unless done() already holds
+static void wait_for_completion_event(bool (*done)(void *), void *arg) {
+    tcb_t *self = get_current_task();
+    while (!done(arg)) {
+        uintptr_t irq = spinlock_acquire_irqsave(&g_wq_lock);
+        if (done(arg)) {
+            spinlock_release_irqrestore(&g_wq_lock, irq);
+            break;
+        }
+        self->wait_next = g_flushers;
+        self->wait_reason = &g_flushers;
+        g_flushers = self;
+        self->state = TASK_BLOCKED;
+        spinlock_release_irqrestore(&g_wq_lock, irq);
+        schedule();
+    }
+}
+
+// Takes pending items one at a time; returns when the queue is empty.
+// Called and returns with pool->lock held.
+static void process_pending_locked(worker_t *self, uintptr_t *irq) {
+    worker_pool_t *pool = self->pool;
+
+    while (pool->head) {
+        // Keep a spare for when this item blocks
+        if (pool->nr_idle == 0 && !pool->starting && pool->nr_workers < WQ_MAX_WORKERS) {
+            pool->starting = true;
+            pool->nr_workers++;
+            spinlock_release_irqrestore(&pool->lock, *irq);
+            bool ok = create_worker(pool);
+            *irq = spinlock_acquire_irqsave(&pool->lock);
+            if (!ok) {
+                pool->starting = false;
+                pool->nr_workers--;
+            }
+            continue;
+        }
+
+        work_t *work = pool->head;
+        pool->head = work->next;
+        if (!pool->head) pool->tail = NULL;
+        work->next = NULL;
+
+        // Cleared before the call so func may requeue its own item
+        workqueue_t *wq = work->wq;
+        __atomic_fetch_and(&work->flags, ~WORK_PENDING, __ATOMIC_RELEASE);
+        self->current = work;
+        spinlock_release_irqrestore(&pool->lock, *irq);
+
+        work->func(work);   // May free work
+
+        *irq = spinlock_acquire_irqsave(&pool->lock);
+        self->current = NULL;
+        pool->executed++;
+        __atomic_fetch_sub(&wq->nr_inflight, 1, __ATOMIC_RELEASE);
+
+        if (g_flushers) {
+            spinlock_release_irqrestore(&pool->lock, *irq);
+            wake_flushers();
+            *irq = spinlock_acquire_irqsave(&pool->lock);
+        }
+    }
+}
+
+static void worker_thread(void) {
+    tcb_t *task = get_current_task();
+
+    uintptr_t irq = spinlock_acquire_irqsave(&g_wq_lock);
+    worker_t *self = g_start_list;
+    KERNEL_ASSERT(self != NULL, "worker_thread started without a worker");
+    g_start_list = self->next;
+    self->next = NULL;
+    spinlock_release_irqrestore(&g_wq_lock, irq);
+
+    worker_pool_t *pool = self->pool;
+    self->task = task;
+
+    irq = spinlock_acquire_irqsave(&pool->lock);
+    self->all_next = pool->all;
+    pool->all = self;
+    pool->starting = false;
+    pool->nr_running++;
+    task->wq_worker = self;
+
+    for (;;) {
+        process_pending_locked(self, &irq);
+
+        if (pool->nr_idle >= WQ_MAX_IDLE) {
+            // Enough spares: leave the pool
+            worker_t **link = &pool->all;
+            while (*link != self) link = &(*link)->all_next;
+            *link = self->all_next;
+            pool->nr_workers--;
+            pool->nr_running--;
+            task->wq_worker = NULL;
+            spinlock_release_irqrestore(&pool->lock, irq);
+            kfree(self);
+            remove_current_task_with_code(0);
+        }
+
+        // Go idle; wake_idle_worker_locked() moves us back into nr_running
+        pool->nr_running--;
+        self->next = pool->idle;
+        pool->idle = self;
+        pool->nr_idle++;
+        task->state = TASK_BLOCKED;
+        spinlock_release_irqrestore(&pool->lock, irq);
+        schedule();
+        irq = spinlock_acquire_irqsave(&pool->lock);
+    }
+}
+
+static void pool_init(worker_pool_t *pool, int cpu) {
+    memset(pool, 0, sizeof(*pool));
+    spinlock_init(&pool->lock);
+    pool->cpu = cpu;
+}
+
+static void pool_start(worker_pool_t *pool) {
+    pool->starting = true;
+    pool->nr_workers = 1;
+    if (!create_worker(pool)) {
+        pool->starting = false;
+        pool->nr_workers = 0;
+        WQ_ERROR("Failed to start a worker for pool %d", pool->cpu);
+    }
+}
+
+void workqueue_init(void) {
+    spinlock_init(&g_wq_lock);
+    for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+        pool_init(&g_cpu_pools[cpu], cpu);
+        pool_start(&g_cpu_pools[cpu]);
+    }
+    pool_init(&g_unbound_pool, WORK_CPU_ANY);
+    pool_start(&g_unbound_pool);
+}
+
+//============================================================================
+// Scheduler Hooks
+//============================================================================
+
+void wq_worker_sleeping(tcb_t *task) {
+    worker_t *worker = task->wq_worker;
+    if (!worker || !worker->current || worker->sleeping) return;
+
+    worker_pool_t *pool = worker->pool;
+    uintptr_t irq = spinlock_acquire_irqsave(&pool->lock);
+    worker->sleeping = true;
+    pool->nr_running--;
+    if (pool->nr_running == 0 && pool->head) {
+        wake_idle_worker_locked(pool);
+    }
+    spinlock_release_irqrestore(&pool->lock, irq);
+}
+
+void wq_worker_running(tcb_t *task) {
+    worker_t *worker = task->wq_worker;
+    if (!worker || !worker->sleeping) return;
+
+    worker_pool_t *pool = worker->pool;
+    uintptr_t irq = spinlock_acquire_irqsave(&pool->lock);
+    worker->sleeping = false;
+    pool->nr_running++;
+    spinlock_release_irqrestore(&pool->lock, irq);
+}
+
+//============================================================================
+// Workqueues
+//============================================================================
+
+workqueue_t *workqueue_create(const char *name, uint32_t flags) {
+    workqueue_t *wq = kmalloc(sizeof(workqueue_t));
+    if (!wq) return NULL;
+    wq->name = name;
+    wq->flags = flags;
+    wq->nr_inflight = 0;
+    return wq;
+}
+
+void workqueue_destroy(workqueue_t *wq) {
+    if (!wq || wq == system_wq || wq == system_unbound_wq) return;
+    flush_workqueue(wq);
+    kfree(wq);
+}
+
+void work_init(work_t *work, work_func_t func, void *data) {
+    memset(work, 0, sizeof(*work));
+    work->func = func;
+    work->data = data;
+}
+
+static void delayed_work_timer_fn(ktimer_t *timer);
+
+void delayed_work_init(delayed_work_t *dwork, work_func_t func, void *data) {
+    work_init(&dwork->work, func, data);
+    ktimer_init(&dwork->timer, delayed_work_timer_fn, dwork);
+    dwork->wq = NULL;
+    dwork->cpu = WORK_CPU_ANY;
+}
+
+static bool test_and_set_pending(work_t *work) {
+    return (__atomic_fetch_or(&work->flags, WORK_PENDING, __ATOMIC_ACQUIRE) & WORK_PENDING) != 0;
+}
+
+// Appends work (already marked pending) to its pool
+static void insert_work(workqueue_t *wq, work_t *work, int cpu) {
+    worker_pool_t *pool = pool_for(wq, cpu);
+    uintptr_t irq = spinlock_acquire_irqsave(&pool->lock);
+    work->pool = pool;
+    work->wq = wq;
+    work->next = NULL;
+    __atomic_fetch_add(&wq->nr_inflight, 1, __ATOMIC_RELAXED);
+    if (pool->tail) pool->tail->next = work;
+    else            pool->head = work;
+    pool->tail = work;
+    if (pool->nr_running == 0) {
+        wake_idle_worker_locked(pool);
+    }
+    spinlock_release_irqrestore(&pool->lock, irq);
+}
+
+bool queue_work_on(int cpu, workqueue_t *wq, work_t *work) {
+    if (!wq || !work || !work->func) return false;
+    if (test_and_set_pending(work)) return false;
+    insert_work(wq, work, cpu);
+    return true;
+}
+
+bool queue_work(workqueue_t *wq, work_t *work) {
+    return queue_work_on(WORK_CPU_ANY, wq, work);
+}
+
+static void delayed_work_timer_fn(ktimer_t *timer) {
+    delayed_work_t *dwork = (delayed_work_t *)timer->data;
+    insert_work(dwork->wq, &dwork->work, dwork->cpu);
+}
+
+static void arm_delayed_work(workqueue_t *wq, delayed_work_t *dwork, uint32_t delay_ms) {
+    dwork->wq = wq;
+    if (delay_ms == 0) {
+        insert_work(wq, &dwork->work, dwork->cpu);
+        return;
+    }
+    // The CPU is picked now, like queue_work() would
+    if (!(wq->flags & WQ_UNBOUND) && dwork->cpu == WORK_CPU_ANY) dwork->cpu = get_cpu_id();
+    ktimer_arm(&dwork->timer, delay_ms * (KTIMER_HZ / 1000));
+}
+
+bool queue_delayed_work(workqueue_t *wq, delayed_work_t *dwork, uint32_t delay_ms) {
+    if (!wq || !dwork || !dwork->work.func) return false;
+    if (test_and_set_pending(&dwork->work)) return false;
+    arm_delayed_work(wq, dwork, delay_ms);
+    return true;
+}
+
+// Removes pending work from its pool's queue
+static bool dequeue_work(work_t *work) {
+    worker_pool_t *pool = work->pool;
+    if (!pool) return false;
+
+    bool found = false;
+    uintptr_t irq = spinlock_acquire_irqsave(&pool->lock);
+    work_t *prev = NULL;
+    for (work_t *cur = pool->head; cur; prev = cur, cur = cur->next) {
+        if (cur != work) continue;
+        if (prev) prev->next = cur->next;
+        else      pool->head = cur->next;
+        if (pool->tail == cur) pool->tail = prev;
+        cur->next = NULL;
+        __atomic_fetch_and(&work->flags, ~WORK_PENDING, __ATOMIC_RELEASE);
+        __atomic_fetch_sub(&work->wq->nr_inflight, 1, __ATOMIC_RELEASE);
+        found = true;
+        break;
+    }
+    spinlock_release_irqrestore(&pool->lock, irq);
+    return found;
+}
+
+/*
+ * Timer callbacks run in interrupt context on the single scheduling CPU, so
+ * once ktimer_cancel() reports the timer idle its callback is not halfway
+ * through insert_work().
+ */
+static bool try_cancel_delayed(delayed_work_t *dwork) {
+    if (ktimer_cancel(&dwork->timer)) {
+        __atomic_fetch_and(&dwork->work.flags, ~WORK_PENDING, __ATOMIC_RELEASE);
+        return true;
+    }
+    return dequeue_work(&dwork->work);
+}
+
+bool mod_delayed_work(workqueue_t *wq, delayed_work_t *dwork, uint32_t delay_ms) {
+    if (!wq || !dwork || !dwork->work.func) return false;
+    uintptr_t irq = local_irq_save();
+    bool was_pending = try_cancel_delayed(dwork);
+    if (!test_and_set_pending(&dwork->work)) {
+        arm_delayed_work(wq, dwork, delay_ms);
+    }
+    local_irq_restore(irq);
+    return was_pending;
+}
+
+bool cancel_delayed_work(delayed_work_t *dwork) {
+    if (!dwork) return false;
+    uintptr_t irq = local_irq_save();
+    bool was_pending = try_cancel_delayed(dwork);
+    local_irq_restore(irq);
+    return was_pending;
+}
+
+//============================================================================
+// Flushing
+//============================================================================
+
+static bool work_running(work_t *work) {
+    worker_pool_t *pool = work->pool;
+    if (!pool) return false;
+    bool running = false;
+    uintptr_t irq = spinlock_acquire_irqsave(&pool->lock);
+    for (worker_t *w = pool->all; w; w = w->all_next) {
+        if (w->current == work) { running = true; break; }
+    }
+    spinlock_release_irqrestore(&pool->lock, irq);
+    return running;
+}
+
+static bool work_idle(void *arg) {
+    work_t *work = (work_t *)arg;
+    return !(work->flags & WORK_PENDING) && !work_running(work);
+}
+
+static bool wq_drained(void *arg) {
+    return ((workqueue_t *)arg)->nr_inflight == 0;
+}
+
+bool flush_work(work_t *work) {
+    if (!work) return false;
+    tcb_t *self = get_current_task();
+    KERNEL_ASSERT(!self || !self->wq_worker || ((worker_t *)self->wq_worker)->current != work,
+                  "flush_work() called from the work item itself");
+    if (work_idle(work)) return false;
+    wait_for_completion_event(work_idle, work);
+    return true;
+}
+
+void flush_workqueue(workqueue_t *wq) {
+    if (!wq) return;
+    wait_for_completion_event(wq_drained, wq);
+}
+
+bool cancel_work_sync(work_t *work) {
+    if (!work) return false;
+    bool was_pending = dequeue_work(work);
+    flush_work(work);
+    return was_pending;
+}
+
+bool cancel_delayed_work_sync(delayed_work_t *dwork) {
+    if (!dwork) return false;
+    bool was_pending = cancel_delayed_work(dwork);
+    flush_work(&dwork->work);
+    return was_pending;
+}
+
+//============================================================================
+// Statistics
+//============================================================================
+
+static void pool_add_stats(worker_pool_t *pool, uint32_t *workers, uint32_t *idle, uint32_t *executed) {
+    uintptr_t irq = spinlock_acquire_irqsave(&pool->lock);
+    *workers += pool->nr_workers;
+    *idle += pool->nr_idle;
+    *executed += pool->executed;
+    spinlock_release_irqrestore(&pool->lock, irq);
+}
+
+void workqueue_get_stats(uint32_t *workers, uint32_t *idle, uint32_t *executed) {
+    uint32_t w = 0, i = 0, e = 0;
+    for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+        pool_add_stats(&g_cpu_pools[cpu], &w, &i, &e);
+    }
+    pool_add_stats(&g_unbound_pool, &w, &i, &e);
+    if (workers) *workers = w;
+    if (idle) *idle = i;
+    if (executed) *executed = e;
+}
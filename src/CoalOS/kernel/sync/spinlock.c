@@ -1,4 +1,5 @@
 #include <kernel/sync/spinlock.h>
+#include <kernel/sync/preempt.h>
 #include <kernel/interfaces/logger.h> // For logging
 
 #define LOG_MODULE "spinlock"
@@ -21,6 +22,7 @@ void spinlock_init(spinlock_t *lock) {
  */
 uintptr_t spinlock_acquire_irqsave(spinlock_t *lock) {
     uintptr_t flags = local_irq_save(); // Disable interrupts, save state
+    preempt_disable();
     if (!lock) {
         LOGGER_ERROR(LOG_MODULE, "Trying to acquire NULL lock!");
         return flags; // Return saved flags even on error
@@ -89,6 +91,7 @@ void spinlock_release_irqrestore(spinlock_t *lock, uintptr_t flags) {
         terminal_write("[Spinlock] Error: Trying to release NULL lock!\n");
         // Restore interrupts anyway? Or panic?
         local_irq_restore(flags);
+        preempt_enable();
         return;
     }
 
@@ -97,6 +100,7 @@ void spinlock_release_irqrestore(spinlock_t *lock, uintptr_t flags) {
     __atomic_clear(&lock->locked, __ATOMIC_RELEASE);
 
     local_irq_restore(flags); // Restore previous interrupt state
+    preempt_enable();         // May reschedule now that IF is back on
 }
 
 //============================================================================
@@ -110,6 +114,7 @@ uintptr_t spinlock_try_acquire_irqsave(spinlock_t *lock) {
     if (!lock) return 0;
     
     uintptr_t flags = local_irq_save();
+    preempt_disable();
     
     // Try to acquire lock without spinning
     if (!__atomic_test_and_set(&lock->locked, __ATOMIC_ACQUIRE)) {
@@ -119,6 +124,7 @@ uintptr_t spinlock_try_acquire_irqsave(spinlock_t *lock) {
     }
     
     // Lock was already held, restore interrupts and return failure
+    preempt_enable_no_resched();
     local_irq_restore(flags);
     return 0; // Indicates failure to acquire
 }
@@ -0,0 +1,467 @@
+/*
+ * ldso.c – CoalOS dynamic linker (/lib/ld.so)
+ *
+ * Loaded by the kernel as the PT_INTERP of dynamically linked programs. It
+ * relocates itself, maps every DT_NEEDED library from /lib with mmap2(),
+ * applies their relocations and the program's, and returns the program
+ * entry point to _start (ldso_start.asm).
+ *
+ * Read-only library segments are mapped MAP_PRIVATE from the file; the kernel
+ * backs them with frames shared by every process using the library, so one
+ * copy of libc.so text serves the whole system.
+ *
+ * PLT calls are bound lazily on first use unless the program asks for
+ * immediate binding (DT_BIND_NOW, DF_BIND_NOW or LD_BIND_NOW in the
+ * environment).
+ *
+ * Built freestanding and position-independent; see README.md.
+ */
+
+/* ==== Types & ELF definitions =========================================== */
+
+typedef unsigned char  uint8_t;
+typedef unsigned short uint16_t;
+typedef unsigned int   uint32_t;
+typedef signed   int   int32_t;
+typedef uint32_t       size_t;
+typedef uint32_t       uintptr_t;
+#define NULL ((void*)0)
+
+typedef struct {
+    uint8_t  e_ident[16];
+    uint16_t e_type, e_machine;
+    uint32_t e_version, e_entry, e_phoff, e_shoff, e_flags;
+    uint16_t e_ehsize, e_phentsize, e_phnum, e_shentsize, e_shnum, e_shstrndx;
+} Elf32_Ehdr;
+
+typedef struct {
+    uint32_t p_type, p_offset, p_vaddr, p_paddr, p_filesz, p_memsz, p_flags, p_align;
+} Elf32_Phdr;
+
+typedef struct { int32_t d_tag; uint32_t d_val; } Elf32_Dyn;
+typedef struct { uint32_t r_offset, r_info; } Elf32_Rel;
+typedef struct {
+    uint32_t st_name, st_value, st_size;
+    uint8_t  st_info, st_other;
+    uint16_t st_shndx;
+} Elf32_Sym;
+
+#define ET_DYN        3
+#define PT_LOAD       1
+#define PT_DYNAMIC    2
+#define PT_PHDR       6
+#define PF_X          1
+#define PF_W          2
+#define PF_R          4
+
+#define DT_NULL       0
+#define DT_NEEDED     1
+#define DT_PLTRELSZ   2
+#define DT_PLTGOT     3
+#define DT_HASH       4
+#define DT_STRTAB     5
+#define DT_SYMTAB     6
+#define DT_REL        17
+#define DT_RELSZ      18
+#define DT_JMPREL     23
+#define DT_BIND_NOW   24
+#define DT_FLAGS      30
+#define DF_BIND_NOW   0x8
+
+#define R_386_32        1
+#define R_386_PC32      2
+#define R_386_COPY      5
+#define R_386_GLOB_DAT  6
+#define R_386_JMP_SLOT  7
+#define R_386_RELATIVE  8
+
+#define SHN_UNDEF     0
+#define STB_WEAK      2
+
+#define AT_NULL       0
+#define AT_PHDR       3
+#define AT_PHNUM      5
+#define AT_BASE       7
+#define AT_ENTRY      9
+
+/* ==== System calls ====================================================== */
+
+#define SYS_EXIT      1
+#define SYS_READ      3
+#define SYS_WRITE     4
+#define SYS_OPEN      5
+#define SYS_CLOSE     6
+#define SYS_LSEEK     19
+#define SYS_MMAP2     192
+
+#define PROT_READ     0x1
+#define PROT_WRITE    0x2
+#define PROT_EXEC     0x4
+#define MAP_PRIVATE   0x02
+#define MAP_FIXED     0x10
+#define MAP_ANONYMOUS 0x20
+
+#define PAGE_SIZE     4096u
+#define PAGE_DOWN(x)  ((x) & ~(PAGE_SIZE - 1))
+#define PAGE_UP(x)    (((x) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1))
+
+#define HIDDEN __attribute__((visibility("hidden")))
+
+extern int  ldso_syscall(int nr, int a1, int a2, int a3, int a4, int a5, int a6) HIDDEN;
+extern void ldso_runtime_resolve(void) HIDDEN;
+extern Elf32_Dyn _DYNAMIC[] HIDDEN;
+
+/* ==== Link maps ========================================================= */
+
+#define LDSO_MAX_OBJECTS 16
+#define LDSO_PATH_MAX    128
+#define LDSO_MAX_PHDRS   16
+
+typedef struct link_map {
+    uintptr_t        base;       /* Load bias */
+    const Elf32_Dyn *dyn;
+    const char      *strtab;
+    const Elf32_Sym *symtab;
+    const uint32_t  *hash;       /* DT_HASH: nbucket, nchain, buckets, chains */
+    const Elf32_Rel *rel;
+    uint32_t         relsz;
+    const Elf32_Rel *jmprel;
+    uint32_t         pltrelsz;
+    uint32_t        *pltgot;
+    int              bind_now;
+    char             name[LDSO_PATH_MAX];
+} link_map_t;
+
+static link_map_t g_maps[LDSO_MAX_OBJECTS];   /* [0] is the program */
+static int g_nmaps;
+static int g_bind_now_env;
+
+/* ==== Small helpers ===================================================== */
+
+static size_t ld_strlen(const char *s) {
+    size_t n = 0;
+    while (s[n]) n++;
+    return n;
+}
+
+static int ld_streq(const char *a, const char *b) {
+    while (*a && *a == *b) { a++; b++; }
+    return *a == *b;
+}
+
+static void ld_memcpy(void *dst, const void *src, size_t n) {
+    uint8_t *d = dst;
+    const uint8_t *s = src;
+    while (n--) *d++ = *s++;
+}
+
+static void ld_memset(void *dst, int c, size_t n) {
+    uint8_t *d = dst;
+    while (n--) *d++ = (uint8_t)c;
+}
+
+static void ld_puts(const char *s) {
+    ldso_syscall(SYS_WRITE, 2, (int)s, (int)ld_strlen(s), 0, 0, 0);
+}
+
+static void ld_fail(const char *what, const char *name) {
+    ld_puts("ld.so: ");
+    ld_puts(what);
+    if (name) { ld_puts(": "); ld_puts(name); }
+    ld_puts("\n");
+    ldso_syscall(SYS_EXIT, 127, 0, 0, 0, 0, 0);
+    for (;;) { }
+}
+
+static int ld_read_at(int fd, uint32_t offset, void *buf, size_t len) {
+    if (ldso_syscall(SYS_LSEEK, fd, (int)offset, 0, 0, 0, 0) != (int)offset) return -1;
+    size_t done = 0;
+    while (done < len) {
+        int n = ldso_syscall(SYS_READ, fd, (int)((uint8_t *)buf + done), (int)(len - done), 0, 0, 0);
+        if (n <= 0) return -1;
+        done += (size_t)n;
+    }
+    return 0;
+}
+
+static int is_mmap_error(int ret) {
+    return ret < 0 && ret > -4096;
+}
+
+/* ==== Self relocation =================================================== */
+
+/*
+ * Built with hidden visibility, ld.so carries only R_386_RELATIVE relocations.
+ * Nothing before this may use pointers stored in initialised data.
+ */
+static void relocate_self(uintptr_t base) {
+    const Elf32_Rel *rel = NULL;
+    uint32_t relsz = 0;
+    for (const Elf32_Dyn *d = _DYNAMIC; d->d_tag != DT_NULL; d++) {
+        if (d->d_tag == DT_REL) rel = (const Elf32_Rel *)(base + d->d_val);
+        else if (d->d_tag == DT_RELSZ) relsz = d->d_val;
+    }
+    for (uint32_t i = 0; rel && i < relsz / sizeof(Elf32_Rel); i++) {
+        if ((rel[i].r_info & 0xFF) == R_386_RELATIVE) {
+            *(uint32_t *)(base + rel[i].r_offset) += base;
+        }
+    }
+}
+
+/* ==== Dynamic section & symbol lookup =================================== */
+
+static void parse_dynamic(link_map_t *map) {
+    uintptr_t b = map->base;
+    for (const Elf32_Dyn *d = map->dyn; d->d_tag != DT_NULL; d++) {
+        switch (d->d_tag) {
+            case DT_STRTAB:   map->strtab = (const char *)(b + d->d_val); break;
+            case DT_SYMTAB:   map->symtab = (const Elf32_Sym *)(b + d->d_val); break;
+            case DT_HASH:     map->hash = (const uint32_t *)(b + d->d_val); break;
+            case DT_REL:      map->rel = (const Elf32_Rel *)(b + d->d_val); break;
+            case DT_RELSZ:    map->relsz = d->d_val; break;
+            case DT_JMPREL:   map->jmprel = (const Elf32_Rel *)(b + d->d_val); break;
+            case DT_PLTRELSZ: map->pltrelsz = d->d_val; break;
+            case DT_PLTGOT:   map->pltgot = (uint32_t *)(b + d->d_val); break;
+            case DT_BIND_NOW: map->bind_now = 1; break;
+            case DT_FLAGS:    if (d->d_val & DF_BIND_NOW) map->bind_now = 1; break;
+            default: break;
+        }
+    }
+}
+
+static uint32_t elf_hash(const char *name) {
+    uint32_t h = 0;
+    while (*name) {
+        h = (h << 4) + (uint8_t)*name++;
+        uint32_t g = h & 0xF0000000u;
+        if (g) h ^= g >> 24;
+        h &= ~g;
+    }
+    return h;
+}
+
+static const Elf32_Sym *lookup_in(const link_map_t *map, const char *name, uint32_t hash) {
+    if (!map->hash || !map->symtab || !map->strtab) return NULL;
+    uint32_t nbucket = map->hash[0];
+    const uint32_t *buckets = map->hash + 2;
+    const uint32_t *chains = buckets + nbucket;
+    for (uint32_t i = buckets[hash % nbucket]; i != 0; i = chains[i]) {
+        const Elf32_Sym *sym = &map->symtab[i];
+        if (sym->st_shndx != SHN_UNDEF && ld_streq(map->strtab + sym->st_name, name)) {
+            return sym;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Resolves a symbol in the global scope (program, then libraries in load
+ * order), optionally skipping the requesting object for R_386_COPY.
+ */
+static uintptr_t resolve(const link_map_t *map, uint32_t symidx, const link_map_t *skip) {
+    const Elf32_Sym *sym = &map->symtab[symidx];
+    const char *name = map->strtab + sym->st_name;
+    uint32_t hash = elf_hash(name);
+
+    for (int i = 0; i < g_nmaps; i++) {
+        if (&g_maps[i] == skip) continue;
+        const Elf32_Sym *def = lookup_in(&g_maps[i], name, hash);
+        if (def) return g_maps[i].base + def->st_value;
+    }
+    if ((sym->st_info >> 4) == STB_WEAK) return 0;
+    ld_fail("undefined symbol", name);
+    return 0;
+}
+
+/* ==== Relocation ======================================================== */
+
+static void apply_rel(link_map_t *map, const Elf32_Rel *r, int lazy) {
+    uint32_t *where = (uint32_t *)(map->base + r->r_offset);
+    uint32_t sym = r->r_info >> 8;
+
+    switch (r->r_info & 0xFF) {
+        case R_386_RELATIVE: *where += map->base; break;
+        case R_386_32:       *where += resolve(map, sym, NULL); break;
+        case R_386_PC32:     *where += resolve(map, sym, NULL) - (uintptr_t)where; break;
+        case R_386_GLOB_DAT: *where = resolve(map, sym, NULL); break;
+        case R_386_JMP_SLOT:
+            /* Lazily, the slot keeps pointing back into its PLT entry */
+            if (lazy) *where += map->base;
+            else      *where = resolve(map, sym, NULL);
+            break;
+        case R_386_COPY: {
+            uintptr_t src = resolve(map, sym, map);
+            if (src) ld_memcpy(where, (const void *)src, map->symtab[sym].st_size);
+            break;
+        }
+        default:
+            ld_fail("unsupported relocation in", map->name);
+    }
+}
+
+static void relocate(link_map_t *map) {
+    for (uint32_t i = 0; map->rel && i < map->relsz / sizeof(Elf32_Rel); i++) {
+        apply_rel(map, &map->rel[i], 0);
+    }
+
+    int lazy = !(map->bind_now || g_bind_now_env) && map->pltgot;
+    for (uint32_t i = 0; map->jmprel && i < map->pltrelsz / sizeof(Elf32_Rel); i++) {
+        apply_rel(map, &map->jmprel[i], lazy);
+    }
+    if (lazy) {
+        map->pltgot[1] = (uint32_t)map;
+        map->pltgot[2] = (uint32_t)&ldso_runtime_resolve;
+    }
+}
+
+/* Called from ldso_runtime_resolve on the first call through a PLT slot */
+HIDDEN uintptr_t ldso_lazy_resolve(link_map_t *map, uint32_t reloc_offset) {
+    const Elf32_Rel *r = (const Elf32_Rel *)((uintptr_t)map->jmprel + reloc_offset);
+    uintptr_t target = resolve(map, r->r_info >> 8, NULL);
+    *(uint32_t *)(map->base + r->r_offset) = target;
+    return target;
+}
+
+/* ==== Library loading =================================================== */
+
+static int prot_of(uint32_t p_flags) {
+    return ((p_flags & PF_R) ? PROT_READ : 0) |
+           ((p_flags & PF_W) ? PROT_WRITE : 0) |
+           ((p_flags & PF_X) ? PROT_EXEC : 0);
+}
+
+static link_map_t *load_library(const char *name) {
+    for (int i = 1; i < g_nmaps; i++) {
+        if (ld_streq(g_maps[i].name, name)) return &g_maps[i];
+    }
+    if (g_nmaps >= LDSO_MAX_OBJECTS) ld_fail("too many libraries", name);
+
+    link_map_t *map = &g_maps[g_nmaps];
+    ld_memset(map, 0, sizeof(*map));
+    size_t len = ld_strlen(name);
+    if (len + 6 > LDSO_PATH_MAX) ld_fail("library name too long", name);
+    ld_memcpy(map->name, name, len + 1);
+
+    char path[LDSO_PATH_MAX];
+    ld_memcpy(path, "/lib/", 5);
+    ld_memcpy(path + 5, name, len + 1);
+
+    int fd = ldso_syscall(SYS_OPEN, (int)path, 0, 0, 0, 0, 0);
+    if (fd < 0) ld_fail("cannot open", path);
+
+    Elf32_Ehdr eh;
+    Elf32_Phdr ph[LDSO_MAX_PHDRS];
+    if (ld_read_at(fd, 0, &eh, sizeof(eh)) != 0 || eh.e_type != ET_DYN ||
+        eh.e_phentsize != sizeof(Elf32_Phdr) || eh.e_phnum > LDSO_MAX_PHDRS ||
+        ld_read_at(fd, eh.e_phoff, ph, eh.e_phnum * sizeof(Elf32_Phdr)) != 0) {
+        ld_fail("not a shared object", path);
+    }
+
+    /* Reserve the whole image so segments keep their relative layout */
+    uintptr_t lo = 0xFFFFFFFFu, hi = 0;
+    for (int i = 0; i < eh.e_phnum; i++) {
+        if (ph[i].p_type != PT_LOAD) continue;
+        if (PAGE_DOWN(ph[i].p_vaddr) < lo) lo = PAGE_DOWN(ph[i].p_vaddr);
+        if (PAGE_UP(ph[i].p_vaddr + ph[i].p_memsz) > hi) hi = PAGE_UP(ph[i].p_vaddr + ph[i].p_memsz);
+    }
+    if (hi <= lo) ld_fail("no loadable segments in", path);
+
+    int res = ldso_syscall(SYS_MMAP2, 0, (int)(hi - lo), 0, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (is_mmap_error(res)) ld_fail("out of address space for", path);
+    map->base = (uintptr_t)res - lo;
+
+    for (int i = 0; i < eh.e_phnum; i++) {
+        const Elf32_Phdr *p = &ph[i];
+        if (p->p_type == PT_DYNAMIC) map->dyn = (const Elf32_Dyn *)(map->base + p->p_vaddr);
+        if (p->p_type != PT_LOAD || p->p_memsz == 0) continue;
+
+        uintptr_t start = PAGE_DOWN(map->base + p->p_vaddr);
+        uint32_t lead = (map->base + p->p_vaddr) - start;
+        uintptr_t file_end = map->base + p->p_vaddr + p->p_filesz;
+        uintptr_t mem_end = PAGE_UP(map->base + p->p_vaddr + p->p_memsz);
+        uint32_t file_len = PAGE_UP(lead + p->p_filesz);
+
+        if (file_len) {
+            res = ldso_syscall(SYS_MMAP2, (int)start, (int)file_len, prot_of(p->p_flags),
+                               MAP_PRIVATE | MAP_FIXED, fd, (int)((p->p_offset - lead) / PAGE_SIZE));
+            if (is_mmap_error(res)) ld_fail("cannot map segment of", path);
+        }
+        if (p->p_memsz > p->p_filesz) {
+            /* .bss: clear the file page tail, then anonymous zero pages */
+            if (file_end & (PAGE_SIZE - 1)) {
+                ld_memset((void *)file_end, 0, PAGE_UP(file_end) - file_end);
+            }
+            uintptr_t anon = start + file_len;
+            if (mem_end > anon) {
+                res = ldso_syscall(SYS_MMAP2, (int)anon, (int)(mem_end - anon), prot_of(p->p_flags),
+                                   MAP_PRIVATE | MAP_FIXED | MAP_ANONYMOUS, -1, 0);
+                if (is_mmap_error(res)) ld_fail("cannot map bss of", path);
+            }
+        }
+    }
+    ldso_syscall(SYS_CLOSE, fd, 0, 0, 0, 0, 0);
+
+    if (!map->dyn) ld_fail("no dynamic section in", path);
+    g_nmaps++;
+    parse_dynamic(map);
+    return map;
+}
+
+/* Breadth-first: every DT_NEEDED of every loaded object, each loaded once */
+static void load_needed(void) {
+    for (int i = 0; i < g_nmaps; i++) {
+        for (const Elf32_Dyn *d = g_maps[i].dyn; d->d_tag != DT_NULL; d++) {
+            if (d->d_tag == DT_NEEDED) load_library(g_maps[i].strtab + d->d_val);
+        }
+    }
+}
+
+/* ==== Entry ============================================================= */
+
+HIDDEN uintptr_t ldso_main(uint32_t *sp) {
+    uint32_t argc = sp[0];
+    char **envp = (char **)(sp + 1 + argc + 1);
+    char **e = envp;
+    while (*e) e++;
+    uint32_t *auxv = (uint32_t *)(e + 1);
+
+    uintptr_t at_phdr = 0, at_base = 0, at_entry = 0;
+    uint32_t at_phnum = 0;
+    for (uint32_t *a = auxv; a[0] != AT_NULL; a += 2) {
+        switch (a[0]) {
+            case AT_PHDR:  at_phdr = a[1]; break;
+            case AT_PHNUM: at_phnum = a[1]; break;
+            case AT_BASE:  at_base = a[1]; break;
+            case AT_ENTRY: at_entry = a[1]; break;
+            default: break;
+        }
+    }
+    relocate_self(at_base);
+
+    for (e = envp; *e; e++) {
+        const char *s = *e, *key = "LD_BIND_NOW=";
+        while (*key && *s == *key) { s++; key++; }
+        if (!*key && *s) g_bind_now_env = 1;
+    }
+
+    /* The program: its bias follows from where PT_PHDR says the headers are */
+    link_map_t *prog = &g_maps[0];
+    const Elf32_Phdr *ph = (const Elf32_Phdr *)at_phdr;
+    for (uint32_t i = 0; ph && i < at_phnum; i++) {
+        if (ph[i].p_type == PT_PHDR) prog->base = at_phdr - ph[i].p_vaddr;
+    }
+    for (uint32_t i = 0; ph && i < at_phnum; i++) {
+        if (ph[i].p_type == PT_DYNAMIC) prog->dyn = (const Elf32_Dyn *)(prog->base + ph[i].p_vaddr);
+    }
+    if (!prog->dyn) return at_entry;    /* Static program run through ld.so */
+
+    g_nmaps = 1;
+    parse_dynamic(prog);
+    load_needed();
+
+    /* Libraries first, so R_386_COPY in the program sees relocated data */
+    for (int i = g_nmaps - 1; i >= 0; i--) {
+        relocate(&g_maps[i]);
+    }
+    return at_entry;
+}
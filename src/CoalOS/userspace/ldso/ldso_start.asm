@@ -0,0 +1,60 @@
+; ldso_start.asm - Entry point and assembly helpers of the CoalOS dynamic linker
+;
+; The kernel starts a dynamically linked program here (PT_INTERP) with ESP at
+; argc, followed by argv, envp and the auxiliary vector. ldso_main() loads and
+; relocates the program's libraries and returns the program entry point; the
+; stack is handed over untouched.
+
+section .text
+bits 32
+
+global _start
+global ldso_runtime_resolve:function hidden
+global ldso_syscall:function hidden
+extern ldso_main
+extern ldso_lazy_resolve
+
+_start:
+    mov  eax, esp
+    push eax                ; ldso_main(initial stack pointer)
+    call ldso_main
+    add  esp, 4             ; ESP is back at argc
+    xor  edx, edx           ; No atexit handler for crt0 to register
+    jmp  eax
+
+; Lazy PLT binding. PLT0 has pushed GOT[1] (the link map) and each PLT entry
+; its relocation offset, on top of the caller's return address:
+;   [esp] = link map, [esp + 4] = relocation offset, [esp + 8] = return address
+ldso_runtime_resolve:
+    push eax                ; Preserve the argument registers of regparm callees
+    push ecx
+    push edx
+    push dword [esp + 16]   ; Relocation offset
+    push dword [esp + 16]   ; Link map
+    call ldso_lazy_resolve  ; Patches the GOT slot, returns the target
+    add  esp, 8
+    pop  edx
+    pop  ecx
+    xchg eax, [esp]         ; Restore EAX, leave the target on the stack
+    ret  8                  ; Jump to the target, dropping map and offset
+
+; int ldso_syscall(int nr, int a1, int a2, int a3, int a4, int a5, int a6)
+; Six-argument int 0x80 call; EBX and EBP cannot be bound from C under -fPIC.
+ldso_syscall:
+    push ebx
+    push esi
+    push edi
+    push ebp
+    mov  eax, [esp + 20]
+    mov  ebx, [esp + 24]
+    mov  ecx, [esp + 28]
+    mov  edx, [esp + 32]
+    mov  esi, [esp + 36]
+    mov  edi, [esp + 40]
+    mov  ebp, [esp + 44]
+    int  0x80
+    pop  ebp
+    pop  edi
+    pop  esi
+    pop  ebx
+    ret
@@ -275,15 +275,30 @@ int builtin_ls(char **args) {
     const char *path = ".";
     if (args[1]) path = args[1];
     
-    // Simple ls implementation - just try to open directory
     int fd = sys_open(path, O_RDONLY, 0);
     if (fd < 0) {
         error("ls: cannot access directory");
         return 1;
     }
     
-    // TODO: Implement directory reading when getdents is available
-    print_str("ls: directory listing not fully implemented\n");
+    // Each getdents call fills the whole buffer, so a listing takes only as
+    // many syscalls as there are buffers' worth of entries
+    static char dirent_buf[4096];
+    int nread;
+    while ((nread = sys_getdents(fd, dirent_buf, sizeof(dirent_buf))) > 0) {
+        for (int pos = 0; pos < nread; ) {
+            struct linux_dirent *d = (struct linux_dirent *)(dirent_buf + pos);
+            print_str(d->d_name);
+            print_str("\n");
+            pos += d->d_reclen;
+        }
+    }
+    
+    if (nread < 0) {
+        error("ls: error reading directory");
+        sys_close(fd);
+        return 1;
+    }
     
     sys_close(fd);
     return 0;
@@ -32,6 +32,7 @@
 #define SYS_PIPE    42
 #define SYS_SIGNAL  48
 #define SYS_GETPPID 64
+#define SYS_GETDENTS 141
 #define SYS_GETCWD  183
 
 //============================================================================
@@ -70,5 +71,14 @@ int32_t syscall(int32_t syscall_number, int32_t arg1, int32_t arg2, int32_t arg3
 #define sys_pipe(p)          syscall(SYS_PIPE, (int32_t)(uintptr_t)(p), 0, 0)
 #define sys_signal(s,h)      syscall(SYS_SIGNAL, (s), (int32_t)(uintptr_t)(h), 0)
 #define sys_getcwd(buf,size) syscall(SYS_GETCWD, (int32_t)(uintptr_t)(buf), (size), 0)
+#define sys_getdents(fd,buf,n) syscall(SYS_GETDENTS, (fd), (int32_t)(uintptr_t)(buf), (n))
+
+// Directory record returned by getdents (matches kernel struct linux_dirent)
+struct linux_dirent {
+    unsigned long  d_ino;
+    unsigned long  d_off;
+    unsigned short d_reclen;
+    char           d_name[];
+};
 
 #endif // SYSCALL_WRAPPER_H
\ No newline at end of file
@@ -15,6 +15,7 @@
  * - Command history
  * - Signal handling
  * - Executable launching via fork/exec
+ * - PATH lookup with a command hash table (hash, hash -r)
  */
 
 //============================================================================
@@ -72,7 +73,10 @@ typedef char bool;
 #define SYS_KILL    37
 #define SYS_PIPE    42
 #define SYS_SIGNAL  48
+#define SYS_IOCTL   54
 #define SYS_GETPPID 64
+#define SYS_STAT    106
+#define SYS_GETDENTS 141
 #define SYS_GETCWD  183
 
 // File descriptor constants
@@ -136,6 +140,55 @@ static inline int32_t syscall(int32_t syscall_number, int32_t arg1, int32_t arg2
 #define sys_pipe(p)          syscall(SYS_PIPE, (int32_t)(uintptr_t)(p), 0, 0)
 #define sys_signal(s,h)      syscall(SYS_SIGNAL, (s), (int32_t)(uintptr_t)(h), 0)
 #define sys_getcwd(buf,size) syscall(SYS_GETCWD, (int32_t)(uintptr_t)(buf), (size), 0)
+#define sys_getdents(fd,buf,n) syscall(SYS_GETDENTS, (fd), (int32_t)(uintptr_t)(buf), (n))
+#define sys_stat(p,st)       syscall(SYS_STAT, (int32_t)(uintptr_t)(p), (int32_t)(uintptr_t)(st), 0)
+#define sys_ioctl(fd,r,a)    syscall(SYS_IOCTL, (fd), (r), (int32_t)(uintptr_t)(a))
+
+// Terminal settings (matches the kernel's struct termios)
+struct k_termios {
+    uint32_t c_iflag;
+    uint32_t c_oflag;
+    uint32_t c_cflag;
+    uint32_t c_lflag;
+    uint8_t  c_line;
+    uint8_t  c_cc[19];
+};
+#define TCGETS  0x5401
+#define TCSETS  0x5402
+#define ISIG    0x0001
+#define ICANON  0x0002
+#define ECHO    0x0008
+#define VTIME   5
+#define VMIN    6
+
+// Directory record returned by getdents (matches kernel struct linux_dirent)
+struct linux_dirent {
+    unsigned long  d_ino;
+    unsigned long  d_off;
+    unsigned short d_reclen;
+    char           d_name[];
+};
+
+// File status returned by stat; same layout as include/kernel/fs/stat.h
+struct stat {
+    uint32_t st_dev;
+    uint32_t st_ino;
+    uint32_t st_mode;
+    uint32_t st_nlink;
+    uint32_t st_uid;
+    uint32_t st_gid;
+    uint32_t st_rdev;
+    int32_t  st_size;
+    uint32_t st_atime;
+    uint32_t st_mtime;
+    uint32_t st_ctime;
+    uint32_t st_blksize;
+    uint32_t st_blocks;
+};
+
+#define S_IFMT   0170000
+#define S_IFREG  0100000
+#define S_ISREG(m) (((m) & S_IFMT) == S_IFREG)
 
 //============================================================================
 // Configuration Constants
@@ -149,6 +202,13 @@ static inline int32_t syscall(int32_t syscall_number, int32_t arg1, int32_t arg2
 #define MAX_PATH_LENGTH 256
 #define MAX_ALIASES 32
 #define MAX_COMPLETIONS 64
+#define COMPLETION_POOL_SIZE 4096
+#define GETDENTS_BUFFER_SIZE 4096
+#define CMD_HASH_SIZE 64             // Power of two, linear probing
+#define CMD_NAME_MAX 64
+#define MAX_PATH_DIRS 16
+#define PATH_LISTING_POOL_SIZE 8192
+#define PATH_LISTING_MAX_NAMES 512
 
 //============================================================================
 // Data Structures
@@ -207,6 +267,22 @@ typedef struct completion {
     int is_command;
 } completion_t;
 
+// Remembered location of an external command (bash "hash")
+typedef struct cmd_hash_entry {
+    bool in_use;
+    int hits;
+    char name[CMD_NAME_MAX];
+    char path[MAX_PATH_LENGTH];
+} cmd_hash_entry_t;
+
+// Cached listing of one PATH directory, revalidated against its stat identity
+typedef struct path_dir {
+    char path[MAX_PATH_LENGTH];
+    bool exists;
+    uint32_t ino;
+    uint32_t mtime;
+} path_dir_t;
+
 // Shell state
 typedef struct {
     job_t jobs[MAX_JOBS];
@@ -236,6 +312,16 @@ static shell_state_t g_shell;
 static char g_input_buffer[MAX_COMMAND_LENGTH];
 static completion_t g_completions[MAX_COMPLETIONS];
 static int g_num_completions = 0;
+static char g_completion_pool[COMPLETION_POOL_SIZE]; // Backing store for file completion strings
+static int g_completion_pool_used = 0;
+static cmd_hash_entry_t g_cmd_hash[CMD_HASH_SIZE];
+static path_dir_t g_path_dirs[MAX_PATH_DIRS];
+static int g_num_path_dirs = 0;
+static bool g_path_listing_valid = false;
+static char g_path_listing_pool[PATH_LISTING_POOL_SIZE];
+static int g_path_listing_pool_used = 0;
+static char *g_path_listing_names[PATH_LISTING_MAX_NAMES];
+static int g_path_listing_num_names = 0;
 
 //============================================================================
 // Utility Functions
@@ -369,6 +455,7 @@ static void clear_completions(void);
 static void find_command_completions(const char *prefix);
 static void find_file_completions(const char *prefix);
 static int handle_tab_completion(char *buffer, int cursor_pos);
+static void path_cache_invalidate(void);
 
 //============================================================================
 // Environment Variable Management
@@ -451,6 +538,10 @@ static char *get_env(const char *name) {
 }
 
 static void set_env(const char *name, const char *value) {
+    if (my_strcmp(name, "PATH") == 0) {
+        path_cache_invalidate();
+    }
+    
     // Check if variable already exists
     for (int i = 0; i < g_shell.num_env_vars; i++) {
         if (my_strcmp(g_shell.env_vars[i].name, name) == 0) {
@@ -471,6 +562,10 @@ static void set_env(const char *name, const char *value) {
 }
 
 static void unset_env(const char *name) {
+    if (my_strcmp(name, "PATH") == 0) {
+        path_cache_invalidate();
+    }
+    
     for (int i = 0; i < g_shell.num_env_vars; i++) {
         if (my_strcmp(g_shell.env_vars[i].name, name) == 0) {
             // Remove by shifting remaining entries
@@ -492,6 +587,124 @@ static void show_env(void) {
     }
 }
 
+//============================================================================
+// Command Hash Table
+//============================================================================
+
+// Like bash, the shell remembers where each external command was found so
+// that running it again costs one table lookup instead of a PATH walk. The
+// table is dropped whenever PATH changes or on "hash -r".
+
+static char g_resolved_path[MAX_PATH_LENGTH]; // Result for names too long to hash
+
+static uint32_t cmd_hash_name(const char *name) {
+    uint32_t h = 2166136261u; // FNV-1a
+    while (*name) {
+        h ^= (uint8_t)*name++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void path_cache_invalidate(void) {
+    my_memset(g_cmd_hash, 0, sizeof(g_cmd_hash));
+    g_path_listing_valid = false;
+}
+
+// Copies the next PATH component into dir; an empty component means ".".
+// Returns the position after it, or NULL once the list is exhausted.
+static const char *next_path_dir(const char *p, char *dir, size_t size) {
+    if (!p) {
+        return NULL;
+    }
+    size_t len = 0;
+    while (p[len] && p[len] != ':') {
+        len++;
+    }
+    if (len == 0) {
+        my_strcpy(dir, ".");
+    } else if (len < size) {
+        for (size_t i = 0; i < len; i++) {
+            dir[i] = p[i];
+        }
+        dir[len] = '\0';
+    } else {
+        dir[0] = '\0'; // Too long to ever match
+    }
+    return p[len] ? p + len + 1 : NULL;
+}
+
+static bool search_path(const char *name, char *out) {
+    const char *path = get_env("PATH");
+    if (!path) {
+        return false;
+    }
+    
+    size_t name_len = my_strlen(name);
+    char dir[MAX_PATH_LENGTH];
+    const char *p = path;
+    while (p) {
+        p = next_path_dir(p, dir, sizeof(dir));
+        size_t dir_len = my_strlen(dir);
+        if (dir_len == 0 || dir_len + 1 + name_len >= MAX_PATH_LENGTH) {
+            continue;
+        }
+        my_strcpy(out, dir);
+        if (out[dir_len - 1] != '/') {
+            my_strcat(out, "/");
+        }
+        my_strcat(out, name);
+        
+        struct stat st;
+        if (sys_stat(out, &st) == 0 && S_ISREG(st.st_mode)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns the matching entry, or the empty slot where name belongs, or NULL
+// if the table is full
+static cmd_hash_entry_t *cmd_hash_slot(const char *name) {
+    uint32_t i = cmd_hash_name(name) & (CMD_HASH_SIZE - 1);
+    for (int probe = 0; probe < CMD_HASH_SIZE; probe++) {
+        cmd_hash_entry_t *e = &g_cmd_hash[i];
+        if (!e->in_use || my_strcmp(e->name, name) == 0) {
+            return e;
+        }
+        i = (i + 1) & (CMD_HASH_SIZE - 1);
+    }
+    return NULL;
+}
+
+// Resolves a command name to the path to execute, or NULL if not found
+static const char *resolve_command(const char *name) {
+    if (my_strchr(name, '/')) {
+        return name; // Explicit paths bypass PATH
+    }
+    
+    cmd_hash_entry_t *e = NULL;
+    if (my_strlen(name) < CMD_NAME_MAX) {
+        e = cmd_hash_slot(name);
+        if (e && e->in_use) {
+            e->hits++;
+            return e->path;
+        }
+    }
+    
+    if (!search_path(name, g_resolved_path)) {
+        return NULL;
+    }
+    if (e) {
+        e->in_use = true;
+        e->hits = 1;
+        my_strcpy(e->name, name);
+        my_strcpy(e->path, g_resolved_path);
+        return e->path;
+    }
+    return g_resolved_path;
+}
+
 //============================================================================
 // Alias Management
 //============================================================================
@@ -1163,6 +1376,49 @@ static int builtin_set(char **args) {
     return 0;
 }
 
+static int builtin_hash(char **args) {
+    if (!args[1]) {
+        bool any = false;
+        for (int i = 0; i < CMD_HASH_SIZE; i++) {
+            if (!g_cmd_hash[i].in_use) continue;
+            if (!any) {
+                print_str("hits\tcommand\n");
+                any = true;
+            }
+            print_str("   ");
+            print_int(g_cmd_hash[i].hits);
+            print_str("\t");
+            print_str(g_cmd_hash[i].path);
+            print_str("\n");
+        }
+        if (!any) {
+            print_str("hash: hash table empty\n");
+        }
+        return 0;
+    }
+    
+    int status = 0;
+    for (int i = 1; args[i]; i++) {
+        if (my_strcmp(args[i], "-r") == 0) {
+            path_cache_invalidate();
+            continue;
+        }
+        const char *path = resolve_command(args[i]);
+        if (!path) {
+            print_str("hash: ");
+            print_str(args[i]);
+            print_str(": not found\n");
+            status = 1;
+        } else if (!my_strchr(args[i], '/')) {
+            cmd_hash_entry_t *e = cmd_hash_slot(args[i]);
+            if (e && e->in_use) {
+                e->hits = 0; // Remembered, not yet run
+            }
+        }
+    }
+    return status;
+}
+
 static int builtin_help(char **args) {
     (void)args;
     print_str("Coal OS Advanced Shell v2.0\n");
@@ -1182,6 +1438,7 @@ static int builtin_help(char **args) {
     print_str("  bg [%job]      - Send job to background\n");
     print_str("  kill [pid]     - Kill process\n");
     print_str("  history        - Show command history\n");
+    print_str("  hash [-r] [name] - Show/remember/forget command locations\n");
     print_str("  help           - Show this help\n");
     print_str("  exit           - Exit shell\n");
     print_str("\n");
@@ -1222,6 +1479,7 @@ static int builtin_help(char **args);
 static int builtin_clear(char **args);
 static int builtin_fg(char **args);
 static int builtin_bg(char **args);
+static int builtin_hash(char **args);
 
 // Builtin commands table
 static builtin_cmd_t builtins[] = {
@@ -1240,6 +1498,7 @@ static builtin_cmd_t builtins[] = {
     {"exit", builtin_exit},
     {"jobs", builtin_jobs},
     {"history", builtin_history},
+    {"hash", builtin_hash},
     {"kill", builtin_kill},
     {"help", builtin_help},
     {NULL, NULL}
@@ -1259,6 +1518,88 @@ static void add_completion(const char *text, int is_command) {
 
 static void clear_completions(void) {
     g_num_completions = 0;
+    g_completion_pool_used = 0;
+}
+
+static bool has_completion(const char *text) {
+    for (int i = 0; i < g_num_completions; i++) {
+        if (my_strcmp(g_completions[i].text, text) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void path_listing_append(const char *dir_path) {
+    int fd = sys_open(dir_path, O_RDONLY, 0);
+    if (fd < 0) {
+        return;
+    }
+    
+    static char dirent_buf[GETDENTS_BUFFER_SIZE];
+    int nread;
+    while ((nread = sys_getdents(fd, dirent_buf, sizeof(dirent_buf))) > 0) {
+        for (int pos = 0; pos < nread; ) {
+            struct linux_dirent *d = (struct linux_dirent *)(dirent_buf + pos);
+            pos += d->d_reclen;
+            
+            if (d->d_name[0] == '.') {
+                continue;
+            }
+            int needed = my_strlen(d->d_name) + 1;
+            if (g_path_listing_pool_used + needed > PATH_LISTING_POOL_SIZE ||
+                g_path_listing_num_names >= PATH_LISTING_MAX_NAMES) {
+                sys_close(fd);
+                return;
+            }
+            char *name = g_path_listing_pool + g_path_listing_pool_used;
+            my_strcpy(name, d->d_name);
+            g_path_listing_pool_used += needed;
+            g_path_listing_names[g_path_listing_num_names++] = name;
+        }
+    }
+    sys_close(fd);
+}
+
+// Brings the PATH directory listings up to date. Each directory is re-read
+// only when its inode or mtime changed since it was listed, so repeated tab
+// presses cost one stat per PATH entry rather than a full getdents scan.
+static void path_listing_refresh(void) {
+    bool stale = !g_path_listing_valid;
+    for (int i = 0; !stale && i < g_num_path_dirs; i++) {
+        struct stat st;
+        bool exists = sys_stat(g_path_dirs[i].path, &st) == 0;
+        if (exists != g_path_dirs[i].exists ||
+            (exists && (st.st_ino != g_path_dirs[i].ino || st.st_mtime != g_path_dirs[i].mtime))) {
+            stale = true;
+        }
+    }
+    if (!stale) {
+        return;
+    }
+    
+    g_num_path_dirs = 0;
+    g_path_listing_pool_used = 0;
+    g_path_listing_num_names = 0;
+    
+    const char *p = get_env("PATH");
+    while (p && g_num_path_dirs < MAX_PATH_DIRS) {
+        path_dir_t *dir = &g_path_dirs[g_num_path_dirs];
+        p = next_path_dir(p, dir->path, sizeof(dir->path));
+        if (!dir->path[0]) {
+            continue;
+        }
+        g_num_path_dirs++;
+        
+        struct stat st;
+        dir->exists = sys_stat(dir->path, &st) == 0;
+        dir->ino = dir->exists ? st.st_ino : 0;
+        dir->mtime = dir->exists ? st.st_mtime : 0;
+        if (dir->exists) {
+            path_listing_append(dir->path);
+        }
+    }
+    g_path_listing_valid = true;
 }
 
 static void find_command_completions(const char *prefix) {
@@ -1276,33 +1617,78 @@ static void find_command_completions(const char *prefix) {
         }
     }
     
-    // TODO: Search PATH for executables (simplified implementation)
-    // Common commands that might be available
-    static const char *common_commands[] = {
-        "ls", "cat", "grep", "find", "touch", "mkdir", "rmdir", 
-        "cp", "mv", "rm", "chmod", "chown", "ps", "top", NULL
-    };
-    
-    for (int i = 0; common_commands[i]; i++) {
-        if (my_strncmp(common_commands[i], prefix, my_strlen(prefix)) == 0) {
-            add_completion(common_commands[i], 1);
+    // Add executables from the cached PATH listings
+    path_listing_refresh();
+    for (int i = 0; i < g_path_listing_num_names; i++) {
+        const char *name = g_path_listing_names[i];
+        if (my_strncmp(name, prefix, my_strlen(prefix)) == 0 && !has_completion(name)) {
+            add_completion(name, 1);
         }
     }
 }
 
 static void find_file_completions(const char *prefix) {
-    // TODO: Read directory and find matching files
-    // This is a simplified implementation
-    static const char *common_files[] = {
-        "file.txt", "document.doc", "script.sh", "program.exe", 
-        "config.conf", "data.dat", NULL
-    };
+    // Split the prefix into directory part (kept verbatim in the completion)
+    // and the basename that entries must match
+    int prefix_len = my_strlen(prefix);
+    int base_start = prefix_len;
+    while (base_start > 0 && prefix[base_start - 1] != '/') {
+        base_start--;
+    }
+    
+    char dir_path[MAX_PATH_LENGTH];
+    if (base_start == 0) {
+        my_strcpy(dir_path, ".");
+    } else if (base_start < MAX_PATH_LENGTH) {
+        for (int i = 0; i < base_start; i++) {
+            dir_path[i] = prefix[i];
+        }
+        dir_path[base_start] = '\0';
+    } else {
+        return;
+    }
+    const char *base = prefix + base_start;
+    int base_len = prefix_len - base_start;
+    
+    int fd = sys_open(dir_path, O_RDONLY, 0);
+    if (fd < 0) {
+        return;
+    }
     
-    for (int i = 0; common_files[i]; i++) {
-        if (my_strncmp(common_files[i], prefix, my_strlen(prefix)) == 0) {
-            add_completion(common_files[i], 0);
+    // One getdents call returns a whole buffer of entries, so even large
+    // directories complete in a handful of syscalls
+    static char dirent_buf[GETDENTS_BUFFER_SIZE];
+    int nread;
+    while ((nread = sys_getdents(fd, dirent_buf, sizeof(dirent_buf))) > 0) {
+        for (int pos = 0; pos < nread; ) {
+            struct linux_dirent *d = (struct linux_dirent *)(dirent_buf + pos);
+            pos += d->d_reclen;
+            
+            const char *name = d->d_name;
+            if (name[0] == '.' && base_len == 0) {
+                continue; // Hide dotfiles unless explicitly requested
+            }
+            if (my_strncmp(name, base, base_len) != 0) {
+                continue;
+            }
+            
+            int needed = base_start + my_strlen(name) + 1;
+            if (g_completion_pool_used + needed > COMPLETION_POOL_SIZE ||
+                g_num_completions >= MAX_COMPLETIONS) {
+                sys_close(fd);
+                return;
+            }
+            char *text = g_completion_pool + g_completion_pool_used;
+            for (int i = 0; i < base_start; i++) {
+                text[i] = prefix[i];
+            }
+            my_strcpy(text + base_start, name);
+            g_completion_pool_used += needed;
+            add_completion(text, 0);
         }
     }
+    
+    sys_close(fd);
 }
 
 static int handle_tab_completion(char *buffer, int cursor_pos) {
@@ -1411,11 +1797,18 @@ static int execute_builtin(char **args) {
 //============================================================================
 
 static int execute_external(char **args) {
+    const char *path = resolve_command(args[0]);
+    if (!path) {
+        print_str(args[0]);
+        print_str(": command not found\n");
+        return 127;
+    }
+    
     pid_t pid = sys_fork();
     
     if (pid == 0) {
         // Child process
-        if (sys_execve(args[0], (int32_t)args, 0) == -1) {
+        if (sys_execve(path, (int32_t)args, 0) == -1) {
             error("execve failed");
             sys_exit(127);
         }
@@ -1456,6 +1849,13 @@ static int execute_pipeline(pipeline_t *pipeline) {
         }
         
         // External command with potential I/O redirection
+        const char *path = resolve_command(cmd->args[0]);
+        if (!path) {
+            print_str(cmd->args[0]);
+            print_str(": command not found\n");
+            return 127;
+        }
+        
         if (pipeline->background) {
             pid_t pid = sys_fork();
             if (pid == 0) {
@@ -1490,7 +1890,7 @@ static int execute_pipeline(pipeline_t *pipeline) {
                     sys_close(output_fd);
                 }
                 
-                sys_execve(cmd->args[0], (int32_t)cmd->args, 0);
+                sys_execve(path, (int32_t)cmd->args, 0);
                 sys_exit(127);
             } else if (pid > 0) {
                 add_job(pid, cmd->args[0], true);
@@ -1532,7 +1932,7 @@ static int execute_pipeline(pipeline_t *pipeline) {
                         sys_close(output_fd);
                     }
                     
-                    sys_execve(cmd->args[0], (int32_t)cmd->args, 0);
+                    sys_execve(path, (int32_t)cmd->args, 0);
                     error("execve failed");
                     sys_exit(127);
                 } else if (pid > 0) {
@@ -1599,6 +1999,9 @@ static int execute_pipeline(pipeline_t *pipeline) {
                 return 1;
             }
             
+            // Resolve in the parent so the hash table outlives the child
+            const char *path = resolve_command(cmd->args[0]);
+            
             // Fork for external command
             pid_t pid = sys_fork();
             if (pid == 0) {
@@ -1648,7 +2051,12 @@ static int execute_pipeline(pipeline_t *pipeline) {
                 }
                 
                 // Execute the command
-                sys_execve(cmd->args[0], (int32_t)cmd->args, 0);
+                if (!path) {
+                    print_str(cmd->args[0]);
+                    print_str(": command not found\n");
+                    sys_exit(127);
+                }
+                sys_execve(path, (int32_t)cmd->args, 0);
                 error("execve failed");
                 sys_exit(127);
             } else if (pid > 0) {
@@ -1769,7 +2177,7 @@ static void load_history_entry(char *buffer, size_t buffer_size, int direction)
 }
 
 // Enhanced input reading with basic line editing support
-static ssize_t read_line_with_completion(char *buffer, size_t buffer_size) {
+static ssize_t read_line_edit(char *buffer, size_t buffer_size) {
     size_t pos = 0;
     char c;
     
@@ -1841,6 +2249,25 @@ static ssize_t read_line_with_completion(char *buffer, size_t buffer_size) {
     return pos;
 }
 
+// The shell edits the line itself, so the tty hands over keys one at a time
+// without echo or signals; commands run with the settings the shell found
+static ssize_t read_line_with_completion(char *buffer, size_t buffer_size) {
+    struct k_termios saved;
+    bool raw = sys_ioctl(STDIN_FILENO, TCGETS, &saved) == 0;
+    if (raw) {
+        struct k_termios t = saved;
+        t.c_lflag &= ~(uint32_t)(ICANON | ECHO | ISIG);
+        t.c_cc[VMIN] = 1;
+        t.c_cc[VTIME] = 0;
+        sys_ioctl(STDIN_FILENO, TCSETS, &t);
+    }
+
+    ssize_t n = read_line_edit(buffer, buffer_size);
+
+    if (raw) sys_ioctl(STDIN_FILENO, TCSETS, &saved);
+    return n;
+}
+
 int main(void) {
     shell_init();
     